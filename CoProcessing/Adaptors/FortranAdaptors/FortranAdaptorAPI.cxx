@@ -15,6 +15,9 @@
 #include "FortranAdaptorAPI.h"
 
 #include <iostream>
+#include <map>
+#include <string>
+#include "vtkCellArray.h"
 #include "vtkCellData.h"
 #include "vtkCellType.h"
 #include "vtkCompositeDataIterator.h"
@@ -24,9 +27,12 @@
 #include "vtkCPPythonScriptPipeline.h"
 #include "vtkDoubleArray.h"
 #include "vtkFieldData.h"
+#include "vtkIdTypeArray.h"
 #include "vtkMultiBlockDataSet.h"
 #include "vtkPointData.h"
 #include "vtkPoints.h"
+#include "vtkSmartPointer.h"
+#include "vtkUnsignedCharArray.h"
 #include "vtkUnstructuredGrid.h"
 
 using namespace std;
@@ -43,6 +49,10 @@ namespace
   // It is reset to falase after calling coprocess as well
   // as if coprocessing is not needed for this time/time step
   bool isTimeDataSet = 0;
+  // arrays whose storage is reused between time steps, see
+  // GetPersistentArray()
+  typedef map<string, vtkSmartPointer<vtkDoubleArray> > PersistentArrayMap;
+  PersistentArrayMap persistentArrays;
 }
 
 vtkCPDataDescription* GetCoProcessorData()
@@ -79,6 +89,138 @@ bool ConvertFortranStringToCString(char* fortranString, int fortranStringLength,
   return true;
 }
 
+vtkDoubleArray* GetPersistentArray(const char* name, int numComponents,
+                                   vtkIdType numTuples)
+{
+  vtkSmartPointer<vtkDoubleArray>& array = persistentArrays[name];
+  if(!array || array->GetNumberOfComponents() != numComponents ||
+     array->GetNumberOfTuples() != numTuples)
+    {
+    array = vtkSmartPointer<vtkDoubleArray>::New();
+    array->SetName(name);
+    array->SetNumberOfComponents(numComponents);
+    array->SetNumberOfTuples(numTuples);
+    }
+  else
+    {
+    array->Modified();
+    }
+  return array;
+}
+
+vtkDoubleArray* CreateStridedArray(const char* name, double* data,
+                                   vtkIdType numTuples, int numComponents,
+                                   vtkIdType tupleStride,
+                                   vtkIdType componentStride)
+{
+  if(tupleStride == numComponents &&
+     (componentStride == 1 || numComponents == 1))
+    {
+    // already laid out the way VTK wants it
+    vtkDoubleArray* array = vtkDoubleArray::New();
+    array->SetName(name);
+    array->SetNumberOfComponents(numComponents);
+    array->SetArray(data, numTuples*numComponents, 1);
+    return array;
+    }
+
+  vtkDoubleArray* array = GetPersistentArray(name, numComponents, numTuples);
+  double* out = array->GetPointer(0);
+  for(vtkIdType i=0;i<numTuples;i++)
+    {
+    const double* in = data + i*tupleStride;
+    for(int c=0;c<numComponents;c++)
+      {
+      *out++ = in[c*componentStride];
+      }
+    }
+  array->Register(0);
+  return array;
+}
+
+vtkDoubleArray* CreateSoAArray(const char* name, double** components,
+                               int numComponents, vtkIdType numTuples)
+{
+  if(numComponents == 1)
+    {
+    return CreateStridedArray(name, components[0], numTuples, 1, 1, 1);
+    }
+  vtkDoubleArray* array = GetPersistentArray(name, numComponents, numTuples);
+  double* out = array->GetPointer(0);
+  for(int c=0;c<numComponents;c++)
+    {
+    const double* in = components[c];
+    for(vtkIdType i=0;i<numTuples;i++)
+      {
+      out[i*numComponents+c] = in[i];
+      }
+    }
+  array->Register(0);
+  return array;
+}
+
+bool InsertBlockOfCells(vtkUnstructuredGrid* grid, int cellType,
+                        vtkIdType numCells, int numPointsPerCell,
+                        const int* connectivity, vtkIdType cellStride,
+                        vtkIdType pointStride, int indexBase,
+                        const int* pointOrder)
+{
+  if(!grid || numCells <= 0)
+    {
+    return true;
+    }
+  if(!grid->GetCells() || !grid->GetCellTypesArray() ||
+     !grid->GetCellLocationsArray())
+    {
+    grid->Allocate(numCells);
+    }
+  vtkCellArray* cells = grid->GetCells();
+  vtkUnsignedCharArray* types = grid->GetCellTypesArray();
+  vtkIdTypeArray* locations = grid->GetCellLocationsArray();
+
+  // reserve everything up front and fill it in directly. the connectivity
+  // array of the cells is grown in place since vtkCellArray::WritePointer()
+  // only supports writing from the beginning.
+  vtkIdTypeArray* ids = cells->GetData();
+  vtkIdType location = ids->GetNumberOfTuples();
+  vtkIdType* conn = ids->WritePointer(location, numCells*(numPointsPerCell+1));
+  vtkIdType firstCell = types->GetNumberOfTuples();
+  unsigned char* cellTypes = types->WritePointer(firstCell, numCells);
+  vtkIdType* cellLocations = locations->WritePointer(firstCell, numCells);
+
+  vtkIdType numPoints = grid->GetNumberOfPoints();
+  vtkIdType numBadIds = 0;
+  for(vtkIdType iCell=0;iCell<numCells;iCell++)
+    {
+    cellTypes[iCell] = static_cast<unsigned char>(cellType);
+    cellLocations[iCell] = location;
+    location += numPointsPerCell+1;
+    *conn++ = numPointsPerCell;
+    const int* cellIds = connectivity + iCell*cellStride;
+    for(int i=0;i<numPointsPerCell;i++)
+      {
+      int j = pointOrder ? pointOrder[i] : i;
+      vtkIdType id = cellIds[j*pointStride] - indexBase;
+      if(id < 0 || id >= numPoints)
+        {
+        numBadIds++;
+        }
+      *conn++ = id;
+      }
+    }
+  // same array so this only updates the number of cells
+  cells->SetCells(firstCell+numCells, ids);
+  cells->Modified();
+  grid->Modified();
+  if(numBadIds)
+    {
+    cout << "CoProcessing: " << numBadIds << " invalid node ids in block of "
+         << numCells << " cells.\n";
+    return false;
+    }
+  return true;
+}
+
 void coprocessorinitialize_(char* pythonFileName, int* pythonFileNameLength )
 {
   if(!coProcessor)
@@ -114,6 +256,7 @@ void coprocessorfinalize_()
     coProcessorData->Delete();
     coProcessorData = 0;
     }
+  persistentArrays.clear();
 }
 
 void requestdatadescription_(int* timeStep, double* time, 
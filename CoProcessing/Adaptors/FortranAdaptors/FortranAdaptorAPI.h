@@ -15,8 +15,12 @@
 #ifndef FortranAdaptorAPI_h
 #define FortranAdaptorAPI_h
 
+#include "vtkType.h" // for vtkIdType
+
 class vtkCPDataDescription;
 class vtkDataSet;
+class vtkDoubleArray;
+class vtkUnstructuredGrid;
 
 // function to return the singleton/static vtkCPDataDescription object
 // that contains the grid and fields stuff
@@ -25,6 +29,42 @@ void ClearFieldDataFromGrid(vtkDataSet* grid);
 bool ConvertFortranStringToCString(char* fortranString, int fortranStringLength,
                                    char* cString, int cStringMaxLength);
 
+// returns a double array called name, owned by the adaptor, whose storage is kept from one time
+// step to the next so that adaptors which have to reorder simulation data
+// do not reallocate it every time step. it is reallocated when its shape
+// changes and released by coprocessorfinalize_().
+vtkDoubleArray* GetPersistentArray(const char* name, int numComponents,
+                                   vtkIdType numTuples);
+
+// returns a new array (the caller must Delete() it) for a field whose
+// component c of tuple i is stored at data[i*tupleStride+c*componentStride].
+// when that matches VTK's interleaved layout, e.g. a single component of a
+// Fortran (nshg,ndof) array, the simulation memory is used without copying.
+// otherwise the values are gathered in one pass into the persistent array
+// for name.  note that zero-copy arrays and persistent arrays change when
+// the simulation advances so asynchronous coprocessing needs deep copied
+// snapshots.
+vtkDoubleArray* CreateStridedArray(const char* name, double* data,
+                                   vtkIdType numTuples, int numComponents,
+                                   vtkIdType tupleStride,
+                                   vtkIdType componentStride);
+
+// same as CreateStridedArray() for a field whose components are stored in
+// separate simulation arrays.
+vtkDoubleArray* CreateSoAArray(const char* name, double** components,
+                               int numComponents, vtkIdType numTuples);
+
+// appends numCells cells of type cellType to grid in one pass. point j of
+// cell i is read from connectivity[i*cellStride+j*pointStride] and indexBase
+// is subtracted from it (1 for Fortran). pointOrder optionally permutes the
+// points of each cell into VTK's ordering. returns false if some point ids
+// are out of range.
+bool InsertBlockOfCells(vtkUnstructuredGrid* grid, int cellType,
+                        vtkIdType numCells, int numPointsPerCell,
+                        const int* connectivity, vtkIdType cellStride,
+                        vtkIdType pointStride, int indexBase,
+                        const int* pointOrder);
+
 // for now assume that the coprocessor is run through a python script
 extern "C" void coprocessorinitialize_(char* pythonFileName, int* pythonFileNameLength);
 extern "C" void coprocessorfinalize_();
@@ -39,12 +39,8 @@ extern "C" void createstructuredgrid_(
 
 extern "C" void add_scalar_(char *fname, int *len, double *data, int *size)
 {
-  vtkDoubleArray *arr = vtkDoubleArray::New ();
   vtkStdString name (fname, *len);
-  arr->SetName (name);
-  arr->SetNumberOfComponents (1);
-  // arr->SetNumberOfTuples (*size);
-  arr->SetArray (data, *size, 1);
+  vtkDoubleArray *arr = CreateStridedArray (name, data, *size, 1, 1, 1);
   vtkMultiBlockDataSet *grid = 
           vtkMultiBlockDataSet::SafeDownCast (
             GetCoProcessorData()->GetInputDescriptionByName ("input")->GetGrid ());
@@ -55,17 +51,9 @@ extern "C" void add_scalar_(char *fname, int *len, double *data, int *size)
 
 extern "C" void add_vector_(char *fname, int *len, double *data0, double *data1, double *data2, int *size)
 {
-  vtkDoubleArray *arr = vtkDoubleArray::New ();
   vtkStdString name (fname, *len);
-  arr->SetName (name);
-  arr->SetNumberOfComponents (3);
-  arr->SetNumberOfTuples (*size);
-  for (int i = 0; i < *size; i ++) 
-    {
-    arr->SetComponent (i, 0, data0[i]);
-    arr->SetComponent (i, 1, data1[i]);
-    arr->SetComponent (i, 2, data2[i]);
-    }
+  double *components[3] = { data0, data1, data2 };
+  vtkDoubleArray *arr = CreateSoAArray (name, components, 3, *size);
   vtkMultiBlockDataSet *grid = 
           vtkMultiBlockDataSet::SafeDownCast (
             GetCoProcessorData()->GetInputDescriptionByName ("input")->GetGrid ());
@@ -104,16 +92,15 @@ extern "C" void add_pressure_ (int *index, double *data, int *size)
     vtkDoubleArray::SafeDownCast (dataset->GetPointData ()->GetArray (name, ignore));
   if (!arr)
     {
-    arr = vtkDoubleArray::New ();
-    arr->SetName (name);
-    arr->SetNumberOfComponents (6);
-    arr->SetNumberOfTuples (*size);
+    // reuse last time step's storage
+    arr = GetPersistentArray (name, 6, *size);
     dataset->GetPointData ()->AddArray (arr);
-    arr->Delete ();
     }
 
+  double *tensor = arr->GetPointer (0) + real_index;
   for (int i = 0; i < *size; i ++) 
     {
-    arr->SetComponent (i, real_index, data[i]);
+    tensor[6*i] = data[i];
     }
+  arr->Modified ();
 }
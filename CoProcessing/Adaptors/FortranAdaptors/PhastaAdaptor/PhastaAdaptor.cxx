@@ -36,15 +36,9 @@ extern "C" void createpointsandallocatecells_(
 
   vtkUnstructuredGrid* Grid = vtkUnstructuredGrid::New();
   vtkPoints* nodePoints = vtkPoints::New();
-  vtkDoubleArray* coords = vtkDoubleArray::New();
-  coords->SetNumberOfComponents(3);
-  coords->SetNumberOfTuples(*numPoints);
-  for(int i=0;i<*numPoints;i++) 
-    {
-    double tuple[3] = {coordsArray[i], coordsArray[i+*numPoints], 
-                       coordsArray[i+*numPoints*2]};
-    coords->SetTupleValue(i, tuple);
-    }
+  // coordinates are stored as (numPoints,3)
+  vtkDoubleArray* coords = CreateStridedArray(
+    "coordinates", coordsArray, *numPoints, 3, 1, *numPoints);
   nodePoints->SetData(coords);
   coords->Delete();
   Grid->SetPoints(nodePoints);
@@ -62,6 +56,7 @@ extern "C" void insertblockofcells_(
   if(!grid)
     {
     cout << "CoProcessing: Could not access grid for cell insertion.\n";
+    return;
     }
   int type = -1;
   switch(*numPointsPerCell)
@@ -93,27 +88,12 @@ extern "C" void insertblockofcells_(
     return;
     }
     }
-  vtkIdType pts[8]; //assume for now we only have linear elements
-  vtkIdType numPoints = grid->GetNumberOfPoints();
-  for(int iCell=0;iCell<*numCellsInBlock;iCell++)
-    {
-    for(int i=0;i<*numPointsPerCell;i++)
-      {
-      pts[i] = cellConnectivity[iCell+i*(*numCellsInBlock)]-1;//-1 to get from f to c++
-      
-      if(pts[i] < 0 || pts[i] >= numPoints)
-        {
-        cout << pts[i] << " is not a valid node id\n";
-        }
-      }
-    if(type == VTK_TETRA)
-      { // change the canonical ordering of the tet to match VTK style
-      vtkIdType temp = pts[0];
-      pts[0] = pts[1];
-      pts[1] = temp;
-      }
-    grid->InsertNextCell(type, *numPointsPerCell, pts);
-    }
+  // connectivity is stored as (numCellsInBlock,numPointsPerCell) with 1
+  // based node ids. the tet's canonical ordering is changed to match VTK's.
+  static const int tetOrder[4] = {1, 0, 2, 3};
+  InsertBlockOfCells(grid, type, *numCellsInBlock, *numPointsPerCell,
+                     cellConnectivity, 1, *numCellsInBlock, 1,
+                     type == VTK_TETRA ? tetOrder : 0);
 }
 
 extern "C" void addfields_(
@@ -133,16 +113,9 @@ extern "C" void addfields_(
   //velocity
   if(idd->IsFieldNeeded("velocity"))
     {
-    vtkDoubleArray* velocity = vtkDoubleArray::New();
-    velocity->SetName("velocity");
-    velocity->SetNumberOfComponents(3);
-    velocity->SetNumberOfTuples(NumberOfNodes);
-    for (vtkIdType idx=0; idx<NumberOfNodes; idx++)
-      {
-      velocity->SetTuple3(idx, dofArray[idx],
-                          dofArray[idx+ *nshg],
-                          dofArray[idx+ *nshg*2]);
-      }
+    // the dofs are stored as (nshg,ndof)
+    vtkDoubleArray* velocity = CreateStridedArray(
+      "velocity", dofArray, NumberOfNodes, 3, 1, *nshg);
     UnstructuredGrid->GetPointData()->AddArray(velocity);
     velocity->Delete();
     }
@@ -150,9 +123,8 @@ extern "C" void addfields_(
   //pressure
   if(idd->IsFieldNeeded("pressure"))
     {
-    vtkDoubleArray* pressure = vtkDoubleArray::New();
-    pressure->SetName("pressure");
-    pressure->SetArray(dofArray+*nshg*3, NumberOfNodes, 1);
+    vtkDoubleArray* pressure = CreateStridedArray(
+      "pressure", dofArray+*nshg*3, NumberOfNodes, 1, 1, *nshg);
     UnstructuredGrid->GetPointData()->AddArray(pressure);
     pressure->Delete();
     }
@@ -161,9 +133,8 @@ extern "C" void addfields_(
   // temperature only varies from compressible flow
   if(idd->IsFieldNeeded("temperature") && *compressibleFlow == 1)
     {
-    vtkDoubleArray* temperature = vtkDoubleArray::New();
-    temperature->SetName("temperature");
-    temperature->SetArray(dofArray+*nshg*4, NumberOfNodes, 1);
+    vtkDoubleArray* temperature = CreateStridedArray(
+      "temperature", dofArray+*nshg*4, NumberOfNodes, 1, 1, *nshg);
     UnstructuredGrid->GetPointData()->AddArray(temperature);
     temperature->Delete();
     }
@@ -0,0 +1,200 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    CoProcessingBenchmark.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Measure the overhead of co-processing relative to a fake solver step.
+// Every combination of the given grid sizes, output frequencies and
+// pipelines is run and one line of timings is printed for each.  The
+// number of processes is swept by launching the benchmark with mpirun.
+//
+// Options (lists are comma separated):
+//   -d <sizes>        points per side of each process' block (default 50)
+//   -f <frequencies>  co-process every n time steps (default 1)
+//   -p <pipelines>    slice, contour, image and/or extract (default slice)
+//   -n <steps>        number of time steps (default 10)
+//   -s <seconds>      duration of a solver step (default 1)
+//   -o <directory>    write the results there, nothing is written otherwise
+//   -a <0|1>          run the pipelines on the analysis thread (default 0)
+
+#include "vtkCPBenchmarkDriver.h"
+#include "vtkCPBenchmarkPipeline.h"
+
+#include "CPSystemInformation.h"
+#ifdef COPROCESSOR_USE_MPI
+#define MPICH_SKIP_MPICXX
+#include "mpi.h"
+#endif
+#include <iostream>
+#include <iomanip>
+#include <stdlib.h>
+#include <string>
+#include <vector>
+
+namespace
+{
+  // split a comma separated list
+  std::vector<std::string> SplitList(const char* list)
+  {
+    std::vector<std::string> items;
+    std::string item;
+    for(const char* c=list;*c;c++)
+      {
+      if(*c == ',')
+        {
+        items.push_back(item);
+        item.clear();
+        }
+      else
+        {
+        item += *c;
+        }
+      }
+    items.push_back(item);
+    return items;
+  }
+}
+
+int main(int argc, char* argv[])
+{
+#ifdef COPROCESSOR_USE_MPI
+  MPI_Init(&argc,&argv);
+#endif
+  std::vector<std::string> sizes(1, "50");
+  std::vector<std::string> frequencies(1, "1");
+  std::vector<std::string> pipelines(1, "slice");
+  unsigned long numberOfTimeSteps = 10;
+  double solverStepTime = 1;
+  const char* outputDirectory = 0;
+  bool asynchronous = false;
+
+  int errors = 0;
+  for(int i=1;i<argc;i++)
+    {
+    std::string arg = argv[i];
+    if(i+1 >= argc)
+      {
+      cerr << "Missing value for " << arg << endl;
+      errors++;
+      break;
+      }
+    const char* value = argv[++i];
+    if(arg == "-d")
+      {
+      sizes = SplitList(value);
+      }
+    else if(arg == "-f")
+      {
+      frequencies = SplitList(value);
+      }
+    else if(arg == "-p")
+      {
+      pipelines = SplitList(value);
+      }
+    else if(arg == "-n")
+      {
+      numberOfTimeSteps = strtoul(value, 0, 10);
+      }
+    else if(arg == "-s")
+      {
+      solverStepTime = atof(value);
+      }
+    else if(arg == "-o")
+      {
+      outputDirectory = value;
+      }
+    else if(arg == "-a")
+      {
+      asynchronous = atoi(value) != 0;
+      }
+    else
+      {
+      cerr << "Unknown option " << arg << endl;
+      errors++;
+      }
+    }
+  for(size_t i=0;i<pipelines.size();i++)
+    {
+    if(vtkCPBenchmarkPipeline::GetPipelineTypeFromString(
+         pipelines[i].c_str()) < 0)
+      {
+      cerr << "Unknown pipeline " << pipelines[i] << endl;
+      errors++;
+      }
+    }
+
+  bool printed = false;
+  for(size_t d=0;!errors && d<sizes.size();d++)
+    {
+    for(size_t f=0;f<frequencies.size();f++)
+      {
+      for(size_t p=0;p<pipelines.size();p++)
+        {
+        int size = atoi(sizes[d].c_str());
+        int dimensions[3] = {size, size, size};
+        vtkCPBenchmarkDriver* driver = vtkCPBenchmarkDriver::New();
+        driver->SetNumberOfTimeSteps(numberOfTimeSteps);
+        driver->SetStartTime(0);
+        driver->SetEndTime(1);
+        driver->SetSolverStepTime(solverStepTime);
+        driver->SetDimensions(dimensions);
+        driver->SetAsynchronousExecution(asynchronous);
+        vtkCPBenchmarkPipeline* pipeline = driver->GetPipeline();
+        pipeline->SetPipelineType(
+          vtkCPBenchmarkPipeline::GetPipelineTypeFromString(
+            pipelines[p].c_str()));
+        pipeline->SetOutputFrequency(atoi(frequencies[f].c_str()));
+        pipeline->SetOutputDirectory(outputDirectory);
+        errors += driver->Run();
+
+        int myid = 0;
+#ifdef COPROCESSOR_USE_MPI
+        MPI_Comm_rank(MPI_COMM_WORLD, &myid);
+#endif
+        if(myid == 0)
+          {
+          if(!printed)
+            {
+            cout << "procs size pipeline freq";
+            for(int i=0;i<vtkCPBenchmarkDriver::NUMBER_OF_PHASES;i++)
+              {
+              cout << " " << vtkCPBenchmarkDriver::GetPhaseName(i);
+              }
+            cout << " overhead\n";
+            printed = true;
+            }
+          // times are per time step, the others as a fraction of the solver
+          double solver = driver->GetAverageTime(vtkCPBenchmarkDriver::SOLVER);
+          double overhead = 0;
+          cout << driver->GetNumberOfProcesses() << " " << size << " "
+               << pipelines[p] << " " << frequencies[f] << " "
+               << std::setprecision(4) << solver;
+          for(int i=vtkCPBenchmarkDriver::SOLVER+1;
+              i<vtkCPBenchmarkDriver::NUMBER_OF_PHASES;i++)
+            {
+            double fraction = solver > 0 ? driver->GetAverageTime(i)/solver : 0;
+            overhead += fraction;
+            cout << " " << fraction;
+            }
+          cout << " " << overhead << endl;
+          }
+        driver->Delete();
+        }
+      }
+    }
+
+#ifdef COPROCESSOR_USE_MPI
+  MPI_Finalize();
+#endif
+
+  return errors;
+}
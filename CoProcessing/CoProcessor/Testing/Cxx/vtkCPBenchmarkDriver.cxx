@@ -0,0 +1,239 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    vtkCPBenchmarkDriver.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkCPBenchmarkDriver.h"
+
+#include "CPSystemInformation.h"
+#include "vtkCPBenchmarkPipeline.h"
+#include "vtkCPDataDescription.h"
+#include "vtkCPInputDataDescription.h"
+#include "vtkCPLinearScalarFieldFunction.h"
+#include "vtkCPNodalFieldBuilder.h"
+#include "vtkCPProcessor.h"
+#include "vtkCPUniformGridBuilder.h"
+#include "vtkDataObject.h"
+#include "vtkObjectFactory.h"
+#include "vtkSmartPointer.h"
+#include "vtkTimerLog.h"
+
+#ifdef COPROCESSOR_USE_MPI
+#include "vtkMPICommunicator.h"
+#endif
+
+namespace
+{
+  const char* PhaseNames[vtkCPBenchmarkDriver::NUMBER_OF_PHASES] =
+    {"solver", "adaptor", "request", "coprocess", "write"};
+}
+
+vtkStandardNewMacro(vtkCPBenchmarkDriver);
+
+//----------------------------------------------------------------------------
+vtkCPBenchmarkDriver::vtkCPBenchmarkDriver()
+{
+  this->SolverStepTime = 1;
+  this->Dimensions[0] = this->Dimensions[1] = this->Dimensions[2] = 50;
+  this->AsynchronousExecution = false;
+  this->NumberOfProcesses = 1;
+  this->ProcessId = 0;
+#ifdef COPROCESSOR_USE_MPI
+  vtkMPICommunicator* communicator = vtkMPICommunicator::GetWorldCommunicator();
+  this->NumberOfProcesses = communicator->GetNumberOfProcesses();
+  this->ProcessId = communicator->GetLocalProcessId();
+#endif
+  this->Pipeline = vtkCPBenchmarkPipeline::New();
+  this->Pipeline->SetArrayName("Pressure");
+  this->Pipeline->SetProcessId(this->ProcessId);
+  for(int i=0;i<NUMBER_OF_PHASES;i++)
+    {
+    this->PhaseTimes[i] = 0;
+    }
+}
+
+//----------------------------------------------------------------------------
+vtkCPBenchmarkDriver::~vtkCPBenchmarkDriver()
+{
+  this->Pipeline->Delete();
+}
+
+//----------------------------------------------------------------------------
+vtkCPBenchmarkPipeline* vtkCPBenchmarkDriver::GetPipeline()
+{
+  return this->Pipeline;
+}
+
+//----------------------------------------------------------------------------
+const char* vtkCPBenchmarkDriver::GetPhaseName(int phase)
+{
+  if(phase < 0 || phase >= NUMBER_OF_PHASES)
+    {
+    return "unknown";
+    }
+  return PhaseNames[phase];
+}
+
+//----------------------------------------------------------------------------
+double vtkCPBenchmarkDriver::GetAverageTime(int phase)
+{
+  if(phase < 0 || phase >= NUMBER_OF_PHASES ||
+     this->GetNumberOfTimeSteps() == 0)
+    {
+    return 0;
+    }
+  return this->PhaseTimes[phase]/this->GetNumberOfTimeSteps();
+}
+
+//----------------------------------------------------------------------------
+void vtkCPBenchmarkDriver::SolverStep()
+{
+  // spin rather than sleep so that the process keeps its core busy like
+  // a real solver would
+  double end = vtkTimerLog::GetUniversalTime() + this->SolverStepTime;
+  volatile double work = 0;
+  while(vtkTimerLog::GetUniversalTime() < end)
+    {
+    for(int i=0;i<1000;i++)
+      {
+      work += i*.5;
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+int vtkCPBenchmarkDriver::Run()
+{
+  for(int i=0;i<NUMBER_OF_PHASES;i++)
+    {
+    this->PhaseTimes[i] = 0;
+    }
+
+  // the simulation: a linear pressure field on a uniform grid
+  vtkSmartPointer<vtkCPLinearScalarFieldFunction> fieldFunction =
+    vtkSmartPointer<vtkCPLinearScalarFieldFunction>::New();
+  fieldFunction->SetConstant(2.);
+  fieldFunction->SetTimeMultiplier(100);
+  fieldFunction->SetXMultiplier(23.);
+  fieldFunction->SetYMultiplier(15.);
+  fieldFunction->SetZMultiplier(8.);
+
+  vtkSmartPointer<vtkCPNodalFieldBuilder> fieldBuilder =
+    vtkSmartPointer<vtkCPNodalFieldBuilder>::New();
+  fieldBuilder->SetArrayName("Pressure");
+  fieldBuilder->SetTensorFieldFunction(fieldFunction);
+
+  vtkSmartPointer<vtkCPUniformGridBuilder> gridBuilder =
+    vtkSmartPointer<vtkCPUniformGridBuilder>::New();
+  gridBuilder->SetDimensions(this->Dimensions);
+  double spacing[3] = {1, 1, 1};
+  gridBuilder->SetSpacing(spacing);
+  double origin[3] = {this->ProcessId*(this->Dimensions[0]-1.), 0, 0};
+  gridBuilder->SetOrigin(origin);
+  gridBuilder->SetFieldBuilder(fieldBuilder);
+  this->SetGridBuilder(gridBuilder);
+
+  vtkSmartPointer<vtkCPProcessor> processor =
+    vtkSmartPointer<vtkCPProcessor>::New();
+  processor->Initialize();
+  processor->AddPipeline(this->Pipeline);
+  processor->SetAsynchronousExecution(this->AsynchronousExecution);
+
+  int errors = 0;
+  int handedOff = 0;
+  int processedBefore = this->Pipeline->GetNumberOfProcessedTimeSteps();
+  for(unsigned long i=0;i<this->GetNumberOfTimeSteps();i++)
+    {
+    double start = vtkTimerLog::GetUniversalTime();
+    this->SolverStep();
+    double end = vtkTimerLog::GetUniversalTime();
+    this->PhaseTimes[SOLVER] += end - start;
+
+    vtkSmartPointer<vtkCPDataDescription> dataDescription =
+      vtkSmartPointer<vtkCPDataDescription>::New();
+    double time = this->GetTime(i);
+    dataDescription->SetTimeData(time, i);
+    dataDescription->AddInput("input");
+
+    start = vtkTimerLog::GetUniversalTime();
+    int coProcess = processor->RequestDataDescription(dataDescription);
+    end = vtkTimerLog::GetUniversalTime();
+    this->PhaseTimes[REQUEST_DATA_DESCRIPTION] += end - start;
+    if(!coProcess)
+      {
+      continue;
+      }
+
+    start = vtkTimerLog::GetUniversalTime();
+    int builtNewGrid = 0;
+    vtkDataObject* grid = gridBuilder->GetGrid(i, time, builtNewGrid);
+    dataDescription->GetInputDescriptionByName("input")->SetGrid(grid);
+    end = vtkTimerLog::GetUniversalTime();
+    this->PhaseTimes[ADAPTOR] += end - start;
+
+    start = vtkTimerLog::GetUniversalTime();
+    if(!processor->CoProcess(dataDescription))
+      {
+      errors++;
+      }
+    handedOff++;
+    end = vtkTimerLog::GetUniversalTime();
+    // asynchronously the pipeline writes on the analysis thread, which the
+    // simulation does not wait for
+    double writeTime = this->AsynchronousExecution ?
+      0 : this->Pipeline->GetLastWriteTime();
+    this->PhaseTimes[CO_PROCESS] += end - start - writeTime;
+    this->PhaseTimes[WRITE] += writeTime;
+    }
+  processor->Finalize();
+
+  // Finalize() waits for the analysis thread, and BLOCK, the default back
+  // pressure, never skips a time step
+  int processed =
+    this->Pipeline->GetNumberOfProcessedTimeSteps() - processedBefore;
+  if(processed != handedOff)
+    {
+    vtkErrorMacro("Processed " << processed << " of the " << handedOff
+                  << " time steps handed to the co-processor.");
+    errors++;
+    }
+
+  this->ReduceTimes();
+  return errors;
+}
+
+//----------------------------------------------------------------------------
+void vtkCPBenchmarkDriver::ReduceTimes()
+{
+#ifdef COPROCESSOR_USE_MPI
+  double maxTimes[NUMBER_OF_PHASES];
+  vtkMPICommunicator::GetWorldCommunicator()->AllReduce(
+    this->PhaseTimes, maxTimes, NUMBER_OF_PHASES, vtkCommunicator::MAX_OP);
+  for(int i=0;i<NUMBER_OF_PHASES;i++)
+    {
+    this->PhaseTimes[i] = maxTimes[i];
+    }
+#endif
+}
+
+//----------------------------------------------------------------------------
+void vtkCPBenchmarkDriver::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "SolverStepTime: " << this->SolverStepTime << endl;
+  os << indent << "Dimensions: " << this->Dimensions[0] << " "
+     << this->Dimensions[1] << " " << this->Dimensions[2] << endl;
+  os << indent << "AsynchronousExecution: " << this->AsynchronousExecution
+     << endl;
+  os << indent << "NumberOfProcesses: " << this->NumberOfProcesses << endl;
+  os << indent << "Pipeline: " << this->Pipeline << endl;
+}
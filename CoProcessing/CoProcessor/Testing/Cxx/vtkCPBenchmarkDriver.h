@@ -0,0 +1,123 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    vtkCPBenchmarkDriver.h
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME vtkCPBenchmarkDriver - A test driver that measures co-processing overhead.
+// .SECTION Description
+// vtkCPBenchmarkDriver replays a fake simulation. Each time step spends
+// SolverStepTime seconds of busy work standing in for the solver, then
+// calls the co-processing library the way an adaptor would, running a
+// vtkCPBenchmarkPipeline on a uniform grid with a "Pressure" point field.
+// Each process owns a block of Dimensions points. The blocks are laid out
+// along x.
+//
+// The time spent in the solver, the adaptor (building the grid and its
+// fields), RequestDataDescription(), CoProcess() and writing are recorded
+// separately. Averages are taken over the time steps and the maximum is
+// taken over the processes.
+
+#ifndef __vtkCPBenchmarkDriver_h
+#define __vtkCPBenchmarkDriver_h
+
+#include "vtkCPTestDriver.h"
+
+class vtkCPBenchmarkPipeline;
+
+class VTK_EXPORT vtkCPBenchmarkDriver : public vtkCPTestDriver
+{
+public:
+  static vtkCPBenchmarkDriver * New();
+  vtkTypeMacro(vtkCPBenchmarkDriver, vtkCPTestDriver);
+  void PrintSelf(ostream& os, vtkIndent indent);
+
+  //BTX
+  enum Phases
+  {
+    SOLVER = 0,
+    ADAPTOR,
+    REQUEST_DATA_DESCRIPTION,
+    CO_PROCESS,
+    WRITE,
+    NUMBER_OF_PHASES
+  };
+  //ETX
+
+  // Description:
+  // Run the fake simulation with the co-processor and gather the timings.
+  // Returns 0 if there were no errors.
+  virtual int Run();
+
+  // Description:
+  // Set/get the number of seconds the fake solver works each time step.
+  vtkSetMacro(SolverStepTime, double);
+  vtkGetMacro(SolverStepTime, double);
+
+  // Description:
+  // Set/get the number of points of each process' block of the grid.
+  vtkSetVector3Macro(Dimensions, int);
+  vtkGetVector3Macro(Dimensions, int);
+
+  // Description:
+  // Set/get whether the co-processor runs the pipeline on its analysis
+  // thread.  Off by default.  Run() then also checks that every time step
+  // that was handed to the co-processor was processed.
+  vtkSetMacro(AsynchronousExecution, bool);
+  vtkGetMacro(AsynchronousExecution, bool);
+  vtkBooleanMacro(AsynchronousExecution, bool);
+
+  // Description:
+  // The pipeline that is run.  It may be configured before calling Run().
+  vtkCPBenchmarkPipeline* GetPipeline();
+
+  // Description:
+  // After Run(), the average time in seconds per time step spent in a phase,
+  // the maximum over all processes.
+  double GetAverageTime(int phase);
+
+  // Description:
+  // Return the name of a phase.
+  static const char* GetPhaseName(int phase);
+
+  // Description:
+  // Get the number of processes the benchmark ran on.
+  vtkGetMacro(NumberOfProcesses, int);
+
+protected:
+  vtkCPBenchmarkDriver();
+  ~vtkCPBenchmarkDriver();
+
+  // Description:
+  // Busy wait for SolverStepTime seconds.
+  void SolverStep();
+
+  // Description:
+  // Take the maximum of the phase times over all processes.
+  void ReduceTimes();
+
+private:
+  vtkCPBenchmarkDriver(const vtkCPBenchmarkDriver&); // Not implemented
+  void operator=(const vtkCPBenchmarkDriver&); // Not implemented
+
+  double SolverStepTime;
+  int Dimensions[3];
+  bool AsynchronousExecution;
+  int NumberOfProcesses;
+  int ProcessId;
+  vtkCPBenchmarkPipeline* Pipeline;
+
+  // Description:
+  // Total time spent in each phase.
+  double PhaseTimes[NUMBER_OF_PHASES];
+};
+
+#endif
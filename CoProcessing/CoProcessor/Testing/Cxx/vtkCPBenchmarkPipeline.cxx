@@ -0,0 +1,308 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    vtkCPBenchmarkPipeline.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkCPBenchmarkPipeline.h"
+
+#include "vtkActor.h"
+#include "vtkContourFilter.h"
+#include "vtkCPDataDescription.h"
+#include "vtkCPInputDataDescription.h"
+#include "vtkCutter.h"
+#include "vtkDataArray.h"
+#include "vtkDataObject.h"
+#include "vtkDataSet.h"
+#include "vtkDataSetSurfaceFilter.h"
+#include "vtkExtractVOI.h"
+#include "vtkImageData.h"
+#include "vtkObjectFactory.h"
+#include "vtkPlane.h"
+#include "vtkPNGWriter.h"
+#include "vtkPointData.h"
+#include "vtkPolyDataMapper.h"
+#include "vtkRenderer.h"
+#include "vtkRenderWindow.h"
+#include "vtkSmartPointer.h"
+#include "vtkTimerLog.h"
+#include "vtkWindowToImageFilter.h"
+#include "vtkXMLDataSetWriter.h"
+
+#include <sstream>
+#include <string.h>
+
+namespace
+{
+  const char* PipelineTypeNames[vtkCPBenchmarkPipeline::NUMBER_OF_PIPELINE_TYPES] =
+    {"slice", "contour", "image", "extract"};
+}
+
+// Rendering objects are kept between time steps, like a co-processing
+// script keeps its views.
+class vtkCPBenchmarkPipeline::vtkInternals
+{
+public:
+  vtkSmartPointer<vtkDataSetSurfaceFilter> Surface;
+  vtkSmartPointer<vtkPolyDataMapper> Mapper;
+  vtkSmartPointer<vtkRenderer> Renderer;
+  vtkSmartPointer<vtkRenderWindow> RenderWindow;
+};
+
+vtkStandardNewMacro(vtkCPBenchmarkPipeline);
+
+//----------------------------------------------------------------------------
+vtkCPBenchmarkPipeline::vtkCPBenchmarkPipeline()
+{
+  this->PipelineType = SLICE;
+  this->OutputFrequency = 1;
+  this->ArrayName = 0;
+  this->OutputDirectory = 0;
+  this->ProcessId = 0;
+  this->LastWriteTime = 0;
+  this->NumberOfProcessedTimeSteps = 0;
+  this->Internals = new vtkInternals;
+}
+
+//----------------------------------------------------------------------------
+vtkCPBenchmarkPipeline::~vtkCPBenchmarkPipeline()
+{
+  this->SetArrayName(0);
+  this->SetOutputDirectory(0);
+  delete this->Internals;
+}
+
+//----------------------------------------------------------------------------
+const char* vtkCPBenchmarkPipeline::GetPipelineTypeAsString(int type)
+{
+  if(type < 0 || type >= NUMBER_OF_PIPELINE_TYPES)
+    {
+    return "unknown";
+    }
+  return PipelineTypeNames[type];
+}
+
+//----------------------------------------------------------------------------
+int vtkCPBenchmarkPipeline::GetPipelineTypeFromString(const char* name)
+{
+  for(int i=0;name && i<NUMBER_OF_PIPELINE_TYPES;i++)
+    {
+    if(strcmp(name, PipelineTypeNames[i]) == 0)
+      {
+      return i;
+      }
+    }
+  return -1;
+}
+
+//----------------------------------------------------------------------------
+int vtkCPBenchmarkPipeline::RequestDataDescription(
+  vtkCPDataDescription* dataDescription)
+{
+  if(!dataDescription)
+    {
+    vtkWarningMacro("dataDescription is NULL.");
+    return 0;
+    }
+  if(dataDescription->GetTimeStep() % this->OutputFrequency != 0 &&
+     !dataDescription->GetForceOutput())
+    {
+    return 0;
+    }
+  vtkCPInputDataDescription* input =
+    dataDescription->GetInputDescriptionByName("input");
+  if(!input)
+    {
+    vtkWarningMacro("Expected an input named \"input\".");
+    return 0;
+    }
+  if(this->ArrayName)
+    {
+    input->AddPointField(this->ArrayName);
+    }
+  else
+    {
+    input->AllFieldsOn();
+    }
+  input->GenerateMeshOn();
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+int vtkCPBenchmarkPipeline::CoProcess(vtkCPDataDescription* dataDescription)
+{
+  this->LastWriteTime = 0;
+  vtkCPInputDataDescription* input = dataDescription ?
+    dataDescription->GetInputDescriptionByName("input") : 0;
+  vtkDataSet* grid = input ? vtkDataSet::SafeDownCast(input->GetGrid()) : 0;
+  if(!grid)
+    {
+    vtkWarningMacro("No grid to process.");
+    return 0;
+    }
+  vtkIdType timeStep = dataDescription->GetTimeStep();
+
+  double center[3];
+  grid->GetCenter(center);
+  switch(this->PipelineType)
+    {
+    case SLICE:
+    {
+    vtkSmartPointer<vtkPlane> plane = vtkSmartPointer<vtkPlane>::New();
+    plane->SetOrigin(center);
+    plane->SetNormal(0, 0, 1);
+    vtkSmartPointer<vtkCutter> cutter = vtkSmartPointer<vtkCutter>::New();
+    cutter->SetCutFunction(plane);
+    cutter->SetInput(grid);
+    cutter->Update();
+    this->WriteData(cutter->GetOutput(), timeStep);
+    break;
+    }
+    case CONTOUR:
+    {
+    vtkDataArray* array = this->ArrayName ?
+      grid->GetPointData()->GetArray(this->ArrayName) :
+      grid->GetPointData()->GetScalars();
+    if(!array)
+      {
+      vtkWarningMacro("No point field to contour.");
+      return 0;
+      }
+    double range[2];
+    array->GetRange(range, 0);
+    vtkSmartPointer<vtkContourFilter> contour =
+      vtkSmartPointer<vtkContourFilter>::New();
+    contour->SetInput(grid);
+    contour->SetInputArrayToProcess(0, 0, 0,
+      vtkDataObject::FIELD_ASSOCIATION_POINTS, array->GetName());
+    contour->SetValue(0, .5*(range[0]+range[1]));
+    contour->Update();
+    this->WriteData(contour->GetOutput(), timeStep);
+    break;
+    }
+    case IMAGE:
+    {
+    this->RenderImage(grid, timeStep);
+    break;
+    }
+    case EXTRACT:
+    {
+    vtkImageData* image = vtkImageData::SafeDownCast(grid);
+    if(!image)
+      {
+      this->WriteData(grid, timeStep);
+      break;
+      }
+    vtkSmartPointer<vtkExtractVOI> extract =
+      vtkSmartPointer<vtkExtractVOI>::New();
+    extract->SetInput(image);
+    extract->SetVOI(image->GetExtent());
+    extract->SetSampleRate(2, 2, 2);
+    extract->Update();
+    this->WriteData(extract->GetOutput(), timeStep);
+    break;
+    }
+    }
+  this->NumberOfProcessedTimeSteps++;
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+void vtkCPBenchmarkPipeline::RenderImage(vtkDataObject* data,
+                                         vtkIdType timeStep)
+{
+  vtkInternals* internals = this->Internals;
+  if(!internals->RenderWindow)
+    {
+    internals->Surface = vtkSmartPointer<vtkDataSetSurfaceFilter>::New();
+    internals->Mapper = vtkSmartPointer<vtkPolyDataMapper>::New();
+    internals->Mapper->SetInputConnection(
+      internals->Surface->GetOutputPort());
+    internals->Mapper->SetScalarModeToUsePointFieldData();
+    vtkSmartPointer<vtkActor> actor = vtkSmartPointer<vtkActor>::New();
+    actor->SetMapper(internals->Mapper);
+    internals->Renderer = vtkSmartPointer<vtkRenderer>::New();
+    internals->Renderer->AddActor(actor);
+    internals->RenderWindow = vtkSmartPointer<vtkRenderWindow>::New();
+    internals->RenderWindow->SetOffScreenRendering(1);
+    internals->RenderWindow->SetSize(400, 400);
+    internals->RenderWindow->AddRenderer(internals->Renderer);
+    }
+  vtkDataSet* grid = vtkDataSet::SafeDownCast(data);
+  internals->Surface->SetInput(grid);
+  vtkDataArray* array = this->ArrayName ?
+    grid->GetPointData()->GetArray(this->ArrayName) :
+    grid->GetPointData()->GetScalars();
+  if(array)
+    {
+    internals->Mapper->SelectColorArray(array->GetName());
+    internals->Mapper->SetScalarRange(array->GetRange(0));
+    }
+  internals->Renderer->ResetCamera();
+  internals->RenderWindow->Render();
+
+  if(!this->OutputDirectory)
+    {
+    return;
+    }
+  // grabbing the frame buffer counts as part of the write
+  double start = vtkTimerLog::GetUniversalTime();
+  vtkSmartPointer<vtkWindowToImageFilter> grabber =
+    vtkSmartPointer<vtkWindowToImageFilter>::New();
+  grabber->SetInput(internals->RenderWindow);
+  std::ostringstream fileName;
+  fileName << this->OutputDirectory << "/image_" << this->ProcessId
+           << "_" << timeStep << ".png";
+  vtkSmartPointer<vtkPNGWriter> writer = vtkSmartPointer<vtkPNGWriter>::New();
+  writer->SetInputConnection(grabber->GetOutputPort());
+  writer->SetFileName(fileName.str().c_str());
+  writer->Write();
+  this->LastWriteTime += vtkTimerLog::GetUniversalTime() - start;
+}
+
+//----------------------------------------------------------------------------
+void vtkCPBenchmarkPipeline::WriteData(vtkDataObject* data,
+                                       vtkIdType timeStep)
+{
+  if(!this->OutputDirectory)
+    {
+    return;
+    }
+  double start = vtkTimerLog::GetUniversalTime();
+  std::ostringstream fileName;
+  fileName << this->OutputDirectory << "/"
+           << GetPipelineTypeAsString(this->PipelineType) << "_"
+           << this->ProcessId << "_" << timeStep << "."
+           << (data->IsA("vtkPolyData") ? "vtp" : "vti");
+  vtkSmartPointer<vtkXMLDataSetWriter> writer =
+    vtkSmartPointer<vtkXMLDataSetWriter>::New();
+  writer->SetInput(data);
+  writer->SetFileName(fileName.str().c_str());
+  writer->Write();
+  this->LastWriteTime += vtkTimerLog::GetUniversalTime() - start;
+}
+
+//----------------------------------------------------------------------------
+void vtkCPBenchmarkPipeline::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "PipelineType: "
+     << GetPipelineTypeAsString(this->PipelineType) << endl;
+  os << indent << "OutputFrequency: " << this->OutputFrequency << endl;
+  os << indent << "ArrayName: "
+     << (this->ArrayName ? this->ArrayName : "(NULL)") << endl;
+  os << indent << "OutputDirectory: "
+     << (this->OutputDirectory ? this->OutputDirectory : "(NULL)") << endl;
+  os << indent << "ProcessId: " << this->ProcessId << endl;
+  os << indent << "LastWriteTime: " << this->LastWriteTime << endl;
+  os << indent << "NumberOfProcessedTimeSteps: "
+     << this->NumberOfProcessedTimeSteps << endl;
+}
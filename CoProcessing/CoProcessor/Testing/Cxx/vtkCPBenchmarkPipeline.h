@@ -0,0 +1,127 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    vtkCPBenchmarkPipeline.h
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME vtkCPBenchmarkPipeline - A C++ co-processing pipeline for benchmarks.
+// .SECTION Description
+// A vtkCPPipeline that runs one of a few typical in-situ analyses on the
+// "input" grid every OutputFrequency time steps: a slice, a contour, a
+// rendered image or a subsampled extract of the data.  The results are
+// written to OutputDirectory, one file per process and time step, unless
+// it is not set.  The time spent writing is reported separately so that
+// the benchmark driver can tell filtering cost from I/O cost.
+
+#ifndef __vtkCPBenchmarkPipeline_h
+#define __vtkCPBenchmarkPipeline_h
+
+#include "vtkCPPipeline.h"
+
+class vtkDataObject;
+
+class VTK_EXPORT vtkCPBenchmarkPipeline : public vtkCPPipeline
+{
+public:
+  static vtkCPBenchmarkPipeline * New();
+  vtkTypeMacro(vtkCPBenchmarkPipeline, vtkCPPipeline);
+  void PrintSelf(ostream& os, vtkIndent indent);
+
+  //BTX
+  enum PipelineTypes
+  {
+    SLICE = 0,
+    CONTOUR,
+    IMAGE,
+    EXTRACT,
+    NUMBER_OF_PIPELINE_TYPES
+  };
+  //ETX
+
+  // Description:
+  // Set/get the analysis that is run.  Default is SLICE.
+  vtkSetClampMacro(PipelineType, int, SLICE, EXTRACT);
+  vtkGetMacro(PipelineType, int);
+
+  // Description:
+  // Convert between pipeline types and their names ("slice", "contour",
+  // "image" and "extract").  GetPipelineTypeFromString() returns -1 for an
+  // unknown name.
+  static const char* GetPipelineTypeAsString(int type);
+  static int GetPipelineTypeFromString(const char* name);
+
+  // Description:
+  // Set/get how often, in time steps, the pipeline runs.  Default is 1.
+  vtkSetClampMacro(OutputFrequency, int, 1, VTK_INT_MAX);
+  vtkGetMacro(OutputFrequency, int);
+
+  // Description:
+  // Set/get the name of the point field that is contoured and colored by.
+  vtkSetStringMacro(ArrayName);
+  vtkGetStringMacro(ArrayName);
+
+  // Description:
+  // Set/get the directory the results are written to.  Nothing is written
+  // when it is not set.
+  vtkSetStringMacro(OutputDirectory);
+  vtkGetStringMacro(OutputDirectory);
+
+  // Description:
+  // Set/get the id of this process, used to name the output files.
+  vtkSetMacro(ProcessId, int);
+  vtkGetMacro(ProcessId, int);
+
+  // Description:
+  // Request the field when this time step should be processed.
+  virtual int RequestDataDescription(vtkCPDataDescription* dataDescription);
+
+  // Description:
+  // Run the analysis and write its result.
+  virtual int CoProcess(vtkCPDataDescription* dataDescription);
+
+  // Description:
+  // Time in seconds the last call to CoProcess() spent writing files.
+  vtkGetMacro(LastWriteTime, double);
+
+  // Description:
+  // Number of time steps CoProcess() has processed successfully.
+  vtkGetMacro(NumberOfProcessedTimeSteps, int);
+
+protected:
+  vtkCPBenchmarkPipeline();
+  ~vtkCPBenchmarkPipeline();
+
+  // Description:
+  // Write data to OutputDirectory and add the time it took to
+  // LastWriteTime.
+  void WriteData(vtkDataObject* data, vtkIdType timeStep);
+
+  // Description:
+  // Render the surface of data and write the image.
+  void RenderImage(vtkDataObject* data, vtkIdType timeStep);
+
+  int PipelineType;
+  int OutputFrequency;
+  char* ArrayName;
+  char* OutputDirectory;
+  int ProcessId;
+  double LastWriteTime;
+  int NumberOfProcessedTimeSteps;
+
+private:
+  vtkCPBenchmarkPipeline(const vtkCPBenchmarkPipeline&); // Not implemented
+  void operator=(const vtkCPBenchmarkPipeline&); // Not implemented
+
+  class vtkInternals;
+  vtkInternals* Internals;
+};
+
+#endif
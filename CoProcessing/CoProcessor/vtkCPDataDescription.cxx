@@ -47,6 +47,14 @@ vtkCPDataDescription::vtkCPDataDescription()
   this->IsTimeDataSet = false;
   this->ForceOutput = false;
   this->UserData = NULL;
+  this->LastSnapshotTime = 0;
+  this->LastBlockedTime = 0;
+  this->LastQueuedTime = 0;
+  this->LastExecutionTime = 0;
+  this->NumberOfExecutedTimeSteps = 0;
+  this->NumberOfSkippedTimeSteps = 0;
+  this->NumberOfDroppedTimeSteps = 0;
+  this->NumberOfPendingTimeSteps = 0;
 
   this->Internals = new vtkInternals();
 }
@@ -134,6 +142,58 @@ vtkCPInputDataDescription* vtkCPDataDescription::GetInputDescriptionByName(
   return NULL;
 }
 
+//----------------------------------------------------------------------------
+const char* vtkCPDataDescription::GetInputDescriptionName(unsigned int index)
+{
+  unsigned int cur_index=0;
+  vtkInternals::GridDescriptionMapType::iterator iter;
+  for (iter = this->Internals->GridDescriptionMap.begin();
+    iter != this->Internals->GridDescriptionMap.end(); ++iter, ++cur_index)
+    {
+    if (cur_index == index)
+      {
+      return iter->first.c_str();
+      }
+    }
+  return NULL;
+}
+
+//----------------------------------------------------------------------------
+void vtkCPDataDescription::Copy(vtkCPDataDescription* from)
+{
+  if(!from || from == this)
+    {
+    return;
+    }
+  this->Time = from->Time;
+  this->TimeStep = from->TimeStep;
+  this->IsTimeDataSet = from->IsTimeDataSet;
+  this->ForceOutput = from->ForceOutput;
+  if(from->UserData)
+    {
+    vtkFieldData* userData = vtkFieldData::New();
+    userData->DeepCopy(from->UserData);
+    this->SetUserData(userData);
+    userData->Delete();
+    }
+  else
+    {
+    this->SetUserData(NULL);
+    }
+
+  this->Internals->GridDescriptionMap.clear();
+  vtkInternals::GridDescriptionMapType::iterator iter;
+  for (iter = from->Internals->GridDescriptionMap.begin();
+    iter != from->Internals->GridDescriptionMap.end(); ++iter)
+    {
+    vtkSmartPointer<vtkCPInputDataDescription> input =
+      vtkSmartPointer<vtkCPInputDataDescription>::New();
+    input->Copy(iter->second);
+    this->Internals->GridDescriptionMap[iter->first] = input;
+    }
+  this->Modified();
+}
+
 //----------------------------------------------------------------------------
 bool vtkCPDataDescription::GetIfAnyGridNecessary()
 {
@@ -187,4 +247,16 @@ void vtkCPDataDescription::PrintSelf(ostream& os, vtkIndent indent)
     {
     os << indent << "UserData: (NULL)\n";
     }
+  os << indent << "LastSnapshotTime: " << this->LastSnapshotTime << "\n";
+  os << indent << "LastBlockedTime: " << this->LastBlockedTime << "\n";
+  os << indent << "LastQueuedTime: " << this->LastQueuedTime << "\n";
+  os << indent << "LastExecutionTime: " << this->LastExecutionTime << "\n";
+  os << indent << "NumberOfExecutedTimeSteps: "
+     << this->NumberOfExecutedTimeSteps << "\n";
+  os << indent << "NumberOfSkippedTimeSteps: "
+     << this->NumberOfSkippedTimeSteps << "\n";
+  os << indent << "NumberOfDroppedTimeSteps: "
+     << this->NumberOfDroppedTimeSteps << "\n";
+  os << indent << "NumberOfPendingTimeSteps: "
+     << this->NumberOfPendingTimeSteps << "\n";
 }
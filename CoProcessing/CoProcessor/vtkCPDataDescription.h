@@ -79,6 +79,9 @@ public:
   /// Provides access to a grid description using the grid name.
   vtkCPInputDataDescription *GetInputDescriptionByName(const char*);
 
+  /// Returns the name of the grid described by the given index.
+  const char* GetInputDescriptionName(unsigned int);
+
   /// Returns true if the grid is necessary, given the grid's name.
   bool GetIfGridIsNecessary(const char*);
 
@@ -93,6 +96,52 @@ public:
   /// adaptor to the coprocessing pipelines.
   vtkGetObjectMacro(UserData, vtkFieldData);
 
+  /// Copy the time information, output forcing, user data and the input
+  /// descriptions of another data description. The grids are shared with
+  /// the other description while the user data is deep copied. The
+  /// statistics below are not copied.
+  void Copy(vtkCPDataDescription* from);
+
+  /// Statistics about the co-processing work, filled in by vtkCPProcessor
+  /// every time RequestDataDescription() or CoProcess() is called. Unlike the
+  /// rest of the description they are not cleared by ResetAll(). Times are
+  /// wall clock seconds.
+  ///
+  /// LastSnapshotTime is the time the simulation spent copying the grids
+  /// of the last asynchronously processed time step.
+  vtkSetMacro(LastSnapshotTime, double);
+  vtkGetMacro(LastSnapshotTime, double);
+
+  /// LastBlockedTime is the time the simulation waited for the analysis
+  /// thread to make room for the last time step.
+  vtkSetMacro(LastBlockedTime, double);
+  vtkGetMacro(LastBlockedTime, double);
+
+  /// LastQueuedTime is the time the last executed time step waited in the
+  /// queue before the analysis thread picked it up.
+  vtkSetMacro(LastQueuedTime, double);
+  vtkGetMacro(LastQueuedTime, double);
+
+  /// LastExecutionTime is the time the pipelines took to process the last
+  /// executed time step.
+  vtkSetMacro(LastExecutionTime, double);
+  vtkGetMacro(LastExecutionTime, double);
+
+  /// Number of time steps that the pipelines have processed, that were
+  /// skipped because the analysis fell behind and that were dropped from
+  /// the queue to make room for newer ones.
+  vtkSetMacro(NumberOfExecutedTimeSteps, vtkIdType);
+  vtkGetMacro(NumberOfExecutedTimeSteps, vtkIdType);
+  vtkSetMacro(NumberOfSkippedTimeSteps, vtkIdType);
+  vtkGetMacro(NumberOfSkippedTimeSteps, vtkIdType);
+  vtkSetMacro(NumberOfDroppedTimeSteps, vtkIdType);
+  vtkGetMacro(NumberOfDroppedTimeSteps, vtkIdType);
+
+  /// Number of time steps that are waiting for or are being processed by
+  /// the analysis thread.
+  vtkSetMacro(NumberOfPendingTimeSteps, vtkIdType);
+  vtkGetMacro(NumberOfPendingTimeSteps, vtkIdType);
+
 //BTX
 protected:
   vtkCPDataDescription();
@@ -122,6 +171,16 @@ private:
   /// it can store a wide variety of data types which are all python wrapped.
   vtkFieldData* UserData;
 
+  /// Co-processing statistics, see the accessors above.
+  double LastSnapshotTime;
+  double LastBlockedTime;
+  double LastQueuedTime;
+  double LastExecutionTime;
+  vtkIdType NumberOfExecutedTimeSteps;
+  vtkIdType NumberOfSkippedTimeSteps;
+  vtkIdType NumberOfDroppedTimeSteps;
+  vtkIdType NumberOfPendingTimeSteps;
+
   class vtkInternals;
   vtkInternals* Internals;
 //ETX
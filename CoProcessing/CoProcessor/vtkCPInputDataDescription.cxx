@@ -66,6 +66,21 @@ void vtkCPInputDataDescription::Reset()
   this->GenerateMesh = false;
 }
 
+//----------------------------------------------------------------------------
+void vtkCPInputDataDescription::Copy(vtkCPInputDataDescription* from)
+{
+  if(!from || from == this)
+    {
+    return;
+    }
+  this->Internals->PointFields = from->Internals->PointFields;
+  this->Internals->CellFields = from->Internals->CellFields;
+  this->AllFields = from->AllFields;
+  this->GenerateMesh = from->GenerateMesh;
+  this->SetWholeExtent(from->WholeExtent);
+  this->SetGrid(from->Grid);
+}
+
 //----------------------------------------------------------------------------
 void vtkCPInputDataDescription::AddPointField(const char* fieldName)
 {
@@ -36,6 +36,11 @@ public:
   // Reset the names of the fields that are needed.
   void Reset();
 
+  // Description:
+  // Copy the requested fields, the flags and the whole extent from
+  // another description. The grid is shared, not copied.
+  void Copy(vtkCPInputDataDescription* from);
+
   // Description:
   // Add in a name of a point field .
   void AddPointField(const char* FieldName);
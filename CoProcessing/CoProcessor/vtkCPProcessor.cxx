@@ -14,12 +14,24 @@
 =========================================================================*/
 #include "vtkCPProcessor.h"
 
+#include "CPSystemInformation.h"
+#include "vtkConditionVariable.h"
 #include "vtkCPDataDescription.h"
+#include "vtkCPInputDataDescription.h"
 #include "vtkCPPipeline.h"
-#include "vtkCPPythonScriptPipeline.h"
+#include "vtkDataObject.h"
+#include "vtkMultiProcessController.h"
+#include "vtkMutexLock.h"
 #include "vtkObjectFactory.h"
 #include "vtkSmartPointer.h"
+#include "vtkTimerLog.h"
 
+#ifdef COPROCESSOR_USE_MPI
+# include "vtkMPI.h"
+# include "vtkMPIController.h"
+#endif
+
+#include <deque>
 #include <list>
 
 struct vtkCPProcessorInternals
@@ -27,6 +39,78 @@ struct vtkCPProcessorInternals
   typedef std::list<vtkSmartPointer<vtkCPPipeline> > PipelineList;
   typedef PipelineList::iterator PipelineListIterator;
   PipelineList Pipelines;
+
+  /// A time step waiting for the analysis thread.
+  struct TimeStep
+  {
+    vtkCPDataDescription* Description;
+    unsigned long Size;
+    double QueuedAt;
+  };
+
+  vtkCPProcessorInternals()
+  {
+    this->Threader = vtkMultiThreader::New();
+    this->ThreadId = -1;
+    this->PipelineListLock = vtkMutexLock::New();
+    this->ExecuteLock = vtkMutexLock::New();
+    this->QueueLock = vtkMutexLock::New();
+    this->QueueChanged = vtkConditionVariable::New();
+    this->Done = false;
+    this->Busy = false;
+    this->Memory = 0;
+    this->WarnedAboutFallback = false;
+    this->SimulationController = NULL;
+    this->AnalysisController = NULL;
+    this->LastSnapshotTime = 0;
+    this->LastBlockedTime = 0;
+    this->LastQueuedTime = 0;
+    this->LastExecutionTime = 0;
+    this->NumberOfExecutedTimeSteps = 0;
+    this->NumberOfSkippedTimeSteps = 0;
+    this->NumberOfDroppedTimeSteps = 0;
+  }
+  ~vtkCPProcessorInternals()
+  {
+    this->Threader->Delete();
+    this->PipelineListLock->Delete();
+    this->ExecuteLock->Delete();
+    this->QueueLock->Delete();
+    this->QueueChanged->Delete();
+  }
+
+  vtkMultiThreader* Threader;
+  int ThreadId;
+  /// Held while the pipeline list is read or modified, never while a
+  /// pipeline runs, so that RequestDataDescription() does not wait for the
+  /// analysis thread.
+  vtkMutexLock* PipelineListLock;
+  /// Held while the pipelines run so that they never run concurrently.
+  vtkMutexLock* ExecuteLock;
+
+  /// Everything below is guarded by QueueLock.
+  vtkMutexLock* QueueLock;
+  vtkConditionVariable* QueueChanged;
+  std::deque<TimeStep> Queue;
+  bool Done;
+  bool Busy;
+  /// Kilobytes held by queued snapshots and the one being processed.
+  unsigned long Memory;
+  bool WarnedAboutFallback;
+
+  /// The global controller when the analysis controller replaced it.
+  vtkMultiProcessController* SimulationController;
+  /// Duplicate of the global controller used by the pipelines while they
+  /// run on the analysis thread of a parallel run.
+  vtkMultiProcessController* AnalysisController;
+
+  double LastSnapshotTime;
+  double LastBlockedTime;
+  double LastQueuedTime;
+  double LastExecutionTime;
+  vtkIdType NumberOfExecutedTimeSteps;
+  vtkIdType NumberOfSkippedTimeSteps;
+  vtkIdType NumberOfDroppedTimeSteps;
 };
 
 vtkStandardNewMacro(vtkCPProcessor);
@@ -35,6 +119,11 @@ vtkStandardNewMacro(vtkCPProcessor);
 vtkCPProcessor::vtkCPProcessor()
 {
   this->Internal = new vtkCPProcessorInternals;
+  this->AsynchronousExecution = false;
+  this->BackPressureMode = BLOCK;
+  this->MaximumNumberOfPendingTimeSteps = 1;
+  this->SnapshotMode = DEEP_COPY;
+  this->SnapshotMemoryBudget = 0;
 }
 
 //----------------------------------------------------------------------------
@@ -42,6 +131,7 @@ vtkCPProcessor::~vtkCPProcessor()
 {
   if(this->Internal)
     {
+    this->StopAnalysisThread();
     delete this->Internal;
     this->Internal = NULL;
     }
@@ -55,7 +145,9 @@ int vtkCPProcessor::AddPipeline(vtkCPPipeline* pipeline)
     vtkErrorMacro("Pipeline is NULL.");
     return 0;
     }
+  this->Internal->PipelineListLock->Lock();
   this->Internal->Pipelines.push_back(pipeline);
+  this->Internal->PipelineListLock->Unlock();
   return 1;
 }
 
@@ -90,13 +182,17 @@ vtkCPPipeline* vtkCPProcessor::GetPipeline(int which)
 //----------------------------------------------------------------------------
 void vtkCPProcessor::RemovePipeline(vtkCPPipeline* pipeline)
 {
+  this->Internal->PipelineListLock->Lock();
   this->Internal->Pipelines.remove(pipeline);
+  this->Internal->PipelineListLock->Unlock();
 }
 
 //----------------------------------------------------------------------------
 void vtkCPProcessor::RemoveAllPipelines()
 {
+  this->Internal->PipelineListLock->Lock();
   this->Internal->Pipelines.clear();
+  this->Internal->PipelineListLock->Unlock();
 }
 
 //----------------------------------------------------------------------------
@@ -115,16 +211,45 @@ int vtkCPProcessor::RequestDataDescription(
     return 0;
     }
   dataDescription->ResetInputDescriptions();
+
+  if(this->AsynchronousExecution && this->BackPressureMode == SKIP &&
+     this->CanExecuteAsynchronously())
+    {
+    // skip without consulting the pipelines, which may be busy on the
+    // analysis thread
+    vtkCPProcessorInternals* internal = this->Internal;
+    internal->QueueLock->Lock();
+    bool full = (static_cast<int>(internal->Queue.size()) >=
+                 this->MaximumNumberOfPendingTimeSteps);
+    if(full)
+      {
+      internal->NumberOfSkippedTimeSteps++;
+      }
+    internal->QueueLock->Unlock();
+    if(full)
+      {
+      this->UpdateStatistics(dataDescription);
+      return 0;
+      }
+    }
+
   int doCoProcessing = 0;
-  for(vtkCPProcessorInternals::PipelineListIterator iter =
-        this->Internal->Pipelines.begin();
-      iter!=this->Internal->Pipelines.end();iter++)
+  this->Internal->PipelineListLock->Lock();
+  vtkCPProcessorInternals::PipelineList pipelines = this->Internal->Pipelines;
+  this->Internal->PipelineListLock->Unlock();
+  for(vtkCPProcessorInternals::PipelineListIterator iter = pipelines.begin();
+      iter!=pipelines.end();iter++)
     {
     if(iter->GetPointer()->RequestDataDescription(dataDescription))
       {
       doCoProcessing = 1;
       }
     }
+  // reference counts are not atomic, release the copy under the lock too
+  this->Internal->PipelineListLock->Lock();
+  pipelines.clear();
+  this->Internal->PipelineListLock->Unlock();
+  this->UpdateStatistics(dataDescription);
   return doCoProcessing;
 }
 
@@ -137,24 +262,386 @@ int vtkCPProcessor::CoProcess(vtkCPDataDescription* dataDescription)
     return 0;
     }
   int success = 1;
-  for(vtkCPProcessorInternals::PipelineListIterator iter =
-        this->Internal->Pipelines.begin();
-      iter!=this->Internal->Pipelines.end();iter++)
+  if(this->AsynchronousExecution && this->CanExecuteAsynchronously())
+    {
+    success = this->EnqueueTimeStep(dataDescription);
+    }
+  else
+    {
+    double start = vtkTimerLog::GetUniversalTime();
+    success = this->ExecutePipelines(dataDescription);
+    this->Internal->LastExecutionTime =
+      vtkTimerLog::GetUniversalTime() - start;
+    this->Internal->NumberOfExecutedTimeSteps++;
+    }
+  this->UpdateStatistics(dataDescription);
+  // we want to reset everything here to make sure that new information
+  // is properly passed in the next time.
+  dataDescription->ResetAll();
+  return success;
+}
+
+//----------------------------------------------------------------------------
+int vtkCPProcessor::ExecutePipelines(vtkCPDataDescription* dataDescription)
+{
+  int success = 1;
+  this->Internal->PipelineListLock->Lock();
+  vtkCPProcessorInternals::PipelineList pipelines = this->Internal->Pipelines;
+  this->Internal->PipelineListLock->Unlock();
+  this->Internal->ExecuteLock->Lock();
+  for(vtkCPProcessorInternals::PipelineListIterator iter = pipelines.begin();
+      iter!=pipelines.end();iter++)
     {
     if(!iter->GetPointer()->CoProcess(dataDescription))
       {
       success = 0;
       }
     }
-  // we want to reset everything here to make sure that new information
-  // is properly passed in the next time.
-  dataDescription->ResetAll();
+  this->Internal->ExecuteLock->Unlock();
+  this->Internal->PipelineListLock->Lock();
+  pipelines.clear();
+  this->Internal->PipelineListLock->Unlock();
   return success;
 }
 
+//----------------------------------------------------------------------------
+bool vtkCPProcessor::CanExecuteAsynchronously()
+{
+  vtkCPProcessorInternals* internal = this->Internal;
+  const char* reason = NULL;
+  // Python scripts need the interpreter lock, which is only held by the
+  // simulation's thread
+  internal->PipelineListLock->Lock();
+  for(vtkCPProcessorInternals::PipelineListIterator iter =
+        internal->Pipelines.begin();
+      !reason && iter!=internal->Pipelines.end();iter++)
+    {
+    if(iter->GetPointer()->IsA("vtkCPPythonScriptPipeline"))
+      {
+      reason = "a Python script pipeline is used";
+      }
+    }
+  internal->PipelineListLock->Unlock();
+
+  // filters that communicate get their own communicator so that their
+  // messages never match the simulation's
+  vtkMultiProcessController* controller =
+    vtkMultiProcessController::GetGlobalController();
+  if(!reason && !internal->AnalysisController &&
+     controller && controller->GetNumberOfProcesses() > 1)
+    {
+    reason = this->CreateAnalysisController();
+    }
+
+  if(!reason)
+    {
+    return true;
+    }
+  if(!internal->WarnedAboutFallback)
+    {
+    vtkWarningMacro("Pipelines run synchronously because " << reason << ".");
+    internal->WarnedAboutFallback = true;
+    }
+  return false;
+}
+
+//----------------------------------------------------------------------------
+const char* vtkCPProcessor::CreateAnalysisController()
+{
+#ifdef COPROCESSOR_USE_MPI
+  vtkMPIController* controller = vtkMPIController::SafeDownCast(
+    vtkMultiProcessController::GetGlobalController());
+  if(!controller)
+    {
+    return "the global controller is not a vtkMPIController";
+    }
+  // both threads call MPI at the same time
+  int provided = MPI_THREAD_SINGLE;
+  MPI_Query_thread(&provided);
+  if(provided != MPI_THREAD_MULTIPLE)
+    {
+    return "MPI was not initialized with MPI_THREAD_MULTIPLE";
+    }
+  // same processes in the same order, on a new communicator
+  vtkMultiProcessController* duplicate = controller->PartitionController(
+    0, controller->GetLocalProcessId());
+  if(!duplicate)
+    {
+    return "the communicator could not be duplicated";
+    }
+  this->Internal->SimulationController = controller;
+  this->Internal->AnalysisController = duplicate;
+  vtkMultiProcessController::SetGlobalController(duplicate);
+  return NULL;
+#else
+  return "the run is parallel without MPI";
+#endif
+}
+
+//----------------------------------------------------------------------------
+void vtkCPProcessor::ReleaseAnalysisController()
+{
+  vtkCPProcessorInternals* internal = this->Internal;
+  if(!internal->AnalysisController)
+    {
+    return;
+    }
+  if(vtkMultiProcessController::GetGlobalController() ==
+     internal->AnalysisController)
+    {
+    vtkMultiProcessController::SetGlobalController(
+      internal->SimulationController);
+    }
+  internal->AnalysisController->Delete();
+  internal->AnalysisController = NULL;
+  internal->SimulationController = NULL;
+}
+
+//----------------------------------------------------------------------------
+int vtkCPProcessor::EnqueueTimeStep(vtkCPDataDescription* dataDescription)
+{
+  vtkCPProcessorInternals* internal = this->Internal;
+
+  // estimate the snapshot's size from the grids the pipelines asked for
+  unsigned long size = 0;
+  unsigned int numInputs = dataDescription->GetNumberOfInputDescriptions();
+  for(unsigned int i=0;i<numInputs;i++)
+    {
+    vtkCPInputDataDescription* input =
+      dataDescription->GetInputDescription(i);
+    if(input->GetGrid() && dataDescription->GetIfGridIsNecessary(
+         dataDescription->GetInputDescriptionName(i)))
+      {
+      size += input->GetGrid()->GetActualMemorySize();
+      }
+    }
+
+  if(this->SnapshotMemoryBudget > 0 && size > this->SnapshotMemoryBudget)
+    {
+    // can never fit, process it here once the analysis thread is idle
+    double start = vtkTimerLog::GetUniversalTime();
+    this->WaitForPendingTimeSteps();
+    double ready = vtkTimerLog::GetUniversalTime();
+    int success = this->ExecutePipelines(dataDescription);
+    internal->QueueLock->Lock();
+    internal->LastBlockedTime = ready - start;
+    internal->LastSnapshotTime = 0;
+    internal->LastQueuedTime = 0;
+    internal->LastExecutionTime = vtkTimerLog::GetUniversalTime() - ready;
+    internal->NumberOfExecutedTimeSteps++;
+    internal->QueueLock->Unlock();
+    return success;
+    }
+
+  this->StartAnalysisThread();
+
+  // apply back-pressure until the queue and the budget have room
+  double start = vtkTimerLog::GetUniversalTime();
+  internal->QueueLock->Lock();
+  for(;;)
+    {
+    bool fits =
+      static_cast<int>(internal->Queue.size()) <
+      this->MaximumNumberOfPendingTimeSteps &&
+      (this->SnapshotMemoryBudget == 0 ||
+       internal->Memory + size <= this->SnapshotMemoryBudget);
+    if(fits)
+      {
+      break;
+      }
+    if(this->BackPressureMode == SKIP)
+      {
+      internal->NumberOfSkippedTimeSteps++;
+      internal->LastBlockedTime = 0;
+      internal->QueueLock->Unlock();
+      return 1;
+      }
+    if(this->BackPressureMode == DROP_OLDEST && !internal->Queue.empty())
+      {
+      vtkCPProcessorInternals::TimeStep& oldest = internal->Queue.front();
+      internal->Memory -= oldest.Size;
+      oldest.Description->Delete();
+      internal->Queue.pop_front();
+      internal->NumberOfDroppedTimeSteps++;
+      continue;
+      }
+    // BLOCK, or nothing left to drop while the analysis thread works
+    internal->QueueChanged->Wait(internal->QueueLock);
+    }
+  // reserve the memory while the snapshot is taken
+  internal->Memory += size;
+  internal->LastBlockedTime = vtkTimerLog::GetUniversalTime() - start;
+  internal->QueueLock->Unlock();
+
+  // snapshot the description and the grids that are needed
+  start = vtkTimerLog::GetUniversalTime();
+  vtkCPDataDescription* snapshot = vtkCPDataDescription::New();
+  snapshot->Copy(dataDescription);
+  for(unsigned int i=0;i<numInputs;i++)
+    {
+    const char* name = snapshot->GetInputDescriptionName(i);
+    vtkCPInputDataDescription* input = snapshot->GetInputDescription(i);
+    vtkDataObject* grid = input->GetGrid();
+    if(!grid || !snapshot->GetIfGridIsNecessary(name))
+      {
+      input->SetGrid(NULL);
+      continue;
+      }
+    vtkDataObject* copy = grid->NewInstance();
+    if(this->SnapshotMode == SHALLOW_COPY)
+      {
+      copy->ShallowCopy(grid);
+      }
+    else
+      {
+      copy->DeepCopy(grid);
+      }
+    input->SetGrid(copy);
+    copy->Delete();
+    }
+  double now = vtkTimerLog::GetUniversalTime();
+
+  vtkCPProcessorInternals::TimeStep step;
+  step.Description = snapshot;
+  step.Size = size;
+  step.QueuedAt = now;
+  internal->QueueLock->Lock();
+  internal->LastSnapshotTime = now - start;
+  internal->Queue.push_back(step);
+  internal->QueueChanged->Broadcast();
+  internal->QueueLock->Unlock();
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+void vtkCPProcessor::WaitForPendingTimeSteps()
+{
+  vtkCPProcessorInternals* internal = this->Internal;
+  internal->QueueLock->Lock();
+  while(internal->ThreadId != -1 &&
+        (!internal->Queue.empty() || internal->Busy))
+    {
+    internal->QueueChanged->Wait(internal->QueueLock);
+    }
+  internal->QueueLock->Unlock();
+}
+
+//----------------------------------------------------------------------------
+void vtkCPProcessor::SetAsynchronousExecution(bool async)
+{
+  if(this->AsynchronousExecution == async)
+    {
+    return;
+    }
+  if(!async)
+    {
+    this->StopAnalysisThread();
+    }
+  this->AsynchronousExecution = async;
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+void vtkCPProcessor::StartAnalysisThread()
+{
+  if(this->Internal->ThreadId != -1)
+    {
+    return;
+    }
+  this->Internal->Done = false;
+  this->Internal->ThreadId = this->Internal->Threader->SpawnThread(
+    (vtkThreadFunctionType)(vtkCPProcessor::AnalysisThreadMain), this);
+}
+
+//----------------------------------------------------------------------------
+void vtkCPProcessor::StopAnalysisThread()
+{
+  if(this->Internal->ThreadId != -1)
+    {
+    // the analysis thread only exits once its queue is empty
+    this->Internal->QueueLock->Lock();
+    this->Internal->Done = true;
+    this->Internal->QueueChanged->Broadcast();
+    this->Internal->QueueLock->Unlock();
+    this->Internal->Threader->TerminateThread(this->Internal->ThreadId);
+    this->Internal->ThreadId = -1;
+    }
+  this->ReleaseAnalysisController();
+}
+
+//----------------------------------------------------------------------------
+VTK_THREAD_RETURN_TYPE vtkCPProcessor::AnalysisThreadMain(void* arg)
+{
+  vtkMultiThreader::ThreadInfo* info =
+    static_cast<vtkMultiThreader::ThreadInfo*>(arg);
+  vtkCPProcessor* self = static_cast<vtkCPProcessor*>(info->UserData);
+  self->AnalysisLoop();
+  return VTK_THREAD_RETURN_VALUE;
+}
+
+//----------------------------------------------------------------------------
+void vtkCPProcessor::AnalysisLoop()
+{
+  vtkCPProcessorInternals* internal = this->Internal;
+  internal->QueueLock->Lock();
+  for(;;)
+    {
+    if(internal->Queue.empty())
+      {
+      if(internal->Done)
+        {
+        break;
+        }
+      internal->QueueChanged->Wait(internal->QueueLock);
+      continue;
+      }
+    vtkCPProcessorInternals::TimeStep step = internal->Queue.front();
+    internal->Queue.pop_front();
+    internal->Busy = true;
+    // let a blocked simulation take the slot that was just freed
+    internal->QueueChanged->Broadcast();
+    internal->QueueLock->Unlock();
+
+    double start = vtkTimerLog::GetUniversalTime();
+    this->ExecutePipelines(step.Description);
+    double end = vtkTimerLog::GetUniversalTime();
+    step.Description->Delete();
+
+    internal->QueueLock->Lock();
+    internal->Memory -= step.Size;
+    internal->Busy = false;
+    internal->LastQueuedTime = start - step.QueuedAt;
+    internal->LastExecutionTime = end - start;
+    internal->NumberOfExecutedTimeSteps++;
+    internal->QueueChanged->Broadcast();
+    }
+  internal->QueueLock->Unlock();
+}
+
+//----------------------------------------------------------------------------
+void vtkCPProcessor::UpdateStatistics(vtkCPDataDescription* dataDescription)
+{
+  vtkCPProcessorInternals* internal = this->Internal;
+  internal->QueueLock->Lock();
+  dataDescription->SetLastSnapshotTime(internal->LastSnapshotTime);
+  dataDescription->SetLastBlockedTime(internal->LastBlockedTime);
+  dataDescription->SetLastQueuedTime(internal->LastQueuedTime);
+  dataDescription->SetLastExecutionTime(internal->LastExecutionTime);
+  dataDescription->SetNumberOfExecutedTimeSteps(
+    internal->NumberOfExecutedTimeSteps);
+  dataDescription->SetNumberOfSkippedTimeSteps(
+    internal->NumberOfSkippedTimeSteps);
+  dataDescription->SetNumberOfDroppedTimeSteps(
+    internal->NumberOfDroppedTimeSteps);
+  dataDescription->SetNumberOfPendingTimeSteps(
+    static_cast<vtkIdType>(internal->Queue.size()) + (internal->Busy ? 1 : 0));
+  internal->QueueLock->Unlock();
+}
+
 //----------------------------------------------------------------------------
 int vtkCPProcessor::Finalize()
 {
+  this->StopAnalysisThread();
   this->RemoveAllPipelines();
   return 1;
 }
@@ -163,4 +650,12 @@ int vtkCPProcessor::Finalize()
 void vtkCPProcessor::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os, indent);
+  os << indent << "AsynchronousExecution: "
+     << this->AsynchronousExecution << "\n";
+  os << indent << "BackPressureMode: " << this->BackPressureMode << "\n";
+  os << indent << "MaximumNumberOfPendingTimeSteps: "
+     << this->MaximumNumberOfPendingTimeSteps << "\n";
+  os << indent << "SnapshotMode: " << this->SnapshotMode << "\n";
+  os << indent << "SnapshotMemoryBudget: "
+     << this->SnapshotMemoryBudget << "\n";
 }
@@ -16,6 +16,7 @@
 #define vtkCPProcessor_h
 
 #include "vtkObject.h"
+#include "vtkMultiThreader.h" // For VTK_THREAD_RETURN_TYPE
 #include "CPWin32Header.h" // For windows import/export of shared libraries
 
 struct vtkCPProcessorInternals;
@@ -52,6 +53,26 @@ class vtkCPPipeline;
 /// actual data that it has been asked to provide, if any. If no data was
 /// selected during the Configuration Step than the priovided vtkDataObject
 /// may be NULL.
+///
+/// Asynchronous execution:\n
+/// By default the pipelines run inside CoProcess() on the simulation's
+/// thread. With AsynchronousExecution on, CoProcess() only takes a snapshot
+/// of the requested grids and hands it to an analysis thread, so that the
+/// simulation advances while the pipelines filter, render and write.
+/// BackPressureMode decides what happens when the analysis falls behind.
+/// The pipelines are never run concurrently with each other, but their
+/// RequestDataDescription() may be called while the analysis thread runs
+/// their CoProcess() on an earlier time step, so it must not depend on
+/// state that CoProcess() modifies. In parallel runs the pipelines
+/// communicate on a duplicate of the global controller's communicator, which
+/// replaces the global controller until the analysis thread is stopped, so
+/// that their messages never match the simulation's. This needs MPI to be
+/// initialized with MPI_THREAD_MULTIPLE, and filters that keep the
+/// controller they were created with must be created after the first
+/// asynchronous time step. Python scripts need the interpreter lock, which
+/// the analysis thread does not have. Without MPI_THREAD_MULTIPLE or with a
+/// vtkCPPythonScriptPipeline the pipelines run synchronously, and a warning
+/// says why the first time it happens.
 class COPROCESSING_EXPORT vtkCPProcessor : public vtkObject
 {
 
@@ -90,16 +111,110 @@ public:
 
   /// Processing Step:
   /// Provides the grid and the field data for the co-procesor to process.
+  /// With AsynchronousExecution on this returns as soon as the time step
+  /// has been handed to the analysis thread (or skipped), the adaptor may
+  /// then modify its grids again.
   virtual int CoProcess(vtkCPDataDescription* dataDescription);
 
   /// Called after all co-processing is complete giving the Co-Processor 
   /// implementation an opportunity to clean up, before it is destroyed.
+  /// Waits for the analysis thread to process every pending time step.
   virtual int Finalize();
 
+  /// Run the pipelines on a separate analysis thread. Off by default.
+  /// Turning it off waits for the pending time steps to be processed.
+  /// Python script pipelines, and parallel runs unless MPI was initialized
+  /// with MPI_THREAD_MULTIPLE, still run synchronously with a warning. In
+  /// parallel runs the first asynchronous time step duplicates the
+  /// communicator, so every process must process it, and turning this off
+  /// frees it, so every process must turn it off.
+  virtual void SetAsynchronousExecution(bool);
+  vtkGetMacro(AsynchronousExecution, bool);
+  vtkBooleanMacro(AsynchronousExecution, bool);
+
+  enum BackPressureModes
+  {
+    /// Do not process time steps that arrive while the queue is full.
+    SKIP = 0,
+    /// Stall the simulation until there is room in the queue.
+    BLOCK,
+    /// Discard the oldest queued time steps to make room for the new one.
+    DROP_OLDEST
+  };
+
+  /// What to do when the analysis thread falls behind. Default is BLOCK.
+  vtkSetClampMacro(BackPressureMode, int, SKIP, DROP_OLDEST);
+  vtkGetMacro(BackPressureMode, int);
+
+  /// How many time steps may wait for the analysis thread, in addition to
+  /// the one it is processing. Default is 1.
+  vtkSetClampMacro(MaximumNumberOfPendingTimeSteps, int, 1, VTK_INT_MAX);
+  vtkGetMacro(MaximumNumberOfPendingTimeSteps, int);
+
+  enum SnapshotModes
+  {
+    /// Copy the grids and their arrays.
+    DEEP_COPY = 0,
+    /// Share the arrays with the adaptor. This is only correct when the
+    /// adaptor replaces arrays instead of writing into them after
+    /// CoProcess() returns, which gives copy-on-write semantics without
+    /// paying for the copy.
+    SHALLOW_COPY
+  };
+
+  /// How grids are snapshotted for the analysis thread. Default is
+  /// DEEP_COPY.
+  vtkSetClampMacro(SnapshotMode, int, DEEP_COPY, SHALLOW_COPY);
+  vtkGetMacro(SnapshotMode, int);
+
+  /// Upper bound, in kilobytes, for the memory held by snapshots that are
+  /// queued or being processed. 0, the default, means no limit. Reaching
+  /// the budget is handled like a full queue. A time step that does not fit
+  /// in the budget on its own is processed synchronously.
+  vtkSetMacro(SnapshotMemoryBudget, unsigned long);
+  vtkGetMacro(SnapshotMemoryBudget, unsigned long);
+
 protected:
   vtkCPProcessor();
   virtual ~vtkCPProcessor();
 
+  /// Run every pipeline on the given description.
+  int ExecutePipelines(vtkCPDataDescription* dataDescription);
+
+  /// Whether the current pipelines and process layout allow running them on
+  /// the analysis thread. Warns once when they do not.
+  bool CanExecuteAsynchronously();
+
+  /// Duplicate the global controller for the pipelines of a parallel run and
+  /// make it the global controller. Returns why it could not, or NULL.
+  const char* CreateAnalysisController();
+
+  /// Restore the global controller and free its duplicate.
+  void ReleaseAnalysisController();
+
+  /// Snapshot the description and queue it for the analysis thread,
+  /// applying the back-pressure policy.
+  int EnqueueTimeStep(vtkCPDataDescription* dataDescription);
+
+  /// Wait for the analysis thread to process every pending time step.
+  void WaitForPendingTimeSteps();
+
+  /// Start and stop (after draining its queue) the analysis thread.
+  void StartAnalysisThread();
+  void StopAnalysisThread();
+
+  /// Copy the statistics into the adaptor's description.
+  void UpdateStatistics(vtkCPDataDescription* dataDescription);
+
+  static VTK_THREAD_RETURN_TYPE AnalysisThreadMain(void* arg);
+  void AnalysisLoop();
+
+  bool AsynchronousExecution;
+  int BackPressureMode;
+  int MaximumNumberOfPendingTimeSteps;
+  int SnapshotMode;
+  unsigned long SnapshotMemoryBudget;
+
 private:
   vtkCPProcessor(const vtkCPProcessor&); // Not implemented
   void operator=(const vtkCPProcessor&); // Not implemented
@@ -0,0 +1,139 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestPVFrameRateController.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Feeds vtkPVFrameRateController with frame times and checks the settings it
+// picks, and that the frames which decimate new LOD geometry are not counted.
+
+#include "vtkPVFrameRateController.h"
+#include "vtkSmartPointer.h"
+
+namespace
+{
+  void AddFrames(vtkPVFrameRateController* controller, int count,
+                 double renderTime, double transferTime = 0.0)
+  {
+    for (int i = 0; i < count; i++)
+      {
+      controller->AddFrame(renderTime, transferTime);
+      }
+  }
+
+  bool Check(const char* name, vtkPVFrameRateController* controller,
+             bool useLOD, double lodResolution, int imageReductionFactor,
+             int compressionLevel, int numberOfDecisions)
+  {
+    if (controller->GetUseLOD() != useLOD ||
+        controller->GetLODResolution() != lodResolution ||
+        controller->GetImageReductionFactor() != imageReductionFactor ||
+        controller->GetCompressionLevel() != compressionLevel ||
+        controller->GetNumberOfDecisions() != numberOfDecisions)
+      {
+      cerr << "Wrong settings " << name << ": LOD " << controller->GetUseLOD()
+           << ", LOD resolution " << controller->GetLODResolution()
+           << ", image reduction factor "
+           << controller->GetImageReductionFactor()
+           << ", compression level " << controller->GetCompressionLevel()
+           << ", " << controller->GetNumberOfDecisions() << " decisions"
+           << endl;
+      return false;
+      }
+    return true;
+  }
+}
+
+int main(int, char**)
+{
+  bool ok = true;
+
+  // A budget of 0.1s per frame, measured over 3 frames.
+  vtkSmartPointer<vtkPVFrameRateController> controller =
+    vtkSmartPointer<vtkPVFrameRateController>::New();
+  controller->SetTargetFrameRate(10.0);
+  controller->SetNumberOfFramesToAverage(3);
+
+  AddFrames(controller, 3, 1.0);
+  ok = Check("before initialization", controller, false, 0.5, 1, -1, 0) && ok;
+
+  controller->Initialize(0.5, 1, 2);
+  AddFrames(controller, 2, 0.3);
+  ok = Check("before enough frames", controller, false, 0.5, 1, 2, 0) && ok;
+  AddFrames(controller, 1, 0.3);
+  ok = Check("for slow renders", controller, true, 0.5, 1, 2, 1) && ok;
+
+  // The first LOD frame also decimates, and must not count.
+  AddFrames(controller, 1, 10.0);
+  AddFrames(controller, 3, 0.08);
+  ok = Check("after the first LOD frame", controller, true, 0.5, 1, 2, 1) && ok;
+  AddFrames(controller, 3, 0.3);
+  ok = Check("for slow LOD renders", controller, true, 0.25, 1, 2, 2) && ok;
+  AddFrames(controller, 1, 10.0);
+  AddFrames(controller, 3, 0.08);
+  ok = Check("after a new LOD resolution", controller, true, 0.25, 1, 2, 2)
+    && ok;
+
+  // Other changes need no new geometry, so their first frame counts.
+  AddFrames(controller, 3, 0.02, 0.2);
+  ok = Check("for slow transfers", controller, true, 0.25, 1, 3, 3) && ok;
+  AddFrames(controller, 3, 0.02, 0.2);
+  ok = Check("for slower transfers", controller, true, 0.25, 1, 4, 4) && ok;
+
+  // Fast frames restore the settings in the reverse order.
+  AddFrames(controller, 3, 0.01);
+  ok = Check("for fast renders", controller, true, 0.5, 1, 4, 5) && ok;
+  AddFrames(controller, 1, 10.0);
+  AddFrames(controller, 3, 0.01);
+  ok = Check("for fast LOD renders", controller, false, 0.5, 1, 4, 6) && ok;
+  AddFrames(controller, 3, 0.01);
+  ok = Check("for fast full resolution renders", controller,
+             false, 0.5, 1, 3, 7) && ok;
+
+  // Frames the render view knows to include a decimation.
+  controller->SkipNextFrame();
+  AddFrames(controller, 1, 10.0);
+  AddFrames(controller, 3, 0.08);
+  ok = Check("after a skipped frame", controller, false, 0.5, 1, 3, 7) && ok;
+
+  // Render-bound frames end up raising the image reduction factor.
+  controller->SetMinimumLODResolution(0.25);
+  controller->SetMaximumImageReductionFactor(2);
+  AddFrames(controller, 3, 1.0);
+  AddFrames(controller, 1, 10.0);
+  AddFrames(controller, 3, 1.0);
+  AddFrames(controller, 1, 10.0);
+  AddFrames(controller, 3, 1.0);
+  ok = Check("at the LOD bound", controller, true, 0.25, 2, 3, 10) && ok;
+  AddFrames(controller, 3, 1.0);
+  ok = Check("at all the bounds", controller, true, 0.25, 2, 3, 10) && ok;
+
+  for (int i = 0; i < controller->GetNumberOfDecisions(); i++)
+    {
+    if (!controller->GetDecision(i))
+      {
+      cerr << "Decision " << i << " is missing" << endl;
+      ok = false;
+      }
+    }
+
+  // Frames are not measured after a reset.
+  controller->Reset();
+  AddFrames(controller, 3, 0.01);
+  if (controller->GetInitialized() || controller->GetNumberOfDecisions() != 10 ||
+      controller->GetLastRenderTime() != 0.01)
+    {
+    cerr << "Frames were measured after a reset" << endl;
+    ok = false;
+    }
+
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,165 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestPluginBroadcast.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Loads an XML plugin with vtkPVPluginLoader on the processes of a server,
+// with PV_PLUGIN_BROADCAST_DIR set, and checks that:
+//  - the root loads the original file, and the other process loads the copy
+//    it wrote under <dir>/<writer>, with the same contents,
+//  - the plugin is loaded on every process under its original file name,
+//  - when a copy cannot be written, every process fails, the root included,
+//  - when the root cannot read the file, the other processes fail.
+// Run it on 2 MPI processes.
+
+#include "vtkMultiProcessController.h"
+#include "vtkProcessModule.h"
+#include "vtkPVPluginLoader.h"
+#include "vtkSmartPointer.h"
+#include "vtkTestUtilities.h"
+
+#include <vtksys/SystemTools.hxx>
+#include <vtksys/ios/fstream>
+#include <vtksys/ios/sstream>
+#include <vtkstd/string>
+
+#include <string.h>
+
+#define PLUGIN_XML "<ServerManagerConfiguration/>\n"
+
+namespace
+{
+  // Gives access to the distribution of the plugin file.
+  class TestPluginLoader : public vtkPVPluginLoader
+  {
+  public:
+    static TestPluginLoader* New() { return new TestPluginLoader; }
+    bool Distribute(const char* file, vtkStdString& localFile)
+    {
+      return this->DistributePluginFile(file, localFile, true);
+    }
+  };
+
+  vtkstd::string ReadFile(const char* fileName)
+  {
+    vtksys_ios::ifstream is(fileName, ios::in | ios::binary);
+    vtksys_ios::ostringstream contents;
+    contents << is.rdbuf();
+    return contents.str();
+  }
+
+  void SetBroadcastDirectory(const vtkstd::string& directory)
+  {
+    vtkstd::string env = "PV_PLUGIN_BROADCAST_DIR=" + directory;
+    vtksys::SystemTools::PutEnv(env.c_str());
+  }
+}
+
+int main(int argc, char* argv[])
+{
+  vtkProcessModule::Initialize(vtkProcessModule::PROCESS_SERVER, argc, argv);
+  vtkMultiProcessController* controller =
+    vtkMultiProcessController::GetGlobalController();
+  int rank = controller->GetLocalProcessId();
+  if (controller->GetNumberOfProcesses() != 2)
+    {
+    cerr << "Run this test on 2 processes" << endl;
+    vtkProcessModule::Finalize();
+    return 1;
+    }
+
+  char* tempDir = vtkTestUtilities::GetArgOrEnvOrDefault(
+    "-T", argc, argv, "VTK_TEMP_DIR", "Testing/Temporary");
+  vtkstd::string pluginFile = vtkstd::string(tempDir) + "/BroadcastPlugin.xml";
+  vtkstd::string directory = vtkstd::string(tempDir) + "/PluginBroadcast";
+  delete [] tempDir;
+
+  // The root writes the plugin, the other process only gets it through the
+  // broadcast.
+  if (rank == 0)
+    {
+    vtksys::SystemTools::RemoveADirectory(directory.c_str());
+    vtksys_ios::ofstream os(pluginFile.c_str(), ios::out | ios::binary);
+    os << PLUGIN_XML;
+    }
+  controller->Barrier();
+
+  bool ok = true;
+  SetBroadcastDirectory(directory);
+  vtkSmartPointer<TestPluginLoader> loader =
+    vtkSmartPointer<TestPluginLoader>::New();
+  vtkStdString localFile;
+  vtkstd::string copy = directory + "/1/BroadcastPlugin.xml";
+  if (!loader->Distribute(pluginFile.c_str(), localFile))
+    {
+    cerr << "Process " << rank << " could not share the plugin: "
+         << (loader->GetErrorString() ? loader->GetErrorString() : "") << endl;
+    ok = false;
+    }
+  else if (localFile != (rank == 0 ? pluginFile : copy))
+    {
+    cerr << "Process " << rank << " would load " << localFile.c_str()
+         << endl;
+    ok = false;
+    }
+  else if (rank > 0 && ReadFile(copy.c_str()) != PLUGIN_XML)
+    {
+    cerr << "The copy of the plugin differs from the original" << endl;
+    ok = false;
+    }
+
+  // Loaded everywhere, under the original name.
+  loader = vtkSmartPointer<TestPluginLoader>::New();
+  if (!loader->LoadPlugin(pluginFile.c_str()) || !loader->GetLoaded() ||
+      pluginFile != loader->GetFileName() ||
+      strcmp(loader->GetPluginName(), "BroadcastPlugin") != 0)
+    {
+    cerr << "Process " << rank << " did not load the plugin" << endl;
+    ok = false;
+    }
+
+  // The copy cannot be written under a regular file.
+  SetBroadcastDirectory(pluginFile);
+  loader = vtkSmartPointer<TestPluginLoader>::New();
+  if (loader->Distribute(pluginFile.c_str(), localFile) ||
+      !loader->GetErrorString())
+    {
+    cerr << "Process " << rank << " did not fail when the copy could not be"
+         << " written" << endl;
+    ok = false;
+    }
+
+  // The root fails to load the missing file on its own.
+  SetBroadcastDirectory(directory);
+  vtkstd::string missingFile = directory + "/Missing.xml";
+  loader = vtkSmartPointer<TestPluginLoader>::New();
+  if (loader->Distribute(missingFile.c_str(), localFile) != (rank == 0))
+    {
+    cerr << "Process " << rank << " did not fail when the root could not"
+         << " read the plugin" << endl;
+    ok = false;
+    }
+
+  controller->Barrier();
+  if (rank == 0)
+    {
+    vtksys::SystemTools::RemoveADirectory(directory.c_str());
+    vtksys::SystemTools::RemoveFile(pluginFile.c_str());
+    }
+
+  int localStatus = ok ? 1 : 0;
+  int status = 0;
+  controller->AllReduce(&localStatus, &status, 1, vtkCommunicator::MIN_OP);
+  loader = 0;
+  vtkProcessModule::Finalize();
+  return status ? 0 : 1;
+}
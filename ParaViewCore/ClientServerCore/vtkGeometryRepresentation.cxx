@@ -29,11 +29,11 @@
 #include "vtkProperty.h"
 #include "vtkPVCacheKeeper.h"
 #include "vtkPVGeometryFilter.h"
+#include "vtkPVLODHierarchyFilter.h"
 #include "vtkPVLODActor.h"
 #include "vtkPVRenderView.h"
 #include "vtkPVTrivialProducer.h"
 #include "vtkPVUpdateSuppressor.h"
-#include "vtkQuadricClustering.h"
 #include "vtkRenderer.h"
 #include "vtkSelectionConverter.h"
 #include "vtkSelection.h"
@@ -82,6 +82,15 @@ protected:
 };
 vtkStandardNewMacro(vtkGeometryRepresentationMultiBlockMaker);
 
+namespace
+{
+  // Number of divisions of the LOD for a resolution in [0, 1].
+  int vtkGeometryRepresentationGetLODDivisions(double resolution)
+    {
+    return static_cast<int>(150 * resolution) + 10;
+    }
+}
+
 //*****************************************************************************
 
 
@@ -92,7 +101,7 @@ vtkGeometryRepresentation::vtkGeometryRepresentation()
   this->GeometryFilter = vtkPVGeometryFilter::New();
   this->CacheKeeper = vtkPVCacheKeeper::New();
   this->MultiBlockMaker = vtkGeometryRepresentationMultiBlockMaker::New();
-  this->Decimator = vtkQuadricClustering::New();
+  this->Decimator = vtkPVLODHierarchyFilter::New();
   this->Mapper = vtkCompositePolyDataMapper2::New();
   this->LODMapper = vtkCompositePolyDataMapper2::New();
   this->Actor = vtkPVLODActor::New();
@@ -147,10 +156,12 @@ vtkGeometryRepresentation::~vtkGeometryRepresentation()
 //----------------------------------------------------------------------------
 void vtkGeometryRepresentation::SetupDefaults()
 {
-  this->Decimator->SetUseInputPoints(1);
-  this->Decimator->SetCopyCellData(1);
-  this->Decimator->SetUseInternalTriangles(0);
-  this->Decimator->SetNumberOfDivisions(10, 10, 10);
+  this->Decimator->SetNumberOfLevels(5);
+  this->Decimator->SetMinimumNumberOfDivisions(10);
+  // The divisions of the default LOD resolution of vtkPVRenderView, so that
+  // the levels built in the background are the ones asked for.
+  this->Decimator->SetNumberOfDivisions(
+    vtkGeometryRepresentationGetLODDivisions(0.5));
   this->LODDeliveryFilter->SetLODMode(true); // tell the filter that it is
                                              // connected to the LOD pipeline.
 
@@ -227,9 +238,9 @@ int vtkGeometryRepresentation::ProcessViewRequest(
       {
       if (inInfo->Has(vtkPVRenderView::LOD_RESOLUTION()))
         {
-        int division = static_cast<int>(150 *
-          inInfo->Get(vtkPVRenderView::LOD_RESOLUTION())) + 10;
-        this->Decimator->SetNumberOfDivisions(division, division, division);
+        this->Decimator->SetNumberOfDivisions(
+          vtkGeometryRepresentationGetLODDivisions(
+            inInfo->Get(vtkPVRenderView::LOD_RESOLUTION())));
         }
       this->LODDeliveryFilter->ProcessViewRequest(inInfo);
       if (this->LODDeliverySuppressor->GetForcedUpdateTimeStamp() <
@@ -240,6 +251,15 @@ int vtkGeometryRepresentation::ProcessViewRequest(
       }
     else
       {
+      if (!this->SuppressLOD &&
+        inInfo->Has(vtkPVRenderView::LOD_NEEDED_FOR_INTERACTION()) &&
+        this->LODDeliveryFilter->GetNumberOfInputConnections(0) > 0)
+        {
+        // Decimate while the full resolution geometry is delivered and
+        // rendered, so that the first interactive render only waits for what
+        // is left.
+        this->Decimator->BuildInBackground();
+        }
       this->DeliveryFilter->ProcessViewRequest(inInfo);
       if (this->DeliverySuppressor->GetForcedUpdateTimeStamp() <
         this->DeliveryFilter->GetMTime())
@@ -366,6 +386,8 @@ int vtkGeometryRepresentation::RequestData(vtkInformation* request,
   // Pass caching information to the cache keeper.
   this->CacheKeeper->SetCachingEnabled(this->GetUseCache());
   this->CacheKeeper->SetCacheTime(this->GetCacheKey());
+  this->Decimator->SetCachingEnabled(this->GetUseCache());
+  this->Decimator->SetCacheTime(this->GetCacheKey());
 
   if (inputVector[0]->GetNumberOfInformationObjects()==1)
     {
@@ -448,6 +470,7 @@ void vtkGeometryRepresentation::MarkModified()
     {
     // Cleanup caches when not using cache.
     this->CacheKeeper->RemoveAllCaches();
+    this->Decimator->RemoveAllCaches();
     }
   this->Superclass::MarkModified();
 }
@@ -30,9 +30,9 @@ class vtkMapper;
 class vtkOrderedCompositeDistributor;
 class vtkPVCacheKeeper;
 class vtkPVGeometryFilter;
+class vtkPVLODHierarchyFilter;
 class vtkPVLODActor;
 class vtkPVUpdateSuppressor;
-class vtkQuadricClustering;
 class vtkScalarsToColors;
 class vtkTexture;
 class vtkUnstructuredDataDeliveryFilter;
@@ -247,7 +247,7 @@ protected:
   vtkAlgorithm* GeometryFilter;
   vtkAlgorithm* MultiBlockMaker;
   vtkPVCacheKeeper* CacheKeeper;
-  vtkQuadricClustering* Decimator;
+  vtkPVLODHierarchyFilter* Decimator;
   vtkMapper* Mapper;
   vtkMapper* LODMapper;
   vtkPVLODActor* Actor;
@@ -81,6 +81,13 @@ public:
   void SetUseOrderedCompositing(bool uoc)
     { this->IceTCompositePass->SetUseOrderedCompositing(uoc); }
 
+  // Description:
+  // Restrict rendering and compositing to a region of the display, in pixels.
+  // An empty region renders the whole viewport.
+  // See vtkIceTCompositePass::SetRenderRegion().
+  void SetRenderRegion(int region[4])
+    { this->IceTCompositePass->SetRenderRegion(region); }
+
   // Description:
   // Set the image reduction factor. Overrides superclass implementation.
   virtual void SetImageReductionFactor(int val);
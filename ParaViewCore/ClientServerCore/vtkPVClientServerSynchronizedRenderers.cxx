@@ -18,6 +18,7 @@
 #include "vtkSquirtCompressor.h"
 #include "vtkZlibImageCompressor.h"
 #include "vtkMultiProcessController.h"
+#include "vtkTimerLog.h"
 #include "vtkUnsignedCharArray.h"
 
 #include <vtksys/ios/sstream>
@@ -32,6 +33,8 @@ vtkPVClientServerSynchronizedRenderers::vtkPVClientServerSynchronizedRenderers()
   this->Compressor = NULL;
   this->ConfigureCompressor("vtkSquirtCompressor 0 3");
   this->LossLessCompression = true;
+  this->CompressionLevel = -1;
+  this->LastTransferTime = 0.0;
 }
 
 //----------------------------------------------------------------------------
@@ -52,6 +55,9 @@ void vtkPVClientServerSynchronizedRenderers::MasterEndRender()
 
   int header[4];
   this->ParallelController->Receive(header, 4, 1, 0x023430);
+
+  // The header arrives once the slave is done rendering, time the image only.
+  double start = vtkTimerLog::GetUniversalTime();
   if (header[0] > 0)
     {
     rawImage.Resize(header[1], header[2], header[3]);
@@ -68,6 +74,7 @@ void vtkPVClientServerSynchronizedRenderers::MasterEndRender()
       }
     rawImage.MarkValid();
     }
+  this->LastTransferTime = vtkTimerLog::GetUniversalTime() - start;
 }
 
 //----------------------------------------------------------------------------
@@ -99,9 +106,21 @@ vtkUnsignedCharArray* vtkPVClientServerSynchronizedRenderers::Compress(
 {
   if (this->Compressor)
     {
+    vtkSquirtCompressor* squirt =
+      vtkSquirtCompressor::SafeDownCast(this->Compressor);
+    int configuredLevel = squirt? squirt->GetSquirtLevel() : 0;
+    if (squirt && this->CompressionLevel >= 0)
+      {
+      squirt->SetSquirtLevel(this->CompressionLevel);
+      }
     this->Compressor->SetLossLessMode(this->LossLessCompression);
     this->Compressor->SetInput(data);
-    if (this->Compressor->Compress() == 0)
+    int status = this->Compressor->Compress();
+    if (squirt)
+      {
+      squirt->SetSquirtLevel(configuredLevel);
+      }
+    if (status == 0)
       {
       vtkErrorMacro("Image compression failed!");
       return data;
@@ -133,6 +152,14 @@ void vtkPVClientServerSynchronizedRenderers::Decompress(
 }
 
 
+//----------------------------------------------------------------------------
+int vtkPVClientServerSynchronizedRenderers::GetConfiguredCompressionLevel()
+{
+  vtkSquirtCompressor* squirt =
+    vtkSquirtCompressor::SafeDownCast(this->Compressor);
+  return squirt? squirt->GetSquirtLevel() : -1;
+}
+
 //----------------------------------------------------------------------------
 void vtkPVClientServerSynchronizedRenderers::ConfigureCompressor(const char *stream)
 {
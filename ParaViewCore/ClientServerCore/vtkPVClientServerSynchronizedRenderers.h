@@ -46,6 +46,22 @@ public:
   // user settings.
   virtual void ConfigureCompressor(const char *stream);
 
+  // Description:
+  // Override the level of a vtkSquirtCompressor for lossy compression. -1,
+  // the default, uses the configured level. Other compressors ignore it.
+  vtkSetClampMacro(CompressionLevel, int, -1, 5);
+  vtkGetMacro(CompressionLevel, int);
+
+  // Description:
+  // Returns the level of the configured vtkSquirtCompressor, or -1 for other
+  // compressors.
+  int GetConfiguredCompressionLevel();
+
+  // Description:
+  // Time in seconds the master spent receiving and decompressing the last
+  // image.
+  vtkGetMacro(LastTransferTime, double);
+
 //BTX
 protected:
   vtkPVClientServerSynchronizedRenderers();
@@ -64,6 +80,8 @@ protected:
 
   vtkImageCompressor* Compressor;
   bool LossLessCompression;
+  int CompressionLevel;
+  double LastTransferTime;
 private:
   vtkPVClientServerSynchronizedRenderers(const vtkPVClientServerSynchronizedRenderers&); // Not implemented
   void operator=(const vtkPVClientServerSynchronizedRenderers&); // Not implemented
@@ -0,0 +1,329 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    vtkPVFrameRateController.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkPVFrameRateController.h"
+
+#include "vtkObjectFactory.h"
+#include "vtkTimerLog.h"
+
+#include <vtkstd/deque>
+#include <vtkstd/string>
+#include <vtksys/ios/sstream>
+
+// Frames slower than the budget times this factor make the controller
+// degrade the settings, and frames faster than the budget times the
+// other one make it restore them. The gap keeps it from oscillating.
+#define VTK_PV_FRAME_RATE_OVER_BUDGET 1.1
+#define VTK_PV_FRAME_RATE_UNDER_BUDGET 0.5
+#define VTK_PV_FRAME_RATE_MAX_DECISIONS 100
+
+//----------------------------------------------------------------------------
+class vtkPVFrameRateController::vtkInternals
+{
+public:
+  vtkstd::deque<double> RenderTimes;
+  vtkstd::deque<double> TransferTimes;
+  vtkstd::deque<vtkstd::string> Decisions;
+  vtksys_ios::ostringstream Change;
+  bool SkipNextFrame;
+
+  vtkInternals() : SkipNextFrame(false) {}
+};
+
+vtkStandardNewMacro(vtkPVFrameRateController);
+//----------------------------------------------------------------------------
+vtkPVFrameRateController::vtkPVFrameRateController()
+{
+  this->TargetFrameRate = 10.0;
+  this->NumberOfFramesToAverage = 3;
+  this->MinimumLODResolution = 0.0;
+  this->MaximumImageReductionFactor = 8;
+  this->MaximumCompressionLevel = 5;
+
+  this->Initialized = false;
+  this->UseLOD = false;
+  this->LODResolution = 0.5;
+  this->ImageReductionFactor = 1;
+  this->CompressionLevel = -1;
+  this->InitialLODResolution = 0.5;
+  this->InitialImageReductionFactor = 1;
+  this->InitialCompressionLevel = -1;
+
+  this->LastRenderTime = 0.0;
+  this->LastTransferTime = 0.0;
+
+  this->Internals = new vtkInternals();
+}
+
+//----------------------------------------------------------------------------
+vtkPVFrameRateController::~vtkPVFrameRateController()
+{
+  delete this->Internals;
+  this->Internals = 0;
+}
+
+//----------------------------------------------------------------------------
+void vtkPVFrameRateController::Initialize(double lodResolution,
+  int imageReductionFactor, int compressionLevel)
+{
+  this->InitialLODResolution = lodResolution;
+  this->InitialImageReductionFactor = imageReductionFactor;
+  this->InitialCompressionLevel = compressionLevel;
+
+  this->UseLOD = false;
+  this->LODResolution = lodResolution;
+  this->ImageReductionFactor = imageReductionFactor;
+  this->CompressionLevel = compressionLevel;
+  this->Internals->RenderTimes.clear();
+  this->Internals->TransferTimes.clear();
+  this->Internals->SkipNextFrame = false;
+  this->Initialized = true;
+}
+
+//----------------------------------------------------------------------------
+void vtkPVFrameRateController::Reset()
+{
+  this->Internals->RenderTimes.clear();
+  this->Internals->TransferTimes.clear();
+  this->Internals->SkipNextFrame = false;
+  this->Initialized = false;
+}
+
+//----------------------------------------------------------------------------
+void vtkPVFrameRateController::SkipNextFrame()
+{
+  this->Internals->SkipNextFrame = true;
+}
+
+//----------------------------------------------------------------------------
+void vtkPVFrameRateController::AddFrame(double renderTime, double transferTime)
+{
+  this->LastRenderTime = renderTime;
+  this->LastTransferTime = transferTime;
+  if (!this->Initialized)
+    {
+    return;
+    }
+
+  vtkInternals* internals = this->Internals;
+  if (internals->SkipNextFrame)
+    {
+    internals->SkipNextFrame = false;
+    return;
+    }
+  internals->RenderTimes.push_back(renderTime);
+  internals->TransferTimes.push_back(transferTime);
+  if (static_cast<int>(internals->RenderTimes.size()) <
+    this->NumberOfFramesToAverage)
+    {
+    return;
+    }
+  while (static_cast<int>(internals->RenderTimes.size()) >
+    this->NumberOfFramesToAverage)
+    {
+    internals->RenderTimes.pop_front();
+    internals->TransferTimes.pop_front();
+    }
+
+  double render = 0.0;
+  double transfer = 0.0;
+  for (size_t cc = 0; cc < internals->RenderTimes.size(); cc++)
+    {
+    render += internals->RenderTimes[cc];
+    transfer += internals->TransferTimes[cc];
+    }
+  render /= internals->RenderTimes.size();
+  transfer /= internals->TransferTimes.size();
+
+  double budget = 1.0 / this->TargetFrameRate;
+  double frame = render + transfer;
+
+  internals->Change.str("");
+  bool useLOD = this->UseLOD;
+  double lodResolution = this->LODResolution;
+  bool changed = false;
+  if (frame > budget * VTK_PV_FRAME_RATE_OVER_BUDGET)
+    {
+    changed = this->Degrade(transfer > render);
+    }
+  else if (frame < budget * VTK_PV_FRAME_RATE_UNDER_BUDGET)
+    {
+    changed = this->Improve();
+    }
+  if (!changed)
+    {
+    return;
+    }
+
+  vtksys_ios::ostringstream decision;
+  decision << "Frame " << frame << "s (render " << render << "s, transfer "
+    << transfer << "s) for a budget of " << budget << "s: "
+    << internals->Change.str();
+  internals->Decisions.push_back(decision.str());
+  if (internals->Decisions.size() > VTK_PV_FRAME_RATE_MAX_DECISIONS)
+    {
+    internals->Decisions.pop_front();
+    }
+  vtkTimerLog::MarkEvent(decision.str().c_str());
+  vtkDebugMacro(<< decision.str().c_str());
+
+  // The frames measured so far do not tell anything about the new settings.
+  internals->RenderTimes.clear();
+  internals->TransferTimes.clear();
+  // The first frame with new LOD geometry also decimates it.
+  internals->SkipNextFrame = this->UseLOD &&
+    (!useLOD || this->LODResolution != lodResolution);
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+bool vtkPVFrameRateController::Degrade(bool transferBound)
+{
+  vtksys_ios::ostringstream& change = this->Internals->Change;
+
+  // Compression only reduces the time spent transferring the image.
+  if (transferBound && this->CompressionLevel >= 0 &&
+    this->CompressionLevel < this->MaximumCompressionLevel)
+    {
+    change << "compression level " << this->CompressionLevel << " -> "
+      << this->CompressionLevel + 1;
+    this->CompressionLevel++;
+    return true;
+    }
+
+  if (!transferBound)
+    {
+    if (!this->UseLOD)
+      {
+      change << "using LOD";
+      this->UseLOD = true;
+      return true;
+      }
+    if (this->LODResolution > this->MinimumLODResolution)
+      {
+      double resolution = this->LODResolution / 2.0;
+      if (resolution < this->MinimumLODResolution || resolution < 0.01)
+        {
+        resolution = this->MinimumLODResolution;
+        }
+      change << "LOD resolution " << this->LODResolution << " -> "
+        << resolution;
+      this->LODResolution = resolution;
+      return true;
+      }
+    }
+
+  // A smaller image is cheaper both to composite and to transfer.
+  if (this->ImageReductionFactor < this->MaximumImageReductionFactor)
+    {
+    change << "image reduction factor " << this->ImageReductionFactor
+      << " -> " << this->ImageReductionFactor + 1;
+    this->ImageReductionFactor++;
+    return true;
+    }
+  return false;
+}
+
+//----------------------------------------------------------------------------
+bool vtkPVFrameRateController::Improve()
+{
+  vtksys_ios::ostringstream& change = this->Internals->Change;
+
+  if (this->ImageReductionFactor > this->InitialImageReductionFactor)
+    {
+    change << "image reduction factor " << this->ImageReductionFactor
+      << " -> " << this->ImageReductionFactor - 1;
+    this->ImageReductionFactor--;
+    return true;
+    }
+
+  if (this->UseLOD)
+    {
+    if (this->LODResolution < this->InitialLODResolution)
+      {
+      double resolution = this->LODResolution < 0.05?
+        0.05 : this->LODResolution * 2.0;
+      if (resolution > this->InitialLODResolution)
+        {
+        resolution = this->InitialLODResolution;
+        }
+      change << "LOD resolution " << this->LODResolution << " -> "
+        << resolution;
+      this->LODResolution = resolution;
+      return true;
+      }
+    change << "using full resolution geometry";
+    this->UseLOD = false;
+    return true;
+    }
+
+  if (this->CompressionLevel > this->InitialCompressionLevel)
+    {
+    change << "compression level " << this->CompressionLevel << " -> "
+      << this->CompressionLevel - 1;
+    this->CompressionLevel--;
+    return true;
+    }
+  return false;
+}
+
+//----------------------------------------------------------------------------
+int vtkPVFrameRateController::GetNumberOfDecisions()
+{
+  return static_cast<int>(this->Internals->Decisions.size());
+}
+
+//----------------------------------------------------------------------------
+const char* vtkPVFrameRateController::GetDecision(int index)
+{
+  if (index < 0 || index >= this->GetNumberOfDecisions())
+    {
+    return NULL;
+    }
+  return this->Internals->Decisions[index].c_str();
+}
+
+//----------------------------------------------------------------------------
+void vtkPVFrameRateController::ClearDecisions()
+{
+  this->Internals->Decisions.clear();
+}
+
+//----------------------------------------------------------------------------
+void vtkPVFrameRateController::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "TargetFrameRate: " << this->TargetFrameRate << endl;
+  os << indent << "NumberOfFramesToAverage: "
+     << this->NumberOfFramesToAverage << endl;
+  os << indent << "MinimumLODResolution: "
+     << this->MinimumLODResolution << endl;
+  os << indent << "MaximumImageReductionFactor: "
+     << this->MaximumImageReductionFactor << endl;
+  os << indent << "MaximumCompressionLevel: "
+     << this->MaximumCompressionLevel << endl;
+  os << indent << "Initialized: " << this->Initialized << endl;
+  os << indent << "UseLOD: " << this->UseLOD << endl;
+  os << indent << "LODResolution: " << this->LODResolution << endl;
+  os << indent << "ImageReductionFactor: "
+     << this->ImageReductionFactor << endl;
+  os << indent << "CompressionLevel: " << this->CompressionLevel << endl;
+  os << indent << "LastRenderTime: " << this->LastRenderTime << endl;
+  os << indent << "LastTransferTime: " << this->LastTransferTime << endl;
+  os << indent << "Decisions:" << endl;
+  for (size_t cc = 0; cc < this->Internals->Decisions.size(); cc++)
+    {
+    os << indent.GetNextIndent() << this->Internals->Decisions[cc] << endl;
+    }
+}
@@ -0,0 +1,152 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    vtkPVFrameRateController.h
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME vtkPVFrameRateController - adapts interactive render settings to a
+// target frame rate.
+// .SECTION Description
+// vtkPVFrameRateController is used by vtkPVRenderView to choose the
+// settings of interactive renders from the times of the most recent frames,
+// instead of from static thresholds. The time of a frame is split into the
+// time spent rendering and compositing, and the time spent transferring and
+// decompressing the image on the client.
+//
+// Once NumberOfFramesToAverage frames have been measured, the controller
+// compares their average time to 1/TargetFrameRate. When frames are too
+// slow, it switches to LOD rendering, then lowers the LOD resolution, then
+// raises the image reduction factor. When the transfer dominates, it raises
+// the compression level first. When frames are much faster than needed, the
+// settings are restored in the reverse order. The measurements are
+// discarded after each change so that the next decision sees its effect.
+// The first frame after LOD is turned on or its resolution changes is not
+// measured either, since it also includes the time to decimate the geometry.
+//
+// Each decision is recorded, and can be inspected with GetDecision(), and is
+// also marked in the vtkTimerLog.
+
+#ifndef __vtkPVFrameRateController_h
+#define __vtkPVFrameRateController_h
+
+#include "vtkObject.h"
+
+class VTK_EXPORT vtkPVFrameRateController : public vtkObject
+{
+public:
+  static vtkPVFrameRateController* New();
+  vtkTypeMacro(vtkPVFrameRateController, vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent);
+
+  // Description:
+  // The interactive frame rate to aim for, in frames per second. 10 by
+  // default.
+  vtkSetClampMacro(TargetFrameRate, double, 0.1, 1000.0);
+  vtkGetMacro(TargetFrameRate, double);
+
+  // Description:
+  // Number of frames averaged before taking a decision. 3 by default.
+  vtkSetClampMacro(NumberOfFramesToAverage, int, 1, 100);
+  vtkGetMacro(NumberOfFramesToAverage, int);
+
+  // Description:
+  // Bounds of the settings. The LOD resolution is lowered down to
+  // MinimumLODResolution and the image reduction factor is raised up to
+  // MaximumImageReductionFactor.
+  vtkSetClampMacro(MinimumLODResolution, double, 0.0, 1.0);
+  vtkGetMacro(MinimumLODResolution, double);
+  vtkSetClampMacro(MaximumImageReductionFactor, int, 1, 20);
+  vtkGetMacro(MaximumImageReductionFactor, int);
+  vtkSetClampMacro(MaximumCompressionLevel, int, 0, 5);
+  vtkGetMacro(MaximumCompressionLevel, int);
+
+  // Description:
+  // Start from the given settings. These are also the best quality the
+  // controller will restore. A compression level of -1 means the compressor
+  // has no levels, and it is left alone.
+  void Initialize(double lodResolution, int imageReductionFactor,
+    int compressionLevel);
+
+  // Description:
+  // Forget the settings. Initialize() must be called again.
+  void Reset();
+  vtkGetMacro(Initialized, bool);
+
+  // Description:
+  // Record the time in seconds of the last interactive frame, and take a
+  // decision if enough frames have been measured.
+  void AddFrame(double renderTime, double transferTime);
+
+  // Description:
+  // Do not measure the next frame, e.g. because it also includes the time to
+  // prepare new geometry. Frames added before Initialize() are not measured
+  // anyway.
+  void SkipNextFrame();
+
+  // Description:
+  // The settings to use for the next interactive render.
+  vtkGetMacro(UseLOD, bool);
+  vtkGetMacro(LODResolution, double);
+  vtkGetMacro(ImageReductionFactor, int);
+  vtkGetMacro(CompressionLevel, int);
+
+  // Description:
+  // Times of the last frame, in seconds.
+  vtkGetMacro(LastRenderTime, double);
+  vtkGetMacro(LastTransferTime, double);
+
+  // Description:
+  // Access the most recent decisions, oldest first. At most 100 are kept.
+  int GetNumberOfDecisions();
+  const char* GetDecision(int index);
+  void ClearDecisions();
+
+//BTX
+protected:
+  vtkPVFrameRateController();
+  ~vtkPVFrameRateController();
+
+  // Description:
+  // Change one setting to make frames faster or slower, and describe the
+  // change in the pending decision. Returns false if all the settings are
+  // already at their bounds.
+  bool Degrade(bool transferBound);
+  bool Improve();
+
+  double TargetFrameRate;
+  int NumberOfFramesToAverage;
+  double MinimumLODResolution;
+  int MaximumImageReductionFactor;
+  int MaximumCompressionLevel;
+
+  bool Initialized;
+  bool UseLOD;
+  double LODResolution;
+  int ImageReductionFactor;
+  int CompressionLevel;
+
+  double InitialLODResolution;
+  int InitialImageReductionFactor;
+  int InitialCompressionLevel;
+
+  double LastRenderTime;
+  double LastTransferTime;
+
+private:
+  vtkPVFrameRateController(const vtkPVFrameRateController&); // Not implemented
+  void operator=(const vtkPVFrameRateController&); // Not implemented
+
+  class vtkInternals;
+  vtkInternals* Internals;
+//ETX
+};
+
+#endif
@@ -15,6 +15,7 @@
 #include "vtkPVPluginLoader.h"
 
 #include "vtkDynamicLoader.h"
+#include "vtkMultiProcessController.h"
 #include "vtkNew.h"
 #include "vtkObjectFactory.h"
 #include "vtkProcessModule.h"
@@ -24,13 +25,21 @@
 #include "vtkPVPythonPluginInterface.h"
 #include "vtkPVServerManagerPluginInterface.h"
 #include "vtkPVXMLParser.h"
+#include "vtkTimerLog.h"
 
 #include <vtkstd/string>
 #include <vtksys/SystemTools.hxx>
 #include <vtksys/Directory.hxx>
+#include <vtksys/ios/fstream>
 #include <vtksys/ios/sstream>
 
 #include <cstdlib>
+#include <stdio.h>
+#include <string.h>
+
+#if !defined(_WIN32)
+# include <unistd.h> // for gethostname
+#endif
 
 #define vtkPVPluginLoaderDebugMacro(x)\
 { if (this->DebugPlugin) {\
@@ -41,8 +50,35 @@
 #define vtkPVPluginLoaderErrorMacro(x)\
   if (!no_errors) {vtkErrorMacro(<< x);} this->SetErrorString(x);
 
+// Longest host name compared to find the processes sharing a node.
+#define VTK_PV_PLUGIN_HOST_NAME_LENGTH 256
+
 namespace
 {
+  // Name of the node of this process. A process whose node has no name is
+  // given one of its own.
+  void vtkPVPluginLoaderGetHostName(char* name, int rank)
+    {
+    memset(name, 0, VTK_PV_PLUGIN_HOST_NAME_LENGTH);
+#if defined(_WIN32)
+    const char* computerName = vtksys::SystemTools::GetEnv("COMPUTERNAME");
+    if (computerName)
+      {
+      strncpy(name, computerName, VTK_PV_PLUGIN_HOST_NAME_LENGTH - 1);
+      }
+#else
+    if (gethostname(name, VTK_PV_PLUGIN_HOST_NAME_LENGTH - 1) != 0)
+      {
+      name[0] = '\0';
+      }
+    name[VTK_PV_PLUGIN_HOST_NAME_LENGTH - 1] = '\0';
+#endif
+    if (name[0] == '\0')
+      {
+      sprintf(name, "process %d", rank);
+      }
+    }
+
   // This is an helper class used for plugins constructed from XMLs.
   class vtkPVXMLOnlyPlugin : public vtkPVPlugin,
                            public vtkPVServerManagerPluginInterface
@@ -275,11 +311,19 @@ bool vtkPVPluginLoader::LoadPluginInternal(const char* file, bool no_errors)
   vtkstd::string defaultname = vtksys::SystemTools::GetFilenameWithoutExtension(file);
   this->SetPluginName(defaultname.c_str());
 
+  // The file actually read on this process. Only differs from file on the
+  // satellites of a parallel server receiving it from the root.
+  vtkStdString localFile;
+  if (!this->DistributePluginFile(file, localFile, no_errors))
+    {
+    return false;
+    }
+
 
   if (vtksys::SystemTools::GetFilenameLastExtension(file) == ".xml")
     {
     vtkPVPluginLoaderDebugMacro("Loading XML plugin");
-    vtkPVXMLOnlyPlugin* plugin = vtkPVXMLOnlyPlugin::Create(file);
+    vtkPVXMLOnlyPlugin* plugin = vtkPVXMLOnlyPlugin::Create(localFile.c_str());
     if (plugin)
       {
       ::LibCleaner.Register(plugin);
@@ -290,7 +334,12 @@ bool vtkPVPluginLoader::LoadPluginInternal(const char* file, bool no_errors)
     return false;
     }
 
-  vtkLibHandle lib = vtkDynamicLoader::OpenLibrary(file);
+  double start = vtkTimerLog::GetUniversalTime();
+  vtkTimerLog::MarkStartEvent("vtkPVPluginLoader Open");
+  vtkLibHandle lib = vtkDynamicLoader::OpenLibrary(localFile.c_str());
+  vtkTimerLog::MarkEndEvent("vtkPVPluginLoader Open");
+  vtkPVPluginLoaderDebugMacro("Opened " << localFile.c_str() << " in "
+    << vtkTimerLog::GetUniversalTime() - start << " s");
   if (!lib)
     {
     vtkPVPluginLoaderErrorMacro(vtkDynamicLoader::LastError());
@@ -468,11 +517,171 @@ bool vtkPVPluginLoader::LoadPlugin(const char* file, vtkPVPlugin* plugin)
 
   // From this point onwards the vtkPVPlugin travels the same path as a
   // statically imported plugin.
+  double start = vtkTimerLog::GetUniversalTime();
+  vtkTimerLog::MarkStartEvent("vtkPVPluginLoader Import");
   vtkPVPlugin::ImportPlugin(plugin);
+  vtkTimerLog::MarkEndEvent("vtkPVPluginLoader Import");
+  vtkPVPluginLoaderDebugMacro("Imported " << plugin->GetPluginName() << " in "
+    << vtkTimerLog::GetUniversalTime() - start << " s");
   this->Loaded = true;
   return true;
 }
 
+//-----------------------------------------------------------------------------
+bool vtkPVPluginLoader::DistributePluginFile(const char* file,
+  vtkStdString& localFile, bool no_errors)
+{
+  localFile = file;
+
+  // Only the processes of the servers are known to all load the same
+  // plugins at the same time.
+  const char* directory = vtksys::SystemTools::GetEnv("PV_PLUGIN_BROADCAST_DIR");
+  vtkProcessModule* pm = vtkProcessModule::GetProcessModule();
+  vtkMultiProcessController* controller =
+    vtkMultiProcessController::GetGlobalController();
+  if (!directory || directory[0] == '\0' || !pm || !controller ||
+    controller->GetNumberOfProcesses() < 2 ||
+    (pm->GetProcessType() != vtkProcessModule::PROCESS_SERVER &&
+     pm->GetProcessType() != vtkProcessModule::PROCESS_DATA_SERVER &&
+     pm->GetProcessType() != vtkProcessModule::PROCESS_RENDER_SERVER))
+    {
+    return true;
+    }
+
+  int rank = controller->GetLocalProcessId();
+  vtkstd::vector<unsigned char> data;
+  vtkIdType size = -1;
+  double start = vtkTimerLog::GetUniversalTime();
+  if (rank == 0)
+    {
+    vtkTimerLog::MarkStartEvent("vtkPVPluginLoader Read");
+    vtksys_ios::ifstream is(file, ios::in | ios::binary);
+    if (is)
+      {
+      is.seekg(0, ios::end);
+      size = static_cast<vtkIdType>(is.tellg());
+      is.seekg(0, ios::beg);
+      if (size > 0)
+        {
+        data.resize(static_cast<size_t>(size));
+        if (!is.read(reinterpret_cast<char*>(&data[0]), size))
+          {
+          size = -1;
+          }
+        }
+      }
+    vtkTimerLog::MarkEndEvent("vtkPVPluginLoader Read");
+    double now = vtkTimerLog::GetUniversalTime();
+    vtkPVPluginLoaderDebugMacro("Read " << size << " bytes from " << file
+      << " in " << now - start << " s");
+    start = now;
+    }
+
+  vtkTimerLog::MarkStartEvent("vtkPVPluginLoader Broadcast");
+  controller->Broadcast(&size, 1, 0);
+  if (size > 0)
+    {
+    data.resize(static_cast<size_t>(size));
+    controller->Broadcast(&data[0], size, 0);
+    }
+  vtkTimerLog::MarkEndEvent("vtkPVPluginLoader Broadcast");
+  double now = vtkTimerLog::GetUniversalTime();
+  vtkPVPluginLoaderDebugMacro("Broadcast " << size << " bytes in "
+    << now - start << " s");
+  start = now;
+
+  if (size < 0)
+    {
+    // The root loads the original file, and reports why it could not be
+    // read.
+    if (rank == 0)
+      {
+      return true;
+      }
+    vtkPVPluginLoaderErrorMacro(
+      "Failed to receive the plugin file from the root process.");
+    return false;
+    }
+
+  // The processes sharing a node load the copy written by the lowest of
+  // their ranks, other than the root which loads the original file.
+  int numProcs = controller->GetNumberOfProcesses();
+  char hostName[VTK_PV_PLUGIN_HOST_NAME_LENGTH];
+  vtkPVPluginLoaderGetHostName(hostName, rank);
+  vtkstd::vector<char> hostNames(numProcs * VTK_PV_PLUGIN_HOST_NAME_LENGTH);
+  controller->AllGather(hostName, &hostNames[0],
+    VTK_PV_PLUGIN_HOST_NAME_LENGTH);
+  int writer = rank;
+  for (int cc=1; cc < rank; cc++)
+    {
+    if (strncmp(&hostNames[cc * VTK_PV_PLUGIN_HOST_NAME_LENGTH], hostName,
+        VTK_PV_PLUGIN_HOST_NAME_LENGTH) == 0)
+      {
+      writer = cc;
+      break;
+      }
+    }
+
+  vtksys_ios::ostringstream localDirectory;
+  localDirectory << directory << "/" << writer;
+  if (rank > 0)
+    {
+    localFile = localDirectory.str() + "/" +
+      vtksys::SystemTools::GetFilenameName(file);
+    }
+
+  // The copy is written aside and renamed, so that a copy already loaded by
+  // the processes of the node stays intact.
+  bool written = true;
+  if (rank > 0 && writer == rank)
+    {
+    vtkTimerLog::MarkStartEvent("vtkPVPluginLoader Write");
+    vtksys::SystemTools::MakeDirectory(localDirectory.str().c_str());
+    vtksys_ios::ostringstream tmpFile;
+    tmpFile << localFile.c_str() << "." << static_cast<vtkTypeUInt64>(
+      vtkTimerLog::GetUniversalTime() * 1.0e6) << ".tmp";
+    vtksys_ios::ofstream os(tmpFile.str().c_str(),
+      ios::out | ios::binary | ios::trunc);
+    if (os && size > 0)
+      {
+      os.write(reinterpret_cast<const char*>(&data[0]),
+        static_cast<vtkstd::streamsize>(size));
+      }
+    os.close();
+    written = !os.fail();
+#if defined(_WIN32)
+    if (written)
+      {
+      remove(localFile.c_str());
+      }
+#endif
+    written = written && rename(tmpFile.str().c_str(), localFile.c_str()) == 0;
+    if (!written)
+      {
+      remove(tmpFile.str().c_str());
+      }
+    vtkTimerLog::MarkEndEvent("vtkPVPluginLoader Write");
+    vtkPVPluginLoaderDebugMacro("Wrote " << localFile.c_str() << " in "
+      << vtkTimerLog::GetUniversalTime() - start << " s");
+    }
+
+  // All the processes wait for the copies to be written before loading
+  // them, and fail together if any copy could not be written, so that the
+  // plugin is loaded everywhere or nowhere.
+  int failed = written ? 0 : 1;
+  int numFailed = 0;
+  controller->AllReduce(&failed, &numFailed, 1, vtkCommunicator::SUM_OP);
+  if (numFailed > 0)
+    {
+    vtksys_ios::ostringstream error;
+    error << "Failed to write the plugin file received from the root process"
+      << " on " << numFailed << " node(s).";
+    vtkPVPluginLoaderErrorMacro(error.str().c_str());
+    return false;
+    }
+  return true;
+}
+
 //-----------------------------------------------------------------------------
 void vtkPVPluginLoader::LoadPluginConfigurationXMLFromString(const char*
   xmlcontents)
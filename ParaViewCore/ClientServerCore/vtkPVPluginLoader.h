@@ -20,11 +20,20 @@
 // This class only needed when loading plugins from shared libraries
 // dynamically. For statically importing plugins, one directly uses
 // PV_PLUGIN_IMPORT() macro defined in vtkPVPlugin.h.
+//
+// On parallel servers, every process loading the plugin file from a shared
+// file system can be slow. When the environment variable
+// PV_PLUGIN_BROADCAST_DIR is set to a node-local directory on all the
+// processes, the root process reads the plugin file and broadcasts it, and
+// the other processes write it under that directory and load their copy.
+// The time spent reading, broadcasting, writing, opening and importing the
+// plugin is reported through vtkTimerLog, and printed with PV_PLUGIN_DEBUG.
 
 #ifndef __vtkPVPluginLoader_h
 #define __vtkPVPluginLoader_h
 
 #include "vtkObject.h"
+#include "vtkStdString.h" // needed for vtkStdString.
 
 class vtkIntArray;
 class vtkPVPlugin;
@@ -100,6 +109,16 @@ protected:
   // plugin.
   bool LoadPlugin(const char*file, vtkPVPlugin* plugin);
 
+  // Description:
+  // Called by LoadPluginInternal() to share the plugin file among the
+  // processes of a parallel server, when PV_PLUGIN_BROADCAST_DIR is set.
+  // This must be called by all of them. One process per node writes the
+  // copy loaded by the others on that node. localFile is set to the file to
+  // load on this process. Returns false on all processes if any copy could
+  // not be written.
+  bool DistributePluginFile(const char* file, vtkStdString& localFile,
+    bool no_errors);
+
   vtkSetStringMacro(ErrorString);
   vtkSetStringMacro(PluginName);
   vtkSetStringMacro(PluginVersion);
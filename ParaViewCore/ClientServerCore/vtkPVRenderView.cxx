@@ -27,6 +27,7 @@
 #include "vtkInformationVector.h"
 #include "vtkInteractorStyleRubberBand3D.h"
 #include "vtkInteractorStyleRubberBandZoom.h"
+#include "vtkKdTreeManager.h"
 #include "vtkLight.h"
 #include "vtkLightKit.h"
 #include "vtkMath.h"
@@ -41,6 +42,7 @@
 #include "vtkPVCenterAxesActor.h"
 #include "vtkPVDataRepresentation.h"
 #include "vtkPVDisplayInformation.h"
+#include "vtkPVFrameRateController.h"
 #include "vtkPVGenericRenderWindowInteractor.h"
 #include "vtkPVHardwareSelector.h"
 #include "vtkPVInteractorStyle.h"
@@ -74,6 +76,7 @@ vtkStandardNewMacro(vtkPVRenderView);
 vtkInformationKeyMacro(vtkPVRenderView, GEOMETRY_SIZE, Integer);
 vtkInformationKeyMacro(vtkPVRenderView, DATA_DISTRIBUTION_MODE, Integer);
 vtkInformationKeyMacro(vtkPVRenderView, USE_LOD, Integer);
+vtkInformationKeyMacro(vtkPVRenderView, LOD_NEEDED_FOR_INTERACTION, Integer);
 vtkInformationKeyMacro(vtkPVRenderView, DELIVER_OUTLINE_TO_CLIENT, Integer);
 vtkInformationKeyMacro(vtkPVRenderView, DELIVER_OUTLINE_TO_CLIENT_FOR_LOD, Integer);
 vtkInformationKeyMacro(vtkPVRenderView, DELIVER_LOD_TO_CLIENT, Integer);
@@ -101,6 +104,12 @@ vtkPVRenderView::vtkPVRenderView()
   this->ClientOutlineThreshold = 5;
   this->LODResolution = 0.5;
   this->UseLightKit = false;
+  this->AdaptiveFrameRate = false;
+  this->FrameRateController = vtkPVFrameRateController::New();
+  this->AdaptiveUseLOD = false;
+  this->RenderLODResolution = 0.5;
+  this->AdaptiveImageReductionFactor = 2;
+  this->AdaptiveCompressionLevel = -1;
   this->Interactor = 0;
   this->InteractorStyle = 0;
   this->RubberBandStyle = 0;
@@ -229,6 +238,7 @@ vtkPVRenderView::~vtkPVRenderView()
 
   this->SetLastSelection(NULL);
   this->Selector->Delete();
+  this->FrameRateController->Delete();
   this->SynchronizedRenderers->Delete();
   this->NonCompositedRenderer->Delete();
   this->RenderView->Delete();
@@ -409,11 +419,6 @@ void vtkPVRenderView::Select(int fieldAssociation, int region[4])
   bool render_event_propagation =
     this->SynchronizedWindows->GetRenderEventPropagation();
   this->SynchronizedWindows->RenderEventPropagationOff();
-  // Make sure that the representations are up-to-date. This is required since
-  // due to delayed-swicth-back-from-lod, the most recent render maybe a LOD
-  // render (or a nonremote render) in which case we need to update the
-  // representation pipelines correctly.
-  this->Render(/*interactive*/false, /*skip-rendering*/false);
 
   this->SetLastSelection(NULL);
 
@@ -425,7 +430,42 @@ void vtkPVRenderView::Select(int fieldAssociation, int region[4])
     vtkMultiProcessController::GetGlobalController()?
     vtkMultiProcessController::GetGlobalController()->GetLocalProcessId() : 0);
 
-  vtkSelection* sel = this->Selector->Select(region);
+  // The driver decides for all processes: their renderers may not have the
+  // same size, and the captured area must be the same everywhere.
+  int area[4];
+  this->Selector->GetCaptureArea(region, area);
+  double decision[5];
+  decision[0] = this->Selector->NeedToRenderForSelection(region)? 1.0 : 0.0;
+  for (int cc=0; cc < 4; cc++)
+    {
+    decision[cc+1] = area[cc];
+    }
+  this->SynchronizedWindows->BroadcastFromDriver(decision, 5);
+  bool need_render = (decision[0] != 0.0);
+  for (int cc=0; cc < 4; cc++)
+    {
+    area[cc] = static_cast<int>(decision[cc+1]);
+    }
+  if (need_render)
+    {
+    // Make sure that the representations are up-to-date. This is required
+    // since due to delayed-swicth-back-from-lod, the most recent render maybe
+    // a LOD render (or a nonremote render) in which case we need to update the
+    // representation pipelines correctly. Not needed when the cached buffers
+    // are reused since nothing changed since they were captured.
+    this->Render(/*interactive*/false, /*skip-rendering*/false);
+
+    // Only render and composite the area that gets captured.
+    this->SynchronizedRenderers->SetRenderRegion(area);
+    }
+
+  vtkSelection* sel = this->Selector->Select(region, need_render, area);
+
+  if (need_render)
+    {
+    int full_viewport[4] = {0, 0, -1, -1};
+    this->SynchronizedRenderers->SetRenderRegion(full_viewport);
+    }
   if (sel)
     {
     // A valid sel is only generated on the "driver" node. The driver node may not have
@@ -647,8 +687,27 @@ void vtkPVRenderView::Render(bool interactive, bool skip_rendering)
   // Use loss-less image compression for client-server for full-res renders.
   this->SynchronizedRenderers->SetLossLessCompression(!interactive);
 
+  bool adaptive = interactive && this->AdaptiveFrameRate;
+  this->RenderLODResolution = this->LODResolution;
+  if (adaptive)
+    {
+    this->SynchronizeFrameRateSettings();
+    }
+
   bool use_lod_rendering = interactive? this->GetUseLODRendering() : false;
+  if (adaptive)
+    {
+    use_lod_rendering = this->AdaptiveUseLOD;
+    }
   this->SetRequestLODRendering(use_lod_rendering);
+  if (this->GetUseLODRendering() || (adaptive && this->AdaptiveUseLOD))
+    {
+    this->RequestInformation->Set(LOD_NEEDED_FOR_INTERACTION(), 1);
+    }
+  else
+    {
+    this->RequestInformation->Remove(LOD_NEEDED_FOR_INTERACTION());
+    }
 
   // cout << "Using remote rendering: " << use_distributed_rendering << endl;
   bool in_tile_display_mode = this->InTileDisplayMode();
@@ -723,6 +782,10 @@ void vtkPVRenderView::Render(bool interactive, bool skip_rendering)
     vtkPVView::REQUEST_PREPARE_FOR_RENDER(),
     this->RequestInformation, this->ReplyInformationVector);
 
+  // When the data changed since the last interactive render, this frame also
+  // decimates and delivers the new geometry.
+  bool new_lod_geometry = use_lod_rendering &&
+    this->UpdateTime > this->InteractiveRenderTime;
   this->DoDataDelivery(use_lod_rendering, use_distributed_rendering);
 
   if (use_distributed_rendering &&
@@ -757,10 +820,20 @@ void vtkPVRenderView::Render(bool interactive, bool skip_rendering)
     this->RequestInformation, this->ReplyInformationVector);
 
   // set the image reduction factor.
-  this->SynchronizedRenderers->SetImageReductionFactor(
-    (interactive?
-     this->InteractiveRenderImageReductionFactor :
-     this->StillRenderImageReductionFactor));
+  if (adaptive)
+    {
+    this->SynchronizedRenderers->SetImageReductionFactor(
+      this->AdaptiveImageReductionFactor);
+    }
+  else
+    {
+    this->SynchronizedRenderers->SetImageReductionFactor(
+      (interactive?
+       this->InteractiveRenderImageReductionFactor :
+       this->StillRenderImageReductionFactor));
+    }
+  this->SynchronizedRenderers->SetCompressionLevel(
+    adaptive? this->AdaptiveCompressionLevel : -1);
 
   if (!interactive)
     {
@@ -798,12 +871,27 @@ void vtkPVRenderView::Render(bool interactive, bool skip_rendering)
   // Call Render() on local render window only if
   // 1: Local process is the driver OR
   // 2: RenderEventPropagation is Off and we are doing distributed rendering.
+  double start = vtkTimerLog::GetUniversalTime();
   if (this->SynchronizedWindows->GetLocalProcessIsDriver() ||
     (!this->SynchronizedWindows->GetRenderEventPropagation() &&
      use_distributed_rendering))
     {
     this->GetRenderWindow()->Render();
     }
+
+  if (adaptive && this->SynchronizedWindows->GetLocalProcessIsDriver())
+    {
+    if (new_lod_geometry)
+      {
+      this->FrameRateController->SkipNextFrame();
+      }
+    // The render time includes compositing, as seen from the driver.
+    double frame = vtkTimerLog::GetUniversalTime() - start;
+    double transfer = use_distributed_rendering?
+      this->SynchronizedRenderers->GetLastTransferTime() : 0.0;
+    this->FrameRateController->AddFrame(
+      frame > transfer? frame - transfer : 0.0, transfer);
+    }
 }
 
 //----------------------------------------------------------------------------
@@ -928,7 +1016,7 @@ void vtkPVRenderView::SetRequestLODRendering(bool enable)
   if (enable)
     {
     this->RequestInformation->Set(USE_LOD(), 1);
-    this->RequestInformation->Set(LOD_RESOLUTION(), this->LODResolution);
+    this->RequestInformation->Set(LOD_RESOLUTION(), this->RenderLODResolution);
     }
   else
     {
@@ -937,6 +1025,50 @@ void vtkPVRenderView::SetRequestLODRendering(bool enable)
     }
 }
 
+//----------------------------------------------------------------------------
+void vtkPVRenderView::SetAdaptiveFrameRate(bool val)
+{
+  if (this->AdaptiveFrameRate != val)
+    {
+    this->AdaptiveFrameRate = val;
+    // Start again from the static settings when turned back on.
+    this->FrameRateController->Reset();
+    this->Modified();
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkPVRenderView::SetTargetFrameRate(double rate)
+{
+  this->FrameRateController->SetTargetFrameRate(rate);
+}
+
+//----------------------------------------------------------------------------
+void vtkPVRenderView::SynchronizeFrameRateSettings()
+{
+  vtkPVFrameRateController* controller = this->FrameRateController;
+  if (!controller->GetInitialized())
+    {
+    controller->Initialize(this->LODResolution,
+      this->InteractiveRenderImageReductionFactor,
+      this->SynchronizedRenderers->GetConfiguredCompressionLevel());
+    }
+
+  // Only the settings chosen on the driver count, the controllers of the
+  // other processes never see a frame.
+  double settings[4];
+  settings[0] = controller->GetUseLOD()? 1.0 : 0.0;
+  settings[1] = controller->GetLODResolution();
+  settings[2] = controller->GetImageReductionFactor();
+  settings[3] = controller->GetCompressionLevel();
+  this->SynchronizedWindows->BroadcastFromDriver(settings, 4);
+
+  this->AdaptiveUseLOD = (settings[0] != 0.0);
+  this->RenderLODResolution = settings[1];
+  this->AdaptiveImageReductionFactor = static_cast<int>(settings[2]);
+  this->AdaptiveCompressionLevel = static_cast<int>(settings[3]);
+}
+
 //----------------------------------------------------------------------------
 void vtkPVRenderView::GatherRepresentationInformation()
 {
@@ -1059,6 +1191,25 @@ bool vtkPVRenderView::GetUseOrderedCompositing()
     }
 }
 
+//----------------------------------------------------------------------------
+void vtkPVRenderView::SetReuseOrderedCompositingPartition(bool reuse)
+{
+  vtkKdTreeManager* mgr =
+    this->OrderedCompositingBSPCutsSource->GetKdTreeManager();
+  if (mgr->GetReusePartition() != (reuse ? 1 : 0))
+    {
+    mgr->SetReusePartition(reuse ? 1 : 0);
+    this->Modified();
+    }
+}
+
+//----------------------------------------------------------------------------
+bool vtkPVRenderView::GetReuseOrderedCompositingPartition()
+{
+  return this->OrderedCompositingBSPCutsSource->GetKdTreeManager()->
+    GetReusePartition() != 0;
+}
+
 //----------------------------------------------------------------------------
 void vtkPVRenderView::SetUseLightKit(bool use)
 {
@@ -1158,6 +1309,9 @@ void vtkPVRenderView::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os, indent);
   os << indent << "UseLightKit: " << this->UseLightKit << endl;
+  os << indent << "AdaptiveFrameRate: " << this->AdaptiveFrameRate << endl;
+  os << indent << "FrameRateController: " << endl;
+  this->FrameRateController->PrintSelf(os, indent.GetNextIndent());
 }
 
 //----------------------------------------------------------------------------
@@ -52,6 +52,7 @@ class vtkPVHardwareSelector;
 class vtkProp;
 class vtkPVAxesWidget;
 class vtkPVCenterAxesActor;
+class vtkPVFrameRateController;
 class vtkPVGenericRenderWindowInteractor;
 class vtkPVInteractorStyle;
 class vtkPVSynchronizedRenderer;
@@ -205,6 +206,28 @@ public:
   vtkSetClampMacro(LODResolution, double, 0.0, 1.0);
   vtkGetMacro(LODResolution, double);
 
+  // Description:
+  // When on, interactive renders let the vtkPVFrameRateController choose
+  // whether to use LOD, the LOD resolution, the image reduction factor and
+  // the compression level from the times of the last frames, to reach
+  // TargetFrameRate. LODRenderingThreshold, LODResolution and
+  // InteractiveRenderImageReductionFactor then only give the settings it
+  // starts from. Off by default.
+  // @CallOnAllProcessess
+  void SetAdaptiveFrameRate(bool);
+  vtkGetMacro(AdaptiveFrameRate, bool);
+  vtkBooleanMacro(AdaptiveFrameRate, bool);
+
+  // Description:
+  // Set the interactive frame rate aimed at when AdaptiveFrameRate is on.
+  // @CallOnAllProcessess
+  void SetTargetFrameRate(double);
+
+  // Description:
+  // Provides access to the frame rate controller. Its decisions are taken on
+  // the client, or on the root node in batch mode.
+  vtkGetObjectMacro(FrameRateController, vtkPVFrameRateController);
+
   // Description:
   // This threshold is only applicable when in client-server mode. It is the size
   // of geometry in megabytes beyond which the view should not deliver geometry
@@ -213,6 +236,15 @@ public:
   vtkSetMacro(ClientOutlineThreshold, double);
   vtkGetMacro(ClientOutlineThreshold, double);
 
+  // Description:
+  // When on, the cuts used to distribute the data for ordered compositing are
+  // kept while the data stays close to what they were built for, instead of
+  // being computed again every time the data changes. See
+  // vtkKdTreeManager::SetReusePartition(). Off by default.
+  // @CallOnAllProcessess
+  void SetReuseOrderedCompositingPartition(bool);
+  bool GetReuseOrderedCompositingPartition();
+
   // Description:
   // Passes the compressor configuration to the client-server synchronizer, if
   // any. This affects the image compression used to relay images back to the
@@ -248,6 +280,11 @@ public:
   // USE_LOD indicates if LOD is being used for the current render/update.
   static vtkInformationIntegerKey* USE_LOD();
 
+  // LOD_NEEDED_FOR_INTERACTION indicates that interactive renders would use
+  // LOD for the current geometry size, even though the current render may
+  // not. Representations can use it to prepare their LOD ahead of time.
+  static vtkInformationIntegerKey* LOD_NEEDED_FOR_INTERACTION();
+
   // DELIVER_LOD_TO_CLIENT is not used currently. I am just defining it as a
   // placeholder. Currently tile-displays don't have the mode in which only LOD
   // is delivered to the client.
@@ -495,6 +532,12 @@ protected:
   // Update the request to enable/disable low-res rendering.
   void SetRequestLODRendering(bool);
 
+  // Description:
+  // Passes the settings chosen by the FrameRateController on the driver to
+  // all processes.
+  // @CallOnAllProcessess
+  void SynchronizeFrameRateSettings();
+
   // Description:
   // Set the last selection object.
   void SetLastSelection(vtkSelection*);
@@ -541,6 +584,16 @@ protected:
   double LODResolution;
   bool UseLightKit;
 
+  bool AdaptiveFrameRate;
+  vtkPVFrameRateController* FrameRateController;
+
+  // Settings of the current render. They come from the FrameRateController
+  // when AdaptiveFrameRate is on.
+  bool AdaptiveUseLOD;
+  double RenderLODResolution;
+  int AdaptiveImageReductionFactor;
+  int AdaptiveCompressionLevel;
+
   bool UsedLODForLastRender;
 
   static bool RemoteRenderingAllowed;
@@ -1333,6 +1333,67 @@ bool vtkPVSynchronizedRenderWindows::SynchronizeSize(unsigned int& size)
   return this->SynchronizeSizeTemplate<unsigned int>(size);
 }
 
+//----------------------------------------------------------------------------
+bool vtkPVSynchronizedRenderWindows::BroadcastFromDriver(
+  double* values, int count)
+{
+  // handle trivial case.
+  if (this->Mode == BUILTIN || this->Mode == INVALID)
+    {
+    return true;
+    }
+
+  vtkMultiProcessController* parallelController =
+    vtkMultiProcessController::GetGlobalController();
+  vtkMultiProcessController* c_rs_controller =
+    this->GetClientServerController();
+
+  // c_ds_controller is non-null only in client-dataserver-renderserver
+  // configuratrions.
+  vtkMultiProcessController* c_ds_controller =
+    this->GetClientDataServerController();
+  assert(c_ds_controller == NULL || c_ds_controller != c_rs_controller);
+
+  // Unlike SynchronizeSize(), the values only travel away from the client so
+  // it does not wait for the servers.
+  switch (this->Mode)
+    {
+  case CLIENT:
+    if (c_ds_controller)
+      {
+      c_ds_controller->Send(values, count, 1, 41235);
+      }
+    if (c_rs_controller)
+      {
+      c_rs_controller->Send(values, count, 1, 41235);
+      }
+    break;
+
+  case DATA_SERVER:
+    if (c_ds_controller)
+      {
+      c_ds_controller->Receive(values, count, 1, 41235);
+      }
+    break;
+
+  case RENDER_SERVER:
+    if (c_rs_controller)
+      {
+      c_rs_controller->Receive(values, count, 1, 41235);
+      }
+    break;
+
+  default:
+    assert(c_ds_controller==NULL && c_rs_controller == NULL);
+    }
+
+  if (parallelController)
+    {
+    parallelController->Broadcast(values, count, 0);
+    }
+  return true;
+}
+
 //----------------------------------------------------------------------------
 bool vtkPVSynchronizedRenderWindows::SynchronizeBounds(double bounds[6])
 {
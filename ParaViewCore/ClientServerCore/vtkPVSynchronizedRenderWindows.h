@@ -109,6 +109,7 @@ public:
   bool SynchronizeBounds(double bounds[6]);
   bool SynchronizeSize(double &size);
   bool SynchronizeSize(unsigned int &size);
+  bool BroadcastFromDriver(double* values, int count);
   bool BroadcastToDataServer(vtkSelection* selection);
   bool BroadcastToRenderServer(vtkDataObject*);
 
@@ -270,6 +270,33 @@ void vtkPVSynchronizedRenderer::ConfigureCompressor(const char* configuration)
     }
 }
 
+//----------------------------------------------------------------------------
+void vtkPVSynchronizedRenderer::SetCompressionLevel(int level)
+{
+  vtkPVClientServerSynchronizedRenderers* cssync =
+    vtkPVClientServerSynchronizedRenderers::SafeDownCast(this->CSSynchronizer);
+  if (cssync)
+    {
+    cssync->SetCompressionLevel(level);
+    }
+}
+
+//----------------------------------------------------------------------------
+int vtkPVSynchronizedRenderer::GetConfiguredCompressionLevel()
+{
+  vtkPVClientServerSynchronizedRenderers* cssync =
+    vtkPVClientServerSynchronizedRenderers::SafeDownCast(this->CSSynchronizer);
+  return cssync? cssync->GetConfiguredCompressionLevel() : -1;
+}
+
+//----------------------------------------------------------------------------
+double vtkPVSynchronizedRenderer::GetLastTransferTime()
+{
+  vtkPVClientServerSynchronizedRenderers* cssync =
+    vtkPVClientServerSynchronizedRenderers::SafeDownCast(this->CSSynchronizer);
+  return cssync? cssync->GetLastTransferTime() : 0.0;
+}
+
 //----------------------------------------------------------------------------
 void vtkPVSynchronizedRenderer::SetImageProcessingPass(
   vtkImageProcessingPass* pass)
@@ -445,6 +472,20 @@ void vtkPVSynchronizedRenderer::SetKdTree(vtkPKdTree* tree)
   (void)tree;
 }
 
+//----------------------------------------------------------------------------
+void vtkPVSynchronizedRenderer::SetRenderRegion(int region[4])
+{
+#ifdef PARAVIEW_USE_ICE_T
+  vtkIceTSynchronizedRenderers* sync =
+    vtkIceTSynchronizedRenderers::SafeDownCast(this->ParallelSynchronizer);
+  if (sync)
+    {
+    sync->SetRenderRegion(region);
+    }
+#endif
+  (void)region;
+}
+
 //----------------------------------------------------------------------------
 void vtkPVSynchronizedRenderer::PrintSelf(ostream& os, vtkIndent indent)
 {
@@ -51,6 +51,12 @@ public:
   // This is used only when UseOrderedCompositing is true.
   void SetKdTree(vtkPKdTree *kdtree);
 
+  // Description:
+  // Restrict rendering and compositing to a region of the display, in pixels
+  // (xmin, ymin, xmax, ymax). Used when rendering for selection. An empty
+  // region (xmax < xmin) renders the whole viewport.
+  void SetRenderRegion(int region[4]);
+
   // Description:
   // Set the renderer that is being synchronized.
   void SetRenderer(vtkRenderer*);
@@ -97,6 +103,14 @@ public:
   void ConfigureCompressor(const char* configuration);
   void SetLossLessCompression(bool);
 
+  // Description:
+  // Forwarded to the client-server synchronizer, if any. The configured
+  // compression level is -1 and the transfer time is 0 otherwise.
+  // See vtkPVClientServerSynchronizedRenderers for details.
+  void SetCompressionLevel(int);
+  int GetConfiguredCompressionLevel();
+  double GetLastTransferTime();
+
   // Description:
   // Activates or de-activated the use of Depth Buffer in an ImageProcessingPass
   void SetUseDepthBuffer(bool);
@@ -241,6 +241,32 @@ const char* vtkPVXMLElement::GetAttributeOrDefault( const char* name,
     }
   return notFound;
 }
+//----------------------------------------------------------------------------
+unsigned int vtkPVXMLElement::GetNumberOfAttributes()
+{
+  return static_cast<unsigned int>(this->Internal->AttributeNames.size());
+}
+
+//----------------------------------------------------------------------------
+const char* vtkPVXMLElement::GetAttributeName(unsigned int index)
+{
+  if (index < this->Internal->AttributeNames.size())
+    {
+    return this->Internal->AttributeNames[index].c_str();
+    }
+  return 0;
+}
+
+//----------------------------------------------------------------------------
+const char* vtkPVXMLElement::GetAttributeValue(unsigned int index)
+{
+  if (index < this->Internal->AttributeValues.size())
+    {
+    return this->Internal->AttributeValues[index].c_str();
+    }
+  return 0;
+}
+
 //----------------------------------------------------------------------------
 const char* vtkPVXMLElement::GetCharacterData()
 {
@@ -47,6 +47,11 @@ public:
   // and can be used as an identifier to an element.
   vtkGetStringMacro(Id);
 
+  // Description:
+  // Set the id of the element. Only needed by code building elements that
+  // were not read by the XML parser, but must have the id they had.
+  vtkSetStringMacro(Id);
+
   // Description:
   // Get the attribute with the given name.  If it doesn't exist,
   // returns NULL.
@@ -64,10 +69,21 @@ public:
   // If it doesn't exist, returns the provided notFound value.
   const char* GetAttributeOrDefault(const char* name, const char* notFound);
 
+  // Description:
+  // Get the number of attributes of the element, and the name and the value
+  // of the attribute at the given index, in the order they were added.
+  unsigned int GetNumberOfAttributes();
+  const char* GetAttributeName(unsigned int index);
+  const char* GetAttributeValue(unsigned int index);
+
   // Description:
   // Get the character data for the element.
   const char* GetCharacterData();
 
+  // Description:
+  // Append to the character data of the element.
+  void AddCharacterData(const char* data, int length);
+
   // Description:
   // Get the attribute with the given name converted to a scalar
   // value.  Returns whether value was extracted.
@@ -221,9 +237,7 @@ protected:
   vtkPVXMLElement* Parent;
 
   // Method used by vtkPVXMLParser to setup the element.
-  vtkSetStringMacro(Id);
   void ReadXMLAttributes(const char** atts);
-  void AddCharacterData(const char* data, int length);
 
 
   // Internal utility methods.
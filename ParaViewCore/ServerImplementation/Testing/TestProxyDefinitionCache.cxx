@@ -0,0 +1,162 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestProxyDefinitionCache.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Saves the proxy definitions in the PV_PROXY_DEFINITION_CACHE file, loads
+// them back, and checks that every core definition and its collapsed
+// version print the same XML as after a fresh parse. Also checks that a
+// truncated cache is parsed again and rewritten.
+
+#include "vtkPVProxyDefinitionIterator.h"
+#include "vtkPVXMLElement.h"
+#include "vtkSIProxyDefinitionManager.h"
+#include "vtkSmartPointer.h"
+#include "vtkTestUtilities.h"
+
+#include <vtksys/SystemTools.hxx>
+#include <vtksys/ios/fstream>
+#include <vtksys/ios/sstream>
+#include <vtkstd/string>
+#include <vtkstd/vector>
+
+namespace
+{
+  vtkstd::string PrintXML(vtkPVXMLElement* element)
+  {
+    vtksys_ios::ostringstream xml;
+    if (element)
+      {
+      element->PrintXML(xml, vtkIndent());
+      }
+    return xml.str();
+  }
+
+  bool Compare(const char* name, vtkSIProxyDefinitionManager* expected,
+               vtkSIProxyDefinitionManager* actual)
+  {
+    int count = 0;
+    vtkPVProxyDefinitionIterator* iter =
+      expected->NewIterator(vtkSIProxyDefinitionManager::CORE_DEFINITIONS);
+    for (iter->InitTraversal(); !iter->IsDoneWithTraversal();
+         iter->GoToNextItem())
+      {
+      const char* group = iter->GetGroupName();
+      const char* proxy = iter->GetProxyName();
+      vtkPVXMLElement* definition = actual->GetProxyDefinition(group, proxy,
+                                                               false);
+      vtkPVXMLElement* collapsed = actual->GetCollapsedProxyDefinition(
+        group, proxy, NULL, false);
+      if (!definition || !collapsed ||
+          PrintXML(definition) != PrintXML(iter->GetProxyDefinition()) ||
+          PrintXML(collapsed) != PrintXML(
+            expected->GetCollapsedProxyDefinition(group, proxy, NULL, false)))
+        {
+        cerr << "The definition of " << group << ", " << proxy << " "
+             << name << " differs from the parsed one" << endl;
+        iter->Delete();
+        return false;
+        }
+      count++;
+      }
+    iter->Delete();
+
+    // No more definitions either.
+    iter = actual->NewIterator(vtkSIProxyDefinitionManager::CORE_DEFINITIONS);
+    for (iter->InitTraversal(); !iter->IsDoneWithTraversal();
+         iter->GoToNextItem())
+      {
+      count--;
+      }
+    iter->Delete();
+    if (count != 0)
+      {
+      cerr << "Wrong number of definitions " << name << endl;
+      return false;
+      }
+    return true;
+  }
+
+  bool ReadFile(const vtkstd::string& fileName, vtkstd::string& contents)
+  {
+    vtksys_ios::ifstream file(fileName.c_str(), ios::in | ios::binary);
+    vtksys_ios::ostringstream data;
+    data << file.rdbuf();
+    contents = data.str();
+    return file && !contents.empty();
+  }
+
+  void WriteFile(const vtkstd::string& fileName, const vtkstd::string& contents)
+  {
+    vtksys_ios::ofstream file(fileName.c_str(),
+                              ios::out | ios::binary | ios::trunc);
+    file.write(contents.c_str(), contents.size());
+  }
+}
+
+int main(int argc, char* argv[])
+{
+  char* tempDir = vtkTestUtilities::GetArgOrEnvOrDefault(
+    "-T", argc, argv, "VTK_TEMP_DIR", "Testing/Temporary");
+  vtkstd::string cacheName =
+    vtkstd::string(tempDir) + "/ProxyDefinitionCache.bin";
+  delete [] tempDir;
+
+  // Parsed from the XML.
+  vtksys::SystemTools::PutEnv("PV_PROXY_DEFINITION_CACHE=");
+  vtkSmartPointer<vtkSIProxyDefinitionManager> parsed =
+    vtkSmartPointer<vtkSIProxyDefinitionManager>::New();
+
+  // Parsed and saved, then loaded.
+  vtkstd::string env = "PV_PROXY_DEFINITION_CACHE=" + cacheName;
+  vtksys::SystemTools::PutEnv(env.c_str());
+  vtksys::SystemTools::RemoveFile(cacheName.c_str());
+  vtkSmartPointer<vtkSIProxyDefinitionManager> saved =
+    vtkSmartPointer<vtkSIProxyDefinitionManager>::New();
+  vtkstd::string cache;
+  if (!ReadFile(cacheName, cache))
+    {
+    cerr << "The cache " << cacheName << " was not written" << endl;
+    return 1;
+    }
+  bool ok = Compare("when saving the cache", parsed, saved);
+  vtkSmartPointer<vtkSIProxyDefinitionManager> loaded =
+    vtkSmartPointer<vtkSIProxyDefinitionManager>::New();
+  ok = Compare("loaded from the cache", parsed, loaded) && ok;
+
+  // Truncated in its header, and after it in the definitions.
+  size_t sizes[2] = { 10, cache.size() / 2 };
+  for (int i = 0; i < 2; i++)
+    {
+    WriteFile(cacheName, cache.substr(0, sizes[i]));
+    vtkSmartPointer<vtkSIProxyDefinitionManager> truncated =
+      vtkSmartPointer<vtkSIProxyDefinitionManager>::New();
+    ok = Compare("with a truncated cache", parsed, truncated) && ok;
+    vtkstd::string rewritten;
+    if (!ReadFile(cacheName, rewritten) || rewritten != cache)
+      {
+      cerr << "The truncated cache was not rewritten" << endl;
+      ok = false;
+      }
+    }
+
+  // Damaged in the middle.
+  vtkstd::string damaged = cache;
+  damaged[damaged.size() / 2] ^= 0x5a;
+  WriteFile(cacheName, damaged);
+  vtkSmartPointer<vtkSIProxyDefinitionManager> reparsed =
+    vtkSmartPointer<vtkSIProxyDefinitionManager>::New();
+  ok = Compare("with a damaged cache", parsed, reparsed) && ok;
+
+  vtksys::SystemTools::RemoveFile(cacheName.c_str());
+  return ok ? 0 : 1;
+}
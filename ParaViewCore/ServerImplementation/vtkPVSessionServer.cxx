@@ -305,6 +305,22 @@ void vtkPVSessionServer::OnClientServerMessageRMI(void* message, int message_len
       }
     break;
 
+  case vtkPVSessionServer::PUSH_TRANSACTION:
+      {
+      // Messages pushed by the client during a transaction, in order.
+      int count;
+      stream >> count;
+      for (int cc=0; cc < count; cc++)
+        {
+        vtkstd::string string;
+        stream >> string;
+        vtkSMMessage msg;
+        msg.ParseFromString(string);
+        this->PushState(&msg);
+        }
+      }
+    break;
+
   case vtkPVSessionServer::PULL:
       {
       vtkstd::string string;
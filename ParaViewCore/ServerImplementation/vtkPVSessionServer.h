@@ -72,6 +72,7 @@ public:
     GATHER_INFORMATION=4,
     DELETE_SI=5,
     LAST_RESULT=6,
+    PUSH_TRANSACTION=7,
     CLIENT_SERVER_MESSAGE_RMI=55625,
     CLOSE_SESSION=55626,
     REPLY_GATHER_INFORMATION_TAG=55627,
@@ -18,6 +18,8 @@
 #include "vtkCollectionIterator.h"
 #include "vtkCommand.h"
 #include "vtkInstantiator.h"
+#include "vtkMultiProcessController.h"
+#include "vtkMultiProcessStream.h"
 #include "vtkNew.h"
 #include "vtkObjectFactory.h"
 #include "vtkPVConfig.h"
@@ -28,6 +30,7 @@
 #include "vtkPVSession.h"
 #include "vtkPVXMLElement.h"
 #include "vtkPVXMLParser.h"
+#include "vtkProcessModule.h"
 #include "vtkReservedRemoteObjectIds.h"
 #include "vtkSmartPointer.h"
 #include "vtkSMMessage.h"
@@ -36,14 +39,17 @@
 #include "vtkTimerLog.h"
 
 #include <vtksys/DateStamp.h> // For date stamp
+#include <vtksys/ios/fstream>
 #include <vtksys/ios/sstream>
 #include <vtkstd/map>
 #include <vtksys/RegularExpression.hxx>
+#include <vtksys/SystemTools.hxx>
 #include <vtkstd/set>
 #include <vtkstd/string>
 #include <vtkstd/vector>
 
 #include <assert.h>
+#include <stdio.h>
 
 // this file must be included after vtkPVConfig etc. are included.
 #include "vtkSMGeneratedModules.h"
@@ -195,6 +201,233 @@ public:
     }
 
 };
+//****************************************************************************/
+//                        Definition cache
+//****************************************************************************/
+namespace
+{
+  // Bump when the layout of the definition streams changes.
+  const int DefinitionCacheFormat = 1;
+  const char* const DefinitionCacheMagic = "ParaViewProxyDefinitionCache";
+
+  // The cache file starts with the size and the hash of the stream, each
+  // stored as 8 little-endian bytes.
+  const size_t DefinitionCacheHeaderSize = 16;
+
+  //-------------------------------------------------------------------------
+  // 64-bit FNV-1a hash, enough to notice any change of the XML.
+  void HashBytes(vtkTypeUInt64& hash, const unsigned char* data, size_t size)
+    {
+    for (size_t cc=0; cc < size; cc++)
+      {
+      hash ^= data[cc];
+      hash *= 1099511628211ull;
+      }
+    }
+
+  //-------------------------------------------------------------------------
+  void HashString(vtkTypeUInt64& hash, const vtkstd::string& str)
+    {
+    // Include the length, so that concatenations cannot collide.
+    vtksys_ios::ostringstream length;
+    length << str.size() << ":";
+    vtkstd::string data = length.str() + str;
+    HashBytes(hash, reinterpret_cast<const unsigned char*>(data.c_str()),
+              data.size());
+    }
+
+  //-------------------------------------------------------------------------
+  vtkTypeUInt64 HashData(const vtkstd::vector<unsigned char>& data)
+    {
+    vtkTypeUInt64 hash = 14695981039346656037ull;
+    if (!data.empty())
+      {
+      HashBytes(hash, &data[0], data.size());
+      }
+    return hash;
+    }
+
+  //-------------------------------------------------------------------------
+  void EncodeUInt64(vtkTypeUInt64 value, unsigned char* bytes)
+    {
+    for (int cc=0; cc < 8; cc++)
+      {
+      bytes[cc] = static_cast<unsigned char>((value >> (8 * cc)) & 0xff);
+      }
+    }
+
+  //-------------------------------------------------------------------------
+  vtkTypeUInt64 DecodeUInt64(const unsigned char* bytes)
+    {
+    vtkTypeUInt64 value = 0;
+    for (int cc=7; cc >= 0; cc--)
+      {
+      value = (value << 8) | bytes[cc];
+      }
+    return value;
+    }
+
+  //-------------------------------------------------------------------------
+  void WriteElement(vtkMultiProcessStream& stream, vtkPVXMLElement* element)
+    {
+    stream << vtkstd::string(element->GetName()? element->GetName() : "")
+           << vtkstd::string(element->GetId()? element->GetId() : "")
+           << vtkstd::string(element->GetCharacterData());
+    unsigned int numAttributes = element->GetNumberOfAttributes();
+    stream << numAttributes;
+    for (unsigned int cc=0; cc < numAttributes; cc++)
+      {
+      stream << vtkstd::string(element->GetAttributeName(cc))
+             << vtkstd::string(element->GetAttributeValue(cc));
+      }
+    unsigned int numChildren = element->GetNumberOfNestedElements();
+    stream << numChildren;
+    for (unsigned int cc=0; cc < numChildren; cc++)
+      {
+      WriteElement(stream, element->GetNestedElement(cc));
+      }
+    }
+
+  //-------------------------------------------------------------------------
+  void ReadElement(vtkMultiProcessStream& stream, vtkPVXMLElement* element)
+    {
+    vtkstd::string name, id, data;
+    stream >> name >> id >> data;
+    element->SetName(name.empty()? NULL : name.c_str());
+    element->SetId(id.empty()? NULL : id.c_str());
+    element->AddCharacterData(data.c_str(), static_cast<int>(data.size()));
+    unsigned int numAttributes = 0;
+    stream >> numAttributes;
+    for (unsigned int cc=0; cc < numAttributes; cc++)
+      {
+      vtkstd::string attrName, attrValue;
+      stream >> attrName >> attrValue;
+      element->AddAttribute(attrName.c_str(), attrValue.c_str());
+      }
+    unsigned int numChildren = 0;
+    stream >> numChildren;
+    for (unsigned int cc=0; cc < numChildren; cc++)
+      {
+      vtkNew<vtkPVXMLElement> child;
+      ReadElement(stream, child.GetPointer());
+      element->AddNestedElement(child.GetPointer());
+      }
+    }
+
+  //-------------------------------------------------------------------------
+  void WriteDefinitions(vtkMultiProcessStream& stream,
+                        const StrToStrToXmlMap& definitions)
+    {
+    unsigned int count = 0;
+    StrToStrToXmlMap::const_iterator groupIter;
+    StrToXmlMap::const_iterator proxyIter;
+    for (groupIter = definitions.begin(); groupIter != definitions.end();
+         ++groupIter)
+      {
+      count += static_cast<unsigned int>(groupIter->second.size());
+      }
+    stream << count;
+    for (groupIter = definitions.begin(); groupIter != definitions.end();
+         ++groupIter)
+      {
+      for (proxyIter = groupIter->second.begin();
+           proxyIter != groupIter->second.end(); ++proxyIter)
+        {
+        stream << groupIter->first << proxyIter->first;
+        WriteElement(stream, proxyIter->second.GetPointer());
+        }
+      }
+    }
+
+  //-------------------------------------------------------------------------
+  void ReadDefinitions(vtkMultiProcessStream& stream,
+                       StrToStrToXmlMap& definitions)
+    {
+    unsigned int count = 0;
+    stream >> count;
+    for (unsigned int cc=0; cc < count; cc++)
+      {
+      vtkstd::string group, name;
+      stream >> group >> name;
+      XMLElement element = XMLElement::New();
+      ReadElement(stream, element);
+      definitions[group][name] = element;
+      }
+    }
+
+  //-------------------------------------------------------------------------
+  // The whole file is read at once, to keep the load of a parallel file
+  // system to a single request. vtkMultiProcessStream does not check what
+  // it extracts, so a file that was truncated or damaged is rejected here,
+  // before the stream is restored from it.
+  bool ReadCacheFile(const char* fileName, vtkstd::vector<unsigned char>& data)
+    {
+    vtksys_ios::ifstream file(fileName, ios::in | ios::binary);
+    if (!file)
+      {
+      return false;
+      }
+    file.seekg(0, ios::end);
+    vtkstd::streamoff size = file.tellg();
+    file.seekg(0, ios::beg);
+    if (size <= static_cast<vtkstd::streamoff>(DefinitionCacheHeaderSize))
+      {
+      return false;
+      }
+    unsigned char header[DefinitionCacheHeaderSize];
+    file.read(reinterpret_cast<char*>(header), DefinitionCacheHeaderSize);
+    size -= DefinitionCacheHeaderSize;
+    if (!file || DecodeUInt64(header) != static_cast<vtkTypeUInt64>(size))
+      {
+      return false;
+      }
+    data.resize(static_cast<size_t>(size));
+    file.read(reinterpret_cast<char*>(&data[0]), size);
+    return file.gcount() == size && HashData(data) == DecodeUInt64(header + 8);
+    }
+
+  //-------------------------------------------------------------------------
+  // The cache is written next to its final name and moved in place, so
+  // that processes starting at the same time never read half of it.
+  bool WriteCacheFile(const char* fileName,
+                      const vtkstd::vector<unsigned char>& data)
+    {
+    vtksys_ios::ostringstream tmpName;
+    tmpName << fileName << "." << static_cast<vtkTypeUInt64>(
+      vtksys::SystemTools::GetTime() * 1.0e6) << ".tmp";
+    vtksys_ios::ofstream file(tmpName.str().c_str(),
+                              ios::out | ios::binary | ios::trunc);
+    if (!file)
+      {
+      return false;
+      }
+    unsigned char header[DefinitionCacheHeaderSize];
+    EncodeUInt64(static_cast<vtkTypeUInt64>(data.size()), header);
+    EncodeUInt64(HashData(data), header + 8);
+    file.write(reinterpret_cast<const char*>(header), DefinitionCacheHeaderSize);
+    if (!data.empty())
+      {
+      file.write(reinterpret_cast<const char*>(&data[0]),
+                 static_cast<vtkstd::streamsize>(data.size()));
+      }
+    file.close();
+    if (!file)
+      {
+      remove(tmpName.str().c_str());
+      return false;
+      }
+#if defined(_WIN32)
+    remove(fileName);
+#endif
+    if (rename(tmpName.str().c_str(), fileName) != 0)
+      {
+      remove(tmpName.str().c_str());
+      return false;
+      }
+    return true;
+    }
+};
+
 //****************************************************************************/
 class vtkInternalDefinitionIterator : public vtkPVProxyDefinitionIterator
 {
@@ -452,8 +685,8 @@ vtkSIProxyDefinitionManager::vtkSIProxyDefinitionManager()
   this->Internals = new vtkInternals;
   this->InternalsFlatten = new vtkInternals;
 
-  // Load the generated modules
-# include "vtkParaViewIncludeModulesToSMApplication.h"
+  // Load the generated modules and any already loaded plugins.
+  this->LoadStartupDefinitions();
 
   // Now register with the plugin tracker, so that when new plugins are loaded,
   // we parse the XML if provided and automatically add it to the proxy
@@ -461,11 +694,6 @@ vtkSIProxyDefinitionManager::vtkSIProxyDefinitionManager()
   vtkPVPluginTracker* tracker = vtkPVPluginTracker::GetInstance();
   tracker->AddObserver( vtkCommand::RegisterEvent, this,
                         &vtkSIProxyDefinitionManager::OnPluginLoaded);
-  // process any already loaded plugins.
-  for (unsigned int cc=0; cc < tracker->GetNumberOfPlugins(); cc++)
-    {
-    this->HandlePlugin(tracker->GetPlugin(cc));
-    }
 }
 
 //---------------------------------------------------------------------------
@@ -475,6 +703,178 @@ vtkSIProxyDefinitionManager::~vtkSIProxyDefinitionManager()
   delete this->InternalsFlatten;
 }
 
+//---------------------------------------------------------------------------
+void vtkSIProxyDefinitionManager::LoadStartupDefinitions()
+{
+  vtkTimerLog::MarkStartEvent("vtkSIProxyDefinitionManager Load Startup Definitions");
+
+  // Creating the tracker may load plugins, which the processes of a server
+  // may do together, so all of them create it before anything else.
+  vtkPVPluginTracker* tracker = vtkPVPluginTracker::GetInstance();
+
+  // All the processes of a server create their session, and so this object,
+  // together at startup. The other applications may create it on the root
+  // process only.
+  vtkMultiProcessController* controller =
+    vtkMultiProcessController::GetGlobalController();
+  vtkProcessModule* pm = vtkProcessModule::GetProcessModule();
+  bool broadcast = controller && controller->GetNumberOfProcesses() > 1 &&
+    pm && (pm->GetProcessType() == vtkProcessModule::PROCESS_SERVER ||
+           pm->GetProcessType() == vtkProcessModule::PROCESS_DATA_SERVER ||
+           pm->GetProcessType() == vtkProcessModule::PROCESS_RENDER_SERVER);
+
+  if (broadcast && controller->GetLocalProcessId() > 0)
+    {
+    vtkMultiProcessStream stream;
+    controller->Broadcast(stream, 0);
+    if (!this->LoadDefinitions(stream, NULL))
+      {
+      vtkErrorMacro("Failed to receive the proxy definitions.");
+      }
+    this->InvokeEvent(vtkSIProxyDefinitionManager::ProxyDefinitionsUpdated);
+    vtkTimerLog::MarkEndEvent("vtkSIProxyDefinitionManager Load Startup Definitions");
+    return;
+    }
+
+  // XML of the generated modules, followed by the one of the server manager
+  // plugins already loaded.
+  vtkstd::vector<vtkstd::string> xmls;
+# include "vtkParaViewIncludeModulesToSMApplication.h"
+  size_t numberOfModuleXMLs = xmls.size();
+
+  vtkTypeUInt64 hash = 14695981039346656037ull;
+  vtksys_ios::ostringstream version;
+  version << DefinitionCacheFormat << " " << PARAVIEW_VERSION_FULL;
+  HashString(hash, version.str());
+  for (unsigned int cc=0; cc < tracker->GetNumberOfPlugins(); cc++)
+    {
+    vtkPVPlugin* plugin = tracker->GetPlugin(cc);
+    vtkPVServerManagerPluginInterface* smplugin =
+      dynamic_cast<vtkPVServerManagerPluginInterface*>(plugin);
+    if (smplugin)
+      {
+      HashString(hash, plugin->GetPluginName());
+      HashString(hash, plugin->GetPluginVersionString());
+      smplugin->GetXMLs(xmls);
+      }
+    }
+  for (size_t cc=0; cc < xmls.size(); cc++)
+    {
+    HashString(hash, xmls[cc]);
+    }
+  vtksys_ios::ostringstream key;
+  key << hex << hash;
+
+  const char* cacheName =
+    vtksys::SystemTools::GetEnv("PV_PROXY_DEFINITION_CACHE");
+  if (cacheName && !*cacheName)
+    {
+    cacheName = NULL;
+    }
+  vtkstd::vector<unsigned char> data;
+  bool loaded = false;
+  if (cacheName && ReadCacheFile(cacheName, data))
+    {
+    vtkMultiProcessStream stream;
+    stream.SetRawData(data);
+    loaded = this->LoadDefinitions(stream, key.str().c_str());
+    if (!loaded)
+      {
+      this->Internals->Clear();
+      this->InternalsFlatten->Clear();
+      }
+    }
+
+  if (loaded)
+    {
+    this->InvokeEvent(vtkSIProxyDefinitionManager::ProxyDefinitionsUpdated);
+    }
+  else
+    {
+    for (size_t cc=0; cc < xmls.size(); cc++)
+      {
+      // Legacy plugins don't have the hints the menus expect.
+      this->LoadConfigurationXMLFromString(xmls[cc].c_str(),
+        cc >= numberOfModuleXMLs);
+      }
+    if (cacheName || broadcast)
+      {
+      this->CollapseDefinitions();
+      vtkMultiProcessStream stream;
+      this->SaveDefinitions(stream, key.str().c_str());
+      stream.GetRawData(data);
+      if (cacheName && !WriteCacheFile(cacheName, data))
+        {
+        vtkWarningMacro("Failed to write the proxy definition cache "
+                        << cacheName);
+        }
+      }
+    }
+
+  if (broadcast)
+    {
+    vtkMultiProcessStream stream;
+    stream.SetRawData(data);
+    controller->Broadcast(stream, 0);
+    }
+  vtkTimerLog::MarkEndEvent("vtkSIProxyDefinitionManager Load Startup Definitions");
+}
+
+//---------------------------------------------------------------------------
+void vtkSIProxyDefinitionManager::SaveDefinitions(vtkMultiProcessStream& stream,
+                                                  const char* key)
+{
+  stream << vtkstd::string(DefinitionCacheMagic) << DefinitionCacheFormat
+         << vtkstd::string(key? key : "");
+  WriteDefinitions(stream, this->Internals->CoreDefinitions);
+  WriteDefinitions(stream, this->InternalsFlatten->CoreDefinitions);
+}
+
+//---------------------------------------------------------------------------
+bool vtkSIProxyDefinitionManager::LoadDefinitions(vtkMultiProcessStream& stream,
+                                                  const char* key)
+{
+  if (stream.Empty())
+    {
+    return false;
+    }
+  vtkstd::string magic, streamKey;
+  int format = 0;
+  stream >> magic;
+  if (magic != DefinitionCacheMagic)
+    {
+    return false;
+    }
+  stream >> format >> streamKey;
+  if (format != DefinitionCacheFormat || (key && streamKey != key))
+    {
+    return false;
+    }
+  ReadDefinitions(stream, this->Internals->CoreDefinitions);
+  ReadDefinitions(stream, this->InternalsFlatten->CoreDefinitions);
+  return true;
+}
+
+//---------------------------------------------------------------------------
+void vtkSIProxyDefinitionManager::CollapseDefinitions()
+{
+  StrToStrToXmlMap::iterator groupIter;
+  StrToXmlMap::iterator proxyIter;
+  for (groupIter = this->Internals->CoreDefinitions.begin();
+       groupIter != this->Internals->CoreDefinitions.end(); ++groupIter)
+    {
+    for (proxyIter = groupIter->second.begin();
+         proxyIter != groupIter->second.end(); ++proxyIter)
+      {
+      if (proxyIter->second->GetAttribute("base_proxygroup"))
+        {
+        this->GetCollapsedProxyDefinition(groupIter->first.c_str(),
+          proxyIter->first.c_str(), NULL, false);
+        }
+      }
+    }
+}
+
 //----------------------------------------------------------------------------
 void vtkSIProxyDefinitionManager::InvokeCustomDefitionsUpdated()
 {
@@ -952,10 +1352,13 @@ vtkPVXMLElement* vtkSIProxyDefinitionManager::GetCollapsedProxyDefinition(
           originalDefinition = this->GetProxyDefinition( base_group.c_str(),
                                                          base_name.c_str(),
                                                          throwError);
-          base_group =
-              originalDefinition->GetAttributeOrEmpty("base_proxygroup");
-          base_name  =
-              originalDefinition->GetAttributeOrEmpty("base_proxyname");
+          if (originalDefinition)
+            {
+            base_group =
+                originalDefinition->GetAttributeOrEmpty("base_proxygroup");
+            base_name  =
+                originalDefinition->GetAttributeOrEmpty("base_proxyname");
+            }
           }
         else
           {
@@ -35,12 +35,22 @@
 // \li \c vtkCommand::UnRegisterEvent - Fired when a proxy definition is
 // removed. Since this class only support removing custom proxies, this event is
 // fired only when a custom proxy is removed.
+//
+// The definitions of the built-in modules and of the server manager plugins
+// loaded before this object is created are read at construction. When the
+// PV_PROXY_DEFINITION_CACHE environment variable names a file, they are
+// read from this binary cache instead, with the definitions inheriting from
+// other ones already collapsed. The cache is rewritten whenever the XML or
+// the plugins it was built from change, or when it cannot be read entirely.
+// On a parallel server, only the root process parses the definitions or
+// reads the cache, and broadcasts them to the other processes.
 
 #ifndef __vtkSIProxyDefinitionManager_h
 #define __vtkSIProxyDefinitionManager_h
 
 #include "vtkSIObject.h"
 
+class vtkMultiProcessStream;
 class vtkPVPlugin;
 class vtkPVProxyDefinitionIterator;
 class vtkPVXMLElement;
@@ -231,6 +241,25 @@ protected:
   bool LoadConfigurationXML(vtkPVXMLElement* root, bool attachShowInMenuHints);
   bool LoadConfigurationXMLFromString(const char* xmlContent, bool attachShowInMenuHints);
 
+  // Description:
+  // Load the definitions of the built-in modules and of the server manager
+  // plugins already loaded, from the XML, the definition cache or the root
+  // process. Called at construction.
+  void LoadStartupDefinitions();
+
+  // Description:
+  // Save the core definitions and their collapsed version in a stream
+  // tagged with the given key, or restore them from a stream. When key is
+  // not NULL, a stream with another key is not restored and false is
+  // returned.
+  void SaveDefinitions(vtkMultiProcessStream& stream, const char* key);
+  bool LoadDefinitions(vtkMultiProcessStream& stream, const char* key);
+
+  // Description:
+  // Collapse all the core definitions inheriting from another one, so that
+  // GetCollapsedProxyDefinition() no longer has to merge them.
+  void CollapseDefinitions();
+
   // Description:
   // Callback called when a plugin is loaded.
   void OnPluginLoaded(vtkObject* caller, unsigned long event, void* calldata);
@@ -0,0 +1,248 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestSessionClientTransaction.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Pushes state with vtkSMSessionClient, inside and outside of transactions,
+// to a data server that only records the RMIs it receives, and checks that:
+//  - state pushed outside of a transaction is sent right away,
+//  - state pushed during a transaction is sent in a single PUSH_TRANSACTION
+//    RMI, in order, when the outermost transaction ends,
+//  - executing a stream or deleting an object during a transaction sends
+//    the state pushed before it first,
+//  - a transaction that pushed nothing sends nothing.
+// Process 0 is the client and process 1 the data server. Run it on 2 MPI
+// processes.
+
+#include "vtkClientServerStream.h"
+#include "vtkMPIController.h"
+#include "vtkMultiProcessStream.h"
+#include "vtkPVSession.h"
+#include "vtkPVSessionServer.h"
+#include "vtkSMMessage.h"
+#include "vtkSMSessionClient.h"
+#include "vtkSmartPointer.h"
+
+#include <vtksys/ios/sstream>
+#include <vtkstd/string>
+#include <vtkstd/vector>
+
+namespace
+{
+  // Gives the client a controller to the data server.
+  class TestSessionClient : public vtkSMSessionClient
+  {
+  public:
+    static TestSessionClient* New() { return new TestSessionClient; }
+    void SetController(vtkMultiProcessController* controller)
+    {
+      this->SetDataServerController(controller);
+    }
+  };
+
+  // What the data server received, one line per RMI.
+  struct ServerLog
+  {
+    vtkMultiProcessController* Controller;
+    vtkstd::vector<vtkstd::string> Lines;
+  };
+
+  vtkstd::string GlobalId(const vtkstd::string& serialized)
+  {
+    vtkSMMessage msg;
+    msg.ParseFromString(serialized);
+    vtksys_ios::ostringstream id;
+    id << msg.global_id();
+    return id.str();
+  }
+
+  // Decode the RMIs the way vtkPVSessionServer does.
+  void RecordMessage(void* localArg, void* remoteArg, int remoteArgLength,
+                     int remoteProcessId)
+  {
+    ServerLog* log = static_cast<ServerLog*>(localArg);
+    vtkMultiProcessStream stream;
+    stream.SetRawData(reinterpret_cast<const unsigned char*>(remoteArg),
+                      remoteArgLength);
+    int type;
+    stream >> type;
+    vtkstd::string line;
+    vtkstd::string serialized;
+    switch (type)
+      {
+    case vtkPVSessionServer::PUSH:
+      stream >> serialized;
+      line = "PUSH " + GlobalId(serialized);
+      break;
+
+    case vtkPVSessionServer::PUSH_TRANSACTION:
+        {
+        int count;
+        stream >> count;
+        line = "PUSH_TRANSACTION";
+        for (int cc=0; cc < count; cc++)
+          {
+          stream >> serialized;
+          line += " " + GlobalId(serialized);
+          }
+        }
+      break;
+
+    case vtkPVSessionServer::EXECUTE_STREAM:
+        {
+        int ignore_errors, size;
+        stream >> ignore_errors >> size;
+        vtkstd::vector<unsigned char> data(size > 0 ? size : 1);
+        log->Controller->Receive(&data[0], size, remoteProcessId,
+          vtkPVSessionServer::EXECUTE_STREAM_TAG);
+        line = "EXECUTE_STREAM";
+        }
+      break;
+
+    case vtkPVSessionServer::DELETE_SI:
+      stream >> serialized;
+      line = "DELETE_SI " + GlobalId(serialized);
+      break;
+
+    default:
+      line = "UNEXPECTED";
+      }
+    log->Lines.push_back(line);
+  }
+
+  void Push(vtkSMSession* session, vtkTypeUInt32 globalId)
+  {
+    vtkSMMessage msg;
+    msg.set_global_id(globalId);
+    msg.set_location(vtkPVSession::DATA_SERVER);
+    session->PushState(&msg);
+  }
+
+  bool CheckTransaction(const char* name, vtkSMSessionClient* session,
+                        int numberOfMessages)
+  {
+    if (session->GetLastTransactionNumberOfMessages() != numberOfMessages ||
+        session->GetLastTransactionNumberOfBytes() <= 0)
+      {
+      cerr << "The last transaction sent "
+           << session->GetLastTransactionNumberOfMessages()
+           << " messages in " << session->GetLastTransactionNumberOfBytes()
+           << " bytes " << name << ", expected " << numberOfMessages
+           << " messages" << endl;
+      return false;
+      }
+    return true;
+  }
+
+  bool RunClient(vtkMultiProcessController* controller)
+  {
+    vtkSmartPointer<TestSessionClient> session =
+      vtkSmartPointer<TestSessionClient>::New();
+    session->SetController(controller);
+
+    Push(session, 11);
+
+    session->StartTransaction();
+    Push(session, 12);
+    Push(session, 13);
+    session->StartTransaction();
+    Push(session, 14);
+    session->EndTransaction();
+
+    vtkClientServerStream stream;
+    stream << vtkClientServerStream::Invoke
+           << vtkClientServerID(1) << "GetClassName"
+           << vtkClientServerStream::End;
+    session->ExecuteStream(vtkPVSession::DATA_SERVER, stream);
+    bool ok = CheckTransaction("before the stream", session, 3);
+
+    Push(session, 15);
+    vtkSMMessage deleted;
+    deleted.set_global_id(12);
+    deleted.set_location(vtkPVSession::DATA_SERVER);
+    session->DeleteSIObject(&deleted);
+    ok = CheckTransaction("before the deletion", session, 1) && ok;
+
+    Push(session, 16);
+    Push(session, 17);
+    session->EndTransaction();
+    ok = CheckTransaction("when it ended", session, 2) && ok;
+
+    session->StartTransaction();
+    session->EndTransaction();
+    ok = CheckTransaction("after an empty transaction", session, 2) && ok;
+
+    // Not connected to a socket, nothing to close.
+    session->SetController(0);
+    controller->TriggerBreakRMIs();
+    return ok;
+  }
+
+  bool RunServer(vtkMultiProcessController* controller)
+  {
+    ServerLog log;
+    log.Controller = controller;
+    controller->AddRMI(RecordMessage, &log,
+      vtkPVSessionServer::CLIENT_SERVER_MESSAGE_RMI);
+    controller->ProcessRMIs();
+
+    const char* expected[] = {
+      "PUSH 11",
+      "PUSH_TRANSACTION 12 13 14",
+      "EXECUTE_STREAM",
+      "PUSH_TRANSACTION 15",
+      "DELETE_SI 12",
+      "PUSH_TRANSACTION 16 17"
+    };
+    size_t numberOfLines = sizeof(expected) / sizeof(expected[0]);
+    bool ok = log.Lines.size() == numberOfLines;
+    for (size_t i = 0; ok && i < numberOfLines; i++)
+      {
+      ok = log.Lines[i] == expected[i];
+      }
+    if (!ok)
+      {
+      cerr << "The data server received:" << endl;
+      for (size_t i = 0; i < log.Lines.size(); i++)
+        {
+        cerr << "  " << log.Lines[i].c_str() << endl;
+        }
+      }
+    return ok;
+  }
+}
+
+int main(int argc, char* argv[])
+{
+  vtkMPIController* controller = vtkMPIController::New();
+  controller->Initialize(&argc, &argv);
+  vtkMultiProcessController::SetGlobalController(controller);
+
+  int status = 0;
+  if (controller->GetNumberOfProcesses() != 2)
+    {
+    cerr << "Run this test on 2 processes" << endl;
+    }
+  else
+    {
+    bool ok = controller->GetLocalProcessId() == 0 ?
+      RunClient(controller) : RunServer(controller);
+    int localStatus = ok ? 1 : 0;
+    controller->AllReduce(&localStatus, &status, 1,
+                          vtkCommunicator::MIN_OP);
+    }
+
+  vtkMultiProcessController::SetGlobalController(0);
+  controller->Finalize();
+  controller->Delete();
+  return status ? 0 : 1;
+}
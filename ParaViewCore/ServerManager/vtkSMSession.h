@@ -128,6 +128,15 @@ public:
   virtual void PushState(vtkSMMessage* msg);
 //ETX
 
+  // Description:
+  // State pushed between StartTransaction() and EndTransaction() may be sent
+  // to the servers together, in order. Transactions can be nested: the state
+  // is sent when the outermost one ends, or earlier when anything else has to
+  // be sent to or requested from the servers. The default implementation does
+  // nothing since all the state is applied locally.
+  virtual void StartTransaction() {}
+  virtual void EndTransaction() {}
+
 
   //---------------------------------------------------------------------------
   // Static methods to create and register sessions easily.
@@ -32,11 +32,23 @@
 #include "vtkSocketCommunicator.h"
 
 #include <vtkstd/string>
+#include <vtkstd/vector>
 #include <vtksys/ios/sstream>
 #include <vtksys/RegularExpression.hxx>
 
 #include <assert.h>
 
+// Messages pushed during a transaction, serialized, for each server.
+class vtkSMSessionClient::vtkTransaction
+{
+public:
+  vtkTransaction() : Depth(0) {}
+
+  int Depth;
+  vtkstd::vector<vtkstd::string> DataServerMessages;
+  vtkstd::vector<vtkstd::string> RenderServerMessages;
+};
+
 vtkStandardNewMacro(vtkSMSessionClient);
 vtkCxxSetObjectMacro(vtkSMSessionClient, RenderServerController,
   vtkMultiProcessController);
@@ -56,6 +68,9 @@ vtkSMSessionClient::vtkSMSessionClient()
   this->RenderServerInformation = vtkPVServerInformation::New();
   this->ServerInformation = vtkPVServerInformation::New();
   this->ServerLastInvokeResult = new vtkClientServerStream();
+  this->Transaction = new vtkTransaction();
+  this->LastTransactionNumberOfMessages = 0;
+  this->LastTransactionNumberOfBytes = 0;
 }
 
 //----------------------------------------------------------------------------
@@ -65,6 +80,7 @@ vtkSMSessionClient::~vtkSMSessionClient()
     {
     this->CloseSession();
     }
+  delete this->Transaction;
   this->SetRenderServerController(0);
   this->SetDataServerController(0);
   this->DataServerInformation->Delete();
@@ -356,6 +372,7 @@ int vtkSMSessionClient::GetNumberOfProcesses(vtkTypeUInt32 servers)
 //----------------------------------------------------------------------------
 void vtkSMSessionClient::CloseSession()
 {
+  this->FlushTransaction();
   if (this->DataServerController)
     {
     this->DataServerController->TriggerRMIOnAllChildren(
@@ -412,7 +429,23 @@ void vtkSMSessionClient::PushState(vtkSMMessage* message)
     {
     controllers[num_controllers++] = this->RenderServerController;
     }
-  if (num_controllers > 0)
+  if (num_controllers > 0 && this->Transaction->Depth > 0)
+    {
+    // Sent when the transaction ends.
+    vtkstd::string serialized = message->SerializeAsString();
+    for (int cc=0; cc < num_controllers; cc++)
+      {
+      if (controllers[cc] == this->DataServerController)
+        {
+        this->Transaction->DataServerMessages.push_back(serialized);
+        }
+      else
+        {
+        this->Transaction->RenderServerMessages.push_back(serialized);
+        }
+      }
+    }
+  else if (num_controllers > 0)
     {
     vtkMultiProcessStream stream;
     stream << static_cast<int>(vtkPVSessionServer::PUSH);
@@ -442,6 +475,7 @@ void vtkSMSessionClient::PushState(vtkSMMessage* message)
 //----------------------------------------------------------------------------
 void vtkSMSessionClient::PullState(vtkSMMessage* message)
 {
+  this->FlushTransaction();
   vtkTypeUInt32 location = this->GetRealLocation(message->location());
   message->set_location(location);
 
@@ -494,6 +528,7 @@ void vtkSMSessionClient::ExecuteStream(
   vtkTypeUInt32 location, const vtkClientServerStream& cssstream,
   bool ignore_errors)
 {
+  this->FlushTransaction();
   location = this->GetRealLocation(location);
 
   vtkMultiProcessController* controllers[2] = {NULL, NULL};
@@ -540,6 +575,7 @@ void vtkSMSessionClient::ExecuteStream(
 //----------------------------------------------------------------------------
 const vtkClientServerStream& vtkSMSessionClient::GetLastResult(vtkTypeUInt32 location)
 {
+  this->FlushTransaction();
   location = this->GetRealLocation(location);
 
   vtkMultiProcessController* controller = NULL;
@@ -587,6 +623,7 @@ const vtkClientServerStream& vtkSMSessionClient::GetLastResult(vtkTypeUInt32 loc
 bool vtkSMSessionClient::GatherInformation(
   vtkTypeUInt32 location, vtkPVInformation* information, vtkTypeUInt32 globalid)
 {
+  this->FlushTransaction();
   if (this->RenderServerController == NULL)
     {
     // re-route all render-server messages to data-server.
@@ -669,6 +706,7 @@ bool vtkSMSessionClient::GatherInformation(
 //----------------------------------------------------------------------------
 void vtkSMSessionClient::DeleteSIObject(vtkSMMessage* message)
 {
+  this->FlushTransaction();
   vtkTypeUInt32 location = this->GetRealLocation(message->location());
   message->set_location(location);
 
@@ -705,8 +743,79 @@ void vtkSMSessionClient::DeleteSIObject(vtkSMMessage* message)
     }
 }
 
+//----------------------------------------------------------------------------
+void vtkSMSessionClient::StartTransaction()
+{
+  this->Transaction->Depth++;
+}
+
+//----------------------------------------------------------------------------
+void vtkSMSessionClient::EndTransaction()
+{
+  if (this->Transaction->Depth == 0)
+    {
+    vtkErrorMacro("EndTransaction() called without StartTransaction().");
+    return;
+    }
+  this->Transaction->Depth--;
+  if (this->Transaction->Depth == 0)
+    {
+    this->FlushTransaction();
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkSMSessionClient::FlushTransaction()
+{
+  vtkMultiProcessController* controllers[2] = {
+    this->DataServerController, this->RenderServerController };
+  vtkstd::vector<vtkstd::string>* messages[2] = {
+    &this->Transaction->DataServerMessages,
+    &this->Transaction->RenderServerMessages };
+  if (messages[0]->empty() && messages[1]->empty())
+    {
+    return;
+    }
+
+  this->LastTransactionNumberOfMessages = 0;
+  this->LastTransactionNumberOfBytes = 0;
+  for (int cc=0; cc < 2; cc++)
+    {
+    if (messages[cc]->empty())
+      {
+      continue;
+      }
+    if (controllers[cc])
+      {
+      // The server applies the messages in the order they were pushed.
+      vtkMultiProcessStream stream;
+      stream << static_cast<int>(vtkPVSessionServer::PUSH_TRANSACTION)
+             << static_cast<int>(messages[cc]->size());
+      for (size_t kk=0; kk < messages[cc]->size(); kk++)
+        {
+        stream << (*messages[cc])[kk];
+        }
+      vtkstd::vector<unsigned char> raw_message;
+      stream.GetRawData(raw_message);
+      controllers[cc]->TriggerRMIOnAllChildren(
+        &raw_message[0], static_cast<int>(raw_message.size()),
+        vtkPVSessionServer::CLIENT_SERVER_MESSAGE_RMI);
+
+      this->LastTransactionNumberOfMessages +=
+        static_cast<int>(messages[cc]->size());
+      this->LastTransactionNumberOfBytes +=
+        static_cast<vtkIdType>(raw_message.size());
+      }
+    messages[cc]->clear();
+    }
+}
+
 //----------------------------------------------------------------------------
 void vtkSMSessionClient::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os, indent);
+  os << indent << "LastTransactionNumberOfMessages: "
+     << this->LastTransactionNumberOfMessages << endl;
+  os << indent << "LastTransactionNumberOfBytes: "
+     << this->LastTransactionNumberOfBytes << endl;
 }
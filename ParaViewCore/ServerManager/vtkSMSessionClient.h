@@ -94,6 +94,19 @@ public:
   virtual const vtkClientServerStream& GetLastResult(vtkTypeUInt32 location);
 //ETX
 
+  // Description:
+  // Overridden to collect the messages pushed to each server during a
+  // transaction and send them as a single RMI per server.
+  virtual void StartTransaction();
+  virtual void EndTransaction();
+
+  // Description:
+  // Number of messages and of bytes sent to the servers by the last
+  // transaction that pushed any state. A message sent to both the data and
+  // the render server counts once per server.
+  vtkGetMacro(LastTransactionNumberOfMessages, int);
+  vtkGetMacro(LastTransactionNumberOfBytes, vtkIdType);
+
   // Description:
   // When Connect() is waiting for a server to connect back to the client (in
   // reverse connect mode), then it periodically fires ProgressEvent.
@@ -139,6 +152,12 @@ protected:
   // render-server exists.
   vtkTypeUInt32 GetRealLocation(vtkTypeUInt32);
 
+  // Description:
+  // Send the state pushed during the current transaction, if any. Called
+  // before anything else is sent to the servers so they see the messages in
+  // the order they were pushed.
+  void FlushTransaction();
+
   // Both maybe the same when connected to pvserver.
   vtkMultiProcessController* RenderServerController;
   vtkMultiProcessController* DataServerController;
@@ -152,9 +171,15 @@ protected:
 
   bool AbortConnect;
   char* URI;
+
+  int LastTransactionNumberOfMessages;
+  vtkIdType LastTransactionNumberOfBytes;
 private:
   vtkSMSessionClient(const vtkSMSessionClient&); // Not implemented
   void operator=(const vtkSMSessionClient&); // Not implemented
+
+  class vtkTransaction;
+  vtkTransaction* Transaction;
 //ETX
 };
 
@@ -28,7 +28,10 @@
 #include "vtkAttributeDataToTableFilter.h"
 #include "vtkTable.h"
 #include "vtkFloatArray.h"
+#include "vtkIdTypeArray.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
+
+#include <vtkstd/vector>
 /*
 ** This test only builds if MPI is in use
 */
@@ -36,6 +39,95 @@
 
 #include "vtkProcess.h"
 
+// Sort a table made of a few values repeated on every process, block by
+// block, and check on process 0 that every row comes exactly once and in
+// order.
+static bool TestEqualValues(vtkMultiProcessController* controller,
+                            bool invertOrder)
+{
+  const vtkIdType nbLocalRows = 1000;
+  const vtkIdType blockSize = 64;
+  int me = controller->GetLocalProcessId();
+  int nbProc = controller->GetNumberOfProcesses();
+
+  vtkFloatArray* values = vtkFloatArray::New();
+  values->SetName("Value");
+  vtkIdTypeArray* ids = vtkIdTypeArray::New();
+  ids->SetName("Id");
+  for(vtkIdType i=0; i < nbLocalRows; i++)
+    {
+    values->InsertNextValue(static_cast<float>((i * 7 + me) % 3));
+    ids->InsertNextValue(me * nbLocalRows + i);
+    }
+  vtkTable* table = vtkTable::New();
+  table->AddColumn(values);
+  table->AddColumn(ids);
+  values->Delete();
+  ids->Delete();
+
+  vtkSortedTableStreamer* sortFilter = vtkSortedTableStreamer::New();
+  sortFilter->SetInput(table);
+  sortFilter->SetColumnNameToSort("Value");
+  sortFilter->SetSelectedComponent(0);
+  sortFilter->SetInvertOrder(invertOrder ? 1 : 0);
+  sortFilter->SetBlockSize(blockSize);
+
+  vtkIdType nbRows = nbLocalRows * nbProc;
+  vtkIdType nbBlocks = (nbRows + blockSize - 1) / blockSize;
+  vtkstd::vector<int> seen(nbRows, 0);
+  bool ok = true;
+  double previous = invertOrder ? VTK_DOUBLE_MAX : -VTK_DOUBLE_MAX;
+  for(vtkIdType block=0; block < nbBlocks; block++)
+    {
+    sortFilter->SetBlock(block);
+    sortFilter->Update();
+    if(me != 0)
+      {
+      continue;
+      }
+    vtkTable* output = sortFilter->GetOutput();
+    vtkFloatArray* sortedValues =
+      vtkFloatArray::SafeDownCast(output->GetColumnByName("Value"));
+    vtkIdTypeArray* sortedIds =
+      vtkIdTypeArray::SafeDownCast(output->GetColumnByName("Id"));
+    vtkIdType expected = (block + 1 < nbBlocks) ? blockSize :
+      nbRows - block * blockSize;
+    if(!sortedValues || !sortedIds ||
+       sortedValues->GetNumberOfTuples() != expected)
+      {
+      cout << "Block " << block << " does not have " << expected << " rows"
+           << endl;
+      ok = false;
+      continue;
+      }
+    for(vtkIdType i=0; i < expected; i++)
+      {
+      double value = sortedValues->GetValue(i);
+      if(invertOrder ? value > previous : value < previous)
+        {
+        cout << "Row " << i << " of block " << block << " is out of order"
+             << endl;
+        ok = false;
+        }
+      previous = value;
+      seen[sortedIds->GetValue(i)]++;
+      }
+    }
+  for(vtkIdType i=0; me == 0 && i < nbRows; i++)
+    {
+    if(seen[i] != 1)
+      {
+      cout << "Row " << i << " was found " << seen[i] << " times" << endl;
+      ok = false;
+      break;
+      }
+    }
+
+  sortFilter->Delete();
+  table->Delete();
+  return ok;
+}
+
 class MyProcess : public vtkProcess
 {
 public:
@@ -128,6 +220,17 @@ void MyProcess::Execute()
       }
     }
 
+  // Equal values that span several blocks and processes
+  if(!TestEqualValues(this->Controller, false) ||
+     !TestEqualValues(this->Controller, true))
+    {
+    this->ReturnValue = 0;
+    }
+  else if(me == 0)
+    {
+    cout << "Blocks of equal values OK" << endl;
+    }
+
   // CLEAN UP
   wavelet->Delete();
   ps->Delete();
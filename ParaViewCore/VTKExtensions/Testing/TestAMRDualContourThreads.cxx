@@ -0,0 +1,159 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestAMRDualContourThreads.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Contours a material of a CTH data set with vtkAMRDualContour on one
+// thread and on several, with points merged, and checks that the surfaces
+// have the same points, in the same order, and the same polygons.
+
+#include "vtkAMRDualContour.h"
+#include "vtkCellArray.h"
+#include "vtkDataObject.h"
+#include "vtkDummyController.h"
+#include "vtkMultiBlockDataSet.h"
+#include "vtkMultiPieceDataSet.h"
+#include "vtkMultiThreader.h"
+#include "vtkPolyData.h"
+#include "vtkSmartPointer.h"
+#include "vtkSpyPlotReader.h"
+#include "vtkTestUtilities.h"
+
+#define MATERIAL "Material volume fraction - 3"
+
+namespace
+{
+  // Contour the input on the given number of threads.
+  vtkSmartPointer<vtkPolyData> Contour(vtkDataObject* input,
+                                       int numberOfThreads)
+  {
+    vtkMultiThreader::SetGlobalMaximumNumberOfThreads(numberOfThreads);
+    vtkMultiThreader::SetGlobalDefaultNumberOfThreads(numberOfThreads);
+
+    vtkSmartPointer<vtkAMRDualContour> filter =
+      vtkSmartPointer<vtkAMRDualContour>::New();
+    filter->SetInput(input);
+    filter->SetInputArrayToProcess(0, 0, 0,
+      vtkDataObject::FIELD_ASSOCIATION_CELLS, MATERIAL);
+    // The volume fractions are down converted to unsigned char.
+    filter->SetIsoValue(0.5 * 255);
+    filter->EnableMergePointsOn();
+    filter->Update();
+
+    vtkMultiBlockDataSet* output =
+      vtkMultiBlockDataSet::SafeDownCast(filter->GetOutputDataObject(0));
+    vtkMultiPieceDataSet* pieces = output ?
+      vtkMultiPieceDataSet::SafeDownCast(output->GetBlock(0)) : 0;
+    vtkPolyData* mesh = pieces ?
+      vtkPolyData::SafeDownCast(pieces->GetPiece(0)) : 0;
+    vtkSmartPointer<vtkPolyData> surface = vtkSmartPointer<vtkPolyData>::New();
+    if (mesh)
+      {
+      surface->ShallowCopy(mesh);
+      }
+    return surface;
+  }
+
+  bool Compare(int numberOfThreads, vtkPolyData* expected,
+               vtkPolyData* actual)
+  {
+    if (expected->GetNumberOfPoints() != actual->GetNumberOfPoints() ||
+        expected->GetNumberOfPolys() != actual->GetNumberOfPolys())
+      {
+      cerr << actual->GetNumberOfPoints() << " points and "
+           << actual->GetNumberOfPolys() << " polygons on " << numberOfThreads
+           << " threads instead of " << expected->GetNumberOfPoints()
+           << " and " << expected->GetNumberOfPolys() << endl;
+      return false;
+      }
+    // The threads compute the same points as one thread, the values have to
+    // be the same.
+    for (vtkIdType i = 0; i < expected->GetNumberOfPoints(); i++)
+      {
+      double x1[3], x2[3];
+      expected->GetPoint(i, x1);
+      actual->GetPoint(i, x2);
+      if (x1[0] != x2[0] || x1[1] != x2[1] || x1[2] != x2[2])
+        {
+        cerr << "Point " << i << " moved on " << numberOfThreads
+             << " threads" << endl;
+        return false;
+        }
+      }
+    vtkCellArray* polys1 = expected->GetPolys();
+    vtkCellArray* polys2 = actual->GetPolys();
+    vtkIdType npts1, npts2;
+    vtkIdType *pts1, *pts2;
+    vtkIdType cellId = 0;
+    polys1->InitTraversal();
+    polys2->InitTraversal();
+    while (polys1->GetNextCell(npts1, pts1) &&
+           polys2->GetNextCell(npts2, pts2))
+      {
+      bool same = npts1 == npts2;
+      for (vtkIdType j = 0; same && j < npts1; j++)
+        {
+        same = pts1[j] == pts2[j];
+        }
+      if (!same)
+        {
+        cerr << "Polygon " << cellId << " changed on " << numberOfThreads
+             << " threads" << endl;
+        return false;
+        }
+      ++cellId;
+      }
+    return true;
+  }
+}
+
+int main(int argc, char* argv[])
+{
+  char* fname = vtkTestUtilities::ExpandDataFileName(
+    argc, argv, "Data/SPCTH/Dave_Karelitz_Small/spcth.0");
+
+  vtkSmartPointer<vtkDummyController> controller =
+    vtkSmartPointer<vtkDummyController>::New();
+  vtkMultiProcessController::SetGlobalController(controller);
+
+  vtkSmartPointer<vtkSpyPlotReader> reader =
+    vtkSmartPointer<vtkSpyPlotReader>::New();
+  reader->SetFileName(fname);
+  reader->SetGlobalController(controller);
+  reader->MergeXYZComponentsOn();
+  reader->DownConvertVolumeFractionOn();
+  reader->DistributeFilesOn();
+  reader->SetCellArrayStatus(MATERIAL, 1);
+  reader->Update();
+  delete [] fname;
+
+  vtkDataObject* input = reader->GetOutputDataObject(0);
+  vtkSmartPointer<vtkPolyData> expected = Contour(input, 1);
+  if (expected->GetNumberOfPolys() == 0)
+    {
+    cerr << "The contour is empty" << endl;
+    return 1;
+    }
+
+  // An odd number of threads splits the blocks unevenly.
+  bool ok = true;
+  int numbersOfThreads[] = { 2, 3, 8 };
+  for (int i = 0; i < 3; i++)
+    {
+    vtkSmartPointer<vtkPolyData> actual = Contour(input, numbersOfThreads[i]);
+    ok = Compare(numbersOfThreads[i], expected, actual) && ok;
+    }
+
+  vtkMultiThreader::SetGlobalDefaultNumberOfThreads(0);
+  vtkMultiProcessController::SetGlobalController(0);
+  return ok ? 0 : 1;
+}
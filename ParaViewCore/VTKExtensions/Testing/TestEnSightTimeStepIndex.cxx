@@ -0,0 +1,129 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestEnSightTimeStepIndex.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Records time step offsets of a binary EnSight file without FILE_INDEX
+// with vtkPEnSightGoldBinaryReader and checks that:
+//  - by default no .vtkindex file is written next to the data,
+//  - with SaveTimeStepOffsets on, it is written, and another reader finds
+//    the offsets in it without scanning the file.
+
+#include "vtkPEnSightGoldBinaryReader.h"
+#include "vtkSmartPointer.h"
+#include "vtkTestUtilities.h"
+
+#include <vtksys/SystemTools.hxx>
+#include <vtksys/ios/fstream>
+#include <vtkstd/string>
+
+#include <string.h>
+
+namespace
+{
+  // Gives access to the time step index of the reader.
+  class IndexReader : public vtkPEnSightGoldBinaryReader
+  {
+  public:
+    typedef vtkPEnSightGoldBinaryReader Superclass;
+    static IndexReader* New() { return new IndexReader; }
+
+    // Open the file and find the nearest known time step.
+    int Seek(const char* fileName, int timeStep)
+    {
+      if (!this->OpenFile(fileName))
+        {
+        return -1;
+        }
+      return this->SeekToNearestTimeStep(fileName, timeStep);
+    }
+
+    // Record an offset found while scanning, as the readers do.
+    void Found(const char* fileName, int timeStep, long offset)
+    {
+      this->AddTimeStepOffset(fileName, timeStep, offset);
+      this->SaveTimeStepIndex(fileName);
+    }
+
+    vtkstd::string IndexFileName()
+    {
+      return this->GetTimeStepIndexFileName();
+    }
+  };
+}
+
+int main(int argc, char* argv[])
+{
+  char* tempDir = vtkTestUtilities::GetArgOrEnvOrDefault(
+    "-T", argc, argv, "VTK_TEMP_DIR", "Testing/Temporary");
+  vtkstd::string fileName = vtkstd::string(tempDir) + "/TimeStepIndex.geo";
+  delete [] tempDir;
+
+  // A C binary header and some bytes, not followed by a FILE_INDEX.
+  {
+  vtksys_ios::ofstream file(fileName.c_str(), ios::out | ios::binary);
+  char line[80];
+  memset(line, 0, 80);
+  strcpy(line, "C Binary");
+  file.write(line, 80);
+  memset(line, 0, 80);
+  file.write(line, 80);
+  if (!file.good())
+    {
+    cerr << "Could not write " << fileName.c_str() << endl;
+    return 1;
+    }
+  }
+
+  bool ok = true;
+  vtkSmartPointer<IndexReader> reader = vtkSmartPointer<IndexReader>::New();
+  vtkstd::string indexName;
+  if (reader->GetSaveTimeStepOffsets())
+    {
+    cerr << "SaveTimeStepOffsets is on by default" << endl;
+    ok = false;
+    }
+  if (reader->Seek(fileName.c_str(), 1) != 0)
+    {
+    cerr << "A time step offset was found before any scan" << endl;
+    ok = false;
+    }
+  indexName = reader->IndexFileName();
+  vtksys::SystemTools::RemoveFile(indexName.c_str());
+  reader->Found(fileName.c_str(), 1, 100);
+  if (vtksys::SystemTools::FileExists(indexName.c_str()))
+    {
+    cerr << "The time step index was saved by default" << endl;
+    ok = false;
+    }
+
+  // Saved when asked for, and used by the next reader.
+  reader = vtkSmartPointer<IndexReader>::New();
+  reader->SaveTimeStepOffsetsOn();
+  reader->Seek(fileName.c_str(), 1);
+  reader->Found(fileName.c_str(), 1, 100);
+  if (!vtksys::SystemTools::FileExists(indexName.c_str()))
+    {
+    cerr << "The time step index was not saved" << endl;
+    ok = false;
+    }
+  reader = vtkSmartPointer<IndexReader>::New();
+  if (reader->Seek(fileName.c_str(), 2) != 1)
+    {
+    cerr << "The saved time step index was not used" << endl;
+    ok = false;
+    }
+
+  vtksys::SystemTools::RemoveFile(indexName.c_str());
+  vtksys::SystemTools::RemoveFile(fileName.c_str());
+  return ok ? 0 : 1;
+}
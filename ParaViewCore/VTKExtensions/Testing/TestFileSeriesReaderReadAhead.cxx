@@ -0,0 +1,168 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestFileSeriesReaderReadAhead.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Plays a series of serial and of parallel VTK XML files back and forth, for
+// several piece requests, with vtkFileSeriesReader's ReadAhead off and on, and
+// checks that reading ahead does not change what is read.
+
+#include "vtkClientServerInterpreterInitializer.h"
+#include "vtkFileSeriesReader.h"
+#include "vtkPolyData.h"
+#include "vtkSmartPointer.h"
+#include "vtkSphereSource.h"
+#include "vtkStreamingDemandDrivenPipeline.h"
+#include "vtkTestUtilities.h"
+#include "vtkXMLPPolyDataReader.h"
+#include "vtkXMLPPolyDataWriter.h"
+#include "vtkXMLPolyDataReader.h"
+#include "vtkXMLPolyDataWriter.h"
+
+#include <vtksys/ios/sstream>
+#include <vtkstd/string>
+#include <vtkstd/vector>
+
+#define NUMBER_OF_FILES 4
+
+extern "C" void vtkIOCS_Initialize(vtkClientServerInterpreter*);
+
+namespace
+{
+  // Read every time step forward then backward for a piece request and
+  // record the number of points and cells of each read.
+  vtkstd::vector<vtkIdType> PlaySeries(vtkAlgorithm* reader,
+                                       const vtkstd::vector<vtkstd::string>& files,
+                                       int readAhead, int piece, int numPieces)
+  {
+    vtkSmartPointer<vtkFileSeriesReader> series =
+      vtkSmartPointer<vtkFileSeriesReader>::New();
+    series->SetReader(reader);
+    series->SetFileNameMethod("SetFileName");
+    for (size_t i = 0; i < files.size(); i++)
+      {
+      series->AddFileName(files[i].c_str());
+      }
+    series->SetReadAhead(readAhead);
+    series->UpdateInformation();
+
+    vtkStreamingDemandDrivenPipeline* sddp =
+      vtkStreamingDemandDrivenPipeline::SafeDownCast(series->GetExecutive());
+    vtkstd::vector<vtkIdType> counts;
+    for (int i = 0; i < 2*NUMBER_OF_FILES; i++)
+      {
+      int step = i < NUMBER_OF_FILES ? i : 2*NUMBER_OF_FILES - 1 - i;
+      sddp->SetUpdateExtent(0, piece, numPieces, 0);
+      sddp->SetUpdateTimeStep(0, step);
+      series->Update();
+      vtkPolyData* output = vtkPolyData::SafeDownCast(
+        series->GetOutputDataObject(0));
+      counts.push_back(output ? output->GetNumberOfPoints() : -1);
+      counts.push_back(output ? output->GetNumberOfCells() : -1);
+      }
+    return counts;
+  }
+
+  bool Compare(const char* name, vtkAlgorithm* reader,
+               const vtkstd::vector<vtkstd::string>& files, int numPieces)
+  {
+    bool ok = true;
+    for (int piece = 0; piece < numPieces; piece++)
+      {
+      vtkstd::vector<vtkIdType> expected =
+        PlaySeries(reader, files, 0, piece, numPieces);
+      vtkstd::vector<vtkIdType> actual =
+        PlaySeries(reader, files, 1, piece, numPieces);
+      if (numPieces == 1 && expected[0] <= 0)
+        {
+        cerr << "Nothing was read from the " << name << " series" << endl;
+        ok = false;
+        }
+      if (expected != actual)
+        {
+        cerr << "Reading the " << name << " series ahead changed piece "
+             << piece << " of " << numPieces << endl;
+        ok = false;
+        }
+      }
+    return ok;
+  }
+}
+
+int main(int argc, char* argv[])
+{
+  // vtkFileSeriesReader sets the file names of its reader through the
+  // ClientServer interpreter.
+  vtkClientServerInterpreterInitializer::GetInitializer()->RegisterCallback(
+    &vtkIOCS_Initialize);
+
+  char* tempDir = vtkTestUtilities::GetArgOrEnvOrDefault(
+    "-T", argc, argv, "VTK_TEMP_DIR", "Testing/Temporary");
+  vtkstd::string prefix = vtkstd::string(tempDir) + "/ReadAhead";
+  delete [] tempDir;
+
+  // A series of spheres that get finer with time, written as serial files
+  // and as parallel files of 3 pieces each.
+  vtkstd::vector<vtkstd::string> serialFiles;
+  vtkstd::vector<vtkstd::string> parallelFiles;
+  vtkSmartPointer<vtkSphereSource> sphere =
+    vtkSmartPointer<vtkSphereSource>::New();
+  for (int i = 0; i < NUMBER_OF_FILES; i++)
+    {
+    sphere->SetThetaResolution(8 + 4*i);
+    sphere->SetPhiResolution(8 + 4*i);
+
+    vtksys_ios::ostringstream serialName;
+    serialName << prefix << "_" << i << ".vtp";
+    vtkSmartPointer<vtkXMLPolyDataWriter> serialWriter =
+      vtkSmartPointer<vtkXMLPolyDataWriter>::New();
+    serialWriter->SetInputConnection(sphere->GetOutputPort());
+    serialWriter->SetFileName(serialName.str().c_str());
+    if (!serialWriter->Write())
+      {
+      cerr << "Could not write " << serialName.str() << endl;
+      return 1;
+      }
+    serialFiles.push_back(serialName.str());
+
+    vtksys_ios::ostringstream parallelName;
+    parallelName << prefix << "_" << i << ".pvtp";
+    vtkSmartPointer<vtkXMLPPolyDataWriter> parallelWriter =
+      vtkSmartPointer<vtkXMLPPolyDataWriter>::New();
+    parallelWriter->SetInputConnection(sphere->GetOutputPort());
+    parallelWriter->SetFileName(parallelName.str().c_str());
+    parallelWriter->SetNumberOfPieces(3);
+    parallelWriter->SetStartPiece(0);
+    parallelWriter->SetEndPiece(2);
+    if (!parallelWriter->Write())
+      {
+      cerr << "Could not write " << parallelName.str() << endl;
+      return 1;
+      }
+    parallelFiles.push_back(parallelName.str());
+    }
+
+  bool ok = true;
+  vtkSmartPointer<vtkXMLPolyDataReader> serialReader =
+    vtkSmartPointer<vtkXMLPolyDataReader>::New();
+  ok = Compare("serial", serialReader, serialFiles, 1) && ok;
+  ok = Compare("serial", serialReader, serialFiles, 2) && ok;
+
+  // more and fewer pieces requested than there are piece files
+  vtkSmartPointer<vtkXMLPPolyDataReader> parallelReader =
+    vtkSmartPointer<vtkXMLPPolyDataReader>::New();
+  ok = Compare("parallel", parallelReader, parallelFiles, 1) && ok;
+  ok = Compare("parallel", parallelReader, parallelFiles, 2) && ok;
+  ok = Compare("parallel", parallelReader, parallelFiles, 5) && ok;
+
+  return ok ? 0 : 1;
+}
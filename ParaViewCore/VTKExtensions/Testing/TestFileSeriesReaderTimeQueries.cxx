@@ -0,0 +1,264 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestFileSeriesReaderTimeQueries.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Opens a series of PVD files that carry their own time with
+// vtkFileSeriesReader and checks that:
+//  - by default the time information is neither distributed nor cached,
+//  - distributing the time queries over the processes does not change the
+//    time steps and leaves fewer files to each process,
+//  - the time cache is written when asked for, and that reading it back gives
+//    the same time steps without querying every file again.
+// Run it on one process or, with MPI, on several.
+
+#include "vtkClientServerInterpreterInitializer.h"
+#include "vtkFileSeriesReader.h"
+#include "vtkInformation.h"
+#include "vtkPVDReader.h"
+#include "vtkSmartPointer.h"
+#include "vtkSphereSource.h"
+#include "vtkStreamingDemandDrivenPipeline.h"
+#include "vtkTestUtilities.h"
+#include "vtkToolkits.h"
+#include "vtkXMLPolyDataWriter.h"
+
+#ifdef VTK_USE_MPI
+# include "vtkMPIController.h"
+#else
+# include "vtkDummyController.h"
+#endif
+
+#include <vtksys/SystemTools.hxx>
+#include <vtksys/ios/fstream>
+#include <vtksys/ios/sstream>
+#include <vtkstd/string>
+#include <vtkstd/vector>
+
+#define NUMBER_OF_FILES 6
+
+extern "C" void vtkPVVTKExtensionsCS_Initialize(vtkClientServerInterpreter*);
+
+namespace
+{
+  // A PVD reader that counts how many times it was asked for its time
+  // steps.  It does not override GetClassName() so that the ClientServer
+  // wrapping of vtkPVDReader still applies to it.
+  class CountingPVDReader : public vtkPVDReader
+  {
+  public:
+    typedef vtkPVDReader Superclass;
+    static CountingPVDReader* New() { return new CountingPVDReader; }
+    int NumberOfQueries;
+
+  protected:
+    CountingPVDReader() { this->NumberOfQueries = 0; }
+
+    virtual void SetupOutputInformation(vtkInformation *outInfo)
+    {
+      this->NumberOfQueries++;
+      this->Superclass::SetupOutputInformation(outInfo);
+    }
+  };
+
+  // Open the series and return its time steps.
+  vtkstd::vector<double> ReadTimeSteps(
+    const vtkstd::vector<vtkstd::string>& files, int distribute, int cache,
+    int& numberOfQueries)
+  {
+    vtkSmartPointer<CountingPVDReader> reader =
+      vtkSmartPointer<CountingPVDReader>::New();
+    vtkSmartPointer<vtkFileSeriesReader> series =
+      vtkSmartPointer<vtkFileSeriesReader>::New();
+    series->SetReader(reader);
+    series->SetFileNameMethod("SetFileName");
+    for (size_t i = 0; i < files.size(); i++)
+      {
+      series->AddFileName(files[i].c_str());
+      }
+    if (distribute >= 0)
+      {
+      series->SetDistributeTimeQueries(distribute);
+      }
+    if (cache >= 0)
+      {
+      series->SetCacheTimeInformation(cache);
+      }
+    series->UpdateInformation();
+    numberOfQueries = reader->NumberOfQueries;
+
+    vtkInformation* outInfo = series->GetExecutive()->GetOutputInformation(0);
+    vtkstd::vector<double> times;
+    if (outInfo->Has(vtkStreamingDemandDrivenPipeline::TIME_STEPS()))
+      {
+      double* steps =
+        outInfo->Get(vtkStreamingDemandDrivenPipeline::TIME_STEPS());
+      times.assign(steps, steps + outInfo->Length(
+        vtkStreamingDemandDrivenPipeline::TIME_STEPS()));
+      }
+    return times;
+  }
+}
+
+int main(int argc, char* argv[])
+{
+#ifdef VTK_USE_MPI
+  vtkMPIController* controller = vtkMPIController::New();
+  controller->Initialize(&argc, &argv);
+#else
+  vtkDummyController* controller = vtkDummyController::New();
+#endif
+  vtkMultiProcessController::SetGlobalController(controller);
+  int numProcs = controller->GetNumberOfProcesses();
+  int procId = controller->GetLocalProcessId();
+
+  vtkClientServerInterpreterInitializer::GetInitializer()->RegisterCallback(
+    &vtkPVVTKExtensionsCS_Initialize);
+
+  char* tempDir = vtkTestUtilities::GetArgOrEnvOrDefault(
+    "-T", argc, argv, "VTK_TEMP_DIR", "Testing/Temporary");
+  vtkstd::string prefix = vtkstd::string(tempDir) + "/TimeQueries";
+  delete [] tempDir;
+
+  // One poly data file, and a PVD file per step of the series that gives it
+  // two time steps.
+  vtkstd::string dataName = prefix + ".vtp";
+  vtkstd::vector<vtkstd::string> files;
+  vtkstd::vector<double> expected;
+  for (int i = 0; i < NUMBER_OF_FILES; i++)
+    {
+    vtksys_ios::ostringstream name;
+    name << prefix << "_" << i << ".pvd";
+    files.push_back(name.str());
+    expected.push_back(2*i);
+    expected.push_back(2*i + 0.5);
+    }
+  vtkstd::string cacheName = files[0] + ".vtktimes";
+  bool ok = true;
+  if (procId == 0)
+    {
+    vtkSmartPointer<vtkSphereSource> sphere =
+      vtkSmartPointer<vtkSphereSource>::New();
+    vtkSmartPointer<vtkXMLPolyDataWriter> writer =
+      vtkSmartPointer<vtkXMLPolyDataWriter>::New();
+    writer->SetInputConnection(sphere->GetOutputPort());
+    writer->SetFileName(dataName.c_str());
+    ok = writer->Write() != 0;
+    for (int i = 0; ok && i < NUMBER_OF_FILES; i++)
+      {
+      vtksys_ios::ofstream pvd(files[i].c_str());
+      pvd << "<?xml version=\"1.0\"?>" << endl
+          << "<VTKFile type=\"Collection\" version=\"0.1\">" << endl
+          << "  <Collection>" << endl;
+      for (int j = 0; j < 2; j++)
+        {
+        pvd << "    <DataSet timestep=\"" << expected[2*i + j]
+            << "\" part=\"0\" file=\""
+            << vtksys::SystemTools::GetFilenameName(dataName) << "\"/>"
+            << endl;
+        }
+      pvd << "  </Collection>" << endl
+          << "</VTKFile>" << endl;
+      ok = pvd.good();
+      }
+    vtksys::SystemTools::RemoveFile(cacheName.c_str());
+    }
+  int status = ok ? 1 : 0;
+  controller->Broadcast(&status, 1, 0);
+  if (!status)
+    {
+    cerr << "Could not write the series" << endl;
+    controller->Finalize();
+    controller->Delete();
+    return 1;
+    }
+
+  // By default every process queries every file and nothing is cached.
+  int queries = 0;
+  vtkstd::vector<double> times = ReadTimeSteps(files, -1, -1, queries);
+  if (times != expected)
+    {
+    cerr << "Process " << procId << " read the wrong time steps" << endl;
+    ok = false;
+    }
+  if (queries < NUMBER_OF_FILES)
+    {
+    cerr << "Process " << procId << " queried " << queries << " files, "
+         << "expected every file" << endl;
+    ok = false;
+    }
+  int defaultQueries = queries;
+  controller->Barrier();
+  if (procId == 0 && vtksys::SystemTools::FileExists(cacheName.c_str()))
+    {
+    cerr << "The time information was cached by default" << endl;
+    ok = false;
+    }
+
+  // Distributed queries give the same steps with fewer files per process.
+  times = ReadTimeSteps(files, 1, 0, queries);
+  if (times != expected)
+    {
+    cerr << "Process " << procId << " read the wrong time steps when the "
+         << "queries are distributed" << endl;
+    ok = false;
+    }
+  if (numProcs > 1 && queries >= defaultQueries)
+    {
+    cerr << "Process " << procId << " queried " << queries << " files when "
+         << "the queries are distributed, and " << defaultQueries
+         << " when they are not" << endl;
+    ok = false;
+    }
+
+  // The cache is written by the first read and used by the second one.
+  times = ReadTimeSteps(files, 0, 1, queries);
+  if (times != expected)
+    {
+    cerr << "Process " << procId << " read the wrong time steps when "
+         << "writing the cache" << endl;
+    ok = false;
+    }
+  controller->Barrier();
+  if (procId == 0 && !vtksys::SystemTools::FileExists(cacheName.c_str()))
+    {
+    cerr << "The time information was not cached" << endl;
+    ok = false;
+    }
+  times = ReadTimeSteps(files, 0, 1, queries);
+  if (times != expected)
+    {
+    cerr << "Process " << procId << " read the wrong time steps from the "
+         << "cache" << endl;
+    ok = false;
+    }
+  if (queries >= defaultQueries)
+    {
+    cerr << "Process " << procId << " queried " << queries << " files "
+         << "although the time information was cached" << endl;
+    ok = false;
+    }
+
+  controller->Barrier();
+  if (procId == 0)
+    {
+    vtksys::SystemTools::RemoveFile(cacheName.c_str());
+    }
+
+  int localStatus = ok ? 1 : 0;
+  controller->AllReduce(&localStatus, &status, 1,
+                        vtkCommunicator::MIN_OP);
+  vtkMultiProcessController::SetGlobalController(0);
+  controller->Finalize();
+  controller->Delete();
+  return status ? 0 : 1;
+}
@@ -0,0 +1,119 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestKdTreeManagerReusePartition.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Moves a sphere by small and large steps and checks that vtkKdTreeManager
+// keeps its partition only when ReusePartition is on, the data stayed close
+// to the partition and the producers are the same ones.
+
+#include "vtkDummyController.h"
+#include "vtkKdTreeManager.h"
+#include "vtkPKdTree.h"
+#include "vtkSmartPointer.h"
+#include "vtkSphereSource.h"
+#include "vtkTransform.h"
+#include "vtkTransformFilter.h"
+
+namespace
+{
+  vtkSmartPointer<vtkTransformFilter> MakeProducer(vtkSphereSource* sphere,
+                                                   vtkTransform* transform)
+  {
+    vtkSmartPointer<vtkTransformFilter> producer =
+      vtkSmartPointer<vtkTransformFilter>::New();
+    producer->SetInputConnection(sphere->GetOutputPort());
+    producer->SetTransform(transform);
+    producer->Update();
+    return producer;
+  }
+
+  // Move the data of the producer and update the manager.
+  bool Check(const char* name, vtkKdTreeManager* manager,
+             vtkTransform* transform, vtkTransformFilter* producer,
+             double dx, bool reused)
+  {
+    transform->Translate(dx, 0.0, 0.0);
+    producer->Update();
+    manager->Update();
+    if (manager->GetPartitionReused() != reused)
+      {
+      cerr << "The partition was " << (reused ? "not " : "") << "kept "
+           << name << endl;
+      return false;
+      }
+    return true;
+  }
+}
+
+int main(int, char**)
+{
+  vtkSmartPointer<vtkDummyController> controller =
+    vtkSmartPointer<vtkDummyController>::New();
+  vtkMultiProcessController::SetGlobalController(controller);
+
+  vtkSmartPointer<vtkSphereSource> sphere =
+    vtkSmartPointer<vtkSphereSource>::New();
+  sphere->SetThetaResolution(64);
+  sphere->SetPhiResolution(64);
+  vtkSmartPointer<vtkTransform> transform =
+    vtkSmartPointer<vtkTransform>::New();
+  vtkSmartPointer<vtkTransformFilter> producer =
+    MakeProducer(sphere, transform);
+
+  vtkSmartPointer<vtkKdTreeManager> manager =
+    vtkSmartPointer<vtkKdTreeManager>::New();
+  manager->GetKdTree()->SetNumberOfRegionsOrMore(8);
+  manager->ReusePartitionOn();
+  manager->AddProducer(producer);
+  manager->Update();
+  bool ok = true;
+  if (manager->GetPartitionReused() ||
+      manager->GetKdTree()->GetNumberOfRegions() < 8)
+    {
+    cerr << "The first partition was not built" << endl;
+    ok = false;
+    }
+
+  // The sphere has a diameter of 1, BoundsTolerance is 0.1 of the diagonal.
+  ok = Check("for a small move", manager, transform, producer,
+             0.02, true) && ok;
+  ok = Check("for a second small move", manager, transform, producer,
+             0.02, true) && ok;
+  ok = Check("for a large move", manager, transform, producer,
+             2.0, false) && ok;
+  ok = Check("for a small move after the large one", manager, transform,
+             producer, 0.02, true) && ok;
+
+  // Another producer of the same data, and one created after the producer of
+  // the partition was deleted.
+  vtkSmartPointer<vtkTransformFilter> other = MakeProducer(sphere, transform);
+  manager->RemoveAllProducers();
+  manager->AddProducer(other);
+  ok = Check("for another producer", manager, transform, other,
+             0.0, false) && ok;
+  manager->RemoveAllProducers();
+  other = 0;
+  producer = 0;
+  producer = MakeProducer(sphere, transform);
+  manager->AddProducer(producer);
+  ok = Check("for a new producer", manager, transform, producer,
+             0.0, false) && ok;
+
+  manager->ReusePartitionOff();
+  ok = Check("with ReusePartition off", manager, transform, producer,
+             0.02, false) && ok;
+
+  manager = 0;
+  vtkMultiProcessController::SetGlobalController(0);
+  return ok ? 0 : 1;
+}
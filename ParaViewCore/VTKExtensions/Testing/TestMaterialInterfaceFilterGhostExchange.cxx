@@ -0,0 +1,237 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestMaterialInterfaceFilterGhostExchange.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Extracts the fragments of every material of a CTH data set with
+// vtkMaterialInterfaceFilter on several MPI processes, which exchange their
+// ghost blocks without blocking, and checks on process 0 that the fragments
+// are the ones found by a single process: the same number of fragments per
+// material, with the same volumes.
+
+#include "vtkCellData.h"
+#include "vtkCompositeDataIterator.h"
+#include "vtkDataArray.h"
+#include "vtkDummyController.h"
+#include "vtkHierarchicalBoxDataSet.h"
+#include "vtkImageData.h"
+#include "vtkMaterialInterfaceFilter.h"
+#include "vtkMPIController.h"
+#include "vtkMultiBlockDataSet.h"
+#include "vtkPointData.h"
+#include "vtkPolyData.h"
+#include "vtkSmartPointer.h"
+#include "vtkSpyPlotReader.h"
+#include "vtkTestUtilities.h"
+
+#include <vtkstd/algorithm>
+#include <vtkstd/string>
+#include <vtkstd/vector>
+
+#include <math.h>
+
+namespace
+{
+  vtkSmartPointer<vtkSpyPlotReader> Read(const char* fname,
+                                         vtkMultiProcessController* controller)
+  {
+    vtkSmartPointer<vtkSpyPlotReader> reader =
+      vtkSmartPointer<vtkSpyPlotReader>::New();
+    reader->SetFileName(fname);
+    reader->SetGlobalController(controller);
+    reader->MergeXYZComponentsOn();
+    reader->DownConvertVolumeFractionOn();
+    // The blocks of every file are split between the processes.
+    reader->DistributeFilesOff();
+    reader->Update();
+    return reader;
+  }
+
+  // The material arrays of the first block of the input, and its number of
+  // blocks.
+  int FindMaterials(vtkDataObject* data,
+                    vtkstd::vector<vtkstd::string>& materials)
+  {
+    vtkHierarchicalBoxDataSet* input =
+      vtkHierarchicalBoxDataSet::SafeDownCast(data);
+    vtkCompositeDataIterator* iter = input ? input->NewIterator() : 0;
+    int numberOfBlocks = 0;
+    if (!iter)
+      {
+      return 0;
+      }
+    for (iter->InitTraversal(); !iter->IsDoneWithTraversal();
+         iter->GoToNextItem())
+      {
+      vtkImageData* block =
+        vtkImageData::SafeDownCast(iter->GetCurrentDataObject());
+      if (!block)
+        {
+        continue;
+        }
+      for (int i = 0; numberOfBlocks == 0 &&
+           i < block->GetCellData()->GetNumberOfArrays(); i++)
+        {
+        vtkDataArray* array = block->GetCellData()->GetArray(i);
+        vtkstd::string name = array && array->GetName() ? array->GetName() :
+          "";
+        if (name.find("Material volume fraction") == 0)
+          {
+          materials.push_back(name);
+          }
+        }
+      ++numberOfBlocks;
+      }
+    iter->Delete();
+    return numberOfBlocks;
+  }
+
+  // Run the filter with the global controller and return the sorted volumes
+  // of the fragments of each material, on process 0.
+  vtkstd::vector<vtkstd::vector<double> > Extract(
+    vtkDataObject* input, const vtkstd::vector<vtkstd::string>& materials)
+  {
+    vtkSmartPointer<vtkMaterialInterfaceFilter> filter =
+      vtkSmartPointer<vtkMaterialInterfaceFilter>::New();
+    filter->SetInput(input);
+    filter->SetMaterialFractionThreshold(0.5);
+    for (size_t i = 0; i < materials.size(); i++)
+      {
+      filter->SelectMaterialArray(materials[i].c_str());
+      }
+    filter->Update();
+
+    vtkstd::vector<vtkstd::vector<double> > volumes;
+    vtkMultiBlockDataSet* statistics =
+      vtkMultiBlockDataSet::SafeDownCast(filter->GetOutputDataObject(1));
+    for (unsigned int i = 0; statistics && i < statistics->GetNumberOfBlocks();
+         i++)
+      {
+      vtkPolyData* pd = vtkPolyData::SafeDownCast(statistics->GetBlock(i));
+      vtkDataArray* volume = pd ? pd->GetPointData()->GetArray("Volume") : 0;
+      vtkstd::vector<double> materialVolumes;
+      for (vtkIdType j = 0; volume && j < volume->GetNumberOfTuples(); j++)
+        {
+        materialVolumes.push_back(volume->GetTuple1(j));
+        }
+      vtkstd::sort(materialVolumes.begin(), materialVolumes.end());
+      volumes.push_back(materialVolumes);
+      }
+    return volumes;
+  }
+
+  bool Same(double a, double b)
+  {
+    // The pieces of a fragment found by different processes are added in
+    // another order.
+    return fabs(a - b) <= 1e-8 * (fabs(b) > 1.0 ? fabs(b) : 1.0);
+  }
+
+  bool Compare(const vtkstd::vector<vtkstd::vector<double> >& expected,
+               const vtkstd::vector<vtkstd::vector<double> >& actual)
+  {
+    if (expected.size() != actual.size())
+      {
+      cerr << "Statistics for " << actual.size() << " materials instead of "
+           << expected.size() << endl;
+      return false;
+      }
+    for (size_t i = 0; i < expected.size(); i++)
+      {
+      if (expected[i].size() != actual[i].size())
+        {
+        cerr << actual[i].size() << " fragments of material " << i
+             << " instead of " << expected[i].size() << endl;
+        return false;
+        }
+      for (size_t j = 0; j < expected[i].size(); j++)
+        {
+        if (!Same(actual[i][j], expected[i][j]))
+          {
+          cerr << "A fragment of material " << i << " has a volume of "
+               << actual[i][j] << " instead of " << expected[i][j] << endl;
+          return false;
+          }
+        }
+      }
+    return true;
+  }
+}
+
+int main(int argc, char* argv[])
+{
+  vtkMPIController* controller = vtkMPIController::New();
+  controller->Initialize(&argc, &argv);
+  vtkMultiProcessController::SetGlobalController(controller);
+  int procId = controller->GetLocalProcessId();
+
+  char* fname = vtkTestUtilities::ExpandDataFileName(
+    argc, argv, "Data/SPCTH/Dave_Karelitz_Small/spcth.0");
+
+  // Every process reads some of the blocks, those next to the blocks of
+  // another process need ghost blocks from it.
+  vtkSmartPointer<vtkSpyPlotReader> reader = Read(fname, controller);
+  vtkstd::vector<vtkstd::string> materials;
+  int numberOfBlocks =
+    FindMaterials(reader->GetOutputDataObject(0), materials);
+  bool ok = true;
+  if (numberOfBlocks == 0 || materials.empty())
+    {
+    cerr << "Process " << procId << " read no block of material" << endl;
+    ok = false;
+    }
+  int status = ok ? 1 : 0;
+  int localStatus = status;
+  controller->AllReduce(&localStatus, &status, 1, vtkCommunicator::MIN_OP);
+  if (!status)
+    {
+    delete [] fname;
+    vtkMultiProcessController::SetGlobalController(0);
+    controller->Finalize();
+    controller->Delete();
+    return 1;
+    }
+
+  vtkstd::vector<vtkstd::vector<double> > actual =
+    Extract(reader->GetOutputDataObject(0), materials);
+
+  // Process 0 extracts the fragments of the whole data set on its own.
+  if (procId == 0)
+    {
+    vtkSmartPointer<vtkDummyController> dummy =
+      vtkSmartPointer<vtkDummyController>::New();
+    vtkMultiProcessController::SetGlobalController(dummy);
+    vtkSmartPointer<vtkSpyPlotReader> serialReader = Read(fname, dummy);
+    vtkstd::vector<vtkstd::vector<double> > expected =
+      Extract(serialReader->GetOutputDataObject(0), materials);
+    size_t total = 0;
+    for (size_t i = 0; i < expected.size(); i++)
+      {
+      total += expected[i].size();
+      }
+    if (total == 0)
+      {
+      cerr << "No fragment was found" << endl;
+      ok = false;
+      }
+    ok = Compare(expected, actual) && ok;
+    vtkMultiProcessController::SetGlobalController(controller);
+    }
+  delete [] fname;
+
+  localStatus = ok ? 1 : 0;
+  controller->AllReduce(&localStatus, &status, 1, vtkCommunicator::MIN_OP);
+  vtkMultiProcessController::SetGlobalController(0);
+  controller->Finalize();
+  controller->Delete();
+  return status ? 0 : 1;
+}
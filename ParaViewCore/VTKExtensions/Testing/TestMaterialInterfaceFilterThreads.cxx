@@ -0,0 +1,246 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestMaterialInterfaceFilterThreads.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Extracts the fragments of every material of a CTH data set with
+// vtkMaterialInterfaceFilter on one thread and on several, and checks that
+// the fragments have the same ids, volumes, centers and integrated
+// attributes.
+
+#include "vtkCellData.h"
+#include "vtkCompositeDataIterator.h"
+#include "vtkDataArray.h"
+#include "vtkDummyController.h"
+#include "vtkHierarchicalBoxDataSet.h"
+#include "vtkImageData.h"
+#include "vtkMaterialInterfaceFilter.h"
+#include "vtkMultiBlockDataSet.h"
+#include "vtkMultiPieceDataSet.h"
+#include "vtkPointData.h"
+#include "vtkPolyData.h"
+#include "vtkSmartPointer.h"
+#include "vtkSpyPlotReader.h"
+#include "vtkTestUtilities.h"
+
+#include <vtkstd/string>
+#include <vtkstd/vector>
+
+#include <math.h>
+
+namespace
+{
+  // Run the filter on the given number of threads and return its fragment
+  // statistics.
+  vtkSmartPointer<vtkMultiBlockDataSet> Extract(
+    vtkDataObject* input, int numberOfThreads,
+    const vtkstd::vector<vtkstd::string>& materials,
+    const vtkstd::vector<vtkstd::string>& attributes,
+    vtkstd::vector<unsigned int>& numberOfFragments)
+  {
+    vtkSmartPointer<vtkMaterialInterfaceFilter> filter =
+      vtkSmartPointer<vtkMaterialInterfaceFilter>::New();
+    filter->SetInput(input);
+    filter->SetNumberOfThreads(numberOfThreads);
+    filter->SetMaterialFractionThreshold(0.5);
+    size_t i;
+    for (i = 0; i < materials.size(); i++)
+      {
+      filter->SelectMaterialArray(materials[i].c_str());
+      }
+    for (i = 0; i < attributes.size(); i++)
+      {
+      filter->SelectVolumeWtdAvgArray(attributes[i].c_str());
+      filter->SelectSummationArray(attributes[i].c_str());
+      }
+    filter->Update();
+
+    vtkMultiBlockDataSet* fragments =
+      vtkMultiBlockDataSet::SafeDownCast(filter->GetOutputDataObject(0));
+    numberOfFragments.clear();
+    for (i = 0; i < fragments->GetNumberOfBlocks(); i++)
+      {
+      vtkMultiPieceDataSet* pieces =
+        vtkMultiPieceDataSet::SafeDownCast(fragments->GetBlock(i));
+      numberOfFragments.push_back(pieces ? pieces->GetNumberOfPieces() : 0);
+      }
+
+    vtkSmartPointer<vtkMultiBlockDataSet> statistics =
+      vtkSmartPointer<vtkMultiBlockDataSet>::New();
+    statistics->DeepCopy(filter->GetOutputDataObject(1));
+    return statistics;
+  }
+
+  bool Same(double a, double b)
+  {
+    // The pieces of a fragment found by different threads are added in
+    // another order.
+    return fabs(a - b) <= 1e-10 * (fabs(b) > 1.0 ? fabs(b) : 1.0);
+  }
+
+  bool Compare(int numberOfThreads, vtkMultiBlockDataSet* expected,
+               const vtkstd::vector<unsigned int>& expectedFragments,
+               vtkMultiBlockDataSet* actual,
+               const vtkstd::vector<unsigned int>& actualFragments)
+  {
+    if (expectedFragments != actualFragments ||
+        expected->GetNumberOfBlocks() != actual->GetNumberOfBlocks())
+      {
+      cerr << "Different fragments on " << numberOfThreads << " threads"
+           << endl;
+      return false;
+      }
+    for (unsigned int i = 0; i < expected->GetNumberOfBlocks(); i++)
+      {
+      vtkPolyData* pd1 = vtkPolyData::SafeDownCast(expected->GetBlock(i));
+      vtkPolyData* pd2 = vtkPolyData::SafeDownCast(actual->GetBlock(i));
+      if (!pd1 || !pd2 ||
+          pd1->GetNumberOfPoints() != pd2->GetNumberOfPoints() ||
+          pd1->GetPointData()->GetNumberOfArrays() !=
+          pd2->GetPointData()->GetNumberOfArrays())
+        {
+        cerr << "Different statistics for material " << i << " on "
+             << numberOfThreads << " threads" << endl;
+        return false;
+        }
+      for (vtkIdType j = 0; j < pd1->GetNumberOfPoints(); j++)
+        {
+        double x1[3], x2[3];
+        pd1->GetPoint(j, x1);
+        pd2->GetPoint(j, x2);
+        if (!Same(x2[0], x1[0]) || !Same(x2[1], x1[1]) || !Same(x2[2], x1[2]))
+          {
+          cerr << "Fragment " << j << " of material " << i << " has another"
+               << " center on " << numberOfThreads << " threads" << endl;
+          return false;
+          }
+        }
+      for (int k = 0; k < pd1->GetPointData()->GetNumberOfArrays(); k++)
+        {
+        vtkDataArray* a1 = pd1->GetPointData()->GetArray(k);
+        vtkDataArray* a2 = a1 ?
+          pd2->GetPointData()->GetArray(a1->GetName()) : 0;
+        if (!a1)
+          {
+          continue;
+          }
+        if (!a2 ||
+            a1->GetNumberOfComponents() != a2->GetNumberOfComponents() ||
+            a1->GetNumberOfTuples() != a2->GetNumberOfTuples())
+          {
+          cerr << "Different " << a1->GetName() << " of material " << i
+               << " on " << numberOfThreads << " threads" << endl;
+          return false;
+          }
+        for (vtkIdType j = 0; j < a1->GetNumberOfTuples(); j++)
+          {
+          for (int c = 0; c < a1->GetNumberOfComponents(); c++)
+            {
+            double v1 = a1->GetComponent(j, c);
+            double v2 = a2->GetComponent(j, c);
+            if (!Same(v2, v1))
+              {
+              cerr << a1->GetName() << " of fragment " << j
+                   << " of material " << i << " is " << v2 << " on "
+                   << numberOfThreads << " threads instead of " << v1
+                   << endl;
+              return false;
+              }
+            }
+          }
+        }
+      }
+    return true;
+  }
+}
+
+int main(int argc, char* argv[])
+{
+  char* fname = vtkTestUtilities::ExpandDataFileName(
+    argc, argv, "Data/SPCTH/Dave_Karelitz_Small/spcth.0");
+
+  vtkSmartPointer<vtkDummyController> controller =
+    vtkSmartPointer<vtkDummyController>::New();
+  vtkMultiProcessController::SetGlobalController(controller);
+
+  vtkSmartPointer<vtkSpyPlotReader> reader =
+    vtkSmartPointer<vtkSpyPlotReader>::New();
+  reader->SetFileName(fname);
+  reader->SetGlobalController(controller);
+  reader->MergeXYZComponentsOn();
+  reader->DownConvertVolumeFractionOn();
+  reader->DistributeFilesOn();
+  reader->Update();
+  delete [] fname;
+
+  // Every material, and every other scalar cell array as an attribute.
+  vtkHierarchicalBoxDataSet* input =
+    vtkHierarchicalBoxDataSet::SafeDownCast(reader->GetOutputDataObject(0));
+  vtkstd::vector<vtkstd::string> materials;
+  vtkstd::vector<vtkstd::string> attributes;
+  vtkCompositeDataIterator* iter = input ? input->NewIterator() : 0;
+  if (iter)
+    {
+    iter->InitTraversal();
+    vtkImageData* block = iter->IsDoneWithTraversal() ? 0 :
+      vtkImageData::SafeDownCast(iter->GetCurrentDataObject());
+    for (int i = 0; block && i < block->GetCellData()->GetNumberOfArrays();
+         i++)
+      {
+      vtkDataArray* array = block->GetCellData()->GetArray(i);
+      vtkstd::string name = array && array->GetName() ? array->GetName() : "";
+      if (name.find("Material volume fraction") == 0)
+        {
+        materials.push_back(name);
+        }
+      else if (!name.empty() && array->GetNumberOfComponents() == 1)
+        {
+        attributes.push_back(name);
+        }
+      }
+    iter->Delete();
+    }
+  if (materials.empty())
+    {
+    cerr << "No material was read" << endl;
+    return 1;
+    }
+
+  vtkstd::vector<unsigned int> expectedFragments;
+  vtkSmartPointer<vtkMultiBlockDataSet> expected =
+    Extract(input, 1, materials, attributes, expectedFragments);
+  unsigned int total = 0;
+  for (size_t i = 0; i < expectedFragments.size(); i++)
+    {
+    total += expectedFragments[i];
+    }
+  if (total == 0)
+    {
+    cerr << "No fragment was found" << endl;
+    return 1;
+    }
+
+  // An odd number of threads splits the blocks unevenly.
+  bool ok = true;
+  int numbersOfThreads[] = { 2, 3, 8 };
+  for (int i = 0; i < 3; i++)
+    {
+    vtkstd::vector<unsigned int> actualFragments;
+    vtkSmartPointer<vtkMultiBlockDataSet> actual = Extract(input,
+      numbersOfThreads[i], materials, attributes, actualFragments);
+    ok = Compare(numbersOfThreads[i], expected, expectedFragments,
+                 actual, actualFragments) && ok;
+    }
+
+  vtkMultiProcessController::SetGlobalController(0);
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,229 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestPVArrayCalculator.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Evaluates functions using every operator and function with
+// vtkPVArrayCalculator, which compiles what it can, and with a plain
+// vtkArrayCalculator, which always goes through vtkFunctionParser, and checks
+// that both give the same results.
+
+#include "vtkArrayCalculator.h"
+#include "vtkCellData.h"
+#include "vtkDataArray.h"
+#include "vtkDoubleArray.h"
+#include "vtkFloatArray.h"
+#include "vtkPointData.h"
+#include "vtkPolyData.h"
+#include "vtkPVArrayCalculator.h"
+#include "vtkSmartPointer.h"
+#include "vtkSphereSource.h"
+
+#include <math.h>
+
+namespace
+{
+  // Functions of the point data. s is in ]0, 1[, t is never 0, v is a vector.
+  const char* PointFunctions[] =
+    {
+    // operators and precedence
+    "s+t", "s-t", "s*t", "t/s", "s^t", "t^3", "-s", "-s^2",
+    "s+t*s^2-t/s", "(s+t)*(s-t)", "1.5*s-2",
+    // functions
+    "abs(t)", "exp(t)", "ceil(t)", "floor(t)", "ln(s)", "log10(s)",
+    "sqrt(s)", "sin(t)", "cos(t)", "tan(s)", "asin(s)", "acos(s)", "atan(t)",
+    "sinh(t)", "cosh(t)", "tanh(t)", "sqrt(abs(t))+exp(-s)",
+    // vectors
+    "v", "-v", "v+coords", "v-coords", "v*s", "t*v", "2*v-coords",
+    "v.coords", "mag(v)", "mag(v)*s", "iHat*s+jHat*t+kHat",
+    "v_X+v_Y*v_Z",
+    // coordinates
+    "coordsX*coordsY-coordsZ", "mag(coords)", "coords*coordsZ",
+    // left to vtkFunctionParser
+    "norm(v)",
+    NULL
+    };
+
+  // Functions undefined for some tuples, evaluated with ReplaceInvalidValues.
+  const char* InvalidFunctions[] =
+    {
+    "ln(s-0.5)", "sqrt(t)", "1/(s-s)", "asin(t)", "t^s",
+    NULL
+    };
+
+  // Functions of the cell data, which have no coordinates.
+  const char* CellFunctions[] =
+    {
+    "cs*2+cs^2", "sqrt(cs)", "cv*cs", "cv.cv", "mag(cv)", "cv-iHat",
+    NULL
+    };
+
+  void AddArrays(vtkPolyData* data)
+  {
+    vtkIdType numPoints = data->GetNumberOfPoints();
+    vtkSmartPointer<vtkDoubleArray> s = vtkSmartPointer<vtkDoubleArray>::New();
+    s->SetName("s");
+    vtkSmartPointer<vtkFloatArray> t = vtkSmartPointer<vtkFloatArray>::New();
+    t->SetName("t");
+    vtkSmartPointer<vtkDoubleArray> v = vtkSmartPointer<vtkDoubleArray>::New();
+    v->SetName("v");
+    v->SetNumberOfComponents(3);
+    for (vtkIdType i = 0; i < numPoints; i++)
+      {
+      double* x = data->GetPoint(i);
+      s->InsertNextValue(0.1 + 0.8 * (i % 97) / 96.0);
+      t->InsertNextValue(static_cast<float>((i % 13) - 5.5));
+      v->InsertNextTuple3(x[0] + 1.0, 2.0 * x[1], x[2] - 0.01 * (i % 7));
+      }
+    data->GetPointData()->AddArray(s);
+    data->GetPointData()->AddArray(t);
+    data->GetPointData()->AddArray(v);
+
+    vtkIdType numCells = data->GetNumberOfCells();
+    vtkSmartPointer<vtkDoubleArray> cs = vtkSmartPointer<vtkDoubleArray>::New();
+    cs->SetName("cs");
+    vtkSmartPointer<vtkDoubleArray> cv = vtkSmartPointer<vtkDoubleArray>::New();
+    cv->SetName("cv");
+    cv->SetNumberOfComponents(3);
+    for (vtkIdType i = 0; i < numCells; i++)
+      {
+      cs->InsertNextValue(0.25 + (i % 11));
+      cv->InsertNextTuple3(i % 5, -0.5 * (i % 3), 1.0 / (1 + i % 4));
+      }
+    data->GetCellData()->AddArray(cs);
+    data->GetCellData()->AddArray(cv);
+  }
+
+  // The variables vtkPVArrayCalculator registers for the arrays used above.
+  void AddVariables(vtkArrayCalculator* calculator, bool cellData)
+  {
+    calculator->AddCoordinateScalarVariable("coordsX", 0);
+    calculator->AddCoordinateScalarVariable("coordsY", 1);
+    calculator->AddCoordinateScalarVariable("coordsZ", 2);
+    calculator->AddCoordinateVectorVariable("coords", 0, 1, 2);
+    if (cellData)
+      {
+      calculator->AddScalarVariable("cs", "cs", 0);
+      calculator->AddVectorArrayName("cv", 0, 1, 2);
+      }
+    else
+      {
+      calculator->AddScalarVariable("s", "s", 0);
+      calculator->AddScalarVariable("t", "t", 0);
+      calculator->AddScalarVariable("v_X", "v", 0);
+      calculator->AddScalarVariable("v_Y", "v", 1);
+      calculator->AddScalarVariable("v_Z", "v", 2);
+      calculator->AddVectorArrayName("v", 0, 1, 2);
+      }
+  }
+
+  bool Compare(vtkPolyData* input, const char* function, bool cellData,
+               bool replaceInvalidValues, int resultType)
+  {
+    vtkSmartPointer<vtkPVArrayCalculator> compiled =
+      vtkSmartPointer<vtkPVArrayCalculator>::New();
+    vtkSmartPointer<vtkArrayCalculator> parsed =
+      vtkSmartPointer<vtkArrayCalculator>::New();
+    AddVariables(parsed, cellData);
+
+    vtkArrayCalculator* calculators[2] = { compiled, parsed };
+    vtkDataArray* results[2];
+    vtkDataSetAttributes* attributes[2];
+    for (int i = 0; i < 2; i++)
+      {
+      calculators[i]->SetInput(input);
+      calculators[i]->SetAttributeMode(cellData ?
+        VTK_ATTRIBUTE_MODE_USE_CELL_DATA : VTK_ATTRIBUTE_MODE_USE_POINT_DATA);
+      calculators[i]->SetFunction(function);
+      calculators[i]->SetResultArrayName("Result");
+      calculators[i]->SetResultArrayType(resultType);
+      calculators[i]->SetReplaceInvalidValues(replaceInvalidValues ? 1 : 0);
+      calculators[i]->SetReplacementValue(42.0);
+      calculators[i]->Update();
+      vtkDataSet* output = vtkDataSet::SafeDownCast(
+        calculators[i]->GetOutputDataObject(0));
+      attributes[i] = cellData ?
+        static_cast<vtkDataSetAttributes*>(output->GetCellData()) :
+        static_cast<vtkDataSetAttributes*>(output->GetPointData());
+      results[i] = attributes[i]->GetArray("Result");
+      }
+
+    if (!results[0] || !results[1])
+      {
+      cerr << "\"" << function << "\" was not evaluated by "
+           << (results[0] ? "vtkArrayCalculator" : "vtkPVArrayCalculator")
+           << endl;
+      return false;
+      }
+    if (results[0]->GetDataType() != results[1]->GetDataType() ||
+        results[0]->GetNumberOfComponents() !=
+        results[1]->GetNumberOfComponents() ||
+        results[0]->GetNumberOfTuples() != results[1]->GetNumberOfTuples() ||
+        (attributes[0]->GetScalars() == results[0]) !=
+        (attributes[1]->GetScalars() == results[1]) ||
+        (attributes[0]->GetVectors() == results[0]) !=
+        (attributes[1]->GetVectors() == results[1]))
+      {
+      cerr << "\"" << function << "\" gives a different result array" << endl;
+      return false;
+      }
+
+    // Single precision results may round differently.
+    double tolerance = resultType == VTK_FLOAT ? 1e-6 : 1e-12;
+    int numComps = results[0]->GetNumberOfComponents();
+    for (vtkIdType i = 0; i < results[0]->GetNumberOfTuples(); i++)
+      {
+      for (int j = 0; j < numComps; j++)
+        {
+        double a = results[0]->GetComponent(i, j);
+        double b = results[1]->GetComponent(i, j);
+        if (fabs(a - b) > tolerance * (fabs(b) > 1.0 ? fabs(b) : 1.0))
+          {
+          cerr << "\"" << function << "\" gives " << a << " instead of " << b
+               << " for component " << j << " of tuple " << i << endl;
+          return false;
+          }
+        }
+      }
+    return true;
+  }
+}
+
+int main(int, char**)
+{
+  // More points than the compiled functions evaluate at once.
+  vtkSmartPointer<vtkSphereSource> sphere =
+    vtkSmartPointer<vtkSphereSource>::New();
+  sphere->SetThetaResolution(80);
+  sphere->SetPhiResolution(80);
+  sphere->Update();
+  vtkSmartPointer<vtkPolyData> input = vtkSmartPointer<vtkPolyData>::New();
+  input->ShallowCopy(sphere->GetOutput());
+  AddArrays(input);
+
+  bool ok = true;
+  int i;
+  for (i = 0; PointFunctions[i]; i++)
+    {
+    ok = Compare(input, PointFunctions[i], false, false, VTK_DOUBLE) && ok;
+    ok = Compare(input, PointFunctions[i], false, false, VTK_FLOAT) && ok;
+    }
+  for (i = 0; InvalidFunctions[i]; i++)
+    {
+    ok = Compare(input, InvalidFunctions[i], false, true, VTK_DOUBLE) && ok;
+    }
+  for (i = 0; CellFunctions[i]; i++)
+    {
+    ok = Compare(input, CellFunctions[i], true, false, VTK_DOUBLE) && ok;
+    }
+  return ok ? 0 : 1;
+}
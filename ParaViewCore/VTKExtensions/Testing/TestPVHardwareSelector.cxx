@@ -0,0 +1,143 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestPVHardwareSelector.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Selects cells of a sphere with vtkPVHardwareSelector and checks when the
+// captured buffers are reused, with the whole viewport captured (the default)
+// and with CaptureRegionOnly on, and that reusing them selects the same cells
+// as capturing them again.
+
+#include "vtkAbstractArray.h"
+#include "vtkActor.h"
+#include "vtkDataObject.h"
+#include "vtkPolyDataMapper.h"
+#include "vtkPVHardwareSelector.h"
+#include "vtkRenderer.h"
+#include "vtkRenderWindow.h"
+#include "vtkSelection.h"
+#include "vtkSelectionNode.h"
+#include "vtkSmartPointer.h"
+#include "vtkSphereSource.h"
+
+namespace
+{
+  vtkIdType CountSelected(vtkSelection* sel)
+  {
+    vtkIdType count = 0;
+    for (unsigned int i = 0; sel && i < sel->GetNumberOfNodes(); i++)
+      {
+      vtkAbstractArray* ids = sel->GetNode(i)->GetSelectionList();
+      count += ids ? ids->GetNumberOfTuples() : 0;
+      }
+    return count;
+  }
+
+  // Select the region and check whether the buffers were captured again.
+  bool Check(const char* name, vtkPVHardwareSelector* selector,
+             int region[4], bool capture, vtkIdType& count)
+  {
+    bool ok = true;
+    if (selector->NeedToRenderForSelection(region) != capture)
+      {
+      cerr << "The buffers would " << (capture ? "not " : "")
+           << "be captured " << name << endl;
+      ok = false;
+      }
+    vtkSelection* sel = selector->Select(region);
+    count = CountSelected(sel);
+    if (count == 0)
+      {
+      cerr << "Nothing was selected " << name << endl;
+      ok = false;
+      }
+    if (sel)
+      {
+      sel->Delete();
+      }
+    return ok;
+  }
+}
+
+int main(int, char**)
+{
+  vtkSmartPointer<vtkSphereSource> sphere =
+    vtkSmartPointer<vtkSphereSource>::New();
+  sphere->SetThetaResolution(32);
+  sphere->SetPhiResolution(32);
+  vtkSmartPointer<vtkPolyDataMapper> mapper =
+    vtkSmartPointer<vtkPolyDataMapper>::New();
+  mapper->SetInputConnection(sphere->GetOutputPort());
+  vtkSmartPointer<vtkActor> actor = vtkSmartPointer<vtkActor>::New();
+  actor->SetMapper(mapper);
+  vtkSmartPointer<vtkRenderer> renderer = vtkSmartPointer<vtkRenderer>::New();
+  renderer->AddActor(actor);
+  vtkSmartPointer<vtkRenderWindow> window =
+    vtkSmartPointer<vtkRenderWindow>::New();
+  window->AddRenderer(renderer);
+  window->SetSize(200, 200);
+  window->Render();
+
+  vtkSmartPointer<vtkPVHardwareSelector> selector =
+    vtkSmartPointer<vtkPVHardwareSelector>::New();
+  selector->SetRenderer(renderer);
+  selector->SetFieldAssociation(vtkDataObject::FIELD_ASSOCIATION_CELLS);
+
+  int left[4] = { 60, 80, 99, 120 };
+  int right[4] = { 100, 80, 139, 120 };
+  int inside[4] = { 70, 90, 90, 110 };
+  vtkIdType count, leftCount, rightCount, insideCount;
+
+  // The whole viewport is captured by default, and reused.
+  bool ok = !selector->GetCaptureRegionOnly();
+  ok = Check("the first time", selector, left, true, leftCount) && ok;
+  ok = Check("for another region", selector, right, false, rightCount) && ok;
+  selector->InvalidateCachedSelection();
+  ok = Check("after invalidation", selector, right, true, count) && ok;
+  if (count != rightCount)
+    {
+    cerr << "The captured buffers selected " << rightCount << " cells instead"
+         << " of " << count << endl;
+    ok = false;
+    }
+  ok = Check("for a region inside", selector, inside, false, insideCount) &&
+    ok;
+
+  // Only the region is captured, the buffers are reused for regions inside.
+  selector->CaptureRegionOnlyOn();
+  selector->InvalidateCachedSelection();
+  ok = Check("for the region only", selector, left, true, count) && ok;
+  if (count != leftCount)
+    {
+    cerr << "Capturing the region only selected " << count << " cells instead"
+         << " of " << leftCount << endl;
+    ok = false;
+    }
+  ok = Check("for a region inside the captured one", selector, inside, false,
+             count) && ok;
+  if (count != insideCount)
+    {
+    cerr << "The captured region selected " << count << " cells instead of "
+         << insideCount << endl;
+    ok = false;
+    }
+  ok = Check("for a region outside the captured one", selector, right, true,
+             count) && ok;
+  if (count != rightCount)
+    {
+    cerr << "Capturing the region only selected " << count << " cells instead"
+         << " of " << rightCount << endl;
+    ok = false;
+    }
+
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,219 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestPVLODHierarchyFilter.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Checks that the levels of vtkPVLODHierarchyFilter are what the
+// vtkQuadricClustering geometry representations used before gives, whether
+// they are built in the background or not, and when a background build is
+// replaced by another one.
+
+#include "vtkCellArray.h"
+#include "vtkIdTypeArray.h"
+#include "vtkImageData.h"
+#include "vtkMultiBlockDataSet.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkPVLODHierarchyFilter.h"
+#include "vtkQuadricClustering.h"
+#include "vtkSmartPointer.h"
+#include "vtkSphereSource.h"
+
+#include <vtkstd/vector>
+
+namespace
+{
+  // What vtkGeometryRepresentation did for each LOD.
+  vtkSmartPointer<vtkPolyData> Decimate(vtkPolyData* input, int divisions)
+  {
+    vtkSmartPointer<vtkQuadricClustering> decimator =
+      vtkSmartPointer<vtkQuadricClustering>::New();
+    decimator->SetUseInputPoints(1);
+    decimator->SetCopyCellData(1);
+    decimator->SetUseInternalTriangles(0);
+    decimator->SetNumberOfDivisions(divisions, divisions, divisions);
+    decimator->SetInput(input);
+    decimator->Update();
+    vtkSmartPointer<vtkPolyData> output = vtkSmartPointer<vtkPolyData>::New();
+    output->ShallowCopy(decimator->GetOutput());
+    return output;
+  }
+
+  // Decimate with each number of divisions in turn.
+  vtkSmartPointer<vtkPolyData> Decimate(vtkPolyData* input,
+                                        const vtkstd::vector<int>& divisions)
+  {
+    vtkSmartPointer<vtkPolyData> output = input;
+    for (size_t i = 0; i < divisions.size(); i++)
+      {
+      output = Decimate(output, divisions[i]);
+      }
+    return output;
+  }
+
+  bool SamePolyData(vtkPolyData* pd1, vtkPolyData* pd2)
+  {
+    if (!pd1 || !pd2 ||
+        pd1->GetNumberOfPoints() != pd2->GetNumberOfPoints() ||
+        pd1->GetNumberOfCells() != pd2->GetNumberOfCells() ||
+        pd1->GetNumberOfCells() == 0)
+      {
+      return false;
+      }
+    for (vtkIdType i = 0; i < pd1->GetNumberOfPoints(); i++)
+      {
+      double x1[3], x2[3];
+      pd1->GetPoint(i, x1);
+      pd2->GetPoint(i, x2);
+      if (x1[0] != x2[0] || x1[1] != x2[1] || x1[2] != x2[2])
+        {
+        return false;
+        }
+      }
+    vtkIdTypeArray* cells1 = pd1->GetPolys()->GetData();
+    vtkIdTypeArray* cells2 = pd2->GetPolys()->GetData();
+    if (cells1->GetNumberOfTuples() != cells2->GetNumberOfTuples())
+      {
+      return false;
+      }
+    for (vtkIdType i = 0; i < cells1->GetNumberOfTuples(); i++)
+      {
+      if (cells1->GetValue(i) != cells2->GetValue(i))
+        {
+        return false;
+        }
+      }
+    return true;
+  }
+
+  // The polydata blocks must be the input blocks decimated with the given
+  // numbers of divisions, the others must be passed.
+  bool Check(const char* name, vtkPVLODHierarchyFilter* filter,
+             vtkMultiBlockDataSet* input, const vtkstd::vector<int>& divisions)
+  {
+    filter->Update();
+    vtkMultiBlockDataSet* output = filter->GetOutput();
+    bool ok = output->GetNumberOfBlocks() == input->GetNumberOfBlocks();
+    for (unsigned int i = 0; ok && i < input->GetNumberOfBlocks(); i++)
+      {
+      vtkPolyData* pd = vtkPolyData::SafeDownCast(input->GetBlock(i));
+      if (pd)
+        {
+        vtkSmartPointer<vtkPolyData> expected = Decimate(pd, divisions);
+        ok = SamePolyData(vtkPolyData::SafeDownCast(output->GetBlock(i)),
+                          expected);
+        }
+      else
+        {
+        ok = output->GetBlock(i) == input->GetBlock(i);
+        }
+      }
+    if (!ok)
+      {
+      cerr << "Wrong levels of detail " << name << endl;
+      }
+    return ok;
+  }
+
+  vtkSmartPointer<vtkMultiBlockDataSet> MakeInput(int resolution)
+  {
+    vtkSmartPointer<vtkMultiBlockDataSet> input =
+      vtkSmartPointer<vtkMultiBlockDataSet>::New();
+    for (int i = 0; i < 2; i++)
+      {
+      vtkSmartPointer<vtkSphereSource> sphere =
+        vtkSmartPointer<vtkSphereSource>::New();
+      sphere->SetCenter(2.0 * i, 0.0, 0.0);
+      sphere->SetThetaResolution(resolution + 10 * i);
+      sphere->SetPhiResolution(resolution);
+      sphere->Update();
+      vtkSmartPointer<vtkPolyData> block = vtkSmartPointer<vtkPolyData>::New();
+      block->ShallowCopy(sphere->GetOutput());
+      input->SetBlock(i, block);
+      }
+    vtkSmartPointer<vtkImageData> image = vtkSmartPointer<vtkImageData>::New();
+    image->SetDimensions(2, 2, 2);
+    input->SetBlock(2, image);
+    return input;
+  }
+
+  vtkstd::vector<int> Divisions(int d1, int d2 = 0, int d3 = 0, int d4 = 0)
+  {
+    int d[4] = { d1, d2, d3, d4 };
+    vtkstd::vector<int> divisions;
+    for (int i = 0; i < 4 && d[i]; i++)
+      {
+      divisions.push_back(d[i]);
+      }
+    return divisions;
+  }
+}
+
+int main(int, char**)
+{
+  bool ok = true;
+  vtkSmartPointer<vtkMultiBlockDataSet> input = MakeInput(120);
+
+  // 85 divisions is the default LOD resolution of the render view.
+  vtkSmartPointer<vtkPVLODHierarchyFilter> filter =
+    vtkSmartPointer<vtkPVLODHierarchyFilter>::New();
+  filter->SetInput(input);
+  filter->SetNumberOfDivisions(85);
+  ok = Check("for 85 divisions", filter, input, Divisions(85)) && ok;
+
+  // Coarser levels decimate the finer ones.
+  filter->SetNumberOfDivisions(42);
+  ok = Check("for 42 divisions", filter, input, Divisions(85, 42)) && ok;
+  filter->SetNumberOfDivisions(30);
+  ok = Check("for 30 divisions", filter, input, Divisions(85, 42, 21)) && ok;
+  filter->SetNumberOfDivisions(5);
+  ok = Check("below the coarsest level", filter, input,
+             Divisions(85, 42, 21, 10)) && ok;
+
+  // More divisions than built.
+  filter->SetNumberOfDivisions(160);
+  ok = Check("for 160 divisions", filter, input, Divisions(160)) && ok;
+
+  // Built in the background, for an input changed since.
+  vtkSmartPointer<vtkPVLODHierarchyFilter> background =
+    vtkSmartPointer<vtkPVLODHierarchyFilter>::New();
+  background->SetInput(input);
+  background->SetNumberOfDivisions(85);
+  background->BuildInBackground();
+  background->BuildInBackground();
+  ok = Check("built in the background", background, input,
+             Divisions(85)) && ok;
+
+  vtkSmartPointer<vtkMultiBlockDataSet> input2 = MakeInput(60);
+  background->SetInput(input2);
+  background->BuildInBackground();
+  background->SetNumberOfDivisions(100);
+  ok = Check("built in the background with fewer divisions", background,
+             input2, Divisions(100)) && ok;
+  background->BuildInBackground();
+  background->SetInput(input);
+  ok = Check("built in the background for another input", background,
+             input, Divisions(100)) && ok;
+
+  // A build for an input replaced before the build is used is stopped, and
+  // another one is started for the new input.
+  vtkSmartPointer<vtkMultiBlockDataSet> input3 = MakeInput(90);
+  background->SetInput(input2);
+  background->SetNumberOfDivisions(85);
+  background->BuildInBackground();
+  background->SetInput(input3);
+  background->BuildInBackground();
+  ok = Check("built in the background after a stale build", background,
+             input3, Divisions(85)) && ok;
+
+  return ok ? 0 : 1;
+}
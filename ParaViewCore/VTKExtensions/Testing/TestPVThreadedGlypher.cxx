@@ -0,0 +1,254 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestPVThreadedGlypher.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Glyphs the same points with vtkGlyph3D and with vtkPVThreadedGlypher on
+// several threads, for several glyph settings, and checks that both give
+// exactly the same output.
+
+#include "vtkCellArray.h"
+#include "vtkCellData.h"
+#include "vtkConeSource.h"
+#include "vtkCubeSource.h"
+#include "vtkDataArray.h"
+#include "vtkDoubleArray.h"
+#include "vtkFloatArray.h"
+#include "vtkGlyph3D.h"
+#include "vtkIdTypeArray.h"
+#include "vtkLineSource.h"
+#include "vtkMultiThreader.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkPVThreadedGlypher.h"
+#include "vtkSmartPointer.h"
+#include "vtkSphereSource.h"
+#include "vtkTransform.h"
+
+#include <string.h>
+
+#define NUMBER_OF_POINTS 20000
+
+namespace
+{
+  vtkSmartPointer<vtkPolyData> MakeInput()
+  {
+    vtkSmartPointer<vtkPoints> points = vtkSmartPointer<vtkPoints>::New();
+    vtkSmartPointer<vtkFloatArray> scalars =
+      vtkSmartPointer<vtkFloatArray>::New();
+    scalars->SetName("Scalars");
+    vtkSmartPointer<vtkDoubleArray> vectors =
+      vtkSmartPointer<vtkDoubleArray>::New();
+    vectors->SetName("Vectors");
+    vectors->SetNumberOfComponents(3);
+    vtkSmartPointer<vtkFloatArray> normals =
+      vtkSmartPointer<vtkFloatArray>::New();
+    normals->SetName("Normals");
+    normals->SetNumberOfComponents(3);
+    for (int i = 0; i < NUMBER_OF_POINTS; i++)
+      {
+      points->InsertNextPoint(i % 40, (i / 40) % 25, i / 1000);
+      scalars->InsertNextValue(static_cast<float>((i % 17) / 16.0));
+      vectors->InsertNextTuple3(1.0 + i % 3, 0.5 * (i % 5) - 1.0,
+                                0.25 * (i % 7));
+      normals->InsertNextTuple3(i % 2, (i + 1) % 2, 0.5);
+      }
+    vtkSmartPointer<vtkPolyData> input = vtkSmartPointer<vtkPolyData>::New();
+    input->SetPoints(points);
+    input->GetPointData()->SetScalars(scalars);
+    input->GetPointData()->SetVectors(vectors);
+    input->GetPointData()->SetNormals(normals);
+    return input;
+  }
+
+  bool SameArrays(vtkDataSetAttributes* a, vtkDataSetAttributes* b)
+  {
+    if (a->GetNumberOfArrays() != b->GetNumberOfArrays())
+      {
+      return false;
+      }
+    for (int i = 0; i < a->GetNumberOfArrays(); i++)
+      {
+      vtkDataArray* x = a->GetArray(i);
+      vtkDataArray* y = b->GetArray(i);
+      if (!x || !y || x->GetDataType() != y->GetDataType() ||
+          x->GetNumberOfComponents() != y->GetNumberOfComponents() ||
+          x->GetNumberOfTuples() != y->GetNumberOfTuples() ||
+          (x->GetName() == 0) != (y->GetName() == 0) ||
+          (x->GetName() && strcmp(x->GetName(), y->GetName()) != 0))
+        {
+        return false;
+        }
+      for (vtkIdType j = 0; j < x->GetNumberOfTuples(); j++)
+        {
+        for (int k = 0; k < x->GetNumberOfComponents(); k++)
+          {
+          if (x->GetComponent(j, k) != y->GetComponent(j, k))
+            {
+            return false;
+            }
+          }
+        }
+      }
+    int attributes1[vtkDataSetAttributes::NUM_ATTRIBUTES];
+    int attributes2[vtkDataSetAttributes::NUM_ATTRIBUTES];
+    a->GetAttributeIndices(attributes1);
+    b->GetAttributeIndices(attributes2);
+    for (int i = 0; i < vtkDataSetAttributes::NUM_ATTRIBUTES; i++)
+      {
+      if (attributes1[i] != attributes2[i])
+        {
+        return false;
+        }
+      }
+    return true;
+  }
+
+  bool SameCells(vtkCellArray* a, vtkCellArray* b)
+  {
+    if (a->GetNumberOfCells() != b->GetNumberOfCells())
+      {
+      return false;
+      }
+    vtkIdTypeArray* x = a->GetData();
+    vtkIdTypeArray* y = b->GetData();
+    if (x->GetNumberOfTuples() != y->GetNumberOfTuples())
+      {
+      return false;
+      }
+    for (vtkIdType i = 0; i < x->GetNumberOfTuples(); i++)
+      {
+      if (x->GetValue(i) != y->GetValue(i))
+        {
+        return false;
+        }
+      }
+    return true;
+  }
+
+  bool Compare(const char* name, vtkGlyph3D* glyph, vtkPolyData* input,
+               int numberOfChunks)
+  {
+    vtkSmartPointer<vtkPVThreadedGlypher> glypher =
+      vtkSmartPointer<vtkPVThreadedGlypher>::New();
+    glypher->SetMinimumNumberOfPointsPerThread(
+      NUMBER_OF_POINTS / numberOfChunks);
+    if (glypher->GetNumberOfChunks(NUMBER_OF_POINTS) != numberOfChunks)
+      {
+      cerr << "Glyphing " << name << " in "
+           << glypher->GetNumberOfChunks(NUMBER_OF_POINTS)
+           << " chunks instead of " << numberOfChunks << endl;
+      return false;
+      }
+
+    glyph->SetInput(input);
+    glyph->Update();
+    vtkPolyData* expected = glyph->GetOutput();
+    vtkSmartPointer<vtkPolyData> output = vtkSmartPointer<vtkPolyData>::New();
+    if (!glypher->Glyph(glyph, input, output))
+      {
+      cerr << "Could not glyph " << name << endl;
+      return false;
+      }
+
+    bool ok = expected->GetNumberOfPoints() > 0 &&
+      output->GetNumberOfPoints() == expected->GetNumberOfPoints() &&
+      output->GetPoints()->GetDataType() ==
+      expected->GetPoints()->GetDataType();
+    for (vtkIdType i = 0; ok && i < expected->GetNumberOfPoints(); i++)
+      {
+      double x1[3], x2[3];
+      output->GetPoint(i, x1);
+      expected->GetPoint(i, x2);
+      ok = x1[0] == x2[0] && x1[1] == x2[1] && x1[2] == x2[2];
+      }
+    ok = ok && SameCells(output->GetVerts(), expected->GetVerts()) &&
+      SameCells(output->GetLines(), expected->GetLines()) &&
+      SameCells(output->GetPolys(), expected->GetPolys()) &&
+      SameCells(output->GetStrips(), expected->GetStrips()) &&
+      SameArrays(output->GetPointData(), expected->GetPointData()) &&
+      SameArrays(output->GetCellData(), expected->GetCellData());
+    if (!ok)
+      {
+      cerr << "Glyphing " << name << " in " << numberOfChunks
+           << " chunks differs from vtkGlyph3D" << endl;
+      }
+    return ok;
+  }
+}
+
+int main(int, char**)
+{
+  // Use several threads whatever the number of processors.
+  vtkMultiThreader::SetGlobalDefaultNumberOfThreads(4);
+
+  bool ok = true;
+  vtkSmartPointer<vtkPolyData> input = MakeInput();
+
+  vtkSmartPointer<vtkConeSource> cone = vtkSmartPointer<vtkConeSource>::New();
+  cone->Update();
+  vtkSmartPointer<vtkSphereSource> sphere =
+    vtkSmartPointer<vtkSphereSource>::New();
+  sphere->Update();
+  vtkSmartPointer<vtkCubeSource> cube = vtkSmartPointer<vtkCubeSource>::New();
+  cube->Update();
+  vtkSmartPointer<vtkLineSource> line = vtkSmartPointer<vtkLineSource>::New();
+  line->Update();
+
+  // Scaled by scalar and oriented along the vectors.
+  vtkSmartPointer<vtkGlyph3D> glyph = vtkSmartPointer<vtkGlyph3D>::New();
+  glyph->SetSource(cone->GetOutput());
+  glyph->SetScaleModeToScaleByScalar();
+  glyph->SetColorModeToColorByScalar();
+  glyph->SetScaleFactor(0.5);
+  for (int chunks = 1; chunks <= 4; chunks++)
+    {
+    ok = Compare("cones", glyph, input, chunks) && ok;
+    }
+
+  // Scaled by vector, oriented along the normals, with point ids.
+  glyph = vtkSmartPointer<vtkGlyph3D>::New();
+  glyph->SetSource(sphere->GetOutput());
+  glyph->SetScaleModeToScaleByVector();
+  glyph->SetColorModeToColorByVector();
+  glyph->SetVectorModeToUseNormal();
+  glyph->GeneratePointIdsOn();
+  ok = Compare("spheres with point ids", glyph, input, 3) && ok;
+
+  // Lines, scaled by vector components, clamped, with a source transform.
+  vtkSmartPointer<vtkTransform> transform =
+    vtkSmartPointer<vtkTransform>::New();
+  transform->Translate(-0.5, 0.0, 0.0);
+  transform->RotateZ(30.0);
+  glyph = vtkSmartPointer<vtkGlyph3D>::New();
+  glyph->SetSource(line->GetOutput());
+  glyph->SetScaleModeToScaleByVectorComponents();
+  glyph->SetRange(0.0, 2.0);
+  glyph->ClampingOn();
+  glyph->SetSourceTransform(transform);
+  ok = Compare("transformed lines", glyph, input, 4) && ok;
+
+  // Sources picked by scalar, unoriented and unscaled.
+  glyph = vtkSmartPointer<vtkGlyph3D>::New();
+  glyph->SetSource(0, cone->GetOutput());
+  glyph->SetSource(1, sphere->GetOutput());
+  glyph->SetSource(2, cube->GetOutput());
+  glyph->SetIndexModeToScalar();
+  glyph->SetRange(0.0, 1.0);
+  glyph->OrientOff();
+  glyph->ScalingOff();
+  ok = Compare("indexed sources", glyph, input, 2) && ok;
+  ok = Compare("indexed sources", glyph, input, 4) && ok;
+
+  return ok ? 0 : 1;
+}
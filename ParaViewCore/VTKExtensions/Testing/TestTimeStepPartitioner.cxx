@@ -0,0 +1,239 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestTimeStepPartitioner.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Partitions the time steps for every rank of several numbers of processes,
+// groups and time steps, including uneven splits and more groups than time
+// steps, and checks that each time step goes to exactly one group of
+// consecutive ranks, which split it into pieces.
+
+#include "vtkDummyCommunicator.h"
+#include "vtkDummyController.h"
+#include "vtkInformation.h"
+#include "vtkObjectFactory.h"
+#include "vtkSmartPointer.h"
+#include "vtkStreamingDemandDrivenPipeline.h"
+#include "vtkTimeStepPartitioner.h"
+
+#include <vtkstd/vector>
+
+// Pretends to be any process of any number of processes.
+class vtkTestPartitionCommunicator : public vtkDummyCommunicator
+{
+public:
+  static vtkTestPartitionCommunicator* New();
+  vtkTypeMacro(vtkTestPartitionCommunicator, vtkDummyCommunicator);
+
+  void SetProcess(int rank, int numProcs)
+    {
+    this->LocalProcessId = rank;
+    this->NumberOfProcesses = numProcs;
+    }
+
+protected:
+  vtkTestPartitionCommunicator() {}
+  ~vtkTestPartitionCommunicator() {}
+};
+
+vtkStandardNewMacro(vtkTestPartitionCommunicator);
+
+namespace
+{
+  struct Partition
+  {
+    int Groups;
+    int Group;
+    int FirstTimeStep;
+    int EndTimeStep;
+    int Piece;
+    int NumberOfPieces;
+  };
+
+  int Min(int a, int b)
+  {
+    return a < b ? a : b;
+  }
+
+  bool Check(int numProcs, int numGroups, int numSteps,
+             const vtkstd::vector<Partition>& partitions)
+  {
+    int groups = Min(Min(numGroups, numProcs), numSteps > 1 ? numSteps : 1);
+    vtkstd::vector<int> stepGroups(numSteps, -1);
+    int smallest = numSteps;
+    int largest = 0;
+    for (int rank = 0; rank < numProcs; rank++)
+      {
+      const Partition& p = partitions[rank];
+      bool ok = p.Groups == groups &&
+        p.Group >= 0 && p.Group < groups &&
+        p.Piece >= 0 && p.Piece < p.NumberOfPieces && p.Piece <= rank;
+      // The pieces of a group are consecutive ranks, the groups are in order.
+      const Partition& first = partitions[ok ? rank - p.Piece : rank];
+      ok = ok && first.Piece == 0 && first.Group == p.Group &&
+        first.NumberOfPieces == p.NumberOfPieces &&
+        first.FirstTimeStep == p.FirstTimeStep &&
+        first.EndTimeStep == p.EndTimeStep &&
+        (rank == 0 ? p.Group == 0 :
+         (p.Piece > 0 ? partitions[rank - 1].Group == p.Group :
+          partitions[rank - 1].Group == p.Group - 1 &&
+          partitions[rank - 1].Piece ==
+          partitions[rank - 1].NumberOfPieces - 1));
+      ok = ok && p.FirstTimeStep >= 0 && p.FirstTimeStep <= p.EndTimeStep &&
+        p.EndTimeStep <= numSteps;
+      if (ok && p.Piece == 0)
+        {
+        for (int step = p.FirstTimeStep; step < p.EndTimeStep; step++)
+          {
+          ok = ok && stepGroups[step] == -1;
+          stepGroups[step] = p.Group;
+          }
+        smallest = Min(smallest, p.EndTimeStep - p.FirstTimeStep);
+        largest = largest > p.EndTimeStep - p.FirstTimeStep ?
+          largest : p.EndTimeStep - p.FirstTimeStep;
+        }
+      if (rank == numProcs - 1)
+        {
+        ok = ok && p.Group == groups - 1 &&
+          p.Piece == p.NumberOfPieces - 1;
+        }
+      if (!ok)
+        {
+        cerr << "Wrong partition for rank " << rank << " of " << numProcs
+             << " with " << numGroups << " groups and " << numSteps
+             << " time steps: group " << p.Group << " of " << p.Groups
+             << ", piece " << p.Piece << " of " << p.NumberOfPieces
+             << ", time steps [" << p.FirstTimeStep << ", "
+             << p.EndTimeStep << ")" << endl;
+        return false;
+        }
+      }
+
+    // Every time step is read once, and the groups get as many as possible.
+    for (int step = 0; step < numSteps; step++)
+      {
+      if (stepGroups[step] == -1)
+        {
+        cerr << "Time step " << step << " of " << numSteps
+             << " is not read by any of the " << numGroups << " groups of "
+             << numProcs << " processes" << endl;
+        return false;
+        }
+      }
+    if (numSteps > 0 && (smallest == 0 || largest - smallest > 1))
+      {
+      cerr << "Uneven split of " << numSteps << " time steps among "
+           << groups << " groups of " << numProcs << " processes" << endl;
+      return false;
+      }
+    return true;
+  }
+
+  vtkstd::vector<Partition> PartitionAll(vtkTimeStepPartitioner* partitioner,
+                                         vtkTestPartitionCommunicator* comm,
+                                         int numProcs, int numGroups,
+                                         int numSteps)
+  {
+    vtkstd::vector<Partition> partitions(numProcs);
+    partitioner->SetNumberOfGroups(numGroups);
+    for (int rank = 0; rank < numProcs; rank++)
+      {
+      comm->SetProcess(rank, numProcs);
+      partitioner->Partition(numSteps);
+      Partition& p = partitions[rank];
+      p.Groups = partitioner->GetNumberOfGroupsUsed();
+      p.Group = partitioner->GetGroup();
+      p.FirstTimeStep = partitioner->GetFirstTimeStep();
+      p.EndTimeStep = partitioner->GetEndTimeStep();
+      p.Piece = partitioner->GetPiece();
+      p.NumberOfPieces = partitioner->GetNumberOfPieces();
+      }
+    return partitions;
+  }
+
+  bool Expect(const char* name, const Partition& p, int group, int first,
+              int end, int piece, int numPieces)
+  {
+    if (p.Group != group || p.FirstTimeStep != first ||
+        p.EndTimeStep != end || p.Piece != piece ||
+        p.NumberOfPieces != numPieces)
+      {
+      cerr << "Wrong partition " << name << ": group " << p.Group
+           << ", time steps [" << p.FirstTimeStep << ", " << p.EndTimeStep
+           << "), piece " << p.Piece << " of " << p.NumberOfPieces << endl;
+      return false;
+      }
+    return true;
+  }
+}
+
+int main(int, char**)
+{
+  vtkSmartPointer<vtkTestPartitionCommunicator> comm =
+    vtkSmartPointer<vtkTestPartitionCommunicator>::New();
+  vtkSmartPointer<vtkDummyController> controller =
+    vtkSmartPointer<vtkDummyController>::New();
+  controller->SetCommunicator(comm);
+  vtkSmartPointer<vtkTimeStepPartitioner> partitioner =
+    vtkSmartPointer<vtkTimeStepPartitioner>::New();
+  partitioner->SetController(controller);
+
+  bool ok = true;
+  for (int numProcs = 1; numProcs <= 9; numProcs++)
+    {
+    for (int numGroups = 1; numGroups <= 12; numGroups++)
+      {
+      for (int numSteps = 0; numSteps <= 11; numSteps++)
+        {
+        ok = Check(numProcs, numGroups, numSteps,
+                   PartitionAll(partitioner, comm, numProcs, numGroups,
+                                numSteps)) && ok;
+        }
+      }
+    }
+
+  // 5 time steps for 2 groups of 2 processes.
+  vtkstd::vector<Partition> partitions =
+    PartitionAll(partitioner, comm, 4, 2, 5);
+  ok = Expect("of rank 0 for an uneven split", partitions[0], 0, 0, 2, 0, 2)
+    && ok;
+  ok = Expect("of rank 3 for an uneven split", partitions[3], 1, 2, 5, 1, 2)
+    && ok;
+
+  // 2 time steps for 4 groups: only 2 groups are used.
+  partitions = PartitionAll(partitioner, comm, 5, 4, 2);
+  ok = Expect("of rank 1 for more groups than time steps", partitions[1],
+              0, 0, 1, 1, 3) && ok;
+  ok = Expect("of rank 4 for more groups than time steps", partitions[4],
+              1, 1, 2, 1, 2) && ok;
+
+  // The time step and the piece of the group are requested.
+  double times[5] = { 0.0, 0.5, 1.0, 1.5, 2.0 };
+  vtkSmartPointer<vtkInformation> info = vtkSmartPointer<vtkInformation>::New();
+  info->Set(vtkStreamingDemandDrivenPipeline::TIME_STEPS(), times, 5);
+  comm->SetProcess(3, 4);
+  partitioner->SetNumberOfGroups(2);
+  partitioner->Partition(5);
+  partitioner->RequestTimeStep(info, partitioner->GetFirstTimeStep());
+  double* time = info->Get(
+    vtkStreamingDemandDrivenPipeline::UPDATE_TIME_STEPS());
+  if (!time || time[0] != 1.0 ||
+      info->Get(vtkStreamingDemandDrivenPipeline::UPDATE_PIECE_NUMBER()) != 1 ||
+      info->Get(
+        vtkStreamingDemandDrivenPipeline::UPDATE_NUMBER_OF_PIECES()) != 2)
+    {
+    cerr << "Wrong time step or piece requested" << endl;
+    ok = false;
+    }
+
+  return ok ? 0 : 1;
+}
@@ -23,6 +23,7 @@
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include "vtkMultiProcessController.h"
+#include "vtkMultiThreader.h"
 #include "vtkObject.h"
 #include "vtkObjectFactory.h"
 // PV interface
@@ -46,6 +47,8 @@
 #include "vtkIntArray.h"
 #include "vtkUnsignedCharArray.h"
 #include "vtkUnsignedCharArray.h"
+#include "vtkPoints.h"
+#include "vtkSmartPointer.h"
 #include <math.h>
 #include <ctime>
 
@@ -1335,6 +1338,70 @@ void vtkAMRDualClipLocator::ShareBlockLocatorWithNeighbor(
 
 
 
+//============================================================================
+// The state of one thread.  A worker clips a contiguous range of the local
+// blocks into its own mesh, with its own locator.
+class vtkAMRDualClipWorker
+{
+public:
+  vtkAMRDualClipWorker();
+  ~vtkAMRDualClipWorker();
+
+  vtkAMRDualClip* Filter;
+  const char* ArrayName;
+
+  // The blocks of this worker and their index in their level.
+  vtkstd::vector<vtkAMRDualGridHelperBlock*> Blocks;
+  vtkstd::vector<int> BlockIds;
+
+  vtkUnstructuredGrid* Mesh;
+  vtkPoints* Points;
+  vtkCellArray* Cells;
+  // For debugging.
+  vtkIntArray* BlockIdCellArray;
+  vtkUnsignedCharArray* LevelMaskPointArray;
+
+  // Locator of the block being processed.
+  vtkAMRDualClipLocator* BlockLocator;
+  // Reused for every block when points are not merged.
+  vtkAMRDualClipLocator* SharedLocator;
+
+private:
+  vtkAMRDualClipWorker(const vtkAMRDualClipWorker&);  // Not implemented.
+  void operator=(const vtkAMRDualClipWorker&);  // Not implemented.
+};
+
+//----------------------------------------------------------------------------
+vtkAMRDualClipWorker::vtkAMRDualClipWorker()
+{
+  this->Filter = 0;
+  this->ArrayName = 0;
+  this->Mesh = vtkUnstructuredGrid::New();
+  this->Points = vtkPoints::New();
+  this->Cells = vtkCellArray::New();
+  this->Mesh->SetPoints(this->Points);
+  this->BlockIdCellArray = vtkIntArray::New();
+  this->BlockIdCellArray->SetName("BlockIds");
+  this->Mesh->GetCellData()->AddArray(this->BlockIdCellArray);
+  this->LevelMaskPointArray = vtkUnsignedCharArray::New();
+  this->LevelMaskPointArray->SetName("LevelMask");
+  this->Mesh->GetPointData()->AddArray(this->LevelMaskPointArray);
+  this->BlockLocator = 0;
+  this->SharedLocator = 0;
+}
+
+//----------------------------------------------------------------------------
+vtkAMRDualClipWorker::~vtkAMRDualClipWorker()
+{
+  delete this->SharedLocator;
+  this->LevelMaskPointArray->Delete();
+  this->BlockIdCellArray->Delete();
+  this->Cells->Delete();
+  this->Points->Delete();
+  this->Mesh->Delete();
+}
+
+
 
 
 
@@ -1360,21 +1427,12 @@ vtkAMRDualClip::vtkAMRDualClip()
   // Pipeline
   this->SetNumberOfOutputPorts(1);
 
-  this->LevelMaskPointArray = 0;
-  this->BlockIdCellArray = 0;
   this->Helper = 0;
-
-  this->BlockLocator = 0;
 }
 
 //----------------------------------------------------------------------------
 vtkAMRDualClip::~vtkAMRDualClip()
 {
-  if (this->BlockLocator)
-    {
-    delete this->BlockLocator;
-    this->BlockLocator = 0;
-    }
   this->SetController(NULL);
 }
 
@@ -1521,53 +1579,68 @@ vtkAMRDualClip::DoRequestData(vtkHierarchicalBoxDataSet* hbdsInput,
     this->DistributeLevelMasks();
     }
 
-  vtkUnstructuredGrid* mesh = vtkUnstructuredGrid::New();
-  this->Points = vtkPoints::New();
-  this->Cells = vtkCellArray::New();
-  mesh->SetPoints(this->Points);
-  mpds->SetPiece(0, mesh);
-
-
-  this->BlockIdCellArray = vtkIntArray::New();
-  this->BlockIdCellArray->SetName("BlockIds");
-  mesh->GetCellData()->AddArray(this->BlockIdCellArray);
-
-  this->LevelMaskPointArray = vtkUnsignedCharArray::New();
-  this->LevelMaskPointArray->SetName("LevelMask");
-  mesh->GetPointData()->AddArray(this->LevelMaskPointArray);
-
-  this->Mesh = mesh;
-  this->InitializeCopyAttributes(hbdsInput, this->Mesh);
-
-  // Loop through blocks
+  // The local blocks in level order.
+  vtkstd::vector<vtkAMRDualGridHelperBlock*> blocks;
+  vtkstd::vector<int> blockIds;
   int numLevels = hbdsInput->GetNumberOfLevels();
-  int numBlocks;
-  int blockId;
-
-  // Add each block.
   for (int level = 0; level < numLevels; ++level)
     {
-    numBlocks = this->Helper->GetNumberOfBlocksInLevel(level);
-    for (blockId = 0; blockId < numBlocks; ++blockId)
+    int numBlocks = this->Helper->GetNumberOfBlocksInLevel(level);
+    for (int blockId = 0; blockId < numBlocks; ++blockId)
       {
       vtkAMRDualGridHelperBlock* block = this->Helper->GetBlock(level, blockId);
-      this->ProcessBlock(block, blockId, arrayNameToProcess);
+      if (block->Image == 0)
+        { // Remote blocks are only to setup local block bit flags.
+        continue;
+        }
+      blocks.push_back(block);
+      blockIds.push_back(blockId);
       }
     }
 
-  this->BlockIdCellArray->Delete();
-  this->BlockIdCellArray = 0;
-  this->LevelMaskPointArray->Delete();
-  this->LevelMaskPointArray = 0;
+  // The blocks are split into contiguous ranges, one per thread.  Merging
+  // points shares locators and level masks from block to block in order,
+  // so it runs in a single thread.
+  int numberOfBlocks = static_cast<int>(blocks.size());
+  int numberOfWorkers = 1;
+  if (!this->EnableMergePoints)
+    {
+    vtkSmartPointer<vtkMultiThreader> threader
+      = vtkSmartPointer<vtkMultiThreader>::New();
+    numberOfWorkers = threader->GetNumberOfThreads();
+    if (numberOfWorkers > numberOfBlocks)
+      {
+      numberOfWorkers = numberOfBlocks > 1 ? numberOfBlocks : 1;
+      }
+    }
 
-  mesh->SetCells(VTK_TETRA,this->Cells);
+  vtkstd::vector<vtkAMRDualClipWorker*> workers(numberOfWorkers);
+  int workerId;
+  for (workerId = 0; workerId < numberOfWorkers; ++workerId)
+    {
+    vtkAMRDualClipWorker* worker = new vtkAMRDualClipWorker;
+    worker->Filter = this;
+    worker->ArrayName = arrayNameToProcess;
+    int first = workerId*numberOfBlocks/numberOfWorkers;
+    int last = (workerId+1)*numberOfBlocks/numberOfWorkers;
+    worker->Blocks.assign(blocks.begin() + first, blocks.begin() + last);
+    worker->BlockIds.assign(blockIds.begin() + first, blockIds.begin() + last);
+    this->InitializeCopyAttributes(hbdsInput, worker->Mesh);
+    workers[workerId] = worker;
+    }
 
-  mesh->Delete();
-  this->Mesh = 0;
-  this->Points->Delete();
-  this->Points = 0;
-  this->Cells->Delete();
-  this->Cells = 0;
+  this->RunWorkers(&workers[0], numberOfWorkers);
+
+  // The first worker holds the output.
+  this->MergeWorkers(workers);
+  vtkUnstructuredGrid* mesh = workers[0]->Mesh;
+  mesh->SetCells(VTK_TETRA, workers[0]->Cells);
+  mpds->SetPiece(0, mesh);
+
+  for (workerId = 0; workerId < numberOfWorkers; ++workerId)
+    {
+    delete workers[workerId];
+    }
 
   mpds->Delete();
   this->Helper->Delete();
@@ -1806,7 +1879,8 @@ void vtkAMRDualClip::ShareLevelMask(vtkAMRDualGridHelperBlock* block)
 
 
 //----------------------------------------------------------------------------
-void vtkAMRDualClip::ProcessBlock(vtkAMRDualGridHelperBlock* block,
+void vtkAMRDualClip::ProcessBlock(vtkAMRDualClipWorker* worker,
+                                  vtkAMRDualGridHelperBlock* block,
                                   int blockId, const char* arrayNameToProcess)
 {
   vtkImageData* image = block->Image;
@@ -1841,16 +1915,17 @@ void vtkAMRDualClip::ProcessBlock(vtkAMRDualGridHelperBlock* block,
   if (this->EnableMergePoints)
     {
     this->InitializeLevelMask(block);
-    this->BlockLocator = vtkAMRDualClipGetBlockLocator(block);
+    worker->BlockLocator = vtkAMRDualClipGetBlockLocator(block);
     }
   else
     { // Shared locator.
-    if (this->BlockLocator == 0)
+    if (worker->SharedLocator == 0)
       {
-      this->BlockLocator = new vtkAMRDualClipLocator;
+      worker->SharedLocator = new vtkAMRDualClipLocator;
       }
-    this->BlockLocator->Initialize(extent[1]-extent[0], extent[3]-extent[2], extent[5]-extent[4]);
-    //this->BlockLocator->CopyRegionLevelDifferences(block);
+    worker->BlockLocator = worker->SharedLocator;
+    worker->BlockLocator->Initialize(extent[1]-extent[0], extent[3]-extent[2], extent[5]-extent[4]);
+    //worker->BlockLocator->CopyRegionLevelDifferences(block);
     }
   image->GetOrigin(origin);
   spacing = image->GetSpacing();
@@ -1914,7 +1989,7 @@ void vtkAMRDualClip::ProcessBlock(vtkAMRDualGridHelperBlock* block,
           cornerOffsets[5] = xOffset+1+zInc;
           cornerOffsets[6] = xOffset+yInc+zInc;
           cornerOffsets[7] = xOffset+1+yInc+zInc;
-          this->ProcessDualCell(block, blockId, x, y, z,
+          this->ProcessDualCell(worker, block, blockId, x, y, z,
                                 cornerOffsets, volumeFractionArray);
           }
         xOffset += 1; // xInc
@@ -1930,8 +2005,7 @@ void vtkAMRDualClip::ProcessBlock(vtkAMRDualGridHelperBlock* block,
     // Copy point ids into neighbor locators.
     this->ShareBlockLocatorWithNeighbors(block);
     // We are done.  We no longer need the locator for this block.
-    delete this->BlockLocator;
-    this->BlockLocator = 0;
+    delete worker->BlockLocator;
     block->UserData = 0;
     // Lets use this unused flag (owner of center region/block) to indicate
     // that the block is already processes.
@@ -1941,6 +2015,90 @@ void vtkAMRDualClip::ProcessBlock(vtkAMRDualGridHelperBlock* block,
     // would tell whether the block was processed.
     block->RegionBits[1][1][1] = 0;
     }
+  worker->BlockLocator = 0;
+}
+
+//----------------------------------------------------------------------------
+// Run the workers, each in its own thread.
+void vtkAMRDualClip::RunWorkers(vtkAMRDualClipWorker** workers,
+                                int numberOfWorkers)
+{
+  if (numberOfWorkers == 1)
+    {
+    vtkAMRDualClip::ProcessBlocks(workers[0]);
+    }
+  else if (numberOfWorkers > 1)
+    {
+    vtkSmartPointer<vtkMultiThreader> threader
+      = vtkSmartPointer<vtkMultiThreader>::New();
+    threader->SetNumberOfThreads(numberOfWorkers);
+    threader->SetSingleMethod(vtkAMRDualClip::ProcessBlocksThread, workers);
+    threader->SingleMethodExecute();
+    }
+}
+
+//----------------------------------------------------------------------------
+VTK_THREAD_RETURN_TYPE vtkAMRDualClip::ProcessBlocksThread(void* arg)
+{
+  vtkMultiThreader::ThreadInfo* info
+    = static_cast<vtkMultiThreader::ThreadInfo*>(arg);
+  vtkAMRDualClip::ProcessBlocks(
+    static_cast<vtkAMRDualClipWorker**>(info->UserData)[info->ThreadID]);
+  return VTK_THREAD_RETURN_VALUE;
+}
+
+//----------------------------------------------------------------------------
+void vtkAMRDualClip::ProcessBlocks(vtkAMRDualClipWorker* worker)
+{
+  for (size_t ii = 0; ii < worker->Blocks.size(); ++ii)
+    {
+    worker->Filter->ProcessBlock(worker, worker->Blocks[ii],
+                                 worker->BlockIds[ii], worker->ArrayName);
+    }
+}
+
+//----------------------------------------------------------------------------
+// Append the meshes of the other workers to the mesh of the first one, in
+// order.  Points are not merged between blocks in threaded runs, so the
+// result is the same as with a single thread.
+void vtkAMRDualClip::MergeWorkers(vtkstd::vector<vtkAMRDualClipWorker*>& workers)
+{
+  vtkAMRDualClipWorker* first = workers[0];
+  vtkPointData* outPD = first->Mesh->GetPointData();
+  int numArrays = outPD->GetNumberOfArrays();
+  for (size_t workerId = 1; workerId < workers.size(); ++workerId)
+    {
+    vtkAMRDualClipWorker* worker = workers[workerId];
+    vtkPointData* inPD = worker->Mesh->GetPointData();
+    // Both meshes have the same point arrays, in the same order.
+    vtkIdType offset = first->Points->GetNumberOfPoints();
+    vtkIdType numPts = worker->Points->GetNumberOfPoints();
+    for (vtkIdType ptId = 0; ptId < numPts; ++ptId)
+      {
+      first->Points->InsertNextPoint(worker->Points->GetPoint(ptId));
+      for (int arrayIdx = 0; arrayIdx < numArrays; ++arrayIdx)
+        {
+        outPD->GetAbstractArray(arrayIdx)->InsertTuple(
+          offset + ptId, ptId, inPD->GetAbstractArray(arrayIdx));
+        }
+      }
+
+    vtkIdType npts;
+    vtkIdType* pts;
+    vtkIdType cellIds[4];
+    vtkIdType cellId = 0;
+    vtkCellArray* cells = worker->Cells;
+    for (cells->InitTraversal(); cells->GetNextCell(npts, pts); ++cellId)
+      {
+      for (vtkIdType jj = 0; jj < npts; ++jj)
+        {
+        cellIds[jj] = offset + pts[jj];
+        }
+      first->Cells->InsertNextCell(npts, cellIds);
+      first->BlockIdCellArray->InsertNextValue(
+        worker->BlockIdCellArray->GetValue(cellId));
+      }
+    }
 }
 
 
@@ -1957,6 +2115,7 @@ void vtkAMRDualClip::ProcessBlock(vtkAMRDualGridHelperBlock* block,
 // Not implemented as optimally as we could.  It can be improved by making
 // a fast path for internal cells (with no degeneracies).
 void vtkAMRDualClip::ProcessDualCell(
+  vtkAMRDualClipWorker* worker,
   vtkAMRDualGridHelperBlock* block, int blockId,
   int x, int y, int z,
   vtkIdType cornerOffsets[8],
@@ -2195,8 +2354,8 @@ void vtkAMRDualClip::ProcessDualCell(
       // convert from VTK corner ids to bit (x,y,z) corner ids.
       if (casePtId < 8)
         { // Corner (internal point)
-        ptIdPtr = this->BlockLocator->GetCornerPointer(x,y,z,casePtId, block->OriginIndex);
-        levelMaskValue = this->BlockLocator->GetLevelMaskValue(x+((casePtId&1)?1:0),
+        ptIdPtr = worker->BlockLocator->GetCornerPointer(x,y,z,casePtId, block->OriginIndex);
+        levelMaskValue = worker->BlockLocator->GetLevelMaskValue(x+((casePtId&1)?1:0),
                                                                y+((casePtId&2)?1:0),
                                                                z+((casePtId&4)?1:0));
         if (levelMaskValue == 0) 
@@ -2231,7 +2390,7 @@ void vtkAMRDualClip::ProcessDualCell(
           pt[0] = origin[0] + spacing[0] * (double)(1 << levelDiff) * ((double)(px)+dx);
           pt[1] = origin[1] + spacing[1] * (double)(1 << levelDiff) * ((double)(py)+dy);
           pt[2] = origin[2] + spacing[2] * (double)(1 << levelDiff) * ((double)(pz)+dz);
-          *ptIdPtr = this->Points->InsertNextPoint(pt);
+          *ptIdPtr = worker->Points->InsertNextPoint(pt);
           if (pt[1] > 100000.0)
             {
             cerr << "bug\n";
@@ -2243,14 +2402,14 @@ void vtkAMRDualClip::ProcessDualCell(
           // lower level cell bounds, but that would be too dificult.  Just pick one.
           // Averaging could be a pre processing step but we would have to modify input attributes .......
           vtkIdType offset = cornerOffsets[casePtId];
-          this->Mesh->GetPointData()->CopyData(block->Image->GetCellData(),offset, *ptIdPtr);
+          worker->Mesh->GetPointData()->CopyData(block->Image->GetCellData(),offset, *ptIdPtr);
 
-          this->LevelMaskPointArray->InsertNextValue(levelMaskValue);
+          worker->LevelMaskPointArray->InsertNextValue(levelMaskValue);
           }
         }
       else
         { // Edge (clipped cell, point on iso surface)
-        ptIdPtr = this->BlockLocator->GetEdgePointer(x,y,z,casePtId-8);
+        ptIdPtr = worker->BlockLocator->GetEdgePointer(x,y,z,casePtId-8);
         if (*ptIdPtr == -1)
           {
           int edge = casePtId - 8;
@@ -2265,7 +2424,7 @@ void vtkAMRDualClip::ProcessDualCell(
           pt[0] = cornerPoints[pt1Idx] + k*(cornerPoints[pt2Idx]-cornerPoints[pt1Idx]);
           pt[1] = cornerPoints[pt1Idx|1] + k*(cornerPoints[pt2Idx|1]-cornerPoints[pt1Idx|1]);
           pt[2] = cornerPoints[pt1Idx|2] + k*(cornerPoints[pt2Idx|2]-cornerPoints[pt1Idx|2]);
-          *ptIdPtr = this->Points->InsertNextPoint(pt);
+          *ptIdPtr = worker->Points->InsertNextPoint(pt);
           if (pt[1] > 100000.0)
             {
             cerr << "bug\n";
@@ -2275,9 +2434,9 @@ void vtkAMRDualClip::ProcessDualCell(
           // Find the offsets of the two attributes to interpolate
           vtkIdType offset0 = cornerOffsets[pt1Idx>>2];
           vtkIdType offset1 = cornerOffsets[pt2Idx>>2];
-          this->Mesh->GetPointData()->InterpolateEdge(block->Image->GetCellData(),*ptIdPtr,offset0,offset1,k);
+          worker->Mesh->GetPointData()->InterpolateEdge(block->Image->GetCellData(),*ptIdPtr,offset0,offset1,k);
 
-          this->LevelMaskPointArray->InsertNextValue(levelMaskValue);
+          worker->LevelMaskPointArray->InsertNextValue(levelMaskValue);
           }
         }
       pointIds[ii] = *ptIdPtr;
@@ -2285,8 +2444,8 @@ void vtkAMRDualClip::ProcessDualCell(
     if (pointIds[0]!=pointIds[1] && pointIds[0]!=pointIds[2] && pointIds[0]!=pointIds[3] &&
         pointIds[1]!=pointIds[2] && pointIds[1]!=pointIds[3] && pointIds[2]!=pointIds[3] )
       {
-      this->Cells->InsertNextCell(4, pointIds);
-      this->BlockIdCellArray->InsertNextValue(blockId);
+      worker->Cells->InsertNextCell(4, pointIds);
+      worker->BlockIdCellArray->InsertNextValue(blockId);
       }
     }
 }
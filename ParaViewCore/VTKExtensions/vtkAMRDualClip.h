@@ -19,11 +19,21 @@
 // transitions are handled correctly, and second is that interal
 // cells are decimated.  I use a variation of degenerate points/cells
 // used for level transitions.
+//
+// When points are not merged, the local blocks are clipped by as many
+// threads as vtkMultiThreader provides, each with its own mesh and locator.
+// The meshes are appended in block order, so the output does not depend on
+// the number of threads.  When points are merged, the locators are passed
+// from block to block in order and the blocks are clipped on one thread.
+// Unlike vtkAMRDualContour, the ghost values are always exchanged before
+// any block is clipped, because DistributeLevelMasks needs all of them.
 
 #ifndef __vtkAMRDualClip_h
 #define __vtkAMRDualClip_h
 
 #include "vtkMultiBlockDataSetAlgorithm.h"
+#include "vtkMultiThreader.h" // needed for VTK_THREAD_RETURN_TYPE
+#include <vtkstd/vector>
 
 class vtkDataSet;
 class vtkImageData;
@@ -43,6 +53,7 @@ class vtkAMRDualGridHelper;
 class vtkAMRDualGridHelperBlock;
 class vtkAMRDualGridHelperFace;
 class vtkAMRDualClipLocator;
+class vtkAMRDualClipWorker;
 
 
 class VTK_EXPORT vtkAMRDualClip : public vtkMultiBlockDataSetAlgorithm
@@ -71,7 +82,8 @@ public:
   // Description:
   // This flag causes blocks to share locators so there are no
   // boundary edges between blocks. It does not eliminate
-  // boundary edges between processes.
+  // boundary edges between processes.  Off by default; when on, the blocks
+  // are clipped on one thread.
   vtkSetMacro(EnableMergePoints,int);
   vtkGetMacro(EnableMergePoints,int);
   vtkBooleanMacro(EnableMergePoints,int);
@@ -92,9 +104,6 @@ protected:
   int EnableMultiProcessCommunication;
   int EnableMergePoints;
 
-  // Needed for copying cell data to point data.
-  vtkUnstructuredGrid* Mesh;
-
   //BTX
   virtual int RequestData(vtkInformation *, vtkInformationVector **, vtkInformationVector *);
 
@@ -112,10 +121,22 @@ protected:
   void ShareBlockLocatorWithNeighbors(
     vtkAMRDualGridHelperBlock* block);
 
-  void ProcessBlock(vtkAMRDualGridHelperBlock* block, int blockId,
+  // Description:
+  // Clip the blocks of the workers, each worker in its own thread.
+  void RunWorkers(vtkAMRDualClipWorker** workers, int numberOfWorkers);
+  static VTK_THREAD_RETURN_TYPE ProcessBlocksThread(void* arg);
+  static void ProcessBlocks(vtkAMRDualClipWorker* worker);
+
+  // Description:
+  // Append the meshes of all the workers to the mesh of the first one.
+  void MergeWorkers(vtkstd::vector<vtkAMRDualClipWorker*>& workers);
+
+  void ProcessBlock(vtkAMRDualClipWorker* worker,
+                    vtkAMRDualGridHelperBlock* block, int blockId,
                     const char* arrayName);
 
   void ProcessDualCell(
+    vtkAMRDualClipWorker* worker,
     vtkAMRDualGridHelperBlock* block, int blockId,
     int x, int y, int z,
     vtkIdType cornerOffsets[8],
@@ -130,14 +151,8 @@ protected:
   //void MirrorCases();
   //void AddGlyph(double x, double y, double z);
 
-  // Stuff exclusively for debugging.
-  vtkIntArray* BlockIdCellArray;
-  vtkUnsignedCharArray* LevelMaskPointArray;
-
   // Ivars used to reduce method parrameters.
   vtkAMRDualGridHelper* Helper;
-  vtkPoints* Points;
-  vtkCellArray* Cells;
 
   vtkMultiProcessController *Controller;
 
@@ -146,8 +161,6 @@ protected:
   int* MessageBuffer;
   int* MessageBufferLength;
 
-  vtkAMRDualClipLocator* BlockLocator;
-
 private:
   vtkAMRDualClip(const vtkAMRDualClip&);  // Not implemented.
   void operator=(const vtkAMRDualClip&);  // Not implemented.
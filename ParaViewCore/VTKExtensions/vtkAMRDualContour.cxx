@@ -14,6 +14,7 @@
 =========================================================================*/
 #include "vtkAMRDualContour.h"
 #include "vtkAMRDualGridHelper.h"
+#include "vtkstd/map"
 #include "vtkstd/vector"
 
 // Pipeline & VTK
@@ -22,6 +23,7 @@
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include "vtkMultiProcessController.h"
+#include "vtkMultiThreader.h"
 #include "vtkObject.h"
 #include "vtkObjectFactory.h"
 // PV interface
@@ -43,6 +45,9 @@
 #include "vtkMultiPieceDataSet.h"
 #include "vtkAMRBox.h"
 #include "vtkCellArray.h"
+#include "vtkIntArray.h"
+#include "vtkPoints.h"
+#include "vtkSmartPointer.h"
 #include "vtkUnsignedCharArray.h"
 #include <math.h>
 #include <ctime>
@@ -96,6 +101,16 @@ public:
   // 0:(000) 1:(100) 2:(010) 3:(110) 4:(001) 5:(101)....
   vtkIdType* GetCornerPointer(int xCell, int yCell, int zCell, int cornerIdx);
 
+  // Description:
+  // The point id stored at an offset of the x, y or z edges (kind 0, 1, 2)
+  // or of the corners (kind 3).
+  vtkIdType* GetSlotPointer(int kind, int offset)
+    {
+    vtkIdType* slots[4] = { this->XEdges, this->YEdges, this->ZEdges,
+                            this->Corners };
+    return slots[kind] + offset;
+    }
+
   // Description:
   // To handle degenerate cells, indicate the level difference between the block
   // and region neighbor.
@@ -411,13 +426,37 @@ vtkAMRDualContourEdgeLocator* vtkAMRDualContourGetBlockLocator(
 }
 
 //----------------------------------------------------------------------------
-// This version works with higher level neighbor blocks.
-void vtkAMRDualContourEdgeLocator::ShareBlockLocatorWithNeighbor(
+// Dual cell dimensions of a block, with ghost layers.  This is the size of
+// its locator.
+static void vtkAMRDualContourGetDualCellDimensions(
+  vtkAMRDualGridHelperBlock* block, int dims[3])
+{
+  int extent[6];
+  block->Image->GetExtent(extent);
+  dims[0] = extent[1]-extent[0]-1;
+  dims[1] = extent[3]-extent[2]-1;
+  dims[2] = extent[5]-extent[4]-1;
+}
+
+//----------------------------------------------------------------------------
+// Call the functor with the locator offsets of every slot that a block
+// passes to a neighbor of the same or a higher level: first the offset in
+// the block, then the offset in the neighbor.  Only the images of the blocks
+// are used, so this works when their locators do not exist.
+template <class TSlotFunctor>
+void vtkAMRDualContourVisitSharedSlots(
   vtkAMRDualGridHelperBlock* block,
-  vtkAMRDualGridHelperBlock* neighbor)
+  vtkAMRDualGridHelperBlock* neighbor,
+  TSlotFunctor& functor)
 {
-  vtkAMRDualContourEdgeLocator* blockLocator = vtkAMRDualContourGetBlockLocator(block);
-  vtkAMRDualContourEdgeLocator* neighborLocator = vtkAMRDualContourGetBlockLocator(neighbor);
+  int blockDims[3];
+  int neighborDims[3];
+  vtkAMRDualContourGetDualCellDimensions(block, blockDims);
+  vtkAMRDualContourGetDualCellDimensions(neighbor, neighborDims);
+  int blockYIncrement = blockDims[0]+1;
+  int blockZIncrement = blockYIncrement * (blockDims[1]+1);
+  int neighborYIncrement = neighborDims[0]+1;
+  int neighborZIncrement = neighborYIncrement * (neighborDims[1]+1);
 
   // Compute the extent of the locator to copy.
   // Moving too many will not hurt, so do not worry about which block owns the region.
@@ -426,11 +465,11 @@ void vtkAMRDualContourEdgeLocator::ShareBlockLocatorWithNeighbor(
   
   // Copy all possible overlap.
   ext[0] = 0;
-  ext[1] = neighborLocator->DualCellDimensions[0];
+  ext[1] = neighborDims[0];
   ext[2] = 0;
-  ext[3] = neighborLocator->DualCellDimensions[1];
+  ext[3] = neighborDims[1];
   ext[4] = 0;
-  ext[5] = neighborLocator->DualCellDimensions[2];
+  ext[5] = neighborDims[2];
 
   // Now we need to convert the receiving low level block extent to the
   // source high level block extent.
@@ -451,22 +490,21 @@ void vtkAMRDualContourEdgeLocator::ShareBlockLocatorWithNeighbor(
   ext[5] = (ext[5] >> levelDiff) - block->OriginIndex[2];
   // Intersect with in (source) low level block.
   if (ext[0] < 0) { ext[0] = 0; }
-  if (ext[0] > blockLocator->DualCellDimensions[0]) { ext[0] = blockLocator->DualCellDimensions[0]; }
+  if (ext[0] > blockDims[0]) { ext[0] = blockDims[0]; }
   if (ext[1] < 0) { ext[1] = 0; }
-  if (ext[1] > blockLocator->DualCellDimensions[0]) { ext[1] = blockLocator->DualCellDimensions[0]; }
+  if (ext[1] > blockDims[0]) { ext[1] = blockDims[0]; }
   if (ext[2] < 0) { ext[2] = 0; }
-  if (ext[2] > blockLocator->DualCellDimensions[1]) { ext[2] = blockLocator->DualCellDimensions[1]; }
+  if (ext[2] > blockDims[1]) { ext[2] = blockDims[1]; }
   if (ext[3] < 0) { ext[3] = 0; }
-  if (ext[3] > blockLocator->DualCellDimensions[1]) { ext[3] = blockLocator->DualCellDimensions[1]; }
+  if (ext[3] > blockDims[1]) { ext[3] = blockDims[1]; }
   if (ext[4] < 0) { ext[4] = 0; }
-  if (ext[4] > blockLocator->DualCellDimensions[2]) { ext[4] = blockLocator->DualCellDimensions[2]; }
+  if (ext[4] > blockDims[2]) { ext[4] = blockDims[2]; }
   if (ext[5] < 0) { ext[5] = 0; }
-  if (ext[5] > blockLocator->DualCellDimensions[2]) { ext[5] = blockLocator->DualCellDimensions[2]; }
+  if (ext[5] > blockDims[2]) { ext[5] = blockDims[2]; }
 
-  vtkIdType pointId;
   int xOut, yOut, zOut;
   int inOffsetZ, inOffsetY, inOffsetX, outOffsetX, outOffsetY, outOffsetZ;
-  inOffsetZ = ext[0] + ext[2]*blockLocator->YIncrement + ext[4]*blockLocator->ZIncrement;
+  inOffsetZ = ext[0] + ext[2]*blockYIncrement + ext[4]*blockZIncrement;
   for (int zIn = ext[4]; zIn <= ext[5]; ++zIn)
     {
     inOffsetY = inOffsetZ;
@@ -475,48 +513,226 @@ void vtkAMRDualContourEdgeLocator::ShareBlockLocatorWithNeighbor(
     // The min ghost index is shifted to fit into the locator array.
     zOut = ((zIn + block->OriginIndex[2]) << levelDiff) - neighbor->OriginIndex[2];
     if (zOut < 0) { zOut = 0; } 
-    outOffsetZ = zOut * neighborLocator->ZIncrement;
+    outOffsetZ = zOut * neighborZIncrement;
     for (int yIn = ext[2]; yIn <= ext[3]; ++yIn)
       {
       inOffsetX = inOffsetY;
       yOut = ((yIn + block->OriginIndex[1]) << levelDiff) - neighbor->OriginIndex[1];
       if (yOut < 0) { yOut = 0; } 
-      outOffsetY = outOffsetZ + yOut * neighborLocator->YIncrement; 
+      outOffsetY = outOffsetZ + yOut * neighborYIncrement; 
       for (int xIn = ext[0]; xIn <= ext[1]; ++xIn)
         {
         xOut = ((xIn + block->OriginIndex[0]) << levelDiff) - neighbor->OriginIndex[0];
         if (xOut < 0) { xOut = 0; } 
         outOffsetX = outOffsetY + xOut;
-
-        pointId = blockLocator->XEdges[inOffsetX];
-        if (pointId >= 0)
-          {
-          neighborLocator->XEdges[outOffsetX] = pointId;
-          }
-        pointId = blockLocator->YEdges[inOffsetX];
-        if (pointId >= 0)
-          {
-          neighborLocator->YEdges[outOffsetX] = pointId;
-          }
-        pointId = blockLocator->ZEdges[inOffsetX];
-        if (pointId >= 0)
-          {
-          neighborLocator->ZEdges[outOffsetX] = pointId;
-          }
-        pointId = blockLocator->Corners[inOffsetX];
-        if (pointId >= 0)
-          {
-          neighborLocator->Corners[outOffsetX] = pointId;
-          }
-
+        functor(inOffsetX, outOffsetX);
         inOffsetX += 1;
         } 
-      inOffsetY += blockLocator->YIncrement;
+      inOffsetY += blockYIncrement;
       }
-    inOffsetZ += blockLocator->ZIncrement;
+    inOffsetZ += blockZIncrement;
     }
 }
 
+//----------------------------------------------------------------------------
+// Copies the point ids of a block locator into a neighbor locator.
+class vtkAMRDualContourCopySlots
+{
+public:
+  vtkAMRDualContourCopySlots(vtkAMRDualContourEdgeLocator* blockLocator,
+                             vtkAMRDualContourEdgeLocator* neighborLocator)
+    : BlockLocator(blockLocator), NeighborLocator(neighborLocator) {}
+
+  void operator()(int inOffset, int outOffset)
+    {
+    for (int kind = 0; kind < 4; ++kind)
+      {
+      vtkIdType pointId = *this->BlockLocator->GetSlotPointer(kind, inOffset);
+      if (pointId >= 0)
+        {
+        *this->NeighborLocator->GetSlotPointer(kind, outOffset) = pointId;
+        }
+      }
+    }
+
+  vtkAMRDualContourEdgeLocator* BlockLocator;
+  vtkAMRDualContourEdgeLocator* NeighborLocator;
+};
+
+//----------------------------------------------------------------------------
+// This version works with higher level neighbor blocks.
+void vtkAMRDualContourEdgeLocator::ShareBlockLocatorWithNeighbor(
+  vtkAMRDualGridHelperBlock* block,
+  vtkAMRDualGridHelperBlock* neighbor)
+{
+  vtkAMRDualContourCopySlots copy(vtkAMRDualContourGetBlockLocator(block),
+                                  vtkAMRDualContourGetBlockLocator(neighbor));
+  vtkAMRDualContourVisitSharedSlots(block, neighbor, copy);
+}
+
+
+
+//============================================================================
+// A slot of the locator of a block and the point id that a worker found in
+// it.  A block passes its slots to its later neighbors.  When the neighbor
+// belongs to another worker, both workers record the slot instead: the
+// point of the later worker is the point of the earlier one.
+struct vtkAMRDualContourSharedSlot
+{
+  // The later block.
+  vtkAMRDualGridHelperBlock* Block;
+  // The x, y or z edges, or the corners.
+  int Kind;
+  // Offset in the locator of the later block.
+  int Offset;
+  // Id in the mesh of the worker that recorded the slot.
+  vtkIdType PointId;
+
+  bool operator<(const vtkAMRDualContourSharedSlot& other) const
+    {
+    if (this->Block != other.Block)
+      {
+      return this->Block < other.Block;
+      }
+    if (this->Kind != other.Kind)
+      {
+      return this->Kind < other.Kind;
+      }
+    return this->Offset < other.Offset;
+    }
+};
+
+//----------------------------------------------------------------------------
+// Records the slots of a locator that a block passes to a neighbor, from
+// the block (the point ids it gives) or from the neighbor (the point ids it
+// ended up with).  Point ids below the minimum are skipped.
+class vtkAMRDualContourRecordSlots
+{
+public:
+  vtkAMRDualContourRecordSlots(
+    vtkAMRDualContourEdgeLocator* locator, bool fromBlock,
+    vtkAMRDualGridHelperBlock* neighbor, vtkIdType minPointId,
+    vtkstd::vector<vtkAMRDualContourSharedSlot>* slots)
+    : Locator(locator), FromBlock(fromBlock), Neighbor(neighbor),
+      MinPointId(minPointId), Slots(slots) {}
+
+  void operator()(int inOffset, int outOffset)
+    {
+    vtkAMRDualContourSharedSlot slot;
+    slot.Block = this->Neighbor;
+    slot.Offset = outOffset;
+    for (slot.Kind = 0; slot.Kind < 4; ++slot.Kind)
+      {
+      slot.PointId = *this->Locator->GetSlotPointer(
+        slot.Kind, this->FromBlock ? inOffset : outOffset);
+      if (slot.PointId >= this->MinPointId)
+        {
+        this->Slots->push_back(slot);
+        }
+      }
+    }
+
+  vtkAMRDualContourEdgeLocator* Locator;
+  bool FromBlock;
+  vtkAMRDualGridHelperBlock* Neighbor;
+  vtkIdType MinPointId;
+  vtkstd::vector<vtkAMRDualContourSharedSlot>* Slots;
+};
+
+//============================================================================
+// The state of one thread.  A worker contours a contiguous range of the
+// local blocks into its own mesh, with its own locators.  Locators are only
+// shared between blocks of the same worker.  The slots that blocks would
+// have passed to the blocks of other workers are recorded, and the points
+// they identify are merged when the meshes of the workers are appended.
+class vtkAMRDualContourWorker
+{
+public:
+  vtkAMRDualContourWorker();
+  ~vtkAMRDualContourWorker();
+
+  // Description:
+  // Position of a local block in the order the blocks are processed.
+  int GetBlockOrder(vtkAMRDualGridHelperBlock* block)
+    {
+    vtkstd::map<vtkAMRDualGridHelperBlock*, int>::const_iterator it
+      = this->BlockOrder->find(block);
+    return it != this->BlockOrder->end() ? it->second : -1;
+    }
+
+  // Description:
+  // Is this block one of the blocks of the worker?
+  bool OwnsBlock(vtkAMRDualGridHelperBlock* block)
+    {
+    int order = this->GetBlockOrder(block);
+    return order >= this->FirstBlock &&
+      order < this->FirstBlock + static_cast<int>(this->Blocks.size());
+    }
+
+  vtkAMRDualContour* Filter;
+  const char* ArrayName;
+
+  // The blocks of this worker and their index in their level.
+  vtkstd::vector<vtkAMRDualGridHelperBlock*> Blocks;
+  vtkstd::vector<int> BlockIds;
+  // Position of the first block of the worker in the processing order.
+  int FirstBlock;
+  // Position of every local block in the processing order.  Shared by all
+  // workers.
+  const vtkstd::map<vtkAMRDualGridHelperBlock*, int>* BlockOrder;
+
+  vtkPolyData* Mesh;
+  vtkPoints* Points;
+  vtkCellArray* Faces;
+  // For debugging.
+  vtkIntArray* BlockIdCellArray;
+
+  // Locator of the block being processed.
+  vtkAMRDualContourEdgeLocator* BlockLocator;
+  // Reused for every block when points are not merged.
+  vtkAMRDualContourEdgeLocator* SharedLocator;
+
+  // Set when the slots shared with other workers have to be recorded.
+  bool RecordSharedSlots;
+  // Slots given to the blocks of later workers.
+  vtkstd::vector<vtkAMRDualContourSharedSlot> GivenSlots;
+  // Slots of the blocks of this worker given by earlier workers.
+  vtkstd::vector<vtkAMRDualContourSharedSlot> TakenSlots;
+
+private:
+  vtkAMRDualContourWorker(const vtkAMRDualContourWorker&);  // Not implemented.
+  void operator=(const vtkAMRDualContourWorker&);  // Not implemented.
+};
+
+//----------------------------------------------------------------------------
+vtkAMRDualContourWorker::vtkAMRDualContourWorker()
+{
+  this->Filter = 0;
+  this->ArrayName = 0;
+  this->FirstBlock = 0;
+  this->BlockOrder = 0;
+  this->Mesh = vtkPolyData::New();
+  this->Points = vtkPoints::New();
+  this->Faces = vtkCellArray::New();
+  this->Mesh->SetPoints(this->Points);
+  this->Mesh->SetPolys(this->Faces);
+  this->BlockIdCellArray = vtkIntArray::New();
+  this->BlockIdCellArray->SetName("BlockIds");
+  this->Mesh->GetCellData()->AddArray(this->BlockIdCellArray);
+  this->BlockLocator = 0;
+  this->SharedLocator = 0;
+  this->RecordSharedSlots = false;
+}
+
+//----------------------------------------------------------------------------
+vtkAMRDualContourWorker::~vtkAMRDualContourWorker()
+{
+  delete this->SharedLocator;
+  this->BlockIdCellArray->Delete();
+  this->Faces->Delete();
+  this->Points->Delete();
+  this->Mesh->Delete();
+}
 
 
 
@@ -546,20 +762,12 @@ vtkAMRDualContour::vtkAMRDualContour()
   this->SetNumberOfOutputPorts(1);
 
   this->TemperatureArray = 0;
-  this->BlockIdCellArray = 0;
   this->Helper = 0;
-
-  this->BlockLocator = 0;
 }
 
 //----------------------------------------------------------------------------
 vtkAMRDualContour::~vtkAMRDualContour()
 {
-  if (this->BlockLocator)
-    {
-    delete this->BlockLocator;
-    this->BlockLocator = 0;
-    }
   this->SetController(NULL);
 }
 
@@ -700,46 +908,94 @@ vtkAMRDualContour::DoRequestData(vtkHierarchicalBoxDataSet* hbdsInput,
     }
 
   // @TODO: Check if this is the right thing to do.
-  this->Helper->Initialize(hbdsInput, arrayNameToProcess);
-
-  this->Mesh = vtkPolyData::New();
-  this->Points = vtkPoints::New();
-  this->Faces = vtkCellArray::New();
-  this->Mesh->SetPoints(this->Points);
-  this->Mesh->SetPolys(this->Faces);
-  mpds->SetPiece(0, this->Mesh);
-
-  this->InitializeCopyAttributes(hbdsInput, this->Mesh);
-
-  // For debugging.
-  this->BlockIdCellArray = vtkIntArray::New();
-  this->BlockIdCellArray->SetName("BlockIds");
-  this->Mesh->GetCellData()->AddArray(this->BlockIdCellArray);
-
-  // Loop through blocks
+  // Ghost regions from other processes arrive while the other blocks
+  // are contoured.
+  this->Helper->BeginInitialize(hbdsInput, arrayNameToProcess);
+
+  // The local blocks in level order.  The blocks that still wait for
+  // ghost regions are processed in a second phase.
+  vtkstd::vector<vtkAMRDualGridHelperBlock*> phaseBlocks[2];
+  vtkstd::vector<int> phaseBlockIds[2];
   int numLevels = hbdsInput->GetNumberOfLevels();
-
-  // Add each block.
   for (int level = 0; level < numLevels; ++level)
     {
     int numBlocks = this->Helper->GetNumberOfBlocksInLevel(level);
     for (int blockId = 0; blockId < numBlocks; ++blockId)
       {
       vtkAMRDualGridHelperBlock* block = this->Helper->GetBlock(level, blockId);
-      this->ProcessBlock(block, blockId, arrayNameToProcess);
+      if (block->Image == 0)
+        { // Remote blocks are only to setup local block bit flags.
+        continue;
+        }
+      int phase = block->RemoteCopyPending ? 1 : 0;
+      phaseBlocks[phase].push_back(block);
+      phaseBlockIds[phase].push_back(blockId);
       }
     }
 
-  this->FinalizeCopyAttributes(this->Mesh);
-  this->BlockIdCellArray->Delete();
-  this->BlockIdCellArray = 0;
+  // Each phase splits its blocks into contiguous ranges, one per thread.
+  vtkSmartPointer<vtkMultiThreader> threader
+    = vtkSmartPointer<vtkMultiThreader>::New();
+  int numberOfThreads = threader->GetNumberOfThreads();
+  int phaseWorkers[2];
+  int phase;
+  for (phase = 0; phase < 2; ++phase)
+    {
+    int numberOfBlocks = static_cast<int>(phaseBlocks[phase].size());
+    phaseWorkers[phase]
+      = numberOfThreads < numberOfBlocks ? numberOfThreads : numberOfBlocks;
+    }
+  if (phaseWorkers[0] + phaseWorkers[1] == 0)
+    {
+    phaseWorkers[0] = 1;
+    }
+  int numberOfWorkers = phaseWorkers[0] + phaseWorkers[1];
 
-  this->Mesh->Delete();
-  this->Mesh = 0;
-  this->Points->Delete();
-  this->Points = 0;
-  this->Faces->Delete();
-  this->Faces = 0;
+  vtkstd::map<vtkAMRDualGridHelperBlock*, int> blockOrder;
+  vtkstd::vector<vtkAMRDualContourWorker*> workers(numberOfWorkers);
+  int workerId = 0;
+  int order = 0;
+  for (phase = 0; phase < 2; ++phase)
+    {
+    int numberOfBlocks = static_cast<int>(phaseBlocks[phase].size());
+    for (int ii = 0; ii < phaseWorkers[phase]; ++ii, ++workerId)
+      {
+      vtkAMRDualContourWorker* worker = new vtkAMRDualContourWorker;
+      worker->Filter = this;
+      worker->ArrayName = arrayNameToProcess;
+      worker->FirstBlock = order;
+      worker->BlockOrder = &blockOrder;
+      worker->RecordSharedSlots
+        = this->EnableMergePoints && numberOfWorkers > 1;
+      int first = ii*numberOfBlocks/phaseWorkers[phase];
+      int last = (ii+1)*numberOfBlocks/phaseWorkers[phase];
+      worker->Blocks.assign(phaseBlocks[phase].begin() + first,
+                            phaseBlocks[phase].begin() + last);
+      worker->BlockIds.assign(phaseBlockIds[phase].begin() + first,
+                              phaseBlockIds[phase].begin() + last);
+      for (int jj = first; jj < last; ++jj)
+        {
+        blockOrder[phaseBlocks[phase][jj]] = order++;
+        }
+      this->InitializeCopyAttributes(hbdsInput, worker->Mesh);
+      workers[workerId] = worker;
+      }
+    }
+
+  this->RunWorkers(&workers[0], phaseWorkers[0]);
+  this->Helper->FinishInitialize();
+  this->RunWorkers(&workers[0] + phaseWorkers[0], phaseWorkers[1]);
+
+  // The first worker holds the output.
+  this->MergeWorkers(workers);
+  vtkPolyData* mesh = workers[0]->Mesh;
+  this->FinalizeCopyAttributes(mesh);
+  mpds->SetPiece(0, mesh);
+
+  for (workerId = 0; workerId < numberOfWorkers; ++workerId)
+    {
+    delete workers[workerId];
+    }
 
   mpds->Delete();
   this->Helper->Delete();
@@ -750,6 +1006,7 @@ vtkAMRDualContour::DoRequestData(vtkHierarchicalBoxDataSet* hbdsInput,
 
 //----------------------------------------------------------------------------
 void vtkAMRDualContour::ShareBlockLocatorWithNeighbors(
+  vtkAMRDualContourWorker* worker,
   vtkAMRDualGridHelperBlock* block)
 {
   vtkAMRDualGridHelperBlock* neighbor;
@@ -786,11 +1043,28 @@ void vtkAMRDualContour::ShareBlockLocatorWithNeighbors(
               (iz >> levelDiff) != zMid)
             {
             neighbor = this->Helper->GetBlock(level, ix, iy, iz); 
+            if (neighbor == 0 || neighbor->Image == 0)
+              {
+              continue;
+              }
             // The unused center flag is used as a flag to indicate
-            if (neighbor && neighbor->Image && neighbor->RegionBits[1][1][1])
+            if (worker->OwnsBlock(neighbor))
               {
-              vtkAMRDualContourEdgeLocator* blockLocator = vtkAMRDualContourGetBlockLocator(block);
-              blockLocator->ShareBlockLocatorWithNeighbor(block, neighbor);
+              if (neighbor->RegionBits[1][1][1])
+                {
+                vtkAMRDualContourEdgeLocator* blockLocator = vtkAMRDualContourGetBlockLocator(block);
+                blockLocator->ShareBlockLocatorWithNeighbor(block, neighbor);
+                }
+              }
+            // The blocks of later workers are left alone, the slots they
+            // would get are recorded instead.
+            else if (worker->RecordSharedSlots &&
+                     worker->GetBlockOrder(neighbor) > worker->FirstBlock)
+              {
+              vtkAMRDualContourRecordSlots record(
+                vtkAMRDualContourGetBlockLocator(block), true, neighbor, 0,
+                &worker->GivenSlots);
+              vtkAMRDualContourVisitSharedSlots(block, neighbor, record);
               }
             }
           }
@@ -803,7 +1077,64 @@ void vtkAMRDualContour::ShareBlockLocatorWithNeighbors(
 
 
 //----------------------------------------------------------------------------
-void vtkAMRDualContour::ProcessBlock(vtkAMRDualGridHelperBlock* block,
+// The reverse of ShareBlockLocatorWithNeighbors: find the blocks of earlier
+// workers that would have shared their locator with this block, and record
+// the points this block created in the slots they would have set.  Points
+// from blocks of the same worker are not recorded, they are the ones a
+// single thread would have found there since those blocks come later.
+void vtkAMRDualContour::RecordSlotsSharedByEarlierWorkers(
+  vtkAMRDualContourWorker* worker,
+  vtkAMRDualGridHelperBlock* block,
+  vtkIdType firstPointId)
+{
+  vtkAMRDualContourEdgeLocator* blockLocator =
+    vtkAMRDualContourGetBlockLocator(block);
+  vtkAMRDualContourRecordSlots record(blockLocator, false, block,
+                                      firstPointId, &worker->TakenSlots);
+  int x = block->GridIndex[0];
+  int y = block->GridIndex[1];
+  int z = block->GridIndex[2];
+  for (int level = 0; level <= block->Level; ++level)
+    {
+    int levelDiff = block->Level - level;
+    // The neighborhoods of these blocks can contain this block.
+    for (int iz = (z >> levelDiff) - 1; iz <= ((z+1) >> levelDiff); ++iz)
+      {
+      if (z < (iz << levelDiff) - 1 || z > ((iz+1) << levelDiff))
+        {
+        continue;
+        }
+      for (int iy = (y >> levelDiff) - 1; iy <= ((y+1) >> levelDiff); ++iy)
+        {
+        if (y < (iy << levelDiff) - 1 || y > ((iy+1) << levelDiff))
+          {
+          continue;
+          }
+        for (int ix = (x >> levelDiff) - 1; ix <= ((x+1) >> levelDiff); ++ix)
+          {
+          if (x < (ix << levelDiff) - 1 || x > ((ix+1) << levelDiff) ||
+              ((x >> levelDiff) == ix && (y >> levelDiff) == iy &&
+               (z >> levelDiff) == iz))
+            {
+            continue;
+            }
+          vtkAMRDualGridHelperBlock* neighbor =
+            this->Helper->GetBlock(level, ix, iy, iz);
+          if (neighbor && neighbor->Image &&
+              worker->GetBlockOrder(neighbor) >= 0 &&
+              worker->GetBlockOrder(neighbor) < worker->FirstBlock)
+            {
+            vtkAMRDualContourVisitSharedSlots(neighbor, block, record);
+            }
+          }
+        }
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkAMRDualContour::ProcessBlock(vtkAMRDualContourWorker* worker,
+                                     vtkAMRDualGridHelperBlock* block,
                                      int blockId, const char* arrayNameToProcess)
 {
   vtkImageData* image = block->Image;
@@ -832,20 +1163,24 @@ void vtkAMRDualContour::ProcessBlock(vtkAMRDualGridHelperBlock* block,
   --extent[3];
   --extent[5];
 
+  // Points created for this block.
+  vtkIdType firstPointId = worker->Points->GetNumberOfPoints();
+
   // Locator merges points in this block.
   // Input the dimensions of the dual cells with ghosts.
   if (this->EnableMergePoints)
     {
-    this->BlockLocator = vtkAMRDualContourGetBlockLocator(block);
+    worker->BlockLocator = vtkAMRDualContourGetBlockLocator(block);
     }
   else
     { // Shared locator.
-    if (this->BlockLocator == 0)
+    if (worker->SharedLocator == 0)
       {
-      this->BlockLocator = new vtkAMRDualContourEdgeLocator;
+      worker->SharedLocator = new vtkAMRDualContourEdgeLocator;
       }
-    this->BlockLocator->Initialize(extent[1]-extent[0], extent[3]-extent[2], extent[5]-extent[4]);
-    this->BlockLocator->CopyRegionLevelDifferences(block);
+    worker->BlockLocator = worker->SharedLocator;
+    worker->BlockLocator->Initialize(extent[1]-extent[0], extent[3]-extent[2], extent[5]-extent[4]);
+    worker->BlockLocator->CopyRegionLevelDifferences(block);
     }
   image->GetOrigin(origin);
   spacing = image->GetSpacing();
@@ -908,7 +1243,7 @@ void vtkAMRDualContour::ProcessBlock(vtkAMRDualGridHelperBlock* block,
           cornerOffsets[5] = xOffset+1+zInc;
           cornerOffsets[6] = xOffset+1+yInc+zInc;
           cornerOffsets[7] = xOffset+yInc+zInc;
-          this->ProcessDualCell(block, blockId, x, y, z,
+          this->ProcessDualCell(worker, block, blockId, x, y, z,
                                 cornerOffsets, volumeFractionArray);
           }
         xOffset += 1; // xInc
@@ -920,11 +1255,14 @@ void vtkAMRDualContour::ProcessBlock(vtkAMRDualGridHelperBlock* block,
 
   if (this->EnableMergePoints)
     {
+    if (worker->RecordSharedSlots)
+      {
+      this->RecordSlotsSharedByEarlierWorkers(worker, block, firstPointId);
+      }
     // Copy point ids into neighbor locators.
-    this->ShareBlockLocatorWithNeighbors(block);
+    this->ShareBlockLocatorWithNeighbors(worker, block);
     // We are done.  We no longer need the locator for this block.
-    delete this->BlockLocator;
-    this->BlockLocator = 0;
+    delete worker->BlockLocator;
     block->UserData = 0;
     // Lets use this unused flag (owner of center region/block) to indicate
     // that the block is already processes.
@@ -934,6 +1272,163 @@ void vtkAMRDualContour::ProcessBlock(vtkAMRDualGridHelperBlock* block,
     // would tell whether the block was processed.
     block->RegionBits[1][1][1] = 0;
     }
+  worker->BlockLocator = 0;
+}
+
+//----------------------------------------------------------------------------
+// Run the workers, each in its own thread.
+void vtkAMRDualContour::RunWorkers(vtkAMRDualContourWorker** workers,
+                                   int numberOfWorkers)
+{
+  if (numberOfWorkers == 1)
+    {
+    vtkAMRDualContour::ProcessBlocks(workers[0]);
+    }
+  else if (numberOfWorkers > 1)
+    {
+    vtkSmartPointer<vtkMultiThreader> threader
+      = vtkSmartPointer<vtkMultiThreader>::New();
+    threader->SetNumberOfThreads(numberOfWorkers);
+    threader->SetSingleMethod(vtkAMRDualContour::ProcessBlocksThread, workers);
+    threader->SingleMethodExecute();
+    }
+}
+
+//----------------------------------------------------------------------------
+VTK_THREAD_RETURN_TYPE vtkAMRDualContour::ProcessBlocksThread(void* arg)
+{
+  vtkMultiThreader::ThreadInfo* info
+    = static_cast<vtkMultiThreader::ThreadInfo*>(arg);
+  vtkAMRDualContour::ProcessBlocks(
+    static_cast<vtkAMRDualContourWorker**>(info->UserData)[info->ThreadID]);
+  return VTK_THREAD_RETURN_VALUE;
+}
+
+//----------------------------------------------------------------------------
+void vtkAMRDualContour::ProcessBlocks(vtkAMRDualContourWorker* worker)
+{
+  for (size_t ii = 0; ii < worker->Blocks.size(); ++ii)
+    {
+    worker->Filter->ProcessBlock(worker, worker->Blocks[ii],
+                                 worker->BlockIds[ii], worker->ArrayName);
+    }
+}
+
+//----------------------------------------------------------------------------
+// Append the meshes of the other workers to the mesh of the first one, in
+// order.  A point that a worker found in a slot given by an earlier worker
+// is replaced by the point that was given, the one the earlier block would
+// have passed on with one thread.  When several blocks give the same slot,
+// the last one in block order wins, as with one thread.  Workers, blocks
+// and slots are visited in order, so the output does not depend on timing
+// or on the number of threads.
+void vtkAMRDualContour::MergeWorkers(
+  vtkstd::vector<vtkAMRDualContourWorker*>& workers)
+{
+  typedef vtkstd::map<vtkAMRDualContourSharedSlot, vtkIdType> SlotMap;
+  size_t numberOfWorkers = workers.size();
+  vtkAMRDualContourWorker* first = workers[0];
+  vtkPointData* outPD = first->Mesh->GetPointData();
+  int numArrays = outPD->GetNumberOfArrays();
+
+  // Where the points of each worker are in the output, or -1 for the
+  // points not appended yet.
+  vtkstd::vector<vtkstd::vector<vtkIdType> > pointMaps(numberOfWorkers);
+  size_t workerId;
+  size_t ii;
+  for (workerId = 0; workerId < numberOfWorkers; ++workerId)
+    {
+    pointMaps[workerId].assign(
+      workers[workerId]->Points->GetNumberOfPoints(), -1);
+    }
+  vtkIdType ptId;
+  for (ptId = 0; ptId < first->Points->GetNumberOfPoints(); ++ptId)
+    {
+    pointMaps[0][ptId] = ptId;
+    }
+
+  // Slots given to the blocks of each worker, in output ids.
+  vtkstd::vector<SlotMap> givenSlots(numberOfWorkers);
+  vtkstd::vector<vtkIdType> cellIds;
+  for (workerId = 0; workerId < numberOfWorkers; ++workerId)
+    {
+    vtkAMRDualContourWorker* worker = workers[workerId];
+    vtkstd::vector<vtkIdType>& pointMap = pointMaps[workerId];
+    if (workerId > 0)
+      {
+      // Points found in given slots are the given points.
+      SlotMap& given = givenSlots[workerId];
+      for (ii = 0; ii < worker->TakenSlots.size(); ++ii)
+        {
+        const vtkAMRDualContourSharedSlot& slot = worker->TakenSlots[ii];
+        SlotMap::iterator it = given.find(slot);
+        if (it != given.end())
+          {
+          pointMap[slot.PointId] = it->second;
+          }
+        }
+      // Both meshes copied their point arrays from the same input, in the
+      // same order.
+      vtkPointData* inPD = worker->Mesh->GetPointData();
+      vtkIdType numPts = worker->Points->GetNumberOfPoints();
+      for (ptId = 0; ptId < numPts; ++ptId)
+        {
+        if (pointMap[ptId] < 0)
+          {
+          vtkIdType outId
+            = first->Points->InsertNextPoint(worker->Points->GetPoint(ptId));
+          for (int arrayIdx = 0; arrayIdx < numArrays; ++arrayIdx)
+            {
+            outPD->GetAbstractArray(arrayIdx)->InsertTuple(
+              outId, ptId, inPD->GetAbstractArray(arrayIdx));
+            }
+          pointMap[ptId] = outId;
+          }
+        }
+
+      // Triangles can collapse when their points are merged, they would
+      // not have been created with one thread.  Caps that are not
+      // triangulated are not checked there, a collapsed one with three
+      // points is dropped here.
+      vtkIdType npts;
+      vtkIdType* pts;
+      vtkIdType cellId = 0;
+      vtkCellArray* faces = worker->Faces;
+      for (faces->InitTraversal(); faces->GetNextCell(npts, pts); ++cellId)
+        {
+        cellIds.resize(npts);
+        for (vtkIdType jj = 0; jj < npts; ++jj)
+          {
+          cellIds[jj] = pointMap[pts[jj]];
+          }
+        if (npts == 3 && (cellIds[0] == cellIds[1] ||
+                          cellIds[0] == cellIds[2] ||
+                          cellIds[1] == cellIds[2]))
+          {
+          continue;
+          }
+        first->Faces->InsertNextCell(npts, &cellIds[0]);
+        first->BlockIdCellArray->InsertNextValue(
+          worker->BlockIdCellArray->GetValue(cellId));
+        }
+      }
+
+    // Pass the slots of this worker to the later ones.  Given slots are
+    // recorded in block order, later blocks overwrite earlier ones.
+    for (ii = 0; ii < worker->GivenSlots.size(); ++ii)
+      {
+      const vtkAMRDualContourSharedSlot& slot = worker->GivenSlots[ii];
+      size_t later = workerId + 1;
+      while (later < numberOfWorkers && !workers[later]->OwnsBlock(slot.Block))
+        {
+        ++later;
+        }
+      if (later < numberOfWorkers)
+        {
+        givenSlots[later][slot] = pointMap[slot.PointId];
+        }
+      }
+    }
 }
 
 
@@ -1002,6 +1497,7 @@ static int vtkAMRDualLegacyIdToBitIdMap[8] = {0,1,3,2,4,5,7,6};
 // a fast path for internal cells (with no degeneracies).
 // Corner offsets are absolute (relative to origin / 0).
 void vtkAMRDualContour::ProcessDualCell(
+  vtkAMRDualContourWorker* worker,
   vtkAMRDualGridHelperBlock* block, int blockId,
   int x, int y, int z,
   vtkIdType cornerOffsets[8],
@@ -1231,7 +1727,7 @@ void vtkAMRDualContour::ProcessDualCell(
     // Only permanently keep locator for edges shared between two blocks.
     for (int ii=0; ii<3; ++ii, ++edge) //insert triangle
       {
-      vtkIdType* ptIdPtr = this->BlockLocator->GetEdgePointer(x,y,z,*edge);
+      vtkIdType* ptIdPtr = worker->BlockLocator->GetEdgePointer(x,y,z,*edge);
 
       if (*ptIdPtr == -1)
         {
@@ -1257,26 +1753,26 @@ void vtkAMRDualContour::ProcessDualCell(
         pt[0] = cornerPoints[pt1Idx] + k*(cornerPoints[pt2Idx]-cornerPoints[pt1Idx]);
         pt[1] = cornerPoints[pt1Idx|1] + k*(cornerPoints[pt2Idx|1]-cornerPoints[pt1Idx|1]);
         pt[2] = cornerPoints[pt1Idx|2] + k*(cornerPoints[pt2Idx|2]-cornerPoints[pt1Idx|2]);
-        *ptIdPtr = this->Points->InsertNextPoint(pt);
+        *ptIdPtr = worker->Points->InsertNextPoint(pt);
         // Interpolate attributes
         // Find the offsets of the two attributes to interpolate
         vtkIdType offset0 = cornerOffsets[vtkAMRDualIsoEdgeToVTKPointsTable[*edge][0]];
         vtkIdType offset1 = cornerOffsets[vtkAMRDualIsoEdgeToVTKPointsTable[*edge][1]];
         this->InterpolateAttributes(block->Image, offset0, offset1, k,
-                                    this->Mesh, *ptIdPtr);
+                                    worker->Mesh, *ptIdPtr);
         }
       edgePointIds[*edge] = pointIds[ii] = *ptIdPtr; 
       }
     if (pointIds[0]!=pointIds[1] && pointIds[0]!=pointIds[2] && pointIds[1]!=pointIds[2])
       {
-      this->Faces->InsertNextCell(3, pointIds);
-      this->BlockIdCellArray->InsertNextValue(blockId);
+      worker->Faces->InsertNextCell(3, pointIds);
+      worker->BlockIdCellArray->InsertNextValue(blockId);
       }
     }
 
   if (this->EnableCapping)
     {
-    this->CapCell(x,y,z, cubeBoundaryBits, cubeCase, edgePointIds, cornerPoints,
+    this->CapCell(worker, x,y,z, cubeBoundaryBits, cubeCase, edgePointIds, cornerPoints,
                   cornerOffsets, blockId, block->Image);
     }
 }
@@ -1284,7 +1780,9 @@ void vtkAMRDualContour::ProcessDualCell(
 
 
 //----------------------------------------------------------------------------
-void vtkAMRDualContour::AddCapPolygon(int ptCount, vtkIdType* pointIds, int blockId)
+void vtkAMRDualContour::AddCapPolygon(vtkAMRDualContourWorker* worker,
+                                      int ptCount, vtkIdType* pointIds,
+                                      int blockId)
 {
   if (this->TriangulateCap)
     {
@@ -1300,8 +1798,8 @@ void vtkAMRDualContour::AddCapPolygon(int ptCount, vtkIdType* pointIds, int bloc
         tri[2] = pointIds[low];
         if (tri[0]!=tri[1] && tri[0]!=tri[2] && tri[1]!=tri[2])
           {
-          this->Faces->InsertNextCell(3, tri);
-          this->BlockIdCellArray->InsertNextValue(blockId);
+          worker->Faces->InsertNextCell(3, tri);
+          worker->BlockIdCellArray->InsertNextValue(blockId);
           }
         }
       else
@@ -1311,16 +1809,16 @@ void vtkAMRDualContour::AddCapPolygon(int ptCount, vtkIdType* pointIds, int bloc
         tri[2] = pointIds[low];
         if (tri[0]!=tri[1] && tri[0]!=tri[2] && tri[1]!=tri[2])
           {
-          this->Faces->InsertNextCell(3, tri);
-          this->BlockIdCellArray->InsertNextValue(blockId);
+          worker->Faces->InsertNextCell(3, tri);
+          worker->BlockIdCellArray->InsertNextValue(blockId);
           }
         tri[0] = pointIds[high];
         tri[1] = pointIds[high+1];
         tri[2] = pointIds[low];
         if (tri[0]!=tri[1] && tri[0]!=tri[2] && tri[1]!=tri[2])
           {
-          this->Faces->InsertNextCell(3, tri);
-          this->BlockIdCellArray->InsertNextValue(blockId);
+          worker->Faces->InsertNextCell(3, tri);
+          worker->BlockIdCellArray->InsertNextValue(blockId);
           }
         }
       ++low;
@@ -1330,8 +1828,8 @@ void vtkAMRDualContour::AddCapPolygon(int ptCount, vtkIdType* pointIds, int bloc
   else
     {
     // Do not worry about degenerate polygons in this path.
-    this->Faces->InsertNextCell(ptCount, pointIds);
-    this->BlockIdCellArray->InsertNextValue(blockId);
+    worker->Faces->InsertNextCell(ptCount, pointIds);
+    worker->BlockIdCellArray->InsertNextValue(blockId);
     }
 }
 
@@ -1343,6 +1841,7 @@ void vtkAMRDualContour::AddCapPolygon(int ptCount, vtkIdType* pointIds, int bloc
 // It endsup being a little long to duplicate the code 6 times,
 // but it is still fast.
 void vtkAMRDualContour::CapCell(
+  vtkAMRDualContourWorker* worker,
   int cellX, int cellY, int cellZ, // cell index in block coordinates.
   // Which cell faces need to be capped.
   unsigned char cubeBoundaryBits,
@@ -1375,12 +1874,12 @@ void vtkAMRDualContour::CapCell(
         if (*capPtr < 4)
           {
           cornerIdx = (vtkAMRDualIsoNXCapEdgeMap[*capPtr]);
-          ptIdPtr = this->BlockLocator->GetCornerPointer(cellX,cellY,cellZ, cornerIdx);
+          ptIdPtr = worker->BlockLocator->GetCornerPointer(cellX,cellY,cellZ, cornerIdx);
           if (*ptIdPtr == -1)
             {
-            *ptIdPtr = this->Points->InsertNextPoint(cornerPoints+(cornerIdx<<2));
+            *ptIdPtr = worker->Points->InsertNextPoint(cornerPoints+(cornerIdx<<2));
             this->CopyAttributes(inData, cornerOffsets[vtkAMRDualLegacyIdToBitIdMap[cornerIdx]],
-                                 this->Mesh, *ptIdPtr);
+                                 worker->Mesh, *ptIdPtr);
             }
           pointIds[ptCount++] = *ptIdPtr; 
           }
@@ -1390,7 +1889,7 @@ void vtkAMRDualContour::CapCell(
           }
         ++capPtr;
         }
-      this->AddCapPolygon(ptCount, pointIds, blockId);
+      this->AddCapPolygon(worker, ptCount, pointIds, blockId);
       if (*capPtr == -1) {++capPtr;} // Skip to the next triangle.
       }
     }
@@ -1407,12 +1906,12 @@ void vtkAMRDualContour::CapCell(
         if (*capPtr < 4)
           {
           cornerIdx = (vtkAMRDualIsoPXCapEdgeMap[*capPtr]);
-          ptIdPtr = this->BlockLocator->GetCornerPointer(cellX,cellY,cellZ, cornerIdx);
+          ptIdPtr = worker->BlockLocator->GetCornerPointer(cellX,cellY,cellZ, cornerIdx);
           if (*ptIdPtr == -1)
             {
-            *ptIdPtr = this->Points->InsertNextPoint(cornerPoints+(cornerIdx<<2));
+            *ptIdPtr = worker->Points->InsertNextPoint(cornerPoints+(cornerIdx<<2));
             this->CopyAttributes(inData, cornerOffsets[vtkAMRDualLegacyIdToBitIdMap[cornerIdx]],
-                                 this->Mesh, *ptIdPtr);
+                                 worker->Mesh, *ptIdPtr);
             }
           pointIds[ptCount++] = *ptIdPtr;
           }
@@ -1422,7 +1921,7 @@ void vtkAMRDualContour::CapCell(
           }
         ++capPtr;
         }
-      this->AddCapPolygon(ptCount, pointIds, blockId);
+      this->AddCapPolygon(worker, ptCount, pointIds, blockId);
       if (*capPtr == -1) {++capPtr;} // Skip to the next triangle.
       }
     }
@@ -1440,12 +1939,12 @@ void vtkAMRDualContour::CapCell(
         if (*capPtr < 4)
           {
           cornerIdx = (vtkAMRDualIsoNYCapEdgeMap[*capPtr]);
-          ptIdPtr = this->BlockLocator->GetCornerPointer(cellX,cellY,cellZ, cornerIdx);
+          ptIdPtr = worker->BlockLocator->GetCornerPointer(cellX,cellY,cellZ, cornerIdx);
           if (*ptIdPtr == -1)
             {
-            *ptIdPtr = this->Points->InsertNextPoint(cornerPoints+(cornerIdx<<2));
+            *ptIdPtr = worker->Points->InsertNextPoint(cornerPoints+(cornerIdx<<2));
             this->CopyAttributes(inData, cornerOffsets[vtkAMRDualLegacyIdToBitIdMap[cornerIdx]],
-                                 this->Mesh, *ptIdPtr);
+                                 worker->Mesh, *ptIdPtr);
             }
           pointIds[ptCount++] = *ptIdPtr; 
           }
@@ -1455,7 +1954,7 @@ void vtkAMRDualContour::CapCell(
           }
         ++capPtr;
         }
-      this->AddCapPolygon(ptCount, pointIds, blockId);
+      this->AddCapPolygon(worker, ptCount, pointIds, blockId);
       if (*capPtr == -1) {++capPtr;} // Skip to the next triangle.
       }
     }
@@ -1473,12 +1972,12 @@ void vtkAMRDualContour::CapCell(
         if (*capPtr < 4)
           {
           cornerIdx = (vtkAMRDualIsoPYCapEdgeMap[*capPtr]);
-          ptIdPtr = this->BlockLocator->GetCornerPointer(cellX,cellY,cellZ, cornerIdx);
+          ptIdPtr = worker->BlockLocator->GetCornerPointer(cellX,cellY,cellZ, cornerIdx);
           if (*ptIdPtr == -1)
             {
-            *ptIdPtr = this->Points->InsertNextPoint(cornerPoints+(cornerIdx<<2));
+            *ptIdPtr = worker->Points->InsertNextPoint(cornerPoints+(cornerIdx<<2));
             this->CopyAttributes(inData, cornerOffsets[vtkAMRDualLegacyIdToBitIdMap[cornerIdx]],
-                                 this->Mesh, *ptIdPtr);
+                                 worker->Mesh, *ptIdPtr);
             }
           pointIds[ptCount++] = *ptIdPtr; 
           }
@@ -1488,7 +1987,7 @@ void vtkAMRDualContour::CapCell(
           }
         ++capPtr;
         }
-      this->AddCapPolygon(ptCount, pointIds, blockId);
+      this->AddCapPolygon(worker, ptCount, pointIds, blockId);
       if (*capPtr == -1) {++capPtr;} // Skip to the next triangle.
       }
     }
@@ -1507,12 +2006,12 @@ void vtkAMRDualContour::CapCell(
         if (*capPtr < 4)
           {
           cornerIdx = (vtkAMRDualIsoNZCapEdgeMap[*capPtr]);
-          ptIdPtr = this->BlockLocator->GetCornerPointer(cellX,cellY,cellZ, cornerIdx);
+          ptIdPtr = worker->BlockLocator->GetCornerPointer(cellX,cellY,cellZ, cornerIdx);
           if (*ptIdPtr == -1)
             {
-            *ptIdPtr = this->Points->InsertNextPoint(cornerPoints+(cornerIdx<<2));
+            *ptIdPtr = worker->Points->InsertNextPoint(cornerPoints+(cornerIdx<<2));
             this->CopyAttributes(inData, cornerOffsets[vtkAMRDualLegacyIdToBitIdMap[cornerIdx]],
-                                 this->Mesh, *ptIdPtr);
+                                 worker->Mesh, *ptIdPtr);
             }
           pointIds[ptCount++] = *ptIdPtr; 
           }
@@ -1522,7 +2021,7 @@ void vtkAMRDualContour::CapCell(
           }
         ++capPtr;
         }
-      this->AddCapPolygon(ptCount, pointIds, blockId);
+      this->AddCapPolygon(worker, ptCount, pointIds, blockId);
       if (*capPtr == -1) {++capPtr;} // Skip to the next triangle.
       }
     }
@@ -1540,12 +2039,12 @@ void vtkAMRDualContour::CapCell(
         if (*capPtr < 4)
           {
           cornerIdx = (vtkAMRDualIsoPZCapEdgeMap[*capPtr]);
-          ptIdPtr = this->BlockLocator->GetCornerPointer(cellX,cellY,cellZ, cornerIdx);
+          ptIdPtr = worker->BlockLocator->GetCornerPointer(cellX,cellY,cellZ, cornerIdx);
           if (*ptIdPtr == -1)
             {
-            *ptIdPtr = this->Points->InsertNextPoint(cornerPoints+(cornerIdx<<2));
+            *ptIdPtr = worker->Points->InsertNextPoint(cornerPoints+(cornerIdx<<2));
             this->CopyAttributes(inData, cornerOffsets[vtkAMRDualLegacyIdToBitIdMap[cornerIdx]],
-                                 this->Mesh, *ptIdPtr);
+                                 worker->Mesh, *ptIdPtr);
             }
           pointIds[ptCount++] = *ptIdPtr; 
           }
@@ -1555,7 +2054,7 @@ void vtkAMRDualContour::CapCell(
           }
         ++capPtr;
         }
-      this->AddCapPolygon(ptCount, pointIds, blockId);
+      this->AddCapPolygon(worker, ptCount, pointIds, blockId);
       if (*capPtr == -1) {++capPtr;} // Skip to the next triangle.
       }
     }
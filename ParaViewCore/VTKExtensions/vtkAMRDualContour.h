@@ -18,6 +18,16 @@
 // surface.  It also performs connectivity on the particles and generates
 // a particle index as part of the cell data of the output.  It computes
 // the volume of each particle from the volume fraction.
+//
+// The local blocks are contoured by as many threads as vtkMultiThreader
+// provides, each with its own mesh and locators.  When points are merged,
+// the locator slots that a block would have passed to a block of another
+// thread are recorded, and the points they identify are merged when the
+// meshes are appended, so the output is the same on any number of threads.
+// Blocks waiting for ghost values from other processes are contoured after
+// the others.  Note that vtkProcessModule::Initialize() limits
+// vtkMultiThreader to one thread, so the filter only uses more threads in
+// ParaView when that limit is raised.
 
 // This will turn on validation and debug i/o of the filter.
 //#define vtkAMRDualContourDEBUG
@@ -27,6 +37,7 @@
 #define __vtkAMRDualContour_h
 
 #include "vtkMultiBlockDataSetAlgorithm.h"
+#include "vtkMultiThreader.h" // needed for VTK_THREAD_RETURN_TYPE
 #include <vtkstd/vector>
 #include <vtkstd/string>
 
@@ -48,6 +59,7 @@ class vtkAMRDualGridHelper;
 class vtkAMRDualGridHelperBlock;
 class vtkAMRDualGridHelperFace;
 class vtkAMRDualContourEdgeLocator;
+class vtkAMRDualContourWorker;
 
 
 class VTK_EXPORT vtkAMRDualContour : public vtkMultiBlockDataSetAlgorithm
@@ -127,23 +139,48 @@ protected:
   virtual int FillOutputPortInformation(int port, vtkInformation *info);
 
   void ShareBlockLocatorWithNeighbors(
+    vtkAMRDualContourWorker* worker,
     vtkAMRDualGridHelperBlock* block);
 
-  void ProcessBlock(vtkAMRDualGridHelperBlock* block, int blockId,
+  // Description:
+  // Record the slots of the block locator that blocks of earlier workers
+  // would have set, so that their points can be merged.  Only the points
+  // from firstPointId on were created for the block.
+  void RecordSlotsSharedByEarlierWorkers(
+    vtkAMRDualContourWorker* worker,
+    vtkAMRDualGridHelperBlock* block,
+    vtkIdType firstPointId);
+
+  // Description:
+  // Contour the blocks of the workers, each worker in its own thread.
+  void RunWorkers(vtkAMRDualContourWorker** workers, int numberOfWorkers);
+  static VTK_THREAD_RETURN_TYPE ProcessBlocksThread(void* arg);
+  static void ProcessBlocks(vtkAMRDualContourWorker* worker);
+
+  // Description:
+  // Append the meshes of all the workers to the mesh of the first one.
+  void MergeWorkers(vtkstd::vector<vtkAMRDualContourWorker*>& workers);
+
+  void ProcessBlock(vtkAMRDualContourWorker* worker,
+                    vtkAMRDualGridHelperBlock* block, int blockId,
                     const char* arrayName);
 
 
   void ProcessDualCell(
+    vtkAMRDualContourWorker* worker,
     vtkAMRDualGridHelperBlock* block, int blockId,
     int x, int y, int z,
     vtkIdType cornerOffsets[8],
     vtkDataArray *volumeFractionArray);
 
-  void AddCapPolygon(int ptCount, vtkIdType* pointIds, int blockId);
+  void AddCapPolygon(vtkAMRDualContourWorker* worker,
+                     int ptCount, vtkIdType* pointIds, int blockId);
 
   // This method is getting too many arguements!
   // Capping was an after thought...
   void CapCell(
+    // The thread's mesh and locator.
+    vtkAMRDualContourWorker* worker,
     int cellX, int cellY, int cellZ,  // block coordinates
     // Which cell faces need to be capped.
     unsigned char cubeBoundaryBits,
@@ -161,14 +198,10 @@ protected:
     vtkDataSet* inData);
 
   // Stuff exclusively for debugging.
-  vtkIntArray* BlockIdCellArray;
   vtkFloatArray* TemperatureArray;
 
   // Ivars used to reduce method parrameters.
   vtkAMRDualGridHelper* Helper;
-  vtkPolyData* Mesh;
-  vtkPoints* Points;
-  vtkCellArray* Faces;
 
   vtkMultiProcessController *Controller;
 
@@ -177,8 +210,6 @@ protected:
   int* MessageBuffer;
   int* MessageBufferLength;
 
-  vtkAMRDualContourEdgeLocator* BlockLocator;
-
   // Stuff for passing cell attributes to point attributes.
   void InitializeCopyAttributes(
     vtkHierarchicalBoxDataSet *hbdsInput,
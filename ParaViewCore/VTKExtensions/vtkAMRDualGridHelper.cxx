@@ -406,6 +406,7 @@ vtkAMRDualGridHelperBlock::vtkAMRDualGridHelperBlock()
   //  }
   this->Image = 0;
   this->CopyFlag = 0;
+  this->RemoteCopyPending = 0;
 
   for (int x = 0; x < 3; ++x)
     {
@@ -729,6 +730,8 @@ vtkAMRDualGridHelper::vtkAMRDualGridHelper()
   this->EnableDegenerateCells = 1;
   this->EnableAsynchronousCommunication = 1;
   this->NumberOfBlocksInThisProcess = 0;
+  this->PendingSendList = 0;
+  this->PendingReceiveList = 0;
   for (ii = 0; ii < 3; ++ii)
     {
     this->StandardBlockDimensions[ii] = 0;
@@ -752,6 +755,9 @@ vtkAMRDualGridHelper::~vtkAMRDualGridHelper()
   int ii;
   int numberOfLevels = (int)(this->Levels.size());
 
+  // Do not leave messages in flight.
+  this->FinishInitialize();
+
   this->SetArrayName(0);
 
   for (ii = 0; ii < numberOfLevels; ++ii)
@@ -1955,12 +1961,24 @@ void vtkAMRDualGridHelper::ProcessRegionRemoteCopyQueueMPIAsynchronous(
     return;
     }
 
-  int numProcs = controller->GetNumberOfProcesses();
-  int myProc = controller->GetLocalProcessId();
-
   vtkAMRDualGridHelperCommRequestList sendList;
   vtkAMRDualGridHelperCommRequestList receiveList;
 
+  this->PostDegenerateRegionsCommMPIAsynchronous(sendList, receiveList);
+
+  // Finally, finish all communications as they come in.
+  this->FinishDegenerateRegionsCommMPIAsynchronous(hackLevelFlag,
+                                                   sendList, receiveList);
+}
+
+//-----------------------------------------------------------------------------
+void vtkAMRDualGridHelper::PostDegenerateRegionsCommMPIAsynchronous(
+                               vtkAMRDualGridHelperCommRequestList &sendList,
+                               vtkAMRDualGridHelperCommRequestList &receiveList)
+{
+  int numProcs = this->Controller->GetNumberOfProcesses();
+  int myProc = this->Controller->GetLocalProcessId();
+
   // First establish all receives.  MPI communication is more efficient if
   // the receive is posted before the send.
   for (int sendProc = 0; sendProc < numProcs; sendProc++)
@@ -1976,10 +1994,6 @@ void vtkAMRDualGridHelper::ProcessRegionRemoteCopyQueueMPIAsynchronous(
     if (recvProc == myProc) continue;
     this->SendDegenerateRegionsFromQueueMPIAsynchronous(recvProc, sendList);
     }
-
-  // Finally, finish all communications as they come in.
-  this->FinishDegenerateRegionsCommMPIAsynchronous(hackLevelFlag,
-                                                   sendList, receiveList);
 }
 
 void vtkAMRDualGridHelper::ReceiveDegenerateRegionsFromQueueMPIAsynchronous(
@@ -2100,6 +2114,15 @@ void vtkAMRDualGridHelper::FinishDegenerateRegionsCommMPIAsynchronous(
 // process multiple arrays.
 int vtkAMRDualGridHelper::Initialize(vtkHierarchicalBoxDataSet* input,
                                      const char* arrayName)
+{
+  int retVal = this->BeginInitialize(input, arrayName);
+  this->FinishInitialize();
+  return retVal;
+}
+
+//----------------------------------------------------------------------------
+int vtkAMRDualGridHelper::BeginInitialize(vtkHierarchicalBoxDataSet* input,
+                                          const char* arrayName)
 {
 //   vtkTimerLogSmartMarkEvent markevent("vtkAMRDualGridHelper::Initialize", this->Controller);
 
@@ -2141,13 +2164,76 @@ int vtkAMRDualGridHelper::Initialize(vtkHierarchicalBoxDataSet* input,
   this->AssignSharedRegions();
 
   // Copy regions on level boundaries between processes.
-  this->ProcessRegionRemoteCopyQueue(false);
+  this->BeginRegionRemoteCopyQueue();
 
   // Setup faces for seeding connectivity between blocks.
   //this->CreateFaces();
 
   return VTK_OK;
 }
+
+//----------------------------------------------------------------------------
+// Post the messages of the region queue and flag the local blocks that
+// receive regions from other processes.  Without MPI the copy is done here.
+void vtkAMRDualGridHelper::BeginRegionRemoteCopyQueue()
+{
+  if (this->SkipGhostCopy)
+    {
+    return;
+    }
+
+#ifdef VTK_AMR_DUAL_GRID_USE_MPI_ASYNCHRONOUS
+  if (   this->EnableAsynchronousCommunication
+      && this->Controller->IsA("vtkMPIController") )
+    {
+    this->PendingSendList = new vtkAMRDualGridHelperCommRequestList;
+    this->PendingReceiveList = new vtkAMRDualGridHelperCommRequestList;
+    this->PostDegenerateRegionsCommMPIAsynchronous(*this->PendingSendList,
+                                                   *this->PendingReceiveList);
+
+    int myProc = this->Controller->GetLocalProcessId();
+    vtkstd::vector<vtkAMRDualGridHelperDegenerateRegion>::iterator region;
+    for (region = this->DegenerateRegionQueue.begin();
+         region != this->DegenerateRegionQueue.end(); ++region)
+      {
+      if (   region->ReceivingBlock->ProcessId == myProc
+          && region->SourceBlock->ProcessId != myProc)
+        {
+        region->ReceivingBlock->RemoteCopyPending = 1;
+        }
+      }
+    return;
+    }
+#endif //VTK_AMR_DUAL_GRID_USE_MPI_ASYNCHRONOUS
+
+  this->ProcessRegionRemoteCopyQueueSynchronous(false);
+}
+
+//----------------------------------------------------------------------------
+void vtkAMRDualGridHelper::FinishInitialize()
+{
+#ifdef VTK_AMR_DUAL_GRID_USE_MPI_ASYNCHRONOUS
+  if (this->PendingReceiveList == 0)
+    {
+    return;
+    }
+
+  this->FinishDegenerateRegionsCommMPIAsynchronous(false,
+                                                   *this->PendingSendList,
+                                                   *this->PendingReceiveList);
+  delete this->PendingSendList;
+  this->PendingSendList = 0;
+  delete this->PendingReceiveList;
+  this->PendingReceiveList = 0;
+
+  vtkstd::vector<vtkAMRDualGridHelperDegenerateRegion>::iterator region;
+  for (region = this->DegenerateRegionQueue.begin();
+       region != this->DegenerateRegionQueue.end(); ++region)
+    {
+    region->ReceivingBlock->RemoteCopyPending = 0;
+    }
+#endif //VTK_AMR_DUAL_GRID_USE_MPI_ASYNCHRONOUS
+}
 void vtkAMRDualGridHelper::ClearRegionRemoteCopyQueue()
 {
   this->DegenerateRegionQueue.clear();
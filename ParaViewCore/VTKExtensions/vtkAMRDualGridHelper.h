@@ -76,6 +76,18 @@ public:
 
   int                       Initialize(vtkHierarchicalBoxDataSet* input,
                                        const char* arrayName);
+
+  // Description:
+  // Initialize in two steps so that the copy of ghost regions from other
+  // processes overlaps with work on the local blocks.  BeginInitialize
+  // does everything Initialize does but only starts the copy.  Until
+  // FinishInitialize is called, local blocks whose ghost regions are still
+  // in flight have their RemoteCopyPending flag set.  The other blocks are
+  // complete.  Without asynchronous communication BeginInitialize
+  // completes the copy and FinishInitialize does nothing.
+  int                       BeginInitialize(vtkHierarchicalBoxDataSet* input,
+                                            const char* arrayName);
+  void                      FinishInitialize();
   const double*             GetGlobalOrigin() { return this->GlobalOrigin;}
   const double*             GetRootSpacing() { return this->RootSpacing;}
   int                       GetNumberOfBlocks() { return this->NumberOfBlocksInThisProcess;}
@@ -188,6 +200,15 @@ private:
                               bool hackLevelFlag,
                               vtkAMRDualGridHelperCommRequestList &sendList,
                               vtkAMRDualGridHelperCommRequestList &receiveList);
+  void PostDegenerateRegionsCommMPIAsynchronous(
+                              vtkAMRDualGridHelperCommRequestList &sendList,
+                              vtkAMRDualGridHelperCommRequestList &receiveList);
+
+  // Starts the copy of the region queue for BeginInitialize.
+  void BeginRegionRemoteCopyQueue();
+  // Communication started by BeginInitialize and not finished yet.
+  vtkAMRDualGridHelperCommRequestList* PendingSendList;
+  vtkAMRDualGridHelperCommRequestList* PendingReceiveList;
 
   // Degenerate regions that span processes.  We keep them in a queue
   // to communicate and process all at once.
@@ -262,6 +283,10 @@ public:
   // We need to modify the ghost layers of level interfaces.
   unsigned char CopyFlag;
 
+  // Set between BeginInitialize and FinishInitialize on local blocks
+  // that still wait for ghost regions from another process.
+  unsigned char RemoteCopyPending;
+
   // We have to assign cells shared between blocks so only one
   // block will process them.  Faces, edges and corners have to be
   // considered separately (Extent does not work).
@@ -29,12 +29,14 @@ vtkBSPCutsGenerator::vtkBSPCutsGenerator()
 {
   this->Enabled = true;
   this->PKdTree = 0;
+  this->KdTreeManager = vtkKdTreeManager::New();
 }
 
 //----------------------------------------------------------------------------
 vtkBSPCutsGenerator::~vtkBSPCutsGenerator()
 {
   this->SetPKdTree(0);
+  this->KdTreeManager->Delete();
 }
 
 //----------------------------------------------------------------------------
@@ -78,7 +80,7 @@ int vtkBSPCutsGenerator::RequestData(vtkInformation *,
     vtkMultiProcessController::GetGlobalController();
   if (this->Enabled && controller && controller->GetNumberOfProcesses() > 1)
     {
-    vtkKdTreeManager* mgr = vtkKdTreeManager::New();
+    vtkKdTreeManager* mgr = this->KdTreeManager;
     vtkBSPCuts* output = vtkBSPCuts::GetData(outputVector, 0);
     for (int cc=0; cc < inputVector[0]->GetNumberOfInformationObjects(); cc++)
       {
@@ -103,7 +105,6 @@ int vtkBSPCutsGenerator::RequestData(vtkInformation *,
 
     mgr->RemoveAllProducers();
     mgr->SetStructuredProducer(NULL);
-    mgr->Delete();
     }
   return 1;
 }
@@ -126,5 +127,6 @@ void vtkBSPCutsGenerator::SetPKdTree(vtkPKdTree* tree)
 void vtkBSPCutsGenerator::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os, indent);
+  os << indent << "KdTreeManager: " << this->KdTreeManager << endl;
 }
 
@@ -20,6 +20,7 @@
 #define __vtkBSPCutsGenerator_h
 
 #include "vtkDataObjectAlgorithm.h"
+class vtkKdTreeManager;
 class vtkPKdTree;
 
 class VTK_EXPORT vtkBSPCutsGenerator : public vtkDataObjectAlgorithm
@@ -37,6 +38,11 @@ public:
   // This is only valid after Update().
   vtkGetObjectMacro(PKdTree, vtkPKdTree);
 
+  // Description:
+  // The manager that builds the tree.  It is kept between updates so that
+  // its ReusePartition mode can keep the partition when the data changes.
+  vtkGetObjectMacro(KdTreeManager, vtkKdTreeManager);
+
 //BTX
 protected:
   vtkBSPCutsGenerator();
@@ -50,6 +56,7 @@ protected:
 
   void SetPKdTree(vtkPKdTree*);
   vtkPKdTree* PKdTree;
+  vtkKdTreeManager* KdTreeManager;
   bool Enabled;
 private:
   vtkBSPCutsGenerator(const vtkBSPCutsGenerator&); // Not implemented
@@ -224,6 +224,13 @@ int vtkExodusFileSeriesReader::RequestInformationForInput(
                                                       request, outputVector);
 }
 
+//-----------------------------------------------------------------------------
+int vtkExodusFileSeriesReader::CanDistributeTimeQueries()
+{
+  return this->Superclass::CanDistributeTimeQueries() &&
+    !vtkPExodusIIReader::SafeDownCast(this->Reader);
+}
+
 //-----------------------------------------------------------------------------
 void vtkExodusFileSeriesReader::FindRestartedResults()
 {
@@ -57,6 +57,11 @@ protected:
                                          vtkInformation *request,
                                          vtkInformationVector *outputVector);
 
+  // The parallel Exodus reader broadcasts the meta data of the file in
+  // RequestInformation, so every process has to query the same file even
+  // when DistributeTimeQueries is on.
+  virtual int CanDistributeTimeQueries();
+
   // Replaces the filenames, which probably represents partitions of the data,
   // with a set of files where each represents a set of solution files for one
   // of the simulation restarts.
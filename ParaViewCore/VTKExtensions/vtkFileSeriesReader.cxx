@@ -32,6 +32,9 @@
 #include "vtkInformationIntegerKey.h"
 #include "vtkInformationVector.h"
 #include "vtkMath.h"
+#include "vtkMultiProcessController.h"
+#include "vtkMultiThreader.h"
+#include "vtkMutexLock.h"
 #include "vtkObjectFactory.h"
 #include "vtkStdString.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
@@ -48,10 +51,13 @@
 #include <vtkstd/string>
 #include <vtkstd/vector>
 
+#include <vtksys/SystemTools.hxx>
+
 //=============================================================================
 vtkStandardNewMacro(vtkFileSeriesReader);
 
 vtkCxxSetObjectMacro(vtkFileSeriesReader,Reader,vtkAlgorithm);
+vtkCxxSetObjectMacro(vtkFileSeriesReader,Controller,vtkMultiProcessController);
 
 //=============================================================================
 // Internal class for holding time ranges.
@@ -326,14 +332,299 @@ vtkstd::vector<double> vtkFileSeriesReaderTimeRanges::GetTimesForInput(
   return times;
 }
 
+//=============================================================================
+// The time information of the files is exchanged and cached as a flat list of
+// doubles, one record per file: the file index, the number of time steps,
+// whether there is a time range, the time range and the time steps.
+namespace
+{
+const char vtkFileSeriesReaderTimeCacheHeader[] =
+  "vtkFileSeriesReader time information";
+
+//-----------------------------------------------------------------------------
+void vtkFileSeriesReaderPackTimes(int index, vtkInformation *info,
+                                  vtkstd::vector<double> &times)
+{
+  int numSteps = 0;
+  double *steps = NULL;
+  if (info->Has(vtkStreamingDemandDrivenPipeline::TIME_STEPS()))
+    {
+    numSteps = info->Length(vtkStreamingDemandDrivenPipeline::TIME_STEPS());
+    steps = info->Get(vtkStreamingDemandDrivenPipeline::TIME_STEPS());
+    }
+  double range[2] = { 0.0, 0.0 };
+  int hasRange = info->Has(vtkStreamingDemandDrivenPipeline::TIME_RANGE());
+  if (hasRange)
+    {
+    info->Get(vtkStreamingDemandDrivenPipeline::TIME_RANGE(), range);
+    }
+  times.push_back(index);
+  times.push_back(numSteps);
+  times.push_back(hasRange);
+  times.push_back(range[0]);
+  times.push_back(range[1]);
+  times.insert(times.end(), steps, steps + numSteps);
+}
+
+//-----------------------------------------------------------------------------
+// Find where the record of each file starts.  Returns false unless there is
+// exactly one well formed record for each file.
+bool vtkFileSeriesReaderFindRecords(const vtkstd::vector<double> &times,
+                                    int numFiles,
+                                    vtkstd::vector<size_t> &records)
+{
+  records.assign(numFiles, times.size());
+  size_t pos = 0;
+  while (pos < times.size())
+    {
+    if (pos + 5 > times.size())
+      {
+      return false;
+      }
+    int index = static_cast<int>(times[pos]);
+    double numSteps = times[pos+1];
+    if (index < 0 || index >= numFiles || records[index] != times.size() ||
+        numSteps < 0 || numSteps > times.size() - pos - 5)
+      {
+      return false;
+      }
+    records[index] = pos;
+    pos += 5 + static_cast<size_t>(numSteps);
+    }
+  return vtkstd::find(records.begin(), records.end(), times.size())
+    == records.end();
+}
+
+//-----------------------------------------------------------------------------
+// The cache is only valid for the same files, read by the same kind of reader,
+// none of which was modified since.
+bool vtkFileSeriesReaderReadTimeCache(vtkFileSeriesReader *self,
+                                      const char *cacheFileName,
+                                      const char *readerClassName,
+                                      const vtkstd::vector<long> &fileTimes,
+                                      vtkstd::vector<double> &times)
+{
+  ifstream cacheFile(cacheFileName, ios::in);
+  if (!cacheFile)
+    {
+    return false;
+    }
+
+  vtkstd::string line;
+  vtksys::SystemTools::GetLineFromStream(cacheFile, line);
+  if (line != vtkFileSeriesReaderTimeCacheHeader)
+    {
+    return false;
+    }
+  vtksys::SystemTools::GetLineFromStream(cacheFile, line);
+  if (line != readerClassName)
+    {
+    return false;
+    }
+  size_t numFiles = 0;
+  cacheFile >> numFiles;
+  if (numFiles != fileTimes.size())
+    {
+    return false;
+    }
+  for (size_t i = 0; i < numFiles; i++)
+    {
+    long fileTime = 0;
+    cacheFile >> fileTime;
+    cacheFile.get();
+    vtksys::SystemTools::GetLineFromStream(cacheFile, line);
+    if (!cacheFile || fileTime != fileTimes[i] ||
+        line != self->GetFileName(static_cast<unsigned int>(i)))
+      {
+      return false;
+      }
+    }
+
+  double value;
+  while (cacheFile >> value)
+    {
+    times.push_back(value);
+    }
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+bool vtkFileSeriesReaderWriteTimeCache(vtkFileSeriesReader *self,
+                                       const char *cacheFileName,
+                                       const char *readerClassName,
+                                       const vtkstd::vector<long> &fileTimes,
+                                       const vtkstd::vector<double> &times)
+{
+  ofstream cacheFile(cacheFileName, ios::out);
+  if (!cacheFile)
+    {
+    return false;
+    }
+  cacheFile << vtkFileSeriesReaderTimeCacheHeader << endl
+            << readerClassName << endl
+            << fileTimes.size() << endl;
+  for (size_t i = 0; i < fileTimes.size(); i++)
+    {
+    cacheFile << fileTimes[i] << " "
+              << self->GetFileName(static_cast<unsigned int>(i)) << endl;
+    }
+  cacheFile.precision(17);
+  for (size_t i = 0; i < times.size(); i++)
+    {
+    cacheFile << times[i] << endl;
+    }
+  return cacheFile.good();
+}
+}
+
 //=============================================================================
 struct vtkFileSeriesReaderInternals
 {
   vtkstd::vector<vtkstd::string> FileNames;
   bool FileNameIsSet;
   vtkFileSeriesReaderTimeRanges *TimeRanges;
+
+  // The index of the file read by the last RequestData, -1 if none.
+  int LastDataIndex;
+
+  vtkMultiThreader *Threader;
+  int ReadAheadThreadId;
+  vtkstd::string ReadAheadFileName;
+  // The piece request the file is read ahead for.
+  int ReadAheadPiece;
+  int ReadAheadNumberOfPieces;
+  // Guards ReadAheadDone.
+  vtkMutexLock *ReadAheadLock;
+  bool ReadAheadDone;
 };
 
+namespace
+{
+//-----------------------------------------------------------------------------
+// Read bytes [offset, offset+length) of a file and throw them away, a
+// negative length reads to the end of the file. Returns false when the
+// reader asked to stop.
+bool vtkFileSeriesReaderReadAheadRange(vtkFileSeriesReaderInternals *internal,
+                                       const vtkstd::string &fileName,
+                                       vtkTypeInt64 offset,
+                                       vtkTypeInt64 length)
+{
+  ifstream file(fileName.c_str(), ios::in | ios::binary);
+  if (offset > 0)
+    {
+    file.seekg(static_cast<vtkstd::streamoff>(offset));
+    }
+  vtkstd::vector<char> buffer(1 << 20);
+  while (file && length != 0)
+    {
+    internal->ReadAheadLock->Lock();
+    bool done = internal->ReadAheadDone;
+    internal->ReadAheadLock->Unlock();
+    if (done)
+      {
+      return false;
+      }
+    vtkTypeInt64 chunk = static_cast<vtkTypeInt64>(buffer.size());
+    if (length > 0 && length < chunk)
+      {
+      chunk = length;
+      }
+    file.read(&buffer[0], static_cast<vtkstd::streamsize>(chunk));
+    if (length > 0)
+      {
+      length -= chunk;
+      }
+    }
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+// The files a parallel VTK XML file (.pvtu, .pvti, ...) points to, in the
+// order of its pieces. Empty for any other file.
+vtkstd::vector<vtkstd::string> vtkFileSeriesReaderGetPieceFiles(
+  const vtkstd::string &fileName)
+{
+  vtkstd::vector<vtkstd::string> pieces;
+  vtkstd::string ext = vtksys::SystemTools::GetFilenameLastExtension(fileName);
+  if (ext.size() != 5 || ext.compare(0, 3, ".pv") != 0)
+    {
+    return pieces;
+    }
+  ifstream file(fileName.c_str());
+  vtkstd::string path = vtksys::SystemTools::GetFilenamePath(fileName);
+  vtkstd::string line;
+  const vtkstd::string source = "Source=\"";
+  while (vtksys::SystemTools::GetLineFromStream(file, line))
+    {
+    size_t start = line.find(source);
+    if (start == vtkstd::string::npos)
+      {
+      continue;
+      }
+    start += source.size();
+    size_t end = line.find('"', start);
+    if (end == vtkstd::string::npos)
+      {
+      continue;
+      }
+    vtkstd::string piece = line.substr(start, end - start);
+    if (!vtksys::SystemTools::FileIsFullPath(piece.c_str()) && !path.empty())
+      {
+      piece = path + "/" + piece;
+      }
+    pieces.push_back(piece);
+    }
+  return pieces;
+}
+}
+
+//-----------------------------------------------------------------------------
+// Read the part of a file that the current piece request will need and throw
+// the bytes away, until done or until the reader asks to stop.
+static VTK_THREAD_RETURN_TYPE vtkFileSeriesReaderReadAheadMain(void *arg)
+{
+  vtkMultiThreader::ThreadInfo *info =
+    static_cast<vtkMultiThreader::ThreadInfo*>(arg);
+  vtkFileSeriesReaderInternals *internal =
+    static_cast<vtkFileSeriesReaderInternals*>(info->UserData);
+  const vtkstd::string &fileName = internal->ReadAheadFileName;
+  vtkTypeInt64 piece = internal->ReadAheadPiece;
+  vtkTypeInt64 numPieces = internal->ReadAheadNumberOfPieces;
+
+  // A parallel XML file: read the piece files the XML readers assign to
+  // this piece, a contiguous share of them.
+  vtkstd::vector<vtkstd::string> pieceFiles =
+    vtkFileSeriesReaderGetPieceFiles(fileName);
+  if (!pieceFiles.empty())
+    {
+    vtkTypeInt64 numFiles = static_cast<vtkTypeInt64>(pieceFiles.size());
+    for (vtkTypeInt64 i = piece*numFiles/numPieces;
+         i < (piece+1)*numFiles/numPieces; i++)
+      {
+      if (!vtkFileSeriesReaderReadAheadRange(internal, pieceFiles[i], 0, -1))
+        {
+        break;
+        }
+      }
+    return VTK_THREAD_RETURN_VALUE;
+    }
+
+  // Any other file: each process reads its share of the bytes, so that the
+  // file goes through the file system once instead of once per process.
+  vtkTypeInt64 offset = 0;
+  vtkTypeInt64 length = -1;
+  if (numPieces > 1)
+    {
+    ifstream file(fileName.c_str(), ios::in | ios::binary);
+    file.seekg(0, ios::end);
+    vtkTypeInt64 size = file ? static_cast<vtkTypeInt64>(file.tellg()) : 0;
+    offset = size*piece/numPieces;
+    length = size*(piece+1)/numPieces - offset;
+    }
+  vtkFileSeriesReaderReadAheadRange(internal, fileName, offset, length);
+  return VTK_THREAD_RETURN_VALUE;
+}
+
 //=============================================================================
 vtkFileSeriesReader::vtkFileSeriesReader()
 {
@@ -348,6 +639,13 @@ vtkFileSeriesReader::vtkFileSeriesReader()
   this->Internal = new vtkFileSeriesReaderInternals;
   this->Internal->FileNameIsSet = false;
   this->Internal->TimeRanges = new vtkFileSeriesReaderTimeRanges;
+  this->Internal->LastDataIndex = -1;
+  this->Internal->Threader = vtkMultiThreader::New();
+  this->Internal->ReadAheadThreadId = -1;
+  this->Internal->ReadAheadPiece = 0;
+  this->Internal->ReadAheadNumberOfPieces = 1;
+  this->Internal->ReadAheadLock = vtkMutexLock::New();
+  this->Internal->ReadAheadDone = false;
 
   this->FileNameMethod = NULL;
   //this->SetFileNameMethod("SetFileName");
@@ -359,14 +657,24 @@ vtkFileSeriesReader::vtkFileSeriesReader()
   this->IgnoreReaderTime = 0;
 
   this->LastRequestInformationIndex = -1;
+
+  this->Controller = NULL;
+  this->SetController(vtkMultiProcessController::GetGlobalController());
+  this->CacheTimeInformation = 0;
+  this->DistributeTimeQueries = 0;
+  this->ReadAhead = 0;
 }
 
 //-----------------------------------------------------------------------------
 vtkFileSeriesReader::~vtkFileSeriesReader()
 {
+  this->StopReadAhead();
+  this->Internal->Threader->Delete();
+  this->Internal->ReadAheadLock->Delete();
   this->SetCurrentFileName(NULL);
   this->SetMetaFileName(NULL);
   this->SetReader(NULL);
+  this->SetController(NULL);
   delete this->Internal->TimeRanges;
   delete this->Internal;
   this->SetFileNameMethod(0);
@@ -578,15 +886,7 @@ int vtkFileSeriesReader::RequestInformation(
     }
   else
     {
-    // Record the reported file time info.
-    this->Internal->TimeRanges->AddTimeRange(0, outInfo);
-
-    // Query all the other files for time info.
-    for (int i = 1; i < numFiles; i++)
-      {
-      this->RequestInformationForInput(i, request, outputVector);
-      this->Internal->TimeRanges->AddTimeRange(i, outInfo);
-      }
+    this->GatherTimeInformation(request, outputVector);
     }
 
   // Now that we have collected all of the time information, set the aggregate
@@ -595,6 +895,148 @@ int vtkFileSeriesReader::RequestInformation(
   return 1;
 }
 
+//----------------------------------------------------------------------------
+void vtkFileSeriesReader::GatherTimeInformation(
+                                             vtkInformation *request,
+                                             vtkInformationVector *outputVector)
+{
+  vtkInformation *outInfo = outputVector->GetInformationObject(0);
+  int numFiles = static_cast<int>(this->GetNumberOfFileNames());
+
+  // Readers that communicate in RequestInformation have every process query
+  // the same file, the others split the files among the processes.
+  vtkMultiProcessController *controller = this->Controller;
+  int numProcs = controller ? controller->GetNumberOfProcesses() : 1;
+  int procId = controller ? controller->GetLocalProcessId() : 0;
+  bool distribute = numProcs > 1 && this->CanDistributeTimeQueries();
+  bool useCache = this->CacheTimeInformation && numFiles > 1;
+
+  // The first process looks for cached information and shares it, so that
+  // every process skips the queries or none does.
+  vtkstd::vector<double> times;
+  vtkstd::vector<size_t> records;
+  vtkstd::vector<long> fileTimes;
+  vtkstd::string cacheFileName;
+  bool cached = false;
+  if (useCache && procId == 0)
+    {
+    cacheFileName = this->UseMetaFile && this->MetaFileName ?
+      this->MetaFileName : this->GetFileName(0);
+    cacheFileName += ".vtktimes";
+    fileTimes.resize(numFiles);
+    for (int i = 0; i < numFiles; i++)
+      {
+      fileTimes[i] = vtksys::SystemTools::ModifiedTime(this->GetFileName(i));
+      }
+    cached =
+      vtkFileSeriesReaderReadTimeCache(this, cacheFileName.c_str(),
+                                       this->Reader->GetClassName(),
+                                       fileTimes, times) &&
+      vtkFileSeriesReaderFindRecords(times, numFiles, records);
+    if (!cached)
+      {
+      times.clear();
+      }
+    }
+  if (useCache && numProcs > 1)
+    {
+    vtkIdType numValues = static_cast<vtkIdType>(times.size());
+    controller->Broadcast(&numValues, 1, 0);
+    if (numValues > 0)
+      {
+      times.resize(numValues);
+      controller->Broadcast(&times[0], numValues, 0);
+      cached = vtkFileSeriesReaderFindRecords(times, numFiles, records);
+      }
+    }
+
+  if (!cached)
+    {
+    // Every process already queried the first file.  The others are dealt
+    // round robin.
+    int first = 1;
+    int step = 1;
+    if (distribute)
+      {
+      first = procId == 0 ? numProcs : procId;
+      step = numProcs;
+      }
+    if (!distribute || procId == 0)
+      {
+      vtkFileSeriesReaderPackTimes(0, outInfo, times);
+      }
+    for (int i = first; i < numFiles; i += step)
+      {
+      // Do not let a file without time inherit the times of the last one.
+      outInfo->Remove(vtkStreamingDemandDrivenPipeline::TIME_STEPS());
+      outInfo->Remove(vtkStreamingDemandDrivenPipeline::TIME_RANGE());
+      this->RequestInformationForInput(i, request, outputVector);
+      vtkFileSeriesReaderPackTimes(i, outInfo, times);
+      }
+
+    if (distribute)
+      {
+      vtkIdType numLocalValues = static_cast<vtkIdType>(times.size());
+      vtkstd::vector<vtkIdType> numValues(numProcs);
+      vtkstd::vector<vtkIdType> offsets(numProcs);
+      controller->AllGather(&numLocalValues, &numValues[0], 1);
+      vtkIdType numGlobalValues = 0;
+      for (int i = 0; i < numProcs; i++)
+        {
+        offsets[i] = numGlobalValues;
+        numGlobalValues += numValues[i];
+        }
+      vtkstd::vector<double> localTimes;
+      localTimes.swap(times);
+      times.resize(numGlobalValues);
+      double dummy = 0;
+      controller->AllGatherV(localTimes.empty() ? &dummy : &localTimes[0],
+                             &times[0], numLocalValues,
+                             &numValues[0], &offsets[0]);
+      }
+    if (!vtkFileSeriesReaderFindRecords(times, numFiles, records))
+      {
+      vtkErrorMacro("Could not gather the time information of the files.");
+      return;
+      }
+
+    if (!cacheFileName.empty() &&
+        !vtkFileSeriesReaderWriteTimeCache(this, cacheFileName.c_str(),
+                                           this->Reader->GetClassName(),
+                                           fileTimes, times))
+      {
+      vtkDebugMacro("Could not write the time cache " << cacheFileName);
+      }
+    }
+
+  // Add the ranges in file order, later files win ties.
+  VTK_CREATE(vtkInformation, fileInfo);
+  for (int i = 0; i < numFiles; i++)
+    {
+    fileInfo->Clear();
+    const double *record = &times[records[i]];
+    int numSteps = static_cast<int>(record[1]);
+    if (numSteps > 0)
+      {
+      fileInfo->Set(vtkStreamingDemandDrivenPipeline::TIME_STEPS(),
+                    record + 5, numSteps);
+      }
+    if (record[2] != 0.0)
+      {
+      fileInfo->Set(vtkStreamingDemandDrivenPipeline::TIME_RANGE(),
+                    record + 3, 2);
+      }
+    this->Internal->TimeRanges->AddTimeRange(i, fileInfo);
+    }
+
+  // The rest of the output information comes from the last file, like it
+  // does when the files are queried in order.
+  if (this->LastRequestInformationIndex != numFiles - 1)
+    {
+    this->RequestInformationForInput(numFiles - 1, request, outputVector);
+    }
+}
+
 //----------------------------------------------------------------------------
 int vtkFileSeriesReader::RequestUpdateExtent(
                                  vtkInformation* vtkNotUsed(request),
@@ -659,8 +1101,30 @@ int vtkFileSeriesReader::RequestData(vtkInformation *request,
   this->Internal->TimeRanges->GetInputTimeInfo(
                                      this->LastRequestInformationIndex,outInfo);
 
+  // Do not compete with the reader for the disk.
+  this->StopReadAhead();
+
   int retVal = this->Reader->ProcessRequest(request, inputVector, outputVector);
 
+  int index = this->LastRequestInformationIndex;
+  if (this->ReadAhead && index >= 0 && index != this->Internal->LastDataIndex)
+    {
+    int step = index < this->Internal->LastDataIndex ? -1 : 1;
+    int piece = 0;
+    int numPieces = 1;
+    if (outInfo->Has(vtkStreamingDemandDrivenPipeline::UPDATE_PIECE_NUMBER()) &&
+        outInfo->Has(
+          vtkStreamingDemandDrivenPipeline::UPDATE_NUMBER_OF_PIECES()))
+      {
+      piece = outInfo->Get(
+        vtkStreamingDemandDrivenPipeline::UPDATE_PIECE_NUMBER());
+      numPieces = outInfo->Get(
+        vtkStreamingDemandDrivenPipeline::UPDATE_NUMBER_OF_PIECES());
+      }
+    this->StartReadAhead(index + step, piece, numPieces);
+    }
+  this->Internal->LastDataIndex = index;
+
   if (this->GetNumberOfFileNames() > 0)
     {
     // Now restore the information.
@@ -670,6 +1134,37 @@ int vtkFileSeriesReader::RequestData(vtkInformation *request,
   return retVal;
 }
 
+//-----------------------------------------------------------------------------
+void vtkFileSeriesReader::StartReadAhead(int index, int piece, int numPieces)
+{
+  this->StopReadAhead();
+  if (index < 0 || index >= static_cast<int>(this->GetNumberOfFileNames()) ||
+      piece < 0 || numPieces < 1 || piece >= numPieces)
+    {
+    return;
+    }
+  this->Internal->ReadAheadFileName = this->GetFileName(index);
+  this->Internal->ReadAheadPiece = piece;
+  this->Internal->ReadAheadNumberOfPieces = numPieces;
+  this->Internal->ReadAheadDone = false;
+  this->Internal->ReadAheadThreadId = this->Internal->Threader->SpawnThread(
+    vtkFileSeriesReaderReadAheadMain, this->Internal);
+}
+
+//-----------------------------------------------------------------------------
+void vtkFileSeriesReader::StopReadAhead()
+{
+  if (this->Internal->ReadAheadThreadId == -1)
+    {
+    return;
+    }
+  this->Internal->ReadAheadLock->Lock();
+  this->Internal->ReadAheadDone = true;
+  this->Internal->ReadAheadLock->Unlock();
+  this->Internal->Threader->TerminateThread(this->Internal->ReadAheadThreadId);
+  this->Internal->ReadAheadThreadId = -1;
+}
+
 //-----------------------------------------------------------------------------
 int vtkFileSeriesReader::RequestInformationForInput(
                                              int index,
@@ -855,4 +1350,10 @@ void vtkFileSeriesReader::PrintSelf(ostream& os, vtkIndent indent)
      << (this->MetaFileName?this->MetaFileName:"(none)") << endl;
   os << indent << "UseMetaFile: " << this->UseMetaFile << endl;
   os << indent << "IgnoreReaderTime: " << this->IgnoreReaderTime << endl;
+  os << indent << "Controller: " << this->Controller << endl;
+  os << indent << "CacheTimeInformation: " << this->CacheTimeInformation
+     << endl;
+  os << indent << "DistributeTimeQueries: " << this->DistributeTimeQueries
+     << endl;
+  os << indent << "ReadAhead: " << this->ReadAhead << endl;
 }
@@ -43,12 +43,25 @@
 // method is useful when the actual reader points to a set of files itself.  The
 // UseMetaFile toggles between these two methods of specifying files.
 //
+// When the files carry their own time, every file has to be opened to find
+// its time steps.  For readers that do not communicate, these queries can be
+// spread over the processes of Controller (see DistributeTimeQueries), and the
+// gathered time information can be saved to a small cache file next to the
+// series (see CacheTimeInformation) that is reused as long as none of the
+// files is modified.
+//
+// With ReadAhead on, the part of the file of the next time step that the
+// current piece request needs is read in the background while the current one
+// is processed, so that it is in the operating system's file cache when the
+// animation gets there.
+//
 
 #ifndef __vtkFileSeriesReader_h
 #define __vtkFileSeriesReader_h
 
 #include "vtkDataObjectAlgorithm.h"
 
+class vtkMultiProcessController;
 class vtkStringArray;
 
 //BTX
@@ -131,6 +144,44 @@ public:
   vtkSetMacro(IgnoreReaderTime, int);
   vtkBooleanMacro(IgnoreReaderTime, int);
 
+  // Description:
+  // Set/get the controller used to spread the time queries of the files over
+  // the processes.  Every process of the controller must run
+  // RequestInformation.  Set to NULL to query every file on every process.
+  // The global controller is used by default.
+  virtual void SetController(vtkMultiProcessController*);
+  vtkGetObjectMacro(Controller, vtkMultiProcessController);
+
+  // Description:
+  // If true, the time information of the files is saved next to the first
+  // file (or the meta file) and read back the next time the same series is
+  // opened, as long as the modification times of the files are unchanged.
+  // This writes a file into the directory of the data.  False by default.
+  vtkGetMacro(CacheTimeInformation, int);
+  vtkSetMacro(CacheTimeInformation, int);
+  vtkBooleanMacro(CacheTimeInformation, int);
+
+  // Description:
+  // If true, the processes of Controller query different files for their
+  // time information and gather the answers.  Only turn this on for readers
+  // that do not communicate in RequestInformation, otherwise the processes
+  // deadlock.  False by default.
+  vtkGetMacro(DistributeTimeQueries, int);
+  vtkSetMacro(DistributeTimeQueries, int);
+  vtkBooleanMacro(DistributeTimeQueries, int);
+
+  // Description:
+  // If true, after a file is read the file that follows it in the direction
+  // of playback is read by a background thread, which brings it into the
+  // operating system's file cache.  The direction is the one of the last two
+  // requested files.  Only what the current piece request needs is read: for
+  // a parallel VTK XML file, the piece files the XML readers assign to the
+  // piece, and for any other file, the piece's share of its bytes, so that
+  // together the processes read it once.  False by default.
+  vtkGetMacro(ReadAhead, int);
+  vtkSetMacro(ReadAhead, int);
+  vtkBooleanMacro(ReadAhead, int);
+
 protected:
   vtkFileSeriesReader();
   ~vtkFileSeriesReader();
@@ -155,6 +206,26 @@ protected:
                                      vtkInformation *request = NULL,
                                      vtkInformationVector *outputVector = NULL);
 
+  // Description:
+  // Collect the time information of all files, from the cache if it is up to
+  // date, otherwise by running RequestInformationForInput on every file.  The
+  // information of the first file must already be in the output information.
+  virtual void GatherTimeInformation(vtkInformation *request,
+                                     vtkInformationVector *outputVector);
+
+  // Description:
+  // Returns true when the files may be queried by different processes at the
+  // same time, i.e. when the reader does not communicate in
+  // RequestInformation.  Returns DistributeTimeQueries by default.
+  virtual int CanDistributeTimeQueries()
+    { return this->DistributeTimeQueries; }
+
+  // Description:
+  // Start reading the part of the given file that the given piece request
+  // needs in the background, or wait for the background read to stop.
+  void StartReadAhead(int index, int piece, int numPieces);
+  void StopReadAhead();
+
   // Description:
   // The last file index for which RequestInformationForInput was run.
   int LastRequestInformationIndex;
@@ -186,6 +257,11 @@ protected:
 
   int IgnoreReaderTime;
 
+  vtkMultiProcessController* Controller;
+  int CacheTimeInformation;
+  int DistributeTimeQueries;
+  int ReadAhead;
+
 private:
   vtkFileSeriesReader(const vtkFileSeriesReader&); // Not implemented.
   void operator=(const vtkFileSeriesReader&); // Not implemented.
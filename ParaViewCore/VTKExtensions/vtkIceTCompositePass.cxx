@@ -80,6 +80,8 @@ vtkIceTCompositePass::vtkIceTCompositePass()
 
   this->DataReplicatedOnAllProcesses = false;
   this->ImageReductionFactor = 1;
+  this->RenderRegion[0] = this->RenderRegion[1] = 0;
+  this->RenderRegion[2] = this->RenderRegion[3] = -1;
 
   this->UseOrderedCompositing = false;
   this->DepthOnly=false;
@@ -222,7 +224,16 @@ void vtkIceTCompositePass::SetupContext(const vtkRenderState* render_state)
       }
     }
 
-  icetEnable(ICET_FLOATING_VIEWPORT);
+  // Draw() restricts the rendering with a scissor box computed in tile
+  // coordinates, which only holds when IceT renders whole tiles.
+  if (this->UseRenderRegion())
+    {
+    icetDisable(ICET_FLOATING_VIEWPORT);
+    }
+  else
+    {
+    icetEnable(ICET_FLOATING_VIEWPORT);
+    }
   if (use_ordered_compositing)
     {
     // if ordered compositing is enabled, pass the process order from the kdtree
@@ -487,10 +498,44 @@ void vtkIceTCompositePass::Draw(const vtkRenderState* render_state)
     glColorMask(GL_FALSE,GL_FALSE,GL_FALSE,GL_FALSE);
     }
   glClear(clear_mask);
+
+  // Only rasterize the render region, if any. The region is given in pixels
+  // of the display while IceT renders the tile at the origin.
+  GLboolean scissor_enabled = GL_FALSE;
+  GLint scissor_box[4];
+  bool use_region = this->UseRenderRegion();
+  if (use_region)
+    {
+    double image_reduction_factor = this->ImageReductionFactor > 0?
+      this->ImageReductionFactor : 1.0;
+    int region[4];
+    for (int cc=0; cc < 4; cc++)
+      {
+      region[cc] = static_cast<int>(
+        this->RenderRegion[cc]/image_reduction_factor) -
+        this->LastTileViewport[cc%2];
+      }
+    scissor_enabled = glIsEnabled(GL_SCISSOR_TEST);
+    glGetIntegerv(GL_SCISSOR_BOX, scissor_box);
+    glEnable(GL_SCISSOR_TEST);
+    glScissor(region[0], region[1],
+      region[2] >= region[0]? region[2] - region[0] + 1 : 0,
+      region[3] >= region[1]? region[3] - region[1] + 1 : 0);
+    }
+
   if (this->RenderPass)
     {
     this->RenderPass->Render(render_state);
     }
+
+  if (use_region)
+    {
+    glScissor(scissor_box[0], scissor_box[1], scissor_box[2], scissor_box[3]);
+    if (!scissor_enabled)
+      {
+      glDisable(GL_SCISSOR_TEST);
+      }
+    }
   if(this->DepthOnly)
     {
     glColorMask(GL_TRUE,GL_TRUE,GL_TRUE,GL_TRUE);
@@ -593,6 +638,23 @@ void vtkIceTCompositePass::UpdateTileInformation(
     //return;
     }
 
+  // With a render region, the tiles that do not intersect it are skipped,
+  // unless that would leave no tile at all.
+  bool skip_tiles = false;
+  if (this->UseRenderRegion())
+    {
+    for (int cc=0; cc < this->TileDimensions[0]*this->TileDimensions[1]; cc++)
+      {
+      int tile_viewport[4];
+      if (tilesHelper->GetTileViewport(viewport, cc, tile_viewport) &&
+        this->RegionIntersectsTile(tile_viewport))
+        {
+        skip_tiles = true;
+        break;
+        }
+      }
+    }
+
   //cout << "icetResetTiles" << endl;
   icetResetTiles();
   for (int x=0; x < this->TileDimensions[0]; x++)
@@ -605,6 +667,10 @@ void vtkIceTCompositePass::UpdateTileInformation(
         {
         continue;
         }
+      if (skip_tiles && !this->RegionIntersectsTile(tile_viewport))
+        {
+        continue;
+        }
 
       vtkDebugMacro(<< this << "=" << cur_rank << " : "
         << tile_viewport[0]/image_reduction_factor << ", "
@@ -651,6 +717,15 @@ void vtkIceTCompositePass::UpdateTileInformation(
   this->LastTileDimensions[1] = this->TileDimensions[1];
 }
 
+//----------------------------------------------------------------------------
+bool vtkIceTCompositePass::RegionIntersectsTile(const int tile_viewport[4])
+{
+  return this->RenderRegion[0] <= tile_viewport[2] &&
+    this->RenderRegion[2] >= tile_viewport[0] &&
+    this->RenderRegion[1] <= tile_viewport[3] &&
+    this->RenderRegion[3] >= tile_viewport[1];
+}
+
 //----------------------------------------------------------------------------
 void vtkIceTCompositePass::GetLastRenderedTile(
   vtkSynchronizedRenderers::vtkRawImage& tile)
@@ -901,6 +976,9 @@ void vtkIceTCompositePass::PrintSelf(ostream& os, vtkIndent indent)
      << this->UseOrderedCompositing << endl;
   os << indent << "DepthOnly: " << this->DepthOnly << endl;
   os << indent << "FixBackground: " << this->FixBackground << endl;
+  os << indent << "RenderRegion: "
+     << this->RenderRegion[0] << ", " << this->RenderRegion[1] << ", "
+     << this->RenderRegion[2] << ", " << this->RenderRegion[3] << endl;
   os << indent << "PhysicalViewport: "
      << this->PhysicalViewport[0] << ", " << this->PhysicalViewport[1]
      << this->PhysicalViewport[2] << ", " << this->PhysicalViewport[3] << endl;
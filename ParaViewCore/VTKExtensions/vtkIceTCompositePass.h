@@ -142,6 +142,16 @@ public:
   vtkGetMacro(FixBackground,bool);
   vtkSetMacro(FixBackground,bool);
 
+  // Description:
+  // Restrict rendering to a region (xmin, ymin, xmax, ymax) given in pixels of
+  // the whole display, in tile-display mode. Geometry is only rasterized
+  // inside the region and only the tiles that intersect the region are
+  // composited. This is used when rendering for selection. With a single
+  // display the region is ignored. An empty region (xmax < xmin), which is
+  // the initial value, renders the whole viewport.
+  vtkSetVector4Macro(RenderRegion, int);
+  vtkGetVector4Macro(RenderRegion, int);
+
 //BTX
   // Description:
   // Returns the last rendered tile from this process, if any.
@@ -186,6 +196,21 @@ protected:
   // Updates the IceT tile information during each render.
   void UpdateTileInformation(const vtkRenderState*);
 
+  // Description:
+  // Returns true if RenderRegion overlaps the given tile viewport.
+  bool RegionIntersectsTile(const int tile_viewport[4]);
+
+  // Description:
+  // Returns true when RenderRegion is not empty and there are several tiles.
+  // With a single display, IceT's floating viewport already limits the
+  // compositing to the projected geometry and the region is ignored.
+  bool UseRenderRegion()
+    {
+    return this->RenderRegion[0] <= this->RenderRegion[2] &&
+      this->RenderRegion[1] <= this->RenderRegion[3] &&
+      this->TileDimensions[0]*this->TileDimensions[1] > 1;
+    }
+
   vtkMultiProcessController *Controller;
   vtkPKdTree *KdTree;
   vtkRenderPass* RenderPass;
@@ -203,6 +228,7 @@ protected:
   double PhysicalViewport[4];
 
   int ImageReductionFactor;
+  int RenderRegion[4];
   
   vtkFloatArray *LastRenderedDepths;
 
@@ -15,6 +15,7 @@
 #include "vtkKdTreeManager.h"
 
 #include "vtkAlgorithm.h"
+#include "vtkBSPCuts.h"
 #include "vtkCellType.h"
 #include "vtkCommunicator.h"
 #include "vtkCompositeDataIterator.h"
@@ -28,16 +29,92 @@
 #include "vtkSmartPointer.h"
 #include "vtkSphereSource.h"
 #include "vtkUnstructuredGrid.h"
+#include "vtkWeakPointer.h"
 
 #define VTK_CREATE(type, name) \
   vtkSmartPointer<type> name = vtkSmartPointer<type>::New()
 
+// Number of points of a data set located to estimate the region loads.
+#define VTK_KD_TREE_MANAGER_LOAD_SAMPLES 65536
+
 #include <vtkstd/set>
 #include <vtkstd/vector>
+#include <math.h>
 
 class vtkKdTreeManager::vtkAlgorithmSet : 
   public vtkstd::set<vtkSmartPointer<vtkAlgorithm> > {};
 
+class vtkKdTreeManager::vtkPartition
+{
+public:
+  vtkPartition() : Valid(false) {}
+
+  // The producers are not kept alive by the partition.  One that was deleted
+  // since is NULL, so that a new producer allocated at the same address does
+  // not pass for it.
+  bool SameProducers(vtkAlgorithmSet* producers)
+    {
+    if (producers->size() != this->Producers.size())
+      {
+      return false;
+      }
+    for (size_t cc = 0; cc < this->Producers.size(); cc++)
+      {
+      vtkAlgorithm* producer = this->Producers[cc];
+      if (!producer || producers->find(producer) == producers->end())
+        {
+        return false;
+        }
+      }
+    return true;
+    }
+
+  void SetProducers(vtkAlgorithmSet* producers)
+    {
+    this->Producers.clear();
+    vtkAlgorithmSet::iterator iter;
+    for (iter = producers->begin(); iter != producers->end(); ++iter)
+      {
+      this->Producers.push_back(iter->GetPointer());
+      }
+    }
+
+  bool Valid;
+  vtkstd::vector<vtkWeakPointer<vtkAlgorithm> > Producers;
+  double Bounds[6];
+  vtkstd::vector<vtkIdType> Loads;
+};
+
+namespace
+{
+  // Collect the non-empty leaves of a data object.
+  void vtkKdTreeManagerGetDataSets(vtkDataObject* data,
+                                   vtkstd::vector<vtkDataSet*>& datasets)
+    {
+    vtkCompositeDataSet* cd = vtkCompositeDataSet::SafeDownCast(data);
+    if (!cd)
+      {
+      vtkDataSet* ds = vtkDataSet::SafeDownCast(data);
+      if (ds && ds->GetNumberOfCells() > 0)
+        {
+        datasets.push_back(ds);
+        }
+      return;
+      }
+    vtkCompositeDataIterator* iter = cd->NewIterator();
+    for (iter->InitTraversal(); !iter->IsDoneWithTraversal();
+      iter->GoToNextItem())
+      {
+      vtkDataSet* ds = vtkDataSet::SafeDownCast(iter->GetCurrentDataObject());
+      if (ds && ds->GetNumberOfCells() > 0)
+        {
+        datasets.push_back(ds);
+        }
+      }
+    iter->Delete();
+    }
+}
+
 vtkStandardNewMacro(vtkKdTreeManager);
 vtkCxxSetObjectMacro(vtkKdTreeManager, StructuredProducer, vtkAlgorithm);
 //----------------------------------------------------------------------------
@@ -55,6 +132,11 @@ vtkKdTreeManager::vtkKdTreeManager()
   this->NumberOfPieces = globalController?
     globalController->GetNumberOfProcesses() : 1;
   this->KdTreeInitialized = false;
+  this->ReusePartition = 0;
+  this->BoundsTolerance = 0.1;
+  this->LoadTolerance = 0.25;
+  this->PartitionReused = false;
+  this->Partition = new vtkPartition();
 
   vtkPKdTree* tree = vtkPKdTree::New();
   tree->SetController(globalController);
@@ -71,6 +153,7 @@ vtkKdTreeManager::~vtkKdTreeManager()
   this->SetStructuredProducer(0);
 
   delete this->Producers;
+  delete this->Partition;
 }
 
 //----------------------------------------------------------------------------
@@ -117,6 +200,7 @@ void vtkKdTreeManager::SetKdTree(vtkPKdTree* tree)
     {
     vtkSetObjectBodyMacro(KdTree, vtkPKdTree, tree);
     this->KdTreeInitialized = false;
+    this->Partition->Valid = false;
     }
 }
 
@@ -156,6 +240,19 @@ void vtkKdTreeManager::Update()
     return;
     }
 
+  // Decide whether the current partition can be kept before the tree is
+  // given the new data.
+  bool reusePartition = false;
+  vtkstd::vector<vtkDataSet*> datasets;
+  if (this->ReusePartition && !this->StructuredProducer)
+    {
+    for (dsIter = outputs.begin(); dsIter != outputs.end(); ++dsIter)
+      {
+      vtkKdTreeManagerGetDataSets(*dsIter, datasets);
+      }
+    reusePartition = this->CanReusePartition(datasets);
+    }
+
   this->KdTree->RemoveAllDataSets();
   if (!this->KdTreeInitialized)
     {
@@ -188,6 +285,15 @@ void vtkKdTreeManager::Update()
     generator->BuildTree(this->StructuredProducer->GetOutputDataObject(0));
     generator->Delete();
     }
+  else if (reusePartition)
+    {
+    // Locate the new data with a copy of the current cuts.  Cells that stay
+    // in their region stay on their process.
+    vtkBSPCuts* cuts = vtkBSPCuts::New();
+    cuts->CreateCuts(this->KdTree->GetCuts()->GetKdNodeTree());
+    this->KdTree->SetCuts(cuts);
+    cuts->Delete();
+    }
   else
     {
     // Ensure that the kdtree is not using predefined cuts.
@@ -199,9 +305,125 @@ void vtkKdTreeManager::Update()
 
   this->KdTree->BuildLocator();
   //this->KdTree->PrintTree();
+
+  if (!reusePartition)
+    {
+    // Remember what the new partition was built for.  The tree already
+    // reduced the bounds of the data.
+    this->Partition->Valid = false;
+    if (this->ReusePartition && !this->StructuredProducer)
+      {
+      this->KdTree->GetBounds(this->Partition->Bounds);
+      this->Partition->Valid = this->ComputeRegionLoads(datasets,
+        VTK_DOUBLE_MAX, this->Partition->Loads);
+      this->Partition->SetProducers(this->Producers);
+      }
+    }
+  this->PartitionReused = reusePartition;
   this->UpdateTime.Modified();
 }
 
+//-----------------------------------------------------------------------------
+// All processes must call this with the same producers.
+bool vtkKdTreeManager::CanReusePartition(
+  vtkstd::vector<vtkDataSet*>& datasets)
+{
+  if (!this->Partition->Valid || !this->KdTree->GetCuts() ||
+    !this->Partition->SameProducers(this->Producers))
+    {
+    return false;
+    }
+
+  const double* bounds = this->Partition->Bounds;
+  double diagonal = 0.0;
+  for (int cc = 0; cc < 3; cc++)
+    {
+    double length = bounds[2*cc+1] - bounds[2*cc];
+    diagonal += length*length;
+    }
+  double margin = this->BoundsTolerance * sqrt(diagonal);
+
+  vtkstd::vector<vtkIdType> loads;
+  if (!this->ComputeRegionLoads(datasets, margin, loads) ||
+    loads.size() != this->Partition->Loads.size() || loads.empty())
+    {
+    return false;
+    }
+  double average = 0.0;
+  size_t region;
+  for (region = 0; region < loads.size(); region++)
+    {
+    average += this->Partition->Loads[region];
+    }
+  average /= loads.size();
+  double maxChange = this->LoadTolerance * average;
+  for (region = 0; region < loads.size(); region++)
+    {
+    double change = static_cast<double>(loads[region]) -
+      static_cast<double>(this->Partition->Loads[region]);
+    if (fabs(change) > maxChange)
+      {
+      return false;
+      }
+    }
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+// The load of a region is estimated from a sample of at most
+// VTK_KD_TREE_MANAGER_LOAD_SAMPLES points of each data set, each standing for
+// the points skipped after it.  Points are much cheaper to get than cell
+// bounds.  They are clamped to the bounds the partition was built for, since
+// the outer regions of reused cuts grow to hold the data that moved out.
+// The points farther out than margin are counted in the same reduction.
+bool vtkKdTreeManager::ComputeRegionLoads(
+  vtkstd::vector<vtkDataSet*>& datasets, double margin,
+  vtkstd::vector<vtkIdType>& loads)
+{
+  int numRegions = this->KdTree->GetNumberOfRegions();
+  if (numRegions <= 0)
+    {
+    loads.clear();
+    return false;
+    }
+
+  // The last entry counts the points too far out of the bounds.
+  const double* bounds = this->Partition->Bounds;
+  vtkstd::vector<vtkIdType> localLoads(numRegions + 1, 0);
+  for (size_t cc = 0; cc < datasets.size(); cc++)
+    {
+    vtkDataSet* ds = datasets[cc];
+    vtkIdType numPoints = ds->GetNumberOfPoints();
+    vtkIdType stride = numPoints / VTK_KD_TREE_MANAGER_LOAD_SAMPLES + 1;
+    double point[3];
+    for (vtkIdType ptId = 0; ptId < numPoints; ptId += stride)
+      {
+      ds->GetPoint(ptId, point);
+      bool tooFar = false;
+      for (int i = 0; i < 3; i++)
+        {
+        tooFar = tooFar || point[i] < bounds[2*i] - margin ||
+          point[i] > bounds[2*i+1] + margin;
+        point[i] = point[i] < bounds[2*i] ? bounds[2*i] : point[i];
+        point[i] = point[i] > bounds[2*i+1] ? bounds[2*i+1] : point[i];
+        }
+      int region =
+        this->KdTree->GetRegionContainingPoint(point[0], point[1], point[2]);
+      vtkIdType weight =
+        ptId + stride <= numPoints ? stride : numPoints - ptId;
+      localLoads[!tooFar && region >= 0 && region < numRegions ?
+                 region : numRegions] += weight;
+      }
+    }
+
+  loads.resize(numRegions + 1);
+  this->KdTree->GetController()->AllReduce(&localLoads[0], &loads[0],
+    numRegions + 1, vtkCommunicator::SUM_OP);
+  bool allInside = (loads[numRegions] == 0);
+  loads.resize(numRegions);
+  return allInside;
+}
+
 //-----------------------------------------------------------------------------
 void vtkKdTreeManager::AddDataObjectToKdTree(vtkDataObject* data)
 {
@@ -319,6 +541,10 @@ void vtkKdTreeManager::PrintSelf(ostream& os, vtkIndent indent)
   this->Superclass::PrintSelf(os, indent);
   os << indent << "KdTree: " << this->KdTree << endl;
   os << indent << "NumberOfPieces: " << this->NumberOfPieces << endl;
+  os << indent << "ReusePartition: " << this->ReusePartition << endl;
+  os << indent << "BoundsTolerance: " << this->BoundsTolerance << endl;
+  os << indent << "LoadTolerance: " << this->LoadTolerance << endl;
+  os << indent << "PartitionReused: " << this->PartitionReused << endl;
 }
 
 
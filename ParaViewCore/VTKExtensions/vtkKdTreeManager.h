@@ -14,12 +14,20 @@
 =========================================================================*/
 // .NAME vtkKdTreeManager
 // .SECTION Description
-//
+// vtkKdTreeManager builds the vtkPKdTree used to distribute data for ordered
+// compositing.  By default the tree is partitioned again whenever the data
+// of a producer changes.  With ReusePartition on, the cuts are kept as long
+// as the data stays close to what they were built for, which saves
+// partitioning again and keeps every region on the same process.  The data
+// is still distributed along the cuts on every update: reusing the partition
+// only saves computing the cuts.  Deciding to reuse it costs one reduction of
+// the region loads, estimated from a sample of the points.
 
 #ifndef __vtkKdTreeManager_h
 #define __vtkKdTreeManager_h
 
 #include "vtkObject.h"
+#include <vtkstd/vector> // needed for vtkstd::vector
 
 class vtkPKdTree;
 class vtkAlgorithm;
@@ -59,6 +67,37 @@ public:
   vtkSetMacro(NumberOfPieces, int);
   vtkGetMacro(NumberOfPieces, int);
 
+  // Description:
+  // When on, Update keeps the current partition if the producers are the
+  // same, their data grew by less than BoundsTolerance out of the bounds
+  // of the partition and the number of points of every region changed by
+  // less than LoadTolerance since the partition was built.  Data that
+  // shrinks changes the loads of the outer regions.  Not used with a
+  // StructuredProducer.
+  // vtkPVRenderView::SetReuseOrderedCompositingPartition() sets it for
+  // ordered compositing.  Off by default.
+  vtkSetMacro(ReusePartition, int);
+  vtkGetMacro(ReusePartition, int);
+  vtkBooleanMacro(ReusePartition, int);
+
+  // Description:
+  // Largest distance of a point out of the bounds the partition was built
+  // for, as a fraction of the diagonal of these bounds. 0.1 by default.
+  vtkSetClampMacro(BoundsTolerance, double, 0.0, VTK_DOUBLE_MAX);
+  vtkGetMacro(BoundsTolerance, double);
+
+  // Description:
+  // Largest change of the number of points in a region, as a fraction of the
+  // average number of points per region when the partition was built.
+  // 0.25 by default.
+  vtkSetClampMacro(LoadTolerance, double, 0.0, VTK_DOUBLE_MAX);
+  vtkGetMacro(LoadTolerance, double);
+
+  // Description:
+  // Returns true if the last Update that processed new data kept the
+  // partition.
+  vtkGetMacro(PartitionReused, bool);
+
 //BTX
 protected:
   vtkKdTreeManager();
@@ -67,11 +106,28 @@ protected:
   void AddDataObjectToKdTree(vtkDataObject *data);
   void AddDataSetToKdTree(vtkDataSet *data);
 
+  // Description:
+  // Is the current partition still good enough for the data?
+  bool CanReusePartition(vtkstd::vector<vtkDataSet*>& datasets);
+
+  // Description:
+  // Estimate the number of points of the data on all processes in each
+  // region of the current partition, with one reduction.  Returns false if
+  // a point is farther than margin out of the bounds the partition was built
+  // for.
+  bool ComputeRegionLoads(vtkstd::vector<vtkDataSet*>& datasets,
+                          double margin, vtkstd::vector<vtkIdType>& loads);
+
   bool KdTreeInitialized;
   vtkAlgorithm* StructuredProducer;
   vtkPKdTree* KdTree;
   int NumberOfPieces;
   vtkTimeStamp UpdateTime;
+
+  int ReusePartition;
+  double BoundsTolerance;
+  double LoadTolerance;
+  bool PartitionReused;
 private:
   vtkKdTreeManager(const vtkKdTreeManager&); // Not implemented
   void operator=(const vtkKdTreeManager&); // Not implemented
@@ -79,6 +135,10 @@ private:
   class vtkAlgorithmSet;
   vtkAlgorithmSet* Producers;
 
+  // What the current partition was built for.
+  class vtkPartition;
+  vtkPartition* Partition;
+
 //ETX
 };
 
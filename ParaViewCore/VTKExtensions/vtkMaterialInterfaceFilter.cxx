@@ -24,6 +24,7 @@
 // PV interface
 #include "vtkCallbackCommand.h"
 #include "vtkMath.h"
+#include "vtkMultiThreader.h"
 #include "vtkDataArraySelection.h"
 // Data sets
 #include "vtkDataSet.h"
@@ -79,6 +80,7 @@ using vtkstd::vector;
 #include "vtkstd/string"
 using vtkstd::string;
 #include "vtkstd/algorithm"
+#include "vtkstd/list"
 // ansi c
 #include <math.h>
 #include <ctime>
@@ -89,6 +91,13 @@ using vtkstd::string;
 #include "vtkPlane.h"
 #include "vtkSphere.h"
 
+#include "vtkToolkits.h"
+#ifdef VTK_USE_MPI
+#define VTK_MATERIAL_INTERFACE_FILTER_USE_MPI_ASYNCHRONOUS
+#include "vtkMPIController.h"
+#include "vtkMPICommunicator.h"
+#endif
+
 class InitializeVolumeFractrionArray;
 
 vtkStandardNewMacro(vtkMaterialInterfaceFilter);
@@ -524,6 +533,10 @@ public:
   // resolve equivalent fragment ids.
   int GetOwnerProcessId() { return this->ProcessId;}
   int GetBlockId() { return this->BlockId;}
+  // The worker that labels the voxels of this block while the blocks
+  // of this process are processed by several threads.
+  int GetWorkerId() { return this->WorkerId;}
+  void SetWorkerId(int id) { this->WorkerId = id;}
 
   //Returns a pointer to the minimum AMR Extent with is the first
   // cell values that is not a ghost cell.
@@ -584,6 +597,7 @@ private:
   // resolve equivalent fragment ids.
   int BlockId;
   int ProcessId;
+  int WorkerId;
   // This id is for connectivity computation.
   // It is essentially a cell array of the image.
   int *FragmentIds;
@@ -632,6 +646,7 @@ private:
 vtkMaterialInterfaceFilterBlock::vtkMaterialInterfaceFilterBlock ()
 {
   this->GhostFlag = 0;
+  this->WorkerId = 0;
   this->Image = 0;
   this->VolumeFractionArray = 0;
   this->WeHaveToDeleteTheVolumeFractionMemory = 0;
@@ -1560,6 +1575,274 @@ int vtkMaterialInterfaceFilterRingBuffer::Pop(vtkMaterialInterfaceFilterIterator
 
 //============================================================================
 
+//----------------------------------------------------------------------------
+// Where a worker found a fragment, to number the fragments of all the
+// workers in block order.
+struct vtkMaterialInterfaceFilterFragmentOrder
+{
+  int BlockId;
+  int WorkerId;
+  int Index;
+
+  bool operator<(const vtkMaterialInterfaceFilterFragmentOrder &other) const
+  {
+    if (this->BlockId != other.BlockId)
+      {
+      return this->BlockId < other.BlockId;
+      }
+    if (this->WorkerId != other.WorkerId)
+      {
+      return this->WorkerId < other.WorkerId;
+      }
+    return this->Index < other.Index;
+  }
+};
+
+//----------------------------------------------------------------------------
+// The state of one thread of the connectivity search.  Each worker labels
+// the voxels of its own range of blocks.  It integrates the current
+// fragment and builds its surface here, and it keeps the fragments it
+// finishes until all the workers are done.  Voxels that belong to another
+// worker (or to a ghost block) are kept as contacts and connected after
+// the pass, when the fragment ids are final.
+class vtkMaterialInterfaceFilterWorker
+{
+public:
+  vtkMaterialInterfaceFilterWorker();
+  ~vtkMaterialInterfaceFilterWorker();
+
+  // Forget the fragments of the last pass and size the accumulators like
+  // the arrays the fragments are saved into.
+  void Initialize(vtkMaterialInterfaceFilter *filter,
+                  int id, int numberOfWorkers,
+                  vector<vtkDoubleArray *> &volumeWtdAvgs,
+                  vector<vtkDoubleArray *> &massWtdAvgs,
+                  vector<vtkDoubleArray *> &sums);
+
+  // Start a new fragment. Its label becomes the current fragment id.
+  void NewFragment(vtkPolyData *mesh);
+  // Save the current fragment and clear the accumulators.
+  void FinishFragment();
+
+  // Keep two neighboring voxels to connect them after the pass.
+  void AddContact(vtkMaterialInterfaceFilterIterator *voxel1,
+                  vtkMaterialInterfaceFilterIterator *voxel2)
+  {
+    this->Contacts.push_back(*voxel1);
+    this->Contacts.push_back(*voxel2);
+  }
+
+  vtkMaterialInterfaceFilter *Filter;
+  // Ghost blocks are connected by a worker with id -1.
+  int Id;
+  int NumberOfWorkers;
+  // The input blocks of this worker, in order.
+  vector<int> BlockIds;
+  // The block being processed.
+  int BlockId;
+
+  // The fragment being connected. Its id is the label of its voxels.
+  // Labels are interleaved: the k'th fragment of a worker is labeled
+  // k*NumberOfWorkers+Id, so that workers never share a label.
+  vtkPolyData *CurrentFragmentMesh;
+  int FragmentId;
+  double FragmentVolume;
+  double ClipDepthMin;
+  double ClipDepthMax;
+  vector<double> FragmentMoment; // =(Myz, Mxz, Mxy, m)
+  vector<vector<double> > FragmentVolumeWtdAvg;
+  vector<vector<double> > FragmentMassWtdAvg;
+  vector<vector<double> > FragmentSum;
+
+  // For computing the point on corners and edges of a face.
+  vtkMaterialInterfaceFilterIterator FaceNeighbors[32];
+  // Permutation of the neighbors. Axis0 normal to face.
+  int faceAxis0;
+  int faceAxis1;
+  int faceAxis2;
+  double FaceCornerPoints[12];
+  double FaceEdgePoints[12];
+  int    FaceEdgeFlags[4];
+
+  // The fragments finished by this worker, in the order they were found,
+  // and the block each of them was found in.
+  vector<vtkPolyData *> FragmentMeshes;
+  vector<int> FragmentBlockIds;
+  // Their volume, clip depth max and min, moments, volume and mass
+  // weighted averages and sums. AttributeStride values per fragment.
+  vector<double> FragmentAttributes;
+  int AttributeStride;
+  // Pairs of labels of the same fragment.
+  vector<int> Equivalences;
+  // Pairs of neighboring voxels, the second may not be labeled yet.
+  vector<vtkMaterialInterfaceFilterIterator> Contacts;
+};
+
+//----------------------------------------------------------------------------
+vtkMaterialInterfaceFilterWorker::vtkMaterialInterfaceFilterWorker()
+{
+  this->Filter = 0;
+  this->Id = 0;
+  this->NumberOfWorkers = 1;
+  this->BlockId = -1;
+  this->CurrentFragmentMesh = 0;
+  this->FragmentId = 0;
+  this->FragmentVolume = 0.0;
+  this->ClipDepthMin = VTK_LARGE_FLOAT;
+  this->ClipDepthMax = 0.0;
+  this->FragmentMoment.resize(4,0.0);
+  this->faceAxis0 = 0;
+  this->faceAxis1 = 1;
+  this->faceAxis2 = 2;
+  this->AttributeStride = 7;
+}
+
+//----------------------------------------------------------------------------
+vtkMaterialInterfaceFilterWorker::~vtkMaterialInterfaceFilterWorker()
+{
+  // Fragments that were not handed over to the filter.
+  ClearVectorOfVtkPointers(this->FragmentMeshes);
+}
+
+//----------------------------------------------------------------------------
+void vtkMaterialInterfaceFilterWorker::Initialize(
+  vtkMaterialInterfaceFilter *filter,
+  int id, int numberOfWorkers,
+  vector<vtkDoubleArray *> &volumeWtdAvgs,
+  vector<vtkDoubleArray *> &massWtdAvgs,
+  vector<vtkDoubleArray *> &sums)
+{
+  this->Filter = filter;
+  this->Id = id;
+  this->NumberOfWorkers = numberOfWorkers;
+  this->BlockIds.clear();
+  this->BlockId = -1;
+
+  this->CurrentFragmentMesh = 0;
+  this->FragmentId = -1;
+  this->FragmentVolume = 0.0;
+  this->ClipDepthMin = VTK_LARGE_FLOAT;
+  this->ClipDepthMax = 0.0;
+  FillVector(this->FragmentMoment, 0.0);
+  // volume, clip depth max and min, moments
+  this->AttributeStride = 7;
+  size_t ii;
+  this->FragmentVolumeWtdAvg.resize(volumeWtdAvgs.size());
+  for (ii = 0; ii < volumeWtdAvgs.size(); ++ii)
+    {
+    int nComps = volumeWtdAvgs[ii]->GetNumberOfComponents();
+    this->FragmentVolumeWtdAvg[ii].clear();
+    this->FragmentVolumeWtdAvg[ii].resize(nComps, 0.0);
+    this->AttributeStride += nComps;
+    }
+  this->FragmentMassWtdAvg.resize(massWtdAvgs.size());
+  for (ii = 0; ii < massWtdAvgs.size(); ++ii)
+    {
+    int nComps = massWtdAvgs[ii]->GetNumberOfComponents();
+    this->FragmentMassWtdAvg[ii].clear();
+    this->FragmentMassWtdAvg[ii].resize(nComps, 0.0);
+    this->AttributeStride += nComps;
+    }
+  this->FragmentSum.resize(sums.size());
+  for (ii = 0; ii < sums.size(); ++ii)
+    {
+    int nComps = sums[ii]->GetNumberOfComponents();
+    this->FragmentSum[ii].clear();
+    this->FragmentSum[ii].resize(nComps, 0.0);
+    this->AttributeStride += nComps;
+    }
+
+  ClearVectorOfVtkPointers(this->FragmentMeshes);
+  this->FragmentBlockIds.clear();
+  this->FragmentAttributes.clear();
+  this->Equivalences.clear();
+  this->Contacts.clear();
+}
+
+//----------------------------------------------------------------------------
+void vtkMaterialInterfaceFilterWorker::NewFragment(vtkPolyData *mesh)
+{
+  this->CurrentFragmentMesh = mesh;
+  this->FragmentId = static_cast<int>(this->FragmentMeshes.size())
+    * this->NumberOfWorkers + this->Id;
+}
+
+//----------------------------------------------------------------------------
+void vtkMaterialInterfaceFilterWorker::FinishFragment()
+{
+  // save the current fragment mesh
+  // the id is implicit given by its position in the vector, but only
+  // until fragments are resolved. After resolution we add addributes such
+  // as id, volume, summations averages, etc..
+  this->CurrentFragmentMesh->Squeeze();
+  this->FragmentMeshes.push_back(this->CurrentFragmentMesh);
+  this->FragmentBlockIds.push_back(this->BlockId);
+  this->CurrentFragmentMesh = 0;
+
+  // Save the integrated attributes and clear the accumulators.
+  vector<double> &attributes = this->FragmentAttributes;
+  attributes.push_back(this->FragmentVolume);
+  attributes.push_back(this->ClipDepthMax);
+  attributes.push_back(this->ClipDepthMin);
+  attributes.insert(attributes.end(),
+                    this->FragmentMoment.begin(), this->FragmentMoment.end());
+  this->FragmentVolume = 0.0;
+  this->ClipDepthMax = 0.0;
+  this->ClipDepthMin = VTK_LARGE_FLOAT;
+  FillVector(this->FragmentMoment, 0.0);
+  size_t ii;
+  for (ii = 0; ii < this->FragmentVolumeWtdAvg.size(); ++ii)
+    {
+    attributes.insert(attributes.end(),
+                      this->FragmentVolumeWtdAvg[ii].begin(),
+                      this->FragmentVolumeWtdAvg[ii].end());
+    FillVector(this->FragmentVolumeWtdAvg[ii], 0.0);
+    }
+  for (ii = 0; ii < this->FragmentMassWtdAvg.size(); ++ii)
+    {
+    attributes.insert(attributes.end(),
+                      this->FragmentMassWtdAvg[ii].begin(),
+                      this->FragmentMassWtdAvg[ii].end());
+    FillVector(this->FragmentMassWtdAvg[ii], 0.0);
+    }
+  for (ii = 0; ii < this->FragmentSum.size(); ++ii)
+    {
+    attributes.insert(attributes.end(),
+                      this->FragmentSum[ii].begin(),
+                      this->FragmentSum[ii].end());
+    FillVector(this->FragmentSum[ii], 0.0);
+    }
+}
+
+//============================================================================
+// The ghost blocks requested from other processes and the replies to their
+// requests, while they are in flight.
+class vtkMaterialInterfaceGhostExchange
+{
+public:
+  struct Message
+  {
+    // Process and block id of the ghost block, its level and the extent
+    // that is sent.
+    int Process;
+    int BlockId;
+    int Level;
+    int Extent[6];
+    vtkSmartPointer<vtkCharArray> Buffer;
+#ifdef VTK_MATERIAL_INTERFACE_FILTER_USE_MPI_ASYNCHRONOUS
+    vtkMPICommunicator::Request Request;
+#endif
+  };
+  // Ghost blocks we receive, in the order they are added to the grid.
+  vtkstd::list<Message> Receives;
+  // Our request counts and lists, and the ghost blocks we send.
+  vtkstd::list<Message> Sends;
+  vector<int> RequestCounts;
+  vector<vector<int> > RequestLists;
+};
+
+//============================================================================
+
 
 
 //----------------------------------------------------------------------------
@@ -1569,16 +1852,19 @@ int vtkMaterialInterfaceFilterRingBuffer::Pop(vtkMaterialInterfaceFilterIterator
 vtkMaterialInterfaceFilter::vtkMaterialInterfaceFilter()
 {
   this->Controller = vtkMultiProcessController::GetGlobalController();
+  this->GhostExchange = 0;
+  this->NumberOfThreads = 0;
 
-#ifdef vtkMaterialInterfaceFilterPROFILE
-// Lets profile to see what takes the most time for large number of processes.
+  // Lets profile to see what takes the most time for large number of processes.
+  this->Profile = false;
   this->InitializeBlocksTimer = vtkSmartPointer<vtkTimerLog>::New();
   this->ShareGhostBlocksTimer = vtkSmartPointer<vtkTimerLog>::New();
   this->NumberOfBlocks = 0;
   this->NumberOfGhostBlocks = 0;
   this->ProcessBlocksTimer = vtkSmartPointer<vtkTimerLog>::New();
+  this->ProcessInteriorBlocksTimer = vtkSmartPointer<vtkTimerLog>::New();
+  this->WaitForGhostBlocksTimer = vtkSmartPointer<vtkTimerLog>::New();
   this->ResolveEquivalencesTimer = vtkSmartPointer<vtkTimerLog>::New();
-#endif
 
 
   #ifdef vtkMaterialInterfaceFilterDEBUG
@@ -1638,17 +1924,13 @@ vtkMaterialInterfaceFilter::vtkMaterialInterfaceFilter()
   this->RootSpacing[0]=this->RootSpacing[1]=this->RootSpacing[2]=1.0;
 
   this->FragmentId = 0;
-  this->FragmentVolume = 0.0;
   this->FragmentVolumes = 0;
-  this->FragmentMoment.resize(4,0.0);
   this->FragmentMoments = 0;
   this->FragmentAABBCenters=0;
   this->FragmentOBBs = 0;
   this->FragmentSplitGeometry=0;
 
   // Keep depth of crater along clip plane normal.
-  this->ClipDepthMax = 0.0;
-  this->ClipDepthMin = VTK_LARGE_FLOAT;
   this->ClipDepthMaximums = 0;
   this->ClipDepthMinimums = 0;
 
@@ -1663,10 +1945,6 @@ vtkMaterialInterfaceFilter::vtkMaterialInterfaceFilter()
   this->ResolvedFragmentCenters=0;
   this->ResolvedFragmentOBBs=0;
 
-  this->FaceNeighbors = new vtkMaterialInterfaceFilterIterator[32];
-
-  this->CurrentFragmentMesh = 0;
-
   this->NVolumeWtdAvgs = 0;
   this->NToSum = 0;
   this->ComputeMoments=false;
@@ -1700,15 +1978,13 @@ vtkMaterialInterfaceFilter::vtkMaterialInterfaceFilter()
 //----------------------------------------------------------------------------
 vtkMaterialInterfaceFilter::~vtkMaterialInterfaceFilter()
 {
+  delete this->GhostExchange;
   this->DeleteAllBlocks();
   this->Controller = 0;
   this->GlobalOrigin[0]=this->GlobalOrigin[1]=this->GlobalOrigin[2]=0.0;
   this->RootSpacing[0]=this->RootSpacing[1]=this->RootSpacing[2]=1.0;
 
   this->FragmentId = 0;
-  this->FragmentVolume = 0.0;
-  this->ClipDepthMax = 0.0;
-  this->ClipDepthMin = VTK_LARGE_FLOAT;
 
   this->SetClipFunction(0);
 
@@ -1726,9 +2002,6 @@ vtkMaterialInterfaceFilter::~vtkMaterialInterfaceFilter()
   delete this->EquivalenceSet;
   this->EquivalenceSet = 0;
 
-  delete [] this->FaceNeighbors;
-  this->FaceNeighbors = 0;
-
   // clean up PV interface
   this->MaterialArraySelection->RemoveObserver( this->SelectionObserver );
   this->MaterialArraySelection->Delete();
@@ -1883,10 +2156,7 @@ int vtkMaterialInterfaceFilter::InitializeBlocks(
   int numProcs = this->Controller->GetNumberOfProcesses();
   vtkMaterialInterfaceFilterHalfSphere* sphere = 0;
 
-#ifdef vtkMaterialInterfaceFilterPROFILE
-// Lets profile to see what takes the most time for large number of processes.
   this->InitializeBlocksTimer->StartTimer();
-#endif
 
   //leaving this logic alone rather than moving it into the
   //this->ClipFunction conditional because I don't know enought of the class to
@@ -2030,22 +2300,13 @@ int vtkMaterialInterfaceFilter::InitializeBlocks(
     this->AddBlock(block);
     }
 
-#ifdef vtkMaterialInterfaceFilterPROFILE
-// Lets profile to see what takes the most time for large number of processes.
   this->InitializeBlocksTimer->StopTimer();
-#endif
 
-#ifdef vtkMaterialInterfaceFilterPROFILE
-// Lets profile to see what takes the most time for large number of processes.
   this->ShareGhostBlocksTimer->StartTimer();
-#endif
 
   //cerr << "start ghost blocks\n" << endl;
 
-#ifdef vtkMaterialInterfaceFilterPROFILE
-// Lets profile to see what takes the most time for large number of processes.
   this->NumberOfBlocks = this->NumberOfInputBlocks;
-#endif
 
   // Broadcast all of the block meta data to all processes.
   // Setup ghost layer blocks.
@@ -2055,10 +2316,7 @@ int vtkMaterialInterfaceFilter::InitializeBlocks(
     this->ShareGhostBlocks();
     }
 
-#ifdef vtkMaterialInterfaceFilterPROFILE
-// Lets profile to see what takes the most time for large number of processes.
   this->ShareGhostBlocksTimer->StopTimer();
-#endif
 
   return VTK_OK;
 }
@@ -2793,10 +3051,23 @@ void vtkMaterialInterfaceFilter::ShareGhostBlocks()
   //(void*)gatheredBlockInfo, recvCounts, displacements,
   //MPI_INT, *com->GetMPIComm()->GetHandle());
 
-  this->ComputeAndDistributeGhostBlocks(blocksPerProcess,
-                                        gatheredBlockInfo,
-                                        myProc,
-                                        numProcs);
+#ifdef VTK_MATERIAL_INTERFACE_FILTER_USE_MPI_ASYNCHRONOUS
+  if (vtkMPIController::SafeDownCast(this->Controller))
+    {
+    // The ghost blocks are added by ProcessBlocks when they arrive.
+    this->StartGhostBlockExchange(blocksPerProcess,
+                                  gatheredBlockInfo,
+                                  myProc,
+                                  numProcs);
+    }
+  else
+#endif
+    {
+    this->ComputeAndDistributeGhostBlocks(blocksPerProcess,
+                                          gatheredBlockInfo,
+                                          myProc,
+                                          numProcs);
+    }
   // Send:
   // Process, extent, data,
   // ...
@@ -2804,10 +3075,7 @@ void vtkMaterialInterfaceFilter::ShareGhostBlocks()
   // Process, extent
   // ...
 
-#ifdef vtkMaterialInterfaceFilterPROFILE
-// Lets profile to see what takes the most time for large number of processes.
   this->NumberOfGhostBlocks = this->GhostBlocks.size();
-#endif
 
     /*
 
@@ -2975,6 +3243,231 @@ void vtkMaterialInterfaceFilter::HandleGhostBlockRequests()
     }
 }
 
+//----------------------------------------------------------------------------
+// Same requests as ComputeAndDistributeGhostBlocks, but all of them are
+// posted at once instead of one process at a time. Every process sends the
+// number of blocks it needs to every other process, then the list of
+// (block id, extent) of these blocks. The ghost blocks we need are received
+// without blocking, the requests of the other processes are answered the
+// same way.
+void vtkMaterialInterfaceFilter::StartGhostBlockExchange(
+  int *numBlocksInProc,
+  int* blockMetaData,
+  int myProc,
+  int numProcs)
+{
+#ifdef VTK_MATERIAL_INTERFACE_FILTER_USE_MPI_ASYNCHRONOUS
+  vtkMPIController* controller
+    = vtkMPIController::SafeDownCast(this->Controller);
+  if (controller == 0)
+    {
+    vtkErrorMacro("Internal error:"
+                  " StartGhostBlockExchange called without MPI controller.");
+    return;
+    }
+  delete this->GhostExchange;
+  vtkMaterialInterfaceGhostExchange* exchange
+    = new vtkMaterialInterfaceGhostExchange;
+  this->GhostExchange = exchange;
+  exchange->RequestCounts.resize(numProcs, 0);
+  exchange->RequestLists.resize(numProcs);
+
+  // Find the ghost blocks we need.
+  vtkMaterialInterfaceGhostExchange::Message message;
+  int* blockMetaDataPtr = blockMetaData;
+  int otherProc;
+  for (otherProc = 0; otherProc < numProcs; ++otherProc)
+    {
+    if (otherProc == myProc)
+      {
+      blockMetaDataPtr += 7*numBlocksInProc[myProc];
+      continue;
+      }
+    vector<int> &requestList = exchange->RequestLists[otherProc];
+    for (int id = 0;  id < numBlocksInProc[otherProc]; ++id)
+      {
+      // Block meta data is level and base-cell-extent.
+      message.Process = otherProc;
+      message.BlockId = id;
+      message.Level = blockMetaDataPtr[0];
+      if (this->ComputeRequiredGhostExtent(message.Level, blockMetaDataPtr+1,
+                                           message.Extent))
+        {
+        requestList.push_back(id);
+        requestList.insert(requestList.end(),
+                           message.Extent, message.Extent+6);
+        exchange->Receives.push_back(message);
+        }
+      blockMetaDataPtr += 7;
+      }
+    exchange->RequestCounts[otherProc]
+      = static_cast<int>(requestList.size()/7);
+    }
+
+  // Post our requests.
+  for (otherProc = 0; otherProc < numProcs; ++otherProc)
+    {
+    if (otherProc == myProc)
+      {
+      continue;
+      }
+    exchange->Sends.push_back(vtkMaterialInterfaceGhostExchange::Message());
+    controller->NoBlockSend(&exchange->RequestCounts[otherProc], 1,
+                            otherProc, 708923,
+                            exchange->Sends.back().Request);
+    if (exchange->RequestCounts[otherProc] > 0)
+      {
+      vector<int> &requestList = exchange->RequestLists[otherProc];
+      exchange->Sends.push_back(vtkMaterialInterfaceGhostExchange::Message());
+      controller->NoBlockSend(&requestList[0],
+                              static_cast<int>(requestList.size()),
+                              otherProc, 708924,
+                              exchange->Sends.back().Request);
+      }
+    }
+
+  // Post the receives of the ghost blocks. Messages between two processes
+  // arrive in the order they are sent, which is the order of the requests.
+  vtkstd::list<vtkMaterialInterfaceGhostExchange::Message>::iterator it;
+  for (it = exchange->Receives.begin(); it != exchange->Receives.end(); ++it)
+    {
+    int *ext = it->Extent;
+    int dataSize = (ext[1]-ext[0]+1)*(ext[3]-ext[2]+1)*(ext[5]-ext[4]+1);
+    it->Buffer = vtkSmartPointer<vtkCharArray>::New();
+    it->Buffer->SetNumberOfValues(dataSize);
+    controller->NoBlockReceive(it->Buffer->GetPointer(0), dataSize,
+                               it->Process, 433240, it->Request);
+    }
+
+  // Answer the requests of the other processes.
+  vector<int> requestList;
+  for (otherProc = 0; otherProc < numProcs; ++otherProc)
+    {
+    if (otherProc == myProc)
+      {
+      continue;
+      }
+    int numberOfRequests = 0;
+    controller->Receive(&numberOfRequests, 1, otherProc, 708923);
+    if (numberOfRequests == 0)
+      {
+      continue;
+      }
+    requestList.resize(numberOfRequests*7);
+    controller->Receive(&requestList[0], numberOfRequests*7, otherProc, 708924);
+    for (int ii = 0; ii < numberOfRequests; ++ii)
+      {
+      int blockId = requestList[ii*7];
+      int *ext = &requestList[ii*7+1];
+      vtkMaterialInterfaceFilterBlock* block = 0;
+      if (blockId >= 0 && blockId < this->NumberOfInputBlocks)
+        {
+        block = this->InputBlocks[blockId];
+        }
+      if (block == 0)
+        { // Sanity check. This will lock up!
+        vtkErrorMacro("Missing block request.");
+        return;
+        }
+      int dataSize = (ext[1]-ext[0]+1)*(ext[3]-ext[2]+1)*(ext[5]-ext[4]+1);
+      exchange->Sends.push_back(vtkMaterialInterfaceGhostExchange::Message());
+      vtkMaterialInterfaceGhostExchange::Message &reply
+        = exchange->Sends.back();
+      reply.Buffer = vtkSmartPointer<vtkCharArray>::New();
+      reply.Buffer->SetNumberOfValues(dataSize);
+      block->ExtractExtent(
+        reinterpret_cast<unsigned char*>(reply.Buffer->GetPointer(0)), ext);
+      controller->NoBlockSend(reply.Buffer->GetPointer(0), dataSize,
+                              otherProc, 433240, reply.Request);
+      }
+    }
+#else
+  (void)numBlocksInProc;
+  (void)blockMetaData;
+  (void)myProc;
+  (void)numProcs;
+#endif
+}
+
+//----------------------------------------------------------------------------
+// Wait for the ghost blocks started by StartGhostBlockExchange and add them
+// to the grid, in the order ComputeAndDistributeGhostBlocks adds them.
+void vtkMaterialInterfaceFilter::FinishGhostBlockExchange()
+{
+  vtkMaterialInterfaceGhostExchange* exchange = this->GhostExchange;
+  if (exchange == 0)
+    {
+    return;
+    }
+#ifdef VTK_MATERIAL_INTERFACE_FILTER_USE_MPI_ASYNCHRONOUS
+  vtkstd::list<vtkMaterialInterfaceGhostExchange::Message>::iterator it;
+  for (it = exchange->Receives.begin(); it != exchange->Receives.end(); ++it)
+    {
+    it->Request.Wait();
+    // Make the ghost block and add it to the grid.
+    vtkMaterialInterfaceFilterBlock* ghostBlock
+      = new vtkMaterialInterfaceFilterBlock;
+    ghostBlock->InitializeGhostLayer(
+      reinterpret_cast<unsigned char*>(it->Buffer->GetPointer(0)),
+      it->Extent, it->Level,
+      this->GlobalOrigin, this->RootSpacing,
+      it->Process, it->BlockId);
+    // Save for deleting.
+    this->GhostBlocks.push_back(ghostBlock);
+    // Add to grid and connect up neighbors.
+    this->AddBlock(ghostBlock);
+    }
+  for (it = exchange->Sends.begin(); it != exchange->Sends.end(); ++it)
+    {
+    it->Request.Wait();
+    }
+#endif
+  delete exchange;
+  this->GhostExchange = 0;
+
+  this->NumberOfGhostBlocks = this->GhostBlocks.size();
+}
+
+//----------------------------------------------------------------------------
+// A block waits for the ghost blocks in flight if one of them is within
+// two of its voxels. Extents are compared at the finer of the two levels.
+int vtkMaterialInterfaceFilter::IsBoundaryBlock(
+  vtkMaterialInterfaceFilterBlock* block)
+{
+  if (block == 0 || this->GhostExchange == 0)
+    {
+    return 0;
+    }
+  int blockLevel = block->GetLevel();
+  const int *blockExt = block->GetBaseCellExtent();
+  vtkstd::list<vtkMaterialInterfaceGhostExchange::Message> &ghosts
+    = this->GhostExchange->Receives;
+  vtkstd::list<vtkMaterialInterfaceGhostExchange::Message>::iterator it;
+  for (it = ghosts.begin(); it != ghosts.end(); ++it)
+    {
+    int level = blockLevel > it->Level ? blockLevel : it->Level;
+    int blockFactor = 1 << (level - blockLevel);
+    int ghostFactor = 1 << (level - it->Level);
+    int touches = 1;
+    for (int ii = 0; ii < 3 && touches; ++ii)
+      {
+      int blockMin = (blockExt[2*ii] - 2) * blockFactor;
+      int blockMax = (blockExt[2*ii+1] + 3) * blockFactor - 1;
+      int ghostMin = it->Extent[2*ii] * ghostFactor;
+      int ghostMax = (it->Extent[2*ii+1] + 1) * ghostFactor - 1;
+      if (blockMax < ghostMin || ghostMax < blockMin)
+        {
+        touches = 0;
+        }
+      }
+    if (touches)
+      {
+      return 1;
+      }
+    }
+  return 0;
+}
+
 //----------------------------------------------------------------------------
 // TODO: Try to not get extents supplied by existing overlap.
 // Return 1 if we need this ghost block.  Ext is the part we need.
@@ -3123,14 +3616,11 @@ void vtkMaterialInterfaceFilter::PrepareForPass(
 {
   this->FragmentId = 0;
 
-  this->FragmentVolume = 0.0;
   ReNewVtkPointer(this->FragmentVolumes);
   this->FragmentVolumes->SetName("Volume");
 
   if (this->ClipWithPlane)
     {
-    this->ClipDepthMax = 0.0;
-    this->ClipDepthMin = VTK_LARGE_FLOAT;
     ReNewVtkPointer(this->ClipDepthMaximums);
     ReNewVtkPointer(this->ClipDepthMinimums);
     this->ClipDepthMaximums->SetName("ClipDepthMax");
@@ -3139,8 +3629,6 @@ void vtkMaterialInterfaceFilter::PrepareForPass(
 
   if (this->ComputeMoments)
     {
-    this->FragmentMoment.clear();
-    this->FragmentMoment.resize(4,0.0);
     ReNewVtkPointer(this->FragmentMoments);
     this->FragmentMoments->SetNumberOfComponents(4);
     this->FragmentMoments->SetName("Moments");
@@ -3178,8 +3666,6 @@ void vtkMaterialInterfaceFilter::PrepareForPass(
   // Configure data structures
   // 1) Volume weighted average of attribute over the
   // fragment set up containers
-  this->FragmentVolumeWtdAvg.clear();
-  this->FragmentVolumeWtdAvg.resize( this->NVolumeWtdAvgs );
   ClearVectorOfVtkPointers( this->FragmentVolumeWtdAvgs );
   this->FragmentVolumeWtdAvgs.resize( this->NVolumeWtdAvgs );
   // set up data array and accumulator for each weighted average
@@ -3204,13 +3690,9 @@ void vtkMaterialInterfaceFilter::PrepareForPass(
     osIntegratedArrayName << "VolumeWeightedAverage-"
                           << thisArrayName;
     this->FragmentVolumeWtdAvgs[j]->SetName( osIntegratedArrayName.str().c_str() );
-    // accumulator
-    this->FragmentVolumeWtdAvg[j].resize( nComp, 0.0 );
     }
   // 2) Mass weighted average of attribute over the fragment
   // set up containers
-  this->FragmentMassWtdAvg.clear();
-  this->FragmentMassWtdAvg.resize(this->NMassWtdAvgs);
   ClearVectorOfVtkPointers(this->FragmentMassWtdAvgs);
   this->FragmentMassWtdAvgs.resize(this->NMassWtdAvgs);
   // set up data array and accumulator for each weighted average
@@ -3235,13 +3717,9 @@ void vtkMaterialInterfaceFilter::PrepareForPass(
     osIntegratedArrayName << "MassWeightedAverage-"
                           << thisArrayName;
     this->FragmentMassWtdAvgs[j]->SetName( osIntegratedArrayName.str().c_str() );
-    // accumulator
-    this->FragmentMassWtdAvg[j].resize( nComp, 0.0 );
     }
   // 3) Summation of attribute over the fragment
   // set up containers
-  this->FragmentSum.clear();
-  this->FragmentSum.resize(this->NToSum);
   ClearVectorOfVtkPointers(this->FragmentSums);
   this->FragmentSums.resize(this->NToSum);
   // set up data array and accumulator for each weighted average
@@ -3266,8 +3744,6 @@ void vtkMaterialInterfaceFilter::PrepareForPass(
     osIntegratedArrayName << "Summation-"
                           << thisArrayName;
     this->FragmentSums[j]->SetName( osIntegratedArrayName.str().c_str() );
-    // accumulator
-    this->FragmentSum[j].resize( nComp, 0.0 );
     }
 
   // 4) Unique list of integrated attributes
@@ -3304,11 +3780,8 @@ int vtkMaterialInterfaceFilter::RequestData(
   vtkInformationVector **inputVector,
   vtkInformationVector *outputVector)
 {
-#ifdef vtkMaterialInterfaceFilterPROFILE
-// Lets profile to see what takes the most time for large number of processes.
   this->NumberOfBlocks = 0;
   this->NumberOfGhostBlocks = 0;
-#endif
 
  if (this->ClipFunction)
     {
@@ -3499,40 +3972,24 @@ int vtkMaterialInterfaceFilter::RequestData(
     this->ProgressBlockInc
       = this->ProgressMaterialInc/(double)this->NumberOfInputBlocks/2.0;
     //
-#ifdef vtkMaterialInterfaceFilterPROFILE
-    // Lets profile to see what takes the most time for large number of processes.
     this->ProcessBlocksTimer->StartTimer();
-#endif
-    int blockId;
-    for (blockId = 0; blockId < this->NumberOfInputBlocks; ++blockId)
-      {
-      // build fragments
-      this->ProcessBlock(blockId);
-      }
-#ifdef vtkMaterialInterfaceFilterPROFILE
-    // Lets profile to see what takes the most time for large number of processes.
+    // build fragments
+    this->ProcessBlocks();
     this->ProcessBlocksTimer->StopTimer();
-#endif
     //char tmp[128];
     //sprintf(tmp, "C:/Law/tmp/mifSurface%d.vtp", this->Controller->GetLocalProcessId());
     //this->SaveBlockSurfaces(tmp);
     //sprintf(tmp, "C:/Law/tmp/mifGhost%d.vtp", this->Controller->GetLocalProcessId());
     //this->SaveGhostSurfaces(tmp);
 
-#ifdef vtkMaterialInterfaceFilterPROFILE
-    // Lets profile to see what takes the most time for large number of processes.
     this->ResolveEquivalencesTimer->StartTimer();
-#endif
 
     // resolve: Merge local and remote geometry
     // correct integrated attributes, finialize integrations
     this->PrepareForResolveEquivalences();
     this->ResolveEquivalences();
 
-#ifdef vtkMaterialInterfaceFilterPROFILE
-    // Lets profile to see what takes the most time for large number of processes.
     this->ResolveEquivalencesTimer->StopTimer();
-#endif
 
     // update the resolved fragment count, so that next pass will start
     // where we left off here
@@ -3594,89 +4051,431 @@ int vtkMaterialInterfaceFilter::RequestData(
   #endif
 
 
-#ifdef vtkMaterialInterfaceFilterPROFILE
-// Lets profile to see what takes the most time for large number of processes.
-  double initializeTime, shareGhostBlocksTime, processBlocksTime, resolveEquivalencesTime;
-  unsigned long numberOfBlocks, numberOfGhostBlocks;
-  initializeTime = this->InitializeBlocksTimer->GetElapsedTime();
-  shareGhostBlocksTime = this->ShareGhostBlocksTimer->GetElapsedTime();
-  processBlocksTime = this->ProcessBlocksTimer->GetElapsedTime();
-  resolveEquivalencesTime = this->ResolveEquivalencesTimer->GetElapsedTime();
-  numberOfBlocks = this->NumberOfBlocks;
-  numberOfGhostBlocks = this->NumberOfGhostBlocks;
-  if (this->Controller == 0)
-    {
-    cout << "InitializeTime: " << initializeTime << endl;
-    cout << "ShareGhostBlocksTime: " << shareGhostBlocksTime << endl;
-    cout << "NumberOfBlocks: " << numberOfBlocks << endl;
-    cout << "NumberOfGhostBlocks: " << numberOfGhostBlocks << endl;
-    cout << "ProcessBlocksTime: " << processBlocksTime << endl;
-    cout << "ResolveEquivalencesTimer: " << resolveEquivalencesTime << endl;
+  // Lets profile to see what takes the most time for large number of processes.
+  if (this->Profile)
+    {
+    this->PrintProfile();
     }
-  else
+
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+// Process 0 prints the times of every process. The wait for the ghost
+// blocks and the blocks processed while they are in flight are part of
+// ProcessBlocksTime.
+void vtkMaterialInterfaceFilter::PrintProfile()
+{
+  const int numberOfTimes = 6;
+  const char *timeNames[numberOfTimes] =
+    {
+    "InitializeTime",
+    "ShareGhostBlocksTime",
+    "ProcessBlocksTime",
+    "ProcessInteriorBlocksTime",
+    "WaitForGhostBlocksTime",
+    "ResolveEquivalencesTimer"
+    };
+  double times[numberOfTimes];
+  times[0] = this->InitializeBlocksTimer->GetElapsedTime();
+  times[1] = this->ShareGhostBlocksTimer->GetElapsedTime();
+  times[2] = this->ProcessBlocksTimer->GetElapsedTime();
+  times[3] = this->ProcessInteriorBlocksTimer->GetElapsedTime();
+  times[4] = this->WaitForGhostBlocksTimer->GetElapsedTime();
+  times[5] = this->ResolveEquivalencesTimer->GetElapsedTime();
+  unsigned long counts[2];
+  counts[0] = this->NumberOfBlocks;
+  counts[1] = this->NumberOfGhostBlocks;
+
+  int numProcs = this->Controller ? this->Controller->GetNumberOfProcesses() : 1;
+  int myProc = this->Controller ? this->Controller->GetLocalProcessId() : 0;
+  if (myProc != 0)
+    {
+    this->Controller->Send(times, numberOfTimes, 0, 234908);
+    this->Controller->Send(counts, 2, 0, 234912);
+    return;
+    }
+  for (int procIdx = 0; procIdx < numProcs; ++procIdx)
+    {
+    if (procIdx > 0)
+      {
+      this->Controller->Receive(times, numberOfTimes, procIdx, 234908);
+      this->Controller->Receive(counts, 2, procIdx, 234912);
+      }
+    cout << "Process " << procIdx << ": \n";
+    for (int ii = 0; ii < numberOfTimes; ++ii)
+      {
+      cout << "  " << timeNames[ii] << ": " << times[ii] << endl;
+      }
+    cout << "  NumberOfBlocks: " << counts[0] << endl;
+    cout << "  NumberOfGhostBlocks: " << counts[1] << endl;
+    }
+}
+
+//----------------------------------------------------------------------------
+// Find the fragments of the local blocks. The blocks are split into
+// contiguous ranges, one for each thread. Each thread labels the voxels of
+// its own blocks only, so the fragments that cross ranges are found in
+// pieces which are made equivalent afterwards. The pieces are numbered in
+// block order: a fragment gets the id of its first voxel in block order,
+// which is the id a single thread gives it.
+// While ghost blocks are in flight, the blocks that do not touch them are
+// processed first and the others once the ghost blocks are in the grid.
+// Numbering in block order keeps the ids of the blocking exchange.
+void vtkMaterialInterfaceFilter::ProcessBlocks()
+{
+  vector<int> phaseBlockIds[2];
+  for (int blockId = 0; blockId < this->NumberOfInputBlocks; ++blockId)
     {
-    int numProcs = this->Controller->GetNumberOfProcesses();
-    if ( this->Controller->GetLocalProcessId() == 0)
-      {
-      cout << "Process 0: \n";
-      cout << "  InitializeTime: " << initializeTime << endl;
-      cout << "  ShareGhostBlocksTime: " << shareGhostBlocksTime << endl;
-      cout << "  NumberOfBlocks: " << numberOfBlocks << endl;
-      cout << "  NumberOfGhostBlocks: " << numberOfGhostBlocks << endl;
-      cout << "  ProcessBlocksTime: " << processBlocksTime << endl;
-      cout << "  ResolveEquivalencesTimer: " << resolveEquivalencesTime << endl;
-      for (int procIdx = 1; procIdx < numProcs; ++procIdx)
+    int boundary = this->IsBoundaryBlock(this->InputBlocks[blockId]);
+    phaseBlockIds[boundary].push_back(blockId);
+    }
+
+  int numberOfThreads = this->NumberOfThreads;
+  if (numberOfThreads == 0)
+    {
+    numberOfThreads = vtkMultiThreader::GetGlobalDefaultNumberOfThreads();
+    int maximum = vtkMultiThreader::GetGlobalMaximumNumberOfThreads();
+    if (maximum > 0 && maximum < numberOfThreads)
+      {
+      numberOfThreads = maximum;
+      }
+    }
+  int phaseWorkers[2];
+  int phase;
+  for (phase = 0; phase < 2; ++phase)
+    {
+    int numberOfBlocks = static_cast<int>(phaseBlockIds[phase].size());
+    phaseWorkers[phase]
+      = numberOfThreads < numberOfBlocks ? numberOfThreads : numberOfBlocks;
+    }
+  if (phaseWorkers[0] + phaseWorkers[1] == 0)
+    {
+    phaseWorkers[0] = 1;
+    }
+  int numberOfWorkers = phaseWorkers[0] + phaseWorkers[1];
+
+  vector<vtkMaterialInterfaceFilterWorker *> workers(numberOfWorkers);
+  int workerId = 0;
+  for (phase = 0; phase < 2; ++phase)
+    {
+    vector<int> &blockIds = phaseBlockIds[phase];
+    int numberOfBlocks = static_cast<int>(blockIds.size());
+    for (int ii = 0; ii < phaseWorkers[phase]; ++ii, ++workerId)
+      {
+      vtkMaterialInterfaceFilterWorker *worker
+        = new vtkMaterialInterfaceFilterWorker;
+      worker->Initialize(this, workerId, numberOfWorkers,
+                         this->FragmentVolumeWtdAvgs,
+                         this->FragmentMassWtdAvgs,
+                         this->FragmentSums);
+      worker->BlockIds.assign(
+        blockIds.begin() + ii*numberOfBlocks/phaseWorkers[phase],
+        blockIds.begin() + (ii+1)*numberOfBlocks/phaseWorkers[phase]);
+      for (size_t jj = 0; jj < worker->BlockIds.size(); ++jj)
         {
-        this->Controller->Receive(&initializeTime, 1, procIdx, 234908);
-        this->Controller->Receive(&shareGhostBlocksTime, 1, procIdx, 234909);
-        this->Controller->Receive(&processBlocksTime, 1, procIdx, 234910);
-        this->Controller->Receive(&resolveEquivalencesTime, 1, procIdx, 234911);
-        this->Controller->Receive(&numberOfBlocks, 1, procIdx, 234912);
-        this->Controller->Receive(&numberOfGhostBlocks, 1, procIdx, 234913);
-        cout << "Process " << procIdx << ": \n";
-        cout << "  InitializeTime: " << initializeTime << endl;
-        cout << "  ShareGhostBlocksTime: " << shareGhostBlocksTime << endl;
-        cout << "  NumberOfBlocks: " << numberOfBlocks << endl;
-        cout << "  NumberOfGhostBlocks: " << numberOfGhostBlocks << endl;
-        cout << "  ProcessBlocksTime: " << processBlocksTime << endl;
-        cout << "  ResolveEquivalencesTimer: " << resolveEquivalencesTime << endl;
+        vtkMaterialInterfaceFilterBlock *block
+          = this->InputBlocks[worker->BlockIds[jj]];
+        if (block)
+          {
+          block->SetWorkerId(workerId);
+          }
         }
+      workers[workerId] = worker;
       }
-    else
+    }
+  // A single worker connects through the ghost blocks as it goes. With
+  // more workers, ghost voxels are labeled once all the workers are done.
+  int ghostWorkerId = numberOfWorkers == 1 ? 0 : -1;
+  size_t ii;
+  for (ii = 0; ii < this->GhostBlocks.size(); ++ii)
+    {
+    this->GhostBlocks[ii]->SetWorkerId(ghostWorkerId);
+    }
+
+  this->ProcessInteriorBlocksTimer->StartTimer();
+  this->RunWorkers(&workers[0], phaseWorkers[0]);
+  this->ProcessInteriorBlocksTimer->StopTimer();
+
+  this->WaitForGhostBlocksTimer->StartTimer();
+  if (this->GhostExchange)
+    {
+    size_t numberOfGhostBlocks = this->GhostBlocks.size();
+    this->FinishGhostBlockExchange();
+    for (ii = numberOfGhostBlocks; ii < this->GhostBlocks.size(); ++ii)
       {
-      this->Controller->Send(&initializeTime, 1, 0, 234908);
-      this->Controller->Send(&shareGhostBlocksTime, 1, 0, 234909);
-      this->Controller->Send(&processBlocksTime, 1, 0, 234910);
-      this->Controller->Send(&resolveEquivalencesTime, 1, 0, 234911);
-      this->Controller->Send(&numberOfBlocks, 1, 0, 234912);
-      this->Controller->Send(&numberOfGhostBlocks, 1, 0, 234913);
+      this->GhostBlocks[ii]->SetWorkerId(ghostWorkerId);
       }
     }
-#endif
+  this->WaitForGhostBlocksTimer->StopTimer();
 
-  return 1;
+  this->RunWorkers(&workers[0] + phaseWorkers[0], phaseWorkers[1]);
+
+  this->MergeWorkers(workers);
+
+  for (workerId = 0; workerId < numberOfWorkers; ++workerId)
+    {
+    delete workers[workerId];
+    }
 }
 
 //----------------------------------------------------------------------------
-int vtkMaterialInterfaceFilter::ProcessBlock(int blockId)
+// Run the workers, the first on this thread and each other one in its own.
+// The threads are spawned rather than run with SingleMethodExecute(), which
+// would limit them to the global maximum of vtkMultiThreader.
+void vtkMaterialInterfaceFilter::RunWorkers(
+  vtkMaterialInterfaceFilterWorker **workers,
+  int numberOfWorkers)
 {
-  #ifdef vtkMaterialInterfaceFilterDEBUG
-  ostringstream progressMesg;
-  progressMesg << "vtkMaterialInterfaceFilter::ProcessBlock("
-               << blockId
-               << ") , Material "
-               << this->MaterialId;
-  this->SetProgressText(progressMesg.str().c_str());
-  #endif
-  this->Progress+=this->ProgressBlockInc;
-  this->UpdateProgress(this->Progress);
+  if (numberOfWorkers == 1)
+    {
+    vector<int> &blockIds = workers[0]->BlockIds;
+    for (size_t ii = 0; ii < blockIds.size(); ++ii)
+      {
+      #ifdef vtkMaterialInterfaceFilterDEBUG
+      ostringstream progressMesg;
+      progressMesg << "vtkMaterialInterfaceFilter::ProcessBlock("
+                   << blockIds[ii]
+                   << ") , Material "
+                   << this->MaterialId;
+      this->SetProgressText(progressMesg.str().c_str());
+      #endif
+      this->Progress+=this->ProgressBlockInc;
+      this->UpdateProgress(this->Progress);
+      // build fragments
+      this->ProcessBlock(blockIds[ii], workers[0]);
+      }
+    }
+  else if (numberOfWorkers > 1)
+    {
+    size_t numberOfBlocks = 0;
+    for (int workerId = 0; workerId < numberOfWorkers; ++workerId)
+      {
+      numberOfBlocks += workers[workerId]->BlockIds.size();
+      }
+    vtkSmartPointer<vtkMultiThreader> threader
+      = vtkSmartPointer<vtkMultiThreader>::New();
+    vector<int> threadIds(numberOfWorkers, -1);
+    int workerId;
+    for (workerId = 1; workerId < numberOfWorkers; ++workerId)
+      {
+      threadIds[workerId] = threader->SpawnThread(
+        vtkMaterialInterfaceFilter::ProcessBlocksThread, workers[workerId]);
+      }
+    vtkMultiThreader::ThreadInfo info;
+    info.ThreadID = 0;
+    info.NumberOfThreads = numberOfWorkers;
+    info.UserData = workers[0];
+    vtkMaterialInterfaceFilter::ProcessBlocksThread(&info);
+    for (workerId = 1; workerId < numberOfWorkers; ++workerId)
+      {
+      if (threadIds[workerId] < 0)
+        {
+        // No thread left, run the worker here.
+        info.ThreadID = workerId;
+        info.UserData = workers[workerId];
+        vtkMaterialInterfaceFilter::ProcessBlocksThread(&info);
+        }
+      else
+        {
+        threader->TerminateThread(threadIds[workerId]);
+        }
+      }
+    this->Progress+=this->ProgressBlockInc*numberOfBlocks;
+    this->UpdateProgress(this->Progress);
+    }
+}
+
+//----------------------------------------------------------------------------
+VTK_THREAD_RETURN_TYPE vtkMaterialInterfaceFilter::ProcessBlocksThread(
+  void *arg)
+{
+  vtkMultiThreader::ThreadInfo *info
+    = static_cast<vtkMultiThreader::ThreadInfo *>(arg);
+  vtkMaterialInterfaceFilterWorker *worker
+    = static_cast<vtkMaterialInterfaceFilterWorker *>(info->UserData);
+  for (size_t ii = 0; ii < worker->BlockIds.size(); ++ii)
+    {
+    worker->Filter->ProcessBlock(worker->BlockIds[ii], worker);
+    }
+  return VTK_THREAD_RETURN_VALUE;
+}
+
+//----------------------------------------------------------------------------
+// Number the fragments of the workers, save them and make their pieces
+// equivalent. Ghost voxels reached by the workers are labeled here.
+void vtkMaterialInterfaceFilter::MergeWorkers(
+  vector<vtkMaterialInterfaceFilterWorker *> &workers)
+{
+  int numberOfWorkers = static_cast<int>(workers.size());
 
+  // Ids are given in block order, then in the order the fragments of a
+  // block were found. That is the order a single worker going through the
+  // blocks in order finds them, whichever worker or phase processed them.
+  vector<vtkMaterialInterfaceFilterFragmentOrder> order;
+  int workerId;
+  for (workerId = 0; workerId < numberOfWorkers; ++workerId)
+    {
+    vector<int> &blockIds = workers[workerId]->FragmentBlockIds;
+    for (size_t ii = 0; ii < blockIds.size(); ++ii)
+      {
+      vtkMaterialInterfaceFilterFragmentOrder fragment;
+      fragment.BlockId = blockIds[ii];
+      fragment.WorkerId = workerId;
+      fragment.Index = static_cast<int>(ii);
+      order.push_back(fragment);
+      }
+    }
+  vtkstd::sort(order.begin(), order.end());
+  int numberOfFragments = static_cast<int>(order.size());
+  vector<vector<int> > fragmentIds(numberOfWorkers);
+  for (workerId = 0; workerId < numberOfWorkers; ++workerId)
+    {
+    fragmentIds[workerId].resize(workers[workerId]->FragmentBlockIds.size());
+    }
+  for (int fragmentId = 0; fragmentId < numberOfFragments; ++fragmentId)
+    {
+    fragmentIds[order[fragmentId].WorkerId][order[fragmentId].Index]
+      = fragmentId;
+    }
+
+  size_t firstMesh = this->FragmentMeshes.size();
+  this->FragmentMeshes.resize(firstMesh + numberOfFragments, 0);
+  for (workerId = 0; workerId < numberOfWorkers; ++workerId)
+    {
+    vtkMaterialInterfaceFilterWorker *worker = workers[workerId];
+    int numberOfWorkerFragments = static_cast<int>(worker->FragmentMeshes.size());
+    for (int ii = 0; ii < numberOfWorkerFragments; ++ii)
+      {
+      int fragmentId = fragmentIds[workerId][ii];
+      const double *attributes
+        = &worker->FragmentAttributes[ii*worker->AttributeStride];
+      this->FragmentMeshes[firstMesh + fragmentId] = worker->FragmentMeshes[ii];
+      this->EquivalenceSet->AddEquivalence(fragmentId, fragmentId);
+      this->FragmentVolumes->InsertTuple1(fragmentId, attributes[0]);
+      if (this->ClipWithPlane)
+        {
+        this->ClipDepthMaximums->InsertTuple1(fragmentId, attributes[1]);
+        this->ClipDepthMinimums->InsertTuple1(fragmentId, attributes[2]);
+        }
+      if (this->ComputeMoments)
+        {
+        this->FragmentMoments->InsertTuple(fragmentId, attributes+3);
+        }
+      attributes += 7;
+      for (int i=0; i<this->NVolumeWtdAvgs; ++i)
+        {
+        this->FragmentVolumeWtdAvgs[i]->InsertTuple(fragmentId, attributes);
+        attributes += this->FragmentVolumeWtdAvgs[i]->GetNumberOfComponents();
+        }
+      for (int i=0; i<this->NMassWtdAvgs; ++i)
+        {
+        this->FragmentMassWtdAvgs[i]->InsertTuple(fragmentId, attributes);
+        attributes += this->FragmentMassWtdAvgs[i]->GetNumberOfComponents();
+        }
+      for (int i=0; i<this->NToSum; ++i)
+        {
+        this->FragmentSums[i]->InsertTuple(fragmentId, attributes);
+        attributes += this->FragmentSums[i]->GetNumberOfComponents();
+        }
+      }
+    // The filter owns the meshes now.
+    worker->FragmentMeshes.clear();
+    }
+  this->FragmentId = numberOfFragments;
 
+  // Replace the labels by the ids. A single worker labels with the ids.
+  if (numberOfWorkers > 1)
+    {
+    for (int blockId = 0; blockId < this->NumberOfInputBlocks; ++blockId)
+      {
+      vtkMaterialInterfaceFilterBlock *block = this->InputBlocks[blockId];
+      if (block == 0)
+        {
+        continue;
+        }
+      int ext[6];
+      block->GetCellExtent(ext);
+      int numCells = (ext[1]-ext[0]+1)*(ext[3]-ext[2]+1)*(ext[5]-ext[4]+1);
+      int *ids = block->GetFragmentIdPointer();
+      for (int ii = 0; ii < numCells; ++ii)
+        {
+        if (ids[ii] >= 0)
+          {
+          ids[ii] = fragmentIds[ids[ii]%numberOfWorkers][ids[ii]/numberOfWorkers];
+          }
+        }
+      }
+    }
+  for (workerId = 0; workerId < numberOfWorkers; ++workerId)
+    {
+    vector<int> &equivalences = workers[workerId]->Equivalences;
+    for (size_t ii = 0; ii+1 < equivalences.size(); ii += 2)
+      {
+      int id1 = equivalences[ii];
+      int id2 = equivalences[ii+1];
+      this->EquivalenceSet->AddEquivalence(
+        fragmentIds[id1%numberOfWorkers][id1/numberOfWorkers],
+        fragmentIds[id2%numberOfWorkers][id2/numberOfWorkers]);
+      }
+    }
+
+  // Connect the voxels that the workers did not label. Unlabeled ghost
+  // voxels are flooded with the id of the fragment that reaches them first,
+  // in the order a single worker would have reached them.
+  vtkMaterialInterfaceFilterWorker ghostWorker;
+  ghostWorker.Initialize(this, -1, numberOfWorkers,
+                         this->FragmentVolumeWtdAvgs,
+                         this->FragmentMassWtdAvgs,
+                         this->FragmentSums);
+  vtkMaterialInterfaceFilterRingBuffer queue;
+  for (workerId = 0; workerId <= numberOfWorkers; ++workerId)
+    {
+    // The ghost worker's contacts come last, they only need equivalences.
+    vtkMaterialInterfaceFilterWorker *worker
+      = workerId < numberOfWorkers ? workers[workerId] : &ghostWorker;
+    vector<vtkMaterialInterfaceFilterIterator> &contacts = worker->Contacts;
+    for (size_t ii = 0; ii+1 < contacts.size(); ii += 2)
+      {
+      vtkMaterialInterfaceFilterIterator *voxel1 = &contacts[ii];
+      vtkMaterialInterfaceFilterIterator *voxel2 = &contacts[ii+1];
+      int id1 = *(voxel1->FragmentIdPointer);
+      int id2 = *(voxel2->FragmentIdPointer);
+      if (id1 != -1 && id2 == -1
+          && voxel2->Block->GetGhostFlag()
+          && voxel2->VolumeFractionPointer[0] >= this->scaledMaterialFractionThreshold)
+        {
+        ghostWorker.FragmentId = id1;
+        *(voxel2->FragmentIdPointer) = id1;
+        queue.Push(voxel2);
+        this->ConnectFragment(&ghostWorker, &queue);
+        }
+      else if (id1 != id2 && id1 != -1 && id2 != -1)
+        {
+        this->EquivalenceSet->AddEquivalence(id1, id2);
+        }
+      }
+    }
+  vector<int> &equivalences = ghostWorker.Equivalences;
+  for (size_t ii = 0; ii+1 < equivalences.size(); ii += 2)
+    {
+    this->EquivalenceSet->AddEquivalence(equivalences[ii], equivalences[ii+1]);
+    }
+}
+
+//----------------------------------------------------------------------------
+// This is called by the worker's thread. Only the voxels of the worker's
+// blocks are labeled.
+int vtkMaterialInterfaceFilter::ProcessBlock(
+  int blockId,
+  vtkMaterialInterfaceFilterWorker *worker)
+{
   vtkMaterialInterfaceFilterBlock* block = this->InputBlocks[blockId];
   if (block == 0)
     {
     return 0;
     }
+  worker->BlockId = blockId;
 
   vtkMaterialInterfaceFilterIterator* xIterator = new vtkMaterialInterfaceFilterIterator;
   vtkMaterialInterfaceFilterIterator* yIterator = new vtkMaterialInterfaceFilterIterator;
@@ -3711,67 +4510,14 @@ int vtkMaterialInterfaceFilter::ProcessBlock(int blockId)
         if (*(xIterator->FragmentIdPointer) == -1 &&
             *(xIterator->VolumeFractionPointer) > this->scaledMaterialFractionThreshold)
           { // We have a new fragment.
-          this->CurrentFragmentMesh=this->NewFragmentMesh();
-          this->EquivalenceSet->AddEquivalence(this->FragmentId,this->FragmentId);
+          worker->NewFragment(this->NewFragmentMesh());
           // We have to mark every voxel we push on the queue.
-          *(xIterator->FragmentIdPointer) = this->FragmentId;
+          *(xIterator->FragmentIdPointer) = worker->FragmentId;
           // There should be no need to clear the queue.
           queue->Push(xIterator);
-          this->ConnectFragment(queue);
-          // save the current fragment mesh
-          // the id is implicit given by its position in the vector, but only
-          // until fragments are resolved. After resolution we add addributes such
-          // as id, volume, summations averages, etc..
-          this->CurrentFragmentMesh->Squeeze();
-          this->FragmentMeshes.push_back( this->CurrentFragmentMesh );
-          // Save the volume from the last fragment.
-          this->FragmentVolumes->InsertTuple1(this->FragmentId, this->FragmentVolume);
-          if (this->ClipWithPlane)
-            {
-            this->ClipDepthMaximums->InsertTuple1(this->FragmentId, this->ClipDepthMax);
-            this->ClipDepthMinimums->InsertTuple1(this->FragmentId, this->ClipDepthMin);
-            }
-          // clear the volume accumulator
-          this->FragmentVolume = 0.0;
-          this->ClipDepthMax = 0.0;
-          this->ClipDepthMin = VTK_LARGE_FLOAT;
-          if (this->ComputeMoments)
-            {
-            // Save the moments from the last fragment
-            this->FragmentMoments->InsertTuple(this->FragmentId,
-                                               &this->FragmentMoment[0]);
-            // clear the moment accumulator
-            FillVector(this->FragmentMoment, 0.0);
-            }
-          // for the volume weighted averaged scalars/vectors...
-          for (int i=0; i<this->NVolumeWtdAvgs; ++i)
-            {
-            // update the integrated value, independent of ncomps
-            this->FragmentVolumeWtdAvgs[i]->InsertTuple(this->FragmentId,
-                                                        &this->FragmentVolumeWtdAvg[i][0]);
-            // clear the accumulator
-            FillVector(this->FragmentVolumeWtdAvg[i],0.0);
-            }
-          // for the mass weighted averaged scalars/vectors...
-          for (int i=0; i<this->NMassWtdAvgs; ++i)
-            {
-            // update the integrated value, independent of ncomps
-            this->FragmentMassWtdAvgs[i]->InsertTuple(this->FragmentId,
-                                                      &this->FragmentMassWtdAvg[i][0]);
-            // clear the accumulator
-            FillVector(this->FragmentMassWtdAvg[i],0.0);
-            }
-          // for the summed scalars/vectors...
-          for (int i=0; i<this->NToSum; ++i)
-            {
-            // update the integrated value, independent of ncomps
-            this->FragmentSums[i]->InsertTuple(this->FragmentId,
-                                               &this->FragmentSum[i][0]);
-            // clear the accumulator
-            FillVector(this->FragmentSum[i],0.0);
-            }
-          // Move to next fragment.
-          ++this->FragmentId;
+          this->ConnectFragment(worker, queue);
+          // Save the mesh and the integrated attributes of the fragment.
+          worker->FinishFragment();
           }
         xIterator->FlatIndex += cellIncs[0]; // 1/ncomp
         xIterator->VolumeFractionPointer += cellIncs[0];
@@ -4100,6 +4846,7 @@ int vtkMaterialInterfaceFilter::ComputeDisplacementFactors(
 // The return value indicates that an edge may be non manifold.
 // It returns the y or z axis index of the edge that may be non manifold.
 int vtkMaterialInterfaceFilter::SubVoxelPositionCorner(
+  vtkMaterialInterfaceFilterWorker* worker,
   double* point,
   vtkMaterialInterfaceFilterIterator* pointNeighborIterators[8],
   int rootNeighborIdx, int faceAxis)
@@ -4152,13 +4899,13 @@ int vtkMaterialInterfaceFilter::SubVoxelPositionCorner(
     projection  = (point[0] - this->ClipCenter[0]) * this->ClipPlaneNormal[0];
     projection += (point[1] - this->ClipCenter[1]) * this->ClipPlaneNormal[1];
     projection += (point[2] - this->ClipCenter[2]) * this->ClipPlaneNormal[2];
-    if (this->ClipDepthMax < projection)
+    if (worker->ClipDepthMax < projection)
       {
-      this->ClipDepthMax = projection;
+      worker->ClipDepthMax = projection;
       }
-    if (this->ClipDepthMin > projection)
+    if (worker->ClipDepthMin > projection)
       {
-      this->ClipDepthMin = projection;
+      worker->ClipDepthMin = projection;
       }
     }
 
@@ -4178,6 +4925,7 @@ int vtkMaterialInterfaceFilter::SubVoxelPositionCorner(
 // I need to have more than 4 points for a face.
 // I am only going to support transitions of 1 level.
 void vtkMaterialInterfaceFilter::CreateFace(
+  vtkMaterialInterfaceFilterWorker* worker,
   vtkMaterialInterfaceFilterIterator* in,
   vtkMaterialInterfaceFilterIterator* out,
   int axis, int outMaxFlag)
@@ -4203,8 +4951,8 @@ void vtkMaterialInterfaceFilter::CreateFace(
   // Add points to the output.  Create separate points for each triangle.
   // We can worry about merging points later.
   vtkMaterialInterfaceFilterIterator* cornerNeighbors[8];
-  vtkPoints *points = this->CurrentFragmentMesh->GetPoints();  //TODO for performance store?
-  vtkCellArray *polys = this->CurrentFragmentMesh->GetPolys();
+  vtkPoints *points = worker->CurrentFragmentMesh->GetPoints();  //TODO for performance store?
+  vtkCellArray *polys = worker->CurrentFragmentMesh->GetPolys();
   vtkIdType quadCornerIds[4];
   vtkIdType quadMidIds[4];
   vtkIdType triPtIds[3];
@@ -4214,12 +4962,12 @@ void vtkMaterialInterfaceFilter::CreateFace(
   quadMidIds[0] = quadMidIds[1] = quadMidIds[2] = quadMidIds[3] = 0;
 
   // Compute the corner and edge points (before subpixel positioning).
-  // Store the results in ivars.
-  this->ComputeFacePoints(in, out,
+  // Store the results in the worker.
+  this->ComputeFacePoints(worker, in, out,
                           axis, outMaxFlag);
   // Find the neighbor iterators.
-  // Store the results in ivars.
-  this->ComputeFaceNeighbors(in, out,
+  // Store the results in the worker.
+  this->ComputeFaceNeighbors(worker, in, out,
                              axis, outMaxFlag);
 
   // A word about indexing:
@@ -4255,55 +5003,59 @@ void vtkMaterialInterfaceFilter::CreateFace(
   // to perform connectivity on the 2x2x2 point neighbors.
   int inNeighborIdx;
 
-  cornerNeighbors[i0] = &(this->FaceNeighbors[0]);
-  cornerNeighbors[i1] = &(this->FaceNeighbors[1]);
-  cornerNeighbors[i2] = &(this->FaceNeighbors[2]);
-  cornerNeighbors[i3] = &(this->FaceNeighbors[3]);
-  cornerNeighbors[i4] = &(this->FaceNeighbors[8]);
-  cornerNeighbors[i5] = &(this->FaceNeighbors[9]);
-  cornerNeighbors[i6] = &(this->FaceNeighbors[10]);
-  cornerNeighbors[i7] = &(this->FaceNeighbors[11]);
+  cornerNeighbors[i0] = &(worker->FaceNeighbors[0]);
+  cornerNeighbors[i1] = &(worker->FaceNeighbors[1]);
+  cornerNeighbors[i2] = &(worker->FaceNeighbors[2]);
+  cornerNeighbors[i3] = &(worker->FaceNeighbors[3]);
+  cornerNeighbors[i4] = &(worker->FaceNeighbors[8]);
+  cornerNeighbors[i5] = &(worker->FaceNeighbors[9]);
+  cornerNeighbors[i6] = &(worker->FaceNeighbors[10]);
+  cornerNeighbors[i7] = &(worker->FaceNeighbors[11]);
   inNeighborIdx = outMaxFlag ? i6 : i7;  // Face neighbor 10 or 11
-  manifoldIssue[0] = this->SubVoxelPositionCorner(this->FaceCornerPoints, cornerNeighbors,
+  manifoldIssue[0] = this->SubVoxelPositionCorner(worker,
+                                                  worker->FaceCornerPoints, cornerNeighbors,
                                                   inNeighborIdx, axis);
   // 1 =>
-  quadCornerIds[0] = points->InsertNextPoint(this->FaceCornerPoints);
-  cornerNeighbors[i0] = &(this->FaceNeighbors[4]);
-  cornerNeighbors[i1] = &(this->FaceNeighbors[5]);
-  cornerNeighbors[i2] = &(this->FaceNeighbors[6]);
-  cornerNeighbors[i3] = &(this->FaceNeighbors[7]);
-  cornerNeighbors[i4] = &(this->FaceNeighbors[12]);
-  cornerNeighbors[i5] = &(this->FaceNeighbors[13]);
-  cornerNeighbors[i6] = &(this->FaceNeighbors[14]);
-  cornerNeighbors[i7] = &(this->FaceNeighbors[15]);
+  quadCornerIds[0] = points->InsertNextPoint(worker->FaceCornerPoints);
+  cornerNeighbors[i0] = &(worker->FaceNeighbors[4]);
+  cornerNeighbors[i1] = &(worker->FaceNeighbors[5]);
+  cornerNeighbors[i2] = &(worker->FaceNeighbors[6]);
+  cornerNeighbors[i3] = &(worker->FaceNeighbors[7]);
+  cornerNeighbors[i4] = &(worker->FaceNeighbors[12]);
+  cornerNeighbors[i5] = &(worker->FaceNeighbors[13]);
+  cornerNeighbors[i6] = &(worker->FaceNeighbors[14]);
+  cornerNeighbors[i7] = &(worker->FaceNeighbors[15]);
   inNeighborIdx = outMaxFlag ? i4 : i5;  // Face neighbor 12 or 13
-  manifoldIssue[1] = this->SubVoxelPositionCorner(this->FaceCornerPoints+3, cornerNeighbors,
+  manifoldIssue[1] = this->SubVoxelPositionCorner(worker,
+                                                  worker->FaceCornerPoints+3, cornerNeighbors,
                                                   inNeighborIdx, axis);
-  quadCornerIds[1] = points->InsertNextPoint(this->FaceCornerPoints+3);
-  cornerNeighbors[i0] = &(this->FaceNeighbors[16]);
-  cornerNeighbors[i1] = &(this->FaceNeighbors[17]);
-  cornerNeighbors[i2] = &(this->FaceNeighbors[18]);
-  cornerNeighbors[i3] = &(this->FaceNeighbors[19]);
-  cornerNeighbors[i4] = &(this->FaceNeighbors[24]);
-  cornerNeighbors[i5] = &(this->FaceNeighbors[25]);
-  cornerNeighbors[i6] = &(this->FaceNeighbors[26]);
-  cornerNeighbors[i7] = &(this->FaceNeighbors[27]);
+  quadCornerIds[1] = points->InsertNextPoint(worker->FaceCornerPoints+3);
+  cornerNeighbors[i0] = &(worker->FaceNeighbors[16]);
+  cornerNeighbors[i1] = &(worker->FaceNeighbors[17]);
+  cornerNeighbors[i2] = &(worker->FaceNeighbors[18]);
+  cornerNeighbors[i3] = &(worker->FaceNeighbors[19]);
+  cornerNeighbors[i4] = &(worker->FaceNeighbors[24]);
+  cornerNeighbors[i5] = &(worker->FaceNeighbors[25]);
+  cornerNeighbors[i6] = &(worker->FaceNeighbors[26]);
+  cornerNeighbors[i7] = &(worker->FaceNeighbors[27]);
   inNeighborIdx = outMaxFlag ? i2 : i3;  // Face neighbor 18 or 19
-  manifoldIssue[2] = this->SubVoxelPositionCorner(this->FaceCornerPoints+6, cornerNeighbors,
+  manifoldIssue[2] = this->SubVoxelPositionCorner(worker,
+                                                  worker->FaceCornerPoints+6, cornerNeighbors,
                                                   inNeighborIdx, axis);
-  quadCornerIds[2] = points->InsertNextPoint(this->FaceCornerPoints+6);
-  cornerNeighbors[i0] = &(this->FaceNeighbors[20]);
-  cornerNeighbors[i1] = &(this->FaceNeighbors[21]);
-  cornerNeighbors[i2] = &(this->FaceNeighbors[22]);
-  cornerNeighbors[i3] = &(this->FaceNeighbors[23]);
-  cornerNeighbors[i4] = &(this->FaceNeighbors[28]);
-  cornerNeighbors[i5] = &(this->FaceNeighbors[29]);
-  cornerNeighbors[i6] = &(this->FaceNeighbors[30]);
-  cornerNeighbors[i7] = &(this->FaceNeighbors[31]);
+  quadCornerIds[2] = points->InsertNextPoint(worker->FaceCornerPoints+6);
+  cornerNeighbors[i0] = &(worker->FaceNeighbors[20]);
+  cornerNeighbors[i1] = &(worker->FaceNeighbors[21]);
+  cornerNeighbors[i2] = &(worker->FaceNeighbors[22]);
+  cornerNeighbors[i3] = &(worker->FaceNeighbors[23]);
+  cornerNeighbors[i4] = &(worker->FaceNeighbors[28]);
+  cornerNeighbors[i5] = &(worker->FaceNeighbors[29]);
+  cornerNeighbors[i6] = &(worker->FaceNeighbors[30]);
+  cornerNeighbors[i7] = &(worker->FaceNeighbors[31]);
   inNeighborIdx = outMaxFlag ? i0 : i1;  // Face neighbor 20 or 21
-  manifoldIssue[3] = this->SubVoxelPositionCorner(this->FaceCornerPoints+9, cornerNeighbors,
+  manifoldIssue[3] = this->SubVoxelPositionCorner(worker,
+                                                  worker->FaceCornerPoints+9, cornerNeighbors,
                                                   inNeighborIdx, axis);
-  quadCornerIds[3] = points->InsertNextPoint(this->FaceCornerPoints+9);
+  quadCornerIds[3] = points->InsertNextPoint(worker->FaceCornerPoints+9);
 
   // If both corners of an edge have an issue, the we need an extra
   // point on the edge to generate a hole.
@@ -4316,98 +5068,98 @@ void vtkMaterialInterfaceFilter::CreateFace(
   if (manifoldIssue[0] != 0 && manifoldIssue[1] != 0 &&
       tmp[manifoldIssue[0]] == 1 && tmp[manifoldIssue[1]] == 1)
     {
-    this->FaceEdgeFlags[0] = 1;
+    worker->FaceEdgeFlags[0] = 1;
     }
 
   if (manifoldIssue[0] != 0 && manifoldIssue[2] != 0 &&
       tmp[manifoldIssue[0]] == 2 && tmp[manifoldIssue[2]] == 2)
     {
-    this->FaceEdgeFlags[1] = 1;
+    worker->FaceEdgeFlags[1] = 1;
     }
   if (manifoldIssue[1] != 0 && manifoldIssue[3] != 0 &&
       tmp[manifoldIssue[1]] == 2 && tmp[manifoldIssue[3]] == 2)
     {
-    this->FaceEdgeFlags[2] = 1;
+    worker->FaceEdgeFlags[2] = 1;
     }
   if (manifoldIssue[2] != 0 && manifoldIssue[3] &&
       tmp[manifoldIssue[2]] == 1 && tmp[manifoldIssue[3]] == 1)
     {
-    this->FaceEdgeFlags[3] = 1;
+    worker->FaceEdgeFlags[3] = 1;
     }
 
 
   // Now for the mid edge point if the neighbors on that side are smaller.
-  if (this->FaceEdgeFlags[0])
-    {
-    cornerNeighbors[i0] = &(this->FaceNeighbors[2]);
-    cornerNeighbors[i1] = &(this->FaceNeighbors[3]);
-    cornerNeighbors[i2] = &(this->FaceNeighbors[4]);
-    cornerNeighbors[i3] = &(this->FaceNeighbors[5]);
-    cornerNeighbors[i4] = &(this->FaceNeighbors[10]);
-    cornerNeighbors[i5] = &(this->FaceNeighbors[11]);
-    cornerNeighbors[i6] = &(this->FaceNeighbors[12]);
-    cornerNeighbors[i7] = &(this->FaceNeighbors[13]);
+  if (worker->FaceEdgeFlags[0])
+    {
+    cornerNeighbors[i0] = &(worker->FaceNeighbors[2]);
+    cornerNeighbors[i1] = &(worker->FaceNeighbors[3]);
+    cornerNeighbors[i2] = &(worker->FaceNeighbors[4]);
+    cornerNeighbors[i3] = &(worker->FaceNeighbors[5]);
+    cornerNeighbors[i4] = &(worker->FaceNeighbors[10]);
+    cornerNeighbors[i5] = &(worker->FaceNeighbors[11]);
+    cornerNeighbors[i6] = &(worker->FaceNeighbors[12]);
+    cornerNeighbors[i7] = &(worker->FaceNeighbors[13]);
     // Two choices here (10, 12) because they both are the same voxel.
     inNeighborIdx = outMaxFlag ? i4 : i5;
-    this->SubVoxelPositionCorner(this->FaceEdgePoints, cornerNeighbors,
-                                 inNeighborIdx, axis);
-    quadMidIds[0] = points->InsertNextPoint(this->FaceEdgePoints);
-    }
-  if (this->FaceEdgeFlags[1])
-    {
-    cornerNeighbors[i0] = &(this->FaceNeighbors[8]);
-    cornerNeighbors[i1] = &(this->FaceNeighbors[9]);
-    cornerNeighbors[i2] = &(this->FaceNeighbors[10]);
-    cornerNeighbors[i3] = &(this->FaceNeighbors[11]);
-    cornerNeighbors[i4] = &(this->FaceNeighbors[16]);
-    cornerNeighbors[i5] = &(this->FaceNeighbors[17]);
-    cornerNeighbors[i6] = &(this->FaceNeighbors[18]);
-    cornerNeighbors[i7] = &(this->FaceNeighbors[19]);
+    this->SubVoxelPositionCorner(worker, worker->FaceEdgePoints,
+                                 cornerNeighbors, inNeighborIdx, axis);
+    quadMidIds[0] = points->InsertNextPoint(worker->FaceEdgePoints);
+    }
+  if (worker->FaceEdgeFlags[1])
+    {
+    cornerNeighbors[i0] = &(worker->FaceNeighbors[8]);
+    cornerNeighbors[i1] = &(worker->FaceNeighbors[9]);
+    cornerNeighbors[i2] = &(worker->FaceNeighbors[10]);
+    cornerNeighbors[i3] = &(worker->FaceNeighbors[11]);
+    cornerNeighbors[i4] = &(worker->FaceNeighbors[16]);
+    cornerNeighbors[i5] = &(worker->FaceNeighbors[17]);
+    cornerNeighbors[i6] = &(worker->FaceNeighbors[18]);
+    cornerNeighbors[i7] = &(worker->FaceNeighbors[19]);
     // Two choices here (10, 18) because they both are the same voxel.
     inNeighborIdx = outMaxFlag ? i2 : i3;
-    this->SubVoxelPositionCorner(this->FaceEdgePoints+3, cornerNeighbors,
-                                 inNeighborIdx, axis);
-    quadMidIds[1] = points->InsertNextPoint(this->FaceEdgePoints+3);
-    }
-  if (this->FaceEdgeFlags[2])
-    {
-    cornerNeighbors[i0] = &(this->FaceNeighbors[12]);
-    cornerNeighbors[i1] = &(this->FaceNeighbors[13]);
-    cornerNeighbors[i2] = &(this->FaceNeighbors[14]);
-    cornerNeighbors[i3] = &(this->FaceNeighbors[15]);
-    cornerNeighbors[i4] = &(this->FaceNeighbors[20]);
-    cornerNeighbors[i5] = &(this->FaceNeighbors[21]);
-    cornerNeighbors[i6] = &(this->FaceNeighbors[22]);
-    cornerNeighbors[i7] = &(this->FaceNeighbors[23]);
+    this->SubVoxelPositionCorner(worker, worker->FaceEdgePoints+3,
+                                 cornerNeighbors, inNeighborIdx, axis);
+    quadMidIds[1] = points->InsertNextPoint(worker->FaceEdgePoints+3);
+    }
+  if (worker->FaceEdgeFlags[2])
+    {
+    cornerNeighbors[i0] = &(worker->FaceNeighbors[12]);
+    cornerNeighbors[i1] = &(worker->FaceNeighbors[13]);
+    cornerNeighbors[i2] = &(worker->FaceNeighbors[14]);
+    cornerNeighbors[i3] = &(worker->FaceNeighbors[15]);
+    cornerNeighbors[i4] = &(worker->FaceNeighbors[20]);
+    cornerNeighbors[i5] = &(worker->FaceNeighbors[21]);
+    cornerNeighbors[i6] = &(worker->FaceNeighbors[22]);
+    cornerNeighbors[i7] = &(worker->FaceNeighbors[23]);
     // Two choices here (12, 20) because they both are the same voxel.
     inNeighborIdx = outMaxFlag ? i0 : i1;
-    this->SubVoxelPositionCorner(this->FaceEdgePoints+6, cornerNeighbors,
-                                 inNeighborIdx, axis);
-    quadMidIds[2] = points->InsertNextPoint(this->FaceEdgePoints+6);
-    }
-  if (this->FaceEdgeFlags[3])
-    {
-    cornerNeighbors[i0] = &(this->FaceNeighbors[18]);
-    cornerNeighbors[i1] = &(this->FaceNeighbors[19]);
-    cornerNeighbors[i2] = &(this->FaceNeighbors[20]);
-    cornerNeighbors[i3] = &(this->FaceNeighbors[21]);
-    cornerNeighbors[i4] = &(this->FaceNeighbors[26]);
-    cornerNeighbors[i5] = &(this->FaceNeighbors[27]);
-    cornerNeighbors[i6] = &(this->FaceNeighbors[28]);
-    cornerNeighbors[i7] = &(this->FaceNeighbors[29]);
+    this->SubVoxelPositionCorner(worker, worker->FaceEdgePoints+6,
+                                 cornerNeighbors, inNeighborIdx, axis);
+    quadMidIds[2] = points->InsertNextPoint(worker->FaceEdgePoints+6);
+    }
+  if (worker->FaceEdgeFlags[3])
+    {
+    cornerNeighbors[i0] = &(worker->FaceNeighbors[18]);
+    cornerNeighbors[i1] = &(worker->FaceNeighbors[19]);
+    cornerNeighbors[i2] = &(worker->FaceNeighbors[20]);
+    cornerNeighbors[i3] = &(worker->FaceNeighbors[21]);
+    cornerNeighbors[i4] = &(worker->FaceNeighbors[26]);
+    cornerNeighbors[i5] = &(worker->FaceNeighbors[27]);
+    cornerNeighbors[i6] = &(worker->FaceNeighbors[28]);
+    cornerNeighbors[i7] = &(worker->FaceNeighbors[29]);
     // Two choices here (18, 20) because they both are the same voxel.
     inNeighborIdx = outMaxFlag ? i0 : i1;
-    this->SubVoxelPositionCorner(this->FaceEdgePoints+9, cornerNeighbors,
-                                 inNeighborIdx, axis);
-    quadMidIds[3] = points->InsertNextPoint(this->FaceEdgePoints+9);
+    this->SubVoxelPositionCorner(worker, worker->FaceEdgePoints+9,
+                                 cornerNeighbors, inNeighborIdx, axis);
+    quadMidIds[3] = points->InsertNextPoint(worker->FaceEdgePoints+9);
     }
 
   // Now there are 9 possibilities
   // (10 if you count the two ways to triangulate the simple quad).
   // No edges, $ cases with one mid point, 4 cases with two mid points.
   // That is all because the face is always the smallest of the two in/out voxels.
-  int caseIdx = this->FaceEdgeFlags[0] | (this->FaceEdgeFlags[1] << 1)
-                  | (this->FaceEdgeFlags[2] << 2) | (this->FaceEdgeFlags[3] << 3);
+  int caseIdx = worker->FaceEdgeFlags[0] | (worker->FaceEdgeFlags[1] << 1)
+                  | (worker->FaceEdgeFlags[2] << 2) | (worker->FaceEdgeFlags[3] << 3);
 
   //c2 e3 c3
   //e1    e2
@@ -4553,10 +5305,10 @@ void vtkMaterialInterfaceFilter::CreateFace(
       // This will help us decide which way to split up the quad into triangles.
       double d0011 = 0.0;
       double d0110 = 0.0;
-      double *pt00 = this->FaceCornerPoints;
-      double *pt01 = this->FaceCornerPoints+3;
-      double *pt10 = this->FaceCornerPoints+6;
-      double *pt11 = this->FaceCornerPoints+9;
+      double *pt00 = worker->FaceCornerPoints;
+      double *pt01 = worker->FaceCornerPoints+3;
+      double *pt10 = worker->FaceCornerPoints+6;
+      double *pt11 = worker->FaceCornerPoints+9;
       for (int ii = 0; ii < 3; ++ii)
         {
         double tmp2 = pt00[ii]-pt11[ii];
@@ -4608,7 +5360,7 @@ void vtkMaterialInterfaceFilter::CreateFace(
 
     // fragment
     vtkDoubleArray *destArray
-      = dynamic_cast<vtkDoubleArray *>(this->CurrentFragmentMesh->GetCellData()->GetArray(i));
+      = dynamic_cast<vtkDoubleArray *>(worker->CurrentFragmentMesh->GetCellData()->GetArray(i));
     for (vtkIdType ii = 0; ii < numTris; ++ii)
       {
       destArray->InsertNextTuple(&thisTup[0]);
@@ -4617,13 +5369,13 @@ void vtkMaterialInterfaceFilter::CreateFace(
   // Cell data attributes for debugging.
   #ifdef vtkMaterialInterfaceFilterDEBUG
   vtkIntArray *levelArray
-    = dynamic_cast<vtkIntArray*>(this->CurrentFragmentMesh->GetCellData()->GetArray("Level"));
+    = dynamic_cast<vtkIntArray*>(worker->CurrentFragmentMesh->GetCellData()->GetArray("Level"));
 
   vtkIntArray *blockIdArray
-    = dynamic_cast<vtkIntArray*>(this->CurrentFragmentMesh->GetCellData()->GetArray("BlockId"));
+    = dynamic_cast<vtkIntArray*>(worker->CurrentFragmentMesh->GetCellData()->GetArray("BlockId"));
 
   vtkIntArray *procIdArray
-    = dynamic_cast<vtkIntArray*>(this->CurrentFragmentMesh->GetCellData()->GetArray("ProcId"));
+    = dynamic_cast<vtkIntArray*>(worker->CurrentFragmentMesh->GetCellData()->GetArray("ProcId"));
 
   for (vtkIdType ii = 0; ii < numTris; ++ii)
     {
@@ -4638,6 +5390,7 @@ void vtkMaterialInterfaceFilter::CreateFace(
 // Computes the face and edge middle points of the shared contact face
 // between the two iterators.
 void vtkMaterialInterfaceFilter::ComputeFacePoints(
+  vtkMaterialInterfaceFilterWorker* worker,
   vtkMaterialInterfaceFilterIterator* in,
   vtkMaterialInterfaceFilterIterator* out,
   int axis, int outMaxFlag)
@@ -4680,40 +5433,41 @@ void vtkMaterialInterfaceFilter::ComputeFacePoints(
   // 6 9
   // 0 3
   // First set them all to the origin.
-  this->FaceCornerPoints[0] = this->FaceCornerPoints[3] =
-    this->FaceCornerPoints[6] = this->FaceCornerPoints[9] = faceOrigin[0];
-  this->FaceCornerPoints[1] = this->FaceCornerPoints[4] =
-    this->FaceCornerPoints[7] = this->FaceCornerPoints[10] = faceOrigin[1];
-  this->FaceCornerPoints[2] = this->FaceCornerPoints[5] =
-    this->FaceCornerPoints[8] = this->FaceCornerPoints[11] = faceOrigin[2];
+  worker->FaceCornerPoints[0] = worker->FaceCornerPoints[3] =
+    worker->FaceCornerPoints[6] = worker->FaceCornerPoints[9] = faceOrigin[0];
+  worker->FaceCornerPoints[1] = worker->FaceCornerPoints[4] =
+    worker->FaceCornerPoints[7] = worker->FaceCornerPoints[10] = faceOrigin[1];
+  worker->FaceCornerPoints[2] = worker->FaceCornerPoints[5] =
+    worker->FaceCornerPoints[8] = worker->FaceCornerPoints[11] = faceOrigin[2];
   // Now offset them to the corners.
-  this->FaceCornerPoints[3+axis1] += spacing[axis1];
-  this->FaceCornerPoints[9+axis1] += spacing[axis1];
-  this->FaceCornerPoints[6+axis2] += spacing[axis2];
-  this->FaceCornerPoints[9+axis2] += spacing[axis2];
+  worker->FaceCornerPoints[3+axis1] += spacing[axis1];
+  worker->FaceCornerPoints[9+axis1] += spacing[axis1];
+  worker->FaceCornerPoints[6+axis2] += spacing[axis2];
+  worker->FaceCornerPoints[9+axis2] += spacing[axis2];
 
   // Now do the same for the edge points
   //   3
   // 1   2
   //   0
   // First set them all to the origin.
-  this->FaceEdgePoints[0] = this->FaceEdgePoints[3] =
-    this->FaceEdgePoints[6] = this->FaceEdgePoints[9] = faceOrigin[0];
-  this->FaceEdgePoints[1] = this->FaceEdgePoints[4] =
-    this->FaceEdgePoints[7] = this->FaceEdgePoints[10] = faceOrigin[1];
-  this->FaceEdgePoints[2] = this->FaceEdgePoints[5] =
-    this->FaceEdgePoints[8] = this->FaceEdgePoints[11] = faceOrigin[2];
+  worker->FaceEdgePoints[0] = worker->FaceEdgePoints[3] =
+    worker->FaceEdgePoints[6] = worker->FaceEdgePoints[9] = faceOrigin[0];
+  worker->FaceEdgePoints[1] = worker->FaceEdgePoints[4] =
+    worker->FaceEdgePoints[7] = worker->FaceEdgePoints[10] = faceOrigin[1];
+  worker->FaceEdgePoints[2] = worker->FaceEdgePoints[5] =
+    worker->FaceEdgePoints[8] = worker->FaceEdgePoints[11] = faceOrigin[2];
   // Now offset the points to the middle of the edges.
-  this->FaceEdgePoints[axis1] += halfSpacing[axis1];
-  this->FaceEdgePoints[9+axis1] += halfSpacing[axis1];
-  this->FaceEdgePoints[6+axis1] += spacing[axis1];
-  this->FaceEdgePoints[3+axis2] += halfSpacing[axis2];
-  this->FaceEdgePoints[6+axis2] += halfSpacing[axis2];
-  this->FaceEdgePoints[9+axis2] += spacing[axis2];
+  worker->FaceEdgePoints[axis1] += halfSpacing[axis1];
+  worker->FaceEdgePoints[9+axis1] += halfSpacing[axis1];
+  worker->FaceEdgePoints[6+axis1] += spacing[axis1];
+  worker->FaceEdgePoints[3+axis2] += halfSpacing[axis2];
+  worker->FaceEdgePoints[6+axis2] += halfSpacing[axis2];
+  worker->FaceEdgePoints[9+axis2] += spacing[axis2];
 }
 
 //----------------------------------------------------------------------------
 void vtkMaterialInterfaceFilter::ComputeFaceNeighbors(
+  vtkMaterialInterfaceFilterWorker* worker,
   vtkMaterialInterfaceFilterIterator* in,
   vtkMaterialInterfaceFilterIterator* out,
   int axis, int outMaxFlag)
@@ -4763,17 +5517,17 @@ void vtkMaterialInterfaceFilter::ComputeFaceNeighbors(
   // for subdivision.
   if (outMaxFlag)
     {
-    this->FaceNeighbors[10] = this->FaceNeighbors[12] =
-       this->FaceNeighbors[18] = this->FaceNeighbors[20] = *in;
-    this->FaceNeighbors[11] = this->FaceNeighbors[13] =
-       this->FaceNeighbors[19] = this->FaceNeighbors[21] = *out;
+    worker->FaceNeighbors[10] = worker->FaceNeighbors[12] =
+       worker->FaceNeighbors[18] = worker->FaceNeighbors[20] = *in;
+    worker->FaceNeighbors[11] = worker->FaceNeighbors[13] =
+       worker->FaceNeighbors[19] = worker->FaceNeighbors[21] = *out;
     }
   else
     {
-    this->FaceNeighbors[10] = this->FaceNeighbors[12] =
-       this->FaceNeighbors[18] = this->FaceNeighbors[20] = *out;
-    this->FaceNeighbors[11] = this->FaceNeighbors[13] =
-       this->FaceNeighbors[19] = this->FaceNeighbors[21] = *in;
+    worker->FaceNeighbors[10] = worker->FaceNeighbors[12] =
+       worker->FaceNeighbors[18] = worker->FaceNeighbors[20] = *out;
+    worker->FaceNeighbors[11] = worker->FaceNeighbors[13] =
+       worker->FaceNeighbors[19] = worker->FaceNeighbors[21] = *in;
     }
 
   // Ok, we have 24 neighbors to compute.
@@ -4783,91 +5537,91 @@ void vtkMaterialInterfaceFilter::ComputeFaceNeighbors(
   // increments: 1, 2, 8
   // Start at the corner and march around the edges.
   faceIndex[axis2] -= 1;
-  this->FindNeighbor(faceIndex, faceLevel, this->FaceNeighbors+3, this->FaceNeighbors+11);
+  this->FindNeighbor(faceIndex, faceLevel, worker->FaceNeighbors+3, worker->FaceNeighbors+11);
   faceIndex[axis1] += 1;
-  this->FindNeighbor(faceIndex, faceLevel, this->FaceNeighbors+5, this->FaceNeighbors+3);
+  this->FindNeighbor(faceIndex, faceLevel, worker->FaceNeighbors+5, worker->FaceNeighbors+3);
   faceIndex[axis1] += 1;
-  this->FindNeighbor(faceIndex, faceLevel, this->FaceNeighbors+7, this->FaceNeighbors+5);
+  this->FindNeighbor(faceIndex, faceLevel, worker->FaceNeighbors+7, worker->FaceNeighbors+5);
   faceIndex[axis2] += 1;
-  this->FindNeighbor(faceIndex, faceLevel, this->FaceNeighbors+15, this->FaceNeighbors+7);
+  this->FindNeighbor(faceIndex, faceLevel, worker->FaceNeighbors+15, worker->FaceNeighbors+7);
   faceIndex[axis2] += 1;
-  this->FindNeighbor(faceIndex, faceLevel, this->FaceNeighbors+23, this->FaceNeighbors+15);
+  this->FindNeighbor(faceIndex, faceLevel, worker->FaceNeighbors+23, worker->FaceNeighbors+15);
   faceIndex[axis2] += 1;
-  this->FindNeighbor(faceIndex, faceLevel, this->FaceNeighbors+31, this->FaceNeighbors+23);
+  this->FindNeighbor(faceIndex, faceLevel, worker->FaceNeighbors+31, worker->FaceNeighbors+23);
   faceIndex[axis1] -= 1;
-  this->FindNeighbor(faceIndex, faceLevel, this->FaceNeighbors+29, this->FaceNeighbors+31);
+  this->FindNeighbor(faceIndex, faceLevel, worker->FaceNeighbors+29, worker->FaceNeighbors+31);
   faceIndex[axis1] -= 1;
-  this->FindNeighbor(faceIndex, faceLevel, this->FaceNeighbors+27, this->FaceNeighbors+29);
+  this->FindNeighbor(faceIndex, faceLevel, worker->FaceNeighbors+27, worker->FaceNeighbors+29);
   faceIndex[axis1] -= 1;
-  this->FindNeighbor(faceIndex, faceLevel, this->FaceNeighbors+25, this->FaceNeighbors+27);
+  this->FindNeighbor(faceIndex, faceLevel, worker->FaceNeighbors+25, worker->FaceNeighbors+27);
   faceIndex[axis2] -= 1;
-  this->FindNeighbor(faceIndex, faceLevel, this->FaceNeighbors+17, this->FaceNeighbors+25);
+  this->FindNeighbor(faceIndex, faceLevel, worker->FaceNeighbors+17, worker->FaceNeighbors+25);
   faceIndex[axis2] -= 1;
-  this->FindNeighbor(faceIndex, faceLevel, this->FaceNeighbors+9, this->FaceNeighbors+17);
+  this->FindNeighbor(faceIndex, faceLevel, worker->FaceNeighbors+9, worker->FaceNeighbors+17);
   faceIndex[axis2] -= 1;
-  this->FindNeighbor(faceIndex, faceLevel, this->FaceNeighbors+1, this->FaceNeighbors+9);
+  this->FindNeighbor(faceIndex, faceLevel, worker->FaceNeighbors+1, worker->FaceNeighbors+9);
   //Now for the other side (min axis).
   faceIndex[axis] -= 1; // Move to the other layer
   faceIndex[axis1] += 1; // Start below reference block.
-  this->FindNeighbor(faceIndex, faceLevel, this->FaceNeighbors+2, this->FaceNeighbors+10);
+  this->FindNeighbor(faceIndex, faceLevel, worker->FaceNeighbors+2, worker->FaceNeighbors+10);
   faceIndex[axis1] += 1;
-  this->FindNeighbor(faceIndex, faceLevel, this->FaceNeighbors+4, this->FaceNeighbors+2);
+  this->FindNeighbor(faceIndex, faceLevel, worker->FaceNeighbors+4, worker->FaceNeighbors+2);
   faceIndex[axis1] += 1;
-  this->FindNeighbor(faceIndex, faceLevel, this->FaceNeighbors+6, this->FaceNeighbors+4);
+  this->FindNeighbor(faceIndex, faceLevel, worker->FaceNeighbors+6, worker->FaceNeighbors+4);
   faceIndex[axis2] += 1;
-  this->FindNeighbor(faceIndex, faceLevel, this->FaceNeighbors+14, this->FaceNeighbors+6);
+  this->FindNeighbor(faceIndex, faceLevel, worker->FaceNeighbors+14, worker->FaceNeighbors+6);
   faceIndex[axis2] += 1;
-  this->FindNeighbor(faceIndex, faceLevel, this->FaceNeighbors+22, this->FaceNeighbors+14);
+  this->FindNeighbor(faceIndex, faceLevel, worker->FaceNeighbors+22, worker->FaceNeighbors+14);
   faceIndex[axis2] += 1;
-  this->FindNeighbor(faceIndex, faceLevel, this->FaceNeighbors+30, this->FaceNeighbors+22);
+  this->FindNeighbor(faceIndex, faceLevel, worker->FaceNeighbors+30, worker->FaceNeighbors+22);
   faceIndex[axis1] -= 1;
-  this->FindNeighbor(faceIndex, faceLevel, this->FaceNeighbors+28, this->FaceNeighbors+30);
+  this->FindNeighbor(faceIndex, faceLevel, worker->FaceNeighbors+28, worker->FaceNeighbors+30);
   faceIndex[axis1] -= 1;
-  this->FindNeighbor(faceIndex, faceLevel, this->FaceNeighbors+26, this->FaceNeighbors+28);
+  this->FindNeighbor(faceIndex, faceLevel, worker->FaceNeighbors+26, worker->FaceNeighbors+28);
   faceIndex[axis1] -= 1;
-  this->FindNeighbor(faceIndex, faceLevel, this->FaceNeighbors+24, this->FaceNeighbors+26);
+  this->FindNeighbor(faceIndex, faceLevel, worker->FaceNeighbors+24, worker->FaceNeighbors+26);
   faceIndex[axis2] -= 1;
-  this->FindNeighbor(faceIndex, faceLevel, this->FaceNeighbors+16, this->FaceNeighbors+24);
+  this->FindNeighbor(faceIndex, faceLevel, worker->FaceNeighbors+16, worker->FaceNeighbors+24);
   faceIndex[axis2] -= 1;
-  this->FindNeighbor(faceIndex, faceLevel, this->FaceNeighbors+8, this->FaceNeighbors+16);
+  this->FindNeighbor(faceIndex, faceLevel, worker->FaceNeighbors+8, worker->FaceNeighbors+16);
   faceIndex[axis2] -= 1;
-  this->FindNeighbor(faceIndex, faceLevel, this->FaceNeighbors+0, this->FaceNeighbors+8);
+  this->FindNeighbor(faceIndex, faceLevel, worker->FaceNeighbors+0, worker->FaceNeighbors+8);
 
   // Split edges if neighbors are a higher level than face.
   --faceLevel;
-  this->FaceEdgeFlags[0] = 0;
+  worker->FaceEdgeFlags[0] = 0;
   // Checking equivalences (this->FaceNeighbor[2] != this->FaceNeighbor[4])
   // May be faster and work fine.
-  if (this->FaceNeighbors[2].Block->GetLevel() > faceLevel ||
-      this->FaceNeighbors[3].Block->GetLevel()  > faceLevel ||
-      this->FaceNeighbors[4].Block->GetLevel()  > faceLevel ||
-      this->FaceNeighbors[5].Block->GetLevel()  > faceLevel)
+  if (worker->FaceNeighbors[2].Block->GetLevel() > faceLevel ||
+      worker->FaceNeighbors[3].Block->GetLevel()  > faceLevel ||
+      worker->FaceNeighbors[4].Block->GetLevel()  > faceLevel ||
+      worker->FaceNeighbors[5].Block->GetLevel()  > faceLevel)
     {
-    this->FaceEdgeFlags[0] = 1;
+    worker->FaceEdgeFlags[0] = 1;
     }
-  this->FaceEdgeFlags[1] = 0;
-  if (this->FaceNeighbors[8].Block->GetLevel()  > faceLevel ||
-      this->FaceNeighbors[9].Block->GetLevel()  > faceLevel ||
-      this->FaceNeighbors[16].Block->GetLevel() > faceLevel ||
-      this->FaceNeighbors[17].Block->GetLevel() > faceLevel)
+  worker->FaceEdgeFlags[1] = 0;
+  if (worker->FaceNeighbors[8].Block->GetLevel()  > faceLevel ||
+      worker->FaceNeighbors[9].Block->GetLevel()  > faceLevel ||
+      worker->FaceNeighbors[16].Block->GetLevel() > faceLevel ||
+      worker->FaceNeighbors[17].Block->GetLevel() > faceLevel)
     {
-    this->FaceEdgeFlags[1] = 1;
+    worker->FaceEdgeFlags[1] = 1;
     }
-  this->FaceEdgeFlags[2] = 0;
-  if (this->FaceNeighbors[14].Block->GetLevel() > faceLevel ||
-      this->FaceNeighbors[15].Block->GetLevel() > faceLevel ||
-      this->FaceNeighbors[22].Block->GetLevel() > faceLevel ||
-      this->FaceNeighbors[23].Block->GetLevel() > faceLevel)
+  worker->FaceEdgeFlags[2] = 0;
+  if (worker->FaceNeighbors[14].Block->GetLevel() > faceLevel ||
+      worker->FaceNeighbors[15].Block->GetLevel() > faceLevel ||
+      worker->FaceNeighbors[22].Block->GetLevel() > faceLevel ||
+      worker->FaceNeighbors[23].Block->GetLevel() > faceLevel)
     {
-    this->FaceEdgeFlags[2] = 1;
+    worker->FaceEdgeFlags[2] = 1;
     }
-  this->FaceEdgeFlags[3] = 0;
-  if (this->FaceNeighbors[26].Block->GetLevel() > faceLevel ||
-      this->FaceNeighbors[27].Block->GetLevel() > faceLevel ||
-      this->FaceNeighbors[28].Block->GetLevel() > faceLevel ||
-      this->FaceNeighbors[29].Block->GetLevel() > faceLevel)
+  worker->FaceEdgeFlags[3] = 0;
+  if (worker->FaceNeighbors[26].Block->GetLevel() > faceLevel ||
+      worker->FaceNeighbors[27].Block->GetLevel() > faceLevel ||
+      worker->FaceNeighbors[28].Block->GetLevel() > faceLevel ||
+      worker->FaceNeighbors[29].Block->GetLevel() > faceLevel)
     {
-    this->FaceEdgeFlags[3] = 1;
+    worker->FaceEdgeFlags[3] = 1;
     }
 }
 
@@ -5355,7 +6109,9 @@ int vtkMaterialInterfaceFilter::AccumulateMoments(
 // This integrates quantities at the same time.
 // This is called only when the voxel is part of a fragment.
 // I tried to create a generic API to replace the hard coded conditional ifs.
-void vtkMaterialInterfaceFilter::ConnectFragment(vtkMaterialInterfaceFilterRingBuffer *queue)
+void vtkMaterialInterfaceFilter::ConnectFragment(
+  vtkMaterialInterfaceFilterWorker *worker,
+  vtkMaterialInterfaceFilterRingBuffer *queue)
 {
   while (queue->GetSize())
     {
@@ -5375,7 +6131,7 @@ void vtkMaterialInterfaceFilter::ConnectFragment(vtkMaterialInterfaceFilterRingB
       double voxelVolumeFrac
         = dX[0]*dX[1]*dX[2]*(double)(*(iterator.VolumeFractionPointer))/255.0;
       #endif
-      this->FragmentVolume+=voxelVolumeFrac;
+      worker->FragmentVolume+=voxelVolumeFrac;
       // The clip depth is accumulated in SubvoxelPositionCorner.
       // accumulate volume weighted average
       for (int i=0; i<this->NVolumeWtdAvgs; ++i)
@@ -5384,7 +6140,7 @@ void vtkMaterialInterfaceFilter::ConnectFragment(vtkMaterialInterfaceFilterRingB
           = iterator.Block->GetVolumeWtdAvgArray(i);
         int nComps
           = arrayToIntegrate->GetNumberOfComponents();
-        this->Accumulate( &this->FragmentVolumeWtdAvg[i][0],
+        this->Accumulate( &worker->FragmentVolumeWtdAvg[i][0],
                           arrayToIntegrate,
                           nComps,
                           iterator.FlatIndex,
@@ -5400,7 +6156,7 @@ void vtkMaterialInterfaceFilter::ConnectFragment(vtkMaterialInterfaceFilterRingB
         double X[3]={X0[0]+dX[0]*(0.5+iterator.Index[0]),
                      X0[1]+dX[1]*(0.5+iterator.Index[1]),
                      X0[2]+dX[2]*(0.5+iterator.Index[2])};
-        this->AccumulateMoments(&this->FragmentMoment[0],
+        this->AccumulateMoments(&worker->FragmentMoment[0],
                                 massArray,
                                 iterator.FlatIndex,
                                 X);
@@ -5413,7 +6169,7 @@ void vtkMaterialInterfaceFilter::ConnectFragment(vtkMaterialInterfaceFilterRingB
             = iterator.Block->GetMassWtdAvgArray(i);
           int nComps
             = arrayToIntegrate->GetNumberOfComponents();
-          this->Accumulate( &this->FragmentMassWtdAvg[i][0],
+          this->Accumulate( &worker->FragmentMassWtdAvg[i][0],
                             arrayToIntegrate,
                             nComps,
                             iterator.FlatIndex,
@@ -5427,7 +6183,7 @@ void vtkMaterialInterfaceFilter::ConnectFragment(vtkMaterialInterfaceFilterRingB
           = iterator.Block->GetArrayToSum(i);
         int nComps
           = arrayToIntegrate->GetNumberOfComponents();
-        this->Accumulate( &this->FragmentSum[i][0],
+        this->Accumulate( &worker->FragmentSum[i][0],
                           arrayToIntegrate,
                           nComps,
                           iterator.FlatIndex,
@@ -5457,17 +6213,21 @@ void vtkMaterialInterfaceFilter::ConnectFragment(vtkMaterialInterfaceFilterRingB
           next.VolumeFractionPointer[0] < this->scaledMaterialFractionThreshold)
         {
         // Neighbor is outside of fragment.  Make a face.
-        this->CreateFace(&iterator, &next, ii, 0);
+        this->CreateFace(worker, &iterator, &next, ii, 0);
+        }
+      else if (next.Block->GetWorkerId() != worker->Id)
+        { // Another worker labels this voxel. Connect them after the pass.
+        worker->AddContact(&iterator, &next);
         }
       else if (next.FragmentIdPointer[0] == -1)
         { // We have not visited this neighbor yet. Mark the voxel and recurse.
-        *(next.FragmentIdPointer) = this->FragmentId;
+        *(next.FragmentIdPointer) = worker->FragmentId;
         queue->Push(&next);
         }
       else
         { // The last case is that we have already visited this voxel and it
         // is in the same fragment.
-        this->AddEquivalence(&iterator, &next);
+        this->AddEquivalence(worker, &iterator, &next);
         }
 
       // Handle the case when the new iterator is a higher level.
@@ -5488,17 +6248,21 @@ void vtkMaterialInterfaceFilter::ConnectFragment(vtkMaterialInterfaceFilterRingB
               next2.VolumeFractionPointer[0] < this->scaledMaterialFractionThreshold)
             {
             // Neighbor is outside of fragment.  Make a face.
-            this->CreateFace(&iterator, &next2, ii, 0);
+            this->CreateFace(worker, &iterator, &next2, ii, 0);
+            }
+          else if (next2.Block->GetWorkerId() != worker->Id)
+            { // Another worker labels this voxel. Connect them after the pass.
+            worker->AddContact(&iterator, &next2);
             }
           else if (next2.FragmentIdPointer[0] == -1)
             { // We have not visited this neighbor yet. Mark the voxel and recurse.
-           *(next2.FragmentIdPointer) = this->FragmentId;
+           *(next2.FragmentIdPointer) = worker->FragmentId;
             queue->Push(&next2);
             }
           else
             { // The last case is that we have already visited this voxel and it
             // is in the same fragment.
-            this->AddEquivalence(&next2, &next);
+            this->AddEquivalence(worker, &next2, &next);
             }
           }
         // Take the fist iterator found and move +Z
@@ -5509,17 +6273,21 @@ void vtkMaterialInterfaceFilter::ConnectFragment(vtkMaterialInterfaceFilterRingB
               next2.VolumeFractionPointer[0] < this->scaledMaterialFractionThreshold)
             {
             // Neighbor is outside of fragment.  Make a face.
-            this->CreateFace(&iterator, &next2, ii, 0);
+            this->CreateFace(worker, &iterator, &next2, ii, 0);
+            }
+          else if (next2.Block->GetWorkerId() != worker->Id)
+            { // Another worker labels this voxel. Connect them after the pass.
+            worker->AddContact(&iterator, &next2);
             }
           else if (next2.FragmentIdPointer[0] == -1)
             { // We have not visited this neighbor yet. Mark the voxel and recurse.
-            *(next2.FragmentIdPointer) = this->FragmentId;
+            *(next2.FragmentIdPointer) = worker->FragmentId;
             queue->Push(&next2);
             }
           else
             { // The last case is that we have already visited this voxel and it
             // is in the same fragment.
-            this->AddEquivalence(&next2, &next);
+            this->AddEquivalence(worker, &next2, &next);
             }
           }
         // To get the +Y+Z start with the +Z iterator and move +Y put results in "next"
@@ -5530,17 +6298,21 @@ void vtkMaterialInterfaceFilter::ConnectFragment(vtkMaterialInterfaceFilterRingB
               next.VolumeFractionPointer[0] < this->scaledMaterialFractionThreshold)
             {
             // Neighbor is outside of fragment.  Make a face.
-            this->CreateFace(&iterator, &next, ii, 0);
+            this->CreateFace(worker, &iterator, &next, ii, 0);
+            }
+          else if (next.Block->GetWorkerId() != worker->Id)
+            { // Another worker labels this voxel. Connect them after the pass.
+            worker->AddContact(&iterator, &next);
             }
           else if (next.FragmentIdPointer[0] == -1)
             { // We have not visited this neighbor yet. Mark the voxel and recurse.
-            *(next.FragmentIdPointer) = this->FragmentId;
+            *(next.FragmentIdPointer) = worker->FragmentId;
             queue->Push(&next);
             }
           else
             { // The last case is that we have already visited this voxel and it
             // is in the same fragment.
-            this->AddEquivalence(&next2, &next);
+            this->AddEquivalence(worker, &next2, &next);
             }
           }
         }
@@ -5550,17 +6322,21 @@ void vtkMaterialInterfaceFilter::ConnectFragment(vtkMaterialInterfaceFilterRingB
       if (next.VolumeFractionPointer == 0 ||
           next.VolumeFractionPointer[0] < this->scaledMaterialFractionThreshold)
         { // Neighbor is outside of fragment.  Make a face.
-        this->CreateFace(&iterator, &next, ii, 1);
+        this->CreateFace(worker, &iterator, &next, ii, 1);
+        }
+      else if (next.Block->GetWorkerId() != worker->Id)
+        { // Another worker labels this voxel. Connect them after the pass.
+        worker->AddContact(&iterator, &next);
         }
       else if (next.FragmentIdPointer[0] == -1)
         { // We have not visited this neighbor yet. Mark the voxel and recurse.
-        *(next.FragmentIdPointer) = this->FragmentId;
+        *(next.FragmentIdPointer) = worker->FragmentId;
         queue->Push(&next);
         }
       else
         { // The last case is that we have already visited this voxel and it
         // is in the same fragment.
-        this->AddEquivalence(&iterator, &next);
+        this->AddEquivalence(worker, &iterator, &next);
         }
       // Same case as above with the same logic to visit the
       // four smaller cells that touch this face of the current block.
@@ -5576,17 +6352,21 @@ void vtkMaterialInterfaceFilter::ConnectFragment(vtkMaterialInterfaceFilterRingB
               next2.VolumeFractionPointer[0] < this->scaledMaterialFractionThreshold)
             {
             // Neighbor is outside of fragment.  Make a face.
-            this->CreateFace(&iterator, &next2, ii, 1);
+            this->CreateFace(worker, &iterator, &next2, ii, 1);
+            }
+          else if (next2.Block->GetWorkerId() != worker->Id)
+            { // Another worker labels this voxel. Connect them after the pass.
+            worker->AddContact(&iterator, &next2);
             }
           else if (next2.FragmentIdPointer[0] == -1)
             { // We have not visited this neighbor yet. Mark the voxel and recurse.
-            *(next2.FragmentIdPointer) = this->FragmentId;
+            *(next2.FragmentIdPointer) = worker->FragmentId;
             queue->Push(&next2);
             }
           else
             { // The last case is that we have already visited this voxel and it
             // is in the same fragment.
-            this->AddEquivalence(&next2, &next);
+            this->AddEquivalence(worker, &next2, &next);
             }
           }
         // Take the fist iterator found and move +Z
@@ -5597,17 +6377,21 @@ void vtkMaterialInterfaceFilter::ConnectFragment(vtkMaterialInterfaceFilterRingB
               next2.VolumeFractionPointer[0] < this->scaledMaterialFractionThreshold)
             {
             // Neighbor is outside of fragment.  Make a face.
-            this->CreateFace(&iterator, &next2, ii, 1);
+            this->CreateFace(worker, &iterator, &next2, ii, 1);
+            }
+          else if (next2.Block->GetWorkerId() != worker->Id)
+            { // Another worker labels this voxel. Connect them after the pass.
+            worker->AddContact(&iterator, &next2);
             }
           else if (next2.FragmentIdPointer[0] == -1)
             { // We have not visited this neighbor yet. Mark the voxel and recurse.
-            *(next2.FragmentIdPointer) = this->FragmentId;
+            *(next2.FragmentIdPointer) = worker->FragmentId;
             queue->Push(&next2);
             }
           else
             { // The last case is that we have already visited this voxel and it
             // is in the same fragment.
-            this->AddEquivalence(&next2, &next);
+            this->AddEquivalence(worker, &next2, &next);
             }
           }
         // To get the +Y+Z start with the +Z iterator and move +Y put results in "next"
@@ -5618,17 +6402,21 @@ void vtkMaterialInterfaceFilter::ConnectFragment(vtkMaterialInterfaceFilterRingB
               next.VolumeFractionPointer[0] < this->scaledMaterialFractionThreshold)
             {
             // Neighbor is outside of fragment.  Make a face.
-            this->CreateFace(&iterator, &next, ii, 1);
+            this->CreateFace(worker, &iterator, &next, ii, 1);
+            }
+          else if (next.Block->GetWorkerId() != worker->Id)
+            { // Another worker labels this voxel. Connect them after the pass.
+            worker->AddContact(&iterator, &next);
             }
           else if (next.FragmentIdPointer[0] == -1)
             { // We have not visited this neighbor yet. Mark the voxel and recurse.
-            *(next.FragmentIdPointer) = this->FragmentId;
+            *(next.FragmentIdPointer) = worker->FragmentId;
             queue->Push(&next);
             }
           else
             { // The last case is that we have already visited this voxel and it
             // is in the same fragment.
-            this->AddEquivalence(&next2, &next);
+            this->AddEquivalence(worker, &next2, &next);
             }
           }
         }
@@ -6251,16 +7039,27 @@ void vtkMaterialInterfaceFilter::SetUpperLoadingBound(int nPolys)
 // Chains can leave orphans, loops break when two nodes in the loop are
 // equated a second time.
 // Lets try a directed tree
+// The worker keeps the pair until the pass is over, when all the ids are
+// final. Voxels that another worker labels are connected after the pass too.
 void vtkMaterialInterfaceFilter::AddEquivalence(
+  vtkMaterialInterfaceFilterWorker *worker,
   vtkMaterialInterfaceFilterIterator *neighbor1,
   vtkMaterialInterfaceFilterIterator *neighbor2)
 {
+  if (neighbor1->Block->GetWorkerId() != worker->Id
+      || neighbor2->Block->GetWorkerId() != worker->Id)
+    {
+    worker->AddContact(neighbor1, neighbor2);
+    return;
+    }
+
   int id1 = *(neighbor1->FragmentIdPointer);
   int id2 = *(neighbor2->FragmentIdPointer);
 
   if (id1 != id2 && id1 != -1 && id2 != -1)
     {
-    this->EquivalenceSet->AddEquivalence(id1, id2);
+    worker->Equivalences.push_back(id1);
+    worker->Equivalences.push_back(id2);
     }
 }
 
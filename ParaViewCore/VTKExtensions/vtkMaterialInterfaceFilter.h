@@ -18,13 +18,16 @@
 // surface.  It also performs connectivity on the particles and generates
 // a particle index as part of the cell data of the output.  It computes
 // the volume of each particle from the volume fraction.
+// The blocks of a process are split among NumberOfThreads threads. The
+// fragment ids do not depend on the number of threads.
+// With MPI, the ghost blocks needed from other processes are exchanged
+// without blocking. The blocks that do not touch them are processed while
+// they are in flight. The fragments keep the ids the blocking exchange
+// gives them.
 
 // This will turn on validation and debug i/o of the filter.
 //#define vtkMaterialInterfaceFilterDEBUG
 
-// This will turn on profiling of how long each part of the filter takes
-//#define vtkMaterialInterfaceFilterPROFILE
-
 #ifndef __vtkMaterialInterfaceFilter_h
 #define __vtkMaterialInterfaceFilter_h
 
@@ -34,6 +37,7 @@
 
 #include "vtkSmartPointer.h" // needed for smart pointer
 #include "vtkTimerLog.h" // needed for vtkTimerLog.
+#include "vtkMultiThreader.h" // needed for VTK_THREAD_RETURN_TYPE
 
 class vtkDataSet;
 class vtkImageData;
@@ -55,6 +59,8 @@ class vtkMaterialInterfaceFilterBlock;
 class vtkMaterialInterfaceFilterIterator;
 class vtkMaterialInterfaceEquivalenceSet;
 class vtkMaterialInterfaceFilterRingBuffer;
+class vtkMaterialInterfaceFilterWorker;
+class vtkMaterialInterfaceGhostExchange;
 class vtkMaterialInterfacePieceLoading;
 class vtkMaterialInterfaceCommBuffer;
 
@@ -250,6 +256,21 @@ public:
   vtkSetMacro(InvertVolumeFraction,int);
   vtkGetMacro(InvertVolumeFraction,int);
 
+  // Description:
+  // If true, process 0 prints how long each part of the filter took on
+  // every process. Off by default.
+  vtkSetMacro(Profile,bool);
+  vtkGetMacro(Profile,bool);
+
+  // Description:
+  // Number of threads the local blocks are connected with. 0, the default,
+  // uses as many as vtkMultiThreader would, which its global maximum limits
+  // to one in ParaView (see vtkProcessModule::Initialize()). A positive
+  // number is used as is, so that a process alone on its node can use all
+  // the cores.
+  vtkSetClampMacro(NumberOfThreads,int,0,VTK_MAX_THREADS);
+  vtkGetMacro(NumberOfThreads,int);
+
   // Description:
   // Return the mtime also considering the locator and clip function.
   unsigned long GetMTime();
@@ -272,11 +293,21 @@ protected:
                       vtkstd::vector<vtkstd::string> &integratedArrayNames);
   // Craete a new fragment/piece.
   vtkPolyData *NewFragmentMesh();
+  // Process the local blocks, one worker per thread.
+  void ProcessBlocks();
+  void RunWorkers(vtkMaterialInterfaceFilterWorker **workers,
+                  int numberOfWorkers);
+  static VTK_THREAD_RETURN_TYPE ProcessBlocksThread(void *arg);
+  // Save the fragments of the workers and resolve the labels they left
+  // in the blocks into fragment ids.
+  void MergeWorkers(
+    vtkstd::vector<vtkMaterialInterfaceFilterWorker*> &workers);
   // Process each cell, looking for fragments.
-  int ProcessBlock(int blockId);
+  int ProcessBlock(int blockId, vtkMaterialInterfaceFilterWorker* worker);
   // Cell has been identified as inside the fragment. Integrate, and
   // generate fragement surface etc...
-  void ConnectFragment(vtkMaterialInterfaceFilterRingBuffer* iterator);
+  void ConnectFragment(vtkMaterialInterfaceFilterWorker* worker,
+                       vtkMaterialInterfaceFilterRingBuffer* iterator);
   void GetNeighborIterator(
         vtkMaterialInterfaceFilterIterator* next,
         vtkMaterialInterfaceFilterIterator* iterator,
@@ -290,6 +321,7 @@ protected:
         int axis1, int maxFlag1,
         int axis2, int maxFlag2);
   void CreateFace(
+        vtkMaterialInterfaceFilterWorker* worker,
         vtkMaterialInterfaceFilterIterator* in,
         vtkMaterialInterfaceFilterIterator* out,
         int axis, int outMaxFlag);
@@ -298,6 +330,7 @@ protected:
         double displacmentFactors[3],
         int rootNeighborIdx, int faceAxis);
   int SubVoxelPositionCorner(
+        vtkMaterialInterfaceFilterWorker* worker,
         double* point,
         vtkMaterialInterfaceFilterIterator* pointNeighborIterators[8],
         int rootNeighborIdx, int faceAxis);
@@ -329,11 +362,24 @@ protected:
     int* blockMetaData,
     int myProc,
     int numProcs);
+  // Non-blocking version of ComputeAndDistributeGhostBlocks, used with
+  // MPI. The requests and the replies are posted, the ghost blocks are
+  // added to the grid by FinishGhostBlockExchange.
+  vtkMaterialInterfaceGhostExchange* GhostExchange;
+  void StartGhostBlockExchange(
+    int *numBlocksInProc,
+    int* blockMetaData,
+    int myProc,
+    int numProcs);
+  void FinishGhostBlockExchange();
+  // Returns 1 if the block may touch a ghost block that has not arrived.
+  int IsBoundaryBlock(vtkMaterialInterfaceFilterBlock* block);
 
   vtkMultiProcessController* Controller;
 
   vtkMaterialInterfaceEquivalenceSet* EquivalenceSet;
   void AddEquivalence(
+    vtkMaterialInterfaceFilterWorker *worker,
     vtkMaterialInterfaceFilterIterator *neighbor1,
     vtkMaterialInterfaceFilterIterator *neighbor2);
   //
@@ -510,10 +556,6 @@ protected:
   char *MaterialFractionArrayName;
   vtkSetStringMacro(MaterialFractionArrayName);
 
-  // while processing a material array this holds
-  // a pointer to the output poly data
-  // data set
-  vtkPolyData *CurrentFragmentMesh;
   // As peices/fragments are found they are stored here
   // until resolution.
   vtkstd::vector<vtkPolyData *> FragmentMeshes;
@@ -523,23 +565,17 @@ protected:
   // all of the supported operations.
   ///class vtkMaterialInterfaceFilterIntegrator
   ///{
-  // Local id of current fragment
+  // Number of local fragments, the workers accumulate the current ones.
   int FragmentId;
-  // Accumulator for the volume of the current fragment.
-  double FragmentVolume;
   // Fragment volumes indexed by the fragment id. It's a local
   // per-process indexing until fragments have been resolved
   vtkDoubleArray* FragmentVolumes;
 
   // Min and max depth of crater.
   // These are only computed when the clip plane is on.
-  double ClipDepthMin;
-  double ClipDepthMax;
   vtkDoubleArray* ClipDepthMinimums;
   vtkDoubleArray* ClipDepthMaximums;
 
-  // Accumulator for moments of the current fragment
-  vtkstd::vector<double> FragmentMoment; // =(Myz, Mxz, Mxy, m)
   // Moments indexed by fragment id
   vtkDoubleArray *FragmentMoments;
   // Centers of fragment AABBs, only computed if moments are not
@@ -548,8 +584,6 @@ protected:
   bool ComputeMoments;
 
   // Weighted average, where weights correspond to fragment volume.
-  // Accumulators one for each array to average, scalar or vector
-  vtkstd::vector<vtkstd::vector<double> > FragmentVolumeWtdAvg;
   // weighted averages indexed by fragment id.
   vtkstd::vector<vtkDoubleArray *>FragmentVolumeWtdAvgs;
   // number of arrays for which to compute the weighted average
@@ -558,8 +592,6 @@ protected:
   vtkstd::vector<vtkstd::string> VolumeWtdAvgArrayNames;
 
   // Weighted average, where weights correspond to fragment mass.
-  // Accumulators one for each array to average, scalar or vector
-  vtkstd::vector<vtkstd::vector<double> > FragmentMassWtdAvg;
   // weighted averages indexed by fragment id.
   vtkstd::vector<vtkDoubleArray *>FragmentMassWtdAvgs;
   // number of arrays for which to compute the weighted average
@@ -576,8 +608,6 @@ protected:
   int NToIntegrate;
 
   // Sum of data over the fragment.
-  // Accumulators, one for each array to sum
-  vtkstd::vector<vtkstd::vector<double> > FragmentSum;
   // sums indexed by fragment id.
   vtkstd::vector<vtkDoubleArray *>FragmentSums;
   // number of arrays for which to compute the weighted average
@@ -641,20 +671,14 @@ protected:
   // It could be changed into the primary storage of blocks.
   vtkstd::vector<vtkMaterialInterfaceLevel*> Levels;
 
-  // Ivars for computing the point on corners and edges of a face.
-  vtkMaterialInterfaceFilterIterator* FaceNeighbors;
-  // Permutation of the neighbors. Axis0 normal to face.
-  int faceAxis0;
-  int faceAxis1;
-  int faceAxis2;
-  double FaceCornerPoints[12];
-  double FaceEdgePoints[12];
-  int    FaceEdgeFlags[4];
+  // Compute the point on corners and edges of a face, into the worker.
   // outMaxFlag implies out is positive direction of axis.
-  void ComputeFacePoints(vtkMaterialInterfaceFilterIterator* in,
+  void ComputeFacePoints(vtkMaterialInterfaceFilterWorker* worker,
+                        vtkMaterialInterfaceFilterIterator* in,
                         vtkMaterialInterfaceFilterIterator* out,
                         int axis, int outMaxFlag);
-  void ComputeFaceNeighbors(vtkMaterialInterfaceFilterIterator* in,
+  void ComputeFaceNeighbors(vtkMaterialInterfaceFilterWorker* worker,
+                            vtkMaterialInterfaceFilterIterator* in,
                             vtkMaterialInterfaceFilterIterator* out,
                             int axis, int  outMaxFlag);
 
@@ -701,15 +725,21 @@ protected:
   int InvertVolumeFraction;
 
 
-#ifdef vtkMaterialInterfaceFilterPROFILE
-// Lets profile to see what takes the most time for large number of processes.
+  int NumberOfThreads;
+
+  // Lets profile to see what takes the most time for large number of processes.
+  bool Profile;
   vtkSmartPointer<vtkTimerLog> InitializeBlocksTimer;
   vtkSmartPointer<vtkTimerLog> ShareGhostBlocksTimer;
   long NumberOfBlocks;
   long NumberOfGhostBlocks;
   vtkSmartPointer<vtkTimerLog> ProcessBlocksTimer;
+  // Parts of ProcessBlocks: the blocks processed while the ghost blocks
+  // are in flight, and the wait for the ghost blocks.
+  vtkSmartPointer<vtkTimerLog> ProcessInteriorBlocksTimer;
+  vtkSmartPointer<vtkTimerLog> WaitForGhostBlocksTimer;
   vtkSmartPointer<vtkTimerLog> ResolveEquivalencesTimer;
-#endif
+  void PrintProfile();
 
 private:
   vtkMaterialInterfaceFilter(const vtkMaterialInterfaceFilter&);  // Not implemented.
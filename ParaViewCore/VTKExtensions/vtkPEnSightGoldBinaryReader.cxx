@@ -29,19 +29,13 @@ vtkPEnSightGoldBinaryReader::vtkPEnSightGoldBinaryReader()
 {
   this->IFile = NULL;
   this->FileSize = 0;
+  this->FileModificationTime = 0;
   this->Fortran = 0;
   this->NodeIdsListed = 0;
   this->ElementIdsListed = 0;
+  this->SaveTimeStepOffsets = 0;
 
-  this->FloatBufferSize = 1000;
-
-  this->FloatBuffer = (float **) malloc( 3 * sizeof(float *) );
-  this->FloatBuffer[0] = new float[this->FloatBufferSize];
-  this->FloatBuffer[1] = new float[this->FloatBufferSize];
-  this->FloatBuffer[2] = new float[this->FloatBufferSize];
-  this->FloatBufferIndexBegin = -1;
-  this->FloatBufferFilePosition =  0;
-  this->FloatBufferNumberOfVectors = 0;
+  this->CoordinatesChunkSize = 1 << 20;
 }
 
 //----------------------------------------------------------------------------
@@ -53,10 +47,6 @@ vtkPEnSightGoldBinaryReader::~vtkPEnSightGoldBinaryReader()
     delete this->IFile;
     this->IFile = NULL;
     }
-  delete this->FloatBuffer[2];
-  delete this->FloatBuffer[1];
-  delete this->FloatBuffer[0];
-  free( this->FloatBuffer );
 }
 
 //----------------------------------------------------------------------------
@@ -83,6 +73,8 @@ int vtkPEnSightGoldBinaryReader::OpenFile(const char* filename)
     {
     // Find out how big the file is.
     this->FileSize = (long)(fs.st_size);
+    this->FileModificationTime = (long)(fs.st_mtime);
+    this->OpenedFileName = filename;
 
 #ifdef _WIN32
     this->IFile = new ifstream(filename, ios::in | ios::binary);
@@ -253,18 +245,8 @@ int vtkPEnSightGoldBinaryReader::ReadGeometryFile(const char* fileName, int time
   if (this->UseFileSets)
     {
     int realTimeStep = timeStep - 1;
-    int j = 0;
-    // Try to find the nearest time step for which we know the offset
-    for (i = realTimeStep; i >= 0; i--)
-      {
-      if (this->FileOffsets.find(fileName) != this->FileOffsets.end()
-          && this->FileOffsets[fileName].find(i) != this->FileOffsets[fileName].end())
-        {
-        this->IFile->seekg(this->FileOffsets[fileName][i], ios::beg);
-        j = i;
-        break;
-        }
-      }
+    // Start from the nearest time step for which we know the offset
+    int j = this->SeekToNearestTimeStep(fileName, realTimeStep);
 
     // Hopefully we are not very far from the timestep we want to use
     // Find it (and cache any timestep we find on the way...)
@@ -276,15 +258,12 @@ int vtkPEnSightGoldBinaryReader::ReadGeometryFile(const char* fileName, int time
         }
       else
         {
-        if (this->FileOffsets.find(fileName) == this->FileOffsets.end())
-          {
-          vtkstd::map<int, long> tsMap;
-          this->FileOffsets[fileName] = tsMap;
-          }
-        this->FileOffsets[fileName][j] = this->IFile->tellg();
+        this->AddTimeStepOffset(fileName, j, this->IFile->tellg());
         }
       }
 
+    this->SaveTimeStepIndex(fileName);
+
     while (strncmp(line, "BEGIN TIME STEP", 15) != 0)
       {
       this->ReadLine(line);
@@ -558,6 +537,221 @@ int vtkPEnSightGoldBinaryReader::SkipTimeStep()
   return 1;
 }
 
+//----------------------------------------------------------------------------
+int vtkPEnSightGoldBinaryReader::SeekToNearestTimeStep(const char* fileName,
+                                                        int realTimeStep)
+{
+  // The first time a file is used, look for an index of its time steps.
+  if (this->TimeStepIndexStates.find(fileName) ==
+      this->TimeStepIndexStates.end())
+    {
+    if (this->ReadFileIndex(fileName))
+      {
+      this->TimeStepIndexStates[fileName] = TIME_STEP_INDEX_FROM_FILE;
+      }
+    else
+      {
+      this->ReadSavedTimeStepIndex(fileName);
+      this->TimeStepIndexStates[fileName] = TIME_STEP_INDEX_SAVED;
+      }
+    }
+
+  vtkstd::map<vtkstd::string, vtkstd::map<int, long> >::iterator offsets =
+    this->FileOffsets.find(fileName);
+  if (offsets == this->FileOffsets.end())
+    {
+    return 0;
+    }
+  vtkstd::map<int, long>::iterator nearest =
+    offsets->second.upper_bound(realTimeStep);
+  if (nearest == offsets->second.begin())
+    {
+    return 0;
+    }
+  --nearest;
+  this->IFile->seekg(nearest->second, ios::beg);
+  return nearest->first;
+}
+
+//----------------------------------------------------------------------------
+void vtkPEnSightGoldBinaryReader::AddTimeStepOffset(const char* fileName,
+                                                     int timeStep, long offset)
+{
+  long& knownOffset = this->FileOffsets[fileName][timeStep];
+  if (knownOffset != offset)
+    {
+    knownOffset = offset;
+    if (this->TimeStepIndexStates[fileName] == TIME_STEP_INDEX_SAVED)
+      {
+      this->TimeStepIndexStates[fileName] = TIME_STEP_INDEX_MODIFIED;
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+int vtkPEnSightGoldBinaryReader::ReadFileIndex(const char* fileName)
+{
+  // Single file transient C binary files may end with an index:
+  //   number of time steps                   int
+  //   offset of each BEGIN TIME STEP         8 byte int array
+  //   offset of the number of time steps     8 byte int
+  //   "FILE_INDEX"                           80 chars
+  long footerSize = 80 + sizeof(vtkTypeInt64);
+  if (this->Fortran || this->FileSize < footerSize + (long)sizeof(int))
+    {
+    return 0;
+    }
+
+  long position = this->IFile->tellg();
+  char line[80];
+  vtkTypeInt64 indexOffset = 0;
+  this->IFile->seekg(this->FileSize - footerSize, ios::beg);
+  this->IFile->read((char*)&indexOffset, sizeof(indexOffset));
+  this->IFile->read(line, 80);
+  if (this->IFile->fail() || strncmp(line, "FILE_INDEX", 10) != 0)
+    {
+    this->IFile->clear();
+    this->IFile->seekg(position);
+    return 0;
+    }
+
+  // Use the byte order giving an index inside the file when it is not
+  // known yet.
+  int byteOrder = this->ByteOrder;
+  vtkTypeInt64 indexEnd = this->FileSize - footerSize - sizeof(int);
+  if (byteOrder == FILE_UNKNOWN_ENDIAN)
+    {
+    vtkTypeInt64 littleEndian = indexOffset;
+    vtkByteSwap::Swap8LE(&littleEndian);
+    byteOrder = (littleEndian >= 0 && littleEndian <= indexEnd) ?
+      FILE_LITTLE_ENDIAN : FILE_BIG_ENDIAN;
+    }
+  this->SwapInt64(&indexOffset, 1, byteOrder);
+
+  int numberOfTimeSteps = 0;
+  if (indexOffset >= 0 && indexOffset <= indexEnd)
+    {
+    this->IFile->seekg(indexOffset, ios::beg);
+    this->IFile->read((char*)&numberOfTimeSteps, sizeof(int));
+    if (byteOrder == FILE_LITTLE_ENDIAN)
+      {
+      vtkByteSwap::Swap4LE(&numberOfTimeSteps);
+      }
+    else
+      {
+      vtkByteSwap::Swap4BE(&numberOfTimeSteps);
+      }
+    }
+  if (this->IFile->fail() || numberOfTimeSteps <= 0 ||
+      indexOffset + (vtkTypeInt64)sizeof(vtkTypeInt64)*numberOfTimeSteps > indexEnd)
+    {
+    vtkWarningMacro("Ignoring the invalid FILE_INDEX of " << fileName);
+    this->IFile->clear();
+    this->IFile->seekg(position);
+    return 0;
+    }
+
+  vtkstd::vector<vtkTypeInt64> timeStepOffsets(numberOfTimeSteps);
+  this->IFile->read((char*)&timeStepOffsets[0],
+                    sizeof(vtkTypeInt64)*numberOfTimeSteps);
+  this->SwapInt64(&timeStepOffsets[0], numberOfTimeSteps, byteOrder);
+  vtkstd::map<int, long>& offsets = this->FileOffsets[fileName];
+  for (int i = 0; i < numberOfTimeSteps; i++)
+    {
+    offsets[i] = static_cast<long>(timeStepOffsets[i]);
+    }
+
+  this->IFile->clear();
+  this->IFile->seekg(position);
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+void vtkPEnSightGoldBinaryReader::SwapInt64(vtkTypeInt64* values, int number,
+                                             int byteOrder)
+{
+  for (int i = 0; i < number; i++)
+    {
+    if (byteOrder == FILE_LITTLE_ENDIAN)
+      {
+      vtkByteSwap::Swap8LE(values + i);
+      }
+    else
+      {
+      vtkByteSwap::Swap8BE(values + i);
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+vtkstd::string vtkPEnSightGoldBinaryReader::GetTimeStepIndexFileName()
+{
+  return this->OpenedFileName + ".vtkindex";
+}
+
+//----------------------------------------------------------------------------
+int vtkPEnSightGoldBinaryReader::ReadSavedTimeStepIndex(const char* fileName)
+{
+  ifstream indexFile(this->GetTimeStepIndexFileName().c_str(), ios::in);
+  if (!indexFile)
+    {
+    return 0;
+    }
+
+  // The index is only valid for the file it was built from.
+  char header[80];
+  long fileSize = -1;
+  long modificationTime = -1;
+  indexFile.getline(header, 80);
+  indexFile >> fileSize >> modificationTime;
+  if (strcmp(header, "EnSight time step offsets") != 0 || fileSize != this->FileSize ||
+      modificationTime != this->FileModificationTime)
+    {
+    vtkDebugMacro("Ignoring the outdated index of " << fileName);
+    return 0;
+    }
+
+  int timeStep;
+  long offset;
+  vtkstd::map<int, long>& offsets = this->FileOffsets[fileName];
+  while (indexFile >> timeStep >> offset)
+    {
+    offsets[timeStep] = offset;
+    }
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+void vtkPEnSightGoldBinaryReader::SaveTimeStepIndex(const char* fileName)
+{
+  if (!this->SaveTimeStepOffsets ||
+      this->TimeStepIndexStates[fileName] != TIME_STEP_INDEX_MODIFIED)
+    {
+    return;
+    }
+  this->TimeStepIndexStates[fileName] = TIME_STEP_INDEX_SAVED;
+
+  // Every process scans the same file, one of them writes the index.
+  if (this->GetMultiProcessLocalProcessId() > 0)
+    {
+    return;
+    }
+  ofstream indexFile(this->GetTimeStepIndexFileName().c_str(), ios::out);
+  if (!indexFile)
+    {
+    vtkDebugMacro("Cannot save the time step index of " << fileName);
+    return;
+    }
+  indexFile << "EnSight time step offsets" << endl
+            << this->FileSize << " " << this->FileModificationTime << endl;
+  vtkstd::map<int, long>& offsets = this->FileOffsets[fileName];
+  vtkstd::map<int, long>::iterator it;
+  for (it = offsets.begin(); it != offsets.end(); ++it)
+    {
+    indexFile << it->first << " " << it->second << endl;
+    }
+}
+
 //----------------------------------------------------------------------------
 int vtkPEnSightGoldBinaryReader::SkipStructuredGrid(char line[256])
 {
@@ -1132,7 +1326,7 @@ int vtkPEnSightGoldBinaryReader::ReadMeasuredGeometryFile(const char* fileName,
   char line[80], subLine[80];
   vtkIdType i;
   int *pointIds;
-  float *xCoords, *yCoords, *zCoords;
+  float *coords;
   vtkPoints *points = vtkPoints::New();
   vtkPolyData *pd = vtkPolyData::New();
 
@@ -1180,18 +1374,8 @@ int vtkPEnSightGoldBinaryReader::ReadMeasuredGeometryFile(const char* fileName,
   if (this->UseFileSets)
     {
     int realTimeStep = timeStep - 1;
-    int k, j = 0;
-    // Try to find the nearest time step for which we know the offset
-    for (k = realTimeStep; k >= 0; k--)
-      {
-      if (this->FileOffsets.find(fileName) != this->FileOffsets.end()
-          && this->FileOffsets[fileName].find(k) != this->FileOffsets[fileName].end())
-        {
-        this->IFile->seekg(this->FileOffsets[fileName][k], ios::beg);
-        j = k;
-        break;
-        }
-      }
+    // Start from the nearest time step for which we know the offset
+    int j = this->SeekToNearestTimeStep(fileName, realTimeStep);
 
     // Hopefully we are not very far from the timestep we want to use
     // Find it (and cache any timestep we find on the way...)
@@ -1220,13 +1404,10 @@ int vtkPEnSightGoldBinaryReader::ReadMeasuredGeometryFile(const char* fileName,
                          (sizeof(float)*3 + sizeof(int))*this->NumberOfMeasuredPoints,
                          ios::cur);
       this->ReadLine(line); // END TIME STEP
-      if (this->FileOffsets.find(fileName) == this->FileOffsets.end())
-        {
-        vtkstd::map<int, long> tsMap;
-        this->FileOffsets[fileName] = tsMap;
-        }
-      this->FileOffsets[fileName][j] = this->IFile->tellg();
+      this->AddTimeStepOffset(fileName, j, this->IFile->tellg());
       }
+    this->SaveTimeStepIndex(fileName);
+
     while (strncmp(line, "BEGIN TIME STEP", 15) != 0)
       {
       this->ReadLine(line);
@@ -1259,9 +1440,7 @@ int vtkPEnSightGoldBinaryReader::ReadMeasuredGeometryFile(const char* fileName,
   this->PrepareStructuredDimensionsForDistribution(partId, dimensions, newDimensions, &splitDimension, &splitDimensionBeginIndex, 0, NULL, NULL);
 
   pointIds = new int[this->NumberOfMeasuredPoints];
-  xCoords = new float [this->NumberOfMeasuredPoints];
-  yCoords = new float [this->NumberOfMeasuredPoints];
-  zCoords = new float [this->NumberOfMeasuredPoints];
+  coords = new float[3*this->NumberOfMeasuredPoints];
 
   points->Allocate(this->GetPointIds(partId)->GetLocalNumberOfIds());
   pd->Allocate(this->GetPointIds(partId)->GetLocalNumberOfIds());
@@ -1277,26 +1456,13 @@ int vtkPEnSightGoldBinaryReader::ReadMeasuredGeometryFile(const char* fileName,
 
   // Read point coordinates tuple by tuple while each tuple contains three
   // components: (x-cord, y-cord, z-cord)
-  int  floatSize = sizeof( float );
-  for ( i = 0; i < this->NumberOfMeasuredPoints; i ++ )
-    {
-    this->IFile->read(  ( char * )( xCoords + i ),  floatSize  );
-    this->IFile->read(  ( char * )( yCoords + i ),  floatSize  );
-    this->IFile->read(  ( char * )( zCoords + i ),  floatSize  );
-    }
-
-  if ( this->ByteOrder == FILE_LITTLE_ENDIAN )
+  if (this->NumberOfMeasuredPoints > 0 &&
+      this->IFile->read((char*)coords,
+                        3*sizeof(float)*this->NumberOfMeasuredPoints) == 0)
     {
-    vtkByteSwap::Swap4LERange( xCoords, this->NumberOfMeasuredPoints );
-    vtkByteSwap::Swap4LERange( yCoords, this->NumberOfMeasuredPoints );
-    vtkByteSwap::Swap4LERange( zCoords, this->NumberOfMeasuredPoints );
-    }
-  else
-    {
-    vtkByteSwap::Swap4BERange( xCoords, this->NumberOfMeasuredPoints );
-    vtkByteSwap::Swap4BERange( yCoords, this->NumberOfMeasuredPoints );
-    vtkByteSwap::Swap4BERange( zCoords, this->NumberOfMeasuredPoints );
+    vtkErrorMacro("Read failed");
     }
+  this->SwapRange4(coords, 3*this->NumberOfMeasuredPoints);
 
   for (i = 0; i < this->NumberOfMeasuredPoints; i++)
     {
@@ -1304,7 +1470,7 @@ int vtkPEnSightGoldBinaryReader::ReadMeasuredGeometryFile(const char* fileName,
     if( realId != -1)
       {
       vtkIdType tempId = realId;
-      points->InsertNextPoint(xCoords[i], yCoords[i], zCoords[i]);
+      points->InsertNextPoint(coords + 3*i);
       pd->InsertNextCell(VTK_VERTEX, 1, &tempId);
       }
     }
@@ -1315,9 +1481,7 @@ int vtkPEnSightGoldBinaryReader::ReadMeasuredGeometryFile(const char* fileName,
   points->Delete();
   pd->Delete();
   delete [] pointIds;
-  delete [] xCoords;
-  delete [] yCoords;
-  delete [] zCoords;
+  delete [] coords;
 
   if (this->IFile)
     {
@@ -1372,18 +1536,8 @@ int vtkPEnSightGoldBinaryReader::ReadScalarsPerNode(
   if (this->UseFileSets)
     {
     int realTimeStep = timeStep - 1;
-    // Try to find the nearest time step for which we know the offset
-    int j = 0;
-    for (i = realTimeStep; i >= 0; i--)
-      {
-      if (this->FileOffsets.find(fileName) != this->FileOffsets.end()
-          && this->FileOffsets[fileName].find(i) != this->FileOffsets[fileName].end())
-        {
-        this->IFile->seekg(this->FileOffsets[fileName][i], ios::beg);
-        j = i;
-        break;
-        }
-      }
+    // Start from the nearest time step for which we know the offset
+    int j = this->SeekToNearestTimeStep(fileName, realTimeStep);
 
     // Hopefully we are not very far from the timestep we want to use
     // Find it (and cache any timestep we find on the way...)
@@ -1426,14 +1580,11 @@ int vtkPEnSightGoldBinaryReader::ReadScalarsPerNode(
           this->IFile->seekg(sizeof(float)*numPts, ios::cur);
           }
         }
-      if (this->FileOffsets.find(fileName) == this->FileOffsets.end())
-        {
-        vtkstd::map<int, long> tsMap;
-        this->FileOffsets[fileName] = tsMap;
-        }
-      this->FileOffsets[fileName][j] = this->IFile->tellg();
+      this->AddTimeStepOffset(fileName, j, this->IFile->tellg());
       }
 
+    this->SaveTimeStepIndex(fileName);
+
     this->ReadLine(line);
     while (strncmp(line, "BEGIN TIME STEP", 15) != 0)
       {
@@ -1598,18 +1749,8 @@ int vtkPEnSightGoldBinaryReader::ReadVectorsPerNode(
   if (this->UseFileSets)
     {
     int realTimeStep = timeStep - 1;
-    // Try to find the nearest time step for which we know the offset
-    int j = 0;
-    for (i = realTimeStep; i >= 0; i--)
-      {
-      if (this->FileOffsets.find(fileName) != this->FileOffsets.end()
-          && this->FileOffsets[fileName].find(i) != this->FileOffsets[fileName].end())
-        {
-        this->IFile->seekg(this->FileOffsets[fileName][i], ios::beg);
-        j = i;
-        break;
-        }
-      }
+    // Start from the nearest time step for which we know the offset
+    int j = this->SeekToNearestTimeStep(fileName, realTimeStep);
 
     // Hopefully we are not very far from the timestep we want to use
     // Find it (and cache any timestep we find on the way...)
@@ -1652,14 +1793,11 @@ int vtkPEnSightGoldBinaryReader::ReadVectorsPerNode(
           this->IFile->seekg(sizeof(float)*3*numPts, ios::cur);
           }
         }
-      if (this->FileOffsets.find(fileName) == this->FileOffsets.end())
-        {
-        vtkstd::map<int, long> tsMap;
-        this->FileOffsets[fileName] = tsMap;
-        }
-      this->FileOffsets[fileName][j] = this->IFile->tellg();
+      this->AddTimeStepOffset(fileName, j, this->IFile->tellg());
       }
 
+    this->SaveTimeStepIndex(fileName);
+
     this->ReadLine(line);
     while (strncmp(line, "BEGIN TIME STEP", 15) != 0)
       {
@@ -1814,18 +1952,8 @@ int vtkPEnSightGoldBinaryReader::ReadTensorsPerNode(
   if (this->UseFileSets)
     {
     int realTimeStep = timeStep - 1;
-    int j = 0;
-    // Try to find the nearest time step for which we know the offset
-    for (i = realTimeStep; i >= 0; i--)
-      {
-      if (this->FileOffsets.find(fileName) != this->FileOffsets.end()
-          && this->FileOffsets[fileName].find(i) != this->FileOffsets[fileName].end())
-        {
-        this->IFile->seekg(this->FileOffsets[fileName][i], ios::beg);
-        j = i;
-        break;
-        }
-      }
+    // Start from the nearest time step for which we know the offset
+    int j = this->SeekToNearestTimeStep(fileName, realTimeStep);
 
     // Hopefully we are not very far from the timestep we want to use
     // Find it (and cache any timestep we find on the way...)
@@ -1853,13 +1981,10 @@ int vtkPEnSightGoldBinaryReader::ReadTensorsPerNode(
           this->IFile->seekg(sizeof(float)*6*numPts, ios::cur);
           }
         }
-      if (this->FileOffsets.find(fileName) == this->FileOffsets.end())
-        {
-        vtkstd::map<int, long> tsMap;
-        this->FileOffsets[fileName] = tsMap;
-        }
-      this->FileOffsets[fileName][j] = this->IFile->tellg();
+      this->AddTimeStepOffset(fileName, j, this->IFile->tellg());
       }
+    this->SaveTimeStepIndex(fileName);
+
     this->ReadLine(line);
     while (strncmp(line, "BEGIN TIME STEP", 15) != 0)
       {
@@ -1981,18 +2106,8 @@ int vtkPEnSightGoldBinaryReader::ReadScalarsPerElement(
   if (this->UseFileSets)
     {
     int realTimeStep = timeStep - 1;
-    // Try to find the nearest time step for which we know the offset
-    int j = 0;
-    for (i = realTimeStep; i >= 0; i--)
-      {
-      if (this->FileOffsets.find(fileName) != this->FileOffsets.end()
-          && this->FileOffsets[fileName].find(i) != this->FileOffsets[fileName].end())
-        {
-        this->IFile->seekg(this->FileOffsets[fileName][i], ios::beg);
-        j = i;
-        break;
-        }
-      }
+    // Start from the nearest time step for which we know the offset
+    int j = this->SeekToNearestTimeStep(fileName, realTimeStep);
 
     // Hopefully we are not very far from the timestep we want to use
     // Find it (and cache any timestep we find on the way...)
@@ -2055,13 +2170,10 @@ int vtkPEnSightGoldBinaryReader::ReadScalarsPerElement(
           lineRead = this->ReadLine(line);
           }
         } // end while
-      if (this->FileOffsets.find(fileName) == this->FileOffsets.end())
-        {
-        vtkstd::map<int, long> tsMap;
-        this->FileOffsets[fileName] = tsMap;
-        }
-      this->FileOffsets[fileName][j] = this->IFile->tellg();
+      this->AddTimeStepOffset(fileName, j, this->IFile->tellg());
       } // end for
+    this->SaveTimeStepIndex(fileName);
+
     this->ReadLine(line);
     while (strncmp(line, "BEGIN TIME STEP", 15) != 0)
       {
@@ -2238,18 +2350,8 @@ int vtkPEnSightGoldBinaryReader::ReadVectorsPerElement(
   if (this->UseFileSets)
     {
     int realTimeStep = timeStep - 1;
-    // Try to find the nearest time step for which we know the offset
-    int j = 0;
-    for (i = realTimeStep; i >= 0; i--)
-      {
-      if (this->FileOffsets.find(fileName) != this->FileOffsets.end()
-          && this->FileOffsets[fileName].find(i) != this->FileOffsets[fileName].end())
-        {
-        this->IFile->seekg(this->FileOffsets[fileName][i], ios::beg);
-        j = i;
-        break;
-        }
-      }
+    // Start from the nearest time step for which we know the offset
+    int j = this->SeekToNearestTimeStep(fileName, realTimeStep);
 
     // Hopefully we are not very far from the timestep we want to use
     // Find it (and cache any timestep we find on the way...)
@@ -2309,13 +2411,10 @@ int vtkPEnSightGoldBinaryReader::ReadVectorsPerElement(
           lineRead = this->ReadLine(line);
           }
         }
-      if (this->FileOffsets.find(fileName) == this->FileOffsets.end())
-        {
-        vtkstd::map<int, long> tsMap;
-        this->FileOffsets[fileName] = tsMap;
-        }
-      this->FileOffsets[fileName][j] = this->IFile->tellg();
+      this->AddTimeStepOffset(fileName, j, this->IFile->tellg());
       }
+    this->SaveTimeStepIndex(fileName);
+
     this->ReadLine(line);
     while (strncmp(line, "BEGIN TIME STEP", 15) != 0)
       {
@@ -2490,18 +2589,8 @@ int vtkPEnSightGoldBinaryReader::ReadTensorsPerElement(
   if (this->UseFileSets)
     {
     int realTimeStep = timeStep - 1;
-    // Try to find the nearest time step for which we know the offset
-    int j = 0;
-    for (i = realTimeStep; i >= 0; i--)
-      {
-      if (this->FileOffsets.find(fileName) != this->FileOffsets.end()
-          && this->FileOffsets[fileName].find(i) != this->FileOffsets[fileName].end())
-        {
-        this->IFile->seekg(this->FileOffsets[fileName][i], ios::beg);
-        j = i;
-        break;
-        }
-      }
+    // Start from the nearest time step for which we know the offset
+    int j = this->SeekToNearestTimeStep(fileName, realTimeStep);
 
     // Hopefully we are not very far from the timestep we want to use
     // Find it (and cache any timestep we find on the way...)
@@ -2562,13 +2651,10 @@ int vtkPEnSightGoldBinaryReader::ReadTensorsPerElement(
           lineRead = this->ReadLine(line);
           }
         }
-      if (this->FileOffsets.find(fileName) == this->FileOffsets.end())
-        {
-        vtkstd::map<int, long> tsMap;
-        this->FileOffsets[fileName] = tsMap;
-        }
-      this->FileOffsets[fileName][j] = this->IFile->tellg();
+      this->AddTimeStepOffset(fileName, j, this->IFile->tellg());
       }
+    this->SaveTimeStepIndex(fileName);
+
     this->ReadLine(line);
     while (strncmp(line, "BEGIN TIME STEP", 15) != 0)
       {
@@ -3847,27 +3933,44 @@ int vtkPEnSightGoldBinaryReader::CreateStructuredGridOutput(
   points->Allocate(this->GetPointIds(partId)->GetLocalNumberOfIds());
 
   long currentPositionInFile = this->IFile->tellg();
-
-  // Buffer Read.
-  this->FloatBufferFilePosition = currentPositionInFile;
-  this->FloatBufferIndexBegin = 0;
-  this->FloatBufferNumberOfVectors = numPts;
   long endFilePosition = currentPositionInFile + 3 * numPts * sizeof(float);
   if (this->Fortran)
     endFilePosition += 24; // 4 * (begin + end) * number of components (3)
-  this->UpdateFloatBuffer();
-  this->IFile->seekg(endFilePosition);
 
-  for (i = 0; i < numPts; i++)
+  // Read the coordinates by chunks, skipping the ones without local points
+  vtkPEnSightReaderCellIds* pointIds = this->GetPointIds(partId);
+  int chunkSize = numPts < this->CoordinatesChunkSize ?
+    numPts : this->CoordinatesChunkSize;
+  float* buffer = new float[3*chunkSize];
+  for (int begin = 0; begin < numPts; begin += chunkSize)
     {
-    int realPointId = this->GetPointIds(partId)->GetId(i);
-    if( realPointId != -1 )
+    int count = numPts - begin < chunkSize ? numPts - begin : chunkSize;
+    bool hasLocalPoints = false;
+    for (i = begin; i < begin + count && !hasLocalPoints; i++)
+      {
+      hasLocalPoints = pointIds->GetId(i) != -1;
+      }
+    if (!hasLocalPoints)
+      {
+      continue;
+      }
+    if (!this->ReadCoordinatesChunk(currentPositionInFile, numPts, begin,
+                                    count, buffer))
+      {
+      break;
+      }
+    for (i = 0; i < count; i++)
       {
-      float vec[3];
-      this->GetVectorFromFloatBuffer(i,vec);
-      points->InsertNextPoint(vec[0], vec[1], vec[2]);
+      if( pointIds->GetId(begin + i) != -1 )
+        {
+        float vec[3] = {buffer[i], buffer[count + i], buffer[2*count + i]};
+        points->InsertNextPoint(vec);
+        }
       }
     }
+  delete [] buffer;
+  this->IFile->seekg(endFilePosition);
+
   output->SetPoints(points);
   if (iblanked)
     {
@@ -4315,14 +4418,7 @@ int vtkPEnSightGoldBinaryReader::ReadIntArray(int *result,
     return 0;
     }
 
-  if (this->ByteOrder == FILE_LITTLE_ENDIAN)
-    {
-    vtkByteSwap::Swap4LERange(result, numInts);
-    }
-  else
-    {
-    vtkByteSwap::Swap4BERange(result, numInts);
-    }
+  this->SwapRange4(result, numInts);
 
   if (this->Fortran)
     {
@@ -4362,14 +4458,7 @@ int vtkPEnSightGoldBinaryReader::ReadFloatArray(float *result,
     return 0;
     }
 
-  if (this->ByteOrder == FILE_LITTLE_ENDIAN)
-    {
-    vtkByteSwap::Swap4LERange(result, numFloats);
-    }
-  else
-    {
-    vtkByteSwap::Swap4BERange(result, numFloats);
-    }
+  this->SwapRange4(result, numFloats);
 
   if (this->Fortran)
     {
@@ -4410,11 +4499,6 @@ int vtkPEnSightGoldBinaryReader::ReadOrSkipCoordinates(vtkPoints* points, long o
 
   long currentPositionInFile = this->IFile->tellg();
 
-  this->FloatBufferFilePosition = currentPositionInFile;
-  this->FloatBufferIndexBegin = 0;
-  this->FloatBufferNumberOfVectors = numPts;
-  this->UpdateFloatBuffer();
-
   // Position to reach at the end of this method
   long endFilePosition = currentPositionInFile + 3 * numPts * sizeof(float);
   if (this->Fortran)
@@ -4438,47 +4522,65 @@ int vtkPEnSightGoldBinaryReader::ReadOrSkipCoordinates(vtkPoints* points, long o
       {
       // No Point was injected at all For this Part. There is clearly a problem...
       // TODO: Do something ?
-      //delete [] xCoords;
-      //delete [] yCoords;
-      //delete [] zCoords;
       this->IFile->seekg(endFilePosition);
       return 0;
       }
     else
       {
       // Inject really needed points
-      int i;
-      int localNumberOfIds = this->GetPointIds(partId)->GetLocalNumberOfIds();
-      points->Allocate(localNumberOfIds);
+      vtkPEnSightReaderCellIds* pointIds = this->GetPointIds(partId);
+      int localNumberOfIds = pointIds->GetLocalNumberOfIds();
+      points->SetDataTypeToFloat();
       points->SetNumberOfPoints(localNumberOfIds);
-      int maxId = -1;
-      int minId = -1;
-      for (i = 0; i < numPts; i++)
-        {
-        float vec[3];
-        int id = this->GetPointIds(partId)->GetId(i);
-        if( id != -1 )
+      float* coords =
+        static_cast<vtkFloatArray*>(points->GetData())->GetPointer(0);
+
+      // Read the coordinates by chunks, skipping the ones without local
+      // points, and interleave them at their local index.
+      int chunkSize = numPts < this->CoordinatesChunkSize ?
+        numPts : this->CoordinatesChunkSize;
+      float* buffer = new float[3*chunkSize];
+      int result = localNumberOfIds;
+      for (int begin = 0; begin < numPts; begin += chunkSize)
+        {
+        int i;
+        int count = numPts - begin < chunkSize ? numPts - begin : chunkSize;
+        bool hasLocalPoints = false;
+        for (i = begin; i < begin + count && !hasLocalPoints; i++)
+          {
+          hasLocalPoints = pointIds->GetId(i) != -1;
+          }
+        if (!hasLocalPoints)
+          {
+          continue;
+          }
+        if (!this->ReadCoordinatesChunk(currentPositionInFile, numPts, begin,
+                                        count, buffer))
           {
-          if( (minId == -1 ) || (minId > id) )
-            minId = id;
-          if( (maxId == -1 ) || (maxId < id) )
-            maxId = id;
-          this->GetVectorFromFloatBuffer(i,vec);
-          points->SetPoint(id, vec[0], vec[1], vec[2]);
+          result = -1;
+          break;
+          }
+        for (i = 0; i < count; i++)
+          {
+          int id = pointIds->GetId(begin + i);
+          if( id != -1 )
+            {
+            coords[3*id] = buffer[i];
+            coords[3*id + 1] = buffer[count + i];
+            coords[3*id + 2] = buffer[2*count + i];
+            }
           }
         }
+      delete [] buffer;
 
       // Inject real Number of points, as we cannot take the size of the vector as a reference
       // numPts comes from the file, it cannot be wrong
       // Needed in nfaced...
       // In case read has never been skipped, we do this again here
-      this->GetPointIds(partId)->SetNumberOfIds(numPts);
+      pointIds->SetNumberOfIds(numPts);
 
-      //delete [] xCoords;
-      //delete [] yCoords;
-      //delete [] zCoords;
       this->IFile->seekg(endFilePosition);
-      return localNumberOfIds;
+      return result;
       }
     }
 }
@@ -4527,66 +4629,57 @@ int vtkPEnSightGoldBinaryReader::InjectCoordinatesAtEnd(vtkUnstructuredGrid* out
 }
 
 //----------------------------------------------------------------------------
-void vtkPEnSightGoldBinaryReader::GetVectorFromFloatBuffer(int i, float *vector)
+int vtkPEnSightGoldBinaryReader::ReadCoordinatesChunk(long position, int numPts,
+                                                       int begin, int count,
+                                                       float* buffer)
 {
-  // We assume FloatBufferIndexBegin, FloatBufferFilePosition, and FloatBufferNumberOfVectors
-  // were previously set.
-  int closestBufferBegin = (i / this->FloatBufferSize) * this->FloatBufferSize;
-  if( (this->FloatBufferIndexBegin == -1 ) || (closestBufferBegin != this->FloatBufferIndexBegin ) )
+  for (int i = 0; i < 3; i++)
     {
-    this->FloatBufferIndexBegin = closestBufferBegin;
-    this->UpdateFloatBuffer();
+    // We cannot use ReadFloatArray method, because Fortran format has dummy things
+    long componentPosition = position + i * numPts * sizeof(float);
+    if (this->Fortran)
+      {
+      componentPosition += 4 + i * 8;
+      }
+    this->IFile->seekg(componentPosition + begin * sizeof(float));
+    if (this->IFile->read((char*)(buffer + i * count), sizeof(float)*count) == 0)
+      {
+      vtkErrorMacro("Read failed");
+      return 0;
+      }
     }
-
-  int index = i - this->FloatBufferIndexBegin;
-  vector[0] = this->FloatBuffer[0][index];
-  vector[1] = this->FloatBuffer[1][index];
-  vector[2] = this->FloatBuffer[2][index];
+  this->SwapRange4(buffer, 3 * count);
+  return 1;
 }
 
 //----------------------------------------------------------------------------
-void vtkPEnSightGoldBinaryReader::UpdateFloatBuffer()
+void vtkPEnSightGoldBinaryReader::SwapRange4(void* values, vtkIdType number)
 {
-  long currentPosition = this->IFile->tellg();
-
-  int sizeToRead;
-  if( this->FloatBufferIndexBegin + this->FloatBufferSize > this->FloatBufferNumberOfVectors )
-    {
-    sizeToRead = this->FloatBufferNumberOfVectors - this->FloatBufferIndexBegin;
-    }
-  else
+  // Files of unknown byte order are read as big endian, like vtkByteSwap
+  // is used everywhere else.
+#ifdef VTK_WORDS_BIGENDIAN
+  if (this->ByteOrder != FILE_LITTLE_ENDIAN)
+#else
+  if (this->ByteOrder == FILE_LITTLE_ENDIAN)
+#endif
     {
-    sizeToRead = this->FloatBufferSize;
+    return;
     }
 
-  for(int i = 0; i < 3; i++)
+  // Plain shifts on whole words, which compilers turn into vector code
+  // unlike the byte by byte swap of vtkByteSwap.
+  vtkTypeUInt32* words = static_cast<vtkTypeUInt32*>(values);
+  for (vtkIdType i = 0; i < number; i++)
     {
-    // We cannot use ReadFloatArray method, because Fortran format has dummy things
-    if( this->Fortran )
-      this->IFile->seekg(this->FloatBufferFilePosition + 4 + i * (this->FloatBufferNumberOfVectors * sizeof(float) + 8) + this->FloatBufferIndexBegin * sizeof(float) );
-    else
-      this->IFile->seekg(this->FloatBufferFilePosition + i * this->FloatBufferNumberOfVectors * sizeof(float) + this->FloatBufferIndexBegin * sizeof(float) );
-
-    if (this->IFile->read((char*)this->FloatBuffer[i], sizeof(float)*sizeToRead) == 0)
-      {
-      vtkErrorMacro("Read failed");
-      }
-
-    if (this->ByteOrder == FILE_LITTLE_ENDIAN)
-      {
-      vtkByteSwap::Swap4LERange(this->FloatBuffer[i], sizeToRead);
-      }
-    else
-      {
-      vtkByteSwap::Swap4BERange(this->FloatBuffer[i], sizeToRead);
-      }
+    vtkTypeUInt32 word = words[i];
+    words[i] = (word >> 24) | ((word >> 8) & 0xff00) |
+      ((word << 8) & 0xff0000) | (word << 24);
     }
-
-  this->IFile->seekg(currentPosition);
 }
 
 //----------------------------------------------------------------------------
 void vtkPEnSightGoldBinaryReader::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os,indent);
+  os << indent << "SaveTimeStepOffsets: " << this->SaveTimeStepOffsets << endl;
 }
@@ -45,6 +45,16 @@ class VTK_EXPORT vtkPEnSightGoldBinaryReader : public vtkPEnSightReader
   vtkTypeMacro(vtkPEnSightGoldBinaryReader, vtkPEnSightReader);
   virtual void PrintSelf(ostream& os, vtkIndent indent);
 
+  // Description:
+  // Save the offsets of the time steps found while scanning a single file
+  // transient case without a FILE_INDEX in a "<file>.vtkindex" file next to
+  // it, so that the next session does not scan it again.  An index saved
+  // earlier is used either way.  Off by default, since it writes next to
+  // the data.
+  vtkSetMacro(SaveTimeStepOffsets, int);
+  vtkGetMacro(SaveTimeStepOffsets, int);
+  vtkBooleanMacro(SaveTimeStepOffsets, int);
+
  protected:
   vtkPEnSightGoldBinaryReader();
   ~vtkPEnSightGoldBinaryReader();
@@ -185,28 +195,73 @@ class VTK_EXPORT vtkPEnSightGoldBinaryReader : public vtkPEnSightReader
   int SkipRectilinearGrid(char line[256]);
   int SkipImageData(char line[256]);
 
+  // Description:
+  // Seek to the nearest time step at or before realTimeStep whose offset is
+  // known in a single file transient file, and return its index (0 when
+  // none is known and the file is left where it is). The offsets come from
+  // the FILE_INDEX at the end of the file when there is one, otherwise from
+  // an index saved next to the file by a previous scan.
+  int SeekToNearestTimeStep(const char* fileName, int realTimeStep);
+
+  // Description:
+  // Remember the offset of a time step found while scanning a file.
+  void AddTimeStepOffset(const char* fileName, int timeStep, long offset);
+
+  // Description:
+  // Save the offsets found while scanning next to the file when
+  // SaveTimeStepOffsets is on, so that the next session does not scan it
+  // again. Failures are ignored.
+  void SaveTimeStepIndex(const char* fileName);
+
+  // Description:
+  // Read the FILE_INDEX at the end of the opened file, or the index saved
+  // for it. Return 1 if offsets were found.
+  int ReadFileIndex(const char* fileName);
+  int ReadSavedTimeStepIndex(const char* fileName);
+//BTX
+  vtkstd::string GetTimeStepIndexFileName();
+//ETX
+  void SwapInt64(vtkTypeInt64* values, int number, int byteOrder);
+
   int NodeIdsListed;
   int ElementIdsListed;
   int Fortran;
+  int SaveTimeStepOffsets;
 
   ifstream *IFile;
   // The size of the file could be used to choose byte order.
   long FileSize;
+  long FileModificationTime;
+
+//BTX
+  // Name of the file opened by OpenFile().
+  vtkstd::string OpenedFileName;
+
+  enum
+  {
+    TIME_STEP_INDEX_FROM_FILE,
+    TIME_STEP_INDEX_SAVED,
+    TIME_STEP_INDEX_MODIFIED
+  };
+  // Where the time step offsets of each file come from.
+  vtkstd::map<vtkstd::string, int> TimeStepIndexStates;
+//ETX
+
+  // Description:
+  // Read the coordinates of points begin to begin + count - 1 of a part
+  // whose x, y and z blocks of numPts floats start at position. The x, then
+  // y, then z values are stored one after the other in buffer, in the byte
+  // order of this machine. Returns zero if there was an error.
+  int ReadCoordinatesChunk(long position, int numPts, int begin, int count,
+                           float* buffer);
+
+  // Description:
+  // Swap 4 bytes values read from the file to the byte order of this
+  // machine, if they differ.
+  void SwapRange4(void* values, vtkIdType number);
 
-  // Float Vector Buffer utils
-  void GetVectorFromFloatBuffer(int i, float *vector);
-  void UpdateFloatBuffer();
-  // The buffer
-  float **FloatBuffer;
-  // The buffer size. Default is 1000
-  int FloatBufferSize;
-  // The FloatBuffer store the vectors
-  // from FloatBufferIndexBegin to FloatBufferIndexBegin + FloatBufferSize
-  int FloatBufferIndexBegin;
-  // X variable positions of vector number 0 in file
-  long FloatBufferFilePosition;
-  // Total number of vectors;
-  int FloatBufferNumberOfVectors;
+  // Number of points whose coordinates are read at once. Default is 1M.
+  int CoordinatesChunkSize;
 
  private:
   vtkPEnSightGoldBinaryReader(const vtkPEnSightGoldBinaryReader&);  // Not implemented.
@@ -44,6 +44,7 @@ vtkPGenericEnSightReader::vtkPGenericEnSightReader()
   // -2 is the default starting value
   this->MultiProcessLocalProcessId = -2;
   this->MultiProcessNumberOfProcesses = -2;
+  this->SaveTimeStepOffsets = 0;
 }
 
 //----------------------------------------------------------------------------
@@ -103,7 +104,8 @@ int vtkPGenericEnSightReader::RequestInformation(
       {
       this->Reader = vtkPEnSightGoldBinaryReader::New();
       }
-
+    static_cast<vtkPEnSightGoldBinaryReader*>(this->Reader)->
+      SetSaveTimeStepOffsets(this->SaveTimeStepOffsets);
     }
   else
     {
@@ -205,4 +207,5 @@ void vtkPGenericEnSightReader::PrintSelf(ostream& os, vtkIndent indent)
   this->Superclass::PrintSelf(os, indent);
   os << indent << "MultiProcessLocalProcessId: " << this->MultiProcessLocalProcessId << endl;
   os << indent << "MultiProcessNumberOfProcesses: " << this->MultiProcessNumberOfProcesses << endl;
+  os << indent << "SaveTimeStepOffsets: " << this->SaveTimeStepOffsets << endl;
 }
@@ -34,6 +34,14 @@ public:
   vtkTypeMacro(vtkPGenericEnSightReader, vtkGenericEnSightReader);
   void PrintSelf(ostream& os, vtkIndent indent);
 
+  // Description:
+  // Passed to vtkPEnSightGoldBinaryReader: save the offsets of the time
+  // steps of single file transient binary cases next to the files.  Off by
+  // default.
+  vtkSetMacro(SaveTimeStepOffsets, int);
+  vtkGetMacro(SaveTimeStepOffsets, int);
+  vtkBooleanMacro(SaveTimeStepOffsets, int);
+
 protected:
   vtkPGenericEnSightReader();
   ~vtkPGenericEnSightReader();
@@ -51,6 +59,7 @@ protected:
 
   int MultiProcessLocalProcessId;
   int MultiProcessNumberOfProcesses;
+  int SaveTimeStepOffsets;
 
 private:
   vtkPGenericEnSightReader(const vtkPGenericEnSightReader&);  // Not implemented.
@@ -17,16 +17,787 @@
 #include "vtkGraph.h"
 #include "vtkDataSet.h"
 #include "vtkCellData.h"
+#include "vtkDataArray.h"
 #include "vtkPointData.h"
 #include "vtkDataObject.h"
 #include "vtkInformation.h"
 #include "vtkObjectFactory.h"
 #include "vtkInformationVector.h"
+#include "vtkMultiThreader.h"
+#include "vtkPoints.h"
+#include "vtkPointSet.h"
+#include "vtkSmartPointer.h"
 
+#include <vtkstd/algorithm>
+#include <vtkstd/map>
+#include <vtkstd/string>
+#include <vtkstd/vector>
 #include <vtksys/ios/sstream>
 #include <assert.h>
+#include <ctype.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
 
 vtkStandardNewMacro( vtkPVArrayCalculator );
+
+namespace
+{
+// The coordinate variables registered by UpdateArrayAndVariableNames().
+const char * const CoordinateScalarNames[3] = { "coordsX", "coordsY", "coordsZ" };
+const char   CoordinateVectorName[] = "coords";
+
+// Number of tuples evaluated at once, small enough for the registers of a
+// block to stay in cache.
+const vtkIdType BlockSize = 1024;
+
+// ----------------------------------------------------------------------------
+// A compiled function: operations on registers that each hold one value for
+// every tuple of a block. Vectors use three registers.
+class vtkPVArrayCalculatorProgram
+{
+public:
+  enum OpCodes
+    {
+    CONSTANT,
+    UNARY_MINUS,
+    ADD,
+    SUBTRACT,
+    MULTIPLY,
+    DIVIDE,
+    POWER,
+    ABSOLUTE_VALUE,
+    EXPONENT,
+    CEILING,
+    FLOOR,
+    LOGARITHME,
+    LOGARITHM10,
+    SQUARE_ROOT,
+    SINE,
+    COSINE,
+    TANGENT,
+    ARC_SINE,
+    ARC_COSINE,
+    ARC_TANGENT,
+    HYPERBOLIC_SINE,
+    HYPERBOLIC_COSINE,
+    HYPERBOLIC_TANGENT
+    };
+
+  struct Operation
+    {
+    int    OpCode;
+    int    Result;
+    int    Operands[2];
+    double Value;
+    };
+
+  // A component of an input array, or of the point coordinates when
+  // ArrayName is empty, loaded into a register before the operations run.
+  struct Input
+    {
+    vtkstd::string ArrayName;
+    int            Component;
+    int            Register;
+    };
+
+  vtkPVArrayCalculatorProgram() : NumberOfRegisters( 0 ), NumberOfResults( 0 )
+    {
+    }
+
+  // Run the operations on the first n values of the registers. Returns false
+  // as soon as the function is not defined for one of the tuples.
+  bool Execute( vtkstd::vector<double> & registers, vtkIdType n ) const;
+
+  vtkstd::vector<Input>     Inputs;
+  vtkstd::vector<Operation> Operations;
+  int                       NumberOfRegisters;
+  int                       NumberOfResults;
+  int                       Results[3];
+};
+
+// ----------------------------------------------------------------------------
+bool vtkPVArrayCalculatorProgram::Execute( vtkstd::vector<double> & registers,
+                                           vtkIdType n ) const
+{
+  for ( size_t i = 0; i < this->Operations.size(); i ++ )
+    {
+    const Operation & op = this->Operations[i];
+    double       * r = &registers[0] + op.Result * BlockSize;
+    const double * a = &registers[0] + op.Operands[0] * BlockSize;
+    const double * b = &registers[0] + op.Operands[1] * BlockSize;
+    vtkIdType      k;
+
+    // vtkFunctionParser refuses these, let it report them.
+    switch ( op.OpCode )
+      {
+      case DIVIDE:
+        for ( k = 0; k < n; k ++ )
+          {
+          if ( b[k] == 0.0 )
+            {
+            return false;
+            }
+          }
+        break;
+      case POWER:
+        for ( k = 0; k < n; k ++ )
+          {
+          if ( ( a[k] < 0.0 && b[k] != floor( b[k] ) ) ||
+               ( a[k] == 0.0 && b[k] < 0.0 ) )
+            {
+            return false;
+            }
+          }
+        break;
+      case LOGARITHME:
+      case LOGARITHM10:
+        for ( k = 0; k < n; k ++ )
+          {
+          if ( a[k] <= 0.0 )
+            {
+            return false;
+            }
+          }
+        break;
+      case SQUARE_ROOT:
+        for ( k = 0; k < n; k ++ )
+          {
+          if ( a[k] < 0.0 )
+            {
+            return false;
+            }
+          }
+        break;
+      case ARC_SINE:
+      case ARC_COSINE:
+        for ( k = 0; k < n; k ++ )
+          {
+          if ( a[k] < -1.0 || a[k] > 1.0 )
+            {
+            return false;
+            }
+          }
+        break;
+      }
+
+    // Plain loops, the compiler vectorizes them.
+    switch ( op.OpCode )
+      {
+      case CONSTANT:
+        for ( k = 0; k < n; k ++ ) r[k] = op.Value;
+        break;
+      case UNARY_MINUS:
+        for ( k = 0; k < n; k ++ ) r[k] = -a[k];
+        break;
+      case ADD:
+        for ( k = 0; k < n; k ++ ) r[k] = a[k] + b[k];
+        break;
+      case SUBTRACT:
+        for ( k = 0; k < n; k ++ ) r[k] = a[k] - b[k];
+        break;
+      case MULTIPLY:
+        for ( k = 0; k < n; k ++ ) r[k] = a[k] * b[k];
+        break;
+      case DIVIDE:
+        for ( k = 0; k < n; k ++ ) r[k] = a[k] / b[k];
+        break;
+      case POWER:
+        for ( k = 0; k < n; k ++ ) r[k] = pow( a[k], b[k] );
+        break;
+      case ABSOLUTE_VALUE:
+        for ( k = 0; k < n; k ++ ) r[k] = fabs( a[k] );
+        break;
+      case EXPONENT:
+        for ( k = 0; k < n; k ++ ) r[k] = exp( a[k] );
+        break;
+      case CEILING:
+        for ( k = 0; k < n; k ++ ) r[k] = ceil( a[k] );
+        break;
+      case FLOOR:
+        for ( k = 0; k < n; k ++ ) r[k] = floor( a[k] );
+        break;
+      case LOGARITHME:
+        for ( k = 0; k < n; k ++ ) r[k] = log( a[k] );
+        break;
+      case LOGARITHM10:
+        for ( k = 0; k < n; k ++ ) r[k] = log10( a[k] );
+        break;
+      case SQUARE_ROOT:
+        for ( k = 0; k < n; k ++ ) r[k] = sqrt( a[k] );
+        break;
+      case SINE:
+        for ( k = 0; k < n; k ++ ) r[k] = sin( a[k] );
+        break;
+      case COSINE:
+        for ( k = 0; k < n; k ++ ) r[k] = cos( a[k] );
+        break;
+      case TANGENT:
+        for ( k = 0; k < n; k ++ ) r[k] = tan( a[k] );
+        break;
+      case ARC_SINE:
+        for ( k = 0; k < n; k ++ ) r[k] = asin( a[k] );
+        break;
+      case ARC_COSINE:
+        for ( k = 0; k < n; k ++ ) r[k] = acos( a[k] );
+        break;
+      case ARC_TANGENT:
+        for ( k = 0; k < n; k ++ ) r[k] = atan( a[k] );
+        break;
+      case HYPERBOLIC_SINE:
+        for ( k = 0; k < n; k ++ ) r[k] = sinh( a[k] );
+        break;
+      case HYPERBOLIC_COSINE:
+        for ( k = 0; k < n; k ++ ) r[k] = cosh( a[k] );
+        break;
+      case HYPERBOLIC_TANGENT:
+        for ( k = 0; k < n; k ++ ) r[k] = tanh( a[k] );
+        break;
+      }
+    }
+  return true;
+}
+
+// ----------------------------------------------------------------------------
+// Compiles a function the way vtkFunctionParser parses it: a substring is
+// split at the rightmost operator of the lowest precedence outside of any
+// parenthesis, so the operations are grouped, and rounded, the same way.
+// Compile() returns false for anything it does not handle.
+class vtkPVArrayCalculatorCompiler
+{
+public:
+  // A variable: one or three components of an array, or of the point
+  // coordinates when ArrayName is empty.
+  struct Variable
+    {
+    vtkstd::string ArrayName;
+    int            NumberOfComponents;
+    int            Components[3];
+    };
+
+  vtkstd::map<vtkstd::string, Variable> Variables;
+
+  bool Compile( const char * function, vtkPVArrayCalculatorProgram * program );
+
+private:
+  struct Value
+    {
+    int Size;
+    int Registers[3];
+    };
+
+  bool Compile( int begin, int end, Value & value );
+  bool IsEnclosed( int begin, int end );
+  int  GetFunction( int begin, int & open );
+  bool Negate( Value & value );
+  bool Combine( char op, const Value & left, const Value & right,
+                Value & value );
+  int  AddOperation( int opCode, int operand0 = 0, int operand1 = 0,
+                     double constant = 0.0 );
+  int  AddInput( const vtkstd::string & arrayName, int component );
+
+  vtkstd::string                Function;
+  vtkPVArrayCalculatorProgram * Program;
+};
+
+// ----------------------------------------------------------------------------
+bool vtkPVArrayCalculatorCompiler::Compile( const char * function,
+                                            vtkPVArrayCalculatorProgram * program )
+{
+  // vtkFunctionParser ignores white space.
+  this->Function.clear();
+  for ( const char * c = function; c && *c; c ++ )
+    {
+    if ( !isspace( *c ) )
+      {
+      this->Function += *c;
+      }
+    }
+
+  // The parser has its own rules for variable names that contain operators
+  // or parenthesis, leave those to it.
+  vtkstd::map<vtkstd::string, Variable>::iterator it;
+  for ( it = this->Variables.begin(); it != this->Variables.end(); ++ it )
+    {
+    const vtkstd::string & name = it->first;
+    for ( size_t i = 0; i < name.size(); i ++ )
+      {
+      if ( !isalnum( name[i] ) && name[i] != '_' &&
+           ( strstr( function, name.c_str() ) ||
+             this->Function.find( name ) != vtkstd::string::npos ) )
+        {
+        return false;
+        }
+      }
+    }
+
+  this->Program = program;
+  Value value;
+  if ( this->Function.empty() ||
+       !this->Compile( 0, static_cast<int>( this->Function.size() ) - 1, value ) )
+    {
+    return false;
+    }
+  program->NumberOfResults = value.Size;
+  for ( int i = 0; i < value.Size; i ++ )
+    {
+    program->Results[i] = value.Registers[i];
+    }
+  return true;
+}
+
+// ----------------------------------------------------------------------------
+bool vtkPVArrayCalculatorCompiler::IsEnclosed( int begin, int end )
+{
+  if ( this->Function[begin] != '(' || this->Function[end] != ')' )
+    {
+    return false;
+    }
+  int depth = 0;
+  for ( int i = begin; i < end; i ++ )
+    {
+    depth += this->Function[i] == '(' ? 1 : ( this->Function[i] == ')' ? -1 : 0 );
+    if ( depth == 0 )
+      {
+      return false;
+      }
+    }
+  return true;
+}
+
+// ----------------------------------------------------------------------------
+// The function names, -1 for mag().
+static const struct
+{
+  const char * Name;
+  int          OpCode;
+} vtkPVArrayCalculatorFunctions[] =
+{
+  { "abs",   vtkPVArrayCalculatorProgram::ABSOLUTE_VALUE },
+  { "exp",   vtkPVArrayCalculatorProgram::EXPONENT },
+  { "ceil",  vtkPVArrayCalculatorProgram::CEILING },
+  { "floor", vtkPVArrayCalculatorProgram::FLOOR },
+  { "ln",    vtkPVArrayCalculatorProgram::LOGARITHME },
+  { "log10", vtkPVArrayCalculatorProgram::LOGARITHM10 },
+  { "sqrt",  vtkPVArrayCalculatorProgram::SQUARE_ROOT },
+  { "sin",   vtkPVArrayCalculatorProgram::SINE },
+  { "cos",   vtkPVArrayCalculatorProgram::COSINE },
+  { "tan",   vtkPVArrayCalculatorProgram::TANGENT },
+  { "asin",  vtkPVArrayCalculatorProgram::ARC_SINE },
+  { "acos",  vtkPVArrayCalculatorProgram::ARC_COSINE },
+  { "atan",  vtkPVArrayCalculatorProgram::ARC_TANGENT },
+  { "sinh",  vtkPVArrayCalculatorProgram::HYPERBOLIC_SINE },
+  { "cosh",  vtkPVArrayCalculatorProgram::HYPERBOLIC_COSINE },
+  { "tanh",  vtkPVArrayCalculatorProgram::HYPERBOLIC_TANGENT },
+  { "mag",   -1 },
+  { NULL,    0 }
+};
+
+// ----------------------------------------------------------------------------
+// Returns the index of the function called at begin, -1 if there is none.
+int vtkPVArrayCalculatorCompiler::GetFunction( int begin, int & open )
+{
+  open = begin;
+  while ( open < static_cast<int>( this->Function.size() ) &&
+          isalnum( this->Function[open] ) )
+    {
+    open ++;
+    }
+  if ( open == static_cast<int>( this->Function.size() ) ||
+       this->Function[open] != '(' )
+    {
+    return -1;
+    }
+  vtkstd::string name = this->Function.substr( begin, open - begin );
+  for ( int i = 0; vtkPVArrayCalculatorFunctions[i].Name; i ++ )
+    {
+    if ( name == vtkPVArrayCalculatorFunctions[i].Name )
+      {
+      // A variable with the same name would be ambiguous.
+      return this->Variables.count( name ) ? -1 : i;
+      }
+    }
+  return -1;
+}
+
+// ----------------------------------------------------------------------------
+bool vtkPVArrayCalculatorCompiler::Compile( int begin, int end, Value & value )
+{
+  static const char operators[] = "|&=<>+-.*/^";
+  const vtkstd::string & f = this->Function;
+  int open;
+
+  if ( begin > end )
+    {
+    return false;
+    }
+  if ( this->IsEnclosed( begin, end ) )
+    {
+    return this->Compile( begin + 1, end - 1, value );
+    }
+
+  if ( f[begin] == '-' && begin < end )
+    {
+    if ( this->IsEnclosed( begin + 1, end ) ||
+         ( this->GetFunction( begin + 1, open ) >= 0 &&
+           this->IsEnclosed( open, end ) ) )
+      {
+      return this->Compile( begin + 1, end, value ) && this->Negate( value );
+      }
+    }
+
+  int function = this->GetFunction( begin, open );
+  if ( function >= 0 && this->IsEnclosed( open, end ) )
+    {
+    Value argument;
+    if ( !this->Compile( open + 1, end - 1, argument ) )
+      {
+      return false;
+      }
+    int opCode = vtkPVArrayCalculatorFunctions[function].OpCode;
+    value.Size = 1;
+    if ( opCode < 0 && argument.Size == 3 )
+      {
+      int * r = argument.Registers;
+      int   x = this->AddOperation( vtkPVArrayCalculatorProgram::MULTIPLY, r[0], r[0] );
+      int   y = this->AddOperation( vtkPVArrayCalculatorProgram::MULTIPLY, r[1], r[1] );
+      int   z = this->AddOperation( vtkPVArrayCalculatorProgram::MULTIPLY, r[2], r[2] );
+      int   sum = this->AddOperation( vtkPVArrayCalculatorProgram::ADD, x, y );
+      sum = this->AddOperation( vtkPVArrayCalculatorProgram::ADD, sum, z );
+      value.Registers[0] =
+        this->AddOperation( vtkPVArrayCalculatorProgram::SQUARE_ROOT, sum );
+      return true;
+      }
+    if ( opCode >= 0 && argument.Size == 1 )
+      {
+      value.Registers[0] = this->AddOperation( opCode, argument.Registers[0] );
+      return true;
+      }
+    return false;
+    }
+
+  for ( int op = 0; operators[op]; op ++ )
+    {
+    int depth = 0;
+    for ( int i = end; i > begin; i -- )
+      {
+      if ( f[i] == ')' )
+        {
+        depth ++;
+        }
+      else if ( f[i] == '(' )
+        {
+        depth --;
+        }
+      if ( depth != 0 || f[i] != operators[op] )
+        {
+        continue;
+        }
+      // A minus following an operator, a parenthesis or the exponent of a
+      // number is unary, a dot followed by a digit is a decimal point.
+      if ( f[i] == '-' &&
+           ( strchr( "|&=<>+-.*/^(", f[i-1] ) ||
+             ( f[i-1] == 'e' && i > 1 && isdigit( f[i-2] ) ) ) )
+        {
+        continue;
+        }
+      if ( f[i] == '.' && i + 1 <= end && isdigit( f[i+1] ) )
+        {
+        continue;
+        }
+      // Logical and comparison operators are left to vtkFunctionParser.
+      if ( strchr( "|&=<>", f[i] ) )
+        {
+        return false;
+        }
+      Value left;
+      Value right;
+      return this->Compile( begin, i - 1, left ) &&
+        this->Compile( i + 1, end, right ) &&
+        this->Combine( f[i], left, right, value );
+      }
+    }
+
+  // A number, a variable or a unit vector, maybe negated.
+  bool negate = f[begin] == '-';
+  vtkstd::string name = f.substr( negate ? begin + 1 : begin,
+                                  negate ? end - begin : end - begin + 1 );
+  if ( name.empty() )
+    {
+    return false;
+    }
+  vtkstd::map<vtkstd::string, Variable>::iterator it =
+    this->Variables.find( name );
+  if ( it != this->Variables.end() )
+    {
+    value.Size = it->second.NumberOfComponents;
+    for ( int i = 0; i < value.Size; i ++ )
+      {
+      value.Registers[i] =
+        this->AddInput( it->second.ArrayName, it->second.Components[i] );
+      }
+    }
+  else if ( name == "iHat" || name == "jHat" || name == "kHat" )
+    {
+    value.Size = 3;
+    for ( int i = 0; i < 3; i ++ )
+      {
+      value.Registers[i] = this->AddOperation(
+        vtkPVArrayCalculatorProgram::CONSTANT, 0, 0, name[0] - 'i' == i ? 1.0 : 0.0 );
+      }
+    }
+  else if ( isdigit( name[0] ) || name[0] == '.' )
+    {
+    char * last;
+    double number = strtod( name.c_str(), &last );
+    if ( *last )
+      {
+      return false;
+      }
+    value.Size = 1;
+    value.Registers[0] =
+      this->AddOperation( vtkPVArrayCalculatorProgram::CONSTANT, 0, 0, number );
+    }
+  else
+    {
+    return false;
+    }
+  return !negate || this->Negate( value );
+}
+
+// ----------------------------------------------------------------------------
+bool vtkPVArrayCalculatorCompiler::Negate( Value & value )
+{
+  for ( int i = 0; i < value.Size; i ++ )
+    {
+    value.Registers[i] = this->AddOperation(
+      vtkPVArrayCalculatorProgram::UNARY_MINUS, value.Registers[i] );
+    }
+  return true;
+}
+
+// ----------------------------------------------------------------------------
+bool vtkPVArrayCalculatorCompiler::Combine( char op, const Value & left,
+                                            const Value & right, Value & value )
+{
+  const int * l = left.Registers;
+  const int * r = right.Registers;
+  int         opCode;
+  switch ( op )
+    {
+    case '+':
+      opCode = vtkPVArrayCalculatorProgram::ADD;
+      break;
+    case '-':
+      opCode = vtkPVArrayCalculatorProgram::SUBTRACT;
+      break;
+    case '*':
+      opCode = vtkPVArrayCalculatorProgram::MULTIPLY;
+      break;
+    case '/':
+      opCode = vtkPVArrayCalculatorProgram::DIVIDE;
+      break;
+    case '^':
+      opCode = vtkPVArrayCalculatorProgram::POWER;
+      break;
+    case '.':
+      {
+      // The dot product, ( x1 * x2 + y1 * y2 ) + z1 * z2.
+      if ( left.Size != 3 || right.Size != 3 )
+        {
+        return false;
+        }
+      int x = this->AddOperation( vtkPVArrayCalculatorProgram::MULTIPLY, l[0], r[0] );
+      int y = this->AddOperation( vtkPVArrayCalculatorProgram::MULTIPLY, l[1], r[1] );
+      int z = this->AddOperation( vtkPVArrayCalculatorProgram::MULTIPLY, l[2], r[2] );
+      int sum = this->AddOperation( vtkPVArrayCalculatorProgram::ADD, x, y );
+      value.Size = 1;
+      value.Registers[0] =
+        this->AddOperation( vtkPVArrayCalculatorProgram::ADD, sum, z );
+      return true;
+      }
+    default:
+      return false;
+    }
+
+  if ( left.Size == right.Size &&
+       ( left.Size == 1 || op == '+' || op == '-' ) )
+    {
+    // Scalars, or vectors component by component.
+    value.Size = left.Size;
+    for ( int i = 0; i < value.Size; i ++ )
+      {
+      value.Registers[i] = this->AddOperation( opCode, l[i], r[i] );
+      }
+    return true;
+    }
+  if ( op == '*' && left.Size != right.Size )
+    {
+    // A scalar times a vector.
+    const Value & scalar = left.Size == 1 ? left : right;
+    const Value & vector = left.Size == 1 ? right : left;
+    value.Size = 3;
+    for ( int i = 0; i < 3; i ++ )
+      {
+      value.Registers[i] = this->AddOperation( opCode,
+        vector.Registers[i], scalar.Registers[0] );
+      }
+    return true;
+    }
+  return false;
+}
+
+// ----------------------------------------------------------------------------
+int vtkPVArrayCalculatorCompiler::AddOperation( int opCode, int operand0,
+                                                int operand1, double constant )
+{
+  vtkPVArrayCalculatorProgram::Operation op;
+  op.OpCode      = opCode;
+  op.Result      = this->Program->NumberOfRegisters ++;
+  op.Operands[0] = operand0;
+  op.Operands[1] = operand1;
+  op.Value       = constant;
+  this->Program->Operations.push_back( op );
+  return op.Result;
+}
+
+// ----------------------------------------------------------------------------
+int vtkPVArrayCalculatorCompiler::AddInput( const vtkstd::string & arrayName,
+                                            int component )
+{
+  vtkstd::vector<vtkPVArrayCalculatorProgram::Input> & inputs =
+    this->Program->Inputs;
+  for ( size_t i = 0; i < inputs.size(); i ++ )
+    {
+    if ( inputs[i].ArrayName == arrayName && inputs[i].Component == component )
+      {
+      return inputs[i].Register;
+      }
+    }
+  vtkPVArrayCalculatorProgram::Input input;
+  input.ArrayName = arrayName;
+  input.Component = component;
+  input.Register  = this->Program->NumberOfRegisters ++;
+  inputs.push_back( input );
+  return input.Register;
+}
+
+// ----------------------------------------------------------------------------
+template <class T>
+void vtkPVArrayCalculatorLoad( const T * data, int numComps, int component,
+                               vtkIdType begin, vtkIdType n, double * values )
+{
+  data += begin * numComps + component;
+  for ( vtkIdType k = 0; k < n; k ++ )
+    {
+    values[k] = static_cast<double>( data[k * numComps] );
+    }
+}
+
+// ----------------------------------------------------------------------------
+template <class T>
+void vtkPVArrayCalculatorStore( T * data, int numComps, int component,
+                                vtkIdType begin, vtkIdType n,
+                                const double * values )
+{
+  data += begin * numComps + component;
+  for ( vtkIdType k = 0; k < n; k ++ )
+    {
+    data[k * numComps] = static_cast<T>( values[k] );
+    }
+}
+
+// ----------------------------------------------------------------------------
+bool vtkPVArrayCalculatorIsSupported( int dataType )
+{
+  switch ( dataType )
+    {
+    vtkTemplateMacro( return true );
+    }
+  return false;
+}
+
+// ----------------------------------------------------------------------------
+// What the threads share. Blocks are dealt round robin.
+struct vtkPVArrayCalculatorWork
+{
+  const vtkPVArrayCalculatorProgram * Program;
+  // The array of each input, NULL for coordinates that have to be asked to
+  // the data set.
+  vtkstd::vector<vtkDataArray *>      Arrays;
+  vtkDataSet                        * Input;
+  vtkDataArray                      * Result;
+  vtkIdType                           NumberOfTuples;
+  vtkIdType                           NumberOfBlocks;
+  // Set by a thread that found a tuple for which the function is undefined.
+  vtkstd::vector<int>                 Failed;
+};
+
+// ----------------------------------------------------------------------------
+VTK_THREAD_RETURN_TYPE vtkPVArrayCalculatorExecute( void * arg )
+{
+  vtkMultiThreader::ThreadInfo * info =
+    static_cast<vtkMultiThreader::ThreadInfo *>( arg );
+  vtkPVArrayCalculatorWork * work =
+    static_cast<vtkPVArrayCalculatorWork *>( info->UserData );
+  const vtkPVArrayCalculatorProgram * program = work->Program;
+  vtkDataArray * result   = work->Result;
+  int            numComps = result->GetNumberOfComponents();
+
+  vtkstd::vector<double> registers( program->NumberOfRegisters * BlockSize );
+  for ( vtkIdType block = info->ThreadID; block < work->NumberOfBlocks;
+        block += info->NumberOfThreads )
+    {
+    vtkIdType begin = block * BlockSize;
+    vtkIdType n     = vtkstd::min( BlockSize, work->NumberOfTuples - begin );
+
+    for ( size_t i = 0; i < program->Inputs.size(); i ++ )
+      {
+      const vtkPVArrayCalculatorProgram::Input & input = program->Inputs[i];
+      double       * values = &registers[0] + input.Register * BlockSize;
+      vtkDataArray * array  = work->Arrays[i];
+      if ( array )
+        {
+        switch ( array->GetDataType() )
+          {
+          vtkTemplateMacro( vtkPVArrayCalculatorLoad(
+            static_cast<VTK_TT *>( array->GetVoidPointer( 0 ) ),
+            array->GetNumberOfComponents(), input.Component, begin, n,
+            values ) );
+          }
+        }
+      else
+        {
+        double point[3];
+        for ( vtkIdType k = 0; k < n; k ++ )
+          {
+          work->Input->GetPoint( begin + k, point );
+          values[k] = point[input.Component];
+          }
+        }
+      }
+
+    if ( !program->Execute( registers, n ) )
+      {
+      work->Failed[info->ThreadID] = 1;
+      break;
+      }
+
+    for ( int c = 0; c < numComps; c ++ )
+      {
+      const double * values =
+        &registers[0] + program->Results[c] * BlockSize;
+      switch ( result->GetDataType() )
+        {
+        vtkTemplateMacro( vtkPVArrayCalculatorStore(
+          static_cast<VTK_TT *>( result->GetVoidPointer( 0 ) ),
+          numComps, c, begin, n, values ) );
+        }
+      }
+    }
+  return VTK_THREAD_RETURN_VALUE;
+}
+}
 // ----------------------------------------------------------------------------
 vtkPVArrayCalculator::vtkPVArrayCalculator()
 {
@@ -51,10 +822,10 @@ void vtkPVArrayCalculator::UpdateArrayAndVariableNames
   this->RemoveAllVariables();
   
   // Add coordinate scalar and vector variables
-  this->AddCoordinateScalarVariable( "coordsX", 0 );
-  this->AddCoordinateScalarVariable( "coordsY", 1 );
-  this->AddCoordinateScalarVariable( "coordsZ", 2 );
-  this->AddCoordinateVectorVariable( "coords",  0, 1, 2 );
+  this->AddCoordinateScalarVariable( CoordinateScalarNames[0], 0 );
+  this->AddCoordinateScalarVariable( CoordinateScalarNames[1], 1 );
+  this->AddCoordinateScalarVariable( CoordinateScalarNames[2], 2 );
+  this->AddCoordinateVectorVariable( CoordinateVectorName,  0, 1, 2 );
   
   // add non-coordinate scalar and vector variables
   int numberArays = inDataAttrs->GetNumberOfArrays(); // the input
@@ -154,6 +925,12 @@ int vtkPVArrayCalculator::RequestData
     // put is the input of a (some) subsequent calculator(s) or the user changes
     // the input of a downstream calculator.
     this->UpdateArrayAndVariableNames( input, dataAttrs );
+
+    if ( dsInput && this->RequestCompiledData( dsInput, dataAttrs, numTuples,
+           vtkDataSet::GetData( outputVector, 0 ) ) )
+      {
+      return 1;
+      }
     }
   
   input      = NULL;
@@ -164,6 +941,156 @@ int vtkPVArrayCalculator::RequestData
   return this->Superclass::RequestData( request, inputVector, outputVector );
 }
 
+// ----------------------------------------------------------------------------
+int vtkPVArrayCalculator::RequestCompiledData
+  ( vtkDataSet * input, vtkDataSetAttributes * inDataAttrs, vtkIdType numTuples,
+    vtkDataSet * output )
+{
+  if ( !output || !this->GetFunction() || !this->GetResultArrayName() ||
+       this->GetCoordinateResults() ||
+       !vtkPVArrayCalculatorIsSupported( this->GetResultArrayType() ) )
+    {
+    return 0;
+    }
+
+  // The superclass refuses to run when any variable is missing, let it say so.
+  vtkPVArrayCalculatorCompiler compiler;
+  int i, j;
+  for ( i = 0; i < this->GetNumberOfScalarArrays(); i ++ )
+    {
+    vtkDataArray * array = inDataAttrs->GetArray( this->GetScalarArrayName( i ) );
+    int component = this->GetSelectedScalarComponent( i );
+    if ( !array || component >= array->GetNumberOfComponents() ||
+         !vtkPVArrayCalculatorIsSupported( array->GetDataType() ) ||
+         compiler.Variables.count( this->GetScalarVariableName( i ) ) )
+      {
+      return 0;
+      }
+    vtkPVArrayCalculatorCompiler::Variable & variable =
+      compiler.Variables[this->GetScalarVariableName( i )];
+    variable.ArrayName          = this->GetScalarArrayName( i );
+    variable.NumberOfComponents = 1;
+    variable.Components[0]      = component;
+    }
+  for ( i = 0; i < this->GetNumberOfVectorArrays(); i ++ )
+    {
+    vtkDataArray * array = inDataAttrs->GetArray( this->GetVectorArrayName( i ) );
+    int * components = this->GetSelectedVectorComponents( i );
+    if ( !array || !vtkPVArrayCalculatorIsSupported( array->GetDataType() ) ||
+         compiler.Variables.count( this->GetVectorVariableName( i ) ) )
+      {
+      return 0;
+      }
+    vtkPVArrayCalculatorCompiler::Variable & variable =
+      compiler.Variables[this->GetVectorVariableName( i )];
+    variable.ArrayName          = this->GetVectorArrayName( i );
+    variable.NumberOfComponents = 3;
+    for ( j = 0; j < 3; j ++ )
+      {
+      if ( components[j] >= array->GetNumberOfComponents() )
+        {
+        return 0;
+        }
+      variable.Components[j] = components[j];
+      }
+    }
+
+  // Coordinates only have values for point data.
+  bool pointData = inDataAttrs == input->GetPointData();
+  for ( i = 0; i < 3 && pointData; i ++ )
+    {
+    vtkPVArrayCalculatorCompiler::Variable & variable =
+      compiler.Variables[CoordinateScalarNames[i]];
+    variable.NumberOfComponents = 1;
+    variable.Components[0]      = i;
+    }
+  if ( pointData )
+    {
+    vtkPVArrayCalculatorCompiler::Variable & variable =
+      compiler.Variables[CoordinateVectorName];
+    variable.NumberOfComponents = 3;
+    for ( j = 0; j < 3; j ++ )
+      {
+      variable.Components[j] = j;
+      }
+    }
+
+  vtkPVArrayCalculatorProgram program;
+  if ( !compiler.Compile( this->GetFunction(), &program ) )
+    {
+    return 0;
+    }
+
+  vtkPVArrayCalculatorWork work;
+  work.Program        = &program;
+  work.Input          = input;
+  work.NumberOfTuples = numTuples;
+  work.NumberOfBlocks = ( numTuples + BlockSize - 1 ) / BlockSize;
+  bool serial = false;
+  for ( size_t k = 0; k < program.Inputs.size(); k ++ )
+    {
+    vtkDataArray * array = NULL;
+    if ( !program.Inputs[k].ArrayName.empty() )
+      {
+      array = inDataAttrs->GetArray( program.Inputs[k].ArrayName.c_str() );
+      }
+    else if ( vtkPointSet::SafeDownCast( input ) &&
+              vtkPointSet::SafeDownCast( input )->GetPoints() )
+      {
+      array = vtkPointSet::SafeDownCast( input )->GetPoints()->GetData();
+      }
+    else
+      {
+      // Other data sets compute their points, not all of them safely from
+      // several threads.
+      serial = true;
+      }
+    work.Arrays.push_back( array );
+    }
+
+  vtkSmartPointer<vtkDataArray> result;
+  result.TakeReference(
+    vtkDataArray::CreateDataArray( this->GetResultArrayType() ) );
+  result->SetNumberOfComponents( program.NumberOfResults );
+  result->SetNumberOfTuples( numTuples );
+  work.Result = result;
+
+  // The number of threads is capped by vtkProcessModule::Initialize().
+  vtkSmartPointer<vtkMultiThreader> threader =
+    vtkSmartPointer<vtkMultiThreader>::New();
+  if ( serial || threader->GetNumberOfThreads() > work.NumberOfBlocks )
+    {
+    threader->SetNumberOfThreads(
+      serial ? 1 : static_cast<int>( work.NumberOfBlocks ) );
+    }
+  work.Failed.resize( threader->GetNumberOfThreads(), 0 );
+  threader->SetSingleMethod( vtkPVArrayCalculatorExecute, &work );
+  threader->SingleMethodExecute();
+  if ( vtkstd::find( work.Failed.begin(), work.Failed.end(), 1 )
+       != work.Failed.end() )
+    {
+    return 0;
+    }
+
+  // Same output as the superclass.
+  output->CopyStructure( input );
+  output->CopyAttributes( input );
+  vtkDataSetAttributes * outDataAttrs = pointData ?
+    static_cast<vtkDataSetAttributes *>( output->GetPointData() ) :
+    static_cast<vtkDataSetAttributes *>( output->GetCellData() );
+  result->SetName( this->GetResultArrayName() );
+  outDataAttrs->AddArray( result );
+  if ( program.NumberOfResults == 1 )
+    {
+    outDataAttrs->SetActiveScalars( this->GetResultArrayName() );
+    }
+  else
+    {
+    outDataAttrs->SetActiveVectors( this->GetResultArrayName() );
+    }
+  return 1;
+}
+
 // ----------------------------------------------------------------------------
 void vtkPVArrayCalculator::PrintSelf( ostream & os, vtkIndent indent )
 {
@@ -24,6 +24,16 @@
 //  array can either be stored in a new array or it can overwrite an 
 //  existing array.
 //
+//  Functions made of numbers, variables, + - * / ^, the dot product,
+//  iHat/jHat/kHat, mag() and the elementary functions are compiled into a
+//  sequence of typed operations that process blocks of tuples, split across
+//  the threads of a vtkMultiThreader.  Their number follows the global cap
+//  vtkProcessModule sets, which is one thread in ParaView.
+//  The compiled function is parsed in the same order as
+//  vtkFunctionParser parses it, so results are identical.  Anything else,
+//  and any tuple for which the function is not defined (division by zero,
+//  square root of a negative number...), is left to the superclass.
+//
 // .SECTION See Also
 //  vtkArrayCalculator vtkFunctionParser
 
@@ -33,6 +43,7 @@
 #include "vtkArrayCalculator.h"
 
 class vtkDataObject;
+class vtkDataSet;
 class vtkDataSetAttributes;
 
 class VTK_EXPORT vtkPVArrayCalculator : public vtkArrayCalculator
@@ -60,6 +71,17 @@ protected:
   // RequestData() only.
   void    UpdateArrayAndVariableNames( vtkDataObject        * theInputObj, 
                                        vtkDataSetAttributes * inDataAttrs );
+
+  // Description:
+  // Compile the function and evaluate it over the numTuples tuples of
+  // inDataAttrs, then fill the output like the superclass does. Returns 0,
+  // without touching the output, when the superclass must evaluate the
+  // function instead. This function should be called by RequestData() only,
+  // after UpdateArrayAndVariableNames().
+  int     RequestCompiledData( vtkDataSet           * input,
+                               vtkDataSetAttributes * inDataAttrs,
+                               vtkIdType              numTuples,
+                               vtkDataSet           * output );
 private:
   vtkPVArrayCalculator( const vtkPVArrayCalculator & ); // Not implemented.
   void operator = ( const vtkPVArrayCalculator & );     // Not implemented.
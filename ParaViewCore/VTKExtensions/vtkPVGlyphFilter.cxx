@@ -28,6 +28,7 @@
 #include "vtkMultiProcessController.h"
 #include "vtkObjectFactory.h"
 #include "vtkPolyData.h"
+#include "vtkPVThreadedGlypher.h"
 #include "vtkUniformGrid.h"
 
 #include <stdlib.h>
@@ -55,6 +56,8 @@ vtkPVGlyphFilter::vtkPVGlyphFilter() :
   this->BlockPointCounter = 0;
   this->BlockNumGlyphedPts = 0;
   this->BlockGlyphAllPoints = 0;
+
+  this->Glypher = vtkPVThreadedGlypher::New();
 }
 
 //-----------------------------------------------------------------------------
@@ -64,6 +67,7 @@ vtkPVGlyphFilter::~vtkPVGlyphFilter()
     {
     this->MaskPoints->Delete();
     }
+  this->Glypher->Delete();
 }
 
 //-----------------------------------------------------------------------------
@@ -193,9 +197,18 @@ int vtkPVGlyphFilter::RequestData(
   // Glyph everything? 
   if (!this->UseMaskPoints)
     {
-    // yes.
-    int retVal
-      = this->Superclass::RequestData(request, inputVector, outputVector);
+    // yes. Large inputs are glyphed in chunks on several threads.
+    int retVal;
+    if (this->Glypher->GetNumberOfChunks(dsInput->GetNumberOfPoints()) > 1)
+      {
+      retVal = this->Glypher->Glyph(this, dsInput,
+        vtkPolyData::GetData(outputVector, 0));
+      }
+    else
+      {
+      retVal
+        = this->Superclass::RequestData(request, inputVector, outputVector);
+      }
     this->BlockGlyphAllPoints= !this->UseMaskPoints;
     return retVal;
     }
@@ -16,6 +16,9 @@
 //
 // .SECTION Description
 // This is a subclass of vtkGlyph3D that allows selection of input scalars
+//
+// When all the points are glyphed, large inputs are split into chunks
+// glyphed on several threads with vtkPVThreadedGlypher.
 
 #ifndef __vtkPVGlyphFilter_h
 #define __vtkPVGlyphFilter_h
@@ -23,6 +26,7 @@
 #include "vtkGlyph3D.h"
 
 class vtkMaskPoints;
+class vtkPVThreadedGlypher;
 
 class VTK_EXPORT vtkPVGlyphFilter : public vtkGlyph3D
 {
@@ -83,6 +87,7 @@ protected:
  void CalculatePtsToGlyph(double PtsNotBlanked);
 
   vtkMaskPoints *MaskPoints;
+  vtkPVThreadedGlypher *Glypher;
   int MaximumNumberOfPoints;
   int NumberOfProcesses;
   int UseMaskPoints;
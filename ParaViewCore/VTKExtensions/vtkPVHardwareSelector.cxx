@@ -22,6 +22,9 @@ vtkStandardNewMacro(vtkPVHardwareSelector);
 //----------------------------------------------------------------------------
 vtkPVHardwareSelector::vtkPVHardwareSelector()
 {
+  this->CapturedArea[0] = this->CapturedArea[1] = 0;
+  this->CapturedArea[2] = this->CapturedArea[3] = -1;
+  this->CaptureRegionOnly = false;
 }
 
 //----------------------------------------------------------------------------
@@ -32,18 +35,30 @@ vtkPVHardwareSelector::~vtkPVHardwareSelector()
 //----------------------------------------------------------------------------
 vtkSelection* vtkPVHardwareSelector::Select(int region[4])
 {
-  if (this->NeedToRenderForSelection())
+  int area[4];
+  this->GetCaptureArea(region, area);
+  return this->Select(region, this->NeedToRenderForSelection(region), area);
+}
+
+//----------------------------------------------------------------------------
+vtkSelection* vtkPVHardwareSelector::Select(int region[4], bool capture,
+  int area[4])
+{
+  if (capture)
     {
-    int* size = this->Renderer->GetSize();
-    int* origin = this->Renderer->GetOrigin();
-    this->SetArea(origin[0], origin[1], origin[0]+size[0]-1,
-      origin[1]+size[1]-1);
-    if (this->CaptureBuffers() == false)
+    this->SetArea(area[0], area[1], area[2], area[3]);
+    bool captured = this->CaptureBuffers();
+    this->CaptureTime.Modified();
+    if (captured == false)
       {
-      this->CaptureTime.Modified();
+      this->CapturedArea[0] = this->CapturedArea[1] = 0;
+      this->CapturedArea[2] = this->CapturedArea[3] = -1;
       return NULL;
       }
-    this->CaptureTime.Modified();
+    for (int cc=0; cc < 4; cc++)
+      {
+      this->CapturedArea[cc] = area[cc];
+      }
     }
 
   return this->GenerateSelection(region[0], region[1], region[2], region[3]);
@@ -58,8 +73,50 @@ bool vtkPVHardwareSelector::NeedToRenderForSelection()
   return this->CaptureTime < this->GetMTime();
 }
 
+//----------------------------------------------------------------------------
+bool vtkPVHardwareSelector::NeedToRenderForSelection(int region[4])
+{
+  if (this->NeedToRenderForSelection())
+    {
+    return true;
+    }
+
+  int area[4];
+  this->GetCaptureArea(region, area);
+  return (area[0] < this->CapturedArea[0] || area[1] < this->CapturedArea[1] ||
+    area[2] > this->CapturedArea[2] || area[3] > this->CapturedArea[3]);
+}
+
+//----------------------------------------------------------------------------
+void vtkPVHardwareSelector::GetCaptureArea(int region[4], int area[4])
+{
+  int* size = this->Renderer->GetSize();
+  int* origin = this->Renderer->GetOrigin();
+  int viewport[4] = { origin[0], origin[1],
+    origin[0]+size[0]-1, origin[1]+size[1]-1 };
+  if (!this->CaptureRegionOnly)
+    {
+    for (int cc=0; cc < 4; cc++)
+      {
+      area[cc] = viewport[cc];
+      }
+    return;
+    }
+
+  // The region may be given with its corners in any order.
+  area[0] = region[0] < region[2]? region[0] : region[2];
+  area[1] = region[1] < region[3]? region[1] : region[3];
+  area[2] = region[0] < region[2]? region[2] : region[0];
+  area[3] = region[1] < region[3]? region[3] : region[1];
+  area[0] = area[0] < viewport[0]? viewport[0] : area[0];
+  area[1] = area[1] < viewport[1]? viewport[1] : area[1];
+  area[2] = area[2] > viewport[2]? viewport[2] : area[2];
+  area[3] = area[3] > viewport[3]? viewport[3] : area[3];
+}
+
 //----------------------------------------------------------------------------
 void vtkPVHardwareSelector::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os, indent);
+  os << indent << "CaptureRegionOnly: " << this->CaptureRegionOnly << endl;
 }
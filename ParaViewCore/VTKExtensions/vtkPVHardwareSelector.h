@@ -21,6 +21,8 @@
 // This class does not know, however, when the cached buffers are invalid.
 // External logic must explicitly calls InvalidateCachedSelection() to ensure
 // that the cache is not reused.
+// With CaptureRegionOnly on, only the requested region is captured, and the
+// buffers are reused as long as later regions fall inside it.
 
 #ifndef __vtkPVHardwareSelector_h
 #define __vtkPVHardwareSelector_h
@@ -38,11 +40,36 @@ public:
   // Overridden to avoid clearing of captured buffers.
   vtkSelection* Select(int region[4]);
 
+  // Description:
+  // Like Select(), but the caller decides whether the buffers are captured
+  // again, and for what area, so that all the processes can use the decision
+  // of one of them. See NeedToRenderForSelection() and GetCaptureArea().
+  vtkSelection* Select(int region[4], bool capture, int area[4]);
+
   // Description:
   // Returns true when the next call to Select() will result in renders to
   // capture the selection-buffers.
   virtual bool NeedToRenderForSelection();
 
+  // Description:
+  // Returns true when the next call to Select() with the given region will
+  // result in renders, i.e. when the cache is invalid or the region is not
+  // inside the captured area.
+  virtual bool NeedToRenderForSelection(int region[4]);
+
+  // Description:
+  // When on, Select() only captures the requested region, which is cheaper
+  // to render and composite. When off, the whole viewport is captured so that
+  // any later selection can reuse the buffers. Off by default.
+  vtkSetMacro(CaptureRegionOnly, bool);
+  vtkGetMacro(CaptureRegionOnly, bool);
+  vtkBooleanMacro(CaptureRegionOnly, bool);
+
+  // Description:
+  // Computes the area Select() captures for the region: the region, or the
+  // whole viewport when CaptureRegionOnly is off, clipped to the viewport.
+  void GetCaptureArea(int region[4], int area[4]);
+
   // Description:
   // Called to invalidate the cache.
   void InvalidateCachedSelection()
@@ -53,6 +80,8 @@ protected:
   ~vtkPVHardwareSelector();
 
   vtkTimeStamp CaptureTime;
+  int CapturedArea[4];
+  bool CaptureRegionOnly;
 private:
   vtkPVHardwareSelector(const vtkPVHardwareSelector&); // Not implemented
   void operator=(const vtkPVHardwareSelector&); // Not implemented
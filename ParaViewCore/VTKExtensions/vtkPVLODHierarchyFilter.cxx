@@ -0,0 +1,578 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    vtkPVLODHierarchyFilter.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkPVLODHierarchyFilter.h"
+
+#include "vtkCacheSizeKeeper.h"
+#include "vtkCompositeDataIterator.h"
+#include "vtkInformation.h"
+#include "vtkInformationVector.h"
+#include "vtkMultiBlockDataSet.h"
+#include "vtkMutexLock.h"
+#include "vtkObjectFactory.h"
+#include "vtkPolyData.h"
+#include "vtkQuadricClustering.h"
+#include "vtkSmartPointer.h"
+
+#include <vtkstd/algorithm>
+#include <vtkstd/map>
+#include <vtkstd/vector>
+
+//----------------------------------------------------------------------------
+// The levels of detail of every block of one input.
+class vtkPVLODHierarchyFilter::vtkHierarchy
+{
+public:
+  vtkHierarchy() : NumberOfLevels(0), MinimumNumberOfDivisions(0) {}
+
+  void Clear()
+    {
+    this->Blocks.clear();
+    this->MTimes.clear();
+    this->Levels.clear();
+    this->Divisions.clear();
+    this->NumberOfLevels = 0;
+    this->MinimumNumberOfDivisions = 0;
+    }
+
+  unsigned long GetActualMemorySize()
+    {
+    unsigned long size = 0;
+    for (size_t i = 0; i < this->Levels.size(); ++i)
+      {
+      for (size_t j = 0; j < this->Levels[i].size(); ++j)
+        {
+        if (this->Levels[i][j])
+          {
+          size += this->Levels[i][j]->GetActualMemorySize();
+          }
+        }
+      }
+    return size;
+    }
+
+  // Leaves of the input in iteration order, with their MTimes when the
+  // hierarchy was built.
+  vtkstd::vector<vtkSmartPointer<vtkDataObject> > Blocks;
+  vtkstd::vector<unsigned long> MTimes;
+
+  // Levels[block][level], empty for blocks that are not polydata.
+  vtkstd::vector<vtkstd::vector<vtkSmartPointer<vtkPolyData> > > Levels;
+
+  // Number of divisions of each level, the coarsest first.
+  vtkstd::vector<int> Divisions;
+
+  int NumberOfLevels;
+  int MinimumNumberOfDivisions;
+};
+
+//----------------------------------------------------------------------------
+// The decimators building a hierarchy. They are created, read and deleted
+// by the thread of the filter, and may be updated by another one in between.
+class vtkPVLODHierarchyFilter::vtkBuild
+{
+public:
+  vtkBuild() : Cancelled(false)
+    {
+    this->Lock = vtkSmartPointer<vtkMutexLock>::New();
+    }
+
+  ~vtkBuild()
+    {
+    this->DeleteDecimators();
+    }
+
+  // Ask the threads running the decimators to stop after the block they are
+  // decimating. The levels are then incomplete and must not be used.
+  void Cancel()
+    {
+    this->Lock->Lock();
+    this->Cancelled = true;
+    this->Lock->Unlock();
+    }
+
+  bool IsCancelled()
+    {
+    this->Lock->Lock();
+    bool cancelled = this->Cancelled;
+    this->Lock->Unlock();
+    return cancelled;
+    }
+
+  // Move the outputs of the decimators to the hierarchy and release the
+  // decimators with their input. Does nothing the second time.
+  void Finish()
+    {
+    for (size_t i = 0; i < this->Chains.size(); ++i)
+      {
+      vtkstd::vector<vtkQuadricClustering*>& chain = this->Chains[i];
+      for (size_t level = 0; level < chain.size(); ++level)
+        {
+        vtkSmartPointer<vtkPolyData> output =
+          vtkSmartPointer<vtkPolyData>::New();
+        output->ShallowCopy(chain[level]->GetOutput());
+        this->Hierarchy.Levels[i].push_back(output);
+        }
+      }
+    this->DeleteDecimators();
+    }
+
+  void DeleteDecimators()
+    {
+    for (size_t i = 0; i < this->Chains.size(); ++i)
+      {
+      for (size_t level = 0; level < this->Chains[i].size(); ++level)
+        {
+        this->Chains[i][level]->Delete();
+        }
+      }
+    this->Chains.clear();
+    this->Coarsest.clear();
+    }
+
+  vtkPVLODHierarchyFilter::vtkHierarchy Hierarchy;
+
+  // The decimators of each block, the coarsest first. The finest decimates
+  // the block and each coarser one decimates the one above it, so updating
+  // the coarsest decimator of a chain builds all its levels.
+  vtkstd::vector<vtkstd::vector<vtkQuadricClustering*> > Chains;
+  vtkstd::vector<vtkQuadricClustering*> Coarsest;
+
+private:
+  // Guards Cancelled.
+  vtkSmartPointer<vtkMutexLock> Lock;
+  bool Cancelled;
+};
+
+//----------------------------------------------------------------------------
+class vtkPVLODHierarchyFilter::vtkInternals
+{
+public:
+  typedef vtkstd::map<double, vtkPVLODHierarchyFilter::vtkHierarchy>
+    CacheType;
+
+  // Hierarchy of the last input when it is not cached.
+  vtkPVLODHierarchyFilter::vtkHierarchy Current;
+  CacheType Cache;
+
+  // The build started by BuildInBackground(), running while ThreadId is not
+  // -1 and BackgroundDone is false.
+  vtkSmartPointer<vtkMultiThreader> Threader;
+  int ThreadId;
+  vtkPVLODHierarchyFilter::vtkBuild* Background;
+  // Guards BackgroundDone.
+  vtkSmartPointer<vtkMutexLock> Lock;
+  bool BackgroundDone;
+};
+
+namespace
+{
+  // Decimators of the blocks a thread updates.
+  struct vtkBuildLevelsJob
+  {
+    vtkPVLODHierarchyFilter::vtkBuild* Build;
+    vtkstd::vector<vtkQuadricClustering*> Coarsest;
+  };
+}
+
+vtkStandardNewMacro(vtkPVLODHierarchyFilter);
+//----------------------------------------------------------------------------
+vtkPVLODHierarchyFilter::vtkPVLODHierarchyFilter()
+{
+  this->NumberOfDivisions = 10;
+  this->NumberOfLevels = 5;
+  this->MinimumNumberOfDivisions = 10;
+  this->CachingEnabled = false;
+  this->CacheTime = 0.0;
+  this->Internals = new vtkInternals();
+  this->Internals->Threader = vtkSmartPointer<vtkMultiThreader>::New();
+  this->Internals->ThreadId = -1;
+  this->Internals->Background = 0;
+  this->Internals->Lock = vtkSmartPointer<vtkMutexLock>::New();
+  this->Internals->BackgroundDone = false;
+}
+
+//----------------------------------------------------------------------------
+vtkPVLODHierarchyFilter::~vtkPVLODHierarchyFilter()
+{
+  delete this->FinishBackgroundBuild(0);
+  this->RemoveAllCaches();
+  delete this->Internals;
+  this->Internals = 0;
+}
+
+//----------------------------------------------------------------------------
+void vtkPVLODHierarchyFilter::RemoveAllCaches()
+{
+  unsigned long freed_size = 0;
+  vtkInternals::CacheType::iterator iter;
+  for (iter = this->Internals->Cache.begin();
+    iter != this->Internals->Cache.end(); ++iter)
+    {
+    freed_size += iter->second.GetActualMemorySize();
+    }
+  this->Internals->Cache.clear();
+  if (freed_size > 0)
+    {
+    vtkCacheSizeKeeper::GetInstance()->FreeCacheSize(freed_size);
+    }
+
+  // like vtkPVCacheKeeper, this method should never mark the filter modified.
+}
+
+//----------------------------------------------------------------------------
+vtkPVLODHierarchyFilter::vtkHierarchy* vtkPVLODHierarchyFilter::GetHierarchy()
+{
+  if (this->CachingEnabled)
+    {
+    vtkInternals::CacheType::iterator iter =
+      this->Internals->Cache.find(this->CacheTime);
+    if (iter != this->Internals->Cache.end())
+      {
+      return &iter->second;
+      }
+    }
+  return &this->Internals->Current;
+}
+
+//----------------------------------------------------------------------------
+bool vtkPVLODHierarchyFilter::IsValid(vtkHierarchy* hierarchy,
+  vtkMultiBlockDataSet* input)
+{
+  if (hierarchy->NumberOfLevels != this->NumberOfLevels ||
+    hierarchy->MinimumNumberOfDivisions != this->MinimumNumberOfDivisions ||
+    hierarchy->Divisions.empty() ||
+    hierarchy->Divisions.back() < this->NumberOfDivisions)
+    {
+    return false;
+    }
+
+  size_t index = 0;
+  vtkCompositeDataIterator* iter = input->NewIterator();
+  for (iter->InitTraversal(); !iter->IsDoneWithTraversal();
+    iter->GoToNextItem(), ++index)
+    {
+    vtkDataObject* block = iter->GetCurrentDataObject();
+    if (index >= hierarchy->Blocks.size() ||
+      hierarchy->Blocks[index] != block ||
+      hierarchy->MTimes[index] != block->GetMTime())
+      {
+      iter->Delete();
+      return false;
+      }
+    }
+  iter->Delete();
+  return index == hierarchy->Blocks.size();
+}
+
+//----------------------------------------------------------------------------
+void vtkPVLODHierarchyFilter::PrepareBuild(vtkBuild* build,
+  vtkMultiBlockDataSet* input, bool copyInput)
+{
+  vtkHierarchy* hierarchy = &build->Hierarchy;
+  hierarchy->Clear();
+  hierarchy->NumberOfLevels = this->NumberOfLevels;
+  hierarchy->MinimumNumberOfDivisions = this->MinimumNumberOfDivisions;
+
+  // Nothing finer than asked for is built.
+  vtkstd::vector<int>& divisions = hierarchy->Divisions;
+  divisions.push_back(this->NumberOfDivisions);
+  while (static_cast<int>(divisions.size()) < this->NumberOfLevels &&
+    divisions.back() / 2 >= this->MinimumNumberOfDivisions)
+    {
+    divisions.push_back(divisions.back() / 2);
+    }
+  vtkstd::reverse(divisions.begin(), divisions.end());
+  int numberOfLevels = static_cast<int>(divisions.size());
+
+  vtkCompositeDataIterator* iter = input->NewIterator();
+  for (iter->InitTraversal(); !iter->IsDoneWithTraversal();
+    iter->GoToNextItem())
+    {
+    vtkDataObject* block = iter->GetCurrentDataObject();
+    hierarchy->Blocks.push_back(block);
+    hierarchy->MTimes.push_back(block->GetMTime());
+    hierarchy->Levels.push_back(
+      vtkstd::vector<vtkSmartPointer<vtkPolyData> >());
+    build->Chains.push_back(vtkstd::vector<vtkQuadricClustering*>());
+
+    vtkPolyData* pd = vtkPolyData::SafeDownCast(block);
+    if (!pd || pd->GetNumberOfCells() == 0)
+      {
+      continue;
+      }
+    vtkSmartPointer<vtkPolyData> source = pd;
+    if (copyInput)
+      {
+      source = vtkSmartPointer<vtkPolyData>::New();
+      source->DeepCopy(pd);
+      }
+
+    vtkstd::vector<vtkQuadricClustering*>& chain = build->Chains.back();
+    chain.resize(numberOfLevels);
+    for (int level = numberOfLevels - 1; level >= 0; --level)
+      {
+      vtkQuadricClustering* decimator = vtkQuadricClustering::New();
+      decimator->SetUseInputPoints(1);
+      decimator->SetCopyCellData(1);
+      decimator->SetUseInternalTriangles(0);
+      decimator->SetNumberOfDivisions(
+        divisions[level], divisions[level], divisions[level]);
+      if (level == numberOfLevels - 1)
+        {
+        decimator->SetInput(source);
+        }
+      else
+        {
+        decimator->SetInputConnection(chain[level + 1]->GetOutputPort());
+        }
+      chain[level] = decimator;
+      }
+    build->Coarsest.push_back(chain[0]);
+    }
+  iter->Delete();
+}
+
+//----------------------------------------------------------------------------
+void vtkPVLODHierarchyFilter::ExecuteBuild(vtkBuild* build)
+{
+  vtkstd::vector<vtkQuadricClustering*>& coarsest = build->Coarsest;
+  int numberOfChains = static_cast<int>(coarsest.size());
+  vtkSmartPointer<vtkMultiThreader> threader
+    = vtkSmartPointer<vtkMultiThreader>::New();
+  int numberOfWorkers = threader->GetNumberOfThreads();
+  if (numberOfWorkers > numberOfChains)
+    {
+    numberOfWorkers = numberOfChains;
+    }
+  if (numberOfWorkers <= 1)
+    {
+    for (size_t i = 0; i < coarsest.size() && !build->IsCancelled(); ++i)
+      {
+      coarsest[i]->Update();
+      }
+    return;
+    }
+
+  // Give each worker a contiguous range of blocks.
+  vtkstd::vector<vtkBuildLevelsJob> jobs(numberOfWorkers);
+  vtkstd::vector<vtkBuildLevelsJob*> jobPointers(numberOfWorkers);
+  for (int i = 0; i < numberOfWorkers; ++i)
+    {
+    int begin = (numberOfChains * i) / numberOfWorkers;
+    int end = (numberOfChains * (i + 1)) / numberOfWorkers;
+    jobs[i].Build = build;
+    jobs[i].Coarsest.assign(coarsest.begin() + begin, coarsest.begin() + end);
+    jobPointers[i] = &jobs[i];
+    }
+  threader->SetNumberOfThreads(numberOfWorkers);
+  threader->SetSingleMethod(vtkPVLODHierarchyFilter::BuildLevelsThread,
+    &jobPointers[0]);
+  threader->SingleMethodExecute();
+}
+
+//----------------------------------------------------------------------------
+VTK_THREAD_RETURN_TYPE vtkPVLODHierarchyFilter::BuildLevelsThread(void* arg)
+{
+  vtkMultiThreader::ThreadInfo* info
+    = static_cast<vtkMultiThreader::ThreadInfo*>(arg);
+  vtkBuildLevelsJob* job
+    = static_cast<vtkBuildLevelsJob**>(info->UserData)[info->ThreadID];
+  for (size_t i = 0; i < job->Coarsest.size() && !job->Build->IsCancelled();
+    ++i)
+    {
+    job->Coarsest[i]->Update();
+    }
+  return VTK_THREAD_RETURN_VALUE;
+}
+
+//----------------------------------------------------------------------------
+void vtkPVLODHierarchyFilter::BuildInBackground()
+{
+  vtkMultiBlockDataSet* input =
+    vtkMultiBlockDataSet::SafeDownCast(this->GetInputDataObject(0, 0));
+  if (!input)
+    {
+    return;
+    }
+
+  vtkInternals* internals = this->Internals;
+  if (internals->ThreadId != -1 &&
+    this->IsValid(&internals->Background->Hierarchy, input))
+    {
+    internals->Lock->Lock();
+    bool done = internals->BackgroundDone;
+    internals->Lock->Unlock();
+    if (!done)
+      {
+      // Do not wait for it, the next update will if it needs to.
+      return;
+      }
+    }
+  // A build for another input or a coarser resolution is stopped.
+  vtkBuild* build = this->FinishBackgroundBuild(input);
+  if (build)
+    {
+    // Keep the levels for the next update, not the copies they came from.
+    build->Finish();
+    internals->Background = build;
+    return;
+    }
+  if (this->IsValid(this->GetHierarchy(), input))
+    {
+    return;
+    }
+
+  // The decimators get copies of the blocks: the input is rendered and its
+  // reference counts changed while they run.
+  internals->Background = new vtkBuild();
+  this->PrepareBuild(internals->Background, input, true);
+  internals->BackgroundDone = false;
+  internals->ThreadId = internals->Threader->SpawnThread(
+    vtkPVLODHierarchyFilter::BuildInBackgroundThread, internals);
+  if (internals->ThreadId == -1)
+    {
+    // Leave it to the next update.
+    delete internals->Background;
+    internals->Background = 0;
+    }
+}
+
+//----------------------------------------------------------------------------
+VTK_THREAD_RETURN_TYPE vtkPVLODHierarchyFilter::BuildInBackgroundThread(
+  void* arg)
+{
+  vtkMultiThreader::ThreadInfo* info
+    = static_cast<vtkMultiThreader::ThreadInfo*>(arg);
+  vtkInternals* internals = static_cast<vtkInternals*>(info->UserData);
+  vtkPVLODHierarchyFilter::ExecuteBuild(internals->Background);
+  internals->Lock->Lock();
+  internals->BackgroundDone = true;
+  internals->Lock->Unlock();
+  return VTK_THREAD_RETURN_VALUE;
+}
+
+//----------------------------------------------------------------------------
+vtkPVLODHierarchyFilter::vtkBuild*
+vtkPVLODHierarchyFilter::FinishBackgroundBuild(vtkMultiBlockDataSet* input)
+{
+  vtkInternals* internals = this->Internals;
+  vtkBuild* build = internals->Background;
+  internals->Background = 0;
+  bool valid = build && input && this->IsValid(&build->Hierarchy, input);
+  if (build && !valid)
+    {
+    build->Cancel();
+    }
+  if (internals->ThreadId != -1)
+    {
+    internals->Threader->TerminateThread(internals->ThreadId);
+    internals->ThreadId = -1;
+    }
+  if (!valid)
+    {
+    delete build;
+    return 0;
+    }
+  return build;
+}
+
+//----------------------------------------------------------------------------
+int vtkPVLODHierarchyFilter::RequestData(vtkInformation*,
+  vtkInformationVector** inputVector, vtkInformationVector* outputVector)
+{
+  vtkMultiBlockDataSet* input = vtkMultiBlockDataSet::GetData(inputVector[0], 0);
+  vtkMultiBlockDataSet* output = vtkMultiBlockDataSet::GetData(outputVector, 0);
+  if (!input || !output)
+    {
+    return 0;
+    }
+
+  vtkHierarchy* hierarchy = this->GetHierarchy();
+  if (!this->IsValid(hierarchy, input))
+    {
+    bool cached = (hierarchy != &this->Internals->Current);
+    if (cached)
+      {
+      vtkCacheSizeKeeper::GetInstance()->FreeCacheSize(
+        hierarchy->GetActualMemorySize());
+      }
+
+    vtkBuild* build = this->FinishBackgroundBuild(input);
+    if (!build)
+      {
+      build = new vtkBuild();
+      this->PrepareBuild(build, input, false);
+      vtkPVLODHierarchyFilter::ExecuteBuild(build);
+      }
+    build->Finish();
+    *hierarchy = build->Hierarchy;
+    delete build;
+
+    if (this->CachingEnabled && !cached &&
+      !vtkCacheSizeKeeper::GetInstance()->GetCacheFull())
+      {
+      vtkHierarchy& entry = this->Internals->Cache[this->CacheTime];
+      entry = *hierarchy;
+      this->Internals->Current.Clear();
+      hierarchy = &entry;
+      cached = true;
+      }
+    if (cached)
+      {
+      vtkCacheSizeKeeper::GetInstance()->AddCacheSize(
+        hierarchy->GetActualMemorySize());
+      }
+    }
+
+  // The finest level with at most NumberOfDivisions divisions.
+  int level = 0;
+  while (level + 1 < static_cast<int>(hierarchy->Divisions.size()) &&
+    hierarchy->Divisions[level + 1] <= this->NumberOfDivisions)
+    {
+    level++;
+    }
+
+  output->CopyStructure(input);
+  size_t index = 0;
+  vtkCompositeDataIterator* iter = input->NewIterator();
+  for (iter->InitTraversal(); !iter->IsDoneWithTraversal();
+    iter->GoToNextItem(), ++index)
+    {
+    vtkstd::vector<vtkSmartPointer<vtkPolyData> >& levels =
+      hierarchy->Levels[index];
+    if (levels.size() > 0)
+      {
+      output->SetDataSet(iter, levels[level]);
+      }
+    else
+      {
+      output->SetDataSet(iter, iter->GetCurrentDataObject());
+      }
+    }
+  iter->Delete();
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+void vtkPVLODHierarchyFilter::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "NumberOfDivisions: " << this->NumberOfDivisions << endl;
+  os << indent << "NumberOfLevels: " << this->NumberOfLevels << endl;
+  os << indent << "MinimumNumberOfDivisions: "
+     << this->MinimumNumberOfDivisions << endl;
+  os << indent << "CachingEnabled: " << this->CachingEnabled << endl;
+  os << indent << "CacheTime: " << this->CacheTime << endl;
+}
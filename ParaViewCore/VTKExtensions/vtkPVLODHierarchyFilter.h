@@ -0,0 +1,145 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    vtkPVLODHierarchyFilter.h
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME vtkPVLODHierarchyFilter - decimates polydata at several resolutions.
+// .SECTION Description
+// vtkPVLODHierarchyFilter builds levels of detail of the polydata blocks of
+// its input with vtkQuadricClustering. The finest level uses
+// NumberOfDivisions divisions along each axis and decimates the input, so it
+// is what vtkQuadricClustering alone gives. Each coarser level halves the
+// number of divisions, down to MinimumNumberOfDivisions, and decimates the
+// level above it, so building them all costs little more than building the
+// finest. Asking for fewer divisions afterwards only selects a coarser level;
+// asking for more builds the levels again.
+//
+// BuildInBackground() starts building the levels of the current input in a
+// separate thread, so that they are usually ready when the output is first
+// needed. The blocks of an input are decimated in parallel with
+// vtkMultiThreader. Like vtkPVCacheKeeper, the filter can keep the levels of
+// several time steps for flip book animations. These are reported to the
+// vtkCacheSizeKeeper.
+// .SECTION See Also
+// vtkQuadricClustering vtkPVCacheKeeper
+
+#ifndef __vtkPVLODHierarchyFilter_h
+#define __vtkPVLODHierarchyFilter_h
+
+#include "vtkMultiBlockDataSetAlgorithm.h"
+#include "vtkMultiThreader.h" // needed for VTK_THREAD_RETURN_TYPE
+
+class VTK_EXPORT vtkPVLODHierarchyFilter : public vtkMultiBlockDataSetAlgorithm
+{
+public:
+  static vtkPVLODHierarchyFilter* New();
+  vtkTypeMacro(vtkPVLODHierarchyFilter, vtkMultiBlockDataSetAlgorithm);
+  void PrintSelf(ostream& os, vtkIndent indent);
+
+  // Description:
+  // Number of divisions along each axis asked for. The output is the finest
+  // level with at most that many divisions, or the coarsest level if none has
+  // so few. 10 by default.
+  vtkSetClampMacro(NumberOfDivisions, int, 2, VTK_LARGE_INTEGER);
+  vtkGetMacro(NumberOfDivisions, int);
+
+  // Description:
+  // Largest number of levels of detail. 5 by default.
+  vtkSetClampMacro(NumberOfLevels, int, 1, 10);
+  vtkGetMacro(NumberOfLevels, int);
+
+  // Description:
+  // No level coarser than the finest one has fewer divisions along each axis.
+  // 10 by default.
+  vtkSetClampMacro(MinimumNumberOfDivisions, int, 2, VTK_LARGE_INTEGER);
+  vtkGetMacro(MinimumNumberOfDivisions, int);
+
+  // Description:
+  // Start building the levels of the current input in a separate thread,
+  // unless they are already built or being built. The input must be up to
+  // date. A background build started for another input, or for fewer
+  // divisions, is stopped and discarded. The next update waits for the
+  // thread instead of building the levels itself.
+  void BuildInBackground();
+
+  // Description:
+  // Get/Set if the levels of each CacheTime are kept. Default is false.
+  vtkSetMacro(CachingEnabled, bool);
+  vtkGetMacro(CachingEnabled, bool);
+  vtkBooleanMacro(CachingEnabled, bool);
+
+  // Description:
+  // Set/Get the current cache time.
+  vtkSetMacro(CacheTime, double);
+  vtkGetMacro(CacheTime, double);
+
+  // Description:
+  // Removes the levels kept for all the cache times.
+  void RemoveAllCaches();
+
+//BTX
+protected:
+  vtkPVLODHierarchyFilter();
+  ~vtkPVLODHierarchyFilter();
+
+  virtual int RequestData(vtkInformation*,
+    vtkInformationVector**, vtkInformationVector*);
+
+  class vtkHierarchy;
+  class vtkBuild;
+
+  // Description:
+  // Returns the hierarchy of the current cache time, or the uncached one.
+  vtkHierarchy* GetHierarchy();
+
+  // Description:
+  // Returns true if the hierarchy was built from the given blocks with the
+  // current parameters and has a level as fine as NumberOfDivisions.
+  bool IsValid(vtkHierarchy* hierarchy, vtkMultiBlockDataSet* input);
+
+  // Description:
+  // Set up the decimators of all the blocks of the input. With copyInput,
+  // they decimate copies of the blocks so that they can run while the input
+  // is used elsewhere.
+  void PrepareBuild(vtkBuild* build, vtkMultiBlockDataSet* input,
+                    bool copyInput);
+
+  // Description:
+  // Run the decimators of a build until they are done or the build is
+  // cancelled. Only touches objects of the build.
+  static void ExecuteBuild(vtkBuild* build);
+
+  // Description:
+  // Wait for the background build, if any, and return it if it is valid for
+  // the given input. Otherwise it is cancelled before waiting, deleted, and
+  // NULL is returned. The caller owns the result.
+  vtkBuild* FinishBackgroundBuild(vtkMultiBlockDataSet* input);
+
+  static VTK_THREAD_RETURN_TYPE BuildLevelsThread(void* arg);
+  static VTK_THREAD_RETURN_TYPE BuildInBackgroundThread(void* arg);
+
+  int NumberOfDivisions;
+  int NumberOfLevels;
+  int MinimumNumberOfDivisions;
+  bool CachingEnabled;
+  double CacheTime;
+
+private:
+  vtkPVLODHierarchyFilter(const vtkPVLODHierarchyFilter&); // Not implemented
+  void operator=(const vtkPVLODHierarchyFilter&); // Not implemented
+
+  class vtkInternals;
+  vtkInternals* Internals;
+//ETX
+};
+
+#endif
@@ -0,0 +1,500 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    vtkPVThreadedGlypher.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkPVThreadedGlypher.h"
+
+#include "vtkCellArray.h"
+#include "vtkCellData.h"
+#include "vtkDataSet.h"
+#include "vtkGlyph3D.h"
+#include "vtkIdTypeArray.h"
+#include "vtkInformation.h"
+#include "vtkMultiThreader.h"
+#include "vtkObjectFactory.h"
+#include "vtkPointData.h"
+#include "vtkPointSet.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkSmartPointer.h"
+#include "vtkTransform.h"
+
+#include <vtkstd/vector>
+#include <string.h>
+
+namespace
+{
+  // Verts, lines, polys and strips, in the order of the cell ids.
+  const int NUMBER_OF_CELL_ARRAYS = 4;
+
+  vtkCellArray* GetCellArray(vtkPolyData* pd, int type)
+    {
+    switch (type)
+      {
+    case 0:
+      return pd->GetVerts();
+    case 1:
+      return pd->GetLines();
+    case 2:
+      return pd->GetPolys();
+    default:
+      return pd->GetStrips();
+      }
+    }
+
+  void SetCellArray(vtkPolyData* pd, int type, vtkCellArray* cells)
+    {
+    switch (type)
+      {
+    case 0:
+      pd->SetVerts(cells);
+      break;
+    case 1:
+      pd->SetLines(cells);
+      break;
+    case 2:
+      pd->SetPolys(cells);
+      break;
+    default:
+      pd->SetStrips(cells);
+      }
+    }
+
+  // Returns true when both have the same data arrays in the same order.
+  bool SameArrays(vtkDataSetAttributes* a, vtkDataSetAttributes* b)
+    {
+    if (a->GetNumberOfArrays() != b->GetNumberOfArrays())
+      {
+      return false;
+      }
+    for (int i = 0; i < a->GetNumberOfArrays(); ++i)
+      {
+      vtkDataArray* x = a->GetArray(i);
+      vtkDataArray* y = b->GetArray(i);
+      if (!x || !y || x->GetDataType() != y->GetDataType() ||
+        x->GetNumberOfComponents() != y->GetNumberOfComponents())
+        {
+        return false;
+        }
+      const char* xname = x->GetName();
+      const char* yname = y->GetName();
+      if ((xname == 0) != (yname == 0) ||
+        (xname && strcmp(xname, yname) != 0))
+        {
+        return false;
+        }
+      }
+    return true;
+    }
+
+  // Create arrays like the ones of source, sized to the given number of
+  // tuples, with the same active attributes.
+  void AllocateArrays(vtkDataSetAttributes* source, vtkDataSetAttributes* dest,
+    vtkIdType numberOfTuples)
+    {
+    for (int i = 0; i < source->GetNumberOfArrays(); ++i)
+      {
+      vtkDataArray* from = source->GetArray(i);
+      vtkDataArray* to = from->NewInstance();
+      to->SetName(from->GetName());
+      to->SetNumberOfComponents(from->GetNumberOfComponents());
+      to->SetNumberOfTuples(numberOfTuples);
+      dest->AddArray(to);
+      to->Delete();
+      }
+    int attributes[vtkDataSetAttributes::NUM_ATTRIBUTES];
+    source->GetAttributeIndices(attributes);
+    for (int type = 0; type < vtkDataSetAttributes::NUM_ATTRIBUTES; ++type)
+      {
+      if (attributes[type] >= 0)
+        {
+        dest->SetActiveAttribute(attributes[type], type);
+        }
+      }
+    }
+
+  void CopyTuples(vtkDataSetAttributes* source, vtkIdType sourceStart,
+    vtkDataSetAttributes* dest, vtkIdType destStart, vtkIdType count)
+    {
+    for (int i = 0; i < source->GetNumberOfArrays(); ++i)
+      {
+      vtkDataArray* from = source->GetArray(i);
+      vtkDataArray* to = dest->GetArray(i);
+      int numComps = from->GetNumberOfComponents();
+      memcpy(to->GetVoidPointer(destStart * numComps),
+        from->GetVoidPointer(sourceStart * numComps),
+        count * numComps * from->GetDataTypeSize());
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+class vtkThreadedGlyphJob
+{
+public:
+  struct Chunk
+    {
+    // Range of input points.
+    vtkIdType Begin;
+    vtkIdType End;
+
+    vtkSmartPointer<vtkPolyData> Input;
+    vtkSmartPointer<vtkGlyph3D> Glyph;
+    vtkPolyData* Output;
+
+    // Where the output of the chunk goes in the assembled output.
+    vtkIdType PointOffset;
+    vtkIdType CellOffset[NUMBER_OF_CELL_ARRAYS];
+    vtkIdType ConnectivityOffset[NUMBER_OF_CELL_ARRAYS];
+    };
+
+  enum
+    {
+    GLYPH,
+    COPY
+    };
+
+  int Phase;
+  int NumberOfThreads;
+  vtkDataSet* Input;
+  vtkPolyData* Output;
+  vtkstd::vector<Chunk> Chunks;
+
+  // Totals of the assembled output.
+  vtkIdType NumberOfCells[NUMBER_OF_CELL_ARRAYS];
+  vtkIdType* Cells[NUMBER_OF_CELL_ARRAYS];
+  vtkIdTypeArray* PointIds;
+
+  void Glyph(Chunk& chunk);
+  void Copy(Chunk& chunk);
+
+  static VTK_THREAD_RETURN_TYPE Thread(void* arg)
+    {
+    vtkMultiThreader::ThreadInfo* info
+      = static_cast<vtkMultiThreader::ThreadInfo*>(arg);
+    vtkThreadedGlyphJob* job = static_cast<vtkThreadedGlyphJob*>(info->UserData);
+    for (size_t i = info->ThreadID; i < job->Chunks.size();
+      i += job->NumberOfThreads)
+      {
+      if (job->Phase == GLYPH)
+        {
+        job->Glyph(job->Chunks[i]);
+        }
+      else
+        {
+        job->Copy(job->Chunks[i]);
+        }
+      }
+    return VTK_THREAD_RETURN_VALUE;
+    }
+};
+
+//----------------------------------------------------------------------------
+void vtkThreadedGlyphJob::Glyph(Chunk& chunk)
+{
+  // The input of the chunk only needs the points and the point data.
+  vtkIdType numPts = chunk.End - chunk.Begin;
+  vtkPoints* points = chunk.Input->GetPoints();
+  vtkPointSet* pointSet = vtkPointSet::SafeDownCast(this->Input);
+  if (pointSet && pointSet->GetPoints() &&
+    pointSet->GetPoints()->GetDataType() == points->GetDataType())
+    {
+    memcpy(points->GetVoidPointer(0),
+      pointSet->GetPoints()->GetVoidPointer(3 * chunk.Begin),
+      3 * numPts * points->GetData()->GetDataTypeSize());
+    }
+  else
+    {
+    double x[3];
+    for (vtkIdType i = 0; i < numPts; ++i)
+      {
+      this->Input->GetPoint(chunk.Begin + i, x);
+      points->SetPoint(i, x);
+      }
+    }
+  vtkPointData* inPD = this->Input->GetPointData();
+  vtkPointData* pd = chunk.Input->GetPointData();
+  for (vtkIdType i = 0; i < numPts; ++i)
+    {
+    pd->CopyData(inPD, chunk.Begin + i, i);
+    }
+
+  chunk.Glyph->Update();
+}
+
+//----------------------------------------------------------------------------
+void vtkThreadedGlyphJob::Copy(Chunk& chunk)
+{
+  vtkPolyData* output = chunk.Output;
+  vtkIdType numPts = output->GetNumberOfPoints();
+  if (numPts == 0)
+    {
+    return;
+    }
+
+  vtkPoints* points = this->Output->GetPoints();
+  int pointSize = 3 * points->GetData()->GetDataTypeSize();
+  memcpy(points->GetVoidPointer(3 * chunk.PointOffset),
+    output->GetPoints()->GetVoidPointer(0), numPts * pointSize);
+  CopyTuples(output->GetPointData(), 0,
+    this->Output->GetPointData(), chunk.PointOffset, numPts);
+
+  // The ids of the input points are relative to the chunk.
+  if (this->PointIds)
+    {
+    vtkIdType* ids = this->PointIds->GetPointer(chunk.PointOffset);
+    for (vtkIdType i = 0; i < numPts; ++i)
+      {
+      ids[i] += chunk.Begin;
+      }
+    }
+
+  vtkIdType cellBase = 0;
+  vtkIdType chunkCellBase = 0;
+  for (int type = 0; type < NUMBER_OF_CELL_ARRAYS; ++type)
+    {
+    vtkCellArray* cells = GetCellArray(output, type);
+    vtkIdType numCells = cells->GetNumberOfCells();
+    if (numCells > 0)
+      {
+      vtkIdType size = cells->GetNumberOfConnectivityEntries();
+      vtkIdType* from = cells->GetPointer();
+      vtkIdType* to = this->Cells[type] + chunk.ConnectivityOffset[type];
+      for (vtkIdType i = 0; i < size; )
+        {
+        vtkIdType npts = from[i];
+        to[i++] = npts;
+        for (vtkIdType j = 0; j < npts; ++j, ++i)
+          {
+          to[i] = from[i] + chunk.PointOffset;
+          }
+        }
+      CopyTuples(output->GetCellData(), chunkCellBase,
+        this->Output->GetCellData(), cellBase + chunk.CellOffset[type],
+        numCells);
+      chunkCellBase += numCells;
+      }
+    cellBase += this->NumberOfCells[type];
+    }
+}
+
+vtkStandardNewMacro(vtkPVThreadedGlypher);
+//----------------------------------------------------------------------------
+vtkPVThreadedGlypher::vtkPVThreadedGlypher()
+{
+  this->MinimumNumberOfPointsPerThread = 5000;
+  this->Threader = vtkMultiThreader::New();
+}
+
+//----------------------------------------------------------------------------
+vtkPVThreadedGlypher::~vtkPVThreadedGlypher()
+{
+  this->Threader->Delete();
+}
+
+//----------------------------------------------------------------------------
+int vtkPVThreadedGlypher::GetNumberOfChunks(vtkIdType numberOfPoints)
+{
+  vtkIdType chunks = numberOfPoints / this->MinimumNumberOfPointsPerThread;
+  if (chunks > this->Threader->GetNumberOfThreads())
+    {
+    chunks = this->Threader->GetNumberOfThreads();
+    }
+  return chunks > 1? static_cast<int>(chunks) : 1;
+}
+
+//----------------------------------------------------------------------------
+void vtkPVThreadedGlypher::CopyGlyphSettings(vtkGlyph3D* from, vtkGlyph3D* to)
+{
+  to->SetScaling(from->GetScaling());
+  to->SetScaleMode(from->GetScaleMode());
+  to->SetColorMode(from->GetColorMode());
+  to->SetScaleFactor(from->GetScaleFactor());
+  to->SetRange(from->GetRange());
+  to->SetOrient(from->GetOrient());
+  to->SetClamping(from->GetClamping());
+  to->SetVectorMode(from->GetVectorMode());
+  to->SetIndexMode(from->GetIndexMode());
+  to->SetGeneratePointIds(from->GetGeneratePointIds());
+  to->SetPointIdsName(from->GetPointIdsName());
+  to->SetSourceTransform(from->GetSourceTransform());
+
+  // Scalars, vectors, normals and color scalars.
+  for (int idx = 0; idx < 4; ++idx)
+    {
+    to->SetInputArrayToProcess(idx, from->GetInputArrayInformation(idx));
+    }
+
+  // The copies get their own producers so that each glyph filter can be
+  // updated independently.
+  for (int i = 0; i < from->GetNumberOfInputConnections(1); ++i)
+    {
+    vtkPolyData* source = from->GetSource(i);
+    if (source)
+      {
+      vtkSmartPointer<vtkPolyData> copy = vtkSmartPointer<vtkPolyData>::New();
+      copy->ShallowCopy(source);
+      to->SetSource(i, copy);
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+int vtkPVThreadedGlypher::Glyph(vtkGlyph3D* glyph, vtkDataSet* input,
+  vtkPolyData* output)
+{
+  vtkIdType numPts = input->GetNumberOfPoints();
+  int numChunks = this->GetNumberOfChunks(numPts);
+
+  if (glyph->GetSourceTransform())
+    {
+    // Transforms update themselves lazily. Do it before the threads share it.
+    glyph->GetSourceTransform()->Update();
+    }
+
+  vtkThreadedGlyphJob job;
+  job.Input = input;
+  job.Output = output;
+  job.PointIds = NULL;
+  job.Chunks.resize(numChunks);
+
+  vtkPointSet* pointSet = vtkPointSet::SafeDownCast(input);
+  for (int c = 0; c < numChunks; ++c)
+    {
+    vtkThreadedGlyphJob::Chunk& chunk = job.Chunks[c];
+    chunk.Begin = (numPts * c) / numChunks;
+    chunk.End = (numPts * (c + 1)) / numChunks;
+    chunk.Input = vtkSmartPointer<vtkPolyData>::New();
+    vtkSmartPointer<vtkPoints> points = vtkSmartPointer<vtkPoints>::New();
+    if (pointSet && pointSet->GetPoints())
+      {
+      points->SetDataType(pointSet->GetPoints()->GetDataType());
+      }
+    else
+      {
+      points->SetDataTypeToDouble();
+      }
+    points->SetNumberOfPoints(chunk.End - chunk.Begin);
+    chunk.Input->SetPoints(points);
+    chunk.Input->GetPointData()->CopyAllocate(input->GetPointData(),
+      chunk.End - chunk.Begin);
+
+    chunk.Glyph = vtkSmartPointer<vtkGlyph3D>::New();
+    vtkPVThreadedGlypher::CopyGlyphSettings(glyph, chunk.Glyph);
+    chunk.Glyph->SetInput(chunk.Input);
+    chunk.Output = chunk.Glyph->GetOutput();
+    }
+
+  job.NumberOfThreads = numChunks;
+  job.Phase = vtkThreadedGlyphJob::GLYPH;
+  if (numChunks > 1)
+    {
+    this->Threader->SetNumberOfThreads(numChunks);
+    this->Threader->SetSingleMethod(vtkThreadedGlyphJob::Thread, &job);
+    this->Threader->SingleMethodExecute();
+    }
+  else
+    {
+    job.Glyph(job.Chunks[0]);
+    }
+
+  // First pass: count the output of each chunk, and prefix-sum the counts
+  // into its offsets in the output.
+  vtkPolyData* first = NULL;
+  vtkIdType totalPts = 0;
+  vtkIdType totalConnectivity[NUMBER_OF_CELL_ARRAYS];
+  for (int type = 0; type < NUMBER_OF_CELL_ARRAYS; ++type)
+    {
+    job.NumberOfCells[type] = 0;
+    job.Cells[type] = NULL;
+    totalConnectivity[type] = 0;
+    }
+  for (int c = 0; c < numChunks; ++c)
+    {
+    vtkThreadedGlyphJob::Chunk& chunk = job.Chunks[c];
+    vtkPolyData* chunkOutput = chunk.Output;
+    chunk.PointOffset = totalPts;
+    for (int type = 0; type < NUMBER_OF_CELL_ARRAYS; ++type)
+      {
+      vtkCellArray* cells = GetCellArray(chunkOutput, type);
+      chunk.CellOffset[type] = job.NumberOfCells[type];
+      chunk.ConnectivityOffset[type] = totalConnectivity[type];
+      job.NumberOfCells[type] += cells->GetNumberOfCells();
+      totalConnectivity[type] += cells->GetNumberOfConnectivityEntries();
+      }
+    if (chunkOutput->GetNumberOfPoints() == 0)
+      {
+      continue;
+      }
+    totalPts += chunkOutput->GetNumberOfPoints();
+    if (!first)
+      {
+      first = chunkOutput;
+      }
+    else if (!SameArrays(first->GetPointData(), chunkOutput->GetPointData()) ||
+      !SameArrays(first->GetCellData(), chunkOutput->GetCellData()) ||
+      first->GetPoints()->GetDataType() !=
+      chunkOutput->GetPoints()->GetDataType())
+      {
+      vtkErrorMacro("The glyphs of the chunks do not have the same arrays.");
+      return 0;
+      }
+    }
+
+  output->Initialize();
+  if (numChunks == 1 || !first)
+    {
+    output->ShallowCopy(job.Chunks[0].Output);
+    return 1;
+    }
+
+  // Allocate the output to its final size.
+  vtkIdType totalCells = 0;
+  vtkSmartPointer<vtkPoints> points = vtkSmartPointer<vtkPoints>::New();
+  points->SetDataType(first->GetPoints()->GetDataType());
+  points->SetNumberOfPoints(totalPts);
+  output->SetPoints(points);
+  for (int type = 0; type < NUMBER_OF_CELL_ARRAYS; ++type)
+    {
+    if (job.NumberOfCells[type] > 0)
+      {
+      vtkSmartPointer<vtkCellArray> cells = vtkSmartPointer<vtkCellArray>::New();
+      job.Cells[type] = cells->WritePointer(job.NumberOfCells[type],
+        totalConnectivity[type]);
+      SetCellArray(output, type, cells);
+      totalCells += job.NumberOfCells[type];
+      }
+    }
+  AllocateArrays(first->GetPointData(), output->GetPointData(), totalPts);
+  AllocateArrays(first->GetCellData(), output->GetCellData(), totalCells);
+  if (glyph->GetGeneratePointIds() && glyph->GetPointIdsName())
+    {
+    job.PointIds = vtkIdTypeArray::SafeDownCast(
+      output->GetPointData()->GetArray(glyph->GetPointIdsName()));
+    }
+
+  // Second pass: copy each chunk at its offsets.
+  job.Phase = vtkThreadedGlyphJob::COPY;
+  this->Threader->SetNumberOfThreads(numChunks);
+  this->Threader->SetSingleMethod(vtkThreadedGlyphJob::Thread, &job);
+  this->Threader->SingleMethodExecute();
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+void vtkPVThreadedGlypher::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "MinimumNumberOfPointsPerThread: "
+     << this->MinimumNumberOfPointsPerThread << endl;
+}
@@ -0,0 +1,91 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    vtkPVThreadedGlypher.h
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME vtkPVThreadedGlypher - generates the glyphs of a vtkGlyph3D on
+// several threads.
+// .SECTION Description
+// vtkPVThreadedGlypher splits the points of a dataset into contiguous
+// chunks, one per thread, and glyphs each chunk with its own copy of a
+// configured vtkGlyph3D. The outputs of the chunks are then assembled in two
+// passes. Their sizes are counted and prefix-summed into the offsets of each
+// chunk in the output, which is allocated once to its final size, and each
+// thread copies its chunk at its offsets. The output is the one of the
+// vtkGlyph3D, in the same order, whatever the number of threads.
+//
+// This trades memory for time. The outputs of the chunks are only released
+// when Glyph() returns, so at its peak the output is held twice: once in the
+// chunks and once assembled. Each chunk is glyphed by a vtkGlyph3D, whose
+// arrays still grow, and reallocate, as the glyphs are appended. Only the
+// assembly avoids the reallocations, and small inputs are better glyphed by
+// vtkGlyph3D itself (see MinimumNumberOfPointsPerThread).
+//
+// Only the settings, input arrays and sources of the vtkGlyph3D are copied.
+// Points a subclass would skip in IsPointVisible() are glyphed anyway. The
+// sources must be up to date when Glyph() is called.
+// .SECTION See Also
+// vtkGlyph3D vtkPVGlyphFilter
+
+#ifndef __vtkPVThreadedGlypher_h
+#define __vtkPVThreadedGlypher_h
+
+#include "vtkObject.h"
+
+class vtkDataSet;
+class vtkGlyph3D;
+class vtkMultiThreader;
+class vtkPolyData;
+
+class VTK_EXPORT vtkPVThreadedGlypher : public vtkObject
+{
+public:
+  static vtkPVThreadedGlypher* New();
+  vtkTypeMacro(vtkPVThreadedGlypher, vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent);
+
+  // Description:
+  // Minimum number of points glyphed by each thread. Inputs with fewer than
+  // twice as many points are glyphed on a single thread. 5000 by default.
+  vtkSetClampMacro(MinimumNumberOfPointsPerThread, vtkIdType, 1, VTK_LARGE_ID);
+  vtkGetMacro(MinimumNumberOfPointsPerThread, vtkIdType);
+
+  // Description:
+  // Number of chunks the given number of points would be glyphed in. 1
+  // means no threads would be used. There are no more chunks than
+  // vtkMultiThreader threads, which ParaView limits to one (see
+  // vtkProcessModule::Initialize()).
+  int GetNumberOfChunks(vtkIdType numberOfPoints);
+
+  // Description:
+  // Glyph all the points of input like glyph would, and store the result
+  // in output. glyph itself is not executed. Returns 0 on failure.
+  int Glyph(vtkGlyph3D* glyph, vtkDataSet* input, vtkPolyData* output);
+
+  // Description:
+  // Copy the settings, input arrays and sources of a vtkGlyph3D into
+  // another one. The sources are shallow copied.
+  static void CopyGlyphSettings(vtkGlyph3D* from, vtkGlyph3D* to);
+
+protected:
+  vtkPVThreadedGlypher();
+  ~vtkPVThreadedGlypher();
+
+  vtkIdType MinimumNumberOfPointsPerThread;
+  vtkMultiThreader* Threader;
+
+private:
+  vtkPVThreadedGlypher(const vtkPVThreadedGlypher&); // Not implemented
+  void operator=(const vtkPVThreadedGlypher&); // Not implemented
+};
+
+#endif
@@ -49,11 +49,13 @@
 #include "vtkDoubleArray.h"
 
 #include <vtkstd/algorithm>
+#include <vtkstd/functional>
 #include <vtksys/stl/map>
 #include <vtkstd/vector>
 #include <vtkstd/set>
 
 #include <float.h>
+#include <string.h>
 
 #include <vtkstd/string>
 #include <vtksys/ios/sstream>
@@ -161,221 +163,6 @@ template<class T>
 class vtkSortedTableStreamer::Internals : public InternalsBase
 {
 public:
-  class Histogram
-  {
-  public:
-    vtkIdType* Values;
-    double Delta;
-    double Min;
-    int Size;
-    vtkIdType TotalValues;
-    bool Inverted;
-
-    Histogram()
-      {
-      this->Inverted = false;
-      this->TotalValues = 0;
-      this->Size = 0;
-      this->Min = 0;
-      this->Delta = 1;
-      this->Values = 0;
-      }
-
-    Histogram(int size) : Size(size), TotalValues(0)
-      {
-      this->Min = 0;
-      this->Delta = 0;
-      this->Inverted = false;
-      this->Values = new vtkIdType[size];
-      for(int i=0; i < this->Size; ++i)
-        {
-        this->Values[i] = 0;
-        }
-      }
-
-    virtual ~Histogram()
-      {
-      if(this->Values)
-        {
-        delete[] this->Values;
-        this->Values = 0;
-        }
-      }
-
-    bool CanBeReduced()
-      {
-      return this->TotalValues != this->Values[0] && (this->Delta > 10E-5);
-      }
-
-    bool SetScalarRange(double* scalarRange)
-      {
-      this->Min = scalarRange[0];
-      this->Delta = (scalarRange[1] - scalarRange[0]) / (double)this->Size;
-      return (scalarRange[1] > scalarRange[0]);
-      }
-
-    void CopyRangeTo(Histogram& other)
-      {
-      other.Min = this->Min;
-      other.Delta = this->Delta;
-      }
-
-    void AddValue(double value)
-      {
-      int idx = vtkMath::Floor((value - this->Min) / this->Delta);
-      if (idx == this->Size)
-        {
-        --idx;
-        }
-      if(this->Inverted)
-        {
-        idx = this->Size - idx - 1;
-        }
-      if(idx >= 0 && idx < this->Size)
-        {
-        this->TotalValues++;
-        this->Values[idx]++;
-        }
-      else if(value == static_cast<T>(this->Min))
-        {
-        // Manage type troncature
-        this->TotalValues++;
-        this->Values[0]++;
-        }
-      else
-        {
-        cout << "Try to add value out of the histogran range: "
-            << value << " Range: [" << this->Min << ", "
-            << (this->Min + this->Delta*this->Size) << "]" << endl;
-        }
-      }
-
-    // Description:
-    // Find the selected bar corresponding to the nth element in the histogram.
-    // As result, we return the number of elements found before the selected bar
-    // as well as providing the scalar range and the index of that bar.
-    vtkIdType GetNewRange(vtkIdType nthElement, vtkIdType& selectedBarIdx, double* scalarRange)
-      {
-      if(nthElement >= this->TotalValues)
-        {
-        scalarRange[0] = this->Min;
-        scalarRange[1] = this->Min + this->Delta*this->Size;
-        selectedBarIdx = this->Size - 1;
-        return this->TotalValues;
-        }
-      vtkIdType nbElementsFounds = 0;
-      selectedBarIdx = 0;
-      while(nbElementsFounds + this->Values[selectedBarIdx] < nthElement)
-        {
-        nbElementsFounds += this->Values[selectedBarIdx++];
-        }
-      if(this->Inverted)
-        {
-        scalarRange[1] = this->Min + this->Delta*(this->Size - selectedBarIdx);
-        scalarRange[0] = scalarRange[1] - this->Delta;
-        }
-      else
-        {
-        scalarRange[0] = this->Min + this->Delta*selectedBarIdx;
-        scalarRange[1] = scalarRange[0] + this->Delta;
-        }
-      return nbElementsFounds;
-      }
-
-    void Merge(const Histogram& other)
-      {
-      if(this->Min != other.Min || this->Delta != other.Delta || Size != other.Size)
-        {
-        // Throw exception because not compatible histogram
-        cout << "ERROR: Histogram::Merge not compatible histogram !" << endl;
-        }
-      for(int i=0; i < this->Size; i++)
-        {
-        this->TotalValues += other.Values[i];
-        this->Values[i] += other.Values[i];
-        }
-      }
-
-    void UpdateTotalValues()
-      {
-      this->TotalValues = 0;
-      for(int i=0; i < this->Size; i++)
-        {
-        this->TotalValues += Values[i];
-        }
-      }
-
-    vtkIdType GetNumberOfElements(int lowerIndex, int upperIndex)
-      {
-      vtkIdType nbElements = 0;
-      if(lowerIndex == -1 || upperIndex == -1 || lowerIndex >= this->Size)
-        {
-        return 0;
-        }
-      upperIndex = (upperIndex > this->Size) ? this->Size : upperIndex;
-      for(int i=lowerIndex; i < upperIndex; ++i)
-        {
-        nbElements += this->Values[i];
-        }
-      return nbElements;
-      }
-
-    void Print()
-      {
-      cout << "Histo: " << endl
-          << " - NbElements: " << this->TotalValues << endl
-          << " - Min: " << this->Min << endl
-          << " - Delta: " << this->Delta << endl
-          << " - Size: " << this->Size << endl;
-      double min = this->Min;
-      for(int i=0; i < this->Size; i++)
-        {
-        if(this->Values[i] > 0)
-          {
-          cout << " - [" << min << ", ";
-          min += this->Delta;
-          cout << min << "]: " << this->Values[i] << endl;
-          }
-        else
-          {
-          min += this->Delta;
-          }
-        }
-      }
-
-    void CopyTo(Histogram& other)
-      {
-      other.Inverted = this->Inverted;
-      other.Delta = this->Delta;
-      other.Min = this->Min;
-      other.Size = this->Size;
-      other.TotalValues = this->TotalValues;
-      if(other.Values)
-        {
-        delete[] other.Values;
-        other.Values = 0;
-        }
-      other.Values = new vtkIdType[this->Size];
-      for(int i=0; i < this->Size; i++)
-        {
-        other.Values[i] = this->Values[i];
-        }
-      }
-
-    void ClearHistogramValues()
-      {
-      this->TotalValues = 0;
-      if(!this->Values)
-        {
-        this->Values = new vtkIdType[this->Size];
-        }
-      for(int i=0; i < this->Size; i++)
-        {
-        this->Values[i] = 0;
-        }
-      }
-
-  };
   class SortableArrayItem
   {
   public:
@@ -438,14 +225,13 @@ public:
   class ArraySorter
   {
   public:
-    Histogram* Histo;
     SortableArrayItem* Array;
     vtkIdType ArraySize;
 
     ArraySorter()
       {
       this->Array = 0;
-      this->Histo = 0;
+      this->ArraySize = 0;
       }
 
     ~ArraySorter()
@@ -460,11 +246,7 @@ public:
         delete[] this->Array;
         this->Array = 0;
         }
-      if( this->Histo )
-        {
-        delete this->Histo;
-        this->Histo = 0;
-        }
+      this->ArraySize = 0;
       }
     void FillArray(vtkIdType numTuples)
       {
@@ -484,8 +266,7 @@ public:
       }
 
     void Update(T* dataPtr, vtkIdType numTuples, int numComponents,
-                int selectedComponent, vtkIdType histogramSize,
-                double* scalarRange, bool reverseOrder)
+                int selectedComponent, bool reverseOrder)
       {
       // Clear memory if needed
       this->Clear();
@@ -496,9 +277,6 @@ public:
         }
 
       // Allocate memory and fill the structure
-      this->Histo = new Histogram(histogramSize);
-      this->Histo->Inverted = reverseOrder;
-      this->Histo->SetScalarRange(scalarRange);
       this->ArraySize = numTuples;
       this->Array = new SortableArrayItem[this->ArraySize];
 
@@ -506,11 +284,11 @@ public:
       for(vtkIdType i=0; i < this->ArraySize; ++i)
         {
         this->Array[i].OriginalIndex = i;
-        double value = 0;
-        double tmp;
         if(selectedComponent < 0)
           {
           // Compute magnitude
+          double value = 0;
+          double tmp;
           for(int k=0;k<numComponents;k++)
             {
             tmp = static_cast<double>(dataPtr[k + i*numComponents]);
@@ -522,33 +300,20 @@ public:
         else
           {
           this->Array[i].Value = dataPtr[selectedComponent + i*numComponents];
-          value = static_cast<double>(this->Array[i].Value);
           }
-        this->Histo->AddValue(value);
         }
 
       // Sort it
-      if(reverseOrder)
-        {
-        vtkstd::sort(this->Array, this->Array + this->ArraySize, SortableArrayItem::Ascendent);
-        }
-      else
-        {
-        vtkstd::sort(this->Array, this->Array + this->ArraySize, SortableArrayItem::Descendent);
-        }
+      this->Sort(reverseOrder);
       }
 
     void SortProcessId(vtkIdType* dataPtr, vtkIdType numTuples,
-                       vtkIdType histogramSize,
-                       double* scalarRange, bool reverseOrder)
+                       bool reverseOrder)
       {
       // Clear memory if needed
       this->Clear();
 
       // Allocate memory and fill the structure
-      this->Histo = new Histogram(histogramSize);
-      this->Histo->Inverted = reverseOrder;
-      this->Histo->SetScalarRange(scalarRange);
       this->ArraySize = numTuples;
       this->Array = new SortableArrayItem[this->ArraySize];
 
@@ -557,20 +322,177 @@ public:
         {
         this->Array[i].OriginalIndex = i;
         this->Array[i].Value = static_cast<T>(dataPtr[i]);
-        double value = static_cast<double>(this->Array[i].Value);
-        this->Histo->AddValue(value);
         }
 
       // Sort it
+      this->Sort(reverseOrder);
+      }
+
+    // Description:
+    // Sort the filled array. Types that are exactly represented by a double
+    // are sorted with a LSD radix sort on the bits of that double, 64 bits
+    // integers fall back on vtkstd::sort. Both produce the same order,
+    // including between equal values which stay ordered by OriginalIndex.
+    void Sort(bool reverseOrder)
+      {
+      if(this->ArraySize < RADIX_SORT_MIN_SIZE || !CanRadixSort())
+        {
+        if(reverseOrder)
+          {
+          vtkstd::sort(this->Array, this->Array + this->ArraySize, SortableArrayItem::Ascendent);
+          }
+        else
+          {
+          vtkstd::sort(this->Array, this->Array + this->ArraySize, SortableArrayItem::Descendent);
+          }
+        return;
+        }
+
+      // The radix sort is stable, so reversing the array first gives equal
+      // values the decreasing OriginalIndex order expected when inverted.
       if(reverseOrder)
         {
-        vtkstd::sort(this->Array, this->Array + this->ArraySize, SortableArrayItem::Ascendent);
+        vtkstd::reverse(this->Array, this->Array + this->ArraySize);
         }
-      else
+      vtkTypeUInt64* keys = new vtkTypeUInt64[this->ArraySize];
+      vtkTypeUInt64* tmpKeys = new vtkTypeUInt64[this->ArraySize];
+      SortableArrayItem* tmpArray = new SortableArrayItem[this->ArraySize];
+      for(vtkIdType i=0; i < this->ArraySize; ++i)
+        {
+        keys[i] = GetRadixKey(static_cast<double>(this->Array[i].Value));
+        if(reverseOrder)
+          {
+          keys[i] = ~keys[i];
+          }
+        }
+
+      vtkIdType count[256];
+      for(int shift=0; shift < 64; shift += 8)
+        {
+        memset(count, 0, sizeof(count));
+        for(vtkIdType i=0; i < this->ArraySize; ++i)
+          {
+          count[(keys[i] >> shift) & 0xff]++;
+          }
+        if(count[(keys[0] >> shift) & 0xff] == this->ArraySize)
+          {
+          continue; // Every key share that digit
+          }
+        vtkIdType offset = 0;
+        for(int bucket=0; bucket < 256; ++bucket)
+          {
+          vtkIdType nbInBucket = count[bucket];
+          count[bucket] = offset;
+          offset += nbInBucket;
+          }
+        for(vtkIdType i=0; i < this->ArraySize; ++i)
+          {
+          vtkIdType dst = count[(keys[i] >> shift) & 0xff]++;
+          tmpKeys[dst] = keys[i];
+          tmpArray[dst] = this->Array[i];
+          }
+        vtkstd::swap(keys, tmpKeys);
+        vtkstd::swap(this->Array, tmpArray);
+        }
+
+      delete[] keys;
+      delete[] tmpKeys;
+      delete[] tmpArray;
+      }
+
+    // Description:
+    // Order the runs of equal values by increasing OriginalIndex, which
+    // Sort() only does when the order is not reversed.
+    void SortEqualValuesByOriginalIndex()
+      {
+      vtkIdType first = 0;
+      for(vtkIdType i=1; i <= this->ArraySize; ++i)
+        {
+        if(i == this->ArraySize || this->Array[i].Value != this->Array[first].Value)
+          {
+          if(i - first > 1 &&
+             this->Array[first].OriginalIndex > this->Array[i-1].OriginalIndex)
+            {
+            vtkstd::reverse(this->Array + first, this->Array + i);
+            }
+          first = i;
+          }
+        }
+      }
+
+    // Description:
+    // Only types that a double holds exactly keep their order once turned
+    // into radix keys.
+    static bool CanRadixSort()
+      {
+      return sizeof(T) <= 4 || static_cast<T>(0.5) != static_cast<T>(0);
+      }
+
+    // Description:
+    // Map a double onto an unsigned integer with the same ordering.
+    static vtkTypeUInt64 GetRadixKey(double value)
+      {
+      if(value == 0)
+        {
+        value = 0; // -0 and +0 are equal values
+        }
+      vtkTypeUInt64 bits;
+      memcpy(&bits, &value, sizeof(bits));
+      const vtkTypeUInt64 signBit = static_cast<vtkTypeUInt64>(1) << 63;
+      return (bits & signBit) ? ~bits : (bits | signBit);
+      }
+  };
+
+  // A sampled item: its value, the process that owns it and its index in
+  // that process sorted array. Equal values are ordered by process then by
+  // index, which gives every row a distinct place in the global order.
+  struct Splitter
+  {
+    double Value;
+    int ProcessId;
+    vtkIdType Index;
+  };
+
+  // Order the splitters in the sort order.
+  class SplitterOrder
+  {
+  public:
+    SplitterOrder(bool invertOrder) : InvertOrder(invertOrder) {}
+    bool operator()(const Splitter& a, const Splitter& b) const
+      {
+      if(a.Value != b.Value)
         {
-        vtkstd::sort(this->Array, this->Array + this->ArraySize, SortableArrayItem::Descendent);
+        return this->InvertOrder ? a.Value > b.Value : a.Value < b.Value;
         }
+      if(a.ProcessId != b.ProcessId)
+        {
+        return a.ProcessId < b.ProcessId;
+        }
+      return a.Index < b.Index;
       }
+    bool InvertOrder;
+  };
+
+  // Tell if an item of the local sorted array comes before a splitter in the
+  // sort order.
+  class PrecedesSplitter
+  {
+  public:
+    PrecedesSplitter(bool invertOrder, int processId,
+                     const SortableArrayItem* array)
+      : InvertOrder(invertOrder), ProcessId(processId), Array(array) {}
+    bool operator()(const SortableArrayItem& item,
+                    const Splitter& splitter) const
+      {
+      Splitter key;
+      key.Value = static_cast<double>(item.Value);
+      key.ProcessId = this->ProcessId;
+      key.Index = &item - this->Array;
+      return SplitterOrder(this->InvertOrder)(key, splitter);
+      }
+    bool InvertOrder;
+    int ProcessId;
+    const SortableArrayItem* Array;
   };
 
 public:
@@ -579,7 +501,7 @@ public:
     {
     // Only used for testing
     this->LocalSorter = 0;
-    this->GlobalHistogram = 0;
+    this->GlobalSize = 0;
     this->Debug = false;
     }
 
@@ -589,6 +511,7 @@ public:
     // Default values
     this->SelectedComponent = 0;
     this->NeedToBuildCache = true;
+    this->GlobalSize = 0;
     this->DataToSort = dataToSort;
 
     this->InputMTime = input->GetMTime();
@@ -605,13 +528,11 @@ public:
 
     // Create internal objects
     this->LocalSorter = new ArraySorter();
-    this->GlobalHistogram = new Histogram(HISTOGRAM_SIZE);
     }
 
   virtual ~Internals()
     {
     if (this->LocalSorter)     delete this->LocalSorter;
-    if (this->GlobalHistogram) delete this->GlobalHistogram;
     }
 
   // --------------------------------------------------------------------------
@@ -636,7 +557,7 @@ public:
       this->DataToSort->GetRange(localRange, this->SelectedComponent);
       }
 
-    // Gather the array range to build a common scale histogram
+    // Gather the array range to decide whether there is anything to sort
     this->MPI->AllReduce(&localRange[0], &this->CommonRange[0], 1, vtkCommunicator::MIN_OP);
     this->MPI->AllReduce(&localRange[1], &this->CommonRange[1], 1, vtkCommunicator::MAX_OP);
 
@@ -679,14 +600,11 @@ public:
     }
 
   // --------------------------------------------------------------------------
-  int BuildCache(bool sortableArray, bool invertOrder)
+  int BuildCache(bool sortableArray, bool invertOrder, vtkIdType blockSize)
     {
     // We are building the cache so no need to build it next time
     this->NeedToBuildCache = false;
 
-    // Communication buffer
-    vtkIdType* bufferHistogramValues = new vtkIdType[this->NumProcs *  HISTOGRAM_SIZE];
-
     // Is there something to sort ???
     if(!sortableArray)
       {
@@ -700,46 +618,108 @@ public:
       {
       if(this->DataToSort)
         {
-        // Sort and build local histogram
+        // Sort locally
         this->LocalSorter->Update(static_cast<T*>(this->DataToSort->GetVoidPointer(0)),
                                   this->DataToSort->GetNumberOfTuples(),
                                   this->DataToSort->GetNumberOfComponents(),
                                   this->SelectedComponent,
-                                  HISTOGRAM_SIZE,
-                                  this->CommonRange,
                                   invertOrder);
         }
       else
         {
-        // Build empty local histogram
         this->LocalSorter->Clear();
-        this->LocalSorter->Histo = new Histogram(HISTOGRAM_SIZE);
-        this->LocalSorter->Histo->SetScalarRange(this->CommonRange);
-        this->LocalSorter->Histo->Inverted = invertOrder;
         }
 
-      // Initialize the global histogram with same range
-      this->LocalSorter->Histo->CopyRangeTo(*this->GlobalHistogram);
-
-      // Make sure that the global histogram is properly initialized
-      this->GlobalHistogram->ClearHistogramValues();
-      this->GlobalHistogram->Inverted = invertOrder;
+      this->BuildSortIndex(invertOrder, blockSize);
+      }
 
-      // Send local histogram and receive every histogram from everybody
-      this->MPI->AllGather(this->LocalSorter->Histo->Values,
-                           bufferHistogramValues,
-                           HISTOGRAM_SIZE);
+    return 1;
+    }
 
-      // Merge all histogram into the GlobalHistogram
-      for(int idx=0, nb=this->NumProcs*HISTOGRAM_SIZE; idx < nb; ++idx)
+  // --------------------------------------------------------------------------
+  // Sample sort index: every process samples its sorted array about every
+  // blockSize values, the samples shared by everybody become the splitters
+  // and for each of them we keep how many values come before it locally and
+  // globally. Any global range of the sorted table is then bracketed by two
+  // splitters without further communication. The splitters are ordered by
+  // (value, process, local index) so that runs of equal values are split too
+  // and every row is in exactly one block.
+  void BuildSortIndex(bool invertOrder, vtkIdType blockSize)
+    {
+    vtkIdType localSize = this->LocalSorter->ArraySize;
+    this->MPI->AllReduce(&localSize, &this->GlobalSize, 1, vtkCommunicator::SUM_OP);
+
+    vtkIdType stride = this->GlobalSize / MAX_NUMBER_OF_SPLITTERS + 1;
+    stride = MAX(stride, blockSize);
+    stride = MAX(stride, 1);
+
+    vtkstd::vector<double> localValues;
+    vtkstd::vector<vtkIdType> localIndices;
+    for(vtkIdType idx=stride; idx < localSize; idx += stride)
+      {
+      localValues.push_back(
+        static_cast<double>(this->LocalSorter->Array[idx].Value));
+      localIndices.push_back(idx);
+      }
+
+    // Gather all the samples
+    vtkIdType nbLocalSplitters = static_cast<vtkIdType>(localValues.size());
+    vtkstd::vector<vtkIdType> nbSplitters(this->NumProcs);
+    vtkstd::vector<vtkIdType> offsets(this->NumProcs);
+    this->MPI->AllGather(&nbLocalSplitters, &nbSplitters[0], 1);
+    vtkIdType nbGlobalSplitters = 0;
+    for(int i=0; i < this->NumProcs; i++)
+      {
+      offsets[i] = nbGlobalSplitters;
+      nbGlobalSplitters += nbSplitters[i];
+      }
+    this->Splitters.resize(nbGlobalSplitters);
+    if(nbGlobalSplitters > 0)
+      {
+      vtkstd::vector<double> values(nbGlobalSplitters);
+      vtkstd::vector<vtkIdType> indices(nbGlobalSplitters);
+      double dummyValue = 0;
+      vtkIdType dummyIndex = 0;
+      this->MPI->AllGatherV(
+        localValues.empty() ? &dummyValue : &localValues[0],
+        &values[0], nbLocalSplitters, &nbSplitters[0], &offsets[0]);
+      this->MPI->AllGatherV(
+        localIndices.empty() ? &dummyIndex : &localIndices[0],
+        &indices[0], nbLocalSplitters, &nbSplitters[0], &offsets[0]);
+      for(int i=0; i < this->NumProcs; i++)
         {
-        this->GlobalHistogram->TotalValues += bufferHistogramValues[idx];
-        this->GlobalHistogram->Values[idx % HISTOGRAM_SIZE] += bufferHistogramValues[idx];
+        for(vtkIdType j=offsets[i]; j < offsets[i] + nbSplitters[i]; j++)
+          {
+          this->Splitters[j].Value = values[j];
+          this->Splitters[j].ProcessId = i;
+          this->Splitters[j].Index = indices[j];
+          }
         }
       }
 
-    delete[] bufferHistogramValues;
-    return 1;
+    // Same splitters, in the same order, on every process
+    vtkstd::sort(this->Splitters.begin(), this->Splitters.end(),
+                 SplitterOrder(invertOrder));
+
+    // Number of values sorted before each splitter
+    size_t nbIndex = this->Splitters.size();
+    this->LocalSplitterOffsets.resize(nbIndex);
+    this->GlobalSplitterOffsets.resize(nbIndex);
+    SortableArrayItem* first = this->LocalSorter->Array;
+    SortableArrayItem* last = first + localSize;
+    PrecedesSplitter precedes(invertOrder, this->Me, first);
+    for(size_t i=0; i < nbIndex; i++)
+      {
+      first = vtkstd::lower_bound(first, last, this->Splitters[i], precedes);
+      this->LocalSplitterOffsets[i] = first - this->LocalSorter->Array;
+      }
+    if(nbIndex > 0)
+      {
+      this->MPI->AllReduce(&this->LocalSplitterOffsets[0],
+                           &this->GlobalSplitterOffsets[0],
+                           static_cast<vtkIdType>(nbIndex),
+                           vtkCommunicator::SUM_OP);
+      }
     }
 
   // --------------------------------------------------------------------------
@@ -754,7 +734,7 @@ public:
     // ------------------------------------------------------------------------
     if(this->NeedToBuildCache)
       {
-      this->BuildCache(false, revertOrder);
+      this->BuildCache(false, revertOrder, blockSize);
       }
 
 
@@ -857,13 +837,9 @@ public:
       if(subsetArray)
         {
         ArraySorter sorter;
-        this->CommonRange[0] = 0;
-        this->CommonRange[1] = this->NumProcs;
         // ProcessId array is not the same type of T
         sorter.SortProcessId(static_cast<vtkIdType*>(subsetArray->GetVoidPointer(0)),
                              subsetArray->GetNumberOfTuples(),
-                             HISTOGRAM_SIZE,
-                             this->CommonRange,
                              revertOrder);
 
         localResult.TakeReference(
@@ -900,44 +876,42 @@ public:
     // ------------------------------------------------------------------------
     if(this->NeedToBuildCache)
       {
-      this->BuildCache(true, revertOrder);
+      this->BuildCache(true, revertOrder, blockSize);
       }
 
     // ------------------------------------------------------------------------
-    // Search for lower bound
+    // Bracket the requested rows with the closest splitters
     // ------------------------------------------------------------------------
-    vtkIdType nbElementsToRemoveFromHead = 0;
+    vtkIdType firstIdx = block * blockSize;
+    vtkIdType lastIdx = MIN(firstIdx + blockSize, this->GlobalSize);
     vtkIdType localOffset = 0;
-    vtkIdType nbElementsInBar = 0;
-    this->SearchGlobalIndexLocation( (block * blockSize),
-                                     this->LocalSorter->Histo,
-                                     this->GlobalHistogram,
-                                     nbElementsToRemoveFromHead,
-                                     localOffset,
-                                     nbElementsInBar);
-
-
-
-    // ------------------------------------------------------------------------
-    // Search for upper bound
-    // ------------------------------------------------------------------------
-    vtkIdType upperOffset = 0;
-    vtkIdType globalUpperOffset = 0;
-    vtkIdType searchIdx =
-        (this->GlobalHistogram->TotalValues < (block + 1) * blockSize) ?
-        this->GlobalHistogram->TotalValues : ((block + 1) * blockSize);
-    searchIdx--; // It is not a size it is an index (so -1)
-
-    this->SearchGlobalIndexLocation( searchIdx,
-                                     this->LocalSorter->Histo,
-                                     this->GlobalHistogram,
-                                     globalUpperOffset,
-                                     upperOffset,
-                                     nbElementsInBar );
+    vtkIdType globalOffset = 0;
+    vtkIdType localEnd = this->LocalSorter->ArraySize;
 
+    vtkstd::vector<vtkIdType>::iterator lower =
+      vtkstd::upper_bound(this->GlobalSplitterOffsets.begin(),
+                          this->GlobalSplitterOffsets.end(), firstIdx);
+    if(lower != this->GlobalSplitterOffsets.begin())
+      {
+      size_t idx = (lower - this->GlobalSplitterOffsets.begin()) - 1;
+      localOffset = this->LocalSplitterOffsets[idx];
+      globalOffset = this->GlobalSplitterOffsets[idx];
+      }
+    vtkstd::vector<vtkIdType>::iterator upper =
+      vtkstd::lower_bound(this->GlobalSplitterOffsets.begin(),
+                          this->GlobalSplitterOffsets.end(), lastIdx);
+    if(upper != this->GlobalSplitterOffsets.end())
+      {
+      localEnd =
+        this->LocalSplitterOffsets[upper - this->GlobalSplitterOffsets.begin()];
+      }
 
-    // We have to include our searched index (so +1)
-    vtkIdType localSize = (upperOffset + nbElementsInBar) - localOffset + 1;
+    vtkIdType nbElementsToRemoveFromHead = firstIdx - globalOffset;
+    vtkIdType localSize = MAX(0, localEnd - localOffset);
+    if(firstIdx >= this->GlobalSize)
+      {
+      localSize = 0;
+      }
 
     // ------------------------------------------------------------------------
     // Build local subset table
@@ -953,22 +927,6 @@ public:
     // ------------------------------------------------------------------------
     int mergePid = GetMergingProcessId(localSubset.GetPointer());
 
-    // ------------------------------------------------------------------------
-    // Add local meta-data in case of merge process
-    // ------------------------------------------------------------------------
-    if(this->NumProcs > 1 && this->Me == mergePid)
-      {
-      vtkSmartPointer<vtkIdTypeArray> processIdArray = vtkSmartPointer<vtkIdTypeArray>::New();
-      processIdArray->SetName("vtkOriginalProcessIds");
-      processIdArray->SetNumberOfComponents(1);
-      processIdArray->Allocate( (blockSize<localSize) ? localSize : blockSize);
-      for(vtkIdType idx=0; idx < localSubset->GetNumberOfRows(); idx++)
-        {
-        processIdArray->InsertNextTuple1(mergePid);
-        }
-      localSubset->GetRowData()->AddArray(processIdArray);
-      }
-
     // ------------------------------------------------------------------------
     // Send local subset array to process mergePid
     // ------------------------------------------------------------------------
@@ -982,14 +940,30 @@ public:
     // ------------------------------------------------------------------------
     if( this->Me == mergePid)
       {
-      vtkSmartPointer<vtkTable> tmp = vtkSmartPointer<vtkTable>::New();
-      for(int i=0; i < this->NumProcs; i++)
+      // Merge the subsets in process order, which is how equal values are
+      // ordered across processes
+      if(this->NumProcs > 1)
         {
-        if(i == mergePid)
-          continue;
+        vtkSmartPointer<vtkTable> merged;
+        merged.TakeReference(NewSubsetTable(input, NULL, 0, 0));
+        vtkSmartPointer<vtkIdTypeArray> processIdArray = vtkSmartPointer<vtkIdTypeArray>::New();
+        processIdArray->SetName("vtkOriginalProcessIds");
+        processIdArray->SetNumberOfComponents(1);
+        processIdArray->Allocate( (blockSize<localSize) ? localSize : blockSize);
+        merged->GetRowData()->AddArray(processIdArray);
 
-        this->MPI->Receive(tmp.GetPointer(), i, VTK_TABLE_EXCHANGE_TAG);
-        this->MergeTable(i,tmp.GetPointer(),localSubset.GetPointer(),blockSize);
+        vtkSmartPointer<vtkTable> tmp = vtkSmartPointer<vtkTable>::New();
+        for(int i=0; i < this->NumProcs; i++)
+          {
+          if(i == mergePid)
+            {
+            this->MergeTable(i, localSubset.GetPointer(), merged.GetPointer(), blockSize);
+            continue;
+            }
+          this->MPI->Receive(tmp.GetPointer(), i, VTK_TABLE_EXCHANGE_TAG);
+          this->MergeTable(i, tmp.GetPointer(), merged.GetPointer(), blockSize);
+          }
+        localSubset = merged;
         }
 
       // Sort new table/array
@@ -1012,9 +986,8 @@ public:
                     subsetArray->GetNumberOfTuples(),
                     subsetArray->GetNumberOfComponents(),
                     this->SelectedComponent,
-                    HISTOGRAM_SIZE,
-                    this->CommonRange,
                     revertOrder);
+      sorter.SortEqualValuesByOriginalIndex();
 
       // trim it (remove head and tail that don't belong to the result)
       localSubset.TakeReference(
@@ -1038,81 +1011,6 @@ public:
     return 1;
     }
 
-  // --------------------------------------------------------------------------
-  // nbGlobalToSkip is the number of elements that should be skiped at the end
-  // if you exactly want to reach the searchedGlobalIndex.
-  // localOffset is the corresponding local index in the sorted table to the
-  // global index of (searchedGlobalIndex - nbGlobalToSkip)
-  // nbInLocalBar is the local number of elements that are available
-  // in the hitogram bar where the searchedGlobalIndex has been found.
-  // nbInLocalBar is used when you want to get an upper bound that
-  // will include the searchedGlobalIndex.
-  void SearchGlobalIndexLocation(vtkIdType searchedGlobalIndex,
-                                 Histogram* localHistogram,
-                                 Histogram* globalHistogram,
-                                 vtkIdType& nbGlobalToSkip,
-                                 vtkIdType& localOffset,
-                                 vtkIdType& nbInLocalBar)
-    {
-    // Communication buffer
-    vtkIdType* bufferHistogramValues = new vtkIdType[this->NumProcs *  HISTOGRAM_SIZE];
-
-    // Local internal working var
-    vtkIdType histogramBarIdx = -1;
-    double currentRange[2];
-    vtkIdType idx, idxEnd;
-
-    // Setup inital hitogram range and values
-    Histogram _globalHistogram;
-    Histogram _localHistogram;
-    localHistogram->CopyTo(_localHistogram);
-    globalHistogram->CopyTo(_globalHistogram);
-
-    // Reset local offsets
-    localOffset = 0;
-    nbGlobalToSkip = searchedGlobalIndex;
-
-    do
-      {
-      nbGlobalToSkip -= _globalHistogram.GetNewRange(nbGlobalToSkip,
-                                                     histogramBarIdx,
-                                                     currentRange);
-
-      localOffset += _localHistogram.GetNumberOfElements(0, histogramBarIdx);
-      nbInLocalBar = _localHistogram.GetNumberOfElements(histogramBarIdx,
-                                                         histogramBarIdx+1);
-
-      // Based on a narrowed range, build local histogram to get closer to the
-      // real index of the object
-      _localHistogram.SetScalarRange(currentRange);
-      _localHistogram.ClearHistogramValues();
-
-      idxEnd = localOffset + nbInLocalBar;
-      for(idx = localOffset; idx < idxEnd; ++idx)
-        {
-        _localHistogram.AddValue(this->LocalSorter->Array[idx].Value);
-        }
-
-      // Exchange local histo with everyone
-      this->MPI->AllGather( _localHistogram.Values,
-                            bufferHistogramValues, HISTOGRAM_SIZE);
-
-      // Build global histogram
-      _globalHistogram.SetScalarRange(currentRange);
-      _globalHistogram.ClearHistogramValues();
-
-      idxEnd = this->NumProcs * HISTOGRAM_SIZE;
-      for(idx = 0; idx < idxEnd; ++idx)
-        {
-        _globalHistogram.TotalValues += bufferHistogramValues[idx];
-        _globalHistogram.Values[idx % HISTOGRAM_SIZE] += bufferHistogramValues[idx];
-        }
-      }
-    while(nbGlobalToSkip > 0 && _globalHistogram.CanBeReduced());
-
-    delete[] bufferHistogramValues;
-    }
-
   // --------------------------------------------------------------------------
   static vtkTable* NewSubsetTable( vtkTable* srcTable,
                             ArraySorter* sorter,
@@ -1250,7 +1148,7 @@ public:
     dataB->SetNumberOfComponents(3);
 
     // Fill data with values
-    for(int i=0;i<2048;i++) // 2048 is bigger than histogram
+    for(int i=0;i<2048;i++)
       {
       dataA->InsertNextTuple1(vtkMath::Random());
       dataB->InsertNextTuple3(vtkMath::Random(),
@@ -1261,54 +1159,12 @@ public:
     input->GetRowData()->AddArray(dataA.GetPointer());
     input->GetRowData()->AddArray(dataB.GetPointer());
 
-    Histogram histPart1(100);
-    Histogram histPart2(100);
-    Histogram histMerge(100);
-    histPart1.SetScalarRange(dataA->GetRange());
-    histPart2.SetScalarRange(dataA->GetRange());
-    histMerge.SetScalarRange(dataA->GetRange());
-    for(vtkIdType i=0;i<dataA->GetNumberOfTuples();i++)
-      {
-      if( i < 1024 )
-        {
-        histPart1.AddValue(dataA->GetValue(i));
-        }
-      else
-        {
-        histPart2.AddValue(dataA->GetValue(i));
-        }
-      }
-
-    // Make sure that no values have been skiped while adding them
-    if(histPart1.TotalValues + histPart2.TotalValues != dataA->GetNumberOfTuples())
-      {
-      cout << "Invalid number of elements in the histogram. Expected "
-          << dataA->GetNumberOfTuples() << " and got "
-          << (histPart1.TotalValues + histPart2.TotalValues) << endl;
-      return false;
-      }
-
-    // Make sure that no values have been skiped while merging histo
-    histMerge.Merge(histPart1);
-    histMerge.Merge(histPart2);
-    if(histMerge.TotalValues != dataA->GetNumberOfTuples())
-      {
-      cout << "Invalid number of elements in the histogram. Expected "
-          << dataA->GetNumberOfTuples() << " and got "
-          << (histMerge.TotalValues) << endl;
-      return false;
-      }
-
-    cout << "Histogram ok" << endl;
-
     // Try to sort array
     ArraySorter sortedArray;
     sortedArray.Update(static_cast<T*>(dataA->GetVoidPointer(0)),
                        dataA->GetNumberOfTuples(),
                        dataA->GetNumberOfComponents(),
                        0,
-                       100,
-                       dataA->GetRange(),
                        false);
 
     double min = dataA->GetRange()[0];
@@ -1341,8 +1197,6 @@ public:
                        dataA->GetNumberOfTuples(),
                        dataA->GetNumberOfComponents(),
                        0,
-                       100,
-                       dataA->GetRange(),
                        true);
 
     if( sortedArray.ArraySize != dataA->GetNumberOfTuples())
@@ -1370,6 +1224,33 @@ public:
     cout << "ArraySorter ok [" << dataA->GetRange()[0] << ", "
          << dataA->GetRange()[1] << "]" << endl;
 
+    // Big enough to go through the radix sort, with negative and repeated
+    // values which must stay ordered by their original index.
+    vtkSmartPointer<vtkDoubleArray> dataC = vtkSmartPointer<vtkDoubleArray>::New();
+    for(int i=0;i<4*RADIX_SORT_MIN_SIZE;i++)
+      {
+      dataC->InsertNextTuple1(vtkMath::Floor(vtkMath::Random(-100, 100)));
+      }
+    for(int invert=0;invert<2;invert++)
+      {
+      sortedArray.Update(static_cast<T*>(dataC->GetVoidPointer(0)),
+                         dataC->GetNumberOfTuples(), 1, 0, invert != 0);
+      for(vtkIdType i=1;i<sortedArray.ArraySize;i++)
+        {
+        bool ordered = invert ?
+          SortableArrayItem::Ascendent(sortedArray.Array[i-1], sortedArray.Array[i]) :
+          SortableArrayItem::Descendent(sortedArray.Array[i-1], sortedArray.Array[i]);
+        if(!ordered)
+          {
+          cout << "Radix sort misplaced the value " << sortedArray.Array[i].Value
+               << " at index " << i << endl;
+          return false;
+          }
+        }
+      }
+
+    cout << "Radix sort ok" << endl;
+
     return true;
   }
   // --------------------------------------------------------------------------
@@ -1399,7 +1280,10 @@ private:
   unsigned long int DataMTime;  // Keep the original data MTime
   vtkDataArray* DataToSort;   // DataArray to sort
   ArraySorter* LocalSorter;   // Local ArraySorter based on global range
-  Histogram* GlobalHistogram; // Globaly merged Histogram based on global range
+  vtkIdType GlobalSize;       // Number of rows to sort across processes
+  vtkstd::vector<Splitter> Splitters;            // Sampled items in sort order
+  vtkstd::vector<vtkIdType> LocalSplitterOffsets;  // Local rows before splitters
+  vtkstd::vector<vtkIdType> GlobalSplitterOffsets; // Global rows before splitters
   double CommonRange[2];      // Scalar range used across processes
   int Me;                     // Current process ID
   int NumProcs;               // Number of processes involved
@@ -1409,13 +1293,11 @@ private:
   bool Debug;
 
   const static int VTK_TABLE_EXCHANGE_TAG = 50;
-  // HISTOGRAM_SIZE could be computed dynamically based on the type of the
-  // array to sort but to make sure that unsigned char won't be distributed
-  // correctly we set the histogram size to be their max number of element
-  // type.
-  // Maybe make some test on huge cluster to see which histogram size is
-  // the best.
-  const static int HISTOGRAM_SIZE = 256;
+  // Bound the size of the sort index replicated on every process, the
+  // sampling gets coarser on bigger tables.
+  const static int MAX_NUMBER_OF_SPLITTERS = 65536;
+  // Below that size vtkstd::sort beats the radix passes.
+  const static int RADIX_SORT_MIN_SIZE = 4096;
 };
 //****************************************************************************
 vtkStandardNewMacro(vtkSortedTableStreamer);
@@ -1431,6 +1313,8 @@ vtkSortedTableStreamer::vtkSortedTableStreamer()
   this->BlockSize = 1024;
   this->Internal = 0;
   this->SelectedComponent = 0;
+  this->MergedInput = 0;
+  this->MergedInputMTime = 0;
   this->SetController(vtkMultiProcessController::GetGlobalController());
 }
 
@@ -1444,6 +1328,11 @@ vtkSortedTableStreamer::~vtkSortedTableStreamer()
     delete this->Internal;
     this->Internal = 0;
     }
+  if(this->MergedInput)
+    {
+    this->MergedInput->UnRegister(this);
+    this->MergedInput = 0;
+    }
 }
 
 //----------------------------------------------------------------------------
@@ -1469,8 +1358,15 @@ int vtkSortedTableStreamer::RequestData( vtkInformation* vtkNotUsed(request),
 
   bool orderInverted = this->InvertOrder > 0;
 
-  // Convert a composite dataset into a vtkTable input.
-  if(!input)
+  // Convert a composite dataset into a vtkTable input. The merged table is
+  // kept as long as the input does not change, otherwise its new MTime
+  // would throw away the sort index at each requested block.
+  if(!input && this->MergedInput &&
+     this->MergedInputMTime == inputDO->GetMTime())
+    {
+    input = this->MergedInput;
+    }
+  else if(!input)
     {
     vtkSmartPointer<vtkCompositeDataSet> inputCompositeDS =
         vtkCompositeDataSet::SafeDownCast(inputDO);
@@ -1556,6 +1452,14 @@ int vtkSortedTableStreamer::RequestData( vtkInformation* vtkNotUsed(request),
         }
       }
     iter->Delete();
+
+    if(this->MergedInput)
+      {
+      this->MergedInput->UnRegister(this);
+      }
+    this->MergedInput = input;
+    this->MergedInput->Register(this);
+    this->MergedInputMTime = inputDO->GetMTime();
     }
 
   // Get input data
@@ -1617,8 +1521,12 @@ const char* vtkSortedTableStreamer::GetColumnNameToSort()
 //----------------------------------------------------------------------------
 void vtkSortedTableStreamer::SetColumnNameToSort(const char* columnName)
 {
+  // Keep the sort index when the same column is set again
+  bool changed = (columnName == 0) != (this->ColumnToSort == 0) ||
+    (columnName && strcmp(columnName, this->ColumnToSort) != 0);
   this->SetColumnToSort(columnName);
-  if(strcmp("vtkOriginalProcessIds", this->GetColumnToSort()) != 0)
+  if(changed && this->GetColumnToSort() &&
+     strcmp("vtkOriginalProcessIds", this->GetColumnToSort()) != 0)
     {
     if(this->Internal)
       {
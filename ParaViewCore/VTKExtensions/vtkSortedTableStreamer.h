@@ -18,6 +18,9 @@
 // This filter is used quickly get a sorted subset of a given vtkTable.
 // By sorted we mean a subset build from a global sort even if some optimisation
 // allow us to skip a global table sorting.
+// The local sort and a distributed index of sampled splitters are computed
+// once per input, column and order. Requesting another block then only
+// exchanges the rows of that block and its neighborhood.
 
 #ifndef __vtkSortedTableStreamer_h
 #define __vtkSortedTableStreamer_h
@@ -103,6 +106,11 @@ protected:
   char* ColumnToSort;
   int SelectedComponent;
   int InvertOrder;
+
+  // Description:
+  // Table built from a composite input and the input MTime it was built at.
+  vtkTable* MergedInput;
+  unsigned long MergedInputMTime;
 private:
   vtkSortedTableStreamer(const vtkSortedTableStreamer&); // Not implemented
   void operator=(const vtkSortedTableStreamer&);   // Not implemented
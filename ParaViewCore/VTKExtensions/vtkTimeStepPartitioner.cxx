@@ -0,0 +1,115 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    vtkTimeStepPartitioner.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkTimeStepPartitioner.h"
+
+#include "vtkInformation.h"
+#include "vtkMultiProcessController.h"
+#include "vtkObjectFactory.h"
+#include "vtkStreamingDemandDrivenPipeline.h"
+
+vtkStandardNewMacro(vtkTimeStepPartitioner);
+vtkCxxSetObjectMacro(vtkTimeStepPartitioner, Controller,
+  vtkMultiProcessController);
+//----------------------------------------------------------------------------
+vtkTimeStepPartitioner::vtkTimeStepPartitioner()
+{
+  this->Controller = 0;
+  this->SetController(vtkMultiProcessController::GetGlobalController());
+  this->NumberOfGroups = 1;
+
+  this->NumberOfGroupsUsed = 1;
+  this->Group = 0;
+  this->FirstTimeStep = 0;
+  this->EndTimeStep = 0;
+  this->Piece = 0;
+  this->NumberOfPieces = 1;
+}
+
+//----------------------------------------------------------------------------
+vtkTimeStepPartitioner::~vtkTimeStepPartitioner()
+{
+  this->SetController(0);
+}
+
+//----------------------------------------------------------------------------
+void vtkTimeStepPartitioner::Partition(int numberOfTimeSteps)
+{
+  int numProcs = this->Controller?
+    this->Controller->GetNumberOfProcesses() : 1;
+  int rank = this->Controller? this->Controller->GetLocalProcessId() : 0;
+
+  int groups = this->NumberOfGroups;
+  if (groups > numProcs)
+    {
+    groups = numProcs;
+    }
+  if (groups > numberOfTimeSteps)
+    {
+    groups = numberOfTimeSteps > 1? numberOfTimeSteps : 1;
+    }
+  this->NumberOfGroupsUsed = groups;
+
+  // Group k holds the ranks in [ceil(k*P/G), ceil((k+1)*P/G)).
+  this->Group = (rank * groups) / numProcs;
+  int firstRank = (this->Group * numProcs + groups - 1) / groups;
+  int endRank = ((this->Group + 1) * numProcs + groups - 1) / groups;
+  this->Piece = rank - firstRank;
+  this->NumberOfPieces = endRank - firstRank;
+
+  int numberOfSteps = numberOfTimeSteps > 0? numberOfTimeSteps : 0;
+  this->FirstTimeStep = (this->Group * numberOfSteps) / groups;
+  this->EndTimeStep = ((this->Group + 1) * numberOfSteps) / groups;
+
+  vtkDebugMacro("Process " << rank << " is piece " << this->Piece << " of "
+    << this->NumberOfPieces << " in group " << this->Group << " of "
+    << groups << ", time steps [" << this->FirstTimeStep << ", "
+    << this->EndTimeStep << ")");
+}
+
+//----------------------------------------------------------------------------
+void vtkTimeStepPartitioner::RequestTimeStep(vtkInformation* inInfo, int index)
+{
+  double* inTimes =
+    inInfo->Get(vtkStreamingDemandDrivenPipeline::TIME_STEPS());
+  int numberOfTimeSteps =
+    inInfo->Length(vtkStreamingDemandDrivenPipeline::TIME_STEPS());
+  if (inTimes && index >= 0 && index < numberOfTimeSteps)
+    {
+    inInfo->Set(vtkStreamingDemandDrivenPipeline::UPDATE_TIME_STEPS(),
+      &inTimes[index], 1);
+    }
+
+  if (this->NumberOfGroupsUsed > 1)
+    {
+    inInfo->Set(vtkStreamingDemandDrivenPipeline::UPDATE_PIECE_NUMBER(),
+      this->Piece);
+    inInfo->Set(vtkStreamingDemandDrivenPipeline::UPDATE_NUMBER_OF_PIECES(),
+      this->NumberOfPieces);
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkTimeStepPartitioner::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "Controller: " << this->Controller << endl;
+  os << indent << "NumberOfGroups: " << this->NumberOfGroups << endl;
+  os << indent << "NumberOfGroupsUsed: " << this->NumberOfGroupsUsed << endl;
+  os << indent << "Group: " << this->Group << endl;
+  os << indent << "FirstTimeStep: " << this->FirstTimeStep << endl;
+  os << indent << "EndTimeStep: " << this->EndTimeStep << endl;
+  os << indent << "Piece: " << this->Piece << endl;
+  os << indent << "NumberOfPieces: " << this->NumberOfPieces << endl;
+}
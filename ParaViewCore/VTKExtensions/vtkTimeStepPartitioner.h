@@ -0,0 +1,103 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    vtkTimeStepPartitioner.h
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME vtkTimeStepPartitioner - assigns time steps to groups of processes.
+// .SECTION Description
+// vtkTimeStepPartitioner helps temporal filters that loop over the time
+// steps of their input with CONTINUE_EXECUTING to run in parallel in time as
+// well as in space. The processes are split into NumberOfGroups groups of
+// consecutive ranks. Each group gets a contiguous range of the time steps,
+// and its processes split each of these time steps into pieces among
+// themselves. The groups update the upstream pipeline independently, so the
+// filter only has to combine the partial results of all the processes at
+// the end.
+//
+// A filter calls Partition() with the number of input time steps before its
+// first pass. It then requests each time step in [FirstTimeStep,
+// EndTimeStep) with RequestTimeStep() from RequestUpdateExtent().
+//
+// With more than one group, the processes of different groups do not
+// update the upstream pipeline together. Readers or filters that
+// communicate among all the processes during their execution will hang.
+
+#ifndef __vtkTimeStepPartitioner_h
+#define __vtkTimeStepPartitioner_h
+
+#include "vtkObject.h"
+
+class vtkInformation;
+class vtkMultiProcessController;
+
+class VTK_EXPORT vtkTimeStepPartitioner : public vtkObject
+{
+public:
+  static vtkTimeStepPartitioner* New();
+  vtkTypeMacro(vtkTimeStepPartitioner, vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent);
+
+  // Description:
+  // Get/Set the controller of the processes to split. By default, the
+  // global controller.
+  void SetController(vtkMultiProcessController*);
+  vtkGetObjectMacro(Controller, vtkMultiProcessController);
+
+  // Description:
+  // Number of groups the processes are split into. 1, the default, means
+  // every process works on every time step.
+  vtkSetClampMacro(NumberOfGroups, int, 1, VTK_LARGE_INTEGER);
+  vtkGetMacro(NumberOfGroups, int);
+
+  // Description:
+  // Assign the time steps to the groups. There are no more groups than
+  // processes or time steps. Must be called with the same number of time
+  // steps on all the processes.
+  void Partition(int numberOfTimeSteps);
+
+  // Description:
+  // Results of the last Partition(). The time steps of the group of this
+  // process are [FirstTimeStep, EndTimeStep), and this process reads piece
+  // Piece out of NumberOfPieces of each of them.
+  vtkGetMacro(NumberOfGroupsUsed, int);
+  vtkGetMacro(Group, int);
+  vtkGetMacro(FirstTimeStep, int);
+  vtkGetMacro(EndTimeStep, int);
+  vtkGetMacro(Piece, int);
+  vtkGetMacro(NumberOfPieces, int);
+
+  // Description:
+  // Request the time step with the given index in the TIME_STEPS of the
+  // input information. When the time steps are split among several groups,
+  // the piece of this process in its group is requested too.
+  void RequestTimeStep(vtkInformation* inInfo, int index);
+
+protected:
+  vtkTimeStepPartitioner();
+  ~vtkTimeStepPartitioner();
+
+  vtkMultiProcessController* Controller;
+  int NumberOfGroups;
+
+  int NumberOfGroupsUsed;
+  int Group;
+  int FirstTimeStep;
+  int EndTimeStep;
+  int Piece;
+  int NumberOfPieces;
+
+private:
+  vtkTimeStepPartitioner(const vtkTimeStepPartitioner&); // Not implemented
+  void operator=(const vtkTimeStepPartitioner&); // Not implemented
+};
+
+#endif
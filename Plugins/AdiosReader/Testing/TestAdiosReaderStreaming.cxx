@@ -0,0 +1,163 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestAdiosReaderStreaming.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME Test of the streaming mode of vtkAdiosReader
+// .SECTION Description
+// Streams a numbered series of BP files, which the reader uses in place of
+// a staging method, with and without Prefetch, including a step that shows
+// up while streaming, and checks that prefetching reads the same data.
+
+#include "vtkAdiosReader.h"
+#include "vtkCellData.h"
+#include "vtkDataArray.h"
+#include "vtkDataSet.h"
+#include "vtkMultiBlockDataSet.h"
+#include "vtkPointData.h"
+#include "vtkSmartPointer.h"
+#include "vtkTestUtilities.h"
+
+#include <vtksys/SystemTools.hxx>
+#include <vtksys/ios/sstream>
+#include <vtkstd/string>
+#include <vtkstd/vector>
+
+#define NUMBER_OF_STEPS 3
+
+namespace
+{
+  vtkstd::string StepFileName(const vtkstd::string& prefix, int step)
+  {
+    vtksys_ios::ostringstream name;
+    name << prefix << ".000" << step << ".bp";
+    return name.str();
+  }
+
+  // Sizes and array ranges of the blocks read for a step.
+  void Summarize(vtkAdiosReader* reader, vtkstd::vector<double>& summary)
+  {
+    vtkMultiBlockDataSet* output =
+      vtkMultiBlockDataSet::SafeDownCast(reader->GetOutputDataObject(0));
+    summary.push_back(output ? output->GetNumberOfBlocks() : -1);
+    for (unsigned int i = 0; output && i < output->GetNumberOfBlocks(); i++)
+      {
+      vtkDataSet* block = vtkDataSet::SafeDownCast(output->GetBlock(i));
+      if (!block)
+        {
+        summary.push_back(-1);
+        continue;
+        }
+      summary.push_back(block->GetNumberOfPoints());
+      summary.push_back(block->GetNumberOfCells());
+      vtkDataSetAttributes* attributes[2] =
+        { block->GetPointData(), block->GetCellData() };
+      for (int j = 0; j < 2; j++)
+        {
+        summary.push_back(attributes[j]->GetNumberOfArrays());
+        for (int k = 0; k < attributes[j]->GetNumberOfArrays(); k++)
+          {
+          double range[2];
+          attributes[j]->GetArray(k)->GetRange(range, -1);
+          summary.push_back(range[0]);
+          summary.push_back(range[1]);
+          }
+        }
+      }
+  }
+
+  // Read the steps of the stream until there are no more, then once more
+  // after the next step was added. Returns the number of steps read.
+  int Stream(const vtkstd::string& prefix, const char* data, int prefetch,
+             vtkstd::vector<double>& summary)
+  {
+    vtkstd::string last = StepFileName(prefix, NUMBER_OF_STEPS);
+    vtksys::SystemTools::RemoveFile(last.c_str());
+
+    vtkSmartPointer<vtkAdiosReader> reader =
+      vtkSmartPointer<vtkAdiosReader>::New();
+    reader->SetReadMethodToBP();
+    reader->SetFileName(StepFileName(prefix, 0).c_str());
+    reader->SetStreaming(1);
+    reader->SetPrefetch(prefetch);
+    reader->Update();
+    Summarize(reader, summary);
+
+    int steps = 1;
+    for (int i = 0; i < 2 * NUMBER_OF_STEPS; i++)
+      {
+      unsigned long mtime = reader->GetMTime();
+      reader->PollForNewTimeSteps();
+      if (reader->GetMTime() == mtime)
+        {
+        if (i == NUMBER_OF_STEPS - 1)
+          {
+          // A step published while the stream is being read.
+          vtksys::SystemTools::CopyFileAlways(data, last.c_str());
+          continue;
+          }
+        break;
+        }
+      reader->Update();
+      Summarize(reader, summary);
+      steps++;
+      }
+    return steps;
+  }
+}
+
+int main(int argc, char* argv[])
+{
+  char* data = vtkTestUtilities::ExpandDataFileName(argc, argv,
+                                                    "Data/adios/pixie3d.bp");
+  char* tempDir = vtkTestUtilities::GetArgOrEnvOrDefault(
+    "-T", argc, argv, "VTK_TEMP_DIR", "Testing/Temporary");
+  vtkstd::string prefix = vtkstd::string(tempDir) + "/AdiosStream";
+  delete [] tempDir;
+
+  for (int i = 0; i < NUMBER_OF_STEPS; i++)
+    {
+    if (!vtksys::SystemTools::CopyFileAlways(data,
+                                             StepFileName(prefix, i).c_str()))
+      {
+      cerr << "Could not write " << StepFileName(prefix, i) << endl;
+      delete [] data;
+      return 1;
+      }
+    }
+
+  int ret = 0;
+  vtkstd::vector<double> expected;
+  vtkstd::vector<double> actual;
+  int steps = Stream(prefix, data, 0, expected);
+  if (steps != NUMBER_OF_STEPS + 1 || expected.empty() || expected[0] <= 0)
+    {
+    cerr << "Read " << steps << " steps instead of " << NUMBER_OF_STEPS + 1
+         << endl;
+    ret = 1;
+    }
+  steps = Stream(prefix, data, 1, actual);
+  if (steps != NUMBER_OF_STEPS + 1)
+    {
+    cerr << "Read " << steps << " steps instead of " << NUMBER_OF_STEPS + 1
+         << " with Prefetch" << endl;
+    ret = 1;
+    }
+  if (expected != actual)
+    {
+    cerr << "Prefetch changed what was read" << endl;
+    ret = 1;
+    }
+
+  delete [] data;
+  return ret;
+}
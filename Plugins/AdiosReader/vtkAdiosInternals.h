@@ -43,6 +43,7 @@
 #include <vtkDoubleArray.h>
 #include <vtkPoints.h>
 #include <vtkExtentTranslator.h>
+#include <vtkDataArraySelection.h>
 #include <vtkCellData.h>
 #include <vtkPointData.h>
 
@@ -335,6 +336,7 @@ public:
     {
     this->HasTimeInformationInVariableNames = false;
     this->ExtentTranslator = NULL;
+    this->VariableSelection = NULL;
     this->File = NULL;
     this->Groups = NULL;
     this->FileName = fileName;
@@ -367,25 +369,18 @@ public:
 #ifdef _NOMPI
     //cout << "NO mpi for the adios reader" << endl;
     this->File = adios_fopen(this->FileName.c_str(), 0);
-    if(this->ExtentTranslator)
-      {
-      this->ExtentTranslator->Delete();
-      this->ExtentTranslator = NULL;
-      }
 #else
     //cout << "Use the mpi communicator for the adios reader" << endl;
     MPI_Comm *comm = NULL;
     vtkMultiProcessController *ctrl =
         vtkMultiProcessController::GetGlobalController();
 
-    // Handle piece management
+    // Handle piece management, one piece per process unless SetPiece()
+    // was called.
     if(!this->ExtentTranslator)
       {
-      this->ExtentTranslator = vtkExtentTranslator::New();
+      this->SetPiece(ctrl->GetLocalProcessId(), ctrl->GetNumberOfProcesses());
       }
-    this->ExtentTranslator->SetPiece(ctrl->GetLocalProcessId());
-    this->ExtentTranslator->SetNumberOfPieces(ctrl->GetNumberOfProcesses());
-    this->ExtentTranslator->SetGhostLevel(0); // FIXME !!!!
 
     vtkMPICommunicator *mpiComm =
         vtkMPICommunicator::SafeDownCast(ctrl->GetCommunicator());
@@ -563,6 +558,63 @@ public:
     return true;
     }
   // --------------------------------------------------------------------------
+  /// Only read the part of the grids of the given piece.
+  void SetPiece(int piece, int numberOfPieces)
+    {
+    if(!this->ExtentTranslator)
+      {
+      this->ExtentTranslator = vtkExtentTranslator::New();
+      }
+    this->ExtentTranslator->SetPiece(piece);
+    this->ExtentTranslator->SetNumberOfPieces(numberOfPieces);
+    this->ExtentTranslator->SetGhostLevel(0); // FIXME !!!!
+    }
+  // --------------------------------------------------------------------------
+  /// Name of the array a variable is read into. Just remove the xxx part of
+  /// /xxx/yy/zzz.
+  static vtkstd::string GetArrayName(const vtkstd::string &variableName)
+    {
+    vtkstd::string arrayName = variableName;
+    vtkstd::string::size_type index = arrayName.find("/", 1);
+    if(index != vtkstd::string::npos)
+      {
+      arrayName = arrayName.substr( index + 1, arrayName.size() - 1 );
+      }
+    return arrayName;
+    }
+  // --------------------------------------------------------------------------
+  /// Whether the data variable is enabled in the VariableSelection, if any.
+  bool IsVariableSelected(const vtkstd::string &variableName)
+    {
+    return !this->VariableSelection ||
+      this->VariableSelection->ArrayIsEnabled(
+        GetArrayName(variableName).c_str());
+    }
+  // --------------------------------------------------------------------------
+  /// Add the arrays of the data variables to the selection. The arrays
+  /// that are already listed keep their status.
+  void FillVariableSelection(vtkDataArraySelection* selection)
+    {
+    if(!this->Open())
+      return;
+
+    vtkstd::string nodesFilter = "/nodes";
+    vtkstd::string cellsFilter = "/cells";
+    AdiosVariableMapIterator varIter = this->Variables.begin();
+    for(; varIter != this->Variables.end(); varIter++)
+      {
+      if( varIter->second.Name.find(nodesFilter) == vtkstd::string::npos
+          && varIter->second.Name.find(cellsFilter) == vtkstd::string::npos )
+        {
+        vtkstd::string arrayName = GetArrayName(varIter->second.Name);
+        if(!selection->ArrayExists(arrayName.c_str()))
+          {
+          selection->AddArray(arrayName.c_str());
+          }
+        }
+      }
+    }
+  // --------------------------------------------------------------------------
   int ExtractTimeStep(vtkstd::string &variableName)
     {
     const std::string prefix("/Timestep_");
@@ -803,7 +855,8 @@ public:
           && varIter->second.Extent[3] == (gridSize[1]-1)
           && varIter->second.Extent[5] == (gridSize[2]-1)
           && varIter->second.Name.find(nodesFilter) == vtkstd::string::npos
-          && varIter->second.Name.find(cellsFilter) == vtkstd::string::npos )
+          && varIter->second.Name.find(cellsFilter) == vtkstd::string::npos
+          && this->IsVariableSelected(varIter->second.Name) )
         {
         vtkDataArray *array = NULL;
         if(varIter->second.IsTimeDependent())
@@ -998,7 +1051,8 @@ public:
           && varIter->second.Extent[3] == size3D[1]
           && varIter->second.Extent[5] == size3D[2]
           && varIter->second.Name.find(nodesFilter) == vtkstd::string::npos
-          && varIter->second.Name.find(cellsFilter) == vtkstd::string::npos )
+          && varIter->second.Name.find(cellsFilter) == vtkstd::string::npos
+          && this->IsVariableSelected(varIter->second.Name) )
         {
         vtkDataArray *array = NULL;
         if(varIter->second.IsTimeDependent())
@@ -1331,14 +1385,8 @@ public:
     array->SetNumberOfComponents(1);
     array->SetNumberOfTuples(nbTuples); // Allocate array memory
 
-    // Create a nice array name (Just remove the xxx part of /xxx/yy/zzz)
-    vtkstd::string arrayName = var.Name;
-    vtkstd::string::size_type index = arrayName.find("/", 1);
-    if(index != vtkstd::string::npos)
-      {
-      arrayName = arrayName.substr( index + 1, arrayName.size() - 1 );
-      }
-    array->SetName(arrayName.c_str());
+    // Create a nice array name
+    array->SetName(GetArrayName(var.Name).c_str());
 
     int groupIdx = var.GroupIndex;
     this->OpenGroup(groupIdx);
@@ -1473,6 +1521,7 @@ public:
   vtkstd::set<int> RealTimeSteps;
 
   vtkExtentTranslator *ExtentTranslator;
+  vtkDataArraySelection *VariableSelection; // Not owned, read all if NULL
   int CurrentWholeExtent[6];
   int CurrentPieceExtent[6];
   bool HasTimeInformationInVariableNames;
@@ -16,8 +16,10 @@
 #include "vtkAdiosInternals.h"
 
 #include "vtkObjectFactory.h"
+#include "vtkDataArraySelection.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
+#include "vtkMultiThreader.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 
 #include <vtksys/ios/sstream>
@@ -26,6 +28,8 @@
 
 #include <sys/stat.h>
 #include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
 
 #include "vtkSmartPointer.h"
 #include "vtkPolyData.h"
@@ -63,10 +67,31 @@ public:
     this->TimeStep = 0;
     this->AdiosInitialized = false;
     this->NeedAdiosInitialization = true;
+    this->ReadMethod = 0;
+    this->Streaming = false;
+    this->Prefetch = false;
+    this->Selection = NULL;
+    this->Piece = 0;
+    this->NumberOfPieces = 1;
+
+    this->MeshFileIsStream = false;
+    this->Step = 0;
+    this->StepTime = 0;
+
+    this->NextFile = NULL;
+    this->NextStepTime = 0;
+    this->NextSelection = vtkDataArraySelection::New();
+    this->NextSelectionTime = 0;
+    this->NextPiece = 0;
+    this->NextNumberOfPieces = 1;
+    this->PrefetchedStep = -1;
+    this->PrefetchThreadId = -1;
+    this->Threader = vtkMultiThreader::New();
     }
   // --------------------------------------------------------------------------
   virtual ~Internals()
     {
+    this->ClearPrefetch();
     if(this->MeshFile)
       {
       delete this->MeshFile;
@@ -76,6 +101,8 @@ public:
       {
       AdiosGlobal::Finalize();
       }
+    this->NextSelection->Delete();
+    this->Threader->Delete();
     }
   // --------------------------------------------------------------------------
   void UpdateFileName(const char* currentFileName)
@@ -83,28 +110,41 @@ public:
     if(!currentFileName)
       return;
 
+    // Check if the filename or the mode has changed
+    if(this->MeshFile && this->FileName == currentFileName &&
+       this->MeshFileIsStream == this->Streaming)
+      {
+      return;
+      }
+
+    this->ClearPrefetch();
     if(this->NeedAdiosInitialization && !this->AdiosInitialized)
       {
       this->AdiosInitialized = true;
       AdiosGlobal::Initialize();
       }
 
-    if(!this->MeshFile)
+    if(this->MeshFile)
+      {
+      delete this->MeshFile;
+      this->MeshFile = NULL;
+      }
+    this->FileName = currentFileName;
+    this->MeshFileIsStream = this->Streaming;
+    this->Step = 0;
+    if(this->Streaming)
+      {
+      // May fail if the simulation did not publish anything yet
+      this->MeshFile = this->OpenStep(0, this->StepTime);
+      }
+    else
       {
       this->MeshFile = new AdiosFile(currentFileName);
 
       // Make sure that file is open and metadata loaded
-      this->MeshFile->Open();
-      }
-    else // Check if the filename has changed
-      {
-      if(strcmp( currentFileName, this->MeshFile->FileName.c_str()) != 0)
+      if(this->MeshFile->Open() && this->Selection)
         {
-        delete this->MeshFile; // not NULL because we are in the else
-        this->MeshFile = new AdiosFile(currentFileName);
-
-        // Make sure that file is open and metadata loaded
-        this->MeshFile->Open();
+        this->MeshFile->FillVariableSelection(this->Selection);
         }
       }
     }
@@ -116,38 +156,60 @@ public:
     // block 0 <=> RectilinearGrid
     // block 1 <=> StructuredGrid
     vtkMultiBlockDataSet* pixieOutput = multiBlock;
-    vtkDataSet* rectilinearGrid = NULL;
-    vtkDataSet* structuredGrid = NULL;
+    vtkSmartPointer<vtkDataSet> rectilinearGrid;
+    vtkSmartPointer<vtkDataSet> structuredGrid;
 
-    int realTimeStep = (int) this->TimeStep;
+    this->WaitForPrefetch();
+    if(!this->MeshFile)
+      return;
+
+    int realTimeStep = (int) (this->MeshFileIsStream ?
+                              this->StepTime : this->TimeStep);
+
+    if(this->HasPrefetchedBlocks())
+      {
+      // The step was read in the background
+      rectilinearGrid = this->NextBlocks[0];
+      structuredGrid = this->NextBlocks[1];
+      }
+    else
+      {
+      // Build geometry and read associted data
+      this->MeshFile->SetPiece(this->Piece, this->NumberOfPieces);
+      this->MeshFile->VariableSelection = this->Selection;
+      rectilinearGrid.TakeReference(
+        this->MeshFile->GetPixieRectilinearGrid(realTimeStep));
+      structuredGrid.TakeReference(
+        this->MeshFile->GetPixieStructuredGrid(realTimeStep));
+      }
+    this->NextBlocks[0] = NULL;
+    this->NextBlocks[1] = NULL;
+    this->PrefetchedStep = -1;
 
-    // Build geometry and read associted data
-    rectilinearGrid = this->MeshFile->GetPixieRectilinearGrid(realTimeStep);
     if(rectilinearGrid)
       {
-//      rectilinearGrid->GetInformation()->Set( vtkDataObject::DATA_TIME_STEPS(),
-//                                              &this->TimeStep, 1);
       pixieOutput->SetBlock(0, rectilinearGrid);
-      rectilinearGrid->FastDelete();
       }
-
-    structuredGrid = this->MeshFile->GetPixieStructuredGrid(realTimeStep);
     if(structuredGrid)
       {
-//      structuredGrid->GetInformation()->Set( vtkDataObject::DATA_TIME_STEPS(),
-//                                             &this->TimeStep, 1);
       pixieOutput->SetBlock(1, structuredGrid);
-      structuredGrid->FastDelete();
       }
-//    pixieOutput->GetInformation()->Set( vtkDataObject::DATA_TIME_STEPS(),
-//                                        &this->TimeStep, 1);
 
     // Close file to release resources
     if(this->MeshFile) this->MeshFile->Close();
+
+    // Overlap the read of the next step with the processing of this one
+    this->StartPrefetch();
     }
   // --------------------------------------------------------------------------
   int GetNumberOfTimeSteps()
     {
+    // A stream only shows its current step
+    if(this->MeshFileIsStream)
+      {
+      return this->MeshFile ? 1 : 0;
+      }
+
     int nbTime = 0;
     if(this->MeshFile)
       {
@@ -164,6 +226,8 @@ public:
     {
     if(this->GetNumberOfTimeSteps() == 0)
       return 0;
+    if(this->MeshFileIsStream)
+      return this->StepTime;
     return this->MeshFile->GetRealTimeStep(idx);
     }
   // --------------------------------------------------------------------------
@@ -177,18 +241,252 @@ public:
     return this->TimeStep;
     }
   // --------------------------------------------------------------------------
-  bool Open()
+  void SetPiece(int piece, int numberOfPieces)
+    {
+    this->Piece = piece;
+    this->NumberOfPieces = numberOfPieces;
+    }
+  // --------------------------------------------------------------------------
+  // Returns true if there is new data to read.
+  bool Poll()
     {
-    return this->MeshFile->Open();
+    if(!this->MeshFileIsStream)
+      {
+      return this->MeshFile && this->MeshFile->Open();
+      }
+
+    this->WaitForPrefetch();
+    if(!this->MeshFile)
+      {
+      // Still waiting for the first step
+      this->MeshFile = this->OpenStep(this->Step, this->StepTime);
+      return this->MeshFile != NULL;
+      }
+    if(!this->NextFile)
+      {
+      this->NextFile = this->OpenStep(this->Step + 1, this->NextStepTime);
+      if(!this->NextFile)
+        {
+        return false;
+        }
+      }
+    delete this->MeshFile;
+    this->MeshFile = this->NextFile;
+    this->NextFile = NULL;
+    this->StepTime = this->NextStepTime;
+    this->Step++;
+    return true;
     }
 
 public:
   bool NeedAdiosInitialization;
+  int ReadMethod;
+  bool Streaming;
+  bool Prefetch;
+  vtkDataArraySelection* Selection;
 
 private:
+  // --------------------------------------------------------------------------
+  // Name of the file of a step of the stream. The staging methods give the
+  // next step each time the same name is opened. With files, the steps are
+  // a series of files, and the last number in the name is the step.
+  vtkstd::string GetStepFileName(int step)
+    {
+    if(this->ReadMethod > 1)
+      {
+      return this->FileName;
+      }
+
+    const char* digits = "0123456789";
+    vtkstd::string::size_type start = this->FileName.find_last_of("/\\");
+    start = (start == vtkstd::string::npos) ? 0 : start + 1;
+    vtkstd::string::size_type end = this->FileName.find_last_of(digits);
+    if(end == vtkstd::string::npos || end < start)
+      {
+      return (step == 0) ? this->FileName : vtkstd::string();
+      }
+    vtkstd::string::size_type begin =
+      this->FileName.find_last_not_of(digits, end);
+    begin = (begin == vtkstd::string::npos || begin < start) ?
+            start : begin + 1;
+
+    vtkstd::string number = this->FileName.substr(begin, end + 1 - begin);
+    char stepNumber[64];
+    sprintf(stepNumber, "%0*d", static_cast<int>(number.size()),
+            atoi(number.c_str()) + step);
+    return this->FileName.substr(0, begin) + stepNumber +
+           this->FileName.substr(end + 1);
+    }
+  // --------------------------------------------------------------------------
+  // Whether the file of a step exists. Opening it is collective with MPI, so
+  // process 0 checks and all the processes follow its answer, even if the
+  // file shows up on their file system at a different time.
+  bool StepIsAvailable(const vtkstd::string& name)
+    {
+    int available = name.empty() ? 0 : 1;
+    bool check = available && this->ReadMethod <= 1;
+#ifndef _NOMPI
+    vtkMultiProcessController* ctrl =
+      vtkMultiProcessController::GetGlobalController();
+    check = check && (!ctrl || ctrl->GetLocalProcessId() == 0);
+#endif
+    if(check)
+      {
+      struct stat fs;
+      available = (stat(name.c_str(), &fs) == 0) ? 1 : 0;
+      }
+#ifndef _NOMPI
+    if(ctrl && ctrl->GetNumberOfProcesses() > 1)
+      {
+      ctrl->Broadcast(&available, 1, 0);
+      }
+#endif
+    return available != 0;
+    }
+  // --------------------------------------------------------------------------
+  // Whether a step was opened by all the processes.
+  static bool OpenedEverywhere(bool opened)
+    {
+    int local = opened ? 1 : 0;
+    int global = local;
+#ifndef _NOMPI
+    vtkMultiProcessController* ctrl =
+      vtkMultiProcessController::GetGlobalController();
+    if(ctrl && ctrl->GetNumberOfProcesses() > 1)
+      {
+      ctrl->AllReduce(&local, &global, 1, vtkCommunicator::MIN_OP);
+      }
+#endif
+    return global != 0;
+    }
+  // --------------------------------------------------------------------------
+  // Open a step of the stream. Returns NULL if it is not available yet. All
+  // the processes must call it, and get the same result.
+  AdiosFile* OpenStep(int step, double &time)
+    {
+    vtkstd::string name = this->GetStepFileName(step);
+    if(!this->StepIsAvailable(name))
+      {
+      return NULL;
+      }
+
+    AdiosFile* file = new AdiosFile(name.c_str());
+    if(!OpenedEverywhere(file->Open()))
+      {
+      delete file;
+      return NULL;
+      }
+    if(this->Selection)
+      {
+      file->FillVariableSelection(this->Selection);
+      }
+    time = (file->GetNumberOfTimeSteps() > 0) ?
+           file->GetRealTimeStep(0) : step;
+    return file;
+    }
+  // --------------------------------------------------------------------------
+  // Open the next step and read its selected variables in the background.
+  // The file is opened here since it is collective with MPI, the reads in
+  // the thread are not.
+  void StartPrefetch()
+    {
+    if(!this->MeshFileIsStream || !this->Prefetch || this->NextFile)
+      {
+      return;
+      }
+    this->NextFile = this->OpenStep(this->Step + 1, this->NextStepTime);
+    if(!this->NextFile)
+      {
+      return;
+      }
+
+    this->NextPiece = this->Piece;
+    this->NextNumberOfPieces = this->NumberOfPieces;
+    this->NextFile->SetPiece(this->Piece, this->NumberOfPieces);
+    if(this->Selection)
+      {
+      this->NextSelection->CopySelections(this->Selection);
+      this->NextSelectionTime = this->Selection->GetMTime();
+      this->NextFile->VariableSelection = this->NextSelection;
+      }
+    this->PrefetchedStep = this->Step + 1;
+    this->PrefetchThreadId =
+      this->Threader->SpawnThread(&Internals::PrefetchThread, this);
+    }
+  // --------------------------------------------------------------------------
+  static VTK_THREAD_RETURN_TYPE PrefetchThread(void* arg)
+    {
+    vtkMultiThreader::ThreadInfo* info =
+      static_cast<vtkMultiThreader::ThreadInfo*>(arg);
+    Internals* self = static_cast<Internals*>(info->UserData);
+    int realTimeStep = (int) self->NextStepTime;
+    self->NextBlocks[0].TakeReference(
+      self->NextFile->GetPixieRectilinearGrid(realTimeStep));
+    self->NextBlocks[1].TakeReference(
+      self->NextFile->GetPixieStructuredGrid(realTimeStep));
+    self->NextFile->Close();
+    return VTK_THREAD_RETURN_VALUE;
+    }
+  // --------------------------------------------------------------------------
+  // The ADIOS read library is not thread safe. Call this before using it.
+  void WaitForPrefetch()
+    {
+    if(this->PrefetchThreadId >= 0)
+      {
+      this->Threader->TerminateThread(this->PrefetchThreadId);
+      this->PrefetchThreadId = -1;
+      }
+    }
+  // --------------------------------------------------------------------------
+  void ClearPrefetch()
+    {
+    this->WaitForPrefetch();
+    if(this->NextFile)
+      {
+      delete this->NextFile;
+      this->NextFile = NULL;
+      }
+    this->NextBlocks[0] = NULL;
+    this->NextBlocks[1] = NULL;
+    this->PrefetchedStep = -1;
+    }
+  // --------------------------------------------------------------------------
+  // Whether the current step was prefetched with the current piece and
+  // selection.
+  bool HasPrefetchedBlocks()
+    {
+    return this->MeshFileIsStream &&
+           this->PrefetchedStep == this->Step &&
+           this->NextPiece == this->Piece &&
+           this->NextNumberOfPieces == this->NumberOfPieces &&
+           (!this->Selection ||
+            this->Selection->GetMTime() <= this->NextSelectionTime);
+    }
+
+private:
+  vtkstd::string FileName;
   AdiosFile* MeshFile;
   double TimeStep;
   bool AdiosInitialized;
+  int Piece;
+  int NumberOfPieces;
+
+  // Stream state
+  bool MeshFileIsStream;
+  int Step;
+  double StepTime;
+
+  // Prefetched step
+  AdiosFile* NextFile;
+  double NextStepTime;
+  vtkDataArraySelection* NextSelection;
+  unsigned long NextSelectionTime;
+  int NextPiece;
+  int NextNumberOfPieces;
+  int PrefetchedStep;
+  vtkSmartPointer<vtkDataSet> NextBlocks[2];
+  vtkMultiThreader* Threader;
+  int PrefetchThreadId;
 };
 //*****************************************************************************
 vtkStandardNewMacro(vtkAdiosReader);
@@ -196,7 +494,11 @@ vtkStandardNewMacro(vtkAdiosReader);
 vtkAdiosReader::vtkAdiosReader()
 {
   this->FileName = NULL;
+  this->Streaming = 0;
+  this->Prefetch = 0;
+  this->VariableSelection = vtkDataArraySelection::New();
   this->Internal = new Internals();
+  this->Internal->Selection = this->VariableSelection;
   this->SetNumberOfInputPorts(0);
   this->SetNumberOfOutputPorts(1);
 }
@@ -210,6 +512,7 @@ vtkAdiosReader::~vtkAdiosReader()
     delete this->Internal;
     this->Internal = NULL;
     }
+  this->VariableSelection->Delete();
 }
 
 //----------------------------------------------------------------------------
@@ -218,6 +521,8 @@ void vtkAdiosReader::PrintSelf(ostream& os, vtkIndent indent)
   this->Superclass::PrintSelf(os, indent);
   os << indent << "FileName: "
      << (this->FileName? this->FileName:"(none)") << "\n";
+  os << indent << "Streaming: " << this->Streaming << "\n";
+  os << indent << "Prefetch: " << this->Prefetch << "\n";
 }
 
 //----------------------------------------------------------------------------
@@ -319,6 +624,8 @@ int vtkAdiosReader::RequestInformation(vtkInformation *, vtkInformationVector**
     vtkWarningMacro( << "FileName must be set");
     return 0;
     }
+  this->Internal->Streaming = (this->Streaming != 0);
+  this->Internal->Prefetch = (this->Prefetch != 0);
   this->Internal->UpdateFileName(this->GetFileName());
 
   // Get information object to fill
@@ -370,6 +677,15 @@ int vtkAdiosReader::RequestData(vtkInformation *, vtkInformationVector** vtkNotU
 {
   vtkInformation *info = outputVector->GetInformationObject(0);
   vtkDataObject* output = info->Get(vtkDataObject::DATA_OBJECT());
+  if(info->Has(vtkStreamingDemandDrivenPipeline::UPDATE_PIECE_NUMBER()) &&
+     info->Has(vtkStreamingDemandDrivenPipeline::UPDATE_NUMBER_OF_PIECES()))
+    {
+    this->Internal->SetPiece(
+      info->Get(vtkStreamingDemandDrivenPipeline::UPDATE_PIECE_NUMBER()),
+      info->Get(vtkStreamingDemandDrivenPipeline::UPDATE_NUMBER_OF_PIECES()));
+    }
+  this->Internal->Streaming = (this->Streaming != 0);
+  this->Internal->Prefetch = (this->Prefetch != 0);
   this->Internal->UpdateFileName(this->GetFileName());
   this->Internal->FillOutput(output);
   return 1;
@@ -392,6 +708,7 @@ void vtkAdiosReader::SetReadMethodToBP()
 {
   AdiosGlobal::SetReadMethodToBP();
   this->Internal->NeedAdiosInitialization = false;
+  this->Internal->ReadMethod = 0;
 }
 
 //----------------------------------------------------------------------------
@@ -399,6 +716,7 @@ void vtkAdiosReader::SetReadMethodToDART()
 {
   AdiosGlobal::SetReadMethodToDART();
   this->Internal->NeedAdiosInitialization = true;
+  this->Internal->ReadMethod = 2;
 }
 
 //----------------------------------------------------------------------------
@@ -406,6 +724,7 @@ void vtkAdiosReader::SetReadMethod(int methodEnum)
 {
   AdiosGlobal::SetReadMethod(methodEnum);
   this->Internal->NeedAdiosInitialization = (methodEnum > 1);
+  this->Internal->ReadMethod = methodEnum;
 }
 
 //----------------------------------------------------------------------------
@@ -417,8 +736,44 @@ void vtkAdiosReader::SetAdiosApplicationId(int id)
 //----------------------------------------------------------------------------
 void vtkAdiosReader::PollForNewTimeSteps()
 {
-  if(this->Internal->Open())
+  if(this->Internal->Poll())
     {
     this->Modified();
     }
 }
+
+//----------------------------------------------------------------------------
+int vtkAdiosReader::GetNumberOfVariableArrays()
+{
+  return this->VariableSelection->GetNumberOfArrays();
+}
+
+//----------------------------------------------------------------------------
+const char* vtkAdiosReader::GetVariableArrayName(int index)
+{
+  return this->VariableSelection->GetArrayName(index);
+}
+
+//----------------------------------------------------------------------------
+int vtkAdiosReader::GetVariableArrayStatus(const char* name)
+{
+  return this->VariableSelection->ArrayIsEnabled(name);
+}
+
+//----------------------------------------------------------------------------
+void vtkAdiosReader::SetVariableArrayStatus(const char* name, int status)
+{
+  if(this->GetVariableArrayStatus(name) == (status != 0))
+    {
+    return;
+    }
+  if(status)
+    {
+    this->VariableSelection->EnableArray(name);
+    }
+  else
+    {
+    this->VariableSelection->DisableArray(name);
+    }
+  this->Modified();
+}
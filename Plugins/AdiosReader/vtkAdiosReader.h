@@ -14,13 +14,28 @@
 =========================================================================*/
 // .NAME vtkAdiosReader - Base class Reader for ADIOS file format.
 // .SECTION Description
+// vtkAdiosReader reads the Pixie grids of an ADIOS file, or of the steps
+// of a running simulation published with a staging read method. Each
+// process only reads its piece of the grids and the variables enabled in
+// the variable selection.
 //
+// In Streaming mode, the reader follows a stream of steps instead of the
+// time steps of a single file. Each call to PollForNewTimeSteps() advances
+// to the next step when one is available. With the staging read methods,
+// the steps are the ones published by the simulation. With the BP file
+// method, a series of files numbered like FileName (for instance
+// pixie.0000.bp, pixie.0001.bp...) stands in for the stream, so that the
+// streaming mode can be tested without a simulation. When Prefetch is on,
+// the next step is opened as soon as the current one has been read, and
+// its selected variables are read in the background while the current
+// step is processed.
 
 #ifndef __vtkAdiosReader_h
 #define __vtkAdiosReader_h
 
 #include "vtkCompositeDataSetAlgorithm.h"
 
+class vtkDataArraySelection;
 class vtkDataSetAttributes;
 class vtkInformationVector;
 class vtkInformation;
@@ -49,9 +64,29 @@ public:
 
   // Description:
   // Modified the reader to request a new read (from stage), so you can
-  // move forward in time.
+  // move forward in time. In Streaming mode, advance to the next step of
+  // the stream if there is one.
   void PollForNewTimeSteps();
 
+  // Description:
+  // Follow a stream of steps. Off by default.
+  vtkSetMacro(Streaming, int);
+  vtkGetMacro(Streaming, int);
+  vtkBooleanMacro(Streaming, int);
+
+  // Description:
+  // In Streaming mode, read the next step in the background. Off by default.
+  vtkSetMacro(Prefetch, int);
+  vtkGetMacro(Prefetch, int);
+  vtkBooleanMacro(Prefetch, int);
+
+  // Description:
+  // Get/Set which data variables are read. All are by default.
+  int GetNumberOfVariableArrays();
+  const char* GetVariableArrayName(int index);
+  int GetVariableArrayStatus(const char* name);
+  void SetVariableArrayStatus(const char* name, int status);
+
   // Description:
   // Test whether the file with the given name can be read by this
   // reader.
@@ -88,6 +123,10 @@ protected:
   // The input file's name.
   char* FileName;
 
+  int Streaming;
+  int Prefetch;
+  vtkDataArraySelection* VariableSelection;
+
 //BTX
 
 private:
@@ -0,0 +1,180 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestH5PartReaderPieces.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Writes an H5Part file and reads it back with vtkH5PartReader on every MPI
+// process, and checks that:
+//  - each process reads its own contiguous slice of the particles, and the
+//    slices cover all of them,
+//  - the components of the coordinates and of a vector are interleaved in
+//    the right order, including a component stored with another type,
+//  - a time step with fewer particles than processes leaves processes
+//    without particles, which still take part in the collective reads.
+// Run it on 2 MPI processes.
+
+#include "vtkDataArray.h"
+#include "vtkH5PartReader.h"
+#include "vtkMPIController.h"
+#include "vtkPointData.h"
+#include "vtkPolyData.h"
+#include "vtkSmartPointer.h"
+#include "vtkStreamingDemandDrivenPipeline.h"
+#include "vtkTestUtilities.h"
+
+#include "H5Part.h"
+
+#include <vtksys/SystemTools.hxx>
+#include <vtkstd/string>
+#include <vtkstd/vector>
+
+// Odd, so that the slices of the processes differ in size.
+#define NUMBER_OF_PARTICLES 1001
+
+namespace
+{
+  // Particle i of a step with n particles. The coordinates, a vector with a
+  // last component of another type, and an id.
+  bool WriteStep(H5PartFile* file, int step, h5part_int64_t n)
+  {
+    vtkstd::vector<h5part_float64_t> x(n), y(n), z(n), v0(n), v1(n);
+    vtkstd::vector<h5part_int64_t> v2(n), id(n);
+    for (h5part_int64_t i = 0; i < n; i++)
+      {
+      x[i] = i;
+      y[i] = 2.0 * i;
+      z[i] = -1.0 * i;
+      v0[i] = 0.5 * i;
+      v1[i] = 0.25 * i;
+      v2[i] = 3 * i;
+      id[i] = 1000 * step + i;
+      }
+    h5part_float64_t time = step;
+    return H5PartSetStep(file, step) == H5PART_SUCCESS &&
+      H5PartWriteStepAttrib(file, "TimeValue", H5PART_FLOAT64, &time, 1) ==
+        H5PART_SUCCESS &&
+      H5PartSetNumParticles(file, n) == H5PART_SUCCESS &&
+      H5PartWriteDataFloat64(file, "Coords_0", &x[0]) == H5PART_SUCCESS &&
+      H5PartWriteDataFloat64(file, "Coords_1", &y[0]) == H5PART_SUCCESS &&
+      H5PartWriteDataFloat64(file, "Coords_2", &z[0]) == H5PART_SUCCESS &&
+      H5PartWriteDataFloat64(file, "Velocity_0", &v0[0]) == H5PART_SUCCESS &&
+      H5PartWriteDataFloat64(file, "Velocity_1", &v1[0]) == H5PART_SUCCESS &&
+      H5PartWriteDataInt64(file, "Velocity_2", &v2[0]) == H5PART_SUCCESS &&
+      H5PartWriteDataInt64(file, "Id", &id[0]) == H5PART_SUCCESS;
+  }
+
+  // Read a time step and check the particles of this process.
+  bool CheckStep(vtkH5PartReader* reader, int step, vtkIdType n,
+                 int procId, int numProcs)
+  {
+    vtkStreamingDemandDrivenPipeline* sddp =
+      vtkStreamingDemandDrivenPipeline::SafeDownCast(reader->GetExecutive());
+    reader->UpdateInformation();
+    sddp->SetUpdateTimeStep(0, step);
+    reader->Update();
+    vtkPolyData* output = reader->GetOutput();
+
+    vtkIdType start = (n * procId) / numProcs;
+    vtkIdType count = (n * (procId + 1)) / numProcs - start;
+    if (output->GetNumberOfPoints() != count)
+      {
+      cerr << "Process " << procId << " read "
+           << output->GetNumberOfPoints() << " particles of step " << step
+           << " instead of " << count << endl;
+      return false;
+      }
+    vtkDataArray* velocity = output->GetPointData()->GetArray("Velocity");
+    vtkDataArray* id = output->GetPointData()->GetArray("Id");
+    if (!velocity || velocity->GetNumberOfComponents() != 3 ||
+        velocity->GetNumberOfTuples() != count ||
+        !id || id->GetNumberOfTuples() != count)
+      {
+      cerr << "Process " << procId << " did not read the arrays of step "
+           << step << endl;
+      return false;
+      }
+    for (vtkIdType j = 0; j < count; j++)
+      {
+      double i = static_cast<double>(start + j);
+      double x[3], v[3];
+      output->GetPoint(j, x);
+      velocity->GetTuple(j, v);
+      if (x[0] != i || x[1] != 2.0 * i || x[2] != -1.0 * i ||
+          v[0] != 0.5 * i || v[1] != 0.25 * i || v[2] != 3.0 * i ||
+          id->GetTuple1(j) != 1000.0 * step + i)
+        {
+        cerr << "Process " << procId << " read particle " << j
+             << " of step " << step << " wrong, expected particle "
+             << start + j << endl;
+        return false;
+        }
+      }
+    return true;
+  }
+}
+
+int main(int argc, char* argv[])
+{
+  vtkMPIController* controller = vtkMPIController::New();
+  controller->Initialize(&argc, &argv);
+  vtkMultiProcessController::SetGlobalController(controller);
+  int numProcs = controller->GetNumberOfProcesses();
+  int procId = controller->GetLocalProcessId();
+
+  char* tempDir = vtkTestUtilities::GetArgOrEnvOrDefault(
+    "-T", argc, argv, "VTK_TEMP_DIR", "Testing/Temporary");
+  vtkstd::string fileName = vtkstd::string(tempDir) + "/Pieces.h5part";
+  delete [] tempDir;
+
+  // A step with many particles, and one with fewer than processes.
+  int status = 1;
+  if (procId == 0)
+    {
+    H5PartFile* file = H5PartOpenFile(fileName.c_str(), H5PART_WRITE);
+    status = file && WriteStep(file, 0, NUMBER_OF_PARTICLES) &&
+      WriteStep(file, 1, numProcs - 1);
+    if (file)
+      {
+      H5PartCloseFile(file);
+      }
+    }
+  controller->Broadcast(&status, 1, 0);
+  if (!status)
+    {
+    cerr << "Could not write " << fileName.c_str() << endl;
+    vtkMultiProcessController::SetGlobalController(0);
+    controller->Finalize();
+    controller->Delete();
+    return 1;
+    }
+
+  bool ok = true;
+  {
+  vtkSmartPointer<vtkH5PartReader> reader =
+    vtkSmartPointer<vtkH5PartReader>::New();
+  reader->SetController(controller);
+  reader->SetFileName(const_cast<char*>(fileName.c_str()));
+  ok = CheckStep(reader, 0, NUMBER_OF_PARTICLES, procId, numProcs);
+  ok = CheckStep(reader, 1, numProcs - 1, procId, numProcs) && ok;
+  }
+
+  int localStatus = ok ? 1 : 0;
+  controller->AllReduce(&localStatus, &status, 1, vtkCommunicator::MIN_OP);
+  if (procId == 0)
+    {
+    vtksys::SystemTools::RemoveFile(fileName.c_str());
+    }
+  vtkMultiProcessController::SetGlobalController(0);
+  controller->Finalize();
+  controller->Delete();
+  return status ? 0 : 1;
+}
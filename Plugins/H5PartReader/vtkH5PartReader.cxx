@@ -77,6 +77,10 @@
 #include "vtkMultiProcessController.h"
 vtkCxxSetObjectMacro(vtkH5PartReader, Controller, vtkMultiProcessController);
 #endif
+#if defined(VTK_USE_MPI) && defined(PARALLEL_IO)
+#include "vtkMPI.h"
+#include "vtkMPICommunicator.h"
+#endif
 
 #include <algorithm>
 
@@ -109,36 +113,51 @@ static hid_t H5PartGetNativeDatasetType(H5PartFile *f, const char *name)
 }
 
 //----------------------------------------------------------------------------
-static hid_t H5PartGetDiskShape(H5PartFile *f, hid_t dataset)
+// Select the particles [start, start+count) of a dataset. Processes without
+// particles still take part in collective reads with an empty selection.
+static hid_t H5PartGetSliceShape(hid_t dataset, hsize_t start, hsize_t count)
 {
   hid_t space = H5Dget_space(dataset);
-  if (H5PartHasView(f))
-    {
-    int r;
-    hsize_t stride, count;
-    hsize_t range[2];
-    /* so, is this selection inclusive or exclusive? */
-    range[0]=f->viewstart;
-    range[1]=f->viewend;
-    count = range[1]-range[0]; /* to be inclusive */
-    stride=1;
-    /* now we select a subset */
-    if (f->diskshape>0)
+  if (count==0)
+    {
+    H5Sselect_none(space);
+    return space;
+    }
+  hsize_t stride = 1;
+  if (H5Sselect_hyperslab(space,H5S_SELECT_SET,&start,&stride,&count,NULL)<0)
+    {
+    fprintf(stderr,"Abort: Selection Failed!\n");
+    }
+  return space;
+}
+
+//----------------------------------------------------------------------------
+// Interleave the components, read one after the other into soa, into the
+// tuples of out. Each tuple is written once, in order.
+template <class T>
+void vtkH5PartInterleave(const T* soa, T* out, vtkIdType Nt, int Nc)
+{
+  if (Nc==3)
+    {
+    const T* x = soa;
+    const T* y = soa + Nt;
+    const T* z = soa + 2*Nt;
+    for (vtkIdType i=0; i<Nt; ++i)
       {
-      r=H5Sselect_hyperslab(f->diskshape,H5S_SELECT_SET,
-        range/* only using first element */,
-        &stride,&count,NULL);
+      out[0] = x[i];
+      out[1] = y[i];
+      out[2] = z[i];
+      out += 3;
       }
-    /* now we select a subset */
-    r=H5Sselect_hyperslab(space,H5S_SELECT_SET,
-      range,&stride,&count,NULL);
-    if (r<0)
+    return;
+    }
+  for (vtkIdType i=0; i<Nt; ++i)
+    {
+    for (int c=0; c<Nc; ++c)
       {
-      fprintf(stderr,"Abort: Selection Failed!\n");
-      return space;
+      *out++ = soa[c*Nt + i];
       }
     }
-  return space;
 }
 
 //----------------------------------------------------------------------------
@@ -255,7 +274,19 @@ int vtkH5PartReader::OpenFile()
 
   if (!this->H5FileId)
     {
-    this->H5FileId = H5PartOpenFile(this->FileName, H5PART_READ);
+#if defined(VTK_USE_MPI) && defined(PARALLEL_IO)
+    vtkMPICommunicator* communicator = this->Controller?
+      vtkMPICommunicator::SafeDownCast(this->Controller->GetCommunicator()) : 0;
+    if (communicator && this->Controller->GetNumberOfProcesses()>1)
+      {
+      this->H5FileId = H5PartOpenFileParallel(this->FileName, H5PART_READ,
+        *communicator->GetMPIComm()->GetHandle());
+      }
+    else
+#endif
+      {
+      this->H5FileId = H5PartOpenFile(this->FileName, H5PART_READ);
+      }
     this->FileOpenedTime.Modified();
     }
 
@@ -460,33 +491,6 @@ int GetVTKDataType(int datatype)
   return VTK_VOID;
 }
 
-//----------------------------------------------------------------------------
-//A Convenience Macro which does what we want for any dataset type
-#define H5PartReadDataArray(null, T2)  \
-  dataarray->SetNumberOfComponents(Nc); \
-  dataarray->SetNumberOfTuples(Nt);                           \
-  dataarray->SetName(rootname.c_str());                       \
-  herr_t r;                                                   \
-  hsize_t     count1_mem[] = { Nt*Nc };                       \
-  hsize_t     count2_mem[] = { Nt };                          \
-  hsize_t     offset_mem[] = { 0 };                           \
-  hsize_t     stride_mem[] = { Nc };                          \
-  for (c=0; c<Nc; c++) {                                      \
-    const char *name = arraylist[c].c_str();                  \
-    hid_t dataset   = H5Dopen(H5FileId->timegroup,name);      \
-    hid_t diskshape = H5PartGetDiskShape(H5FileId,dataset);   \
-    hid_t memspace = H5Screate_simple(1, count1_mem, NULL);   \
-    offset_mem[0] = c;                                        \
-    r = H5Sselect_hyperslab(                                  \
-      memspace, H5S_SELECT_SET,                               \
-      offset_mem, stride_mem, count2_mem, NULL);              \
-      H5Dread(dataset, null##T2, memspace,                    \
-      diskshape, H5P_DEFAULT, dataarray->GetVoidPointer(0));  \
-    if (memspace!=H5S_ALL) H5Sclose(memspace);                \
-    if (diskshape!=H5S_ALL) H5Sclose(diskshape);              \
-    H5Dclose(dataset);                                        \
-  }
-
 //----------------------------------------------------------------------------
 /*
 template <class T1, class T2>
@@ -581,11 +585,10 @@ int vtkH5PartReader::RequestData(
     this->UpdatePiece = this->Controller->GetLocalProcessId();
     this->UpdateNumPieces = this->Controller->GetNumberOfProcesses();
   }
+#else
+  this->UpdatePiece = outInfo->Get(vtkStreamingDemandDrivenPipeline::UPDATE_PIECE_NUMBER());
+  this->UpdateNumPieces = outInfo->Get(vtkStreamingDemandDrivenPipeline::UPDATE_NUMBER_OF_PIECES());
 #endif
-  //
-  // Parallel read currently not implemented, just read on process zero and
-  // exit quick on the others. @TODO : Add in Slab selection code
-  if (this->UpdatePiece>0) return 1;
   //
   typedef vtkstd::map< vtkstd::string, vtkstd::vector<vtkstd::string> > FieldMap;
   FieldMap scalarFields;
@@ -717,8 +720,17 @@ int vtkH5PartReader::RequestData(
 
   // Set the TimeStep on the H5 file
   H5PartSetStep(this->H5FileId, this->ActualTimeStep);
-  // Get the number of points for this step
-  vtkIdType Nt = H5PartGetNumParticles(this->H5FileId);
+  // Get the number of points for this step, and the slice read by this piece
+  vtkIdType Ntotal = H5PartGetNumParticles(this->H5FileId);
+  int numPieces = this->UpdateNumPieces>0 ? this->UpdateNumPieces : 1;
+  int piece = this->UpdatePiece>=0 ? this->UpdatePiece : 0;
+  vtkIdType Nstart = (Ntotal*piece)/numPieces;
+  vtkIdType Nt = (Ntotal*(piece+1))/numPieces - Nstart;
+  if (piece>=numPieces)
+    {
+    Nstart = Ntotal;
+    Nt = 0;
+    }
 
   // Setup arrays for reading data
   vtkSmartPointer<vtkPoints>    points = vtkSmartPointer<vtkPoints>::New();
@@ -742,54 +754,40 @@ int vtkH5PartReader::RequestData(
       dataarray->SetNumberOfTuples(Nt);
       dataarray->SetName(rootname.c_str());
 
-      // now read the data components.
-      hsize_t count1_mem[] = { Nt*Nc };
-      hsize_t count2_mem[] = { Nt };
-      hsize_t offset_mem[] = { 0 };
-      hsize_t stride_mem[] = { Nc };
+      // Read each component contiguously, converted by HDF5 to the type of
+      // the array, one after the other. A scalar is read in place, the
+      // components of a vector are interleaved afterwards.
+      vtkSmartPointer<vtkDataArray> soa = dataarray;
+      if (Nc>1)
+        {
+        soa.TakeReference(vtkDataArray::CreateDataArray(vtk_datatype));
+        soa->SetNumberOfTuples(Nt*Nc);
+        }
+      hsize_t count_mem[] = { static_cast<hsize_t>(Nt>0 ? Nt : 1) };
+      hid_t memspace = H5Screate_simple(1, count_mem, NULL);
+      if (Nt==0)
+        {
+        H5Sselect_none(memspace);
+        }
       for (int c=0; c<Nc; c++)
         {
         const char *name = arraylist[c].c_str();
         hid_t dataset   = H5Dopen(H5FileId->timegroup,name);
-        hid_t diskshape = H5PartGetDiskShape(H5FileId,dataset);
-        hid_t memspace = H5Screate_simple(1, count1_mem, NULL);
-        hid_t component_datatype = H5PartGetNativeDatasetType(H5FileId, name);
-        offset_mem[0] = c;
-        H5Sselect_hyperslab(
-          memspace, H5S_SELECT_SET,
-          offset_mem, stride_mem, count2_mem, NULL);
-        if (component_datatype == datatype)
-          {
-          H5Dread(dataset, datatype, memspace,
-            diskshape, H5P_DEFAULT, dataarray->GetVoidPointer(0));
-          }
-        else
-          {
-          // read data into a temporary array of the right type and then copy it
-          // over to the "dataarray".
-          // This can be optimized to create a single component array. But I
-          // don't understand the stride/offset stuff too well to fix that.
-          vtkDataArray* temparray =
-            vtkDataArray::CreateDataArray(GetVTKDataType(component_datatype));
-          temparray->SetNumberOfComponents(Nc);
-          temparray->SetNumberOfTuples(Nt);
-          H5Sselect_hyperslab(
-            memspace, H5S_SELECT_SET,
-            offset_mem, stride_mem, count2_mem, NULL);
-          H5Dread(dataset, component_datatype, memspace,
-            diskshape, H5P_DEFAULT, temparray->GetVoidPointer(0));
-          dataarray->CopyComponent(c, temparray, c);
-          temparray->Delete();
-          }
-        if (memspace!=H5S_ALL)
-          {
-          H5Sclose(memspace);
-          }
-        if (diskshape!=H5S_ALL)
+        hid_t diskshape = H5PartGetSliceShape(dataset, Nstart, Nt);
+        H5Dread(dataset, datatype, memspace, diskshape,
+          H5FileId->xfer_prop, Nt>0 ? soa->GetVoidPointer(c*Nt) : NULL);
+        H5Sclose(diskshape);
+        H5Dclose(dataset);
+        }
+      H5Sclose(memspace);
+      if (Nc>1)
+        {
+        switch (vtk_datatype)
           {
-          H5Sclose(diskshape);
+          vtkTemplateMacro(vtkH5PartInterleave(
+            static_cast<VTK_TT*>(soa->GetVoidPointer(0)),
+            static_cast<VTK_TT*>(dataarray->GetVoidPointer(0)), Nt, Nc));
           }
-        H5Dclose(dataset);
         }
       }
     else
@@ -36,6 +36,12 @@
 // .SECTION Description
 // vtkH5PartReader reads compatible with H5Part : documented here
 // http://amas.web.psi.ch/docs/H5Part-doc/h5part.html 
+//
+// In parallel, each process reads a contiguous slice of the particles of the
+// requested time step. When HDF5 is built with MPI-IO support, the file is
+// opened on all the processes of the controller and the slices are read
+// with collective transfers, so all the processes must update the reader
+// together.
 // .SECTION Thanks
 // John Bidiscombe of
 // CSCS - Swiss National Supercomputing Centre for creating and contributing
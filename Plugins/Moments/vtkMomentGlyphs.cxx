@@ -33,6 +33,7 @@
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
 #include "vtkPolyData.h"
+#include "vtkPVThreadedGlypher.h"
 #include "vtkTransformFilter.h"
 #include "vtkUnsignedCharArray.h"
 
@@ -128,6 +129,10 @@ int vtkMomentGlyphs::RequestData(vtkInformation *vtkNotUsed(request),
 
   vtkSmartPointer<vtkPolyData> glyphs;
   glyphs = this->MakeGlyphs(workingInput, inputArray);
+  if (!glyphs)
+    {
+    return 0;
+    }
 
   output->ShallowCopy(glyphs);
 
@@ -271,9 +276,27 @@ vtkSmartPointer<vtkPolyData> vtkMomentGlyphs::MakeGlyphs(
                                   attributeType);
     }
 
-  glyph->Update();
-
-  vtkSmartPointer<vtkPolyData> result = glyph->GetOutput();
+  // Large inputs are glyphed in chunks on several threads, with the same
+  // threshold as vtkPVGlyphFilter. There is one glyph per cell, so small
+  // inputs go through the pipeline as before.
+  vtkSmartPointer<vtkPolyData> result;
+  VTK_CREATE(vtkPVThreadedGlypher, glypher);
+  if (glypher->GetNumberOfChunks(input->GetNumberOfCells()) > 1)
+    {
+    cellCenters->Update();
+    sourceTransform->Update();
+    result = vtkSmartPointer<vtkPolyData>::New();
+    if (!glypher->Glyph(glyph, cellCenters->GetOutput(), result))
+      {
+      vtkErrorMacro("Could not generate the glyphs.");
+      return NULL;
+      }
+    }
+  else
+    {
+    glyph->Update();
+    result = glyph->GetOutput();
+    }
   // Modifying the output of a filter is not a great idea, but all we are
   // going to do is a shallow copy.
   result->GetPointData()->RemoveArray("ScaleFactors");
@@ -0,0 +1,167 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestDepthSortPainter.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Sorts translucent vertices with vtkDepthSortPainter while the camera
+// turns and checks:
+//  - that the radix sort gives the same order as vtkDepthSortPolyData,
+//  - that the order is reused, fixed up incrementally or sorted again
+//    depending on how far the camera turned,
+//  - that changing the settings of vtkDepthSortPolyData sorts again.
+
+#include "vtkActor.h"
+#include "vtkCamera.h"
+#include "vtkCellArray.h"
+#include "vtkDepthSortPainter.h"
+#include "vtkDepthSortPolyData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkProperty.h"
+#include "vtkRenderer.h"
+#include "vtkSmartPointer.h"
+
+#include <vtkstd/vector>
+
+#define NUMBER_OF_POINTS 1000
+
+namespace
+{
+  // Gives access to PrepareForRendering(), which does the sort.
+  class TestPainter : public vtkDepthSortPainter
+  {
+  public:
+    static TestPainter* New() { return new TestPainter; }
+    void Prepare(vtkRenderer* renderer, vtkActor* actor)
+    {
+      this->PrepareForRendering(renderer, actor);
+    }
+  };
+
+  // The first point of every vertex, in order.
+  vtkstd::vector<vtkIdType> GetOrder(vtkPolyData* polyData)
+  {
+    vtkstd::vector<vtkIdType> order;
+    vtkCellArray* verts = polyData ? polyData->GetVerts() : 0;
+    if (verts)
+      {
+      vtkIdType npts;
+      vtkIdType* pts;
+      for (verts->InitTraversal(); verts->GetNextCell(npts, pts);)
+        {
+        order.push_back(npts > 0 ? pts[0] : -1);
+        }
+      }
+    return order;
+  }
+
+  // Sort with the painter and check what it did, and that the order is
+  // the one of vtkDepthSortPolyData when the cells were sorted.
+  bool Check(const char* name, TestPainter* painter, vtkPolyData* input,
+             vtkRenderer* renderer, vtkActor* actor, int sortType)
+  {
+    painter->Prepare(renderer, actor);
+    if (painter->GetLastSortType() != sortType)
+      {
+      cerr << "The sort was of type " << painter->GetLastSortType()
+           << " instead of " << sortType << " " << name << endl;
+      return false;
+      }
+    if (sortType != vtkDepthSortPainter::SORT_INCREMENTAL &&
+        sortType != vtkDepthSortPainter::SORT_FULL)
+      {
+      return true;
+      }
+
+    vtkSmartPointer<vtkDepthSortPolyData> filter =
+      vtkSmartPointer<vtkDepthSortPolyData>::New();
+    filter->SetInput(input);
+    filter->SetCamera(renderer->GetActiveCamera());
+    filter->SetProp3D(actor);
+    filter->SetDirectionToBackToFront();
+    filter->SetDepthSortMode(
+      painter->GetDepthSortPolyData()->GetDepthSortMode());
+    filter->Update();
+    if (GetOrder(vtkPolyData::SafeDownCast(painter->GetOutput())) !=
+        GetOrder(filter->GetOutput()))
+      {
+      cerr << "The order differs from vtkDepthSortPolyData " << name << endl;
+      return false;
+      }
+    return true;
+  }
+}
+
+int main(int, char**)
+{
+  // The points are one unit apart along the view direction and close to
+  // its axis, so that their order does not depend on rounding.
+  vtkSmartPointer<vtkPoints> points = vtkSmartPointer<vtkPoints>::New();
+  vtkSmartPointer<vtkCellArray> verts = vtkSmartPointer<vtkCellArray>::New();
+  for (vtkIdType i = 0; i < NUMBER_OF_POINTS; i++)
+    {
+    double z = static_cast<double>((i * 7919) % NUMBER_OF_POINTS);
+    double x = 0.2 * ((i * 31) % 11) / 10.0 - 0.1;
+    double y = 0.2 * ((i * 17) % 13) / 12.0 - 0.1;
+    points->InsertNextPoint(x, y, z);
+    verts->InsertNextCell(1, &i);
+    }
+  vtkSmartPointer<vtkPolyData> input = vtkSmartPointer<vtkPolyData>::New();
+  input->SetPoints(points);
+  input->SetVerts(verts);
+
+  vtkSmartPointer<vtkActor> actor = vtkSmartPointer<vtkActor>::New();
+  actor->GetProperty()->SetOpacity(0.5);
+  vtkSmartPointer<vtkRenderer> renderer = vtkSmartPointer<vtkRenderer>::New();
+  vtkCamera* camera = renderer->GetActiveCamera();
+  camera->SetFocalPoint(0.0, 0.0, NUMBER_OF_POINTS / 2);
+  camera->SetPosition(0.0, 0.0, 4 * NUMBER_OF_POINTS);
+
+  vtkSmartPointer<TestPainter> painter = vtkSmartPointer<TestPainter>::New();
+  painter->SetInput(input);
+
+  bool ok = Check("the first time", painter, input, renderer, actor,
+                  vtkDepthSortPainter::SORT_FULL);
+  ok = Check("when nothing changed", painter, input, renderer, actor,
+             vtkDepthSortPainter::SORT_NONE) && ok;
+  camera->Azimuth(0.2);
+  ok = Check("for a small turn", painter, input, renderer, actor,
+             vtkDepthSortPainter::SORT_REUSED) && ok;
+  camera->Azimuth(5.0);
+  ok = Check("for a medium turn", painter, input, renderer, actor,
+             vtkDepthSortPainter::SORT_INCREMENTAL) && ok;
+  camera->Azimuth(40.0);
+  ok = Check("for a large turn", painter, input, renderer, actor,
+             vtkDepthSortPainter::SORT_FULL) && ok;
+
+  // Other settings of the filter invalidate the order of the radix sort,
+  // the filter itself sorts by bounds center.
+  painter->GetDepthSortPolyData()->SetDepthSortModeToBoundsCenter();
+  ok = Check("after the sort mode changed", painter, input, renderer, actor,
+             vtkDepthSortPainter::SORT_FULL) && ok;
+  camera->Azimuth(0.2);
+  ok = Check("for a small turn sorted by the filter", painter, input,
+             renderer, actor, vtkDepthSortPainter::SORT_FULL) && ok;
+  painter->GetDepthSortPolyData()->SetDepthSortModeToFirstPoint();
+  ok = Check("after the sort mode changed back", painter, input, renderer,
+             actor, vtkDepthSortPainter::SORT_FULL) && ok;
+  camera->Azimuth(0.2);
+  ok = Check("for a small turn after the sort mode changed back", painter,
+             input, renderer, actor, vtkDepthSortPainter::SORT_REUSED) && ok;
+
+  // The input changed.
+  input->Modified();
+  ok = Check("after the input changed", painter, input, renderer, actor,
+             vtkDepthSortPainter::SORT_FULL) && ok;
+
+  return ok ? 0 : 1;
+}
@@ -48,18 +48,434 @@
 #include "vtkProperty.h"
 #include "vtkDepthSortPolyData.h"
 #include "vtkScalarsToColors.h"
+#include "vtkMultiThreader.h"
+#include "vtkSmartPointer.h"
+#include "vtkTimerLog.h"
 
 #include <vtkstd/vector>
 #include <vtkstd/algorithm>
 #include <functional>
 
 #include <cmath>
+#include <cstring>
 #include "vtkImageData.h"
 #include "vtkPNGWriter.h"
 #include "vtkPointData.h"
 #include "vtkCellData.h"
 #include "vtkPolyData.h"
 
+// The radix sort uses 8 bit digits. Below VTK_DEPTH_SORT_MIN_THREADED cells,
+// it runs on a single thread. An incremental fix up gives up after
+// VTK_DEPTH_SORT_FIXUP_MOVES moves per cell on average.
+#define VTK_DEPTH_SORT_RADIX_BUCKETS 256
+#define VTK_DEPTH_SORT_MIN_THREADED 65536
+#define VTK_DEPTH_SORT_FIXUP_MOVES 8
+
+//-----------------------------------------------------------------------------
+// Turn a depth into a key such that increasing keys are decreasing depths,
+// that is back to front. The float bits are flipped so that they compare
+// as unsigned integers in the same order as the floats.
+static inline vtkTypeUInt32 vtkDepthSortKey(double depth)
+{
+  float value = static_cast<float>(depth);
+  vtkTypeUInt32 bits;
+  memcpy(&bits, &value, sizeof(bits));
+  bits = (bits & 0x80000000u) ? ~bits : (bits | 0x80000000u);
+  return ~bits;
+}
+
+//-----------------------------------------------------------------------------
+// Sorts the cells of one cell array by decreasing depth of their first
+// point, with a least significant digit radix sort. The keys, histograms
+// and scatters are computed by several threads, each over a contiguous range
+// of the cells.
+class vtkDepthSortJob
+{
+public:
+  enum { KEYS, COUNT, SCATTER };
+
+  vtkDepthSortJob(vtkIdType size)
+    {
+    this->Size = size;
+    this->NumberOfThreads = 1;
+    if (size >= VTK_DEPTH_SORT_MIN_THREADED)
+      {
+      this->Threader = vtkSmartPointer<vtkMultiThreader>::New();
+      this->NumberOfThreads = this->Threader->GetNumberOfThreads();
+      }
+    this->Counts.resize(this->NumberOfThreads * VTK_DEPTH_SORT_RADIX_BUCKETS);
+    this->Source = 0;
+    this->Phase = KEYS;
+    this->Shift = 0;
+    }
+
+  // Run a phase on all the threads.
+  void Execute(int phase)
+    {
+    this->Phase = phase;
+    if (this->NumberOfThreads == 1)
+      {
+      this->Run(0);
+      return;
+      }
+    this->Threader->SetNumberOfThreads(this->NumberOfThreads);
+    this->Threader->SetSingleMethod(vtkDepthSortJob::Thread, this);
+    this->Threader->SingleMethodExecute();
+    }
+
+  static VTK_THREAD_RETURN_TYPE Thread(void* arg)
+    {
+    vtkMultiThreader::ThreadInfo* info
+      = static_cast<vtkMultiThreader::ThreadInfo*>(arg);
+    static_cast<vtkDepthSortJob*>(info->UserData)->Run(info->ThreadID);
+    return VTK_THREAD_RETURN_VALUE;
+    }
+
+  void Run(int thread);
+
+  // Sort the keys of Values[Source] and leave the result in Values[0].
+  void Sort();
+
+  // Insertion sort of nearly sorted keys. Returns false, leaving the keys
+  // partially sorted, when more than budget moves are needed.
+  bool FixUp(vtkIdType budget);
+
+  vtkIdType Size;
+  int NumberOfThreads;
+  int Phase;
+  int Shift;
+  int Source;
+  vtkSmartPointer<vtkMultiThreader> Threader;
+
+  const vtkIdType* Connectivity;
+  const vtkIdType* Offsets;
+  vtkDataArray* Points;
+  double Vector[3];
+  double Origin[3];
+
+  vtkstd::vector<vtkTypeUInt32> Keys[2];
+  vtkstd::vector<vtkIdType> Values[2];
+  vtkstd::vector<vtkIdType> Counts;
+};
+
+//-----------------------------------------------------------------------------
+template <class T>
+void vtkDepthSortComputeKeys(const T* points, vtkDepthSortJob* job,
+  vtkIdType begin, vtkIdType end)
+{
+  const vtkIdType* values = &job->Values[0][0];
+  vtkTypeUInt32* keys = &job->Keys[0][0];
+  const double* vector = job->Vector;
+  const double* origin = job->Origin;
+  for (vtkIdType i = begin; i < end; ++i)
+    {
+    const vtkIdType* cell = job->Connectivity + job->Offsets[values[i]];
+    double depth = 0.0;
+    if (cell[0] > 0)
+      {
+      const T* x = points + 3 * cell[1];
+      depth = (x[0] - origin[0]) * vector[0] + (x[1] - origin[1]) * vector[1]
+        + (x[2] - origin[2]) * vector[2];
+      }
+    keys[i] = vtkDepthSortKey(depth);
+    }
+}
+
+//-----------------------------------------------------------------------------
+void vtkDepthSortJob::Run(int thread)
+{
+  vtkIdType begin = (this->Size * thread) / this->NumberOfThreads;
+  vtkIdType end = (this->Size * (thread + 1)) / this->NumberOfThreads;
+  vtkIdType* counts = &this->Counts[thread * VTK_DEPTH_SORT_RADIX_BUCKETS];
+  const vtkTypeUInt32* keys = &this->Keys[this->Source][0];
+  switch (this->Phase)
+    {
+    case KEYS:
+      switch (this->Points->GetDataType())
+        {
+        vtkTemplateMacro(vtkDepthSortComputeKeys(
+          static_cast<VTK_TT*>(this->Points->GetVoidPointer(0)),
+          this, begin, end));
+        }
+      break;
+
+    case COUNT:
+      memset(counts, 0, VTK_DEPTH_SORT_RADIX_BUCKETS * sizeof(vtkIdType));
+      for (vtkIdType i = begin; i < end; ++i)
+        {
+        counts[(keys[i] >> this->Shift) & 0xff]++;
+        }
+      break;
+
+    case SCATTER:
+      {
+      const vtkIdType* values = &this->Values[this->Source][0];
+      vtkTypeUInt32* outKeys = &this->Keys[1 - this->Source][0];
+      vtkIdType* outValues = &this->Values[1 - this->Source][0];
+      for (vtkIdType i = begin; i < end; ++i)
+        {
+        vtkIdType location = counts[(keys[i] >> this->Shift) & 0xff]++;
+        outKeys[location] = keys[i];
+        outValues[location] = values[i];
+        }
+      }
+      break;
+    }
+}
+
+//-----------------------------------------------------------------------------
+void vtkDepthSortJob::Sort()
+{
+  for (this->Shift = 0; this->Shift < 32; this->Shift += 8)
+    {
+    this->Execute(COUNT);
+
+    // Each thread scatters a bucket after the previous buckets and after the
+    // same bucket of the previous threads. A digit shared by all the keys
+    // does not change the order.
+    vtkIdType location = 0;
+    bool sorted = false;
+    for (int bucket = 0; bucket < VTK_DEPTH_SORT_RADIX_BUCKETS; ++bucket)
+      {
+      vtkIdType begin = location;
+      for (int thread = 0; thread < this->NumberOfThreads; ++thread)
+        {
+        vtkIdType& count =
+          this->Counts[thread * VTK_DEPTH_SORT_RADIX_BUCKETS + bucket];
+        vtkIdType next = location + count;
+        count = location;
+        location = next;
+        }
+      if (location - begin == this->Size)
+        {
+        sorted = true;
+        break;
+        }
+      }
+    if (!sorted)
+      {
+      this->Execute(SCATTER);
+      this->Source = 1 - this->Source;
+      }
+    }
+  if (this->Source == 1)
+    {
+    this->Keys[0].swap(this->Keys[1]);
+    this->Values[0].swap(this->Values[1]);
+    this->Source = 0;
+    }
+}
+
+//-----------------------------------------------------------------------------
+bool vtkDepthSortJob::FixUp(vtkIdType budget)
+{
+  vtkTypeUInt32* keys = &this->Keys[0][0];
+  vtkIdType* values = &this->Values[0][0];
+  vtkIdType moves = 0;
+  for (vtkIdType i = 1; i < this->Size; ++i)
+    {
+    vtkTypeUInt32 key = keys[i];
+    if (keys[i - 1] <= key)
+      {
+      continue;
+      }
+    vtkIdType value = values[i];
+    vtkIdType j = i;
+    for (; j > 0 && keys[j - 1] > key; --j)
+      {
+      keys[j] = keys[j - 1];
+      values[j] = values[j - 1];
+      }
+    keys[j] = key;
+    values[j] = value;
+    moves += i - j;
+    if (moves > budget)
+      {
+      return false;
+      }
+    }
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+// The cells of one type of a polydata sorted with the radix sort.
+class vtkDepthSortCells
+{
+public:
+  vtkDepthSortCells() : Base(0) {}
+
+  // Id of the first cell of this type in the polydata.
+  vtkIdType Base;
+  // Location of each cell in the connectivity of Input.
+  vtkstd::vector<vtkIdType> Offsets;
+  // Input cells in the order they are rendered.
+  vtkstd::vector<vtkIdType> Order;
+  vtkSmartPointer<vtkCellArray> Input;
+  vtkSmartPointer<vtkCellArray> Output;
+};
+
+class vtkDepthSortBlock
+{
+public:
+  vtkSmartPointer<vtkPolyData> Input;
+  vtkSmartPointer<vtkPolyData> Output;
+  vtkDepthSortCells Cells[4];
+};
+
+//-----------------------------------------------------------------------------
+class vtkDepthSortPainter::vtkInternals
+{
+public:
+  vtkInternals() : FilterSorted(false)
+    {
+    this->SortedMode = VTK_SORT_FIRST_POINT;
+    this->SortedDirection = VTK_DIRECTION_BACK_TO_FRONT;
+    this->SortedDirectionVector[0] = this->SortedDirectionVector[1] = 0.0;
+    this->SortedDirectionVector[2] = 0.0;
+    this->SortedDirectionOrigin[0] = this->SortedDirectionOrigin[1] = 0.0;
+    this->SortedDirectionOrigin[2] = 0.0;
+    this->Vector[0] = this->Vector[1] = 0.0;
+    this->Vector[2] = -1.0;
+    this->Origin[0] = this->Origin[1] = this->Origin[2] = 0.0;
+    this->SortedVector[0] = this->SortedVector[1] = 0.0;
+    this->SortedVector[2] = -1.0;
+    }
+
+  // Sort the cells of a block, incrementally if asked. Returns false if the
+  // incremental sort had to be replaced by a full sort.
+  bool SortCells(vtkDepthSortBlock& block, int type, bool incremental);
+
+  // Rebuild the cell data of the output of a block in the new order.
+  void CopyCellData(vtkDepthSortBlock& block);
+
+  // Record the settings of the filter used by the last full sort, and
+  // check whether they are still the same.
+  void RecordSettings(vtkDepthSortPolyData* filter);
+  bool SameSettings(vtkDepthSortPolyData* filter);
+
+  vtkstd::vector<vtkDepthSortBlock> Blocks;
+  // Buffers of the radix sort, kept from one sort to the next.
+  vtkstd::vector<vtkTypeUInt32> Keys[2];
+  vtkstd::vector<vtkIdType> Values;
+  // True when some blocks of the output were sorted by vtkDepthSortPolyData,
+  // and cannot be updated when the camera moves.
+  bool FilterSorted;
+  // Normalized direction of projection and position of the camera in the
+  // coordinates of the actor, now and at the last sort.
+  double Vector[3];
+  double Origin[3];
+  double SortedVector[3];
+  // Settings of vtkDepthSortPolyData at the last full sort. The order kept
+  // in Blocks is only valid for them.
+  int SortedMode;
+  int SortedDirection;
+  double SortedDirectionVector[3];
+  double SortedDirectionOrigin[3];
+};
+
+//-----------------------------------------------------------------------------
+void vtkDepthSortPainter::vtkInternals::RecordSettings(
+  vtkDepthSortPolyData* filter)
+{
+  this->SortedMode = filter->GetDepthSortMode();
+  this->SortedDirection = filter->GetDirection();
+  filter->GetVector(this->SortedDirectionVector);
+  filter->GetOrigin(this->SortedDirectionOrigin);
+}
+
+//-----------------------------------------------------------------------------
+bool vtkDepthSortPainter::vtkInternals::SameSettings(
+  vtkDepthSortPolyData* filter)
+{
+  double* vector = filter->GetVector();
+  double* origin = filter->GetOrigin();
+  return this->SortedMode == filter->GetDepthSortMode() &&
+    this->SortedDirection == filter->GetDirection() &&
+    vector[0] == this->SortedDirectionVector[0] &&
+    vector[1] == this->SortedDirectionVector[1] &&
+    vector[2] == this->SortedDirectionVector[2] &&
+    origin[0] == this->SortedDirectionOrigin[0] &&
+    origin[1] == this->SortedDirectionOrigin[1] &&
+    origin[2] == this->SortedDirectionOrigin[2];
+}
+
+//-----------------------------------------------------------------------------
+bool vtkDepthSortPainter::vtkInternals::SortCells(vtkDepthSortBlock& block,
+  int type, bool incremental)
+{
+  vtkDepthSortCells& cells = block.Cells[type];
+  vtkIdType size = static_cast<vtkIdType>(cells.Order.size());
+  if (size < 2)
+    {
+    return true;
+    }
+
+  vtkDepthSortJob job(size);
+  job.Connectivity = cells.Input->GetPointer();
+  job.Offsets = &cells.Offsets[0];
+  job.Points = block.Input->GetPoints()->GetData();
+  for (int i = 0; i < 3; ++i)
+    {
+    job.Vector[i] = this->Vector[i];
+    job.Origin[i] = this->Origin[i];
+    }
+  job.Values[0].swap(cells.Order);
+  job.Values[1].swap(this->Values);
+  job.Keys[0].swap(this->Keys[0]);
+  job.Keys[1].swap(this->Keys[1]);
+  job.Values[1].resize(size);
+  job.Keys[0].resize(size);
+  job.Keys[1].resize(size);
+
+  job.Execute(vtkDepthSortJob::KEYS);
+  bool fixedUp = incremental && job.FixUp(VTK_DEPTH_SORT_FIXUP_MOVES * size);
+  if (!fixedUp)
+    {
+    job.Sort();
+    }
+
+  cells.Order.swap(job.Values[0]);
+  this->Values.swap(job.Values[1]);
+  this->Keys[0].swap(job.Keys[0]);
+  this->Keys[1].swap(job.Keys[1]);
+
+  // Copy the cells in their new order.
+  const vtkIdType* in = cells.Input->GetPointer();
+  vtkIdType* out = cells.Output->WritePointer(size,
+    cells.Input->GetNumberOfConnectivityEntries());
+  for (vtkIdType i = 0; i < size; ++i)
+    {
+    const vtkIdType* cell = in + cells.Offsets[cells.Order[i]];
+    vtkIdType n = cell[0] + 1;
+    memcpy(out, cell, n * sizeof(vtkIdType));
+    out += n;
+    }
+  cells.Output->Modified();
+  return fixedUp || !incremental;
+}
+
+//-----------------------------------------------------------------------------
+void vtkDepthSortPainter::vtkInternals::CopyCellData(vtkDepthSortBlock& block)
+{
+  vtkCellData* inCD = block.Input->GetCellData();
+  if (inCD->GetNumberOfArrays() == 0)
+    {
+    return;
+    }
+  vtkCellData* outCD = block.Output->GetCellData();
+  outCD->Initialize();
+  outCD->CopyAllocate(inCD, block.Input->GetNumberOfCells());
+  for (int type = 0; type < 4; ++type)
+    {
+    vtkDepthSortCells& cells = block.Cells[type];
+    vtkIdType size = static_cast<vtkIdType>(cells.Order.size());
+    for (vtkIdType i = 0; i < size; ++i)
+      {
+      outCD->CopyData(inCD, cells.Base + cells.Order[i], cells.Base + i);
+      }
+    }
+}
+
 //-----------------------------------------------------------------------------
 vtkStandardNewMacro(vtkDepthSortPainter)
 //-----------------------------------------------------------------------------
@@ -75,17 +491,65 @@ vtkDepthSortPainter::vtkDepthSortPainter()
   this->CachedIsColorSemiTranslucent = 1;
   this->DepthSortPolyData = vtkDepthSortPolyData::New();
   this->OutputData = NULL;
+  this->UseRadixSort = 1;
+  this->ReuseOrderAngle = 0.5;
+  this->IncrementalSortAngle = 10.0;
+  this->LastSortType = SORT_NONE;
+  this->LastSortTime = 0.0;
+  this->Internals = new vtkInternals();
 }
 //-----------------------------------------------------------------------------
 vtkDepthSortPainter::~vtkDepthSortPainter()
 {
   this->SetDepthSortPolyData(NULL);
   this->SetOutputData(NULL);
+  delete this->Internals;
 }
 //-----------------------------------------------------------------------------
 void vtkDepthSortPainter::PrintSelf(ostream &os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os, indent);
+  os << indent << "DepthSortEnableMode: " << this->DepthSortEnableMode << endl;
+  os << indent << "UseRadixSort: " << this->UseRadixSort << endl;
+  os << indent << "ReuseOrderAngle: " << this->ReuseOrderAngle << endl;
+  os << indent << "IncrementalSortAngle: " << this->IncrementalSortAngle
+     << endl;
+  os << indent << "LastSortType: " << this->LastSortType << endl;
+  os << indent << "LastSortTime: " << this->LastSortTime << endl;
+}
+
+//-----------------------------------------------------------------------------
+void vtkDepthSortPainter::ComputeProjectionVector(vtkRenderer* renderer,
+  vtkActor* actor, double vector[3], double origin[3])
+{
+  vtkCamera* camera = renderer->GetActiveCamera();
+  double focalPoint[4], position[4];
+  camera->GetFocalPoint(focalPoint);
+  camera->GetPosition(position);
+  focalPoint[3] = position[3] = 1.0;
+  if (actor)
+    {
+    vtkMatrix4x4* inverse = vtkMatrix4x4::New();
+    vtkMatrix4x4::Invert(actor->GetMatrix(), inverse);
+    double point[4];
+    inverse->MultiplyPoint(focalPoint, point);
+    for (int i = 0; i < 3; ++i)
+      {
+      focalPoint[i] = point[i] / point[3];
+      }
+    inverse->MultiplyPoint(position, point);
+    for (int i = 0; i < 3; ++i)
+      {
+      position[i] = point[i] / point[3];
+      }
+    inverse->Delete();
+    }
+  for (int i = 0; i < 3; ++i)
+    {
+    vector[i] = focalPoint[i] - position[i];
+    origin[i] = position[i];
+    }
+  vtkMath::Normalize(vector);
 }
 
 //-----------------------------------------------------------------------------
@@ -100,60 +564,123 @@ void vtkDepthSortPainter::PrepareForRendering(vtkRenderer* renderer,
     this->DepthSortPolyData->SetDirectionToBackToFront();
     }
 
+  vtkDataObject * input = this->GetInput();
+  if (!input)
+    {
+    this->SetOutputData(NULL);
+    return;
+    }
+
   // check if we need to update
+  this->LastSortType = SORT_NONE;
+  this->LastSortTime = 0.0;
   if (this->GetMTime() < this->SortTime && this->DepthSortPolyData->GetMTime()
-      < this->SortTime && this->GetInput()->GetMTime() < this->SortTime)
+      < this->SortTime && input->GetMTime() < this->SortTime)
     {
     return;
     }
 
-  // update the OutputData, initialize it with a shallow copy of the input
-  this->SetOutputData(NULL);
-  vtkDataObject * input = this->GetInput();
-  if (!input)
-    return;
+  double startTime = vtkTimerLog::GetUniversalTime();
+  vtkTimerLog::MarkStartEvent("Depth Sort");
 
-  vtkDataObject* output = input->NewInstance();
-  output->ShallowCopy(input);
-  this->SetOutputData(output);
-  output->Delete();
+  int needSorting =
+    this->DepthSortPolyData != NULL && this->NeedSorting(renderer, actor);
+  if (needSorting)
+    {
+    this->ComputeProjectionVector(renderer, actor, this->Internals->Vector,
+      this->Internals->Origin);
+    }
 
-  if (this->DepthSortPolyData != NULL && this->NeedSorting(renderer, actor))
+  // When only the camera moved, update the order of the cells sorted by
+  // the radix sort in place. The modification time of the filter includes
+  // the camera, so its settings are compared instead.
+  if (needSorting && this->OutputData &&
+      this->GetMTime() < this->SortTime && input->GetMTime() < this->SortTime &&
+      !this->Internals->Blocks.empty() && !this->Internals->FilterSorted &&
+      this->Internals->SameSettings(this->DepthSortPolyData))
+    {
+    this->LastSortType = this->UpdateOrder();
+    this->SortTime.Modified();
+    }
+  else
     {
-    if (input->IsA("vtkCompositeDataSet"))
+    // update the OutputData, initialize it with a shallow copy of the input
+    this->SetOutputData(NULL);
+    this->Internals->Blocks.clear();
+    this->Internals->FilterSorted = false;
+
+    vtkDataObject* output = input->NewInstance();
+    output->ShallowCopy(input);
+    this->SetOutputData(output);
+    output->Delete();
+
+    if (needSorting)
       {
-      vtkCompositeDataSet* cdInput = vtkCompositeDataSet::SafeDownCast(input);
-      vtkCompositeDataSet* cdOutput = vtkCompositeDataSet::SafeDownCast(
-          this->OutputData);
-      vtkCompositeDataIterator* iter = cdInput->NewIterator();
-      for (iter->InitTraversal(); !iter->IsDoneWithTraversal(); iter->GoToNextItem())
+      if (input->IsA("vtkCompositeDataSet"))
         {
-        vtkDataSet* pdInput = vtkDataSet::SafeDownCast(
-            iter->GetCurrentDataObject());
-        vtkDataSet* pdOutput = vtkDataSet::SafeDownCast(cdOutput->GetDataSet(
-            iter));
-        if (pdInput && pdOutput)
+        vtkCompositeDataSet* cdInput = vtkCompositeDataSet::SafeDownCast(input);
+        vtkCompositeDataSet* cdOutput = vtkCompositeDataSet::SafeDownCast(
+            this->OutputData);
+        vtkCompositeDataIterator* iter = cdInput->NewIterator();
+        for (iter->InitTraversal(); !iter->IsDoneWithTraversal(); iter->GoToNextItem())
           {
-          this->Sort(pdOutput, pdInput, renderer, actor);
+          vtkDataSet* pdInput = vtkDataSet::SafeDownCast(
+              iter->GetCurrentDataObject());
+          vtkDataSet* pdOutput = vtkDataSet::SafeDownCast(cdOutput->GetDataSet(
+              iter));
+          if (pdInput && pdOutput)
+            {
+            if (pdOutput == pdInput)
+              {
+              // the leaves of the shallow copy are shared with the input.
+              pdOutput = pdInput->NewInstance();
+              pdOutput->ShallowCopy(pdInput);
+              cdOutput->SetDataSet(iter, pdOutput);
+              pdOutput->Delete();
+              }
+            this->Sort(pdOutput, pdInput, renderer, actor);
+            }
           }
-        }
 
-      iter->Delete();
-      }
-    else
-      {
-      this->Sort(vtkDataSet::SafeDownCast(this->OutputData),
-          vtkDataSet::SafeDownCast(input), renderer, actor);
+        iter->Delete();
+        }
+      else
+        {
+        this->Sort(vtkDataSet::SafeDownCast(this->OutputData),
+            vtkDataSet::SafeDownCast(input), renderer, actor);
+        }
+      for (int i = 0; i < 3; ++i)
+        {
+        this->Internals->SortedVector[i] = this->Internals->Vector[i];
+        }
+      this->Internals->RecordSettings(this->DepthSortPolyData);
+      this->LastSortType = SORT_FULL;
+      this->SortTime.Modified();
       }
-    this->SortTime.Modified();
     }
+
+  vtkTimerLog::MarkEndEvent("Depth Sort");
+  this->LastSortTime = vtkTimerLog::GetUniversalTime() - startTime;
+  vtkDebugMacro("Depth sort of type " << this->LastSortType << " took "
+    << this->LastSortTime << "s");
 }
 
+//-----------------------------------------------------------------------------
 void vtkDepthSortPainter::Sort(vtkDataSet* output,
     vtkDataSet* input,
     vtkRenderer* vtkNotUsed(renderer),
     vtkActor* vtkNotUsed(actor))
 {
+  vtkPolyData* pdInput = vtkPolyData::SafeDownCast(input);
+  vtkPolyData* pdOutput = vtkPolyData::SafeDownCast(output);
+  if (this->UseRadixSort && pdInput && pdOutput && pdInput->GetPoints() &&
+      this->DepthSortPolyData->GetDepthSortMode() == VTK_SORT_FIRST_POINT)
+    {
+    this->RadixSort(pdOutput, pdInput);
+    return;
+    }
+
+  this->Internals->FilterSorted = true;
   this->DepthSortPolyData->SetInput(input);
 
   this->DepthSortPolyData->Update();
@@ -163,6 +690,94 @@ void vtkDepthSortPainter::Sort(vtkDataSet* output,
   output->ShallowCopy(polyData);
 }
 
+//-----------------------------------------------------------------------------
+void vtkDepthSortPainter::RadixSort(vtkPolyData* output, vtkPolyData* input)
+{
+  this->Internals->Blocks.push_back(vtkDepthSortBlock());
+  vtkDepthSortBlock& block = this->Internals->Blocks.back();
+  block.Input = input;
+  block.Output = output;
+
+  vtkCellArray* arrays[4] =
+    { input->GetVerts(), input->GetLines(), input->GetPolys(),
+      input->GetStrips() };
+  vtkIdType base = 0;
+  for (int type = 0; type < 4; ++type)
+    {
+    vtkDepthSortCells& cells = block.Cells[type];
+    cells.Base = base;
+    vtkIdType size = arrays[type] ? arrays[type]->GetNumberOfCells() : 0;
+    base += size;
+    if (size == 0)
+      {
+      continue;
+      }
+
+    cells.Input = arrays[type];
+    cells.Offsets.resize(size);
+    cells.Order.resize(size);
+    const vtkIdType* cell = cells.Input->GetPointer();
+    vtkIdType offset = 0;
+    for (vtkIdType i = 0; i < size; ++i)
+      {
+      cells.Offsets[i] = offset;
+      cells.Order[i] = i;
+      offset += cell[offset] + 1;
+      }
+    if (size < 2)
+      {
+      continue;
+      }
+
+    cells.Output = vtkSmartPointer<vtkCellArray>::New();
+    this->Internals->SortCells(block, type, false);
+    switch (type)
+      {
+      case 0: output->SetVerts(cells.Output); break;
+      case 1: output->SetLines(cells.Output); break;
+      case 2: output->SetPolys(cells.Output); break;
+      case 3: output->SetStrips(cells.Output); break;
+      }
+    }
+  this->Internals->CopyCellData(block);
+}
+
+//-----------------------------------------------------------------------------
+int vtkDepthSortPainter::UpdateOrder()
+{
+  vtkInternals* internals = this->Internals;
+  double cosine = vtkMath::Dot(internals->Vector, internals->SortedVector);
+  cosine = cosine > 1.0 ? 1.0 : (cosine < -1.0 ? -1.0 : cosine);
+  double angle = acos(cosine) * 180.0 / vtkMath::DoublePi();
+  if (angle <= this->ReuseOrderAngle)
+    {
+    return SORT_REUSED;
+    }
+
+  bool incremental = angle <= this->IncrementalSortAngle;
+  int sortType = incremental ? SORT_INCREMENTAL : SORT_FULL;
+  for (size_t i = 0; i < internals->Blocks.size(); ++i)
+    {
+    vtkDepthSortBlock& block = internals->Blocks[i];
+    for (int type = 0; type < 4; ++type)
+      {
+      if (!internals->SortCells(block, type, incremental))
+        {
+        sortType = SORT_FULL;
+        }
+      }
+    internals->CopyCellData(block);
+    block.Output->DeleteCells();
+    block.Output->Modified();
+    }
+  for (int i = 0; i < 3; ++i)
+    {
+    internals->SortedVector[i] = internals->Vector[i];
+    }
+  this->OutputData->Modified();
+  return sortType;
+}
+
 int vtkDepthSortPainter::NeedSorting(vtkRenderer* renderer, vtkActor* actor)
 {
   if (!actor || !renderer)
@@ -32,6 +32,16 @@
 // painter does nothing.
 // This painter is useful with the point sprite painter
 // to sort points when depth peeling is disabled.
+//
+// When UseRadixSort is on and the cells of polydata are sorted by their
+// first point, which is the default of vtkDepthSortPolyData, the painter
+// sorts the cells itself: the depths are quantized to 32 bit keys that are
+// sorted with a radix sort on several threads, and only the cell arrays of
+// the output are rebuilt. When only the camera moves, the painter keeps the
+// previous order if the view direction turned by less than ReuseOrderAngle
+// and fixes it up with an insertion sort if it turned by less than
+// IncrementalSortAngle. Otherwise, or if the fix up has too much to do, the
+// cells are sorted again.
 
 #ifndef __vtkDepthSortPainter_h
 #define __vtkDepthSortPainter_h
@@ -49,6 +59,7 @@ class vtkDataObject;
 class vtkTexture;
 class vtkDepthSortPolyData;
 class vtkUnsignedCharArray;
+class vtkPolyData;
 
 class VTK_EXPORT vtkDepthSortPainter : public vtkPainter
 {
@@ -101,6 +112,34 @@ public:
   virtual void  SetDepthSortPolyData(vtkDepthSortPolyData*);
   vtkGetObjectMacro(DepthSortPolyData, vtkDepthSortPolyData);
 
+  // Description:
+  // Sort the cells of polydata with a threaded radix sort instead of the
+  // vtkDepthSortPolyData filter. On by default. Only used when the filter
+  // sorts by first point.
+  vtkSetMacro(UseRadixSort, int);
+  vtkGetMacro(UseRadixSort, int);
+  vtkBooleanMacro(UseRadixSort, int);
+
+  // Description:
+  // Angles in degrees between the view direction of the last sort and the
+  // current one under which the previous order is kept as is, or fixed up
+  // incrementally, when the input did not change. 0.5 and 10 by default.
+  vtkSetClampMacro(ReuseOrderAngle, double, 0.0, 180.0);
+  vtkGetMacro(ReuseOrderAngle, double);
+  vtkSetClampMacro(IncrementalSortAngle, double, 0.0, 180.0);
+  vtkGetMacro(IncrementalSortAngle, double);
+
+  //BTX
+  enum { SORT_NONE=0, SORT_REUSED=1, SORT_INCREMENTAL=2, SORT_FULL=3 };
+  //ETX
+
+  // Description:
+  // What the last render did to order the cells, one of SORT_NONE,
+  // SORT_REUSED, SORT_INCREMENTAL or SORT_FULL, and the time it took in
+  // seconds. The sorts are also logged in the vtkTimerLog.
+  vtkGetMacro(LastSortType, int);
+  vtkGetMacro(LastSortTime, double);
+
 protected:
   vtkDepthSortPainter();
   virtual ~vtkDepthSortPainter();
@@ -109,6 +148,22 @@ protected:
   // do the sorting for a given dataset
   virtual void Sort(vtkDataSet* output, vtkDataSet* input, vtkRenderer* renderer, vtkActor* actor);
 
+  // Description:
+  // Sort the cells of a polydata with the radix sort, and record the order
+  // so that it can be updated when only the camera moves.
+  virtual void RadixSort(vtkPolyData* output, vtkPolyData* input);
+
+  // Description:
+  // Update the order of the cells of the datasets sorted by RadixSort() for
+  // the current camera. Returns the kind of sort done.
+  virtual int UpdateOrder();
+
+  // Description:
+  // Compute the direction of projection of the camera in the coordinates of
+  // the actor, and the camera position.
+  void ComputeProjectionVector(vtkRenderer* renderer, vtkActor* actor,
+    double vector[3], double origin[3]);
+
   // Description:
   // Called just before RenderInternal(). We sort the points here if the
   // renderer's camera has been modified.
@@ -140,6 +195,11 @@ protected:
   vtkTimeStamp          CachedIsColorSemiTranslucentTime;
   int                   CachedIsColorSemiTranslucent;
   vtkDepthSortPolyData* DepthSortPolyData;
+  int                   UseRadixSort;
+  double                ReuseOrderAngle;
+  double                IncrementalSortAngle;
+  int                   LastSortType;
+  double                LastSortTime;
 
   //BTX
   vtkWeakPointer<vtkDataObject> PrevInput;
@@ -150,6 +210,11 @@ protected:
 private:
   vtkDepthSortPainter(const vtkDepthSortPainter &);  // Not implemented.
   void operator=(const vtkDepthSortPainter &);  // Not implemented.
+
+  //BTX
+  class vtkInternals;
+  vtkInternals* Internals;
+  //ETX
 };
 
 #endif //__vtkDepthSortPainter_h
@@ -27,6 +27,7 @@
 #include "vtkReductionFilter.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkTable.h"
+#include "vtkTimeStepPartitioner.h"
 
 #include "vtkSmartPointer.h"
 #define VTK_CREATE(type, name) \
@@ -100,11 +101,14 @@ vtkPTemporalRanges::vtkPTemporalRanges()
 {
   this->Controller = NULL;
   this->SetController(vtkMultiProcessController::GetGlobalController());
+  this->NumberOfTimeGroups = 1;
+  this->Partitioner = vtkTimeStepPartitioner::New();
 }
 
 vtkPTemporalRanges::~vtkPTemporalRanges()
 {
   this->SetController(NULL);
+  this->Partitioner->Delete();
 }
 
 void vtkPTemporalRanges::PrintSelf(ostream &os, vtkIndent indent)
@@ -112,6 +116,26 @@ void vtkPTemporalRanges::PrintSelf(ostream &os, vtkIndent indent)
   this->Superclass::PrintSelf(os, indent);
 
   os << indent << "Controller: " << this->Controller << endl;
+  os << indent << "NumberOfTimeGroups: " << this->NumberOfTimeGroups << endl;
+}
+
+//-----------------------------------------------------------------------------
+void vtkPTemporalRanges::InitializeTimeSteps(vtkInformation *inInfo)
+{
+  // Every process sees the same time steps, so they all agree on the
+  // partition without communicating.
+  this->Partitioner->SetController(this->Controller);
+  this->Partitioner->SetNumberOfGroups(this->NumberOfTimeGroups);
+  this->Partitioner->Partition(
+                inInfo->Length(vtkStreamingDemandDrivenPipeline::TIME_STEPS()));
+  this->FirstTimeIndex = this->Partitioner->GetFirstTimeStep();
+  this->EndTimeIndex = this->Partitioner->GetEndTimeStep();
+}
+
+//-----------------------------------------------------------------------------
+void vtkPTemporalRanges::RequestTimeStep(vtkInformation *inInfo, int index)
+{
+  this->Partitioner->RequestTimeStep(inInfo, index);
 }
 
 //-----------------------------------------------------------------------------
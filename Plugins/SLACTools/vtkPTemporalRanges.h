@@ -25,6 +25,12 @@
 // vtkPTemporalRanges works basically like its superclass, vtkTemporalRanges,
 // except that it works in a data parallel manner.
 //
+// When NumberOfTimeGroups is more than 1, it also works in a time parallel
+// manner.  The processes are split into that many groups, each group
+// accumulates a range of the time steps, and the partial results are reduced
+// at the end.  See vtkTimeStepPartitioner for the restrictions on the
+// upstream pipeline.
+//
 
 #ifndef __vtkPTemporalRanges_h
 #define __vtkPTemporalRanges_h
@@ -32,6 +38,7 @@
 #include "vtkTemporalRanges.h"
 
 class vtkMultiProcessController;
+class vtkTimeStepPartitioner;
 
 class vtkPTemporalRanges : public vtkTemporalRanges
 {
@@ -43,11 +50,24 @@ public:
   vtkGetObjectMacro(Controller, vtkMultiProcessController);
   virtual void SetController(vtkMultiProcessController *);
 
+  // Description:
+  // Number of groups of processes that accumulate different time steps at
+  // the same time.  1, the default, means all processes accumulate every
+  // time step.  More groups hang when the upstream pipeline communicates
+  // among processes, which is not detected.
+  vtkSetClampMacro(NumberOfTimeGroups, int, 1, VTK_LARGE_INTEGER);
+  vtkGetMacro(NumberOfTimeGroups, int);
+
 protected:
   vtkPTemporalRanges();
   ~vtkPTemporalRanges();
 
   vtkMultiProcessController *Controller;
+  int NumberOfTimeGroups;
+  vtkTimeStepPartitioner *Partitioner;
+
+  virtual void InitializeTimeSteps(vtkInformation *inInfo);
+  virtual void RequestTimeStep(vtkInformation *inInfo, int index);
 
   virtual int RequestData(vtkInformation *,
                           vtkInformationVector **,
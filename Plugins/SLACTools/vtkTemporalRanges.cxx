@@ -116,6 +116,8 @@ vtkStandardNewMacro(vtkTemporalRanges);
 vtkTemporalRanges::vtkTemporalRanges()
 {
   this->CurrentTimeIndex = 0;
+  this->FirstTimeIndex = 0;
+  this->EndTimeIndex = 0;
 }
 
 vtkTemporalRanges::~vtkTemporalRanges()
@@ -169,14 +171,35 @@ int vtkTemporalRanges::RequestUpdateExtent(
   // upstream pipeline to get each time step in order.  The executive in turn
   // will call this method to get the extent request for each iteration (in this
   // case the time step).
+  if (this->CurrentTimeIndex == 0)
+    {
+    this->InitializeTimeSteps(inInfo);
+    }
+  if (this->FirstTimeIndex < this->EndTimeIndex)
+    {
+    this->RequestTimeStep(inInfo, this->FirstTimeIndex + this->CurrentTimeIndex);
+    }
+
+  return 1;
+}
+
+//-----------------------------------------------------------------------------
+void vtkTemporalRanges::InitializeTimeSteps(vtkInformation *inInfo)
+{
+  this->FirstTimeIndex = 0;
+  this->EndTimeIndex
+    = inInfo->Length(vtkStreamingDemandDrivenPipeline::TIME_STEPS());
+}
+
+//-----------------------------------------------------------------------------
+void vtkTemporalRanges::RequestTimeStep(vtkInformation *inInfo, int index)
+{
   double *inTimes = inInfo->Get(vtkStreamingDemandDrivenPipeline::TIME_STEPS());
   if (inTimes)
     {
     inInfo->Set(vtkStreamingDemandDrivenPipeline::UPDATE_TIME_STEPS(),
-                &inTimes[this->CurrentTimeIndex], 1);
+                &inTimes[index], 1);
     }
-
-  return 1;
 }
 
 //-----------------------------------------------------------------------------
@@ -213,8 +236,7 @@ int vtkTemporalRanges::RequestData(vtkInformation *request,
 
   this->CurrentTimeIndex++;
 
-  if (  this->CurrentTimeIndex
-      < inInfo->Length(vtkStreamingDemandDrivenPipeline::TIME_STEPS()) )
+  if (this->FirstTimeIndex + this->CurrentTimeIndex < this->EndTimeIndex)
     {
     // There is still more to do.
     request->Set(vtkStreamingDemandDrivenPipeline::CONTINUE_EXECUTING(), 1);
@@ -63,7 +63,22 @@ protected:
   vtkTemporalRanges();
   ~vtkTemporalRanges();
 
+  // Description:
+  // The time steps this process accumulates are [FirstTimeIndex,
+  // EndTimeIndex). CurrentTimeIndex counts the passes from the first.
   int CurrentTimeIndex;
+  int FirstTimeIndex;
+  int EndTimeIndex;
+
+  // Description:
+  // Sets FirstTimeIndex and EndTimeIndex before the first pass. All the time
+  // steps of the input by default.
+  virtual void InitializeTimeSteps(vtkInformation *inInfo);
+
+  // Description:
+  // Sets the update extent of the input for the time step with the given
+  // index.
+  virtual void RequestTimeStep(vtkInformation *inInfo, int index);
 
   virtual int FillInputPortInformation(int port, vtkInformation *info);
 
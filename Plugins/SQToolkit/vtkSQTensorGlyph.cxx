@@ -29,6 +29,8 @@ Copyright 2008 SciberQuest Inc.
 #include "vtkExecutive.h"
 #include "vtkFloatArray.h"
 #include "vtkMath.h"
+#include "vtkMatrix4x4.h"
+#include "vtkMultiThreader.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include "vtkObjectFactory.h"
@@ -36,6 +38,12 @@ Copyright 2008 SciberQuest Inc.
 #include "vtkPolyData.h"
 #include "vtkTransform.h"
 
+#include <string.h>
+
+// Below twice this number of input points, the glyphs are generated on a
+// single thread.
+#define VTK_SQ_TENSOR_GLYPH_POINTS_PER_THREAD 1000
+
 vtkStandardNewMacro(vtkSQTensorGlyph);
 
 // Construct object with scaling on and scale factor 1.0. Eigenvalues are 
@@ -103,185 +111,129 @@ int vtkSQTensorGlyph::RequestUpdateExtent(
 }
 
 //----------------------------------------------------------------------------
-int vtkSQTensorGlyph::RequestData(
-  vtkInformation *vtkNotUsed(request),
-  vtkInformationVector **inputVector,
-  vtkInformationVector *outputVector)
+// Glyphs a contiguous range of the input points into the preallocated
+// output arrays. Every input point produces the same number of points and
+// cells, so the location of the glyphs of a point in the output follows
+// from its id, and the ranges can be glyphed by several threads at once.
+class vtkSQTensorGlyphJob
 {
-  // get the info objects
-  vtkInformation *inInfo = inputVector[0]->GetInformationObject(0);
-  vtkInformation *sourceInfo = inputVector[1]->GetInformationObject(0);
-  vtkInformation *outInfo = outputVector->GetInformationObject(0);
-
-  // get the input and output
-  vtkDataSet *input = vtkDataSet::SafeDownCast(
-    inInfo->Get(vtkDataObject::DATA_OBJECT()));
-  vtkPolyData *source = vtkPolyData::SafeDownCast(
-    sourceInfo->Get(vtkDataObject::DATA_OBJECT()));
-  vtkPolyData *output = vtkPolyData::SafeDownCast(
-    outInfo->Get(vtkDataObject::DATA_OBJECT()));
+public:
+  vtkSQTensorGlyph *Filter;
+  vtkDataSet *Input;
+  vtkDataArray *InTensors;
+  vtkDataArray *InScalars;
+  vtkPolyData *Source;
+  vtkDataArray *SourceNormals;
+  vtkDataArray *SourceData;
+  int NumberOfThreads;
+  int NumberOfDirections;
+  vtkIdType NumberOfPoints;
+
+  // Preallocated output.
+  float *Points;
+  float *Normals;
+  float *Scalars;
+  vtkDataArray *Data;
+  vtkIdType *Cells[4];
+
+  void Run(vtkIdType begin, vtkIdType end);
+
+  static VTK_THREAD_RETURN_TYPE Thread(void *arg)
+    {
+    vtkMultiThreader::ThreadInfo *info
+      = static_cast<vtkMultiThreader::ThreadInfo*>(arg);
+    vtkSQTensorGlyphJob *job
+      = static_cast<vtkSQTensorGlyphJob*>(info->UserData);
+    vtkIdType begin
+      = (job->NumberOfPoints*info->ThreadID)/job->NumberOfThreads;
+    vtkIdType end
+      = (job->NumberOfPoints*(info->ThreadID+1))/job->NumberOfThreads;
+    job->Run(begin,end);
+    return VTK_THREAD_RETURN_VALUE;
+    }
+};
 
-  vtkDataArray *inTensors;
+//----------------------------------------------------------------------------
+void vtkSQTensorGlyphJob::Run(vtkIdType begin, vtkIdType end)
+{
+  vtkSQTensorGlyph *self = this->Filter;
   double tensor[9];
-  vtkDataArray *inScalars;
-  vtkIdType numPts, numSourcePts, numSourceCells, inPtId, i;
-  int j;
-  vtkPoints *sourcePts;
-  vtkDataArray *sourceNormals;
-  vtkCellArray *sourceCells, *cells;  
-  vtkPoints *newPts;
-  vtkFloatArray *newScalars=NULL;
-  vtkFloatArray *newNormals=NULL;
   double x[3], s;
-  vtkTransform *trans;
-  vtkCell *cell;
-  vtkIdList *cellPts;
-  int npts;
-  vtkIdType *pts;
-  vtkIdType ptIncr, cellId;
-  vtkIdType subIncr;
-  int numDirs, dir, eigen_dir, symmetric_dir;
-  vtkMatrix4x4 *matrix;
+  vtkIdType inPtId, i;
+  int j;
+  int numDirs = this->NumberOfDirections;
+  int eigen_dir, symmetric_dir, dir;
   double *m[3], w[3], *v[3];
   double m0[3], m1[3], m2[3];
   double v0[3], v1[3], v2[3];
   double xv[3], yv[3], zv[3];
   double maxScale;
-  vtkPointData *pd, *outPD;
-
-  numDirs = (this->ThreeGlyphs?3:1)*(this->Symmetric+1);
-
-  pts = new vtkIdType[source->GetMaxCellSize()];
-  trans = vtkTransform::New();
-  matrix = vtkMatrix4x4::New();
+  double scaleFactor = self->GetScaleFactor();
+  int threeGlyphs = self->GetThreeGlyphs();
+  int colorMode = self->GetColorMode();
+  int colorGlyphs = self->GetColorGlyphs();
+  vtkPoints *sourcePts = this->Source->GetPoints();
+  vtkIdType numSourcePts = sourcePts->GetNumberOfPoints();
+
+  vtkTransform *trans = vtkTransform::New();
+  vtkMatrix4x4 *matrix = vtkMatrix4x4::New();
+  vtkMatrix4x4 *inverse = vtkMatrix4x4::New();
+  trans->PreMultiply();
 
   // set up working matrices
-  m[0] = m0; m[1] = m1; m[2] = m2; 
-  v[0] = v0; v[1] = v1; v[2] = v2; 
-
-  vtkDebugMacro(<<"Generating tensor glyphs");
-
-  pd = input->GetPointData();
-  outPD = output->GetPointData();
-  inTensors = this->GetInputArrayToProcess(0, inputVector);
-  inScalars = this->GetInputArrayToProcess(1, inputVector);
-  numPts = input->GetNumberOfPoints();
+  m[0] = m0; m[1] = m1; m[2] = m2;
+  v[0] = v0; v[1] = v1; v[2] = v2;
 
-  if ( !inTensors || numPts < 1 )
-    {
-    vtkErrorMacro(<<"No data to glyph!");
-    return 1;
-    }
   //
-  // Allocate storage for output PolyData
+  // First copy all topology (transformation independent)
   //
-  sourcePts = source->GetPoints();
-  numSourcePts = sourcePts->GetNumberOfPoints();
-  numSourceCells = source->GetNumberOfCells();
-
-  newPts = vtkPoints::New();
-  newPts->Allocate(numDirs*numPts*numSourcePts);
-
-  // Setting up for calls to PolyData::InsertNextCell()
-  if ( (sourceCells=source->GetVerts())->GetNumberOfCells() > 0 )
-    {
-    cells = vtkCellArray::New();
-    cells->Allocate(numDirs*numPts*sourceCells->GetSize());
-    output->SetVerts(cells);
-    cells->Delete();
-    }
-  if ( (sourceCells=this->GetSource()->GetLines())->GetNumberOfCells() > 0 )
+  vtkCellArray *sourceCells[4] =
     {
-    cells = vtkCellArray::New();
-    cells->Allocate(numDirs*numPts*sourceCells->GetSize());
-    output->SetLines(cells);
-    cells->Delete();
-    }
-  if ( (sourceCells=this->GetSource()->GetPolys())->GetNumberOfCells() > 0 )
-    {
-    cells = vtkCellArray::New();
-    cells->Allocate(numDirs*numPts*sourceCells->GetSize());
-    output->SetPolys(cells);
-    cells->Delete();
-    }
-  if ( (sourceCells=this->GetSource()->GetStrips())->GetNumberOfCells() > 0 )
-    {
-    cells = vtkCellArray::New();
-    cells->Allocate(numDirs*numPts*sourceCells->GetSize());
-    output->SetStrips(cells);
-    cells->Delete();
-    }
-
-  // only copy scalar data through
-  pd = this->GetSource()->GetPointData();
-  // generate scalars if eigenvalues are chosen or if scalars exist.
-  if (this->ColorGlyphs && 
-      ((this->ColorMode == COLOR_BY_EIGENVALUES) || 
-       (inScalars && (this->ColorMode == COLOR_BY_SCALARS)) ) )
+    this->Source->GetVerts(), this->Source->GetLines(),
+    this->Source->GetPolys(), this->Source->GetStrips()
+    };
+  for (int type=0; type<4; type++)
     {
-    newScalars = vtkFloatArray::New();
-    newScalars->Allocate(numDirs*numPts*numSourcePts);
-    if (this->ColorMode == COLOR_BY_EIGENVALUES)
+    if (!this->Cells[type])
       {
-      newScalars->SetName("MaxEigenvalue");
+      continue;
       }
-    else
+    vtkIdType size = sourceCells[type]->GetNumberOfConnectivityEntries();
+    vtkIdType numCells = sourceCells[type]->GetNumberOfCells();
+    vtkIdType *out = this->Cells[type] + begin*numDirs*size;
+    for (inPtId=begin; inPtId < end; inPtId++)
       {
-      newScalars->SetName(inScalars->GetName());
-      }
-    }
-  else
-    {
-    outPD->CopyAllOff();
-    outPD->CopyScalarsOn();
-    outPD->CopyAllocate(pd,numDirs*numPts*numSourcePts);
-    }
-  if ( (sourceNormals = pd->GetNormals()) )
-    {
-    newNormals = vtkFloatArray::New();
-    newNormals->SetNumberOfComponents(3);
-    newNormals->SetName("Normals");
-    newNormals->Allocate(numDirs*3*numPts*numSourcePts);
-    }
-  //
-  // First copy all topology (transformation independent)
-  //
-  for (inPtId=0; inPtId < numPts; inPtId++)
-    {
-    ptIncr = numDirs * inPtId * numSourcePts;
-    for (cellId=0; cellId < numSourceCells; cellId++)
-      {
-      cell = this->GetSource()->GetCell(cellId);
-      cellPts = cell->GetPointIds();
-      npts = cellPts->GetNumberOfIds();
-      for (dir=0; dir < numDirs; dir++)
+      vtkIdType ptIncr = numDirs * inPtId * numSourcePts;
+      vtkIdType *cell = sourceCells[type]->GetPointer();
+      for (vtkIdType cellId=0; cellId < numCells; cellId++)
         {
-        // This variable may be removed, but that 
-        // will not improve readability
-        subIncr = ptIncr + dir*numSourcePts;
-        for (i=0; i < npts; i++)
+        vtkIdType npts = cell[0];
+        for (dir=0; dir < numDirs; dir++)
           {
-          pts[i] = cellPts->GetId(i) + subIncr;
+          vtkIdType subIncr = ptIncr + dir*numSourcePts;
+          *out++ = npts;
+          for (i=0; i < npts; i++)
+            {
+            *out++ = cell[i+1] + subIncr;
+            }
           }
-        output->InsertNextCell(cell->GetCellType(),npts,pts);
+        cell += npts + 1;
         }
       }
     }
   //
-  // Traverse all Input points, transforming glyph at Source points
+  // Traverse the input points, transforming glyph at Source points
   //
-  trans->PreMultiply();
-
-  for (inPtId=0; inPtId < numPts; inPtId++)
+  for (inPtId=begin; inPtId < end; inPtId++)
     {
-    ptIncr = numDirs * inPtId * numSourcePts;
+    vtkIdType ptIncr = numDirs * inPtId * numSourcePts;
 
     // Translation is postponed
 
-    inTensors->GetTuple(inPtId, tensor);
+    this->InTensors->GetTuple(inPtId, tensor);
 
     // compute orientation vectors and scale factors from tensor
-    if ( this->ExtractEigenvalues ) // extract appropriate eigenfunctions
+    if ( self->GetExtractEigenvalues() ) // extract appropriate eigenfunctions
       {
       for (j=0; j<3; j++)
         {
@@ -302,7 +254,7 @@ int vtkSQTensorGlyph::RequestData(
       for (i=0; i<3; i++)
         {
         xv[i] = tensor[i];
-        yv[i] = tensor[i+3]; 
+        yv[i] = tensor[i+3];
         zv[i] = tensor[i+6];
         }
       w[0] = vtkMath::Normalize(xv);
@@ -310,17 +262,12 @@ int vtkSQTensorGlyph::RequestData(
       w[2] = vtkMath::Normalize(zv);
       }
 
-    // cerr << "w=" << w[0] << ", " << w[1] << ", " << w[2] << endl;
-    // cerr << "v1=" << xv[0] << ", " << xv[1] << ", " << xv[2] << endl;
-    // cerr << "v2=" << yv[0] << ", " << yv[1] << ", " << yv[2] << endl;
-    // cerr << "v3=" << zv[0] << ", " << zv[1] << ", " << zv[2] << endl;
-
     // compute scale factors
-    w[0] *= this->ScaleFactor;
-    w[1] *= this->ScaleFactor;
-    w[2] *= this->ScaleFactor;
+    w[0] *= scaleFactor;
+    w[1] *= scaleFactor;
+    w[2] *= scaleFactor;
 
-    if ( this->ClampScaling )
+    if ( self->GetClampScaling() )
       {
       for (maxScale=0.0, i=0; i<3; i++)
         {
@@ -329,9 +276,9 @@ int vtkSQTensorGlyph::RequestData(
           maxScale = fabs(w[i]);
           }
         }
-      if ( maxScale > this->MaxScaleFactor )
+      if ( maxScale > self->GetMaxScaleFactor() )
         {
-        maxScale = this->MaxScaleFactor / maxScale;
+        maxScale = self->GetMaxScaleFactor() / maxScale;
         for (i=0; i<3; i++)
           {
           w[i] *= maxScale; //preserve overall shape of glyph
@@ -363,21 +310,16 @@ int vtkSQTensorGlyph::RequestData(
 
     // Now do the real work for each "direction"
 
-    for (dir=0; dir < numDirs; dir++) 
+    for (dir=0; dir < numDirs; dir++)
       {
-      // cerr << "dir=" << dir << endl;
-
-      eigen_dir = dir%(this->ThreeGlyphs?3:1);
-      symmetric_dir = dir/(this->ThreeGlyphs?3:1);
-
-      // cerr << "eigne_dir=" << eigen_dir << endl;
-      // cerr << "symetric dir=" << symmetric_dir << endl;
+      eigen_dir = dir%(threeGlyphs?3:1);
+      symmetric_dir = dir/(threeGlyphs?3:1);
 
       // Remove previous scales ...
       trans->Identity();
 
       // translate Source to Input point
-      input->GetPoint(inPtId, x);
+      this->Input->GetPoint(inPtId, x);
       trans->Translate(x[0], x[1], x[2]);
 
       // normalized eigenvectors rotate object for eigen direction 0
@@ -391,8 +333,8 @@ int vtkSQTensorGlyph::RequestData(
       matrix->Element[2][1] = yv[2];
       matrix->Element[2][2] = zv[2];
       trans->Concatenate(matrix);
-        
-      if (eigen_dir == 1) 
+
+      if (eigen_dir == 1)
         {
         trans->RotateZ(90.0);
         }
@@ -402,9 +344,9 @@ int vtkSQTensorGlyph::RequestData(
         trans->RotateY(-90.0);
         }
 
-      if (this->ThreeGlyphs) 
+      if (threeGlyphs)
         {
-        trans->Scale(w[eigen_dir], this->ScaleFactor, this->ScaleFactor);
+        trans->Scale(w[eigen_dir], scaleFactor, scaleFactor);
         }
       else
         {
@@ -418,70 +360,261 @@ int vtkSQTensorGlyph::RequestData(
         }
 
       // if the eigenvalue is negative, shift to reverse direction.
-      // The && is there to ensure that we do not change the 
-      // old behaviour of vtkSQTensorGlyphs (which only used one dir), 
+      // The && is there to ensure that we do not change the
+      // old behaviour of vtkSQTensorGlyphs (which only used one dir),
       // in case there is an oriented glyph, e.g. an arrow.
-      if (w[eigen_dir] < 0 && numDirs > 1) 
+      if (w[eigen_dir] < 0 && numDirs > 1)
         {
-        trans->Translate(-this->Length, 0., 0.);
+        trans->Translate(-self->GetLength(), 0., 0.);
         }
 
       // multiply points (and normals if available) by resulting
-      // matrix
-      trans->TransformPoints(sourcePts,newPts); 
+      // matrix, directly into their place in the output.
+      double (*e)[4] = trans->GetMatrix()->Element;
+      float *outPt = this->Points + 3*ptIncr;
+      for (i=0; i < numSourcePts; i++)
+        {
+        double p[3];
+        sourcePts->GetPoint(i, p);
+        for (j=0; j<3; j++)
+          {
+          outPt[j] = static_cast<float>(
+            e[j][0]*p[0] + e[j][1]*p[1] + e[j][2]*p[2] + e[j][3]);
+          }
+        outPt += 3;
+        }
 
-      // Apply the transformation to a series of points, 
-      // and append the results to outPts.
-      if ( newNormals )
+      if ( this->Normals )
         {
         // a negative determinant indicates inverted orientation
-        // this affects surface normals. By applying a flip to
-        // the transform we presever orientation.
-        if (trans->GetMatrix()->Determinant()<0)
+        // this affects surface normals. By flipping the normals we
+        // preserve orientation.
+        double flip = trans->GetMatrix()->Determinant()<0 ? -1.0 : 1.0;
+        vtkMatrix4x4::Invert(trans->GetMatrix(), inverse);
+        double (*ie)[4] = inverse->Element;
+        float *outN = this->Normals + 3*ptIncr;
+        for (i=0; i < numSourcePts; i++)
           {
-          trans->Scale(-1.,-1.,-1.);
+          double n[3], tn[3];
+          this->SourceNormals->GetTuple(i, n);
+          for (j=0; j<3; j++)
+            {
+            tn[j] = ie[0][j]*n[0] + ie[1][j]*n[1] + ie[2][j]*n[2];
+            }
+          vtkMath::Normalize(tn);
+          for (j=0; j<3; j++)
+            {
+            outN[j] = static_cast<float>(flip*tn[j]);
+            }
+          outN += 3;
           }
-  
-        trans->TransformNormals(sourceNormals,newNormals);
         }
 
-        // Copy point data from source
-      if ( this->ColorGlyphs && inScalars && 
-           (this->ColorMode == COLOR_BY_SCALARS) )
+      // Copy point data from source
+      if ( colorGlyphs && this->InScalars &&
+           (colorMode == vtkSQTensorGlyph::COLOR_BY_SCALARS) )
         {
-        s = inScalars->GetComponent(inPtId, 0);
-        for (i=0; i < numSourcePts; i++) 
+        s = this->InScalars->GetComponent(inPtId, 0);
+        for (i=0; i < numSourcePts; i++)
           {
-          newScalars->InsertTuple(ptIncr+i, &s);
+          this->Scalars[ptIncr+i] = static_cast<float>(s);
           }
         }
-      else if (this->ColorGlyphs && 
-               (this->ColorMode == COLOR_BY_EIGENVALUES) )
+      else if (colorGlyphs &&
+               (colorMode == vtkSQTensorGlyph::COLOR_BY_EIGENVALUES) )
         {
-        // If ThreeGlyphs is false we use the first (largest) 
+        // If ThreeGlyphs is false we use the first (largest)
         // eigenvalue as scalar.
         s = w[eigen_dir];
-        for (i=0; i < numSourcePts; i++) 
+        for (i=0; i < numSourcePts; i++)
           {
-          newScalars->InsertTuple(ptIncr+i, &s);
+          this->Scalars[ptIncr+i] = static_cast<float>(s);
           }
         }
-      else
+      else if (this->Data)
         {
-        for (i=0; i < numSourcePts; i++) 
-          {
-          outPD->CopyData(pd,i,ptIncr+i);
-          }
+        int tupleSize = this->Data->GetNumberOfComponents()
+          * this->Data->GetDataTypeSize();
+        memcpy(this->Data->GetVoidPointer(ptIncr*this->Data->GetNumberOfComponents()),
+               this->SourceData->GetVoidPointer(0),
+               numSourcePts*tupleSize);
         }
       ptIncr += numSourcePts;
       }
     }
+
+  trans->Delete();
+  matrix->Delete();
+  inverse->Delete();
+}
+
+//----------------------------------------------------------------------------
+int vtkSQTensorGlyph::RequestData(
+  vtkInformation *vtkNotUsed(request),
+  vtkInformationVector **inputVector,
+  vtkInformationVector *outputVector)
+{
+  // get the info objects
+  vtkInformation *inInfo = inputVector[0]->GetInformationObject(0);
+  vtkInformation *sourceInfo = inputVector[1]->GetInformationObject(0);
+  vtkInformation *outInfo = outputVector->GetInformationObject(0);
+
+  // get the input and output
+  vtkDataSet *input = vtkDataSet::SafeDownCast(
+    inInfo->Get(vtkDataObject::DATA_OBJECT()));
+  vtkPolyData *source = vtkPolyData::SafeDownCast(
+    sourceInfo->Get(vtkDataObject::DATA_OBJECT()));
+  vtkPolyData *output = vtkPolyData::SafeDownCast(
+    outInfo->Get(vtkDataObject::DATA_OBJECT()));
+
+  vtkDataArray *inTensors;
+  vtkDataArray *inScalars;
+  vtkIdType numPts, numSourcePts, numOutPts;
+  vtkPoints *sourcePts;
+  vtkDataArray *sourceNormals;
+  vtkPoints *newPts;
+  vtkFloatArray *newScalars=NULL;
+  vtkFloatArray *newNormals=NULL;
+  vtkDataArray *newData=NULL;
+  int numDirs;
+  vtkPointData *pd, *outPD;
+
+  numDirs = (this->ThreeGlyphs?3:1)*(this->Symmetric+1);
+
+  vtkDebugMacro(<<"Generating tensor glyphs");
+
+  outPD = output->GetPointData();
+  inTensors = this->GetInputArrayToProcess(0, inputVector);
+  inScalars = this->GetInputArrayToProcess(1, inputVector);
+  numPts = input->GetNumberOfPoints();
+
+  if ( !inTensors || numPts < 1 )
+    {
+    vtkErrorMacro(<<"No data to glyph!");
+    return 1;
+    }
+  //
+  // Allocate storage for output PolyData. Every input point produces the
+  // same number of points and cells, so the output is allocated to its
+  // final size up front and filled in place.
+  //
+  sourcePts = source->GetPoints();
+  numSourcePts = sourcePts->GetNumberOfPoints();
+  numOutPts = numDirs*numPts*numSourcePts;
+
+  newPts = vtkPoints::New();
+  newPts->SetNumberOfPoints(numOutPts);
+
+  vtkSQTensorGlyphJob job;
+  job.Filter = this;
+  job.Input = input;
+  job.InTensors = inTensors;
+  job.InScalars = inScalars;
+  job.Source = source;
+  job.NumberOfDirections = numDirs;
+  job.NumberOfPoints = numPts;
+  job.Points = static_cast<float*>(newPts->GetVoidPointer(0));
+  job.Normals = NULL;
+  job.Scalars = NULL;
+  job.Data = NULL;
+  job.SourceNormals = NULL;
+  job.SourceData = NULL;
+
+  vtkCellArray *sourceCells[4] =
+    {
+    source->GetVerts(), source->GetLines(),
+    source->GetPolys(), source->GetStrips()
+    };
+  for (int type=0; type<4; type++)
+    {
+    job.Cells[type] = NULL;
+    vtkIdType numCells = sourceCells[type]->GetNumberOfCells();
+    if ( numCells > 0 )
+      {
+      vtkCellArray *cells = vtkCellArray::New();
+      job.Cells[type] = cells->WritePointer(numDirs*numPts*numCells,
+        numDirs*numPts*sourceCells[type]->GetNumberOfConnectivityEntries());
+      switch (type)
+        {
+        case 0: output->SetVerts(cells); break;
+        case 1: output->SetLines(cells); break;
+        case 2: output->SetPolys(cells); break;
+        case 3: output->SetStrips(cells); break;
+        }
+      cells->Delete();
+      }
+    }
+
+  // only copy scalar data through
+  pd = source->GetPointData();
+  // generate scalars if eigenvalues are chosen or if scalars exist.
+  if (this->ColorGlyphs &&
+      ((this->ColorMode == COLOR_BY_EIGENVALUES) ||
+       (inScalars && (this->ColorMode == COLOR_BY_SCALARS)) ) )
+    {
+    newScalars = vtkFloatArray::New();
+    newScalars->SetNumberOfTuples(numOutPts);
+    if (this->ColorMode == COLOR_BY_EIGENVALUES)
+      {
+      newScalars->SetName("MaxEigenvalue");
+      }
+    else
+      {
+      newScalars->SetName(inScalars->GetName());
+      }
+    job.Scalars = newScalars->GetPointer(0);
+    }
+  else
+    {
+    outPD->CopyAllOff();
+    outPD->CopyScalarsOn();
+    outPD->CopyAllocate(pd,numOutPts);
+    job.SourceData = pd->GetScalars();
+    newData = outPD->GetScalars();
+    if (job.SourceData && newData)
+      {
+      newData->SetNumberOfTuples(numOutPts);
+      job.Data = newData;
+      }
+    }
+  if ( (sourceNormals = pd->GetNormals()) )
+    {
+    newNormals = vtkFloatArray::New();
+    newNormals->SetNumberOfComponents(3);
+    newNormals->SetName("Normals");
+    newNormals->SetNumberOfTuples(numOutPts);
+    job.SourceNormals = sourceNormals;
+    job.Normals = newNormals->GetPointer(0);
+    }
+
+  // The points are glyphed by contiguous ranges, one per thread.
+  job.NumberOfThreads = 1;
+  vtkMultiThreader *threader = vtkMultiThreader::New();
+  if (numPts >= 2*VTK_SQ_TENSOR_GLYPH_POINTS_PER_THREAD)
+    {
+    job.NumberOfThreads = threader->GetNumberOfThreads();
+    vtkIdType maxThreads = numPts/VTK_SQ_TENSOR_GLYPH_POINTS_PER_THREAD;
+    if (job.NumberOfThreads > maxThreads)
+      {
+      job.NumberOfThreads = static_cast<int>(maxThreads);
+      }
+    }
+  if (job.NumberOfThreads > 1)
+    {
+    threader->SetNumberOfThreads(job.NumberOfThreads);
+    threader->SetSingleMethod(vtkSQTensorGlyphJob::Thread, &job);
+    threader->SingleMethodExecute();
+    }
+  else
+    {
+    job.Run(0, numPts);
+    }
+  threader->Delete();
+
   vtkDebugMacro(<<"Generated " << numPts <<" tensor glyphs");
   //
   // Update output and release memory
   //
-  delete [] pts;
-
   output->SetPoints(newPts);
   newPts->Delete();
 
@@ -498,9 +631,10 @@ int vtkSQTensorGlyph::RequestData(
     newNormals->Delete();
     }
 
-  output->Squeeze();
-  trans->Delete();
-  matrix->Delete();
+  if ( newData )
+    {
+    newData->Modified();
+    }
 
   return 1;
 }
@@ -74,6 +74,12 @@ Copyright 2008 SciberQuest Inc.
 // column, always positive, is the eigenvalue).  This allows
 // additional capability over the vtkGlyph3D object. That is, the
 // glyph can be oriented in three directions instead of one.
+//
+// Every input point produces the same number of output points and cells,
+// so the output is allocated to its final size before any glyph is
+// generated. Large inputs are then split into contiguous ranges of points
+// glyphed in place by several threads. The output is the same whatever the
+// number of threads.
 
 // .SECTION Thanks
 // Thanks to Jose Paulo Moitinho de Almeida for enhancements.
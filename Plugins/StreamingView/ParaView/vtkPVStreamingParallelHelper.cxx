@@ -17,6 +17,36 @@
 #include "vtkMultiProcessController.h"
 #include "vtkObjectFactory.h"
 #include "vtkPVSynchronizedRenderWindows.h"
+#include "vtkToolkits.h" // For VTK_USE_MPI
+
+#ifdef VTK_USE_MPI
+#include "vtkMPICommunicator.h"
+#include "vtkMPIController.h"
+#endif
+
+#include <vtkstd/vector>
+
+class vtkPVStreamingParallelHelper::vtkInternals
+{
+public:
+  vtkInternals()
+  {
+    this->Posted = false;
+    this->Local = 0;
+    this->Result = 0;
+  }
+
+  // true when a BeginReduce has messages in flight
+  bool Posted;
+  int Local;
+  int Result;
+#ifdef VTK_USE_MPI
+  vtkstd::vector<int> Values;
+  vtkstd::vector<vtkMPICommunicator::Request> Requests;
+  vtkMPICommunicator::Request SendRequest;
+  vtkMPICommunicator::Request ResultRequest;
+#endif
+};
 
 vtkStandardNewMacro(vtkPVStreamingParallelHelper);
 
@@ -24,12 +54,14 @@ vtkStandardNewMacro(vtkPVStreamingParallelHelper);
 vtkPVStreamingParallelHelper::vtkPVStreamingParallelHelper()
 {
   this->SynchronizedWindows = NULL;
+  this->Internals = new vtkInternals();
 }
 
 //----------------------------------------------------------------------------
 vtkPVStreamingParallelHelper::~vtkPVStreamingParallelHelper()
 {
   this->SetSynchronizedWindows(NULL);
+  delete this->Internals;
 }
 
 //----------------------------------------------------------------------------
@@ -108,3 +140,175 @@ void vtkPVStreamingParallelHelper::Reduce(bool &flag)
 
   flag = value!=0; //convert back to bool without annoying msvc
 }
+
+//----------------------------------------------------------------------------
+void vtkPVStreamingParallelHelper::ReduceMinimum(double *values, int num)
+{
+  if (!this->SynchronizedWindows || num <= 0)
+    {
+    return;
+    }
+
+  vtkPVSynchronizedRenderWindows::ModeEnum mode =
+    this->SynchronizedWindows->GetMode();
+  if (mode == vtkPVSynchronizedRenderWindows::INVALID ||
+      mode == vtkPVSynchronizedRenderWindows::BUILTIN)
+    return;
+
+  vtkMultiProcessController* parallelController =
+    this->SynchronizedWindows->GetParallelController();
+  if (mode == vtkPVSynchronizedRenderWindows::BATCH &&
+      parallelController->GetNumberOfProcesses() <= 1)
+    {
+    return;
+    }
+  if (parallelController && mode != vtkPVSynchronizedRenderWindows::CLIENT)
+    {
+    vtkstd::vector<double> local(values, values+num);
+    parallelController->AllReduce(&local[0], values, num,
+                                  vtkCommunicator::MIN_OP);
+    }
+
+  vtkMultiProcessController* c_s_controller =
+    this->SynchronizedWindows->GetClientServerController();
+  switch (mode)
+    {
+    case vtkPVSynchronizedRenderWindows::CLIENT:
+      //client just obeys what the server tells it
+      c_s_controller->Receive(values, num, 1, STREAMING_REDUCE_TAG);
+      break;
+    default:
+      //server tells client what to do
+      //TODO: handle split ds/rs/client mode.
+      if (c_s_controller)
+        {
+        c_s_controller->Send(values, num, 1, STREAMING_REDUCE_TAG);
+        }
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkPVStreamingParallelHelper::BeginReduce(bool *flags, int num)
+{
+  this->Internals->Posted = false;
+  this->Internals->Local = 0;
+  for (int i = 0; i < num; i++)
+    {
+    if (flags[i])
+      {
+      this->Internals->Local |= (1<<i);
+      }
+    }
+
+  if (!this->SynchronizedWindows)
+    {
+    return;
+    }
+  vtkPVSynchronizedRenderWindows::ModeEnum mode =
+    this->SynchronizedWindows->GetMode();
+  if (mode == vtkPVSynchronizedRenderWindows::INVALID ||
+      mode == vtkPVSynchronizedRenderWindows::BUILTIN ||
+      mode == vtkPVSynchronizedRenderWindows::CLIENT)
+    {
+    return;
+    }
+
+#ifdef VTK_USE_MPI
+  vtkMPIController* controller = vtkMPIController::SafeDownCast
+    (this->SynchronizedWindows->GetParallelController());
+  if (!controller || controller->GetNumberOfProcesses() <= 1)
+    {
+    return;
+    }
+
+  int numProcs = controller->GetNumberOfProcesses();
+  if (controller->GetLocalProcessId() == 0)
+    {
+    this->Internals->Values.resize(numProcs, 0);
+    this->Internals->Requests.resize(numProcs);
+    for (int i = 1; i < numProcs; i++)
+      {
+      controller->NoBlockReceive(&this->Internals->Values[i], 1, i,
+                                 STREAMING_REDUCE_TAG,
+                                 this->Internals->Requests[i]);
+      }
+    }
+  else
+    {
+    controller->NoBlockSend(&this->Internals->Local, 1, 0,
+                            STREAMING_REDUCE_TAG,
+                            this->Internals->SendRequest);
+    controller->NoBlockReceive(&this->Internals->Result, 1, 0,
+                               STREAMING_RESULT_TAG,
+                               this->Internals->ResultRequest);
+    }
+  this->Internals->Posted = true;
+#endif
+}
+
+//----------------------------------------------------------------------------
+void vtkPVStreamingParallelHelper::EndReduce(bool *flags, int num)
+{
+  if (!this->Internals->Posted)
+    {
+    //nothing in flight, use the blocking exchange
+    this->Superclass::EndReduce(flags, num);
+    return;
+    }
+  this->Internals->Posted = false;
+
+  int value = this->Internals->Local;
+#ifdef VTK_USE_MPI
+  vtkMPIController* controller = vtkMPIController::SafeDownCast
+    (this->SynchronizedWindows->GetParallelController());
+  int numProcs = controller->GetNumberOfProcesses();
+  if (controller->GetLocalProcessId() == 0)
+    {
+    //server nodes all continue if any needs to
+    for (int i = 1; i < numProcs; i++)
+      {
+      this->Internals->Requests[i].Wait();
+      value |= this->Internals->Values[i];
+      }
+    vtkstd::vector<vtkMPICommunicator::Request> sends(numProcs);
+    for (int i = 1; i < numProcs; i++)
+      {
+      controller->NoBlockSend(&value, 1, i, STREAMING_RESULT_TAG, sends[i]);
+      }
+    for (int i = 1; i < numProcs; i++)
+      {
+      sends[i].Wait();
+      }
+    }
+  else
+    {
+    this->Internals->SendRequest.Wait();
+    this->Internals->ResultRequest.Wait();
+    value = this->Internals->Result;
+    }
+#endif
+
+  for (int i = 0; i < num; i++)
+    {
+    flags[i] = (value & (1<<i)) != 0;
+    }
+  this->ExchangeWithClient(flags, num);
+}
+
+//----------------------------------------------------------------------------
+void vtkPVStreamingParallelHelper::ExchangeWithClient(bool *flags, int num)
+{
+  vtkMultiProcessController* c_s_controller =
+    this->SynchronizedWindows->GetClientServerController();
+  if (!c_s_controller)
+    {
+    return;
+    }
+
+  //one message per flag, to match what Reduce does on the client
+  for (int i = 0; i < num; i++)
+    {
+    int value = (int)flags[i];
+    c_s_controller->Send(&value, 1, 1, STREAMING_REDUCE_TAG);
+    }
+}
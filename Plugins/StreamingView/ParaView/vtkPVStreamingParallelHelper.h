@@ -38,6 +38,18 @@ public:
   //the value of flag.
   void Reduce(bool &flag);
 
+  //Description:
+  //A command that is called in parallel to make all processors agree on
+  //the minimum of each value.
+  void ReduceMinimum(double *values, int num);
+
+  //Description:
+  //Overridden to post the flags to the root node with non-blocking messages
+  //in BeginReduce, so that the exchange proceeds while this node renders.
+  //The root combines them and answers in EndReduce.
+  virtual void BeginReduce(bool *flags, int num);
+  virtual void EndReduce(bool *flags, int num);
+
   //Description:
   // We use the parallel synchronized render windows as a conduit to communicators
   // and to query rendering mode, remote, client, tile etc.
@@ -52,13 +64,21 @@ protected:
   vtkPVSynchronizedRenderWindows *SynchronizedWindows;
 
   enum {
-    STREAMING_REDUCE_TAG = 838666
+    STREAMING_REDUCE_TAG = 838666,
+    STREAMING_RESULT_TAG = 838667
   };
 
+  // Description:
+  // Tells the client the flags that the server nodes agreed upon.
+  void ExchangeWithClient(bool *flags, int num);
+
 private:
   vtkPVStreamingParallelHelper(const vtkPVStreamingParallelHelper&);  // Not implemented.
   void operator=(const vtkPVStreamingParallelHelper&);  // Not implemented.
 
+  class vtkInternals;
+  vtkInternals *Internals;
+
 //ETX
 };
 
@@ -19,6 +19,7 @@
 #include "vtkObjectFactory.h"
 #include "vtkParallelStreamHelper.h"
 #include "vtkPieceCacheFilter.h"
+#include "vtkPieceFetcher.h"
 #include "vtkPieceList.h"
 #include "vtkRenderer.h"
 #include "vtkRenderWindow.h"
@@ -42,6 +43,8 @@ public:
     this->StopNow = false;
     this->RefineNow = false;
     this->CoarsenNow = false;
+    this->ReducePosted = false;
+    this->DoneFlags[0] = this->DoneFlags[1] = false;
   }
   ~Internals()
   {
@@ -51,6 +54,9 @@ public:
   bool StopNow;
   bool RefineNow;
   bool CoarsenNow;
+  //completely done and wend done, agreed on while the pass renders
+  bool ReducePosted;
+  bool DoneFlags[2];
 };
 
 //----------------------------------------------------------------------------
@@ -329,6 +335,9 @@ void vtkMultiResolutionStreamer::PrepareFirstPass()
     //sort list of pieces in most to least important order
     ToDo->SortPriorities();
 
+    //queue up what we will need next
+    this->PrefetchPieces(harness, ToDo, 0);
+
     //setup pipeline to show the first one in the upcoming render
     vtkPiece p = ToDo->GetPiece(0);
     harness->SetPiece(p.GetPiece());
@@ -868,7 +877,25 @@ void vtkMultiResolutionStreamer::PrepareNextPass()
     vtkPieceList *NextFrame = harness->GetPieceList2();
     if (ToDo && NextFrame && (ToDo->GetNumberNonZeroPriority() > 0))
       {
-      vtkPiece p = ToDo->PopPiece();
+      int choice = 0;
+      vtkPieceCacheFilter *pcf = harness->GetCacheFilter();
+      if (this->GetPieceFetcher() && pcf)
+        {
+        //rather than wait on the readers, draw the most important piece
+        //that has already been fetched
+        int important = ToDo->GetNumberNonZeroPriority();
+        for (int i = 0; i < important; i++)
+          {
+          vtkPiece candidate = ToDo->GetPiece(i);
+          if (pcf->InCache(candidate.GetPiece(), candidate.GetNumPieces(),
+                           candidate.GetResolution()))
+            {
+            choice = i;
+            break;
+            }
+          }
+        }
+      vtkPiece p = ToDo->PopPiece(choice);
       NextFrame->AddPiece(p);
       //adjust pipeline to draw the chosen piece
       DEBUGPRINT_PASSES
@@ -886,6 +913,8 @@ void vtkMultiResolutionStreamer::PrepareNextPass()
       //producing the stale (lower res?) results without it.
       harness->ComputePiecePriority(p.GetPiece(), p.GetNumPieces(),
                                     p.GetResolution());
+
+      this->PrefetchPieces(harness, ToDo, 0);
       }
     }
 
@@ -903,6 +932,17 @@ void vtkMultiResolutionStreamer::StartRenderEvent()
   vtkRenderer *ren = this->GetRenderer();
   vtkRenderWindow *rw = this->GetRenderWindow();
 
+  //a render that was aborted never got to EndRenderEvent, finish the
+  //reduction it posted so that the next one matches on every processor
+  if (this->Internal->ReducePosted)
+    {
+    if (this->GetParallelHelper())
+      {
+      this->GetParallelHelper()->EndReduce(this->Internal->DoneFlags, 2);
+      }
+    this->Internal->ReducePosted = false;
+    }
+
   bool firstPass = this->IsFirstPass();
   if (this->GetParallelHelper())
     {
@@ -953,6 +993,16 @@ void vtkMultiResolutionStreamer::StartRenderEvent()
 
   //assume that we are not done covering all the domains
   this->Internal->StartOver = false;
+
+  //nothing that decides whether we are done changes while the pass renders,
+  //so agree on it in parallel with the render
+  this->Internal->DoneFlags[0] = this->IsCompletelyDone();
+  this->Internal->DoneFlags[1] = this->IsWendDone();
+  if (this->GetParallelHelper())
+    {
+    this->GetParallelHelper()->BeginReduce(this->Internal->DoneFlags, 2);
+    }
+  this->Internal->ReducePosted = true;
 }
 
 //----------------------------------------------------------------------------
@@ -1079,6 +1129,29 @@ void vtkMultiResolutionStreamer::EndRenderEvent()
      cerr << "ER " << endl;
      );
 
+  bool allDone;
+  bool wendDone;
+  if (this->Internal->ReducePosted)
+    {
+    if (this->GetParallelHelper())
+      {
+      this->GetParallelHelper()->EndReduce(this->Internal->DoneFlags, 2);
+      }
+    this->Internal->ReducePosted = false;
+    allDone = this->Internal->DoneFlags[0];
+    wendDone = this->Internal->DoneFlags[1];
+    }
+  else
+    {
+    allDone = this->IsCompletelyDone();
+    wendDone = this->IsWendDone();
+    if (this->GetParallelHelper())
+      {
+      this->GetParallelHelper()->Reduce(allDone);
+      this->GetParallelHelper()->Reduce(wendDone);
+      }
+    }
+
   vtkRenderer *ren = this->GetRenderer();
   vtkRenderWindow *rw = this->GetRenderWindow();
   if (!ren || !rw)
@@ -1091,11 +1164,6 @@ void vtkMultiResolutionStreamer::EndRenderEvent()
   ren->EraseOff();
   rw->EraseOff();
 
-  bool allDone = this->IsCompletelyDone();
-  if (this->GetParallelHelper())
-    {
-    this->GetParallelHelper()->Reduce(allDone);
-    }
   if (allDone)
     {
     DEBUGPRINT_PASSES(cerr << "ALL DONE" << endl;);
@@ -1107,11 +1175,6 @@ void vtkMultiResolutionStreamer::EndRenderEvent()
     }
   else
     {
-    bool wendDone = this->IsWendDone();
-    if (this->GetParallelHelper())
-      {
-      this->GetParallelHelper()->Reduce(wendDone);
-      }
     if (wendDone)
       {
       DEBUGPRINT_PASSES(cerr << "WEND DONE" << endl;);
@@ -1123,6 +1186,10 @@ void vtkMultiResolutionStreamer::EndRenderEvent()
       this->CopyBackBufferToFront();
       }
 
+    //get a piece ready for a later pass while this one is on screen,
+    //every processor takes part so pipelines that communicate stay in step
+    this->FetchNextPiece();
+
     //there is more to draw, so keep going
     this->RenderEventually();
     }
@@ -1138,6 +1205,10 @@ void vtkMultiResolutionStreamer::RestartStreaming()
 void vtkMultiResolutionStreamer::StopStreaming()
 {
   this->Internal->StopNow = true;
+  if (this->GetPieceFetcher())
+    {
+    this->GetPieceFetcher()->Cancel();
+    }
 }
 
 //------------------------------------------------------------------------------
@@ -33,3 +33,18 @@ void vtkParallelStreamHelper::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os,indent);
 }
+
+//----------------------------------------------------------------------------
+void vtkParallelStreamHelper::BeginReduce(bool *vtkNotUsed(flags),
+                                          int vtkNotUsed(num))
+{
+}
+
+//----------------------------------------------------------------------------
+void vtkParallelStreamHelper::EndReduce(bool *flags, int num)
+{
+  for (int i = 0; i < num; i++)
+    {
+    this->Reduce(flags[i]);
+    }
+}
@@ -37,6 +37,22 @@ public:
   //the value of flag.
   virtual void Reduce(bool &vtkNotUsed(flag)) {};
 
+  //Description:
+  //A command that is called in parallel to make all processors agree on a
+  //choice. Each value is replaced by its minimum over all processors.
+  virtual void ReduceMinimum(double *vtkNotUsed(values),
+                             int vtkNotUsed(num)) {};
+
+  //Description:
+  //Split phase version of Reduce for several flags at once. BeginReduce
+  //posts this processor's flags and returns right away so that callers can
+  //overlap the communication with rendering. EndReduce waits until every
+  //processor agrees and overwrites flags with the result. The flags array
+  //must stay valid in between. The default implementation simply calls
+  //Reduce on each flag in EndReduce.
+  virtual void BeginReduce(bool *flags, int num);
+  virtual void EndReduce(bool *flags, int num);
+
 //BTX
 protected:
   vtkParallelStreamHelper();
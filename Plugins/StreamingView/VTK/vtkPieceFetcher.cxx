@@ -0,0 +1,188 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    vtkPieceFetcher.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkPieceFetcher.h"
+
+#include "vtkObjectFactory.h"
+#include "vtkPieceCacheFilter.h"
+#include "vtkStreamingHarness.h"
+
+#include <vtksys/stl/vector>
+
+#define DEBUGPRINT_FETCH( arg ) ;
+
+vtkStandardNewMacro(vtkPieceFetcher);
+
+class vtkPieceFetcher::Internals
+{
+public:
+  struct Request
+  {
+    vtkStreamingHarness *Harness;
+    vtkPiece Piece;
+  };
+
+  Internals(vtkPieceFetcher *owner)
+  {
+    this->Owner = owner;
+  }
+  ~Internals()
+  {
+    this->ReleaseQueued();
+  }
+
+  void ReleaseQueued()
+  {
+    for (size_t i = 0; i < this->Queue.size(); i++)
+      {
+      this->Queue[i].Harness->UnRegister(this->Owner);
+      }
+    this->Queue.clear();
+  }
+
+  vtkPieceFetcher *Owner;
+  vtksys_stl::vector<Request> Queue;
+};
+
+//----------------------------------------------------------------------------
+vtkPieceFetcher::vtkPieceFetcher()
+{
+  this->Internal = new Internals(this);
+}
+
+//----------------------------------------------------------------------------
+vtkPieceFetcher::~vtkPieceFetcher()
+{
+  delete this->Internal;
+}
+
+//----------------------------------------------------------------------------
+void vtkPieceFetcher::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os,indent);
+  os << indent << "Queued: " << this->Internal->Queue.size() << endl;
+}
+
+//----------------------------------------------------------------------------
+void vtkPieceFetcher::Enqueue(vtkStreamingHarness *harness, vtkPiece piece)
+{
+  if (!harness)
+    {
+    return;
+    }
+
+  for (size_t i = 0; i < this->Internal->Queue.size(); i++)
+    {
+    Internals::Request &rqst = this->Internal->Queue[i];
+    if (rqst.Harness == harness &&
+        rqst.Piece.GetPiece() == piece.GetPiece() &&
+        rqst.Piece.GetNumPieces() == piece.GetNumPieces())
+      {
+      rqst.Piece = piece;
+      return;
+      }
+    }
+
+  DEBUGPRINT_FETCH
+    (
+     cerr << "ENQUEUE " << piece.GetPiece() << "/" << piece.GetNumPieces()
+     << "@" << piece.GetResolution() << endl;
+     );
+  harness->Register(this);
+  Internals::Request rqst;
+  rqst.Harness = harness;
+  rqst.Piece = piece;
+  this->Internal->Queue.push_back(rqst);
+}
+
+//----------------------------------------------------------------------------
+void vtkPieceFetcher::Cancel()
+{
+  this->Internal->ReleaseQueued();
+}
+
+//----------------------------------------------------------------------------
+int vtkPieceFetcher::GetNumberOfQueuedPieces()
+{
+  return static_cast<int>(this->Internal->Queue.size());
+}
+
+//----------------------------------------------------------------------------
+double vtkPieceFetcher::GetHighestPriority(vtkStreamingHarness *harness)
+{
+  Internals *internal = this->Internal;
+  vtkPieceCacheFilter *pcf = harness ? harness->GetCacheFilter() : NULL;
+  double priority = -1.0;
+  size_t i = 0;
+  while (i < internal->Queue.size())
+    {
+    Internals::Request &rqst = internal->Queue[i];
+    if (rqst.Harness != harness)
+      {
+      i++;
+      continue;
+      }
+    if (!pcf || pcf->InCache(rqst.Piece.GetPiece(),
+                             rqst.Piece.GetNumPieces(),
+                             rqst.Piece.GetResolution()))
+      {
+      //fetching it would not execute the pipeline
+      rqst.Harness->UnRegister(this);
+      internal->Queue.erase(internal->Queue.begin()+i);
+      continue;
+      }
+    if (rqst.Piece.GetPriority() > priority)
+      {
+      priority = rqst.Piece.GetPriority();
+      }
+    i++;
+    }
+  return priority;
+}
+
+//----------------------------------------------------------------------------
+bool vtkPieceFetcher::FetchNext(vtkStreamingHarness *harness)
+{
+  Internals *internal = this->Internal;
+
+  //take the most important piece of the harness
+  size_t best = internal->Queue.size();
+  for (size_t i = 0; i < internal->Queue.size(); i++)
+    {
+    if (internal->Queue[i].Harness == harness &&
+        (best == internal->Queue.size() ||
+         internal->Queue[i].Piece.ComparePriority(internal->Queue[best].Piece)))
+      {
+      best = i;
+      }
+    }
+  if (best == internal->Queue.size())
+    {
+    return false;
+    }
+  Internals::Request rqst = internal->Queue[best];
+  internal->Queue.erase(internal->Queue.begin()+best);
+
+  DEBUGPRINT_FETCH
+    (
+     cerr << "FETCH " << rqst.Piece.GetPiece() << "/"
+     << rqst.Piece.GetNumPieces() << "@"
+     << rqst.Piece.GetResolution() << endl;
+     );
+  rqst.Harness->PrefetchPiece(rqst.Piece.GetPiece(),
+                              rqst.Piece.GetNumPieces(),
+                              rqst.Piece.GetResolution());
+  rqst.Harness->UnRegister(this);
+  return true;
+}
@@ -0,0 +1,88 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    vtkPieceFetcher.h
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME vtkPieceFetcher - fetches streamed pieces ahead of the pass that draws them
+// .SECTION Description
+// vtkPieceFetcher lets a vtkStreamingDriver execute the pieces that it
+// expects to draw next before the passes that draw them. Each request names
+// a harness and a piece. FetchNext updates the pipeline upstream of that
+// harness' vtkPieceCacheFilter so that the result lands in the cache, from
+// where a later pass picks it up without executing the readers.
+//
+// VTK pipelines are not thread safe and the streamed pipelines may contain
+// filters that communicate across processes, so pieces are executed on the
+// render thread, in between passes, which the fetch delays. In parallel the
+// driver makes every processor call FetchNext for the same harness, so that
+// every processor updates the same pipeline together.
+// .SECTION See Also
+// vtkStreamingDriver vtkPieceCacheFilter
+
+#ifndef __vtkPieceFetcher_h
+#define __vtkPieceFetcher_h
+
+#include "vtkObject.h"
+#include "vtkPiece.h" // for vtkPiece
+
+class vtkStreamingHarness;
+
+class VTK_EXPORT vtkPieceFetcher : public vtkObject
+{
+public:
+  static vtkPieceFetcher *New();
+  vtkTypeMacro(vtkPieceFetcher,vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent);
+
+  //BTX
+  // Description:
+  // Queues a piece to be fetched into harness' cache. Queued pieces are
+  // fetched in decreasing priority order. Queueing a piece that is already
+  // waiting only updates its priority.
+  void Enqueue(vtkStreamingHarness *harness, vtkPiece piece);
+  //ETX
+
+  // Description:
+  // Discards every queued request. Drivers call this when the camera moves
+  // so that no time is spent on pieces that became unimportant.
+  void Cancel();
+
+  // Description:
+  // Returns the number of requests that are waiting to be fetched.
+  int GetNumberOfQueuedPieces();
+
+  // Description:
+  // Forgets the requests of harness whose piece has been cached since, and
+  // returns the priority of the most important one left, or -1 if there is
+  // none.
+  double GetHighestPriority(vtkStreamingHarness *harness);
+
+  // Description:
+  // Executes the most important queued piece of harness into its cache.
+  // Returns false if none was queued.
+  bool FetchNext(vtkStreamingHarness *harness);
+
+//BTX
+protected:
+  vtkPieceFetcher();
+  ~vtkPieceFetcher();
+
+private:
+  vtkPieceFetcher(const vtkPieceFetcher&);  // Not implemented.
+  void operator=(const vtkPieceFetcher&);  // Not implemented.
+
+  class Internals;
+  Internals *Internal;
+//ETX
+};
+
+#endif
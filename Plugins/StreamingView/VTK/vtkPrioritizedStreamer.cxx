@@ -19,6 +19,7 @@
 #include "vtkObjectFactory.h"
 #include "vtkParallelStreamHelper.h"
 #include "vtkPieceCacheFilter.h"
+#include "vtkPieceFetcher.h"
 #include "vtkPieceList.h"
 #include "vtkRenderer.h"
 #include "vtkRenderWindow.h"
@@ -39,6 +40,8 @@ public:
     this->StartOver = true;
     this->DebugPass = 0;
     this->StopNow = false;
+    this->ReducePosted = false;
+    this->AllDone = false;
   }
   ~Internals()
   {
@@ -47,6 +50,9 @@ public:
   vtkPrioritizedStreamer *Owner;
   bool StartOver;
   bool StopNow;
+  //all done, agreed on while the pass renders
+  bool ReducePosted;
+  bool AllDone;
   int DebugPass;  //used solely for debug messages
 };
 
@@ -210,6 +216,9 @@ void vtkPrioritizedStreamer::PrepareFirstPass()
     //this is a hack
     harness->SetPass(-1);
     //but I can't get the first piece to show consistently without it
+
+    //queue up what we will need next
+    this->PrefetchPieces(harness, pl, 0);
     }
   iter->Delete();
 }
@@ -247,6 +256,28 @@ void vtkPrioritizedStreamer::PrepareNextPass()
 
     //map that to an absolute piece number, but don't got beyond end
     vtkPieceList *pl = harness->GetPieceList1();
+    vtkPieceCacheFilter *pcf = harness->GetCacheFilter();
+    if (this->GetPieceFetcher() && pcf && passNext < maxPass &&
+        pl->GetPiece(passNext).GetPriority() &&
+        !pcf->InCache(pl->GetPiece(passNext).GetPiece(), maxPass, 1.0))
+      {
+      //rather than wait on the readers, bring the most important piece that
+      //has already been fetched forward to this pass
+      for (int i = passNext+1; i < maxPass; i++)
+        {
+        vtkPiece candidate = pl->GetPiece(i);
+        if (!candidate.GetPriority())
+          {
+          break;
+          }
+        if (pcf->InCache(candidate.GetPiece(), maxPass, 1.0))
+          {
+          pl->SetPiece(i, pl->GetPiece(passNext));
+          pl->SetPiece(passNext, candidate);
+          break;
+          }
+        }
+      }
     double priority = pl->GetPiece(passNext).GetPriority();
     if (priority)
       {
@@ -256,6 +287,7 @@ void vtkPrioritizedStreamer::PrepareNextPass()
          cerr <<harness<<" NP PASS "<<passNext<<" PIECE "<<pieceNext<<endl;
          );
       harness->SetPiece(pieceNext);
+      this->PrefetchPieces(harness, pl, passNext+1);
       }
    }
 
@@ -272,6 +304,17 @@ void vtkPrioritizedStreamer::StartRenderEvent()
   vtkRenderer *ren = this->GetRenderer();
   vtkRenderWindow *rw = this->GetRenderWindow();
 
+  //a render that was aborted never got to EndRenderEvent, finish the
+  //reduction it posted so that the next one matches on every processor
+  if (this->Internal->ReducePosted)
+    {
+    if (this->GetParallelHelper())
+      {
+      this->GetParallelHelper()->EndReduce(&this->Internal->AllDone, 1);
+      }
+    this->Internal->ReducePosted = false;
+    }
+
   bool firstPass = this->IsFirstPass();
   if (this->GetParallelHelper())
     {
@@ -315,6 +358,15 @@ void vtkPrioritizedStreamer::StartRenderEvent()
 
   //assume that we are not done covering all the domains
   this->Internal->StartOver = false;
+
+  //nothing that decides whether we are done changes while the pass renders,
+  //so agree on it in parallel with the render
+  this->Internal->AllDone = this->IsEveryoneDone()||this->Internal->StopNow;
+  if (this->GetParallelHelper())
+    {
+    this->GetParallelHelper()->BeginReduce(&this->Internal->AllDone, 1);
+    }
+  this->Internal->ReducePosted = true;
 }
 
 //----------------------------------------------------------------------------
@@ -376,6 +428,25 @@ void vtkPrioritizedStreamer::EndRenderEvent()
      this->Internal->DebugPass++;
      );
 
+  bool allDone;
+  if (this->Internal->ReducePosted)
+    {
+    if (this->GetParallelHelper())
+      {
+      this->GetParallelHelper()->EndReduce(&this->Internal->AllDone, 1);
+      }
+    this->Internal->ReducePosted = false;
+    allDone = this->Internal->AllDone;
+    }
+  else
+    {
+    allDone = this->IsEveryoneDone()||this->Internal->StopNow;
+    if (this->GetParallelHelper())
+      {
+      this->GetParallelHelper()->Reduce(allDone);
+      }
+    }
+
   vtkRenderer *ren = this->GetRenderer();
   vtkRenderWindow *rw = this->GetRenderWindow();
   if (!ren || !rw)
@@ -387,11 +458,6 @@ void vtkPrioritizedStreamer::EndRenderEvent()
   ren->EraseOff();
   rw->EraseOff();
 
-  bool allDone = this->IsEveryoneDone()||this->Internal->StopNow;
-  if (this->GetParallelHelper())
-    {
-    this->GetParallelHelper()->Reduce(allDone);
-    }
   if (allDone)
     {
     DEBUGPRINT_PASSES(cerr << "ALLDONE SHOW" << endl;);
@@ -409,6 +475,10 @@ void vtkPrioritizedStreamer::EndRenderEvent()
       this->CopyBackBufferToFront();
       }
 
+    //get a piece ready for a later pass while this one is on screen,
+    //every processor takes part so pipelines that communicate stay in step
+    this->FetchNextPiece();
+
     //we haven't finished yet so schedule the next pass
     DEBUGPRINT_PASSES(cerr << "RENDER EVENTUALLY" << endl;);
     this->RenderEventually();
@@ -425,6 +495,10 @@ void vtkPrioritizedStreamer::RestartStreaming()
 void vtkPrioritizedStreamer::StopStreaming()
 {
   this->Internal->StopNow = true;
+  if (this->GetPieceFetcher())
+    {
+    this->GetPieceFetcher()->Cancel();
+    }
 }
 
 //------------------------------------------------------------------------------
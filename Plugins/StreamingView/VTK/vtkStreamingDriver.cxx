@@ -22,6 +22,8 @@
 #include "vtkObjectFactory.h"
 #include "vtkParallelStreamHelper.h"
 #include "vtkPieceCacheFilter.h"
+#include "vtkPieceFetcher.h"
+#include "vtkPieceList.h"
 #include "vtkRenderer.h"
 #include "vtkRenderWindow.h"
 #include "vtkRenderWindowInteractor.h"
@@ -29,6 +31,8 @@
 #include "vtkUnsignedCharArray.h"
 #include "vtkVisibilityPrioritizer.h"
 
+#include <vtksys/stl/vector>
+
 class vtkStreamingDriver::Internals
 {
 public:
@@ -49,9 +53,14 @@ public:
       }
     this->PixelArray = NULL;
     this->ParallelHelper = NULL;
+    this->Fetcher = NULL;
   }
   ~Internals()
   {
+    if (this->Fetcher)
+      {
+      this->Fetcher->Delete();
+      }
     this->Owner->SetRenderer(NULL);
     this->Owner->SetRenderWindow(NULL);
     if (this->WindowWatcher)
@@ -79,6 +88,7 @@ public:
   void *RenderLaterArgument;
   vtkUnsignedCharArray *PixelArray;
   vtkParallelStreamHelper *ParallelHelper;
+  vtkPieceFetcher *Fetcher;
   //auxilliary functionality, that help view sorting sublasses
   vtkVisibilityPrioritizer *ViewSorter;
   double LastCamera[9];
@@ -118,6 +128,8 @@ vtkStreamingDriver::vtkStreamingDriver()
 
   this->DisplayFrequency = 0;
   this->CacheSize = 32;
+  this->Prefetching = 0;
+  this->PrefetchDepth = 4;
 }
 
 //----------------------------------------------------------------------------
@@ -130,6 +142,9 @@ vtkStreamingDriver::~vtkStreamingDriver()
 void vtkStreamingDriver::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os,indent);
+  os << indent << "Prefetching: " << this->Prefetching
+     << endl;
+  os << indent << "PrefetchDepth: " << this->PrefetchDepth << endl;
 }
 
 //----------------------------------------------------------------------------
@@ -308,6 +323,12 @@ bool vtkStreamingDriver::HasCameraMoved()
     }
   if (changed)
     {
+    //whatever was queued was chosen for the old viewpoint
+    if (this->Internal->Fetcher)
+      {
+      this->Internal->Fetcher->Cancel();
+      }
+
     //convert screen rectangle to world frustum
     const double HALFEXT=1.0; //1.0 means all way to edge of screen
     const double XMAX=HALFEXT;
@@ -461,3 +482,99 @@ vtkVisibilityPrioritizer *vtkStreamingDriver::GetVisibilityPrioritizer()
 {
   return this->Internal->ViewSorter;
 }
+
+//------------------------------------------------------------------------------
+void vtkStreamingDriver::SetPrefetching(int nv)
+{
+  if (this->Prefetching == nv)
+    {
+    return;
+    }
+  this->Prefetching = nv;
+  if (nv && !this->Internal->Fetcher)
+    {
+    this->Internal->Fetcher = vtkPieceFetcher::New();
+    }
+  else if (!nv && this->Internal->Fetcher)
+    {
+    this->Internal->Fetcher->Delete();
+    this->Internal->Fetcher = NULL;
+    }
+  this->Modified();
+}
+
+//------------------------------------------------------------------------------
+vtkPieceFetcher *vtkStreamingDriver::GetPieceFetcher()
+{
+  return this->Internal->Fetcher;
+}
+
+//------------------------------------------------------------------------------
+void vtkStreamingDriver::PrefetchPieces(vtkStreamingHarness *harness,
+                                        vtkPieceList *pl, int first)
+{
+  vtkPieceFetcher *fetcher = this->GetPieceFetcher();
+  vtkPieceCacheFilter *pcf = harness->GetCacheFilter();
+  if (!fetcher || !pcf || !pl)
+    {
+    return;
+    }
+
+  int queued = 0;
+  int max = pl->GetNumberOfPieces();
+  for (int i = first; i < max && queued < this->PrefetchDepth; i++)
+    {
+    vtkPiece piece = pl->GetPiece(i);
+    if (piece.GetPriority() == 0.0)
+      {
+      //list is sorted, nothing after this is worth drawing
+      break;
+      }
+    if (pcf->InCache(piece.GetPiece(), piece.GetNumPieces(),
+                     piece.GetResolution()))
+      {
+      continue;
+      }
+    fetcher->Enqueue(harness, piece);
+    queued++;
+    }
+}
+
+//------------------------------------------------------------------------------
+void vtkStreamingDriver::FetchNextPiece()
+{
+  vtkPieceFetcher *fetcher = this->GetPieceFetcher();
+  vtkCollection *harnesses = this->GetHarnesses();
+  int num = harnesses ? harnesses->GetNumberOfItems() : 0;
+  if (!fetcher || num == 0)
+    {
+    return;
+    }
+
+  //a harness that some processor has nothing queued for ends up at -1
+  vtksys_stl::vector<double> priorities(num);
+  int i;
+  for (i = 0; i < num; i++)
+    {
+    priorities[i] = fetcher->GetHighestPriority
+      (vtkStreamingHarness::SafeDownCast(harnesses->GetItemAsObject(i)));
+    }
+  if (this->GetParallelHelper())
+    {
+    this->GetParallelHelper()->ReduceMinimum(&priorities[0], num);
+    }
+
+  int best = -1;
+  for (i = 0; i < num; i++)
+    {
+    if (priorities[i] > 0.0 && (best == -1 || priorities[i] > priorities[best]))
+      {
+      best = i;
+      }
+    }
+  if (best != -1)
+    {
+    fetcher->FetchNext
+      (vtkStreamingHarness::SafeDownCast(harnesses->GetItemAsObject(best)));
+    }
+}
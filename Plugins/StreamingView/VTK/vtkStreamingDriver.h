@@ -29,6 +29,8 @@
 class vtkCallbackCommand;
 class vtkCollection;
 class vtkParallelStreamHelper;
+class vtkPieceFetcher;
+class vtkPieceList;
 class vtkRenderer;
 class vtkRenderWindow;
 class vtkStreamingHarness;
@@ -87,6 +89,23 @@ public:
   void SetCacheSize(int);
   vtkGetMacro(CacheSize, int);
 
+  //Description:
+  //When on, after each pass the driver executes one of the pieces that it
+  //expects to draw soon into the piece cache, and each pass draws the most
+  //important piece that is already cached instead of waiting for the
+  //readers. This is not asynchronous: the piece is executed on the render
+  //thread, after the pass is shown and before the next one is scheduled.
+  //In parallel all processors execute a piece of the same harness, so that
+  //pipelines with communicating filters stay in step. Default is 0, off.
+  void SetPrefetching(int);
+  vtkGetMacro(Prefetching, int);
+
+  //Description:
+  //How many pieces ahead of the one being drawn are queued for fetching
+  //when Prefetching is on. Default is 4.
+  vtkSetClampMacro(PrefetchDepth, int, 1, VTK_INT_MAX);
+  vtkGetMacro(PrefetchDepth, int);
+
   //Description:
   //A command to restart streaming on next render.
   virtual void RestartStreaming() = 0;
@@ -137,11 +156,31 @@ protected:
   // So subclasses can tune it's behavior.
   vtkVisibilityPrioritizer * GetVisibilityPrioritizer();
 
+  // Description:
+  // The queue of pieces to execute ahead of time. NULL unless
+  // Prefetching is on.
+  vtkPieceFetcher * GetPieceFetcher();
+
+  // Description:
+  // When prefetching is on, queues up to PrefetchDepth not yet cached
+  // pieces with nonzero priority from the list, starting at first.
+  void PrefetchPieces(vtkStreamingHarness *, vtkPieceList *, int first);
+
+  // Description:
+  // Executes one queued piece. Must be called on all processors alike. The
+  // processors agree, with one reduction, on the harness whose pieces are
+  // the most important among those that every processor has queued, and
+  // each executes its most important piece of that harness. Nothing is
+  // executed if there is no such harness.
+  void FetchNextPiece();
+
   bool ManualStart;
   bool ManualFinish;
 
   int CacheSize;
   int DisplayFrequency;
+  int Prefetching;
+  int PrefetchDepth;
 
 private:
   vtkStreamingDriver(const vtkStreamingDriver&);  // Not implemented.
@@ -377,6 +377,47 @@ void vtkStreamingHarness::ComputePieceMetaInformation(
   this->ForOther = false;
 }
 
+//----------------------------------------------------------------------------
+bool vtkStreamingHarness::PrefetchPiece(
+  int piece, int NumPieces, double resolution)
+{
+  if (!this->CacheFilter)
+    {
+    return false;
+    }
+  if (this->CacheFilter->InCache(piece, NumPieces, resolution))
+    {
+    return true;
+    }
+
+  vtkStreamingDemandDrivenPipeline* sddp =
+    vtkStreamingDemandDrivenPipeline::SafeDownCast
+    (this->CacheFilter->GetExecutive());
+  if (!sddp)
+    {
+    return false;
+    }
+
+  //get initial pipeline setting
+  vtkInformation *outInfo = sddp->GetOutputInformation(0);
+  int oldPiece = sddp->GetUpdatePiece(outInfo);
+  int oldNumPieces = sddp->GetUpdateNumberOfPieces(outInfo);
+  double oldResolution = sddp->GetUpdateResolution(outInfo);
+
+  //change to new setting and execute, which leaves the result in the cache
+  sddp->SetUpdatePiece(outInfo, piece);
+  sddp->SetUpdateNumberOfPieces(outInfo, NumPieces);
+  sddp->SetUpdateResolution(outInfo, resolution);
+  sddp->Update(0);
+
+  //restore the old setting
+  sddp->SetUpdatePiece(outInfo, oldPiece);
+  sddp->SetUpdateNumberOfPieces(outInfo, oldNumPieces);
+  sddp->SetUpdateResolution(outInfo, oldResolution);
+
+  return true;
+}
+
 //----------------------------------------------------------------------------
 bool vtkStreamingHarness::InAppend(
   int piece, int NumPieces, double resolution)
@@ -84,6 +84,13 @@ public:
      double &min, double &max, double &attribute_confidence,
      unsigned long &numCells, double **pNormal);
 
+  //Description:
+  //executes the pipeline upstream of the cache filter for a particular piece
+  //so that the result is cached for a later pass. The harness' own output
+  //and its Piece, NumberOfPieces and Resolution are not affected.
+  //Returns false if there is no cache filter to hold the result.
+  bool PrefetchPiece(int Piece, int NumPieces, double Resolution);
+
   //Description:
   //determines if the piece is in the piece cache filter's append slot
   bool InAppend(int Pieces, int NumPieces, double Resolution);
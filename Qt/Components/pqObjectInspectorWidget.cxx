@@ -46,6 +46,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 // ParaView Server Manager includes
 #include <vtkSMProxy.h>
+#include <vtkSMSession.h>
 
 // ParaView includes
 #include "pqApplicationCore.h"
@@ -500,6 +501,17 @@ void pqObjectInspectorWidget::accept()
 
   QSet<pqProxy*> proxies_to_show;
 
+  // Send the properties of all the panels to the server together.
+  QSet<vtkSMSession*> sessions;
+  foreach(pqObjectPanel* panel, this->PanelStore)
+    {
+    sessions.insert(panel->referenceProxy()->getServer()->session());
+    }
+  foreach(vtkSMSession* session, sessions)
+    {
+    session->StartTransaction();
+    }
+
   // accept all panels that are dirty.
   foreach(pqObjectPanel* panel, this->PanelStore)
     {
@@ -526,6 +538,11 @@ void pqObjectInspectorWidget::accept()
     this->CurrentPanel->accept();
     }
 
+  foreach(vtkSMSession* session, sessions)
+    {
+    session->EndTransaction();
+    }
+
   foreach (pqProxy* proxy_to_show, proxies_to_show)
     {
     pqPipelineSource* source = qobject_cast<pqPipelineSource*>(proxy_to_show);